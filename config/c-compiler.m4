@@ -622,6 +622,101 @@ undefine([Ac_cachevar])dnl
 ])# PGAC_SSE42_CRC32_INTRINSICS
 
 
+# PGAC_AVX512_PCLMUL_INTRINSICS
+# -----------------------
+# Check if the compiler supports the AVX-512 and VPCLMULQDQ instructions used
+# to fold CRC-32C over 64-byte chunks, using the _mm512_clmulepi64_epi128,
+# _mm512_ternarylogic_epi64, _mm512_zextsi128_si512 and _mm_ternarylogic_epi64
+# intrinsic functions.  The last one requires AVX-512VL, and
+# _mm512_zextsi128_si512 is missing from some older compilers.
+#
+# An optional compiler flag can be passed as argument (e.g.
+# -mavx512vl -mvpclmulqdq). If the intrinsics are supported, sets
+# pgac_avx512_pclmul_intrinsics, and CFLAGS_AVX512_CRC32C.
+AC_DEFUN([PGAC_AVX512_PCLMUL_INTRINSICS],
+[define([Ac_cachevar], [AS_TR_SH([pgac_cv_avx512_pclmul_intrinsics_$1])])dnl
+AC_CACHE_CHECK([for _mm512_clmulepi64_epi128 and _mm_ternarylogic_epi64 with CFLAGS=$1], [Ac_cachevar],
+[pgac_save_CFLAGS=$CFLAGS
+CFLAGS="$pgac_save_CFLAGS $1"
+AC_LINK_IFELSE([AC_LANG_PROGRAM([#include <immintrin.h>],
+  [__m512i x = _mm512_zextsi128_si512(_mm_cvtsi32_si128(0x1));
+   __m128i z;
+   x = _mm512_clmulepi64_epi128(x, x, 0);
+   x = _mm512_ternarylogic_epi64(x, x, x, 0x96);
+   z = _mm_ternarylogic_epi64(_mm512_castsi512_si128(x),
+                              _mm512_extracti32x4_epi32(x, 1),
+                              _mm512_extracti32x4_epi32(x, 2), 0x96);
+   /* return computed value, to prevent the above being optimized away */
+   return _mm_extract_epi64(z, 0) == 0;])],
+  [Ac_cachevar=yes],
+  [Ac_cachevar=no])
+CFLAGS="$pgac_save_CFLAGS"])
+if test x"$Ac_cachevar" = x"yes"; then
+  CFLAGS_AVX512_CRC32C="$1"
+  pgac_avx512_pclmul_intrinsics=yes
+fi
+undefine([Ac_cachevar])dnl
+])# PGAC_AVX512_PCLMUL_INTRINSICS
+
+# PGAC_AVX2_INTRINSICS
+# -----------------------
+# Check if the compiler supports the AVX2 integer instructions used by the
+# data page checksum, using the _mm256_mullo_epi32 and _mm256_srli_epi32
+# intrinsic functions.
+#
+# An optional compiler flag can be passed as argument (e.g. -mavx2). If the
+# intrinsics are supported, sets pgac_avx2_intrinsics, and CFLAGS_AVX2.
+AC_DEFUN([PGAC_AVX2_INTRINSICS],
+[define([Ac_cachevar], [AS_TR_SH([pgac_cv_avx2_intrinsics_$1])])dnl
+AC_CACHE_CHECK([for _mm256_mullo_epi32 and _mm256_srli_epi32 with CFLAGS=$1], [Ac_cachevar],
+[pgac_save_CFLAGS=$CFLAGS
+CFLAGS="$pgac_save_CFLAGS $1"
+AC_LINK_IFELSE([AC_LANG_PROGRAM([#include <immintrin.h>],
+  [__m256i x = _mm256_set1_epi32(0x1);
+   x = _mm256_mullo_epi32(x, x);
+   x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+   /* return computed value, to prevent the above being optimized away */
+   return _mm256_extract_epi32(x, 0) == 0;])],
+  [Ac_cachevar=yes],
+  [Ac_cachevar=no])
+CFLAGS="$pgac_save_CFLAGS"])
+if test x"$Ac_cachevar" = x"yes"; then
+  CFLAGS_AVX2="$1"
+  pgac_avx2_intrinsics=yes
+fi
+undefine([Ac_cachevar])dnl
+])# PGAC_AVX2_INTRINSICS
+
+# PGAC_AVX512F_INTRINSICS
+# -----------------------
+# Check if the compiler supports the AVX-512 Foundation integer instructions
+# used by the data page checksum, using the _mm512_mullo_epi32 and
+# _mm512_srli_epi32 intrinsic functions.
+#
+# An optional compiler flag can be passed as argument (e.g. -mavx512f). If the
+# intrinsics are supported, sets pgac_avx512f_intrinsics, and CFLAGS_AVX512F.
+AC_DEFUN([PGAC_AVX512F_INTRINSICS],
+[define([Ac_cachevar], [AS_TR_SH([pgac_cv_avx512f_intrinsics_$1])])dnl
+AC_CACHE_CHECK([for _mm512_mullo_epi32 and _mm512_srli_epi32 with CFLAGS=$1], [Ac_cachevar],
+[pgac_save_CFLAGS=$CFLAGS
+CFLAGS="$pgac_save_CFLAGS $1"
+AC_LINK_IFELSE([AC_LANG_PROGRAM([#include <immintrin.h>],
+  [__m512i x = _mm512_set1_epi32(0x1);
+   x = _mm512_mullo_epi32(x, x);
+   x = _mm512_xor_si512(x, _mm512_srli_epi32(x, 17));
+   /* return computed value, to prevent the above being optimized away */
+   return _mm512_reduce_add_epi32(x) == 0;])],
+  [Ac_cachevar=yes],
+  [Ac_cachevar=no])
+CFLAGS="$pgac_save_CFLAGS"])
+if test x"$Ac_cachevar" = x"yes"; then
+  CFLAGS_AVX512F="$1"
+  pgac_avx512f_intrinsics=yes
+fi
+undefine([Ac_cachevar])dnl
+])# PGAC_AVX512F_INTRINSICS
+
+
 # PGAC_ARMV8_CRC32C_INTRINSICS
 # -----------------------
 # Check if the compiler supports the CRC32C instructions using the __crc32cb,
@@ -11,12 +11,17 @@
 #include "access/htup_details.h"
 #include "catalog/pg_type.h"
 #include "funcapi.h"
+#include "port/pg_numa.h"
 #include "storage/buf_internals.h"
 #include "storage/bufmgr.h"
 
 
 #define NUM_BUFFERCACHE_PAGES_MIN_ELEM	8
 #define NUM_BUFFERCACHE_PAGES_ELEM	9
+#define NUM_BUFFERCACHE_NUMA_ELEM	2
+
+/* Number of buffers to ask the kernel about at a time */
+#define NUMA_QUERY_CHUNK_SIZE	1024
 
 PG_MODULE_MAGIC;
 
@@ -53,6 +58,15 @@ typedef struct
 	BufferCachePagesRec *record;
 } BufferCachePagesContext;
 
+/*
+ * Function context for pg_buffercache_numa_pages.
+ */
+typedef struct
+{
+	TupleDesc	tupdesc;
+	int		   *nodes;			/* node of each buffer, or negative errno */
+} BufferCacheNumaContext;
+
 
 /*
  * Function returning data from the shared buffer cache - buffer number,
@@ -237,3 +251,101 @@ pg_buffercache_pages(PG_FUNCTION_ARGS)
 	else
 		SRF_RETURN_DONE(funcctx);
 }
+
+/*
+ * Function returning the NUMA node of the memory of each shared buffer.
+ */
+PG_FUNCTION_INFO_V1(pg_buffercache_numa_pages);
+
+Datum
+pg_buffercache_numa_pages(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	BufferCacheNumaContext *fctx;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		MemoryContext oldcontext;
+		TupleDesc	tupledesc;
+		void	  **pages;
+		int			i;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+
+		/* Switch context when allocating stuff to be used in later calls */
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		fctx = (BufferCacheNumaContext *) palloc(sizeof(BufferCacheNumaContext));
+
+		tupledesc = CreateTemplateTupleDesc(NUM_BUFFERCACHE_NUMA_ELEM);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 1, "bufferid",
+						   INT4OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 2, "numa_node",
+						   INT4OID, -1, 0);
+		fctx->tupdesc = BlessTupleDesc(tupledesc);
+
+		fctx->nodes = (int *)
+			MemoryContextAllocHuge(CurrentMemoryContext,
+								   sizeof(int) * NBuffers);
+
+		funcctx->max_calls = NBuffers;
+		funcctx->user_fctx = fctx;
+
+		/* Return to original context when allocating transient memory */
+		MemoryContextSwitchTo(oldcontext);
+
+		/*
+		 * Ask the kernel where the first byte of each buffer is.  We don't
+		 * touch the buffers, so for buffers that have never been used, the
+		 * answer is that they're nowhere yet.
+		 */
+		pages = (void **) palloc(sizeof(void *) * NUMA_QUERY_CHUNK_SIZE);
+		for (i = 0; i < NBuffers; i += NUMA_QUERY_CHUNK_SIZE)
+		{
+			int			count = Min(NUMA_QUERY_CHUNK_SIZE, NBuffers - i);
+			int			j;
+
+			for (j = 0; j < count; j++)
+				pages[j] = BufferGetBlock(i + j + 1);
+
+			if (pg_numa_query_pages(count, pages, &fctx->nodes[i]) != 0)
+				ereport(ERROR,
+						(errmsg("could not determine NUMA node of shared buffers: %m")));
+		}
+		pfree(pages);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+
+	/* Get the saved state */
+	fctx = funcctx->user_fctx;
+
+	if (funcctx->call_cntr < funcctx->max_calls)
+	{
+		uint32		i = funcctx->call_cntr;
+		Datum		values[NUM_BUFFERCACHE_NUMA_ELEM];
+		bool		nulls[NUM_BUFFERCACHE_NUMA_ELEM];
+		HeapTuple	tuple;
+
+		values[0] = Int32GetDatum(i + 1);
+		nulls[0] = false;
+
+		/* Negative values are errors, most likely that it's not present */
+		if (fctx->nodes[i] < 0)
+		{
+			values[1] = (Datum) 0;
+			nulls[1] = true;
+		}
+		else
+		{
+			values[1] = Int32GetDatum(fctx->nodes[i]);
+			nulls[1] = false;
+		}
+
+		tuple = heap_form_tuple(fctx->tupdesc, values, nulls);
+
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+	else
+		SRF_RETURN_DONE(funcctx);
+}
@@ -58,6 +58,7 @@
 #include "storage/freespace.h"
 #include "storage/lmgr.h"
 #include "storage/predicate.h"
+#include "storage/read_stream.h"
 #include "storage/procarray.h"
 #include "storage/smgr.h"
 #include "storage/spin.h"
@@ -65,6 +66,7 @@
 #include "utils/datum.h"
 #include "utils/inval.h"
 #include "utils/lsyscache.h"
+#include "utils/memutils.h"
 #include "utils/relcache.h"
 #include "utils/snapmgr.h"
 #include "utils/spccache.h"
@@ -296,11 +298,21 @@ initscan(HeapScanDesc scan, ScanKey key, bool keep_startblock)
 	}
 
 	scan->rs_numblocks = InvalidBlockNumber;
+	scan->rs_limitblocks = InvalidBlockNumber;
 	scan->rs_inited = false;
 	scan->rs_ctup.t_data = NULL;
 	ItemPointerSetInvalid(&scan->rs_ctup.t_self);
 	scan->rs_cbuf = InvalidBuffer;
 	scan->rs_cblock = InvalidBlockNumber;
+	scan->rs_dir = NoMovementScanDirection;
+	scan->rs_prefetch_block = InvalidBlockNumber;
+	scan->rs_prefetch_remaining = 0;
+	scan->rs_nextbuf = InvalidBuffer;
+	scan->rs_cindex = 0;
+	scan->rs_ntuples = 0;
+	scan->rs_empty_tuples_pending = 0;
+	scan->rs_empty_tuples = 0;
+	scan->rs_skipped_pages = 0;
 
 	/* page-at-a-time fields are always invalid when not rs_inited */
 
@@ -339,6 +351,153 @@ heap_setscanlimits(TableScanDesc sscan, BlockNumber startBlk, BlockNumber numBlk
 
 	scan->rs_startblock = startBlk;
 	scan->rs_numblocks = numBlks;
+	scan->rs_limitblocks = numBlks;
+}
+
+/*
+ * heap_scan_stream_read_next - read stream callback for sequential scans
+ *
+ * In a parallel scan, the blocks are allocated to us as the stream asks for
+ * them.  Otherwise, we return the blocks a forward scan visits, starting at
+ * the block heap_scan_stream_read_page() last restarted the stream at.
+ */
+static BlockNumber
+heap_scan_stream_read_next(ReadStream *stream,
+						   void *callback_private_data,
+						   void *per_buffer_data)
+{
+	HeapScanDesc scan = (HeapScanDesc) callback_private_data;
+	BlockNumber page;
+
+	if (scan->rs_base.rs_parallel != NULL)
+	{
+		ParallelBlockTableScanDesc pbscan =
+		(ParallelBlockTableScanDesc) scan->rs_base.rs_parallel;
+
+		return table_block_parallelscan_nextpage(scan->rs_base.rs_rd, pbscan);
+	}
+
+	if (scan->rs_prefetch_remaining == 0)
+		return InvalidBlockNumber;
+
+	page = scan->rs_prefetch_block;
+	scan->rs_prefetch_remaining--;
+	if (++scan->rs_prefetch_block >= scan->rs_nblocks)
+		scan->rs_prefetch_block = 0;
+
+	return page;
+}
+
+/*
+ * heap_scan_get_read_stream - return the scan's read stream, creating it if
+ * this is the first time it is needed
+ *
+ * The stream must live as long as the scan, so it is allocated in the scan
+ * descriptor's memory context rather than whatever context the caller asking
+ * for the first tuple happens to be in; that is often a per-tuple context.
+ */
+static ReadStream *
+heap_scan_get_read_stream(HeapScanDesc scan)
+{
+	if (scan->rs_read_stream == NULL)
+	{
+		MemoryContext oldcxt;
+
+		oldcxt = MemoryContextSwitchTo(GetMemoryChunkContext(scan));
+		scan->rs_read_stream = read_stream_begin_relation(READ_STREAM_DEFAULT,
+														  scan->rs_strategy,
+														  scan->rs_base.rs_rd,
+														  MAIN_FORKNUM,
+														  heap_scan_stream_read_next,
+														  scan,
+														  0);
+		MemoryContextSwitchTo(oldcxt);
+	}
+	return scan->rs_read_stream;
+}
+
+/*
+ * heap_parallelscan_nextpage - allocate the next page of a parallel scan
+ *
+ * Sequential scans get their pages from the read stream, which allocates
+ * them ahead of time.  The buffer is kept in rs_nextbuf, for the
+ * heapgetpage() call that follows.
+ */
+static BlockNumber
+heap_parallelscan_nextpage(HeapScanDesc scan)
+{
+	ParallelBlockTableScanDesc pbscan =
+	(ParallelBlockTableScanDesc) scan->rs_base.rs_parallel;
+
+	if (!(scan->rs_base.rs_flags & SO_TYPE_SEQSCAN))
+		return table_block_parallelscan_nextpage(scan->rs_base.rs_rd, pbscan);
+
+	Assert(!BufferIsValid(scan->rs_nextbuf));
+	scan->rs_nextbuf = read_stream_next_buffer(heap_scan_get_read_stream(scan),
+											   NULL);
+	if (!BufferIsValid(scan->rs_nextbuf))
+		return InvalidBlockNumber;
+
+	return BufferGetBlockNumber(scan->rs_nextbuf);
+}
+
+/*
+ * heap_scan_stream_read_page - read a page of a forward sequential scan
+ *
+ * Normally the read stream's next buffer is the requested page.  If it is
+ * not, because the scan changed direction, was repositioned or is just
+ * starting, restart the stream at the requested page.
+ */
+static Buffer
+heap_scan_stream_read_page(HeapScanDesc scan, BlockNumber page)
+{
+	ReadStream *stream = heap_scan_get_read_stream(scan);
+	Buffer		buffer;
+	BlockNumber consumed;
+	BlockNumber remaining;
+
+	if (scan->rs_base.rs_parallel != NULL)
+	{
+		/* heap_parallelscan_nextpage() has already read it */
+		buffer = scan->rs_nextbuf;
+		scan->rs_nextbuf = InvalidBuffer;
+		Assert(BufferIsValid(buffer) && BufferGetBlockNumber(buffer) == page);
+		return buffer;
+	}
+
+	buffer = read_stream_next_buffer(stream, NULL);
+	if (BufferIsValid(buffer))
+	{
+		if (BufferGetBlockNumber(buffer) == page)
+			return buffer;
+		ReleaseBuffer(buffer);
+	}
+
+	/*
+	 * Restart at the requested page, and stop where the scan will: when it
+	 * wraps around to the start block, or at the end of the range set by
+	 * heap_setscanlimits().  rs_numblocks counts down as pages are consumed,
+	 * in either direction, so measure from rs_startblock instead.
+	 */
+	if (page >= scan->rs_startblock)
+		consumed = page - scan->rs_startblock;
+	else
+		consumed = scan->rs_nblocks - scan->rs_startblock + page;
+	remaining = scan->rs_nblocks - consumed;
+	if (scan->rs_limitblocks != InvalidBlockNumber)
+	{
+		Assert(consumed < scan->rs_limitblocks);
+		remaining = Min(remaining, scan->rs_limitblocks - consumed);
+	}
+
+	read_stream_reset(stream);
+	scan->rs_prefetch_block = page;
+	scan->rs_prefetch_remaining = remaining;
+
+	buffer = read_stream_next_buffer(stream, NULL);
+	Assert(BufferIsValid(buffer) && BufferGetBlockNumber(buffer) == page);
+
+	return buffer;
 }
 
 /*
@@ -377,9 +536,18 @@ heapgetpage(TableScanDesc sscan, BlockNumber page)
 	 */
 	CHECK_FOR_INTERRUPTS();
 
-	/* read page using selected strategy */
-	scan->rs_cbuf = ReadBufferExtended(scan->rs_base.rs_rd, MAIN_FORKNUM, page,
-									   RBM_NORMAL, scan->rs_strategy);
+	/*
+	 * Read page using selected strategy.  Forward sequential and TID range
+	 * scans read through the read stream, so that the following pages are
+	 * already being read while we process this one.
+	 */
+	if ((scan->rs_base.rs_flags & (SO_TYPE_SEQSCAN | SO_TYPE_TIDRANGESCAN)) &&
+		ScanDirectionIsForward(scan->rs_dir))
+		scan->rs_cbuf = heap_scan_stream_read_page(scan, page);
+	else
+		scan->rs_cbuf = ReadBufferExtended(scan->rs_base.rs_rd, MAIN_FORKNUM,
+										   page, RBM_NORMAL,
+										   scan->rs_strategy);
 	scan->rs_cblock = page;
 
 	if (!(scan->rs_base.rs_flags & SO_ALLOW_PAGEMODE))
@@ -500,6 +668,9 @@ heapgettup(HeapScanDesc scan,
 	int			linesleft;
 	ItemId		lpp;
 
+	/* remember the direction, for heapgetpage() */
+	scan->rs_dir = dir;
+
 	/*
 	 * calculate next starting lineoff, given scan direction
 	 */
@@ -524,8 +695,7 @@ heapgettup(HeapScanDesc scan,
 				table_block_parallelscan_startblock_init(scan->rs_base.rs_rd,
 														 pbscan);
 
-				page = table_block_parallelscan_nextpage(scan->rs_base.rs_rd,
-														 pbscan);
+				page = heap_parallelscan_nextpage(scan);
 
 				/* Other processes might have already finished the scan. */
 				if (page == InvalidBlockNumber)
@@ -582,8 +752,13 @@ heapgettup(HeapScanDesc scan,
 			 * forward scanners.
 			 */
 			scan->rs_base.rs_flags &= ~SO_ALLOW_SYNC;
-			/* start from last page of the scan */
-			if (scan->rs_startblock > 0)
+			/*
+			 * Start from last page of the scan.  Ensure we take into account
+			 * rs_numblocks if it's been adjusted by heap_setscanlimits().
+			 */
+			if (scan->rs_numblocks != InvalidBlockNumber)
+				page = (scan->rs_startblock + scan->rs_numblocks - 1) % scan->rs_nblocks;
+			else if (scan->rs_startblock > 0)
 				page = scan->rs_startblock - 1;
 			else
 				page = scan->rs_nblocks - 1;
@@ -718,11 +893,7 @@ heapgettup(HeapScanDesc scan,
 		}
 		else if (scan->rs_base.rs_parallel != NULL)
 		{
-			ParallelBlockTableScanDesc pbscan =
-			(ParallelBlockTableScanDesc) scan->rs_base.rs_parallel;
-
-			page = table_block_parallelscan_nextpage(scan->rs_base.rs_rd,
-													 pbscan);
+			page = heap_parallelscan_nextpage(scan);
 			finished = (page == InvalidBlockNumber);
 		}
 		else
@@ -814,6 +985,9 @@ heapgettup_pagemode(HeapScanDesc scan,
 	int			linesleft;
 	ItemId		lpp;
 
+	/* remember the direction, for heapgetpage() */
+	scan->rs_dir = dir;
+
 	/*
 	 * calculate next starting lineindex, given scan direction
 	 */
@@ -838,8 +1012,7 @@ heapgettup_pagemode(HeapScanDesc scan,
 				table_block_parallelscan_startblock_init(scan->rs_base.rs_rd,
 														 pbscan);
 
-				page = table_block_parallelscan_nextpage(scan->rs_base.rs_rd,
-														 pbscan);
+				page = heap_parallelscan_nextpage(scan);
 
 				/* Other processes might have already finished the scan. */
 				if (page == InvalidBlockNumber)
@@ -893,8 +1066,13 @@ heapgettup_pagemode(HeapScanDesc scan,
 			 * forward scanners.
 			 */
 			scan->rs_base.rs_flags &= ~SO_ALLOW_SYNC;
-			/* start from last page of the scan */
-			if (scan->rs_startblock > 0)
+			/*
+			 * Start from last page of the scan.  Ensure we take into account
+			 * rs_numblocks if it's been adjusted by heap_setscanlimits().
+			 */
+			if (scan->rs_numblocks != InvalidBlockNumber)
+				page = (scan->rs_startblock + scan->rs_numblocks - 1) % scan->rs_nblocks;
+			else if (scan->rs_startblock > 0)
 				page = scan->rs_startblock - 1;
 			else
 				page = scan->rs_nblocks - 1;
@@ -1017,11 +1195,7 @@ heapgettup_pagemode(HeapScanDesc scan,
 		}
 		else if (scan->rs_base.rs_parallel != NULL)
 		{
-			ParallelBlockTableScanDesc pbscan =
-			(ParallelBlockTableScanDesc) scan->rs_base.rs_parallel;
-
-			page = table_block_parallelscan_nextpage(scan->rs_base.rs_rd,
-													 pbscan);
+			page = heap_parallelscan_nextpage(scan);
 			finished = (page == InvalidBlockNumber);
 		}
 		else
@@ -1155,7 +1329,11 @@ heap_beginscan(Relation relation, Snapshot snapshot,
 	scan->rs_base.rs_nkeys = nkeys;
 	scan->rs_base.rs_flags = flags;
 	scan->rs_base.rs_parallel = parallel_scan;
+	scan->rs_base.rs_tbmiterator = NULL;
+	scan->rs_base.rs_shared_tbmiterator = NULL;
 	scan->rs_strategy = NULL;	/* set in initscan */
+	scan->rs_read_stream = NULL;
+	scan->rs_vmbuffer = InvalidBuffer;
 
 	/*
 	 * Disable page-at-a-time mode if it's not a MVCC-safe snapshot.
@@ -1164,19 +1342,20 @@ heap_beginscan(Relation relation, Snapshot snapshot,
 		scan->rs_base.rs_flags &= ~SO_ALLOW_PAGEMODE;
 
 	/*
-	 * For seqscan and sample scans in a serializable transaction, acquire a
-	 * predicate lock on the entire relation. This is required not only to
-	 * lock all the matching tuples, but also to conflict with new insertions
-	 * into the table. In an indexscan, we take page locks on the index pages
-	 * covering the range specified in the scan qual, but in a heap scan there
-	 * is nothing more fine-grained to lock. A bitmap scan is a different
-	 * story, there we have already scanned the index and locked the index
-	 * pages covering the predicate. But in that case we still have to lock
-	 * any matching heap tuples. For sample scan we could optimize the locking
-	 * to be at least page-level granularity, but we'd need to add per-tuple
-	 * locking for that.
+	 * For seqscan, TID range and sample scans in a serializable transaction,
+	 * acquire a predicate lock on the entire relation. This is required not
+	 * only to lock all the matching tuples, but also to conflict with new
+	 * insertions into the table. In an indexscan, we take page locks on the
+	 * index pages covering the range specified in the scan qual, but in a
+	 * heap scan there is nothing more fine-grained to lock. A bitmap scan is
+	 * a different story, there we have already scanned the index and locked
+	 * the index pages covering the predicate. But in that case we still have
+	 * to lock any matching heap tuples. For sample and TID range scans we
+	 * could optimize the locking to be at least page-level granularity, but
+	 * we'd need to add per-tuple locking for that.
 	 */
-	if (scan->rs_base.rs_flags & (SO_TYPE_SEQSCAN | SO_TYPE_SAMPLESCAN))
+	if (scan->rs_base.rs_flags & (SO_TYPE_SEQSCAN | SO_TYPE_TIDRANGESCAN |
+								  SO_TYPE_SAMPLESCAN))
 	{
 		/*
 		 * Ensure a missing snapshot is noticed reliably, even if the
@@ -1234,6 +1413,23 @@ heap_rescan(TableScanDesc sscan, ScanKey key, bool set_params,
 	 */
 	if (BufferIsValid(scan->rs_cbuf))
 		ReleaseBuffer(scan->rs_cbuf);
+	if (BufferIsValid(scan->rs_nextbuf))
+		ReleaseBuffer(scan->rs_nextbuf);
+	if (BufferIsValid(scan->rs_vmbuffer))
+	{
+		ReleaseBuffer(scan->rs_vmbuffer);
+		scan->rs_vmbuffer = InvalidBuffer;
+	}
+
+	/*
+	 * The read stream refers to the access strategy, which initscan() might
+	 * replace, so start a new one when it's needed again.
+	 */
+	if (scan->rs_read_stream != NULL)
+	{
+		read_stream_end(scan->rs_read_stream);
+		scan->rs_read_stream = NULL;
+	}
 
 	/*
 	 * reinitialize scan descriptor
@@ -1253,6 +1449,13 @@ heap_endscan(TableScanDesc sscan)
 	 */
 	if (BufferIsValid(scan->rs_cbuf))
 		ReleaseBuffer(scan->rs_cbuf);
+	if (BufferIsValid(scan->rs_nextbuf))
+		ReleaseBuffer(scan->rs_nextbuf);
+	if (BufferIsValid(scan->rs_vmbuffer))
+		ReleaseBuffer(scan->rs_vmbuffer);
+
+	if (scan->rs_read_stream != NULL)
+		read_stream_end(scan->rs_read_stream);
 
 	/*
 	 * decrement relation reference count and free scan descriptor storage
@@ -1379,6 +1582,164 @@ heap_getnextslot(TableScanDesc sscan, ScanDirection direction, TupleTableSlot *s
 	return true;
 }
 
+/*
+ * heap_set_tidrange - restrict a scan to the TIDs between mintid and maxtid
+ *
+ * Both ends of the range are inclusive.  We clamp the range to the TIDs
+ * that can exist in the relation, and then restrict the scan to the blocks
+ * that the range covers; heap_getnextslot_tidrange() takes care of the
+ * tuples on the first and last block that fall outside of the range.
+ */
+void
+heap_set_tidrange(TableScanDesc sscan, ItemPointer mintid,
+				  ItemPointer maxtid)
+{
+	HeapScanDesc scan = (HeapScanDesc) sscan;
+	BlockNumber startBlk;
+	BlockNumber numBlks;
+	ItemPointerData highestItem;
+	ItemPointerData lowestItem;
+
+	/*
+	 * For relations without any pages, we can simply leave the TID range
+	 * unset.  There will be no tuples to scan, therefore no tuples outside
+	 * the given TID range.
+	 */
+	if (scan->rs_nblocks == 0)
+		return;
+
+	/*
+	 * Set up some ItemPointers which point to the first and last possible
+	 * tuples in the heap.
+	 */
+	ItemPointerSet(&highestItem, scan->rs_nblocks - 1, MaxOffsetNumber);
+	ItemPointerSet(&lowestItem, 0, FirstOffsetNumber);
+
+	/*
+	 * If the given maximum TID is below the highest possible TID in the
+	 * relation, then restrict the range to that, otherwise we scan to the end
+	 * of the relation.
+	 */
+	if (ItemPointerCompare(maxtid, &highestItem) < 0)
+		ItemPointerCopy(maxtid, &highestItem);
+
+	/*
+	 * If the given minimum TID is above the lowest possible TID in the
+	 * relation, then restrict the range to only scan for TIDs above that.
+	 */
+	if (ItemPointerCompare(mintid, &lowestItem) > 0)
+		ItemPointerCopy(mintid, &lowestItem);
+
+	/*
+	 * Check for an empty range and protect from would be negative results
+	 * from the numBlks calculation below.
+	 */
+	if (ItemPointerCompare(&highestItem, &lowestItem) < 0)
+	{
+		/* Set an empty range of blocks to scan */
+		heap_setscanlimits(sscan, 0, 0);
+		return;
+	}
+
+	/*
+	 * Calculate the first block and the number of blocks we must scan.  We
+	 * could narrow this a little further when lowestItem's offset is beyond
+	 * what fits on a page, or highestItem's offset is zero, but that doesn't
+	 * seem worth troubling over.
+	 */
+	startBlk = ItemPointerGetBlockNumberNoCheck(&lowestItem);
+	numBlks = ItemPointerGetBlockNumberNoCheck(&highestItem) -
+		ItemPointerGetBlockNumberNoCheck(&lowestItem) + 1;
+
+	/* Set the start block and number of blocks to scan */
+	heap_setscanlimits(sscan, startBlk, numBlks);
+
+	/* Finally, set the TID range in sscan */
+	ItemPointerCopy(&lowestItem, &sscan->rs_mintid);
+	ItemPointerCopy(&highestItem, &sscan->rs_maxtid);
+}
+
+/*
+ * heap_getnextslot_tidrange - fetch the next tuple of a TID range scan
+ *
+ * Works like heap_getnextslot(), but skips the tuples on the first and last
+ * block of the range that are outside of the range set by
+ * heap_set_tidrange().
+ */
+bool
+heap_getnextslot_tidrange(TableScanDesc sscan, ScanDirection direction,
+						  TupleTableSlot *slot)
+{
+	HeapScanDesc scan = (HeapScanDesc) sscan;
+	ItemPointer mintid = &sscan->rs_mintid;
+	ItemPointer maxtid = &sscan->rs_maxtid;
+
+	/* Note: no locking manipulations needed */
+	for (;;)
+	{
+		if (sscan->rs_flags & SO_ALLOW_PAGEMODE)
+			heapgettup_pagemode(scan, direction, sscan->rs_nkeys, sscan->rs_key);
+		else
+			heapgettup(scan, direction, sscan->rs_nkeys, sscan->rs_key);
+
+		if (scan->rs_ctup.t_data == NULL)
+		{
+			ExecClearTuple(slot);
+			return false;
+		}
+
+		/*
+		 * heap_set_tidrange will have used heap_setscanlimits to limit the
+		 * range of pages we scan to only ones that can contain the TID range
+		 * we're scanning for.  Here we must filter out any tuples from these
+		 * pages that are outside of that range.
+		 */
+		if (ItemPointerCompare(&scan->rs_ctup.t_self, mintid) < 0)
+		{
+			ExecClearTuple(slot);
+
+			/*
+			 * When scanning backwards, the TIDs will be in descending order.
+			 * Future tuples in this direction will be lower still, so we can
+			 * just return false to indicate there will be no more tuples.
+			 */
+			if (ScanDirectionIsBackward(direction))
+				return false;
+
+			continue;
+		}
+
+		/*
+		 * Likewise for the final page, we must filter out TIDs greater than
+		 * maxtid.
+		 */
+		if (ItemPointerCompare(&scan->rs_ctup.t_self, maxtid) > 0)
+		{
+			ExecClearTuple(slot);
+
+			/*
+			 * When scanning forward, the TIDs will be in ascending order.
+			 * Future tuples in this direction will be higher still, so we can
+			 * just return false to indicate there will be no more tuples.
+			 */
+			if (ScanDirectionIsForward(direction))
+				return false;
+			continue;
+		}
+
+		break;
+	}
+
+	/*
+	 * if we get here it means we have a new current scan tuple, so point to
+	 * the proper return buffer and return the tuple.
+	 */
+	pgstat_count_heap_getnext(scan->rs_base.rs_rd);
+
+	ExecStoreBufferHeapTuple(&scan->rs_ctup, slot, scan->rs_cbuf);
+	return true;
+}
+
 /*
  *	heap_fetch		- retrieve tuple with given tid
  *
@@ -1634,9 +1995,16 @@ heap_hot_search_buffer(ItemPointer tid, Relation relation, Buffer buffer,
 		 * Note: if you change the criterion here for what is "dead", fix the
 		 * planner's get_actual_variable_range() function to match.
 		 */
-		if (all_dead && *all_dead &&
-			!HeapTupleIsSurelyDead(heapTuple, RecentGlobalXmin))
-			*all_dead = false;
+		if (all_dead && *all_dead)
+		{
+			/* The horizon is computed lazily, see if a newer one helps */
+			if (!(heapTuple->t_data->t_infomask & HEAP_XMAX_IS_MULTI))
+				MaybeUpdateRecentGlobalXmin(
+					HeapTupleHeaderGetRawXmax(heapTuple->t_data));
+
+			if (!HeapTupleIsSurelyDead(heapTuple, RecentGlobalXmin))
+				*all_dead = false;
+		}
 
 		/*
 		 * Check to see if HOT chain continues past this tuple; if so fetch
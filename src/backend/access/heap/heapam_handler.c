@@ -26,6 +26,7 @@
 #include "access/rewriteheap.h"
 #include "access/tableam.h"
 #include "access/tsmapi.h"
+#include "access/visibilitymap.h"
 #include "access/xact.h"
 #include "catalog/catalog.h"
 #include "catalog/index.h"
@@ -40,8 +41,10 @@
 #include "storage/lmgr.h"
 #include "storage/predicate.h"
 #include "storage/procarray.h"
+#include "storage/read_stream.h"
 #include "storage/smgr.h"
 #include "utils/builtins.h"
+#include "utils/memutils.h"
 #include "utils/rel.h"
 
 static void reform_and_rewrite_tuple(HeapTuple tuple,
@@ -960,8 +963,7 @@ heapam_relation_copy_for_cluster(Relation OldHeap, Relation NewHeap,
 }
 
 static bool
-heapam_scan_analyze_next_block(TableScanDesc scan, BlockNumber blockno,
-							   BufferAccessStrategy bstrategy)
+heapam_scan_analyze_next_block(TableScanDesc scan, ReadStream *stream)
 {
 	HeapScanDesc hscan = (HeapScanDesc) scan;
 
@@ -974,10 +976,12 @@ heapam_scan_analyze_next_block(TableScanDesc scan, BlockNumber blockno,
 	 * doing much work per tuple, the extra lock traffic is probably better
 	 * avoided.
 	 */
-	hscan->rs_cblock = blockno;
+	hscan->rs_cbuf = read_stream_next_buffer(stream, NULL);
+	if (!BufferIsValid(hscan->rs_cbuf))
+		return false;
+
+	hscan->rs_cblock = BufferGetBlockNumber(hscan->rs_cbuf);
 	hscan->rs_cindex = FirstOffsetNumber;
-	hscan->rs_cbuf = ReadBufferExtended(scan->rs_rd, MAIN_FORKNUM,
-										blockno, RBM_NORMAL, bstrategy);
 	LockBuffer(hscan->rs_cbuf, BUFFER_LOCK_SHARE);
 
 	/* in heap all blocks can contain tuples, so always return true */
@@ -2059,122 +2063,242 @@ heapam_estimate_rel_size(Relation rel, int32 *attr_widths,
  * ------------------------------------------------------------------------
  */
 
+/*
+ * Read stream callback for bitmap heap scans.  Returns the next block of the
+ * bitmap that has to be fetched, and stores a copy of its bitmap entry as the
+ * buffer's per-buffer data.
+ */
+static BlockNumber
+heapam_bitmap_stream_read_next(ReadStream *stream,
+							   void *callback_private_data,
+							   void *per_buffer_data)
+{
+	HeapScanDesc hscan = (HeapScanDesc) callback_private_data;
+	TableScanDesc scan = &hscan->rs_base;
+	TBMIterateResult *tbmres;
+
+	for (;;)
+	{
+		CHECK_FOR_INTERRUPTS();
+
+		if (scan->rs_shared_tbmiterator)
+			tbmres = tbm_shared_iterate(scan->rs_shared_tbmiterator);
+		else
+			tbmres = tbm_iterate(scan->rs_tbmiterator);
+
+		/* no more entries in the bitmap */
+		if (tbmres == NULL)
+			return InvalidBlockNumber;
+
+		/*
+		 * Ignore any claimed entries past what we think is the end of the
+		 * relation. It may have been extended after the start of our scan (we
+		 * only hold an AccessShareLock, and it could be inserts from this
+		 * backend).
+		 */
+		if (tbmres->blockno >= hscan->rs_nblocks)
+			continue;
+
+		/*
+		 * We can skip fetching the heap page if we don't need any fields from
+		 * the heap, and the bitmap entries don't need rechecking, and all
+		 * tuples on the page are visible to our transaction.  The tuples are
+		 * returned as empty tuples by heapam_scan_bitmap_next_block().
+		 */
+		if (!(scan->rs_flags & SO_NEED_TUPLES) &&
+			!tbmres->recheck &&
+			VM_ALL_VISIBLE(scan->rs_rd, tbmres->blockno, &hscan->rs_vmbuffer))
+		{
+			/* can't be lossy in the skip_fetch case */
+			Assert(tbmres->ntuples >= 0);
+
+			hscan->rs_empty_tuples_pending += tbmres->ntuples;
+			hscan->rs_skipped_pages++;
+			continue;
+		}
+
+		memcpy(per_buffer_data, tbmres,
+			   offsetof(TBMIterateResult, offsets) +
+			   Max(tbmres->ntuples, 0) * sizeof(OffsetNumber));
+
+		return tbmres->blockno;
+	}
+}
+
 static bool
-heapam_scan_bitmap_next_block(TableScanDesc scan,
-							  TBMIterateResult *tbmres)
+heapam_scan_bitmap_next_block(TableScanDesc scan, bool *recheck,
+							  long *lossy_pages, long *exact_pages)
 {
 	HeapScanDesc hscan = (HeapScanDesc) scan;
-	BlockNumber page = tbmres->blockno;
+	TBMIterateResult *tbmres;
+	BlockNumber page;
 	Buffer		buffer;
 	Snapshot	snapshot;
 	int			ntup;
 
-	hscan->rs_cindex = 0;
-	hscan->rs_ntuples = 0;
-
-	/*
-	 * Ignore any claimed entries past what we think is the end of the
-	 * relation. It may have been extended after the start of our scan (we
-	 * only hold an AccessShareLock, and it could be inserts from this
-	 * backend).
-	 */
-	if (page >= hscan->rs_nblocks)
-		return false;
+	/* allocated with the scan, like heap_scan_get_read_stream() does */
+	if (hscan->rs_read_stream == NULL)
+	{
+		MemoryContext oldcxt;
+
+		oldcxt = MemoryContextSwitchTo(GetMemoryChunkContext(hscan));
+		hscan->rs_read_stream =
+			read_stream_begin_relation(READ_STREAM_DEFAULT,
+									   hscan->rs_strategy,
+									   scan->rs_rd,
+									   MAIN_FORKNUM,
+									   heapam_bitmap_stream_read_next,
+									   hscan,
+									   offsetof(TBMIterateResult, offsets) +
+									   MaxHeapTuplesPerPage * sizeof(OffsetNumber));
+		MemoryContextSwitchTo(oldcxt);
+	}
 
-	/*
-	 * Acquire pin on the target heap page, trading in any pin we held before.
-	 */
-	hscan->rs_cbuf = ReleaseAndReadBuffer(hscan->rs_cbuf,
-										  scan->rs_rd,
-										  page);
-	hscan->rs_cblock = page;
-	buffer = hscan->rs_cbuf;
-	snapshot = scan->rs_snapshot;
+	for (;;)
+	{
+		void	   *per_buffer_data;
 
-	ntup = 0;
+		hscan->rs_cindex = 0;
+		hscan->rs_ntuples = 0;
+		hscan->rs_empty_tuples = 0;
 
-	/*
-	 * Prune and repair fragmentation for the whole page, if possible.
-	 */
-	heap_page_prune_opt(scan->rs_rd, buffer);
+		/* release the previous page, if any */
+		if (BufferIsValid(hscan->rs_cbuf))
+		{
+			ReleaseBuffer(hscan->rs_cbuf);
+			hscan->rs_cbuf = InvalidBuffer;
+		}
 
-	/*
-	 * We must hold share lock on the buffer content while examining tuple
-	 * visibility.  Afterwards, however, the tuples we have found to be
-	 * visible are guaranteed good as long as we hold the buffer pin.
-	 */
-	LockBuffer(buffer, BUFFER_LOCK_SHARE);
+		/* account for pages the read stream found we needn't fetch */
+		*exact_pages += hscan->rs_skipped_pages;
+		hscan->rs_skipped_pages = 0;
 
-	/*
-	 * We need two separate strategies for lossy and non-lossy cases.
-	 */
-	if (tbmres->ntuples >= 0)
-	{
 		/*
-		 * Bitmap is non-lossy, so we just look through the offsets listed in
-		 * tbmres; but we have to follow any HOT chain starting at each such
-		 * offset.
+		 * Return the tuples on those pages first, as a page of their own, so
+		 * that they aren't mixed up with tuples that need rechecking.
 		 */
-		int			curslot;
-
-		for (curslot = 0; curslot < tbmres->ntuples; curslot++)
+		if (hscan->rs_empty_tuples_pending > 0)
 		{
-			OffsetNumber offnum = tbmres->offsets[curslot];
-			ItemPointerData tid;
-			HeapTupleData heapTuple;
+			hscan->rs_empty_tuples = hscan->rs_empty_tuples_pending;
+			hscan->rs_empty_tuples_pending = 0;
+			*recheck = false;
+			return true;
+		}
 
-			ItemPointerSet(&tid, page, offnum);
-			if (heap_hot_search_buffer(&tid, scan->rs_rd, buffer, snapshot,
-									   &heapTuple, NULL, true))
-				hscan->rs_vistuples[ntup++] = ItemPointerGetOffsetNumber(&tid);
+		buffer = read_stream_next_buffer(hscan->rs_read_stream,
+										 &per_buffer_data);
+		if (!BufferIsValid(buffer))
+		{
+			/* the stream may have come across more skippable pages */
+			if (hscan->rs_empty_tuples_pending > 0 ||
+				hscan->rs_skipped_pages > 0)
+				continue;
+			return false;
 		}
-	}
-	else
-	{
+
+		tbmres = (TBMIterateResult *) per_buffer_data;
+		page = tbmres->blockno;
+		Assert(BufferGetBlockNumber(buffer) == page);
+
+		hscan->rs_cbuf = buffer;
+		hscan->rs_cblock = page;
+		snapshot = scan->rs_snapshot;
+
+		ntup = 0;
+
+		/*
+		 * Prune and repair fragmentation for the whole page, if possible.
+		 */
+		heap_page_prune_opt(scan->rs_rd, buffer);
+
 		/*
-		 * Bitmap is lossy, so we must examine each line pointer on the page.
-		 * But we can ignore HOT chains, since we'll check each tuple anyway.
+		 * We must hold share lock on the buffer content while examining
+		 * tuple visibility.  Afterwards, however, the tuples we have found to
+		 * be visible are guaranteed good as long as we hold the buffer pin.
 		 */
-		Page		dp = (Page) BufferGetPage(buffer);
-		OffsetNumber maxoff = PageGetMaxOffsetNumber(dp);
-		OffsetNumber offnum;
+		LockBuffer(buffer, BUFFER_LOCK_SHARE);
 
-		for (offnum = FirstOffsetNumber; offnum <= maxoff; offnum = OffsetNumberNext(offnum))
+		/*
+		 * We need two separate strategies for lossy and non-lossy cases.
+		 */
+		if (tbmres->ntuples >= 0)
 		{
-			ItemId		lp;
-			HeapTupleData loctup;
-			bool		valid;
+			/*
+			 * Bitmap is non-lossy, so we just look through the offsets listed
+			 * in tbmres; but we have to follow any HOT chain starting at each
+			 * such offset.
+			 */
+			int			curslot;
 
-			lp = PageGetItemId(dp, offnum);
-			if (!ItemIdIsNormal(lp))
-				continue;
-			loctup.t_data = (HeapTupleHeader) PageGetItem((Page) dp, lp);
-			loctup.t_len = ItemIdGetLength(lp);
-			loctup.t_tableOid = scan->rs_rd->rd_id;
-			ItemPointerSet(&loctup.t_self, page, offnum);
-			valid = HeapTupleSatisfiesVisibility(&loctup, snapshot, buffer);
-			if (valid)
+			for (curslot = 0; curslot < tbmres->ntuples; curslot++)
 			{
-				hscan->rs_vistuples[ntup++] = offnum;
-				PredicateLockTID(scan->rs_rd, &loctup.t_self, snapshot,
-								 HeapTupleHeaderGetXmin(loctup.t_data));
+				OffsetNumber offnum = tbmres->offsets[curslot];
+				ItemPointerData tid;
+				HeapTupleData heapTuple;
+
+				ItemPointerSet(&tid, page, offnum);
+				if (heap_hot_search_buffer(&tid, scan->rs_rd, buffer, snapshot,
+										   &heapTuple, NULL, true))
+					hscan->rs_vistuples[ntup++] = ItemPointerGetOffsetNumber(&tid);
 			}
-			HeapCheckForSerializableConflictOut(valid, scan->rs_rd, &loctup,
-												buffer, snapshot);
 		}
-	}
+		else
+		{
+			/*
+			 * Bitmap is lossy, so we must examine each line pointer on the
+			 * page. But we can ignore HOT chains, since we'll check each
+			 * tuple anyway.
+			 */
+			Page		dp = (Page) BufferGetPage(buffer);
+			OffsetNumber maxoff = PageGetMaxOffsetNumber(dp);
+			OffsetNumber offnum;
 
-	LockBuffer(buffer, BUFFER_LOCK_UNLOCK);
+			for (offnum = FirstOffsetNumber; offnum <= maxoff; offnum = OffsetNumberNext(offnum))
+			{
+				ItemId		lp;
+				HeapTupleData loctup;
+				bool		valid;
 
-	Assert(ntup <= MaxHeapTuplesPerPage);
-	hscan->rs_ntuples = ntup;
+				lp = PageGetItemId(dp, offnum);
+				if (!ItemIdIsNormal(lp))
+					continue;
+				loctup.t_data = (HeapTupleHeader) PageGetItem((Page) dp, lp);
+				loctup.t_len = ItemIdGetLength(lp);
+				loctup.t_tableOid = scan->rs_rd->rd_id;
+				ItemPointerSet(&loctup.t_self, page, offnum);
+				valid = HeapTupleSatisfiesVisibility(&loctup, snapshot, buffer);
+				if (valid)
+				{
+					hscan->rs_vistuples[ntup++] = offnum;
+					PredicateLockTID(scan->rs_rd, &loctup.t_self, snapshot,
+									 HeapTupleHeaderGetXmin(loctup.t_data));
+				}
+				HeapCheckForSerializableConflictOut(valid, scan->rs_rd, &loctup,
+													buffer, snapshot);
+			}
+		}
 
-	return ntup > 0;
+		LockBuffer(buffer, BUFFER_LOCK_UNLOCK);
+
+		Assert(ntup <= MaxHeapTuplesPerPage);
+		hscan->rs_ntuples = ntup;
+
+		/* AM doesn't think this block is worth returning, skip it */
+		if (ntup == 0)
+			continue;
+
+		if (tbmres->ntuples >= 0)
+			(*exact_pages)++;
+		else
+			(*lossy_pages)++;
+
+		*recheck = tbmres->recheck;
+		return true;
+	}
 }
 
 static bool
 heapam_scan_bitmap_next_tuple(TableScanDesc scan,
-							  TBMIterateResult *tbmres,
 							  TupleTableSlot *slot)
 {
 	HeapScanDesc hscan = (HeapScanDesc) scan;
@@ -2182,6 +2306,16 @@ heapam_scan_bitmap_next_tuple(TableScanDesc scan,
 	Page		dp;
 	ItemId		lp;
 
+	/*
+	 * If we don't have to fetch the tuple, just return nulls.
+	 */
+	if (hscan->rs_empty_tuples > 0)
+	{
+		ExecStoreAllNullTuple(slot);
+		hscan->rs_empty_tuples--;
+		return true;
+	}
+
 	/*
 	 * Out of range?  If so, nothing more to look at on this page
 	 */
@@ -2494,6 +2628,9 @@ static const TableAmRoutine heapam_methods = {
 	.scan_rescan = heap_rescan,
 	.scan_getnextslot = heap_getnextslot,
 
+	.scan_set_tidrange = heap_set_tidrange,
+	.scan_getnextslot_tidrange = heap_getnextslot_tidrange,
+
 	.parallelscan_estimate = table_block_parallelscan_estimate,
 	.parallelscan_initialize = table_block_parallelscan_initialize,
 	.parallelscan_reinitialize = table_block_parallelscan_reinitialize,
@@ -74,6 +74,7 @@
 #include "storage/bufmgr.h"
 #include "storage/freespace.h"
 #include "storage/lmgr.h"
+#include "storage/read_stream.h"
 #include "tcop/tcopprot.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
@@ -319,6 +320,16 @@ typedef struct LVRelStats
 	VacErrPhase phase;
 } LVRelStats;
 
+/*
+ * State of the read stream that lazy_vacuum_heap() uses to read the pages
+ * containing dead tuples.
+ */
+typedef struct LVReadStreamPrivate
+{
+	LVDeadTuples *dead_tuples;
+	int			next_tupindex;	/* first dead tuple not yet handed out */
+} LVReadStreamPrivate;
+
 /* A few variables that don't seem worth passing around as parameters */
 static int	elevel = -1;
 
@@ -1802,6 +1813,33 @@ lazy_vacuum_all_indexes(Relation onerel, Relation *Irel,
 }
 
 
+/*
+ * Read stream callback for lazy_vacuum_heap().  Returns the block containing
+ * the next dead tuple, skipping over the remaining dead tuples on the same
+ * block, and stores the index of its first dead tuple in per_buffer_data.
+ */
+static BlockNumber
+lazy_vacuum_heap_read_stream_next(ReadStream *stream,
+								  void *callback_private_data,
+								  void *per_buffer_data)
+{
+	LVReadStreamPrivate *private = (LVReadStreamPrivate *) callback_private_data;
+	LVDeadTuples *dead_tuples = private->dead_tuples;
+	BlockNumber blkno;
+
+	if (private->next_tupindex >= dead_tuples->num_tuples)
+		return InvalidBlockNumber;
+
+	*(int *) per_buffer_data = private->next_tupindex;
+	blkno = ItemPointerGetBlockNumber(&dead_tuples->itemptrs[private->next_tupindex]);
+
+	while (private->next_tupindex < dead_tuples->num_tuples &&
+		   ItemPointerGetBlockNumber(&dead_tuples->itemptrs[private->next_tupindex]) == blkno)
+		private->next_tupindex++;
+
+	return blkno;
+}
+
 /*
  *	lazy_vacuum_heap() -- second pass over the heap
  *
@@ -1821,6 +1859,8 @@ lazy_vacuum_heap(Relation onerel, LVRelStats *vacrelstats)
 	PGRUsage	ru0;
 	Buffer		vmbuffer = InvalidBuffer;
 	LVRelStats	olderrinfo;
+	LVReadStreamPrivate stream_private;
+	ReadStream *stream;
 
 	/* Report that we are now vacuuming the heap */
 	pgstat_progress_update_param(PROGRESS_VACUUM_PHASE,
@@ -1834,26 +1874,53 @@ lazy_vacuum_heap(Relation onerel, LVRelStats *vacrelstats)
 	pg_rusage_init(&ru0);
 	npages = 0;
 
-	tupindex = 0;
-	while (tupindex < vacrelstats->dead_tuples->num_tuples)
+	/* Read the pages containing dead tuples ahead of time */
+	stream_private.dead_tuples = vacrelstats->dead_tuples;
+	stream_private.next_tupindex = 0;
+	stream = read_stream_begin_relation(READ_STREAM_MAINTENANCE,
+										vac_strategy,
+										onerel,
+										MAIN_FORKNUM,
+										lazy_vacuum_heap_read_stream_next,
+										&stream_private,
+										sizeof(int));
+
+	for (;;)
 	{
 		BlockNumber tblk;
 		Buffer		buf;
 		Page		page;
 		Size		freespace;
+		void	   *per_buffer_data;
 
 		vacuum_delay_point();
 
-		tblk = ItemPointerGetBlockNumber(&vacrelstats->dead_tuples->itemptrs[tupindex]);
+		buf = read_stream_next_buffer(stream, &per_buffer_data);
+		if (!BufferIsValid(buf))
+			break;
+
+		tupindex = *(int *) per_buffer_data;
+		tblk = BufferGetBlockNumber(buf);
 		vacrelstats->blkno = tblk;
-		buf = ReadBufferExtended(onerel, MAIN_FORKNUM, tblk, RBM_NORMAL,
-								 vac_strategy);
-		if (!ConditionalLockBufferForCleanup(buf))
+
+		/*
+		 * If we can't get a cleanup lock, try again for each of the page's
+		 * remaining dead tuples, skipping one dead tuple per attempt.
+		 */
+		while (!ConditionalLockBufferForCleanup(buf))
 		{
-			ReleaseBuffer(buf);
 			++tupindex;
-			continue;
+			if (tupindex >= vacrelstats->dead_tuples->num_tuples ||
+				ItemPointerGetBlockNumber(&vacrelstats->dead_tuples->itemptrs[tupindex]) != tblk)
+			{
+				ReleaseBuffer(buf);
+				buf = InvalidBuffer;
+				break;
+			}
 		}
+		if (!BufferIsValid(buf))
+			continue;
+
 		tupindex = lazy_vacuum_page(onerel, tblk, buf, tupindex, vacrelstats,
 									&vmbuffer);
 
@@ -1866,6 +1933,9 @@ lazy_vacuum_heap(Relation onerel, LVRelStats *vacrelstats)
 		npages++;
 	}
 
+	read_stream_end(stream);
+	tupindex = vacrelstats->dead_tuples->num_tuples;
+
 	if (BufferIsValid(vmbuffer))
 	{
 		ReleaseBuffer(vmbuffer);
@@ -537,6 +537,18 @@ visibilitymap_prepare_truncate(Relation rel, BlockNumber nheapblocks)
 	return newnblocks;
 }
 
+/*
+ *	visibilitymap_map_block - the visibility map block covering a heap block
+ *
+ * This is for code that tracks which visibility map blocks WAL records
+ * modify, without access to the map itself.
+ */
+BlockNumber
+visibilitymap_map_block(BlockNumber heapBlk)
+{
+	return HEAPBLK_TO_MAPBLOCK(heapBlk);
+}
+
 /*
  * Read a visibility map page.
  *
@@ -35,6 +35,8 @@
 #include "access/xlog_internal.h"
 #include "access/xlogarchive.h"
 #include "access/xloginsert.h"
+#include "access/xlogparallel.h"
+#include "access/xlogprefetch.h"
 #include "access/xlogreader.h"
 #include "access/xlogutils.h"
 #include "catalog/catversion.h"
@@ -43,13 +45,16 @@
 #include "commands/progress.h"
 #include "commands/tablespace.h"
 #include "common/controldata_utils.h"
+#include "common/incremental_backup.h"
 #include "executor/instrument.h"
 #include "miscadmin.h"
 #include "pg_trace.h"
 #include "pgstat.h"
 #include "port/atomics.h"
+#include "port/pg_iovec.h"
 #include "postmaster/bgwriter.h"
 #include "postmaster/startup.h"
+#include "postmaster/walsummarizer.h"
 #include "postmaster/walwriter.h"
 #include "replication/basebackup.h"
 #include "replication/logical.h"
@@ -96,16 +101,19 @@ char	   *XLogArchiveCommand = NULL;
 bool		EnableHotStandby = false;
 bool		fullPageWrites = true;
 bool		wal_log_hints = false;
-bool		wal_compression = false;
+int			wal_compression = WAL_COMPRESSION_NONE;
+int			wal_record_compression_threshold = -1;
 char	   *wal_consistency_checking_string = NULL;
 bool	   *wal_consistency_checking = NULL;
 bool		wal_init_zero = true;
 bool		wal_recycle = true;
+int			wal_prealloc_segments = 2;
 bool		log_checkpoints = false;
 int			sync_method = DEFAULT_SYNC_METHOD;
 int			wal_level = WAL_LEVEL_MINIMAL;
 int			CommitDelay = 0;	/* precommit delay in microseconds */
 int			CommitSiblings = 5; /* # concurrent xacts needed to sleep */
+bool		wal_group_commit = true;
 int			wal_retrieve_retry_interval = 5000;
 int			max_slot_wal_keep_size_mb = -1;
 
@@ -116,11 +124,11 @@ bool		XLOG_DEBUG = false;
 int			wal_segment_size = DEFAULT_XLOG_SEG_SIZE;
 
 /*
- * Number of WAL insertion locks to use. A higher value allows more insertions
- * to happen concurrently, but adds some CPU overhead to flushing the WAL,
- * which needs to iterate all the locks.
+ * Number of WAL insertion locks to use (wal_insert_locks). A higher value
+ * allows more insertions to happen concurrently, but adds some CPU overhead
+ * to flushing the WAL, which needs to iterate all the locks.
  */
-#define NUM_XLOGINSERT_LOCKS  8
+int			wal_insert_locks = 8;
 
 /*
  * Max distance from last checkpoint, before triggering a new xlog-based
@@ -902,6 +910,7 @@ static XLogRecPtr XLogGetReplicationSlotMinimumLSN(void);
 static void AdvanceXLInsertBuffer(XLogRecPtr upto, bool opportunistic);
 static bool XLogCheckpointNeeded(XLogSegNo new_segno);
 static void XLogWrite(XLogwrtRqst WriteRqst, bool flexible);
+static void XLogGroupFlush(XLogRecPtr record);
 static bool InstallXLogFileSegment(XLogSegNo *segno, char *tmppath,
 								   bool find_free, XLogSegNo max_segno,
 								   bool use_lock);
@@ -945,7 +954,6 @@ static bool read_backup_label(XLogRecPtr *checkPointLoc,
 							  bool *backupEndRequired, bool *backupFromStandby);
 static bool read_tablespace_map(List **tablespaces);
 
-static void rm_redo_error_callback(void *arg);
 static int	get_sync_bit(int method);
 
 static void CopyXLogRecordToWAL(int write_len, bool isLogSwitch,
@@ -1035,7 +1043,7 @@ XLogInsertRecord(XLogRecData *rdata,
 	 * inserter acquires an insertion lock. In addition to just indicating that
 	 * an insertion is in progress, the lock tells others how far the inserter
 	 * has progressed. There is a small fixed number of insertion locks,
-	 * determined by NUM_XLOGINSERT_LOCKS. When an inserter crosses a page
+	 * determined by wal_insert_locks. When an inserter crosses a page
 	 * boundary, it updates the value stored in the lock to the how far it has
 	 * inserted, to allow the previous buffer to be flushed.
 	 *
@@ -1666,7 +1674,7 @@ WALInsertLockAcquire(void)
 	static int	lockToTry = -1;
 
 	if (lockToTry == -1)
-		lockToTry = MyProc->pgprocno % NUM_XLOGINSERT_LOCKS;
+		lockToTry = MyProc->pgprocno % wal_insert_locks;
 	MyLockNo = lockToTry;
 
 	/*
@@ -1684,7 +1692,7 @@ WALInsertLockAcquire(void)
 		 * than locks, it still helps to distribute the inserters evenly
 		 * across the locks.
 		 */
-		lockToTry = (lockToTry + 1) % NUM_XLOGINSERT_LOCKS;
+		lockToTry = (lockToTry + 1) % wal_insert_locks;
 	}
 }
 
@@ -1702,7 +1710,7 @@ WALInsertLockAcquireExclusive(void)
 	 * indicator is set to 0xFFFFFFFFFFFFFFFF, which is higher than any real
 	 * XLogRecPtr value, to make sure that no-one blocks waiting on those.
 	 */
-	for (i = 0; i < NUM_XLOGINSERT_LOCKS - 1; i++)
+	for (i = 0; i < wal_insert_locks - 1; i++)
 	{
 		LWLockAcquire(&WALInsertLocks[i].l.lock, LW_EXCLUSIVE);
 		LWLockUpdateVar(&WALInsertLocks[i].l.lock,
@@ -1728,7 +1736,7 @@ WALInsertLockRelease(void)
 	{
 		int			i;
 
-		for (i = 0; i < NUM_XLOGINSERT_LOCKS; i++)
+		for (i = 0; i < wal_insert_locks; i++)
 			LWLockReleaseClearVar(&WALInsertLocks[i].l.lock,
 								  &WALInsertLocks[i].l.insertingAt,
 								  0);
@@ -1756,8 +1764,8 @@ WALInsertLockUpdateInsertingAt(XLogRecPtr insertingAt)
 		 * We use the last lock to mark our actual position, see comments in
 		 * WALInsertLockAcquireExclusive.
 		 */
-		LWLockUpdateVar(&WALInsertLocks[NUM_XLOGINSERT_LOCKS - 1].l.lock,
-						&WALInsertLocks[NUM_XLOGINSERT_LOCKS - 1].l.insertingAt,
+		LWLockUpdateVar(&WALInsertLocks[wal_insert_locks - 1].l.lock,
+						&WALInsertLocks[wal_insert_locks - 1].l.insertingAt,
 						insertingAt);
 	}
 	else
@@ -1824,7 +1832,7 @@ WaitXLogInsertionsToFinish(XLogRecPtr upto)
 	 * out for any insertion that's still in progress.
 	 */
 	finishedUpto = reservedUpto;
-	for (i = 0; i < NUM_XLOGINSERT_LOCKS; i++)
+	for (i = 0; i < wal_insert_locks; i++)
 	{
 		XLogRecPtr	insertingat = InvalidXLogRecPtr;
 
@@ -2399,7 +2407,7 @@ XLogCheckpointNeeded(XLogSegNo new_segno)
  * Write and/or fsync the log at least as far as WriteRqst indicates.
  *
  * If flexible == true, we don't have to write as far as WriteRqst, but
- * may stop at any convenient boundary (such as a cache or logfile boundary).
+ * may stop at any convenient boundary (such as a logfile boundary).
  * This option allows us to avoid uselessly issuing multiple writes when a
  * single one would do.
  *
@@ -2430,11 +2438,12 @@ XLogWrite(XLogwrtRqst WriteRqst, bool flexible)
 	/*
 	 * Since successive pages in the xlog cache are consecutively allocated,
 	 * we can usually gather multiple pages together and issue just one
-	 * write() call.  npages is the number of pages we have determined can be
-	 * written together; startidx is the cache block index of the first one,
-	 * and startoffset is the file offset at which it should go. The latter
-	 * two variables are only valid when npages > 0, but we must initialize
-	 * all of them to keep the compiler quiet.
+	 * write() call.  A run of pages that wraps around the end of the cache is
+	 * written with a single pwritev() call.  npages is the number of pages we
+	 * have determined can be written together; startidx is the cache block
+	 * index of the first one, and startoffset is the file offset at which it
+	 * should go. The latter two variables are only valid when npages > 0, but
+	 * we must initialize all of them to keep the compiler quiet.
 	 */
 	npages = 0;
 	startidx = 0;
@@ -2483,6 +2492,13 @@ XLogWrite(XLogwrtRqst WriteRqst, bool flexible)
 			use_existent = true;
 			openLogFile = XLogFileInit(openLogSegNo, &use_existent, true);
 			ReserveExternalFD();
+
+			/*
+			 * Let the bgwriter know that it should prepare another segment in
+			 * place of the one we have just started to use.
+			 */
+			if (wal_prealloc_segments > 0 && ProcGlobal->bgwriterLatch)
+				SetLatch(ProcGlobal->bgwriterLatch);
 		}
 
 		/* Make sure we have the current logfile open */
@@ -2506,33 +2522,47 @@ XLogWrite(XLogwrtRqst WriteRqst, bool flexible)
 
 		/*
 		 * Dump the set if this will be the last loop iteration, or if we are
-		 * at the last page of the cache area (since the next page won't be
-		 * contiguous in memory), or if we are at the end of the logfile
-		 * segment.
+		 * at the end of the logfile segment.  Reaching the last page of the
+		 * cache area doesn't end the set, even though the next page isn't
+		 * contiguous in memory.
 		 */
 		last_iteration = WriteRqst.Write <= LogwrtResult.Write;
 
 		finishing_seg = !ispartialpage &&
 			(startoffset + npages * XLOG_BLCKSZ) >= wal_segment_size;
 
-		if (last_iteration ||
-			curridx == XLogCtl->XLogCacheBlck ||
-			finishing_seg)
+		if (last_iteration || finishing_seg)
 		{
-			char	   *from;
-			Size		nbytes;
+			struct iovec iov[2];
+			int			iovcnt;
+			int			nwrap;
 			Size		nleft;
-			int			written;
+			ssize_t		written;
 
-			/* OK to write the page(s) */
-			from = XLogCtl->pages + startidx * (Size) XLOG_BLCKSZ;
-			nbytes = npages * (Size) XLOG_BLCKSZ;
-			nleft = nbytes;
+			/*
+			 * OK to write the page(s).  The pages past the end of the cache
+			 * area, if any, continue at its beginning.
+			 */
+			nwrap = startidx + npages - (XLogCtl->XLogCacheBlck + 1);
+			iov[0].iov_base = XLogCtl->pages + startidx * (Size) XLOG_BLCKSZ;
+			if (nwrap > 0)
+			{
+				iov[0].iov_len = (npages - nwrap) * (Size) XLOG_BLCKSZ;
+				iov[1].iov_base = XLogCtl->pages;
+				iov[1].iov_len = nwrap * (Size) XLOG_BLCKSZ;
+				iovcnt = 2;
+			}
+			else
+			{
+				iov[0].iov_len = npages * (Size) XLOG_BLCKSZ;
+				iovcnt = 1;
+			}
+			nleft = npages * (Size) XLOG_BLCKSZ;
 			do
 			{
 				errno = 0;
 				pgstat_report_wait_start(WAIT_EVENT_WAL_WRITE);
-				written = pg_pwrite(openLogFile, from, nleft, startoffset);
+				written = pg_pwritev(openLogFile, iov, iovcnt, startoffset);
 				pgstat_report_wait_end();
 				if (written <= 0)
 				{
@@ -2553,8 +2583,20 @@ XLogWrite(XLogwrtRqst WriteRqst, bool flexible)
 									xlogfname, startoffset, nleft)));
 				}
 				nleft -= written;
-				from += written;
 				startoffset += written;
+
+				/* adjust the iovecs to describe what is still to be written */
+				while (iovcnt > 0 && written >= iov[0].iov_len)
+				{
+					written -= iov[0].iov_len;
+					iov[0] = iov[1];
+					iovcnt--;
+				}
+				if (iovcnt > 0)
+				{
+					iov[0].iov_base = (char *) iov[0].iov_base + written;
+					iov[0].iov_len -= written;
+				}
 			} while (nleft > 0);
 
 			npages = 0;
@@ -2833,6 +2875,180 @@ UpdateMinRecoveryPoint(XLogRecPtr lsn, bool force)
 	LWLockRelease(ControlFileLock);
 }
 
+/*
+ * Flush XLOG through the given position as a member of a flush group.
+ *
+ * Backends that need WAL flushed at about the same time add themselves to a
+ * list.  The first one to do so becomes the group leader: it waits for any
+ * flush already in progress to finish, while the others join the group, and
+ * then takes the whole group off the list and does a single write and fsync
+ * that covers the requests of all its members.  The members just sleep on
+ * their semaphores until the leader wakes them up.  While the leader is
+ * flushing, the next group gathers behind it, so that the groups grow by
+ * themselves as the fsync gets slower.
+ *
+ * This must be called in a critical section.  On return, the WAL may not be
+ * flushed as far as requested if the request was past the end of WAL;
+ * XLogFlush() takes care of that case.
+ */
+static void
+XLogGroupFlush(XLogRecPtr record)
+{
+	PGPROC	   *proc = MyProc;
+	uint32		nextidx;
+	uint32		wakeidx;
+	XLogRecPtr	WriteRqstPtr;
+	XLogRecPtr	insertpos;
+	int			members = 0;
+	instr_time	io_start,
+				io_time;
+
+	Assert(CritSectionCount > 0);
+
+	/* Add ourselves to the list of processes needing a flush. */
+	proc->walFlushGroupMember = true;
+	proc->walFlushGroupMemberLsn = record;
+
+	nextidx = pg_atomic_read_u32(&ProcGlobal->walFlushGroupFirst);
+	while (true)
+	{
+		pg_atomic_write_u32(&proc->walFlushGroupNext, nextidx);
+
+		if (pg_atomic_compare_exchange_u32(&ProcGlobal->walFlushGroupFirst,
+										   &nextidx,
+										   (uint32) proc->pgprocno))
+			break;
+	}
+
+	/*
+	 * If the list was not empty, the leader will flush the WAL for us.  Sleep
+	 * until it has done so.
+	 */
+	if (nextidx != INVALID_PGPROCNO)
+	{
+		int			extraWaits = 0;
+
+		pgstat_report_wait_start(WAIT_EVENT_WAL_FLUSH_GROUP);
+		for (;;)
+		{
+			/* acts as a read barrier */
+			PGSemaphoreLock(proc->sem);
+			if (!proc->walFlushGroupMember)
+				break;
+			extraWaits++;
+		}
+		pgstat_report_wait_end();
+
+		Assert(pg_atomic_read_u32(&proc->walFlushGroupNext) == INVALID_PGPROCNO);
+
+		/* Fix semaphore count for any absorbed wakeups */
+		while (extraWaits-- > 0)
+			PGSemaphoreUnlock(proc->sem);
+		return;
+	}
+
+	/*
+	 * We are the leader.  If somebody is flushing WAL right now, wait for
+	 * that to finish; more members are likely to join us in the meantime.
+	 */
+	if (LWLockAcquireOrWait(WALWriteLock, LW_EXCLUSIVE))
+		LWLockRelease(WALWriteLock);
+
+	/*
+	 * Sleep before taking the group off the list, if commit_delay asks for
+	 * it.  That gives further backends the opportunity to join the group;
+	 * see XLogFlush().
+	 */
+	if (CommitDelay > 0 && enableFsync &&
+		MinimumActiveBackends(CommitSiblings))
+		pg_usleep(CommitDelay);
+
+	/*
+	 * Now take the whole list, so that processes arriving from now on form
+	 * the next group, and find out how far the WAL has to be flushed.
+	 */
+	nextidx = pg_atomic_exchange_u32(&ProcGlobal->walFlushGroupFirst,
+									 INVALID_PGPROCNO);
+	WriteRqstPtr = record;
+	wakeidx = nextidx;
+	while (wakeidx != INVALID_PGPROCNO)
+	{
+		PGPROC	   *member = &ProcGlobal->allProcs[wakeidx];
+
+		if (WriteRqstPtr < member->walFlushGroupMemberLsn)
+			WriteRqstPtr = member->walFlushGroupMemberLsn;
+		members++;
+
+		wakeidx = pg_atomic_read_u32(&member->walFlushGroupNext);
+	}
+
+	/* Like XLogFlush(), also flush anything else already requested */
+	SpinLockAcquire(&XLogCtl->info_lck);
+	if (WriteRqstPtr < XLogCtl->LogwrtRqst.Write)
+		WriteRqstPtr = XLogCtl->LogwrtRqst.Write;
+	LogwrtResult = XLogCtl->LogwrtResult;
+	SpinLockRelease(&XLogCtl->info_lck);
+
+	/*
+	 * Wait for in-flight insertions to the pages we're about to write before
+	 * acquiring the write lock, as XLogFlush() does.  A member may have
+	 * asked for a position past the end of WAL; we flush as far as we can
+	 * and leave it to that member to complain.
+	 */
+	insertpos = WaitXLogInsertionsToFinish(WriteRqstPtr);
+	if (insertpos > LogwrtResult.Flush)
+	{
+		XLogwrtRqst WriteRqst;
+
+		LWLockAcquire(WALWriteLock, LW_EXCLUSIVE);
+
+		/* somebody else may have flushed it while we were waiting */
+		LogwrtResult = XLogCtl->LogwrtResult;
+		if (insertpos > LogwrtResult.Flush)
+		{
+			if (track_io_timing)
+				INSTR_TIME_SET_CURRENT(io_start);
+
+			WriteRqst.Write = insertpos;
+			WriteRqst.Flush = insertpos;
+			XLogWrite(WriteRqst, false);
+
+			if (track_io_timing)
+			{
+				INSTR_TIME_SET_CURRENT(io_time);
+				INSTR_TIME_SUBTRACT(io_time, io_start);
+				pgstat_count_wal_flush_group(members, &io_time);
+			}
+			else
+				pgstat_count_wal_flush_group(members, NULL);
+		}
+
+		LWLockRelease(WALWriteLock);
+	}
+
+	/*
+	 * Wake up the members, ourselves included.  Each member rechecks how far
+	 * the WAL has been flushed when it gets back to XLogFlush(), so it is
+	 * harmless if we didn't get as far as it asked for.
+	 */
+	wakeidx = nextidx;
+	while (wakeidx != INVALID_PGPROCNO)
+	{
+		PGPROC	   *member = &ProcGlobal->allProcs[wakeidx];
+
+		wakeidx = pg_atomic_read_u32(&member->walFlushGroupNext);
+		pg_atomic_write_u32(&member->walFlushGroupNext, INVALID_PGPROCNO);
+
+		/* ensure all previous writes are visible before follower continues. */
+		pg_write_barrier();
+
+		member->walFlushGroupMember = false;
+
+		if (member != MyProc)
+			PGSemaphoreUnlock(member->sem);
+	}
+}
+
 /*
  * Ensure that all XLOG data through the given position is flushed to disk.
  *
@@ -2880,6 +3096,14 @@ XLogFlush(XLogRecPtr record)
 	 * gives us some chance of avoiding another fsync immediately after.
 	 */
 
+	/*
+	 * Normally, let a flush group do the work.  The loop below then finds
+	 * that the request has been satisfied right away, unless it was past the
+	 * end of WAL.
+	 */
+	if (wal_group_commit && MyProc != NULL)
+		XLogGroupFlush(record);
+
 	/* initialize to given target; may increase below */
 	WriteRqstPtr = record;
 
@@ -3019,7 +3243,7 @@ XLogFlush(XLogRecPtr record)
  *
  * We can guarantee that async commits reach disk after at most three
  * wal_writer_delay cycles. (When flushing complete blocks, we allow XLogWrite
- * to write "flexibly", meaning it can stop at the end of the buffer ring;
+ * to write "flexibly", meaning it can stop at the end of a logfile segment;
  * this makes a difference only with very high load or long wal_writer_delay,
  * but imposes one extra cycle for the worst case for async commits.)
  *
@@ -3251,12 +3475,13 @@ XLogFileInit(XLogSegNo logsegno, bool *use_existent, bool use_lock)
 {
 	char		path[MAXPGPATH];
 	char		tmppath[MAXPGPATH];
-	PGAlignedXLogBlock zbuffer;
+	PGIOAlignedXLogBlock zbuffer;
 	XLogSegNo	installed_segno;
 	XLogSegNo	max_segno;
 	int			fd;
 	int			nbytes;
 	int			save_errno;
+	int			flags;
 
 	XLogFilePath(path, ThisTimeLineID, logsegno, wal_segment_size);
 
@@ -3289,8 +3514,15 @@ XLogFileInit(XLogSegNo logsegno, bool *use_existent, bool use_lock)
 
 	unlink(tmppath);
 
-	/* do not use get_sync_bit() here --- want to fsync only at end of fill */
-	fd = BasicOpenFile(tmppath, O_RDWR | O_CREAT | O_EXCL | PG_BINARY);
+	/*
+	 * Do not use get_sync_bit() here --- want to fsync only at end of fill.
+	 * Direct I/O is only useful, and only possible, if we fill the whole
+	 * file with aligned writes.
+	 */
+	flags = O_RDWR | O_CREAT | O_EXCL | PG_BINARY;
+	if ((io_direct_flags & IO_DIRECT_WAL_INIT) && wal_init_zero)
+		flags |= PG_O_DIRECT;
+	fd = BasicOpenFile(tmppath, flags);
 	if (fd < 0)
 		ereport(ERROR,
 				(errcode_for_file_access(),
@@ -3854,10 +4086,11 @@ XLogFileClose(void)
 	 * WAL segment files will not be re-read in normal operation, so we advise
 	 * the OS to release any cached pages.  But do not do so if WAL archiving
 	 * or streaming is active, because archiver and walsender process could
-	 * use the cache to read the WAL segment.
+	 * use the cache to read the WAL segment.  With io_direct=wal, there is
+	 * nothing cached to release.
 	 */
 #if defined(USE_POSIX_FADVISE) && defined(POSIX_FADV_DONTNEED)
-	if (!XLogIsNeeded())
+	if (!XLogIsNeeded() && (io_direct_flags & IO_DIRECT_WAL) == 0)
 		(void) posix_fadvise(openLogFile, 0, 0, POSIX_FADV_DONTNEED);
 #endif
 
@@ -3908,6 +4141,62 @@ PreallocXlogFiles(XLogRecPtr endptr)
 	}
 }
 
+/*
+ * Make sure that the wal_prealloc_segments segments following the one WAL is
+ * currently being inserted into exist, either recycled or newly created and
+ * zero-filled, so that backends don't have to create them in the foreground
+ * when they move on to a new segment.
+ *
+ * This is invoked periodically by the bgwriter, which XLogWrite() also wakes
+ * up whenever it starts writing to a new segment.
+ *
+ * Returns true if any segment had to be created.
+ */
+bool
+XLogPreallocSegments(void)
+{
+	static XLogSegNo lastPreallocSegNo = 0;
+	static TimeLineID lastPreallocTLI = 0;
+	XLogSegNo	insertSegNo;
+	XLogSegNo	segno;
+	bool		added = false;
+
+	if (wal_prealloc_segments <= 0 || RecoveryInProgress())
+		return false;
+
+	/*
+	 * Segments of a new timeline don't exist yet, even though we may have
+	 * prepared those of the old one.
+	 */
+	if (lastPreallocTLI != ThisTimeLineID)
+	{
+		lastPreallocSegNo = 0;
+		lastPreallocTLI = ThisTimeLineID;
+	}
+
+	XLByteToSeg(GetXLogInsertRecPtr(), insertSegNo, wal_segment_size);
+
+	/*
+	 * Segments beyond the insert position are never removed, only added by
+	 * recycling, so there's nothing to do for the ones we've already seen.
+	 */
+	segno = Max(insertSegNo, lastPreallocSegNo) + 1;
+	for (; segno <= insertSegNo + wal_prealloc_segments; segno++)
+	{
+		bool		use_existent = true;
+		int			fd;
+
+		fd = XLogFileInit(segno, &use_existent, true);
+		close(fd);
+
+		if (!use_existent)
+			added = true;
+		lastPreallocSegNo = segno;
+	}
+
+	return added;
+}
+
 /*
  * Throws an error if the given log segment has already been removed or
  * recycled. The caller should only pass a segment that it knows to have
@@ -5050,7 +5339,7 @@ XLOGShmemSize(void)
 	size = sizeof(XLogCtlData);
 
 	/* WAL insertion locks, plus alignment */
-	size = add_size(size, mul_size(sizeof(WALInsertLockPadded), NUM_XLOGINSERT_LOCKS + 1));
+	size = add_size(size, mul_size(sizeof(WALInsertLockPadded), wal_insert_locks + 1));
 	/* xlblocks array */
 	size = add_size(size, mul_size(sizeof(XLogRecPtr), XLOGbuffers));
 	/* extra alignment padding for XLOG I/O buffers */
@@ -5142,10 +5431,10 @@ XLOGShmemInit(void)
 		((uintptr_t) allocptr) % sizeof(WALInsertLockPadded);
 	WALInsertLocks = XLogCtl->Insert.WALInsertLocks =
 		(WALInsertLockPadded *) allocptr;
-	allocptr += sizeof(WALInsertLockPadded) * NUM_XLOGINSERT_LOCKS;
+	allocptr += sizeof(WALInsertLockPadded) * wal_insert_locks;
 
 	LWLockRegisterTranche(LWTRANCHE_WAL_INSERT, "wal_insert");
-	for (i = 0; i < NUM_XLOGINSERT_LOCKS; i++)
+	for (i = 0; i < wal_insert_locks; i++)
 	{
 		LWLockInitialize(&WALInsertLocks[i].l.lock, LWTRANCHE_WAL_INSERT);
 		WALInsertLocks[i].l.insertingAt = InvalidXLogRecPtr;
@@ -6858,6 +7147,13 @@ StartupXLOG(void)
 		InRecovery = true;
 	}
 
+	/*
+	 * Without recovery, the statistics saved at the last shutdown are still
+	 * valid, so load them.  Otherwise they are discarded below.
+	 */
+	if (!InRecovery)
+		pgstat_restore_stats();
+
 	/* REDO */
 	if (InRecovery)
 	{
@@ -7143,6 +7439,7 @@ StartupXLOG(void)
 		{
 			ErrorContextCallback errcallback;
 			TimestampTz xtime;
+			XLogPrefetcher *prefetcher = NULL;
 
 			InRedo = true;
 
@@ -7150,6 +7447,21 @@ StartupXLOG(void)
 					(errmsg("redo starts at %X/%X",
 							(uint32) (ReadRecPtr >> 32), (uint32) ReadRecPtr)));
 
+			/*
+			 * Launch parallel redo workers, if requested.  They replay
+			 * records of different relations out of order with each other,
+			 * which hot standby queries could observe, so only do that when
+			 * hot standby is disabled.
+			 */
+			if (max_parallel_redo_workers > 0)
+			{
+				if (standbyState != STANDBY_DISABLED)
+					ereport(LOG,
+							(errmsg("parallel redo is not used because hot standby is enabled")));
+				else
+					(void) ParallelRedoStart(!bgwriterLaunched);
+			}
+
 			/*
 			 * main redo apply loop
 			 */
@@ -7179,6 +7491,23 @@ StartupXLOG(void)
 				/* Handle interrupt signals of startup process */
 				HandleStartupProcInterrupts();
 
+				/*
+				 * Read ahead of the record we're about to replay, and issue
+				 * prefetches for the blocks referenced by upcoming records.
+				 * The setting can be changed on reload, so check each time.
+				 */
+				if (recovery_prefetch)
+				{
+					if (prefetcher == NULL)
+						prefetcher = XLogPrefetcherAllocate(ReadRecPtr);
+					XLogPrefetcherReadAhead(prefetcher, ReadRecPtr);
+				}
+				else if (prefetcher != NULL)
+				{
+					XLogPrefetcherFree(prefetcher);
+					prefetcher = NULL;
+				}
+
 				/*
 				 * Pause WAL replay, if requested by a hot-standby session via
 				 * SetRecoveryPause().
@@ -7293,8 +7622,12 @@ StartupXLOG(void)
 					TransactionIdIsValid(record->xl_xid))
 					RecordKnownAssignedTransactionIds(record->xl_xid);
 
-				/* Now apply the WAL record itself */
-				RmgrTable[record->xl_rmid].rm_redo(xlogreader);
+				/*
+				 * Now apply the WAL record itself, unless a parallel redo
+				 * worker takes care of it.
+				 */
+				if (!ParallelRedoDispatch(xlogreader))
+					RmgrTable[record->xl_rmid].rm_redo(xlogreader);
 
 				/*
 				 * After redo, check whether the backup pages associated with
@@ -7310,7 +7643,7 @@ StartupXLOG(void)
 
 				/*
 				 * Update lastReplayedEndRecPtr after this record has been
-				 * successfully replayed.
+				 * successfully replayed, or handed to a parallel redo worker.
 				 */
 				SpinLockAcquire(&XLogCtl->info_lck);
 				XLogCtl->lastReplayedEndRecPtr = EndRecPtr;
@@ -7367,6 +7700,12 @@ StartupXLOG(void)
 			 * end of main redo apply loop
 			 */
 
+			if (prefetcher != NULL)
+				XLogPrefetcherFree(prefetcher);
+
+			/* Wait for parallel redo workers to replay everything */
+			ParallelRedoFinish();
+
 			if (reachedRecoveryTarget)
 			{
 				if (!reachedConsistency)
@@ -7973,6 +8312,9 @@ CheckRecoveryConsistency(void)
 		 */
 		elog(DEBUG1, "end of backup reached");
 
+		/* All records up to here must have been replayed */
+		ParallelRedoWaitForWorkers();
+
 		LWLockAcquire(ControlFileLock, LW_EXCLUSIVE);
 
 		if (ControlFile->minRecoveryPoint < lastReplayedEndRecPtr)
@@ -7999,8 +8341,10 @@ CheckRecoveryConsistency(void)
 	{
 		/*
 		 * Check to see if the XLOG sequence contained any unresolved
-		 * references to uninitialized pages.
+		 * references to uninitialized pages.  Parallel redo workers check
+		 * their own, after replaying all records up to here.
 		 */
+		ParallelRedoReachedConsistency();
 		XLogCheckInvalidPages();
 
 		reachedConsistency = true;
@@ -8396,7 +8740,7 @@ GetLastImportantRecPtr(void)
 	XLogRecPtr	res = InvalidXLogRecPtr;
 	int			i;
 
-	for (i = 0; i < NUM_XLOGINSERT_LOCKS; i++)
+	for (i = 0; i < wal_insert_locks; i++)
 	{
 		XLogRecPtr	last_important;
 
@@ -9521,7 +9865,7 @@ GetWALAvailability(XLogRecPtr targetLSN)
 
 /*
  * Retreat *logSegNo to the last segment that we need to retain because of
- * either wal_keep_segments or replication slots.
+ * wal_keep_segments, replication slots or the WAL summarizer.
  *
  * This is calculated by subtracting wal_keep_segments from the given xlog
  * location, recptr and by making sure that that result is below the
@@ -9571,6 +9915,17 @@ KeepLogSeg(XLogRecPtr recptr, XLogSegNo *logSegNo)
 			segno = currSegNo - wal_keep_segments;
 	}
 
+	/* and keep whatever the WAL summarizer hasn't summarized yet */
+	keep = GetOldestUnsummarizedLSN(NULL);
+	if (keep != InvalidXLogRecPtr)
+	{
+		XLogSegNo	unsummarized_segno;
+
+		XLByteToSeg(keep, unsummarized_segno, wal_segment_size);
+		if (unsummarized_segno < segno)
+			segno = unsummarized_segno;
+	}
+
 	/* don't delete WAL segments newer than the calculated segment */
 	if (XLogRecPtrIsInvalid(*logSegNo) || segno < *logSegNo)
 		*logSegNo = segno;
@@ -10233,23 +10588,31 @@ xlog_outdesc(StringInfo buf, XLogReaderState *record)
 
 /*
  * Return the (possible) sync flag used for opening a file, depending on the
- * value of the GUC wal_sync_method.
+ * value of the GUC wal_sync_method, combined with O_DIRECT if appropriate.
  */
 static int
 get_sync_bit(int method)
 {
 	int			o_direct_flag = 0;
+	int			o_sync_direct_flag = 0;
+
+	/*
+	 * Use O_DIRECT if requested with io_direct, whatever the sync method,
+	 * except in walreceiver process for the reasons explained below.
+	 */
+	if ((io_direct_flags & IO_DIRECT_WAL) && !AmWalReceiverProcess())
+		o_direct_flag = PG_O_DIRECT;
 
 	/* If fsync is disabled, never open in sync mode */
 	if (!enableFsync)
-		return 0;
+		return o_direct_flag;
 
 	/*
-	 * Optimize writes by bypassing kernel cache with O_DIRECT when using
-	 * O_SYNC/O_FSYNC and O_DSYNC.  But only if archiving and streaming are
-	 * disabled, otherwise the archive command or walsender process will read
-	 * the WAL soon after writing it, which is guaranteed to cause a physical
-	 * read if we bypassed the kernel cache. We also skip the
+	 * Even without io_direct, optimize writes by bypassing kernel cache with
+	 * O_DIRECT when using O_SYNC/O_FSYNC and O_DSYNC.  But only if archiving
+	 * and streaming are disabled, otherwise the archive command or walsender
+	 * process will read the WAL soon after writing it, which is guaranteed to
+	 * cause a physical read if we bypassed the kernel cache. We also skip the
 	 * posix_fadvise(POSIX_FADV_DONTNEED) call in XLogFileClose() for the same
 	 * reason.
 	 *
@@ -10259,7 +10622,7 @@ get_sync_bit(int method)
 	 * don't work with O_DIRECT, so it is required for correctness too.
 	 */
 	if (!XLogIsNeeded() && !AmWalReceiverProcess())
-		o_direct_flag = PG_O_DIRECT;
+		o_sync_direct_flag = PG_O_DIRECT;
 
 	switch (method)
 	{
@@ -10272,14 +10635,14 @@ get_sync_bit(int method)
 		case SYNC_METHOD_FSYNC:
 		case SYNC_METHOD_FSYNC_WRITETHROUGH:
 		case SYNC_METHOD_FDATASYNC:
-			return 0;
+			return o_direct_flag;
 #ifdef OPEN_SYNC_FLAG
 		case SYNC_METHOD_OPEN:
-			return OPEN_SYNC_FLAG | o_direct_flag;
+			return OPEN_SYNC_FLAG | o_direct_flag | o_sync_direct_flag;
 #endif
 #ifdef OPEN_DATASYNC_FLAG
 		case SYNC_METHOD_OPEN_DSYNC:
-			return OPEN_DATASYNC_FLAG | o_direct_flag;
+			return OPEN_DATASYNC_FLAG | o_direct_flag | o_sync_direct_flag;
 #endif
 		default:
 			/* can't happen (unless we are out of sync with option array) */
@@ -11594,6 +11957,16 @@ read_backup_label(XLogRecPtr *checkPointLoc, bool *backupEndRequired,
 						tli_from_file, BACKUP_LABEL_FILE)));
 	}
 
+	/*
+	 * An incremental backup contains only the blocks changed since a prior
+	 * backup, so it can't be started on its own.
+	 */
+	if (fscanf(lfp, INCREMENTAL_FROM_LSN_LABEL ": %X/%X\n", &hi, &lo) > 0)
+		ereport(FATAL,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("this is an incremental backup, not a data directory"),
+				 errhint("Use pg_combinebackup to reconstruct a valid data directory.")));
+
 	if (ferror(lfp) || FreeFile(lfp))
 		ereport(FATAL,
 				(errcode_for_file_access(),
@@ -11688,7 +12061,7 @@ read_tablespace_map(List **tablespaces)
 /*
  * Error context callback for errors occurring during rm_redo().
  */
-static void
+void
 rm_redo_error_callback(void *arg)
 {
 	XLogReaderState *record = (XLogReaderState *) arg;
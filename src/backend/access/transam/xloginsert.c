@@ -19,6 +19,14 @@
 
 #include "postgres.h"
 
+#ifdef USE_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
 #include "access/xact.h"
 #include "access/xlog.h"
 #include "access/xlog_internal.h"
@@ -36,6 +44,20 @@
 /* Buffer size required to store a compressed version of backup block image */
 #define PGLZ_MAX_BLCKSZ PGLZ_MAX_OUTPUT(BLCKSZ)
 
+#ifdef USE_LZ4
+#define LZ4_MAX_BLCKSZ	LZ4_COMPRESSBOUND(BLCKSZ)
+#else
+#define LZ4_MAX_BLCKSZ	0
+#endif
+
+#ifdef USE_ZSTD
+#define ZSTD_MAX_BLCKSZ	ZSTD_COMPRESSBOUND(BLCKSZ)
+#else
+#define ZSTD_MAX_BLCKSZ	0
+#endif
+
+#define COMPRESS_BUFSIZE	Max(Max(PGLZ_MAX_BLCKSZ, LZ4_MAX_BLCKSZ), ZSTD_MAX_BLCKSZ)
+
 /*
  * For each block reference registered with XLogRegisterBuffer, we fill in
  * a registered_buffer struct.
@@ -58,7 +80,7 @@ typedef struct
 								 * backup block data in XLogRecordAssemble() */
 
 	/* buffer to store a compressed version of backup block image */
-	char		compressed_page[PGLZ_MAX_BLCKSZ];
+	char		compressed_page[COMPRESS_BUFSIZE];
 } registered_buffer;
 
 static registered_buffer *registered_buffers;
@@ -88,6 +110,18 @@ static uint8 curinsert_flags = 0;
 static XLogRecData hdr_rdt;
 static char *hdr_scratch = NULL;
 
+/*
+ * Working buffers for compressing record payloads, see
+ * XLogCompressRecordPayload().  They are allocated on first use, possibly
+ * inside a critical section, so they live in a context that permits that.
+ * If allocation fails, the record is simply written uncompressed.
+ */
+static MemoryContext compress_cxt;
+static char *compress_raw_buf = NULL;
+static char *compress_out_buf = NULL;
+static uint32 compress_buf_size = 0;
+static XLogRecData compress_rdt;
+
 #define SizeOfXlogOrigin	(sizeof(RepOriginId) + sizeof(char))
 
 #define HEADER_SCRATCH_SIZE \
@@ -112,6 +146,9 @@ static XLogRecData *XLogRecordAssemble(RmgrId rmid, uint8 info,
 									   XLogRecPtr *fpw_lsn, int *num_fpw);
 static bool XLogCompressBackupBlock(char *page, uint16 hole_offset,
 									uint16 hole_length, char *dest, uint16 *dlen);
+static int32 XLogCompressData(const char *source, int32 slen, char *dest,
+							  int32 capacity);
+static bool XLogCompressRecordPayload(uint32 payload_len, uint32 *total_len);
 
 /*
  * Begin constructing a WAL record. This must be called before the
@@ -494,6 +531,7 @@ XLogRecordAssemble(RmgrId rmid, uint8 info,
 	XLogRecData *rdt_datas_last;
 	XLogRecord *rechdr;
 	char	   *scratch = hdr_scratch;
+	bool		has_image = false;
 
 	/*
 	 * Note: this function can be called multiple times for the same record.
@@ -588,6 +626,8 @@ XLogRecordAssemble(RmgrId rmid, uint8 info,
 			Page		page = regbuf->page;
 			uint16		compressed_len = 0;
 
+			has_image = true;
+
 			/*
 			 * The page needs to be backed up, so calculate its hole length
 			 * and offset.
@@ -622,7 +662,7 @@ XLogRecordAssemble(RmgrId rmid, uint8 info,
 			/*
 			 * Try to compress a block image if wal_compression is enabled
 			 */
-			if (wal_compression)
+			if (wal_compression != WAL_COMPRESSION_NONE)
 			{
 				is_compressed =
 					XLogCompressBackupBlock(page, bimg.hole_offset,
@@ -659,8 +699,24 @@ XLogRecordAssemble(RmgrId rmid, uint8 info,
 
 			if (is_compressed)
 			{
+				/* The current compression is stored in the WAL record */
 				bimg.length = compressed_len;
-				bimg.bimg_info |= BKPIMAGE_IS_COMPRESSED;
+
+				switch ((WalCompression) wal_compression)
+				{
+					case WAL_COMPRESSION_PGLZ:
+						bimg.bimg_info |= BKPIMAGE_COMPRESS_PGLZ;
+						break;
+					case WAL_COMPRESSION_LZ4:
+						bimg.bimg_info |= BKPIMAGE_COMPRESS_LZ4;
+						break;
+					case WAL_COMPRESSION_ZSTD:
+						bimg.bimg_info |= BKPIMAGE_COMPRESS_ZSTD;
+						break;
+					case WAL_COMPRESSION_NONE:
+						Assert(false);	/* cannot happen */
+						break;
+				}
 
 				rdt_datas_last->data = regbuf->compressed_page;
 				rdt_datas_last->len = compressed_len;
@@ -771,6 +827,23 @@ XLogRecordAssemble(RmgrId rmid, uint8 info,
 	hdr_rdt.len = (scratch - hdr_scratch);
 	total_len += hdr_rdt.len;
 
+	/*
+	 * Compress the whole payload if it is large enough.  Records carrying
+	 * full-page images are left alone, since the images are compressed on
+	 * their own already.  So are XLOG records, because xlog.c cross-checks
+	 * the length of some of them before decoding (see ReadCheckpointRecord).
+	 */
+	if (wal_compression != WAL_COMPRESSION_NONE &&
+		wal_record_compression_threshold >= 0 &&
+		!has_image && rmid != RM_XLOG_ID &&
+		total_len > SizeOfXLogRecord &&
+		total_len - SizeOfXLogRecord >= wal_record_compression_threshold)
+	{
+		if (XLogCompressRecordPayload(total_len - SizeOfXLogRecord,
+									  &total_len))
+			info |= XLR_COMPRESSED;
+	}
+
 	/*
 	 * Calculate CRC of the data
 	 *
@@ -835,11 +908,11 @@ XLogCompressBackupBlock(char *page, uint16 hole_offset, uint16 hole_length,
 		source = page;
 
 	/*
-	 * We recheck the actual size even if pglz_compress() reports success and
-	 * see if the number of bytes saved by compression is larger than the
-	 * length of extra data needed for the compressed version of block image.
+	 * We recheck the actual size even if compression reports success and see
+	 * if the number of bytes saved by compression is larger than the length
+	 * of extra data needed for the compressed version of block image.
 	 */
-	len = pglz_compress(source, orig_len, dest, PGLZ_strategy_default);
+	len = XLogCompressData(source, orig_len, dest, COMPRESS_BUFSIZE);
 	if (len >= 0 &&
 		len + extra_bytes < orig_len)
 	{
@@ -849,6 +922,164 @@ XLogCompressBackupBlock(char *page, uint16 hole_offset, uint16 hole_length,
 	return false;
 }
 
+/*
+ * Compress 'slen' bytes at 'source' into 'dest' with the wal_compression
+ * method.  'capacity' is the size of 'dest'; for pglz it must be at least
+ * PGLZ_MAX_OUTPUT(slen).
+ *
+ * Returns the compressed length, or -1 if the data could not be compressed
+ * into the available space.
+ */
+static int32
+XLogCompressData(const char *source, int32 slen, char *dest, int32 capacity)
+{
+	int32		len = -1;
+
+	switch ((WalCompression) wal_compression)
+	{
+		case WAL_COMPRESSION_PGLZ:
+			len = pglz_compress(source, slen, dest, PGLZ_strategy_default);
+			break;
+
+		case WAL_COMPRESSION_LZ4:
+#ifdef USE_LZ4
+			len = LZ4_compress_default(source, dest, slen, capacity);
+			if (len <= 0)
+				len = -1;		/* failure */
+#else
+			elog(ERROR, "LZ4 is not supported by this build");
+#endif
+			break;
+
+		case WAL_COMPRESSION_ZSTD:
+#ifdef USE_ZSTD
+			{
+				size_t		zlen;
+
+				zlen = ZSTD_compress(dest, capacity, source, slen,
+									 ZSTD_CLEVEL_DEFAULT);
+				len = ZSTD_isError(zlen) ? -1 : (int32) zlen;
+			}
+#else
+			elog(ERROR, "zstd is not supported by this build");
+#endif
+			break;
+
+		case WAL_COMPRESSION_NONE:
+			Assert(false);		/* cannot happen */
+			break;
+			/* no default case, so that compiler will warn */
+	}
+
+	return len;
+}
+
+/*
+ * Replace the payload of the record being assembled with a compressed copy.
+ *
+ * The payload is everything after the fixed-size XLogRecord header in the
+ * chain starting at hdr_rdt, 'payload_len' bytes in total.  On success, the
+ * chain is rewritten to consist of the record header, an
+ * XLogRecordCompressedHeader and the compressed data, *total_len is updated
+ * and true is returned.  Returns false, leaving the chain untouched, if the
+ * payload doesn't compress well enough or no working memory is available.
+ */
+static bool
+XLogCompressRecordPayload(uint32 payload_len, uint32 *total_len)
+{
+	XLogRecData *rdt;
+	XLogRecordCompressedHeader chdr;
+	char	   *ptr;
+	int32		len;
+
+	if (payload_len > PG_INT32_MAX / 2)
+		return false;
+
+	/* Make sure the working buffers are large enough */
+	if (compress_buf_size < payload_len)
+	{
+		uint32		newsize = Max(payload_len, BLCKSZ);
+
+		if (compress_raw_buf)
+			pfree(compress_raw_buf);
+		if (compress_out_buf)
+			pfree(compress_out_buf);
+		compress_buf_size = 0;
+
+		compress_raw_buf = MemoryContextAllocExtended(compress_cxt, newsize,
+													  MCXT_ALLOC_NO_OOM);
+		compress_out_buf = MemoryContextAllocExtended(compress_cxt,
+													  PGLZ_MAX_OUTPUT(newsize),
+													  MCXT_ALLOC_NO_OOM);
+		if (compress_raw_buf == NULL || compress_out_buf == NULL)
+		{
+			if (compress_raw_buf)
+				pfree(compress_raw_buf);
+			if (compress_out_buf)
+				pfree(compress_out_buf);
+			compress_raw_buf = compress_out_buf = NULL;
+			return false;
+		}
+		compress_buf_size = newsize;
+	}
+
+	/* Flatten the payload */
+	ptr = compress_raw_buf;
+	memcpy(ptr, hdr_scratch + SizeOfXLogRecord, hdr_rdt.len - SizeOfXLogRecord);
+	ptr += hdr_rdt.len - SizeOfXLogRecord;
+	for (rdt = hdr_rdt.next; rdt != NULL; rdt = rdt->next)
+	{
+		memcpy(ptr, rdt->data, rdt->len);
+		ptr += rdt->len;
+	}
+	Assert(ptr - compress_raw_buf == payload_len);
+
+	/*
+	 * Only use the compressed version if it's smaller than the original,
+	 * counting the extra header.  Capping the output at the original length
+	 * lets lz4 and zstd give up early.
+	 */
+	len = XLogCompressData(compress_raw_buf, payload_len, compress_out_buf,
+						   payload_len);
+	if (len < 0 ||
+		len + SizeOfXLogRecordCompressedHeader >= payload_len)
+		return false;
+
+	chdr.method = 0;
+	chdr.raw_length = payload_len;
+	switch ((WalCompression) wal_compression)
+	{
+		case WAL_COMPRESSION_PGLZ:
+			chdr.method = XLR_COMPRESSION_PGLZ;
+			break;
+		case WAL_COMPRESSION_LZ4:
+			chdr.method = XLR_COMPRESSION_LZ4;
+			break;
+		case WAL_COMPRESSION_ZSTD:
+			chdr.method = XLR_COMPRESSION_ZSTD;
+			break;
+		case WAL_COMPRESSION_NONE:
+			Assert(false);		/* cannot happen */
+			break;
+	}
+
+	/* Rewrite the chain: record header, compression header, compressed data */
+	ptr = hdr_scratch + SizeOfXLogRecord;
+	memcpy(ptr, &chdr.method, sizeof(uint8));
+	ptr += sizeof(uint8);
+	memcpy(ptr, &chdr.raw_length, sizeof(uint32));
+	hdr_rdt.len = SizeOfXLogRecord + SizeOfXLogRecordCompressedHeader;
+
+	compress_rdt.data = compress_out_buf;
+	compress_rdt.len = len;
+	compress_rdt.next = NULL;
+	hdr_rdt.next = &compress_rdt;
+
+	*total_len = hdr_rdt.len + len;
+
+	return true;
+}
+
 /*
  * Determine whether the buffer referenced has to be backed up.
  *
@@ -1148,4 +1379,12 @@ InitXLogInsert(void)
 	if (hdr_scratch == NULL)
 		hdr_scratch = MemoryContextAllocZero(xloginsert_cxt,
 											 HEADER_SCRATCH_SIZE);
+
+	if (compress_cxt == NULL)
+	{
+		compress_cxt = AllocSetContextCreate(xloginsert_cxt,
+											 "WAL record compression",
+											 ALLOCSET_DEFAULT_SIZES);
+		MemoryContextAllowInCriticalSection(compress_cxt, true);
+	}
 }
@@ -0,0 +1,890 @@
+/*-------------------------------------------------------------------------
+ *
+ * xlogparallel.c
+ *		Parallel WAL redo.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *		src/backend/access/transam/xlogparallel.c
+ *
+ * When max_parallel_redo_workers is set, the startup process launches a pool
+ * of background workers at the start of redo and hands them the records that
+ * only modify blocks of a single relation.  Each relation is assigned to one
+ * worker by hashing its RelFileNode, and each worker replays the records it
+ * receives in WAL order, so all changes to a given block (and to the other
+ * forks of its relation, which redo routines such as heap_xlog_visible()
+ * update together with the main fork) are still applied in order.
+ *
+ * Everything else is replayed by the startup process itself.  Before
+ * replaying a record with global effects (checkpoints, relation and database
+ * creation and removal, relation map updates, ...), the startup process
+ * waits for the workers to finish all the records handed to them so far, so
+ * that such a record sees the effects of all earlier records, as in serial
+ * redo.  Commit and abort records that don't drop relations, and the
+ * transaction status records of the clog, commit_ts, multixact and standby
+ * resource managers, don't depend on the contents of relation pages and are
+ * replayed without waiting.
+ *
+ * Since the workers apply records out of WAL order across relations, a
+ * snapshot taken during recovery could see an inconsistent state.  Parallel
+ * redo is therefore used only when hot standby is disabled: during crash
+ * recovery, and in archive recovery and streaming replication with
+ * hot_standby = off.  lastReplayedEndRecPtr covers records that have been
+ * handed to a worker but not yet replayed; before deciding that a consistent
+ * state has been reached, and at the end of recovery, the startup process
+ * waits for the workers to catch up.
+ *
+ * Workers keep their own table of references to invalid pages.  The startup
+ * process forwards relation and database drops and truncations to them, and
+ * asks them to check their tables when reaching consistency.  During crash
+ * recovery there is no checkpointer, so workers remember their fsync requests
+ * locally and perform them before relation files are unlinked, and before
+ * they exit.
+ *
+ * A worker that fails to replay a record reports the error and exits, and
+ * the startup process then exits with FATAL, as if it had failed to replay
+ * the record itself.
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/rmgr.h"
+#include "access/xact.h"
+#include "access/xlog.h"
+#include "access/xlog_internal.h"
+#include "access/xlogparallel.h"
+#include "access/xlogutils.h"
+#include "catalog/pg_control.h"
+#include "common/hashfn.h"
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "port/atomics.h"
+#include "postmaster/bgworker.h"
+#include "storage/dsm.h"
+#include "storage/ipc.h"
+#include "storage/latch.h"
+#include "storage/md.h"
+#include "storage/proc.h"
+#include "storage/shm_mq.h"
+#include "storage/smgr.h"
+#include "storage/sync.h"
+#include "utils/memutils.h"
+#include "utils/resowner.h"
+
+/* Size of each worker's message queue. */
+#define PARALLEL_REDO_QUEUE_SIZE		(256 * 1024)
+
+/* GUCs */
+int			max_parallel_redo_workers = 0;
+
+typedef enum
+{
+	PARALLEL_REDO_MSG_RECORD,	/* replay the record that follows */
+	PARALLEL_REDO_MSG_DROP_RELATION,	/* relation fork is being dropped */
+	PARALLEL_REDO_MSG_TRUNCATE_RELATION,	/* relation fork was truncated */
+	PARALLEL_REDO_MSG_DROP_DATABASE,	/* database is being dropped */
+	PARALLEL_REDO_MSG_CONSISTENT	/* consistent state has been reached */
+} ParallelRedoMessageType;
+
+/*
+ * Header of a message sent to a worker.  For records, the XLogRecord
+ * follows, so the size must be a multiple of MAXIMUM_ALIGNOF.
+ */
+typedef struct ParallelRedoMessage
+{
+	XLogRecPtr	ReadRecPtr;		/* start of the record */
+	XLogRecPtr	EndRecPtr;		/* end+1 of the record */
+	ParallelRedoMessageType type;
+	RelFileNode rnode;			/* relation to drop or truncate */
+	ForkNumber	forknum;
+	BlockNumber nblocks;		/* new size, if truncated */
+	Oid			dbid;			/* database to drop */
+} ParallelRedoMessage;
+
+/*
+ * Per-worker state in the shared memory segment.
+ */
+typedef struct ParallelRedoWorkerSlot
+{
+	pg_atomic_uint64 nprocessed;	/* number of messages processed */
+	bool		have_invalid_pages; /* any unresolved invalid pages? */
+} ParallelRedoWorkerSlot;
+
+/*
+ * Layout of the shared memory segment: this struct, then one message queue
+ * per worker.
+ */
+typedef struct ParallelRedoShared
+{
+	int			nworkers;		/* number of slots and queues */
+	bool		local_sync;		/* no checkpointer to forward fsyncs to */
+	bool		reached_consistency;	/* value when workers were started */
+	int			leader_pgprocno;	/* the startup process */
+	pg_atomic_uint32 leader_waiting;	/* startup process waits for us */
+	pg_atomic_uint32 nfailed;	/* number of workers that failed */
+	ParallelRedoWorkerSlot slots[FLEXIBLE_ARRAY_MEMBER];
+} ParallelRedoShared;
+
+#define PARALLEL_REDO_QUEUE_OFFSET(nworkers) \
+	MAXALIGN(offsetof(ParallelRedoShared, slots) + \
+			 sizeof(ParallelRedoWorkerSlot) * (nworkers))
+
+/*
+ * Startup process's private state, for the workers that could be started.
+ */
+typedef struct ParallelRedoLeader
+{
+	dsm_segment *seg;
+	ParallelRedoShared *shared;
+	int			nworkers;		/* number of workers running */
+	int		   *slotno;			/* their slot numbers */
+	BackgroundWorkerHandle **handles;
+	shm_mq_handle **mqh;
+	uint64	   *nsent;			/* number of messages sent to each */
+} ParallelRedoLeader;
+
+/* Non-NULL in the startup process while parallel redo is active. */
+static ParallelRedoLeader *leader = NULL;
+
+/* In a worker, our state in the shared memory segment. */
+static ParallelRedoShared *MyParallelRedoShared = NULL;
+
+static int	ParallelRedoChooseWorker(XLogReaderState *record);
+static bool ParallelRedoNeedsBarrier(XLogReaderState *record);
+static void ParallelRedoSend(int n, ParallelRedoMessage *msg,
+							 XLogRecord *record);
+static void ParallelRedoBroadcast(ParallelRedoMessage *msg);
+static void ParallelRedoApply(XLogReaderState *reader,
+							  ParallelRedoMessage *msg, XLogRecord *record);
+static void ParallelRedoWorkerExit(int code, Datum arg);
+
+/*
+ * Launch the parallel redo workers.  Called by the startup process at the
+ * start of redo, when hot standby is disabled.  local_sync indicates that
+ * there's no checkpointer running to forward fsync requests to.
+ *
+ * Returns false if no workers could be started, in which case redo proceeds
+ * in the startup process alone.
+ */
+bool
+ParallelRedoStart(bool local_sync)
+{
+	int			nworkers = max_parallel_redo_workers;
+	Size		size;
+	dsm_segment *seg;
+	ParallelRedoShared *shared;
+	ParallelRedoLeader *pr;
+	BackgroundWorker worker;
+	BackgroundWorkerHandle **handles;
+	MemoryContext oldcontext;
+	int			nregistered;
+	int			i;
+
+	Assert(leader == NULL);
+	Assert(AmStartupProcess());
+
+	/* There's no postmaster to launch workers in single-user mode. */
+	if (nworkers <= 0 || !IsUnderPostmaster)
+		return false;
+
+	size = add_size(PARALLEL_REDO_QUEUE_OFFSET(nworkers),
+					mul_size(nworkers, PARALLEL_REDO_QUEUE_SIZE));
+	seg = dsm_create(size, DSM_CREATE_NULL_IF_MAXSEGMENTS);
+	if (seg == NULL)
+	{
+		ereport(LOG,
+				(errmsg("could not create shared memory segment for parallel redo")));
+		return false;
+	}
+
+	/* Keep the segment mapped until ParallelRedoFinish(). */
+	dsm_pin_mapping(seg);
+
+	shared = dsm_segment_address(seg);
+	shared->nworkers = nworkers;
+	shared->local_sync = local_sync;
+	shared->reached_consistency = reachedConsistency;
+	shared->leader_pgprocno = MyProc->pgprocno;
+	pg_atomic_init_u32(&shared->leader_waiting, 0);
+	pg_atomic_init_u32(&shared->nfailed, 0);
+
+	oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+
+	pr = palloc0(sizeof(ParallelRedoLeader));
+	pr->seg = seg;
+	pr->shared = shared;
+	pr->slotno = palloc0(sizeof(int) * nworkers);
+	pr->handles = palloc0(sizeof(BackgroundWorkerHandle *) * nworkers);
+	pr->mqh = palloc0(sizeof(shm_mq_handle *) * nworkers);
+	pr->nsent = palloc0(sizeof(uint64) * nworkers);
+	handles = palloc0(sizeof(BackgroundWorkerHandle *) * nworkers);
+
+	memset(&worker, 0, sizeof(worker));
+	worker.bgw_flags = BGWORKER_SHMEM_ACCESS;
+	worker.bgw_start_time = BgWorkerStart_PostmasterStart;
+	worker.bgw_restart_time = BGW_NEVER_RESTART;
+	sprintf(worker.bgw_library_name, "postgres");
+	sprintf(worker.bgw_function_name, "ParallelRedoWorkerMain");
+	snprintf(worker.bgw_type, BGW_MAXLEN, "parallel redo worker");
+	worker.bgw_main_arg = UInt32GetDatum(dsm_segment_handle(seg));
+	worker.bgw_notify_pid = MyProcPid;
+
+	/* Register all the workers first, so that they start concurrently. */
+	for (nregistered = 0; nregistered < nworkers; nregistered++)
+	{
+		ParallelRedoWorkerSlot *slot = &shared->slots[nregistered];
+		shm_mq	   *mq;
+
+		pg_atomic_init_u64(&slot->nprocessed, 0);
+		slot->have_invalid_pages = false;
+
+		mq = shm_mq_create((char *) shared +
+						   PARALLEL_REDO_QUEUE_OFFSET(nworkers) +
+						   nregistered * PARALLEL_REDO_QUEUE_SIZE,
+						   PARALLEL_REDO_QUEUE_SIZE);
+		shm_mq_set_sender(mq, MyProc);
+
+		snprintf(worker.bgw_name, BGW_MAXLEN, "parallel redo worker %d",
+				 nregistered);
+		memcpy(worker.bgw_extra, &nregistered, sizeof(int));
+		if (!RegisterDynamicBackgroundWorker(&worker, &handles[nregistered]))
+			break;
+	}
+
+	/* Keep the workers that started successfully. */
+	for (i = 0; i < nregistered; i++)
+	{
+		pid_t		pid;
+		shm_mq	   *mq;
+
+		if (WaitForBackgroundWorkerStartup(handles[i], &pid) != BGWH_STARTED)
+		{
+			pfree(handles[i]);
+			continue;
+		}
+
+		mq = (shm_mq *) ((char *) shared +
+						 PARALLEL_REDO_QUEUE_OFFSET(nworkers) +
+						 i * PARALLEL_REDO_QUEUE_SIZE);
+		pr->slotno[pr->nworkers] = i;
+		pr->handles[pr->nworkers] = handles[i];
+		pr->mqh[pr->nworkers] = shm_mq_attach(mq, seg, handles[i]);
+		pr->nworkers++;
+	}
+	pfree(handles);
+
+	MemoryContextSwitchTo(oldcontext);
+
+	if (pr->nworkers == 0)
+	{
+		ereport(LOG,
+				(errmsg("could not start parallel redo workers"),
+				 errhint("You might need to increase max_worker_processes.")));
+		dsm_detach(seg);
+		pfree(pr->slotno);
+		pfree(pr->handles);
+		pfree(pr->mqh);
+		pfree(pr->nsent);
+		pfree(pr);
+		return false;
+	}
+
+	ereport(LOG,
+			(errmsg_plural("using %d parallel redo worker",
+						   "using %d parallel redo workers",
+						   pr->nworkers, pr->nworkers)));
+
+	leader = pr;
+
+	return true;
+}
+
+/*
+ * Hand the record that the startup process is about to replay to a worker,
+ * if possible.  Returns true if the record was sent to a worker.  Otherwise,
+ * the caller must replay the record itself; we have already waited for the
+ * workers to catch up if the record requires that.
+ */
+bool
+ParallelRedoDispatch(XLogReaderState *record)
+{
+	ParallelRedoMessage msg;
+	int			n;
+
+	if (leader == NULL)
+		return false;
+
+	n = ParallelRedoChooseWorker(record);
+	if (n < 0)
+	{
+		if (ParallelRedoNeedsBarrier(record))
+			ParallelRedoWaitForWorkers();
+		return false;
+	}
+
+	memset(&msg, 0, sizeof(msg));
+	msg.type = PARALLEL_REDO_MSG_RECORD;
+	msg.ReadRecPtr = record->ReadRecPtr;
+	msg.EndRecPtr = record->EndRecPtr;
+	ParallelRedoSend(n, &msg, record->decoded_record);
+
+	return true;
+}
+
+/*
+ * Choose the worker to replay a record, or return -1 if the record must be
+ * replayed by the startup process.
+ */
+static int
+ParallelRedoChooseWorker(XLogReaderState *record)
+{
+	uint8		info = XLogRecGetInfo(record) & ~XLR_INFO_MASK;
+	RelFileNode rnode;
+	bool		found = false;
+	int			block_id;
+
+	/* Pages are compared with the images right after replay */
+	if ((XLogRecGetInfo(record) & XLR_CHECK_CONSISTENCY) != 0)
+		return -1;
+
+	/*
+	 * Only resource managers whose records modify nothing but the blocks they
+	 * reference can be replayed out of order with other relations.
+	 */
+	switch (XLogRecGetRmid(record))
+	{
+		case RM_HEAP_ID:
+		case RM_HEAP2_ID:
+		case RM_BTREE_ID:
+		case RM_HASH_ID:
+		case RM_GIN_ID:
+		case RM_GIST_ID:
+		case RM_SEQ_ID:
+		case RM_SPGIST_ID:
+		case RM_BRIN_ID:
+		case RM_GENERIC_ID:
+			break;
+		case RM_XLOG_ID:
+			if (info == XLOG_FPI || info == XLOG_FPI_FOR_HINT)
+				break;
+			return -1;
+		default:
+			return -1;
+	}
+
+	for (block_id = 0; block_id <= record->max_block_id; block_id++)
+	{
+		RelFileNode blk_rnode;
+
+		if (!XLogRecGetBlockTag(record, block_id, &blk_rnode, NULL, NULL))
+			continue;
+
+		if (!found)
+		{
+			rnode = blk_rnode;
+			found = true;
+		}
+		else if (!RelFileNodeEquals(rnode, blk_rnode))
+			return -1;
+	}
+
+	/* Records without blocks, such as heap truncation, have other effects */
+	if (!found)
+		return -1;
+
+	return hash_bytes((const unsigned char *) &rnode, sizeof(rnode)) %
+		leader->nworkers;
+}
+
+/*
+ * Does the startup process have to wait for the workers before replaying a
+ * record itself?
+ */
+static bool
+ParallelRedoNeedsBarrier(XLogReaderState *record)
+{
+	uint8		info = XLogRecGetInfo(record) & ~XLR_INFO_MASK;
+
+	switch (XLogRecGetRmid(record))
+	{
+		case RM_CLOG_ID:
+		case RM_COMMIT_TS_ID:
+		case RM_MULTIXACT_ID:
+		case RM_STANDBY_ID:
+			return false;
+
+		case RM_XACT_ID:
+			switch (info & XLOG_XACT_OPMASK)
+			{
+				case XLOG_XACT_COMMIT:
+				case XLOG_XACT_COMMIT_PREPARED:
+					{
+						xl_xact_parsed_commit parsed;
+
+						ParseCommitRecord(XLogRecGetInfo(record),
+										  (xl_xact_commit *) XLogRecGetData(record),
+										  &parsed);
+						return parsed.nrels > 0;
+					}
+				case XLOG_XACT_ABORT:
+				case XLOG_XACT_ABORT_PREPARED:
+					{
+						xl_xact_parsed_abort parsed;
+
+						ParseAbortRecord(XLogRecGetInfo(record),
+										 (xl_xact_abort *) XLogRecGetData(record),
+										 &parsed);
+						return parsed.nrels > 0;
+					}
+				case XLOG_XACT_ASSIGNMENT:
+					return false;
+				default:
+					return true;
+			}
+
+		default:
+			return true;
+	}
+}
+
+/*
+ * Send a message to the n'th running worker.
+ */
+static void
+ParallelRedoSend(int n, ParallelRedoMessage *msg, XLogRecord *record)
+{
+	shm_mq_iovec iov[2];
+	int			iovcnt = 1;
+
+	StaticAssertStmt(sizeof(ParallelRedoMessage) ==
+					 MAXALIGN(sizeof(ParallelRedoMessage)),
+					 "ParallelRedoMessage must be maxaligned");
+
+	iov[0].data = (const char *) msg;
+	iov[0].len = sizeof(ParallelRedoMessage);
+	if (record != NULL)
+	{
+		iov[1].data = (const char *) record;
+		iov[1].len = record->xl_tot_len;
+		iovcnt = 2;
+	}
+
+	if (shm_mq_sendv(leader->mqh[n], iov, iovcnt, false) != SHM_MQ_SUCCESS)
+		ereport(FATAL,
+				(errmsg("parallel redo worker exited unexpectedly")));
+
+	leader->nsent[n]++;
+}
+
+/*
+ * Send a message to all running workers.
+ */
+static void
+ParallelRedoBroadcast(ParallelRedoMessage *msg)
+{
+	int			n;
+
+	for (n = 0; n < leader->nworkers; n++)
+		ParallelRedoSend(n, msg, NULL);
+}
+
+/*
+ * Wait until the workers have processed all the messages sent to them.
+ */
+void
+ParallelRedoWaitForWorkers(void)
+{
+	ParallelRedoShared *shared;
+
+	if (leader == NULL)
+		return;
+
+	shared = leader->shared;
+
+	/* Ask the workers to wake us up; pairs with barrier in the workers */
+	pg_atomic_write_u32(&shared->leader_waiting, 1);
+	pg_memory_barrier();
+
+	for (;;)
+	{
+		int			n;
+
+		ParallelRedoCheckWorkers();
+
+		for (n = 0; n < leader->nworkers; n++)
+		{
+			ParallelRedoWorkerSlot *slot = &shared->slots[leader->slotno[n]];
+
+			if (pg_atomic_read_u64(&slot->nprocessed) != leader->nsent[n])
+				break;
+		}
+		if (n == leader->nworkers)
+			break;
+
+		(void) WaitLatch(MyLatch, WL_LATCH_SET | WL_EXIT_ON_PM_DEATH, -1L,
+						 WAIT_EVENT_PARALLEL_REDO_DRAIN);
+		ResetLatch(MyLatch);
+	}
+
+	pg_atomic_write_u32(&shared->leader_waiting, 0);
+}
+
+/*
+ * Exit if a worker has failed.  Called by the startup process regularly,
+ * also while it waits for WAL, so that a failure is noticed promptly.
+ */
+void
+ParallelRedoCheckWorkers(void)
+{
+	if (leader != NULL && pg_atomic_read_u32(&leader->shared->nfailed) > 0)
+		ereport(FATAL,
+				(errmsg("parallel redo worker exited unexpectedly")));
+}
+
+/*
+ * Called by the startup process when recovery has reached a consistent state.
+ * Makes sure that all records up to this point have been replayed, and that
+ * the workers haven't seen references to invalid pages.
+ */
+void
+ParallelRedoReachedConsistency(void)
+{
+	ParallelRedoMessage msg;
+
+	if (leader == NULL)
+		return;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.type = PARALLEL_REDO_MSG_CONSISTENT;
+	ParallelRedoBroadcast(&msg);
+	ParallelRedoWaitForWorkers();
+}
+
+/*
+ * Have any of the workers seen references to invalid pages?  Only accurate
+ * after ParallelRedoWaitForWorkers().
+ */
+bool
+ParallelRedoHaveInvalidPages(void)
+{
+	int			n;
+
+	if (leader == NULL)
+		return false;
+
+	for (n = 0; n < leader->nworkers; n++)
+	{
+		volatile ParallelRedoWorkerSlot *slot =
+		&leader->shared->slots[leader->slotno[n]];
+
+		if (slot->have_invalid_pages)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Tell the workers that a relation fork is about to be dropped.  Waits for
+ * them to let go of the files, since the caller will unlink them next.
+ */
+void
+ParallelRedoDropRelation(RelFileNode rnode, ForkNumber forknum)
+{
+	ParallelRedoMessage msg;
+
+	if (leader == NULL)
+		return;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.type = PARALLEL_REDO_MSG_DROP_RELATION;
+	msg.rnode = rnode;
+	msg.forknum = forknum;
+	ParallelRedoBroadcast(&msg);
+	ParallelRedoWaitForWorkers();
+}
+
+/*
+ * Tell the workers that a relation fork has been truncated.
+ */
+void
+ParallelRedoTruncateRelation(RelFileNode rnode, ForkNumber forknum,
+							 BlockNumber nblocks)
+{
+	ParallelRedoMessage msg;
+
+	if (leader == NULL)
+		return;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.type = PARALLEL_REDO_MSG_TRUNCATE_RELATION;
+	msg.rnode = rnode;
+	msg.forknum = forknum;
+	msg.nblocks = nblocks;
+	ParallelRedoBroadcast(&msg);
+}
+
+/*
+ * Tell the workers that a database is about to be dropped, and wait for them
+ * to let go of its files.
+ */
+void
+ParallelRedoDropDatabase(Oid dbid)
+{
+	ParallelRedoMessage msg;
+
+	if (leader == NULL)
+		return;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.type = PARALLEL_REDO_MSG_DROP_DATABASE;
+	msg.dbid = dbid;
+	ParallelRedoBroadcast(&msg);
+	ParallelRedoWaitForWorkers();
+}
+
+/*
+ * Wait for the workers to replay all the records handed to them, and shut
+ * them down.  Called by the startup process at the end of redo.
+ */
+void
+ParallelRedoFinish(void)
+{
+	int			n;
+
+	if (leader == NULL)
+		return;
+
+	ParallelRedoWaitForWorkers();
+
+	/* Workers exit when they see that we have detached from their queue. */
+	for (n = 0; n < leader->nworkers; n++)
+		shm_mq_detach(leader->mqh[n]);
+	for (n = 0; n < leader->nworkers; n++)
+		(void) WaitForBackgroundWorkerShutdown(leader->handles[n]);
+
+	/* A worker could have failed to perform its fsyncs before exiting. */
+	ParallelRedoCheckWorkers();
+
+	dsm_detach(leader->seg);
+
+	for (n = 0; n < leader->nworkers; n++)
+		pfree(leader->handles[n]);
+	pfree(leader->slotno);
+	pfree(leader->handles);
+	pfree(leader->mqh);
+	pfree(leader->nsent);
+	pfree(leader);
+	leader = NULL;
+}
+
+/*
+ * Replay one record in a worker.
+ */
+static void
+ParallelRedoApply(XLogReaderState *reader, ParallelRedoMessage *msg,
+				  XLogRecord *record)
+{
+	ErrorContextCallback errcallback;
+	MemoryContext oldcontext;
+	char	   *errormsg;
+	bool		decoded;
+
+	reader->ReadRecPtr = msg->ReadRecPtr;
+	reader->EndRecPtr = msg->EndRecPtr;
+
+	/*
+	 * The reader keeps the buffers it decodes into for the next record, so
+	 * they must outlive the per-record context we're called in.
+	 */
+	oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+	decoded = DecodeXLogRecord(reader, record, &errormsg);
+	MemoryContextSwitchTo(oldcontext);
+	if (!decoded)
+		elog(ERROR, "could not decode WAL record at %X/%X: %s",
+			 (uint32) (msg->ReadRecPtr >> 32), (uint32) msg->ReadRecPtr,
+			 errormsg);
+
+	/* Setup error traceback support for ereport() */
+	errcallback.callback = rm_redo_error_callback;
+	errcallback.arg = (void *) reader;
+	errcallback.previous = error_context_stack;
+	error_context_stack = &errcallback;
+
+	RmgrTable[record->xl_rmid].rm_redo(reader);
+
+	error_context_stack = errcallback.previous;
+}
+
+/*
+ * Let the startup process know if we exit before it told us to, which means
+ * that we failed.
+ */
+static void
+ParallelRedoWorkerExit(int code, Datum arg)
+{
+	ParallelRedoShared *shared = MyParallelRedoShared;
+
+	if (code == 0)
+		return;
+
+	pg_atomic_fetch_add_u32(&shared->nfailed, 1);
+	SetLatch(&GetPGProcByNumber(shared->leader_pgprocno)->procLatch);
+	WakeupRecovery();
+}
+
+/*
+ * Main entry point for parallel redo workers.
+ */
+void
+ParallelRedoWorkerMain(Datum main_arg)
+{
+	int			worker_number;
+	dsm_segment *seg;
+	ParallelRedoShared *shared;
+	ParallelRedoWorkerSlot *slot;
+	Latch	   *leader_latch;
+	shm_mq	   *mq;
+	shm_mq_handle *mqh;
+	XLogReaderState *reader;
+	MemoryContext redo_context;
+	int			rmid;
+
+	memcpy(&worker_number, MyBgworkerEntry->bgw_extra, sizeof(int));
+
+	/*
+	 * Stopping in the middle of a record could leave a partially modified
+	 * page to be written out by a restartpoint, so ignore SIGTERM.  We exit
+	 * when the startup process detaches from our queue, after replaying the
+	 * records it has sent us.
+	 */
+	pqsignal(SIGTERM, SIG_IGN);
+	BackgroundWorkerUnblockSignals();
+
+	CurrentResourceOwner = ResourceOwnerCreate(NULL, "parallel redo worker");
+
+	seg = dsm_attach(DatumGetUInt32(main_arg));
+	if (seg == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("could not map dynamic shared memory segment")));
+	shared = dsm_segment_address(seg);
+	slot = &shared->slots[worker_number];
+	leader_latch = &GetPGProcByNumber(shared->leader_pgprocno)->procLatch;
+
+	MyParallelRedoShared = shared;
+	before_shmem_exit(ParallelRedoWorkerExit, 0);
+
+	mq = (shm_mq *) ((char *) shared +
+					 PARALLEL_REDO_QUEUE_OFFSET(shared->nworkers) +
+					 worker_number * PARALLEL_REDO_QUEUE_SIZE);
+	shm_mq_set_receiver(mq, MyProc);
+	mqh = shm_mq_attach(mq, seg, NULL);
+
+	/* We replay WAL records, like the startup process. */
+	InRecovery = true;
+	reachedConsistency = shared->reached_consistency;
+	if (shared->local_sync)
+		DisableSyncRequestForwarding();
+
+	reader = XLogReaderAllocate(wal_segment_size, NULL, NULL, NULL);
+	if (reader == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of memory"),
+				 errdetail("Failed while allocating a WAL reading processor.")));
+
+	for (rmid = 0; rmid <= RM_MAX_ID; rmid++)
+	{
+		if (RmgrTable[rmid].rm_startup != NULL)
+			RmgrTable[rmid].rm_startup();
+	}
+
+	redo_context = AllocSetContextCreate(TopMemoryContext,
+										 "parallel redo",
+										 ALLOCSET_DEFAULT_SIZES);
+
+	for (;;)
+	{
+		ParallelRedoMessage msg;
+		MemoryContext oldcontext;
+		Size		nbytes;
+		void	   *data;
+		RelFileNodeBackend rbnode;
+
+		if (shm_mq_receive(mqh, &nbytes, &data, false) != SHM_MQ_SUCCESS)
+			break;				/* the startup process has detached */
+
+		if (nbytes < sizeof(ParallelRedoMessage))
+			elog(ERROR, "invalid parallel redo message size %zu", nbytes);
+		memcpy(&msg, data, sizeof(ParallelRedoMessage));
+
+		oldcontext = MemoryContextSwitchTo(redo_context);
+
+		switch (msg.type)
+		{
+			case PARALLEL_REDO_MSG_RECORD:
+				ParallelRedoApply(reader, &msg,
+								  (XLogRecord *) ((char *) data +
+												  sizeof(ParallelRedoMessage)));
+				break;
+
+			case PARALLEL_REDO_MSG_DROP_RELATION:
+				XLogDropRelation(msg.rnode, msg.forknum);
+				rbnode.node = msg.rnode;
+				rbnode.backend = InvalidBackendId;
+				smgrclosenode(rbnode);
+				/* Our fsyncs must be done before the file is unlinked */
+				if (shared->local_sync)
+					ProcessSyncRequests();
+				break;
+
+			case PARALLEL_REDO_MSG_TRUNCATE_RELATION:
+				XLogTruncateRelation(msg.rnode, msg.forknum, msg.nblocks);
+				rbnode.node = msg.rnode;
+				rbnode.backend = InvalidBackendId;
+				smgrclosenode(rbnode);
+				break;
+
+			case PARALLEL_REDO_MSG_DROP_DATABASE:
+				if (shared->local_sync)
+					ForgetDatabaseSyncRequests(msg.dbid);
+				XLogDropDatabase(msg.dbid);
+				break;
+
+			case PARALLEL_REDO_MSG_CONSISTENT:
+				XLogCheckInvalidPages();
+				reachedConsistency = true;
+				break;
+
+			default:
+				elog(ERROR, "unrecognized parallel redo message type %d",
+					 (int) msg.type);
+		}
+
+		MemoryContextSwitchTo(oldcontext);
+		MemoryContextReset(redo_context);
+
+		slot->have_invalid_pages = XLogHaveInvalidPages();
+
+		/* Wake the startup process if it waits; pairs with its barrier */
+		pg_atomic_fetch_add_u64(&slot->nprocessed, 1);
+		if (pg_atomic_read_u32(&shared->leader_waiting) != 0)
+			SetLatch(leader_latch);
+	}
+
+	for (rmid = 0; rmid <= RM_MAX_ID; rmid++)
+	{
+		if (RmgrTable[rmid].rm_cleanup != NULL)
+			RmgrTable[rmid].rm_cleanup();
+	}
+
+	if (shared->local_sync)
+		ProcessSyncRequests();
+
+	proc_exit(0);
+}
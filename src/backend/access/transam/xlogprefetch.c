@@ -0,0 +1,912 @@
+/*-------------------------------------------------------------------------
+ *
+ * xlogprefetch.c
+ *		Prefetching support for recovery.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *		src/backend/access/transam/xlogprefetch.c
+ *
+ * The goal of this module is to read future WAL records and issue
+ * PrefetchSharedBuffer() calls for referenced blocks, so that we avoid I/O
+ * stalls in the main recovery loop.
+ *
+ * When examining a WAL record from the future, we need to consider that a
+ * referenced block or segment file might not exist on disk until this record
+ * or some earlier record has been replayed.  After a crash, a file might also
+ * be missing because it was dropped by a later WAL record; in that case, it
+ * will be recreated when this record is replayed.  These cases are handled by
+ * recognizing them and adding a "filter" that prevents all prefetching of a
+ * certain block range until the present WAL record has been replayed.  Blocks
+ * skipped for these reasons are counted as "skip_new" (that is, cases where we
+ * didn't try to prefetch "new" blocks).
+ *
+ * Blocks found in the buffer pool already are counted as "hit".  These
+ * cases are cheap, but still require a buffer mapping table lookup.
+ *
+ * We track in-progress I/Os by the LSN of the WAL record that caused them,
+ * and consider them completed once that record has been replayed.  The
+ * number of I/Os in progress is limited by maintenance_io_concurrency, and
+ * the distance we read ahead of replay by max_recovery_prefetch_distance.
+ *
+ * The WAL is read with a separate xlogreader that reads directly from the
+ * segment files in pg_wal.  While streaming, it doesn't read past the
+ * position the WAL receiver has flushed.  Failing to read or decode WAL is
+ * never an error here: we just stop prefetching until replay has caught up,
+ * and the main recovery loop will deal with the problem, if any.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include <unistd.h>
+
+#include "access/htup_details.h"
+#include "access/xlog.h"
+#include "access/xlog_internal.h"
+#include "access/xlogprefetch.h"
+#include "access/xlogreader.h"
+#include "catalog/pg_type.h"
+#include "catalog/storage_xlog.h"
+#include "commands/dbcommands_xlog.h"
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "port/atomics.h"
+#include "replication/walreceiver.h"
+#include "storage/bufmgr.h"
+#include "storage/fd.h"
+#include "storage/shmem.h"
+#include "storage/smgr.h"
+#include "utils/builtins.h"
+#include "utils/hsearch.h"
+#include "utils/timestamp.h"
+
+/*
+ * Sample the queue depth and distance every time we replay this much WAL.
+ * This is used to avoid touching shared memory for every record.
+ */
+#define XLOGPREFETCHER_MONITORING_SAMPLE_STEP 4096
+
+/*
+ * To detect repeat access to the same block and skip useless extra system
+ * calls, we remember a small window of recently prefetched blocks.
+ */
+#define XLOGPREFETCHER_SEQ_WINDOW_SIZE 4
+
+/* GUCs */
+bool		recovery_prefetch = false;
+int			max_recovery_prefetch_distance = 256 * 1024;
+
+/*
+ * A prefetcher object.  There is at most one of these in existence at a time,
+ * owned by the startup process.
+ */
+struct XLogPrefetcher
+{
+	/* Reader and current reading state. */
+	XLogReaderState *reader;
+	bool		have_record;	/* reader holds a record not yet scanned */
+	int			next_block_id;	/* next block reference to look at */
+	bool		shutdown;		/* stop reading until replay catches up */
+	XLogRecPtr	no_readahead_until;
+
+	/* The WAL segment file the reader has open, if any. */
+	int			readFile;
+	XLogSegNo	readSegNo;
+	TimeLineID	readTLI;
+	bool		open_failed;	/* segment readSegNo could not be opened */
+
+	/* Recently prefetched blocks, to skip repeats. */
+	RelFileNode recent_rnode[XLOGPREFETCHER_SEQ_WINDOW_SIZE];
+	BlockNumber recent_block[XLOGPREFETCHER_SEQ_WINDOW_SIZE];
+	int			recent_idx;
+
+	/* Online averages. */
+	uint64		samples;
+	double		avg_queue_depth;
+	double		avg_distance;
+	XLogRecPtr	next_sample_lsn;
+
+	/* Book-keeping required to avoid accessing non-existing blocks. */
+	HTAB	   *filter_table;
+	dlist_head	filter_queue;
+
+	/* Book-keeping required to limit concurrent prefetches. */
+	int			prefetch_head;
+	int			prefetch_tail;
+	int			prefetch_queue_size;
+	XLogRecPtr	prefetch_queue[MAX_IO_CONCURRENCY + 1];
+};
+
+/*
+ * A temporary filter used to track block ranges that haven't been created
+ * yet, whole relations that haven't been created yet, and whole relations
+ * that we must assume have already been dropped.  A relNode of InvalidOid
+ * filters the whole database.
+ */
+typedef struct XLogPrefetcherFilter
+{
+	RelFileNode rnode;
+	XLogRecPtr	filter_until_replayed;
+	BlockNumber filter_from_block;
+	dlist_node	link;
+} XLogPrefetcherFilter;
+
+/*
+ * Counters exposed in shared memory for pg_stat_recovery_prefetch.
+ */
+typedef struct XLogPrefetchStats
+{
+	pg_atomic_uint64 reset_time;	/* Time of last reset. */
+	pg_atomic_uint64 prefetch;	/* Prefetches initiated. */
+	pg_atomic_uint64 hit;		/* Blocks already buffered. */
+	pg_atomic_uint64 skip_init; /* Zero-inited blocks skipped. */
+	pg_atomic_uint64 skip_new;	/* New/missing blocks filtered. */
+	pg_atomic_uint64 skip_fpw;	/* FPWs skipped. */
+	pg_atomic_uint64 skip_rep;	/* Repeat blocks skipped. */
+
+	/* Reset counters */
+	pg_atomic_uint32 reset_request;
+	uint32		reset_handled;
+
+	/* Dynamic values */
+	int			wal_distance;	/* Number of WAL bytes ahead. */
+	int			io_depth;		/* Number of I/Os in progress. */
+	double		avg_wal_distance;
+	double		avg_io_depth;
+} XLogPrefetchStats;
+
+static inline void XLogPrefetcherAddFilter(XLogPrefetcher *prefetcher,
+										   RelFileNode rnode,
+										   BlockNumber blockno,
+										   XLogRecPtr lsn);
+static inline bool XLogPrefetcherIsFiltered(XLogPrefetcher *prefetcher,
+											RelFileNode rnode,
+											BlockNumber blockno);
+static inline void XLogPrefetcherCompleteFilters(XLogPrefetcher *prefetcher,
+												 XLogRecPtr replaying_lsn);
+static inline void XLogPrefetcherInitiatedIO(XLogPrefetcher *prefetcher,
+											 XLogRecPtr prefetching_lsn);
+static inline void XLogPrefetcherCompletedIO(XLogPrefetcher *prefetcher,
+											 XLogRecPtr replaying_lsn);
+static inline bool XLogPrefetcherSaturated(XLogPrefetcher *prefetcher);
+static bool XLogPrefetcherScanRecord(XLogPrefetcher *prefetcher);
+static bool XLogPrefetcherScanBlocks(XLogPrefetcher *prefetcher);
+static int	XLogPrefetcherPageRead(XLogReaderState *xlogreader,
+								   XLogRecPtr targetPagePtr, int reqLen,
+								   XLogRecPtr targetRecPtr, char *readBuf);
+static void XLogPrefetchResetStats(void);
+
+static XLogPrefetchStats *SharedStats;
+
+static inline void
+XLogPrefetchIncrement(pg_atomic_uint64 *counter)
+{
+	Assert(AmStartupProcess() || !IsUnderPostmaster);
+	pg_atomic_write_u64(counter, pg_atomic_read_u64(counter) + 1);
+}
+
+/*
+ * Report shared memory space needed by XLogPrefetchShmemInit.
+ */
+Size
+XLogPrefetchShmemSize(void)
+{
+	return sizeof(XLogPrefetchStats);
+}
+
+static void
+XLogPrefetchResetStats(void)
+{
+	pg_atomic_write_u64(&SharedStats->reset_time, GetCurrentTimestamp());
+	pg_atomic_write_u64(&SharedStats->prefetch, 0);
+	pg_atomic_write_u64(&SharedStats->hit, 0);
+	pg_atomic_write_u64(&SharedStats->skip_init, 0);
+	pg_atomic_write_u64(&SharedStats->skip_new, 0);
+	pg_atomic_write_u64(&SharedStats->skip_fpw, 0);
+	pg_atomic_write_u64(&SharedStats->skip_rep, 0);
+	SharedStats->avg_wal_distance = 0;
+	SharedStats->avg_io_depth = 0;
+}
+
+/*
+ * Allocate and initialize the shared memory counters.
+ */
+void
+XLogPrefetchShmemInit(void)
+{
+	bool		found;
+
+	SharedStats = (XLogPrefetchStats *)
+		ShmemInitStruct("XLogPrefetchStats",
+						sizeof(XLogPrefetchStats),
+						&found);
+
+	if (!found)
+	{
+		pg_atomic_init_u32(&SharedStats->reset_request, 0);
+		SharedStats->reset_handled = 0;
+
+		pg_atomic_init_u64(&SharedStats->reset_time, GetCurrentTimestamp());
+		pg_atomic_init_u64(&SharedStats->prefetch, 0);
+		pg_atomic_init_u64(&SharedStats->hit, 0);
+		pg_atomic_init_u64(&SharedStats->skip_init, 0);
+		pg_atomic_init_u64(&SharedStats->skip_new, 0);
+		pg_atomic_init_u64(&SharedStats->skip_fpw, 0);
+		pg_atomic_init_u64(&SharedStats->skip_rep, 0);
+		SharedStats->wal_distance = 0;
+		SharedStats->io_depth = 0;
+		SharedStats->avg_wal_distance = 0;
+		SharedStats->avg_io_depth = 0;
+	}
+}
+
+/*
+ * Ask the startup process to reset the counters.  This is done by the
+ * startup process itself, since it is the only writer; until it gets around
+ * to it, pg_stat_recovery_prefetch shows nothing.
+ */
+void
+XLogPrefetchRequestResetStats(void)
+{
+	pg_atomic_fetch_add_u32(&SharedStats->reset_request, 1);
+}
+
+/*
+ * Create a prefetcher that is ready to begin prefetching blocks referenced by
+ * WAL records following the one starting at lsn.
+ */
+XLogPrefetcher *
+XLogPrefetcherAllocate(XLogRecPtr lsn)
+{
+	XLogPrefetcher *prefetcher;
+	static HASHCTL hash_table_ctl = {
+		.keysize = sizeof(RelFileNode),
+		.entrysize = sizeof(XLogPrefetcherFilter)
+	};
+
+	prefetcher = palloc0(sizeof(XLogPrefetcher));
+	prefetcher->reader = XLogReaderAllocate(wal_segment_size, NULL,
+											XLogPrefetcherPageRead,
+											prefetcher);
+	if (prefetcher->reader == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of memory"),
+				 errdetail("Failed while allocating a WAL reading processor.")));
+	XLogBeginRead(prefetcher->reader, lsn);
+
+	prefetcher->readFile = -1;
+	prefetcher->filter_table = hash_create("XLogPrefetcherFilterTable", 1024,
+										   &hash_table_ctl,
+										   HASH_ELEM | HASH_BLOBS);
+	dlist_init(&prefetcher->filter_queue);
+
+	ereport(LOG,
+			(errmsg("recovery started prefetching at %X/%X",
+					(uint32) (lsn >> 32), (uint32) lsn)));
+
+	SharedStats->wal_distance = 0;
+	SharedStats->io_depth = 0;
+
+	return prefetcher;
+}
+
+/*
+ * Destroy a prefetcher and release all resources.
+ */
+void
+XLogPrefetcherFree(XLogPrefetcher *prefetcher)
+{
+	/* Log final statistics. */
+	ereport(LOG,
+			(errmsg("recovery finished prefetching at %X/%X; "
+					"prefetch = " UINT64_FORMAT ", "
+					"hit = " UINT64_FORMAT ", "
+					"skip_init = " UINT64_FORMAT ", "
+					"skip_new = " UINT64_FORMAT ", "
+					"skip_fpw = " UINT64_FORMAT ", "
+					"skip_rep = " UINT64_FORMAT ", "
+					"avg_distance = %f, "
+					"avg_queue_depth = %f",
+					(uint32) (prefetcher->reader->EndRecPtr >> 32),
+					(uint32) (prefetcher->reader->EndRecPtr),
+					pg_atomic_read_u64(&SharedStats->prefetch),
+					pg_atomic_read_u64(&SharedStats->hit),
+					pg_atomic_read_u64(&SharedStats->skip_init),
+					pg_atomic_read_u64(&SharedStats->skip_new),
+					pg_atomic_read_u64(&SharedStats->skip_fpw),
+					pg_atomic_read_u64(&SharedStats->skip_rep),
+					SharedStats->avg_wal_distance,
+					SharedStats->avg_io_depth)));
+	if (prefetcher->readFile >= 0)
+		close(prefetcher->readFile);
+	XLogReaderFree(prefetcher->reader);
+	hash_destroy(prefetcher->filter_table);
+	pfree(prefetcher);
+
+	SharedStats->wal_distance = 0;
+	SharedStats->io_depth = 0;
+}
+
+/*
+ * Called when recovery is replaying a new LSN, to check if we can read ahead.
+ */
+void
+XLogPrefetcherReadAhead(XLogPrefetcher *prefetcher, XLogRecPtr replaying_lsn)
+{
+	uint32		reset_request;
+
+	/* If an error has occurred or we've hit the end of the WAL, do nothing. */
+	if (prefetcher->shutdown)
+	{
+		if (replaying_lsn < prefetcher->no_readahead_until)
+			return;
+		prefetcher->shutdown = false;
+	}
+
+	/* Apply any requested reset of the counters. */
+	reset_request = pg_atomic_read_u32(&SharedStats->reset_request);
+	if (reset_request != SharedStats->reset_handled)
+	{
+		XLogPrefetchResetStats();
+		SharedStats->reset_handled = reset_request;
+		prefetcher->avg_distance = 0;
+		prefetcher->avg_queue_depth = 0;
+		prefetcher->samples = 0;
+	}
+
+	/* Can we drop any filters yet, due to problem records being replayed? */
+	XLogPrefetcherCompleteFilters(prefetcher, replaying_lsn);
+
+	/* Can we drop any prefetch slots due to replay having caught up? */
+	XLogPrefetcherCompletedIO(prefetcher, replaying_lsn);
+
+	/*
+	 * If replay has overtaken us, for example because we were unable to
+	 * read WAL that the main recovery loop got from the archive, skip
+	 * forward rather than decoding WAL that has already been replayed.
+	 */
+	if (prefetcher->reader->EndRecPtr < replaying_lsn)
+	{
+		XLogBeginRead(prefetcher->reader, replaying_lsn);
+		prefetcher->have_record = false;
+	}
+
+	/* Keep prefetching until we reach one of our limits. */
+	while (!XLogPrefetcherSaturated(prefetcher))
+	{
+		/* Unless we're still scanning the blocks of a record, get a new one. */
+		if (!prefetcher->have_record)
+		{
+			XLogRecord *record;
+			char	   *error;
+
+			/* Don't read too far ahead of replay. */
+			if (prefetcher->reader->EndRecPtr - replaying_lsn >=
+				(XLogRecPtr) max_recovery_prefetch_distance)
+				break;
+
+			record = XLogReadRecord(prefetcher->reader, &error);
+			if (record == NULL)
+			{
+				/*
+				 * We couldn't read (or decode) the next record.  That's
+				 * normal at the end of the WAL available so far.  Try again
+				 * once replay has reached the same point, or immediately if
+				 * we're merely waiting for the WAL receiver.  If a segment
+				 * file is missing from pg_wal, because recovery restores it
+				 * from the archive under a temporary name, don't try again
+				 * before replay has moved past that segment.
+				 */
+				if (prefetcher->open_failed)
+				{
+					prefetcher->shutdown = true;
+					XLogSegNoOffsetToRecPtr(prefetcher->readSegNo + 1, 0,
+											wal_segment_size,
+											prefetcher->no_readahead_until);
+				}
+				else if (!WalRcvStreaming())
+				{
+					prefetcher->shutdown = true;
+					prefetcher->no_readahead_until =
+						prefetcher->reader->EndRecPtr;
+				}
+				break;
+			}
+
+			/* Skip records that have already been (or are being) replayed. */
+			if (prefetcher->reader->ReadRecPtr <= replaying_lsn)
+				continue;
+
+			if (!XLogPrefetcherScanRecord(prefetcher))
+				continue;
+			prefetcher->have_record = true;
+			prefetcher->next_block_id = 0;
+		}
+
+		/* Scan the record's block references. */
+		if (!XLogPrefetcherScanBlocks(prefetcher))
+			break;
+
+		/* Advance to the next record. */
+		prefetcher->have_record = false;
+	}
+
+	/* Update the instantaneous stats visible in pg_stat_recovery_prefetch. */
+	SharedStats->wal_distance =
+		prefetcher->reader->EndRecPtr > replaying_lsn ?
+		prefetcher->reader->EndRecPtr - replaying_lsn : 0;
+	SharedStats->io_depth = prefetcher->prefetch_queue_size;
+
+	/* Maintain the online averages, sampling at regular LSN intervals. */
+	if (replaying_lsn >= prefetcher->next_sample_lsn)
+	{
+		prefetcher->samples++;
+		prefetcher->avg_distance +=
+			(SharedStats->wal_distance - prefetcher->avg_distance) /
+			prefetcher->samples;
+		prefetcher->avg_queue_depth +=
+			(SharedStats->io_depth - prefetcher->avg_queue_depth) /
+			prefetcher->samples;
+		SharedStats->avg_wal_distance = prefetcher->avg_distance;
+		SharedStats->avg_io_depth = prefetcher->avg_queue_depth;
+		prefetcher->next_sample_lsn =
+			replaying_lsn + XLOGPREFETCHER_MONITORING_SAMPLE_STEP;
+	}
+}
+
+/*
+ * Look at the record the reader just decoded for things that affect which
+ * blocks may be prefetched.  Returns true if it has block references to
+ * scan.
+ */
+static bool
+XLogPrefetcherScanRecord(XLogPrefetcher *prefetcher)
+{
+	XLogReaderState *reader = prefetcher->reader;
+	uint8		rmid = XLogRecGetRmid(reader);
+	uint8		info = XLogRecGetInfo(reader) & ~XLR_INFO_MASK;
+
+	/*
+	 * Check for operations that change the set of files on disk: we must not
+	 * touch files that replay hasn't created or truncated yet.
+	 */
+	if (rmid == RM_DBASE_ID && info == XLOG_DBASE_CREATE)
+	{
+		xl_dbase_create_rec *xlrec =
+		(xl_dbase_create_rec *) XLogRecGetData(reader);
+		RelFileNode rnode = {InvalidOid, xlrec->db_id, InvalidOid};
+
+		/*
+		 * Don't try to prefetch anything in this database until it has been
+		 * created, or we might confuse blocks on different timelines.  Also,
+		 * replay removes the directory first if it exists, which would leave
+		 * us with file descriptors pointing to unlinked files.
+		 */
+		rnode.spcNode = xlrec->tablespace_id;
+		XLogPrefetcherAddFilter(prefetcher, rnode, 0, reader->ReadRecPtr);
+	}
+	else if (rmid == RM_SMGR_ID && info == XLOG_SMGR_CREATE)
+	{
+		xl_smgr_create *xlrec = (xl_smgr_create *) XLogRecGetData(reader);
+
+		/* Don't prefetch anything in this relation until it's created. */
+		XLogPrefetcherAddFilter(prefetcher, xlrec->rnode, 0,
+								reader->ReadRecPtr);
+	}
+	else if (rmid == RM_SMGR_ID && info == XLOG_SMGR_TRUNCATE)
+	{
+		xl_smgr_truncate *xlrec = (xl_smgr_truncate *) XLogRecGetData(reader);
+
+		/*
+		 * Don't prefetch anything in the truncation range until the
+		 * truncation has been performed.
+		 */
+		XLogPrefetcherAddFilter(prefetcher, xlrec->rnode, xlrec->blkno,
+								reader->ReadRecPtr);
+	}
+
+	return reader->max_block_id >= 0;
+}
+
+/*
+ * Scan the current record for block references, and consider prefetching.
+ *
+ * Return true if we processed the current record to completion and still
+ * have queue space to process a new record, and false if we saturated the
+ * I/O queue and need to wait for recovery to advance before we continue.
+ */
+static bool
+XLogPrefetcherScanBlocks(XLogPrefetcher *prefetcher)
+{
+	XLogReaderState *reader = prefetcher->reader;
+
+	Assert(!XLogPrefetcherSaturated(prefetcher));
+
+	/*
+	 * We may be picking up where we left off last time, if we have
+	 * saturated the I/O queue.
+	 */
+	for (int block_id = prefetcher->next_block_id;
+		 block_id <= reader->max_block_id;
+		 ++block_id)
+	{
+		DecodedBkpBlock *block = &reader->blocks[block_id];
+		PrefetchBufferResult prefetch;
+		SMgrRelation reln;
+
+		/* Ignore everything but the main fork for now. */
+		if (!block->in_use || block->forknum != MAIN_FORKNUM)
+			continue;
+
+		/*
+		 * If there is a full page image attached, replay will overwrite the
+		 * page without reading it.
+		 */
+		if (block->apply_image)
+		{
+			XLogPrefetchIncrement(&SharedStats->skip_fpw);
+			continue;
+		}
+
+		/*
+		 * If this block will initialize a new page then replay won't read
+		 * it either.  It's probably a relation extension, so the block most
+		 * likely doesn't exist yet anyway.
+		 */
+		if (block->flags & BKPBLOCK_WILL_INIT)
+		{
+			XLogPrefetchIncrement(&SharedStats->skip_init);
+			continue;
+		}
+
+		/* Should we skip this block due to a filter? */
+		if (XLogPrefetcherIsFiltered(prefetcher, block->rnode, block->blkno))
+		{
+			XLogPrefetchIncrement(&SharedStats->skip_new);
+			continue;
+		}
+
+		/* Fast path for repeated references to the same block. */
+		for (int i = 0; i < XLOGPREFETCHER_SEQ_WINDOW_SIZE; ++i)
+		{
+			if (block->blkno == prefetcher->recent_block[i] &&
+				RelFileNodeEquals(block->rnode, prefetcher->recent_rnode[i]))
+			{
+				/*
+				 * XXX If we also remembered where it was, we could set
+				 * recent_buffer so that recovery could skip the buffer
+				 * mapping lookup.
+				 */
+				XLogPrefetchIncrement(&SharedStats->skip_rep);
+				goto next_block;
+			}
+		}
+		prefetcher->recent_rnode[prefetcher->recent_idx] = block->rnode;
+		prefetcher->recent_block[prefetcher->recent_idx] = block->blkno;
+		prefetcher->recent_idx =
+			(prefetcher->recent_idx + 1) % XLOGPREFETCHER_SEQ_WINDOW_SIZE;
+
+		/*
+		 * We could try to have a fast path for repeated references to the
+		 * same relation (with some scheme to handle invalidations safely),
+		 * but for now we'll call smgropen() every time.
+		 */
+		reln = smgropen(block->rnode, InvalidBackendId);
+
+		/* Try to prefetch this block! */
+		prefetch = PrefetchSharedBuffer(reln, block->forknum, block->blkno);
+		if (BufferIsValid(prefetch.recent_buffer))
+		{
+			/* It was already cached, so do nothing. */
+			XLogPrefetchIncrement(&SharedStats->hit);
+		}
+		else if (prefetch.initiated_io)
+		{
+			/*
+			 * I/O has possibly been initiated (though we don't know if it was
+			 * already cached by the kernel, so we just have to assume that it
+			 * has due to lack of better information).  Record this as an I/O
+			 * in progress until eventually we replay this LSN.
+			 */
+			XLogPrefetchIncrement(&SharedStats->prefetch);
+			XLogPrefetcherInitiatedIO(prefetcher, reader->ReadRecPtr);
+
+			/*
+			 * If the queue is now full, we'll have to wait before processing
+			 * any more blocks from this record, or move to a new record if
+			 * that was the last block.
+			 */
+			if (XLogPrefetcherSaturated(prefetcher))
+			{
+				prefetcher->next_block_id = block_id + 1;
+				return false;
+			}
+		}
+		else
+		{
+			/*
+			 * Neither cached nor initiated.  The underlying segment file
+			 * doesn't exist, presumably because it is created or extended by
+			 * a record we haven't replayed yet.  Prefetching this relation
+			 * from this block onwards is pointless until this record has
+			 * been replayed.  (Without posix_fadvise, we'd also end up here,
+			 * but recovery_prefetch can't be enabled then.)
+			 */
+			XLogPrefetcherAddFilter(prefetcher, block->rnode, block->blkno,
+									reader->ReadRecPtr);
+			XLogPrefetchIncrement(&SharedStats->skip_new);
+		}
+
+next_block:
+		;
+	}
+
+	return true;
+}
+
+/*
+ * Read callback for the prefetcher's xlogreader.  Reads directly from the
+ * segment files in pg_wal, without waiting for WAL to arrive or restoring
+ * files from the archive: if the WAL isn't there yet, we simply fail.
+ */
+static int
+XLogPrefetcherPageRead(XLogReaderState *xlogreader, XLogRecPtr targetPagePtr,
+					   int reqLen, XLogRecPtr targetRecPtr, char *readBuf)
+{
+	XLogPrefetcher *prefetcher = (XLogPrefetcher *) xlogreader->private_data;
+	TimeLineID	tli = ThisTimeLineID;
+	XLogSegNo	segno;
+	uint32		offset;
+	int			readLen = XLOG_BLCKSZ;
+
+	/* While streaming, don't read beyond what has been flushed. */
+	if (WalRcvStreaming())
+	{
+		XLogRecPtr	flushed = GetWalRcvFlushRecPtr(NULL, &tli);
+
+		if (targetPagePtr + reqLen > flushed)
+			return -1;
+		if (targetPagePtr + XLOG_BLCKSZ > flushed)
+			readLen = flushed - targetPagePtr;
+	}
+
+	XLByteToSeg(targetPagePtr, segno, wal_segment_size);
+
+	/* Open the segment, if we don't have it open already. */
+	if (prefetcher->readFile < 0 ||
+		prefetcher->readSegNo != segno ||
+		prefetcher->readTLI != tli)
+	{
+		char		path[MAXPGPATH];
+
+		if (prefetcher->readFile >= 0)
+			close(prefetcher->readFile);
+
+		XLogFilePath(path, tli, segno, wal_segment_size);
+		prefetcher->readFile = BasicOpenFile(path, O_RDONLY | PG_BINARY);
+		prefetcher->readSegNo = segno;
+		prefetcher->readTLI = tli;
+		prefetcher->open_failed = (prefetcher->readFile < 0);
+		if (prefetcher->open_failed)
+			return -1;
+	}
+
+	offset = XLogSegmentOffset(targetPagePtr, wal_segment_size);
+
+	pgstat_report_wait_start(WAIT_EVENT_WAL_READ);
+	if (pg_pread(prefetcher->readFile, readBuf, XLOG_BLCKSZ, (off_t) offset) !=
+		XLOG_BLCKSZ)
+	{
+		pgstat_report_wait_end();
+		return -1;
+	}
+	pgstat_report_wait_end();
+
+	xlogreader->seg.ws_tli = tli;
+
+	return readLen;
+}
+
+/*
+ * Don't prefetch any blocks >= 'blockno' from a given 'rnode', until 'lsn'
+ * has been replayed.
+ */
+static inline void
+XLogPrefetcherAddFilter(XLogPrefetcher *prefetcher, RelFileNode rnode,
+						BlockNumber blockno, XLogRecPtr lsn)
+{
+	XLogPrefetcherFilter *filter;
+	bool		found;
+
+	filter = hash_search(prefetcher->filter_table, &rnode, HASH_ENTER, &found);
+	if (!found)
+	{
+		/*
+		 * Don't allow any prefetching of this block or higher until replayed.
+		 */
+		filter->filter_until_replayed = lsn;
+		filter->filter_from_block = blockno;
+		dlist_push_head(&prefetcher->filter_queue, &filter->link);
+	}
+	else
+	{
+		/*
+		 * We were already filtering this rnode.  Extend the filter's lifetime
+		 * to cover this WAL record, but leave the (presumably lower) block
+		 * number there because we don't want to have to track individual
+		 * blocks.
+		 */
+		filter->filter_until_replayed = lsn;
+		dlist_delete(&filter->link);
+		dlist_push_head(&prefetcher->filter_queue, &filter->link);
+		filter->filter_from_block = Min(filter->filter_from_block, blockno);
+	}
+}
+
+/*
+ * Have we replayed the records that caused us to begin filtering a block
+ * range?  That means that relations should have been created, extended or
+ * dropped as required, so we can drop relevant filters.
+ */
+static inline void
+XLogPrefetcherCompleteFilters(XLogPrefetcher *prefetcher,
+							  XLogRecPtr replaying_lsn)
+{
+	while (unlikely(!dlist_is_empty(&prefetcher->filter_queue)))
+	{
+		XLogPrefetcherFilter *filter = dlist_tail_element(XLogPrefetcherFilter,
+														  link,
+														  &prefetcher->filter_queue);
+
+		if (filter->filter_until_replayed >= replaying_lsn)
+			break;
+		dlist_delete(&filter->link);
+		hash_search(prefetcher->filter_table, filter, HASH_REMOVE, NULL);
+	}
+}
+
+/*
+ * Check if a given block should be skipped due to a filter.
+ */
+static inline bool
+XLogPrefetcherIsFiltered(XLogPrefetcher *prefetcher, RelFileNode rnode,
+						 BlockNumber blockno)
+{
+	/*
+	 * Test for empty queue first, because we expect it to be empty most of
+	 * the time and we can avoid the hash table lookup in that case.
+	 */
+	if (unlikely(!dlist_is_empty(&prefetcher->filter_queue)))
+	{
+		XLogPrefetcherFilter *filter;
+
+		/* See if the block range is filtered. */
+		filter = hash_search(prefetcher->filter_table, &rnode, HASH_FIND, NULL);
+		if (filter && filter->filter_from_block <= blockno)
+			return true;
+
+		/* See if the whole database is filtered. */
+		rnode.relNode = InvalidOid;
+		filter = hash_search(prefetcher->filter_table, &rnode, HASH_FIND, NULL);
+		if (filter)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Insert an LSN into the queue.  The queue must not be full already.  This
+ * tracks the fact that we have (to the best of our knowledge) initiated an
+ * I/O, so that we can impose a cap on concurrent prefetching.
+ */
+static inline void
+XLogPrefetcherInitiatedIO(XLogPrefetcher *prefetcher,
+						  XLogRecPtr prefetching_lsn)
+{
+	Assert(!XLogPrefetcherSaturated(prefetcher));
+	prefetcher->prefetch_queue[prefetcher->prefetch_head++] = prefetching_lsn;
+	prefetcher->prefetch_head %= lengthof(prefetcher->prefetch_queue);
+	prefetcher->prefetch_queue_size++;
+}
+
+/*
+ * Have we replayed the records that caused us to initiate the oldest
+ * prefetches yet?  That means that they're definitely finished, so we can can
+ * forget about them and allow ourselves to initiate more prefetches.  For now
+ * we don't have any awareness of when I/O really completes.
+ */
+static inline void
+XLogPrefetcherCompletedIO(XLogPrefetcher *prefetcher, XLogRecPtr replaying_lsn)
+{
+	while (prefetcher->prefetch_head != prefetcher->prefetch_tail &&
+		   prefetcher->prefetch_queue[prefetcher->prefetch_tail] < replaying_lsn)
+	{
+		prefetcher->prefetch_tail++;
+		prefetcher->prefetch_tail %= lengthof(prefetcher->prefetch_queue);
+		prefetcher->prefetch_queue_size--;
+	}
+}
+
+/*
+ * Check if the maximum allowed number of I/Os is already in flight.
+ */
+static inline bool
+XLogPrefetcherSaturated(XLogPrefetcher *prefetcher)
+{
+	return prefetcher->prefetch_queue_size >= maintenance_io_concurrency;
+}
+
+/*
+ * Expose statistics about recovery prefetching.
+ */
+Datum
+pg_stat_get_recovery_prefetch(PG_FUNCTION_ARGS)
+{
+#define PG_STAT_GET_RECOVERY_PREFETCH_COLS 11
+	TupleDesc	tupdesc;
+	Datum		values[PG_STAT_GET_RECOVERY_PREFETCH_COLS];
+	bool		nulls[PG_STAT_GET_RECOVERY_PREFETCH_COLS];
+
+	/* Initialise attributes information in the tuple descriptor */
+	tupdesc = CreateTemplateTupleDesc(PG_STAT_GET_RECOVERY_PREFETCH_COLS);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 1, "stats_reset",
+					   TIMESTAMPTZOID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 2, "prefetch",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 3, "hit",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 4, "skip_init",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 5, "skip_new",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 6, "skip_fpw",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 7, "skip_rep",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 8, "wal_distance",
+					   INT4OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 9, "io_depth",
+					   INT4OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 10, "avg_wal_distance",
+					   FLOAT4OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 11, "avg_io_depth",
+					   FLOAT4OID, -1, 0);
+
+	BlessTupleDesc(tupdesc);
+
+	if (pg_atomic_read_u32(&SharedStats->reset_request) !=
+		SharedStats->reset_handled)
+	{
+		/* There's an unhandled reset request, so just show NULLs */
+		for (int i = 0; i < PG_STAT_GET_RECOVERY_PREFETCH_COLS; ++i)
+			nulls[i] = true;
+	}
+	else
+	{
+		for (int i = 0; i < PG_STAT_GET_RECOVERY_PREFETCH_COLS; ++i)
+			nulls[i] = false;
+	}
+
+	values[0] = TimestampTzGetDatum(pg_atomic_read_u64(&SharedStats->reset_time));
+	values[1] = Int64GetDatum(pg_atomic_read_u64(&SharedStats->prefetch));
+	values[2] = Int64GetDatum(pg_atomic_read_u64(&SharedStats->hit));
+	values[3] = Int64GetDatum(pg_atomic_read_u64(&SharedStats->skip_init));
+	values[4] = Int64GetDatum(pg_atomic_read_u64(&SharedStats->skip_new));
+	values[5] = Int64GetDatum(pg_atomic_read_u64(&SharedStats->skip_fpw));
+	values[6] = Int64GetDatum(pg_atomic_read_u64(&SharedStats->skip_rep));
+	values[7] = Int32GetDatum(SharedStats->wal_distance);
+	values[8] = Int32GetDatum(SharedStats->io_depth);
+	values[9] = Float4GetDatum(SharedStats->avg_wal_distance);
+	values[10] = Float4GetDatum(SharedStats->avg_io_depth);
+
+	/* Returns the record as Datum */
+	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
+}
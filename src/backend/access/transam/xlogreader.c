@@ -19,6 +19,13 @@
 
 #include <unistd.h>
 
+#ifdef USE_LZ4
+#include <lz4.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
 #include "access/transam.h"
 #include "access/xlog_internal.h"
 #include "access/xlogreader.h"
@@ -36,6 +43,9 @@
 static void report_invalid_record(XLogReaderState *state, const char *fmt,...)
 			pg_attribute_printf(2, 3);
 static bool allocate_recordbuf(XLogReaderState *state, uint32 reclength);
+static const char *compression_unsupported(uint8 method);
+static bool decompress_data(uint8 method, const char *source, int32 slen,
+							char *dest, int32 rawlen);
 static int	ReadPageInternal(XLogReaderState *state, XLogRecPtr pageptr,
 							 int reqLen);
 static void XLogReaderInvalReadState(XLogReaderState *state);
@@ -150,6 +160,8 @@ XLogReaderFree(XLogReaderState *state)
 	pfree(state->errormsg_buf);
 	if (state->readRecordBuf)
 		pfree(state->readRecordBuf);
+	if (state->decompressBuf)
+		pfree(state->decompressBuf);
 	pfree(state->readBuf);
 	pfree(state);
 }
@@ -1194,6 +1206,70 @@ DecodeXLogRecord(XLogReaderState *state, XLogRecord *record, char **errormsg)
 	ptr += SizeOfXLogRecord;
 	remaining = record->xl_tot_len - SizeOfXLogRecord;
 
+	/*
+	 * If the payload is compressed, decompress it into decompressBuf and
+	 * decode from there.
+	 */
+	if (record->xl_info & XLR_COMPRESSED)
+	{
+		XLogRecordCompressedHeader chdr;
+		const char *unsupported;
+
+		COPY_HEADER_FIELD(&chdr.method, sizeof(uint8));
+		COPY_HEADER_FIELD(&chdr.raw_length, sizeof(uint32));
+
+		unsupported = compression_unsupported(chdr.method);
+		if (unsupported != NULL)
+		{
+			report_invalid_record(state,
+								  "could not decode record at %X/%X compressed with %s not supported by build",
+								  (uint32) (state->ReadRecPtr >> 32),
+								  (uint32) state->ReadRecPtr,
+								  unsupported);
+			goto err;
+		}
+
+#ifndef FRONTEND
+		if (!AllocSizeIsValid(chdr.raw_length))
+			goto shortdata_err;
+#endif
+		if (chdr.raw_length == 0 || chdr.raw_length > PG_INT32_MAX)
+			goto shortdata_err;
+
+		if (state->decompressBufSize < chdr.raw_length)
+		{
+			uint32		newSize = Max(chdr.raw_length, BLCKSZ);
+
+			if (state->decompressBuf)
+				pfree(state->decompressBuf);
+			state->decompressBufSize = 0;
+			state->decompressBuf = palloc_extended(newSize, MCXT_ALLOC_NO_OOM);
+			if (state->decompressBuf == NULL)
+			{
+				report_invalid_record(state,
+									  "out of memory while decompressing record at %X/%X",
+									  (uint32) (state->ReadRecPtr >> 32),
+									  (uint32) state->ReadRecPtr);
+				goto err;
+			}
+			state->decompressBufSize = newSize;
+		}
+
+		if (!decompress_data(chdr.method, ptr, remaining,
+							 state->decompressBuf, chdr.raw_length))
+		{
+			report_invalid_record(state,
+								  "invalid compressed record payload at %X/%X",
+								  (uint32) (state->ReadRecPtr >> 32),
+								  (uint32) state->ReadRecPtr);
+			goto err;
+		}
+
+		ptr = state->decompressBuf;
+		remaining = chdr.raw_length;
+	}
+	state->raw_payload_len = remaining;
+
 	/* Decode the headers */
 	datatotal = 0;
 	while (remaining > datatotal)
@@ -1281,7 +1357,7 @@ DecodeXLogRecord(XLogReaderState *state, XLogRecord *record, char **errormsg)
 
 				blk->apply_image = ((blk->bimg_info & BKPIMAGE_APPLY) != 0);
 
-				if (blk->bimg_info & BKPIMAGE_IS_COMPRESSED)
+				if (BKPIMAGE_COMPRESSED(blk->bimg_info))
 				{
 					if (blk->bimg_info & BKPIMAGE_HAS_HOLE)
 						COPY_HEADER_FIELD(&blk->hole_length, sizeof(uint16));
@@ -1326,29 +1402,28 @@ DecodeXLogRecord(XLogReaderState *state, XLogRecord *record, char **errormsg)
 				}
 
 				/*
-				 * cross-check that bimg_len < BLCKSZ if the IS_COMPRESSED
-				 * flag is set.
+				 * cross-check that bimg_len < BLCKSZ if it is compressed.
 				 */
-				if ((blk->bimg_info & BKPIMAGE_IS_COMPRESSED) &&
+				if (BKPIMAGE_COMPRESSED(blk->bimg_info) &&
 					blk->bimg_len == BLCKSZ)
 				{
 					report_invalid_record(state,
-										  "BKPIMAGE_IS_COMPRESSED set, but block image length %u at %X/%X",
+										  "BKPIMAGE_COMPRESSED set, but block image length %u at %X/%X",
 										  (unsigned int) blk->bimg_len,
 										  (uint32) (state->ReadRecPtr >> 32), (uint32) state->ReadRecPtr);
 					goto err;
 				}
 
 				/*
-				 * cross-check that bimg_len = BLCKSZ if neither HAS_HOLE nor
-				 * IS_COMPRESSED flag is set.
+				 * cross-check that bimg_len = BLCKSZ if neither HAS_HOLE is
+				 * set nor COMPRESSED().
 				 */
 				if (!(blk->bimg_info & BKPIMAGE_HAS_HOLE) &&
-					!(blk->bimg_info & BKPIMAGE_IS_COMPRESSED) &&
+					!BKPIMAGE_COMPRESSED(blk->bimg_info) &&
 					blk->bimg_len != BLCKSZ)
 				{
 					report_invalid_record(state,
-										  "neither BKPIMAGE_HAS_HOLE nor BKPIMAGE_IS_COMPRESSED set, but block image length is %u at %X/%X",
+										  "neither BKPIMAGE_HAS_HOLE nor BKPIMAGE_COMPRESSED set, but block image length is %u at %X/%X",
 										  (unsigned int) blk->data_len,
 										  (uint32) (state->ReadRecPtr >> 32), (uint32) state->ReadRecPtr);
 					goto err;
@@ -1528,6 +1603,71 @@ XLogRecGetBlockData(XLogReaderState *record, uint8 block_id, Size *len)
 	}
 }
 
+/*
+ * If the given XLR_COMPRESSION_* method can't be decompressed by this build,
+ * return its name for use in an error message.  Otherwise return NULL.
+ */
+static const char *
+compression_unsupported(uint8 method)
+{
+	switch (method)
+	{
+		case XLR_COMPRESSION_PGLZ:
+			return NULL;
+		case XLR_COMPRESSION_LZ4:
+#ifdef USE_LZ4
+			return NULL;
+#else
+			return "lz4";
+#endif
+		case XLR_COMPRESSION_ZSTD:
+#ifdef USE_ZSTD
+			return NULL;
+#else
+			return "zstd";
+#endif
+		default:
+			return "unknown method";
+	}
+}
+
+/*
+ * Decompress 'slen' bytes at 'source', which must decompress to exactly
+ * 'rawlen' bytes, into 'dest'.  Returns false if the data is corrupt.
+ *
+ * The caller must have checked the method with compression_unsupported().
+ */
+static bool
+decompress_data(uint8 method, const char *source, int32 slen,
+				char *dest, int32 rawlen)
+{
+	switch (method)
+	{
+		case XLR_COMPRESSION_PGLZ:
+			return pglz_decompress(source, slen, dest, rawlen, true) == rawlen;
+
+		case XLR_COMPRESSION_LZ4:
+#ifdef USE_LZ4
+			return LZ4_decompress_safe(source, dest, slen, rawlen) == rawlen;
+#else
+			break;
+#endif
+
+		case XLR_COMPRESSION_ZSTD:
+#ifdef USE_ZSTD
+			{
+				size_t		len = ZSTD_decompress(dest, rawlen, source, slen);
+
+				return !ZSTD_isError(len) && len == (size_t) rawlen;
+			}
+#else
+			break;
+#endif
+	}
+
+	return false;
+}
+
 /*
  * Restore a full-page image from a backup block attached to an XLOG record.
  *
@@ -1548,11 +1688,32 @@ RestoreBlockImage(XLogReaderState *record, uint8 block_id, char *page)
 	bkpb = &record->blocks[block_id];
 	ptr = bkpb->bkp_image;
 
-	if (bkpb->bimg_info & BKPIMAGE_IS_COMPRESSED)
+	if (BKPIMAGE_COMPRESSED(bkpb->bimg_info))
 	{
+		uint8		method;
+		const char *unsupported;
+
+		if (bkpb->bimg_info & BKPIMAGE_COMPRESS_PGLZ)
+			method = XLR_COMPRESSION_PGLZ;
+		else if (bkpb->bimg_info & BKPIMAGE_COMPRESS_LZ4)
+			method = XLR_COMPRESSION_LZ4;
+		else
+			method = XLR_COMPRESSION_ZSTD;
+
+		unsupported = compression_unsupported(method);
+		if (unsupported != NULL)
+		{
+			report_invalid_record(record, "could not restore image at %X/%X compressed with %s not supported by build, block %d",
+								  (uint32) (record->ReadRecPtr >> 32),
+								  (uint32) record->ReadRecPtr,
+								  unsupported,
+								  block_id);
+			return false;
+		}
+
 		/* If a backup block image is compressed, decompress it */
-		if (pglz_decompress(ptr, bkpb->bimg_len, tmp.data,
-							BLCKSZ - bkpb->hole_length, true) < 0)
+		if (!decompress_data(method, ptr, bkpb->bimg_len, tmp.data,
+							 BLCKSZ - bkpb->hole_length))
 		{
 			report_invalid_record(record, "invalid compressed image at %X/%X, block %d",
 								  (uint32) (record->ReadRecPtr >> 32),
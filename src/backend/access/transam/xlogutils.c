@@ -22,6 +22,7 @@
 #include "access/timeline.h"
 #include "access/xlog.h"
 #include "access/xlog_internal.h"
+#include "access/xlogparallel.h"
 #include "access/xlogutils.h"
 #include "miscadmin.h"
 #include "pgstat.h"
@@ -216,7 +217,7 @@ XLogHaveInvalidPages(void)
 	if (invalid_page_tab != NULL &&
 		hash_get_num_entries(invalid_page_tab) > 0)
 		return true;
-	return false;
+	return ParallelRedoHaveInvalidPages();
 }
 
 /* Complain about any remaining invalid-page entries */
@@ -615,6 +616,9 @@ void
 XLogDropRelation(RelFileNode rnode, ForkNumber forknum)
 {
 	forget_invalid_pages(rnode, forknum, 0);
+
+	/* Parallel redo workers keep their own records */
+	ParallelRedoDropRelation(rnode, forknum);
 }
 
 /*
@@ -634,6 +638,8 @@ XLogDropDatabase(Oid dbid)
 	smgrcloseall();
 
 	forget_invalid_pages_db(dbid);
+
+	ParallelRedoDropDatabase(dbid);
 }
 
 /*
@@ -646,6 +652,8 @@ XLogTruncateRelation(RelFileNode rnode, ForkNumber forkNum,
 					 BlockNumber nblocks)
 {
 	forget_invalid_pages(rnode, forkNum, nblocks);
+
+	ParallelRedoTruncateRelation(rnode, forkNum, nblocks);
 }
 
 /*
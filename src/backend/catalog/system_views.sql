@@ -961,6 +961,31 @@ CREATE VIEW pg_stat_archiver AS
         s.stats_reset
     FROM pg_stat_get_archiver() s;
 
+CREATE VIEW pg_stat_wal_flush AS
+    SELECT
+        s.groups,
+        s.members,
+        s.max_members,
+        s.flush_time,
+        s.max_flush_time,
+        s.stats_reset
+    FROM pg_stat_get_wal_flush() s;
+
+CREATE VIEW pg_stat_recovery_prefetch AS
+    SELECT
+            s.stats_reset,
+            s.prefetch,
+            s.hit,
+            s.skip_init,
+            s.skip_new,
+            s.skip_fpw,
+            s.skip_rep,
+            s.wal_distance,
+            s.io_depth,
+            s.avg_wal_distance,
+            s.avg_io_depth
+    FROM pg_stat_get_recovery_prefetch() s;
+
 CREATE VIEW pg_stat_bgwriter AS
     SELECT
         pg_stat_get_bgwriter_timed_checkpoints() AS checkpoints_timed,
@@ -975,6 +1000,24 @@ CREATE VIEW pg_stat_bgwriter AS
         pg_stat_get_buf_alloc() AS buffers_alloc,
         pg_stat_get_bgwriter_stat_reset_time() AS stats_reset;
 
+CREATE VIEW pg_stat_io AS
+    SELECT
+            s.backend_type,
+            s.io_context,
+            s.reads,
+            s.read_time,
+            s.writes,
+            s.write_time,
+            s.extends,
+            s.extend_time,
+            s.hits,
+            s.evictions,
+            s.reuses,
+            s.fsyncs,
+            s.fsync_time,
+            s.stats_reset
+    FROM pg_stat_get_io() s;
+
 CREATE VIEW pg_stat_progress_analyze AS
     SELECT
         S.pid AS pid, S.datid AS datid, D.datname AS datname,
@@ -1681,10 +1681,12 @@ vacuum_rel(Oid relid, RangeVar *relation, VacuumParams *params)
 	StartTransactionCommand();
 
 	/*
-	 * Functions in indexes may want a snapshot set.  Also, setting a snapshot
-	 * ensures that RecentGlobalXmin is kept truly recent.
+	 * Functions in indexes may want a snapshot set.  GetSnapshotData() does
+	 * not recompute RecentGlobalXmin each time, so do that explicitly to
+	 * ensure it is truly recent, e.g. for recycling index pages.
 	 */
 	PushActiveSnapshot(GetTransactionSnapshot());
+	UpdateRecentGlobalXmin();
 
 	if (!(params->options & VACOPT_FULL))
 	{
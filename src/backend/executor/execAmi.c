@@ -44,6 +44,7 @@
 #include "executor/nodeProjectSet.h"
 #include "executor/nodeRecursiveunion.h"
 #include "executor/nodeResult.h"
+#include "executor/nodeResultCache.h"
 #include "executor/nodeSamplescan.h"
 #include "executor/nodeSeqscan.h"
 #include "executor/nodeSetOp.h"
@@ -51,6 +52,7 @@
 #include "executor/nodeSubplan.h"
 #include "executor/nodeSubqueryscan.h"
 #include "executor/nodeTableFuncscan.h"
+#include "executor/nodeTidrangescan.h"
 #include "executor/nodeTidscan.h"
 #include "executor/nodeUnique.h"
 #include "executor/nodeValuesscan.h"
@@ -197,6 +199,10 @@ ExecReScan(PlanState *node)
 			ExecReScanTidScan((TidScanState *) node);
 			break;
 
+		case T_TidRangeScanState:
+			ExecReScanTidRangeScan((TidRangeScanState *) node);
+			break;
+
 		case T_SubqueryScanState:
 			ExecReScanSubqueryScan((SubqueryScanState *) node);
 			break;
@@ -249,6 +255,10 @@ ExecReScan(PlanState *node)
 			ExecReScanMaterial((MaterialState *) node);
 			break;
 
+		case T_ResultCacheState:
+			ExecReScanResultCache((ResultCacheState *) node);
+			break;
+
 		case T_SortState:
 			ExecReScanSort((SortState *) node);
 			break;
@@ -557,6 +567,7 @@ ExecSupportsBackwardScan(Plan *node)
 
 		case T_SeqScan:
 		case T_TidScan:
+		case T_TidRangeScan:
 		case T_FunctionScan:
 		case T_ValuesScan:
 		case T_CteScan:
@@ -639,3 +650,81 @@ ExecMaterializesOutput(NodeTag plantype)
 
 	return false;
 }
+
+/*
+ * ExecSupportsBatchOutput - can a plan node return its rows in batches?
+ *
+ * Sequential scans can, and a Result node without a per-row qual can pass
+ * on the batches of its input.  The rows in the batches are not projected;
+ * ExecBatchOutputAttr finds the node's output columns in them.  Whether a
+ * node actually runs in batch mode is only known once it's initialized,
+ * see ExecBatchOutputReady.
+ */
+bool
+ExecSupportsBatchOutput(Plan *node)
+{
+	switch (nodeTag(node))
+	{
+		case T_SeqScan:
+			return true;
+
+		case T_Result:
+			return outerPlan(node) != NULL && node->qual == NIL &&
+				ExecSupportsBatchOutput(outerPlan(node));
+
+		default:
+			return false;
+	}
+}
+
+/*
+ * ExecBatchOutputReady - can a node be read with ExecGetBatch?
+ *
+ * A parent that passed EXEC_FLAG_BATCH to a node supporting batch output
+ * asks this once the node is initialized.  If the answer is yes, the node
+ * returns all its rows in batches, and the rows listed in the selection
+ * vector of a batch need no further checking.
+ */
+bool
+ExecBatchOutputReady(PlanState *node)
+{
+	switch (nodeTag(node))
+	{
+		case T_SeqScanState:
+			return ((SeqScanState *) node)->batch != NULL &&
+				node->qual == NULL;
+
+		case T_ResultState:
+			return node->qual == NULL && outerPlanState(node) != NULL &&
+				ExecBatchOutputReady(outerPlanState(node));
+
+		default:
+			return false;
+	}
+}
+
+/*
+ * ExecLimitBatchAttrs - tell a node read with ExecGetBatch which columns
+ * its parent uses
+ *
+ * The parent only looks at the first natts column vectors of the batches,
+ * so the node needn't fill in any more than those.
+ */
+void
+ExecLimitBatchAttrs(PlanState *node, int natts)
+{
+	switch (nodeTag(node))
+	{
+		case T_SeqScanState:
+			ExecSeqScanLimitBatchAttrs((SeqScanState *) node, natts);
+			break;
+
+		case T_ResultState:
+			ExecLimitBatchAttrs(outerPlanState(node), natts);
+			break;
+
+		default:
+			elog(ERROR, "unrecognized node type: %d", (int) nodeTag(node));
+			break;
+	}
+}
@@ -0,0 +1,1172 @@
+/*-------------------------------------------------------------------------
+ *
+ * execBatch.c
+ *	  Support for evaluating scans a batch of rows at a time.
+ *
+ * A scan running in batch mode fetches up to executor_batch_size rows from
+ * the table AM at once, deforms the attributes it needs into column vectors
+ * (a TupleBatch), and evaluates the simple parts of its qual over the whole
+ * batch, producing a selection vector of the rows that pass.  Only the rows
+ * that survive are then handed, one at a time, to the rest of the qual, the
+ * projection and the parent node.
+ *
+ * The parts of a qual evaluated this way (a BatchQual) are comparisons of a
+ * column of a fixed-width integer, float or date/time type with a constant,
+ * and NULL tests on a column.  Each is evaluated by a tight loop over one
+ * column vector rather than through the expression interpreter and fmgr,
+ * which is where most of the time of a selective scan otherwise goes.  These
+ * loops are not ExprEvalSteps: ExecInterpExpr still runs row by row, and the
+ * rest of the qual and any projection are evaluated through it as usual.
+ *
+ * Parent nodes can also take whole batches from a scan whose qual is fully
+ * evaluated over batches, through ExecGetBatch, possibly by way of Result
+ * nodes that just pass them on.  A plain Agg advances the common transition
+ * functions of count, sum, min and max over whole column vectors
+ * (BatchAggTrans, see nodeAgg.c), and a Hash node builds its hash table from
+ * the rows of the batches without running its input row by row (see
+ * nodeHash.c).
+ *
+ * The innermost loops of both, comparing or summing an array of values, are
+ * kernels with a plain C and, on x86, an AVX2 implementation, the latter in
+ * execBatchAvx2.c.  Which one to use is decided once, at runtime.
+ *
+ * Only sequential scans produce batches, and only Result, a non-parallel Hash
+ * and a plain Agg consume them.  The hash keys are still computed row by row,
+ * and Parallel Hash, grouped aggregation and Result nodes with a qual of their
+ * own or a target list that computes expressions take their input one row at
+ * a time.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *	  src/backend/executor/execBatch.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "common/int.h"
+#include "executor/execBatch.h"
+#include "nodes/nodeFuncs.h"
+#include "parser/parsetree.h"
+#ifdef USE_AVX2_BATCH_WITH_RUNTIME_CHECK
+#include "port/pg_cpu_x86.h"
+#endif
+#include "storage/bufmgr.h"
+#include "utils/fmgroids.h"
+#include "utils/float.h"
+
+
+/* GUC parameter */
+int			executor_batch_size = 1000;
+
+typedef enum BatchStepKind
+{
+	BATCH_STEP_CMP_INT,			/* integer column op constant */
+	BATCH_STEP_CMP_FLOAT,		/* float column op constant */
+	BATCH_STEP_ISNULL,			/* column IS NULL */
+	BATCH_STEP_ISNOTNULL,		/* column IS NOT NULL */
+	BATCH_STEP_CONSTFALSE		/* comparison with a NULL constant */
+} BatchStepKind;
+
+typedef struct BatchQualStep
+{
+	BatchStepKind kind;
+	int			attno;			/* column vector, 0-based */
+	BatchValueType coltype;		/* representation of the column */
+	BatchCmp	cmp;			/* comparison, with the column on the left */
+	int64		ival;			/* constant, for integer comparisons */
+	double		fval;			/* constant, for float comparisons */
+} BatchQualStep;
+
+struct BatchQual
+{
+	int			nsteps;
+	BatchQualStep steps[FLEXIBLE_ARRAY_MEMBER];
+};
+
+/*
+ * The comparison functions we know how to evaluate over a batch.  Integer
+ * types are all compared as int64 and float types as float8, which gives the
+ * same answers as the functions themselves, including for the cross-type
+ * ones.
+ */
+typedef struct BatchCmpFunc
+{
+	Oid			funcid;
+	BatchValueType lefttype;
+	BatchValueType righttype;
+	BatchCmp	cmp;
+} BatchCmpFunc;
+
+#define BATCH_CMP_FUNCS(prefix, ltype, rtype) \
+	{F_##prefix##EQ, ltype, rtype, BATCH_CMP_EQ}, \
+	{F_##prefix##NE, ltype, rtype, BATCH_CMP_NE}, \
+	{F_##prefix##LT, ltype, rtype, BATCH_CMP_LT}, \
+	{F_##prefix##LE, ltype, rtype, BATCH_CMP_LE}, \
+	{F_##prefix##GT, ltype, rtype, BATCH_CMP_GT}, \
+	{F_##prefix##GE, ltype, rtype, BATCH_CMP_GE}
+
+static const BatchCmpFunc batch_cmp_funcs[] = {
+	BATCH_CMP_FUNCS(INT2, BATCH_INT2, BATCH_INT2),
+	BATCH_CMP_FUNCS(INT4, BATCH_INT4, BATCH_INT4),
+	BATCH_CMP_FUNCS(INT8, BATCH_INT8, BATCH_INT8),
+	BATCH_CMP_FUNCS(INT24, BATCH_INT2, BATCH_INT4),
+	BATCH_CMP_FUNCS(INT42, BATCH_INT4, BATCH_INT2),
+	BATCH_CMP_FUNCS(INT28, BATCH_INT2, BATCH_INT8),
+	BATCH_CMP_FUNCS(INT82, BATCH_INT8, BATCH_INT2),
+	BATCH_CMP_FUNCS(INT48, BATCH_INT4, BATCH_INT8),
+	BATCH_CMP_FUNCS(INT84, BATCH_INT8, BATCH_INT4),
+	BATCH_CMP_FUNCS(OID, BATCH_OID, BATCH_OID),
+	BATCH_CMP_FUNCS(FLOAT4, BATCH_FLOAT4, BATCH_FLOAT4),
+	BATCH_CMP_FUNCS(FLOAT8, BATCH_FLOAT8, BATCH_FLOAT8),
+	BATCH_CMP_FUNCS(FLOAT48, BATCH_FLOAT4, BATCH_FLOAT8),
+	BATCH_CMP_FUNCS(FLOAT84, BATCH_FLOAT8, BATCH_FLOAT4),
+	BATCH_CMP_FUNCS(DATE_, BATCH_INT4, BATCH_INT4),
+	BATCH_CMP_FUNCS(TIMESTAMP_, BATCH_INT8, BATCH_INT8)
+};
+
+/*
+ * The aggregate transition functions we know how to advance over a batch
+ */
+typedef struct BatchAggFunc
+{
+	Oid			transfn;
+	BatchAggKind kind;
+	BatchValueType coltype;
+} BatchAggFunc;
+
+static const BatchAggFunc batch_agg_funcs[] = {
+	{F_INT8INC, BATCH_AGG_COUNT_STAR, BATCH_INT8},
+	{F_INT8INC_ANY, BATCH_AGG_COUNT, BATCH_INT8},
+	{F_INT2_SUM, BATCH_AGG_SUM_INT, BATCH_INT2},
+	{F_INT4_SUM, BATCH_AGG_SUM_INT, BATCH_INT4},
+	{F_FLOAT8PL, BATCH_AGG_SUM_FLOAT8, BATCH_FLOAT8},
+	{F_INT2SMALLER, BATCH_AGG_MIN, BATCH_INT2},
+	{F_INT2LARGER, BATCH_AGG_MAX, BATCH_INT2},
+	{F_INT4SMALLER, BATCH_AGG_MIN, BATCH_INT4},
+	{F_INT4LARGER, BATCH_AGG_MAX, BATCH_INT4},
+	{F_INT8SMALLER, BATCH_AGG_MIN, BATCH_INT8},
+	{F_INT8LARGER, BATCH_AGG_MAX, BATCH_INT8},
+	{F_OIDSMALLER, BATCH_AGG_MIN, BATCH_OID},
+	{F_OIDLARGER, BATCH_AGG_MAX, BATCH_OID},
+	{F_DATE_SMALLER, BATCH_AGG_MIN, BATCH_INT4},
+	{F_DATE_LARGER, BATCH_AGG_MAX, BATCH_INT4},
+	/* these are timestamptz_smaller and timestamptz_larger */
+	{F_TIMESTAMP_SMALLER, BATCH_AGG_MIN, BATCH_INT8},
+	{F_TIMESTAMP_LARGER, BATCH_AGG_MAX, BATCH_INT8},
+	{F_FLOAT4SMALLER, BATCH_AGG_MIN, BATCH_FLOAT4},
+	{F_FLOAT4LARGER, BATCH_AGG_MAX, BATCH_FLOAT4},
+	{F_FLOAT8SMALLER, BATCH_AGG_MIN, BATCH_FLOAT8},
+	{F_FLOAT8LARGER, BATCH_AGG_MAX, BATCH_FLOAT8}
+};
+
+typedef struct
+{
+	Index		scanrelid;
+	int			natts;
+	bool		ok;
+} batch_attrs_context;
+
+static bool batch_attrs_walker(Node *node, batch_attrs_context *context);
+static bool batch_qual_step(Expr *clause, Index scanrelid,
+							BatchQualStep *step);
+static int	batch_eval_int(BatchQualStep *step, TupleBatch *batch, int nsel);
+static int	batch_eval_float(BatchQualStep *step, TupleBatch *batch,
+							 int nsel);
+static int	batch_gather_int(TupleBatch *batch, int attno,
+							 BatchValueType coltype, int64 *scratch);
+static int	batch_gather_float(TupleBatch *batch, int attno,
+							   BatchValueType coltype, double *scratch);
+static const BatchKernels *batch_choose_kernels(void);
+
+/* plain C kernels */
+static int	batch_filter_int64_c(BatchCmp cmp, int64 c, const int64 *values,
+								 int *sel, int n);
+static int	batch_filter_float8_c(BatchCmp cmp, double c,
+								  const double *values, int *sel, int n);
+static int64 batch_sum_int64_c(const int64 *values, int n);
+static int64 batch_min_int64_c(const int64 *values, int n);
+static int64 batch_max_int64_c(const int64 *values, int n);
+
+static const BatchKernels batch_kernels_c = {
+	batch_filter_int64_c,
+	batch_filter_float8_c,
+	batch_sum_int64_c,
+	batch_min_int64_c,
+	batch_max_int64_c
+};
+
+/* kernels in use, chosen when the first batch is created */
+static const BatchKernels *batch_kernels = NULL;
+
+
+/*
+ * ExecBatchScanAttrs
+ *
+ * Check whether a scan with the given targetlist and qual can run in batch
+ * mode, and if so set *natts to the number of leading attributes of the
+ * scanned relation that it needs.  Batches hold only user attributes, so
+ * scans referencing system columns or whole-row Vars can't use them.
+ */
+bool
+ExecBatchScanAttrs(List *targetlist, List *qual, Index scanrelid, int *natts)
+{
+	batch_attrs_context context;
+
+	context.scanrelid = scanrelid;
+	context.natts = 0;
+	context.ok = true;
+
+	(void) batch_attrs_walker((Node *) targetlist, &context);
+	if (context.ok)
+		(void) batch_attrs_walker((Node *) qual, &context);
+
+	*natts = context.natts;
+	return context.ok;
+}
+
+static bool
+batch_attrs_walker(Node *node, batch_attrs_context *context)
+{
+	if (node == NULL)
+		return false;
+	if (IsA(node, Var))
+	{
+		Var		   *var = (Var *) node;
+
+		if (var->varno == context->scanrelid && var->varlevelsup == 0)
+		{
+			if (var->varattno <= 0)
+			{
+				context->ok = false;
+				return true;
+			}
+			context->natts = Max(context->natts, var->varattno);
+		}
+		return false;
+	}
+	return expression_tree_walker(node, batch_attrs_walker,
+								  (void *) context);
+}
+
+/*
+ * ExecBatchOutputAttr
+ *
+ * Find output column resno of a plan node that supports batch output (see
+ * ExecSupportsBatchOutput) in the batches it returns.  Returns the 0-based
+ * index of the column vector holding it, or -1 if the column isn't simply
+ * a column of the scanned relation, passed up unchanged.
+ */
+int
+ExecBatchOutputAttr(Plan *plan, AttrNumber resno)
+{
+	for (;;)
+	{
+		TargetEntry *tle = get_tle_by_resno(plan->targetlist, resno);
+		Node	   *expr;
+		Var		   *var;
+
+		if (tle == NULL)
+			return -1;
+		expr = (Node *) tle->expr;
+		while (IsA(expr, RelabelType))
+			expr = (Node *) ((RelabelType *) expr)->arg;
+		if (!IsA(expr, Var))
+			return -1;
+		var = (Var *) expr;
+
+		switch (nodeTag(plan))
+		{
+			case T_SeqScan:
+				if (var->varno != ((Scan *) plan)->scanrelid ||
+					var->varlevelsup != 0 ||
+					var->varattno <= 0)
+					return -1;
+				return var->varattno - 1;
+
+			case T_Result:
+				/* look through to the input's column */
+				if (var->varno != OUTER_VAR)
+					return -1;
+				resno = var->varattno;
+				plan = outerPlan(plan);
+				break;
+
+			default:
+				return -1;
+		}
+	}
+}
+
+/*
+ * ExecInitBatchQual
+ *
+ * Split an implicitly-ANDed qual list into the clauses that can be
+ * evaluated over a batch, which are compiled into the returned BatchQual,
+ * and the rest, which are returned in *residual for the caller to evaluate
+ * per row as usual.  Returns NULL if no clause can be evaluated over a
+ * batch.
+ */
+BatchQual *
+ExecInitBatchQual(List *qual, Index scanrelid, List **residual)
+{
+	BatchQual  *bqual;
+	ListCell   *lc;
+
+	bqual = palloc(offsetof(BatchQual, steps) +
+				   Max(list_length(qual), 1) * sizeof(BatchQualStep));
+	bqual->nsteps = 0;
+	*residual = NIL;
+
+	foreach(lc, qual)
+	{
+		Expr	   *clause = (Expr *) lfirst(lc);
+
+		if (batch_qual_step(clause, scanrelid, &bqual->steps[bqual->nsteps]))
+			bqual->nsteps++;
+		else
+			*residual = lappend(*residual, clause);
+	}
+
+	if (bqual->nsteps == 0)
+	{
+		pfree(bqual);
+		return NULL;
+	}
+
+	return bqual;
+}
+
+/*
+ * Is the given node a Var of the scanned relation, possibly under a
+ * binary-compatible relabeling?  If so, return it.
+ */
+static Var *
+batch_scan_var(Node *node, Index scanrelid)
+{
+	while (node && IsA(node, RelabelType))
+		node = (Node *) ((RelabelType *) node)->arg;
+
+	if (node && IsA(node, Var) &&
+		((Var *) node)->varno == scanrelid &&
+		((Var *) node)->varlevelsup == 0 &&
+		((Var *) node)->varattno > 0)
+		return (Var *) node;
+	return NULL;
+}
+
+/*
+ * Try to compile one qual clause into a batch step.
+ */
+static bool
+batch_qual_step(Expr *clause, Index scanrelid, BatchQualStep *step)
+{
+	if (IsA(clause, NullTest))
+	{
+		NullTest   *ntest = (NullTest *) clause;
+		Var		   *var;
+
+		if (ntest->argisrow)
+			return false;
+		var = batch_scan_var((Node *) ntest->arg, scanrelid);
+		if (var == NULL)
+			return false;
+
+		step->kind = (ntest->nulltesttype == IS_NULL) ?
+			BATCH_STEP_ISNULL : BATCH_STEP_ISNOTNULL;
+		step->attno = var->varattno - 1;
+		return true;
+	}
+	else if (IsA(clause, OpExpr))
+	{
+		OpExpr	   *opexpr = (OpExpr *) clause;
+		const BatchCmpFunc *func = NULL;
+		Node	   *leftop;
+		Node	   *rightop;
+		Var		   *var;
+		Const	   *con;
+		BatchValueType consttype;
+		int			i;
+
+		if (list_length(opexpr->args) != 2)
+			return false;
+
+		set_opfuncid(opexpr);
+		for (i = 0; i < lengthof(batch_cmp_funcs); i++)
+		{
+			if (batch_cmp_funcs[i].funcid == opexpr->opfuncid)
+			{
+				func = &batch_cmp_funcs[i];
+				break;
+			}
+		}
+		if (func == NULL)
+			return false;
+
+		leftop = (Node *) linitial(opexpr->args);
+		rightop = (Node *) lsecond(opexpr->args);
+
+		if ((var = batch_scan_var(leftop, scanrelid)) != NULL &&
+			IsA(rightop, Const))
+		{
+			con = (Const *) rightop;
+			step->coltype = func->lefttype;
+			step->cmp = func->cmp;
+			consttype = func->righttype;
+		}
+		else if ((var = batch_scan_var(rightop, scanrelid)) != NULL &&
+				 IsA(leftop, Const))
+		{
+			/* commute the comparison to put the column on the left */
+			con = (Const *) leftop;
+			step->coltype = func->righttype;
+			consttype = func->lefttype;
+			switch (func->cmp)
+			{
+				case BATCH_CMP_LT:
+					step->cmp = BATCH_CMP_GT;
+					break;
+				case BATCH_CMP_LE:
+					step->cmp = BATCH_CMP_GE;
+					break;
+				case BATCH_CMP_GT:
+					step->cmp = BATCH_CMP_LT;
+					break;
+				case BATCH_CMP_GE:
+					step->cmp = BATCH_CMP_LE;
+					break;
+				default:
+					step->cmp = func->cmp;
+					break;
+			}
+		}
+		else
+			return false;
+
+		step->attno = var->varattno - 1;
+		step->ival = 0;
+		step->fval = 0.0;
+
+		/* the functions are strict, so a NULL constant rejects every row */
+		if (con->constisnull)
+		{
+			step->kind = BATCH_STEP_CONSTFALSE;
+			return true;
+		}
+
+		switch (consttype)
+		{
+			case BATCH_INT2:
+				step->ival = DatumGetInt16(con->constvalue);
+				break;
+			case BATCH_INT4:
+				step->ival = DatumGetInt32(con->constvalue);
+				break;
+			case BATCH_INT8:
+				step->ival = DatumGetInt64(con->constvalue);
+				break;
+			case BATCH_OID:
+				step->ival = DatumGetObjectId(con->constvalue);
+				break;
+			case BATCH_FLOAT4:
+				step->fval = DatumGetFloat4(con->constvalue);
+				break;
+			case BATCH_FLOAT8:
+				step->fval = DatumGetFloat8(con->constvalue);
+				break;
+		}
+
+		if (step->coltype == BATCH_FLOAT4 || step->coltype == BATCH_FLOAT8)
+			step->kind = BATCH_STEP_CMP_FLOAT;
+		else
+			step->kind = BATCH_STEP_CMP_INT;
+		return true;
+	}
+
+	return false;
+}
+
+/*
+ * ExecBatchQualEval
+ *
+ * Evaluate a BatchQual over all the rows of a batch, setting up the batch's
+ * selection vector to list the rows that pass.  A NULL BatchQual passes all
+ * rows.
+ */
+void
+ExecBatchQualEval(BatchQual *bqual, TupleBatch *batch)
+{
+	int		   *sel = batch->sel;
+	int			nsel = batch->nrows;
+	int			i;
+
+	for (i = 0; i < nsel; i++)
+		sel[i] = i;
+
+	for (i = 0; bqual != NULL && i < bqual->nsteps && nsel > 0; i++)
+	{
+		BatchQualStep *step = &bqual->steps[i];
+		bool	   *isnull;
+		int			j;
+		int			n;
+
+		switch (step->kind)
+		{
+			case BATCH_STEP_CMP_INT:
+				nsel = batch_eval_int(step, batch, nsel);
+				break;
+
+			case BATCH_STEP_CMP_FLOAT:
+				nsel = batch_eval_float(step, batch, nsel);
+				break;
+
+			case BATCH_STEP_ISNULL:
+				isnull = batch->isnull[step->attno];
+				for (j = 0, n = 0; j < nsel; j++)
+				{
+					if (isnull[sel[j]])
+						sel[n++] = sel[j];
+				}
+				nsel = n;
+				break;
+
+			case BATCH_STEP_ISNOTNULL:
+				isnull = batch->isnull[step->attno];
+				for (j = 0, n = 0; j < nsel; j++)
+				{
+					if (!isnull[sel[j]])
+						sel[n++] = sel[j];
+				}
+				nsel = n;
+				break;
+
+			case BATCH_STEP_CONSTFALSE:
+				nsel = 0;
+				break;
+		}
+	}
+
+	batch->nselected = nsel;
+	batch->next = 0;
+	batch->lastrow = -1;
+}
+
+/*
+ * Gather the non-null values of the selected rows into a scratch array,
+ * dropping the rows with nulls from the selection vector as we go.
+ */
+#define BATCH_GATHER(scratch, conv) \
+	do { \
+		for (i = 0; i < nsel; i++) \
+		{ \
+			int			row = sel[i]; \
+			\
+			if (!isnull[row]) \
+			{ \
+				sel[n] = row; \
+				(scratch)[n] = conv(values[row]); \
+				n++; \
+			} \
+		} \
+	} while (0)
+
+/*
+ * Like BATCH_GATHER, but leave the selection vector alone.
+ */
+#define BATCH_GATHER_VALUES(scratch, conv) \
+	do { \
+		for (i = 0; i < nsel; i++) \
+		{ \
+			int			row = sel[i]; \
+			\
+			if (!isnull[row]) \
+				(scratch)[n++] = conv(values[row]); \
+		} \
+	} while (0)
+
+/*
+ * Keep the selected rows whose gathered value passes a comparison.
+ */
+#define BATCH_FILTER(test) \
+	do { \
+		for (i = 0; i < n; i++) \
+		{ \
+			if (test) \
+				sel[m++] = sel[i]; \
+		} \
+	} while (0)
+
+static int
+batch_eval_int(BatchQualStep *step, TupleBatch *batch, int nsel)
+{
+	Datum	   *values = batch->values[step->attno];
+	bool	   *isnull = batch->isnull[step->attno];
+	int		   *sel = batch->sel;
+	int64	   *scratch = batch->iscratch;
+	int			i;
+	int			n = 0;
+
+	switch (step->coltype)
+	{
+		case BATCH_INT2:
+			BATCH_GATHER(scratch, DatumGetInt16);
+			break;
+		case BATCH_INT4:
+			BATCH_GATHER(scratch, DatumGetInt32);
+			break;
+		case BATCH_INT8:
+			BATCH_GATHER(scratch, DatumGetInt64);
+			break;
+		case BATCH_OID:
+			BATCH_GATHER(scratch, DatumGetObjectId);
+			break;
+		default:
+			elog(ERROR, "unexpected batch column type %d", step->coltype);
+	}
+
+	return batch_kernels->filter_int64(step->cmp, step->ival, scratch, sel, n);
+}
+
+static int
+batch_eval_float(BatchQualStep *step, TupleBatch *batch, int nsel)
+{
+	Datum	   *values = batch->values[step->attno];
+	bool	   *isnull = batch->isnull[step->attno];
+	int		   *sel = batch->sel;
+	double	   *scratch = batch->fscratch;
+	int			i;
+	int			n = 0;
+
+	switch (step->coltype)
+	{
+		case BATCH_FLOAT4:
+			BATCH_GATHER(scratch, DatumGetFloat4);
+			break;
+		case BATCH_FLOAT8:
+			BATCH_GATHER(scratch, DatumGetFloat8);
+			break;
+		default:
+			elog(ERROR, "unexpected batch column type %d", step->coltype);
+	}
+
+	/* vectorized kernels don't know that NaN equals NaN */
+	if (isnan(step->fval))
+		return batch_filter_float8_c(step->cmp, step->fval, scratch, sel, n);
+	return batch_kernels->filter_float8(step->cmp, step->fval, scratch, sel, n);
+}
+
+/*
+ * Gather the non-null values of a column of integer type, in the selected
+ * rows of a batch, into scratch[].  Returns the number of values.
+ */
+static int
+batch_gather_int(TupleBatch *batch, int attno, BatchValueType coltype,
+				 int64 *scratch)
+{
+	Datum	   *values = batch->values[attno];
+	bool	   *isnull = batch->isnull[attno];
+	int		   *sel = batch->sel;
+	int			nsel = batch->nselected;
+	int			i;
+	int			n = 0;
+
+	switch (coltype)
+	{
+		case BATCH_INT2:
+			BATCH_GATHER_VALUES(scratch, DatumGetInt16);
+			break;
+		case BATCH_INT4:
+			BATCH_GATHER_VALUES(scratch, DatumGetInt32);
+			break;
+		case BATCH_INT8:
+			BATCH_GATHER_VALUES(scratch, DatumGetInt64);
+			break;
+		case BATCH_OID:
+			BATCH_GATHER_VALUES(scratch, DatumGetObjectId);
+			break;
+		default:
+			elog(ERROR, "unexpected batch column type %d", coltype);
+	}
+
+	return n;
+}
+
+/*
+ * Likewise for a column of float type
+ */
+static int
+batch_gather_float(TupleBatch *batch, int attno, BatchValueType coltype,
+				   double *scratch)
+{
+	Datum	   *values = batch->values[attno];
+	bool	   *isnull = batch->isnull[attno];
+	int		   *sel = batch->sel;
+	int			nsel = batch->nselected;
+	int			i;
+	int			n = 0;
+
+	switch (coltype)
+	{
+		case BATCH_FLOAT4:
+			BATCH_GATHER_VALUES(scratch, DatumGetFloat4);
+			break;
+		case BATCH_FLOAT8:
+			BATCH_GATHER_VALUES(scratch, DatumGetFloat8);
+			break;
+		default:
+			elog(ERROR, "unexpected batch column type %d", coltype);
+	}
+
+	return n;
+}
+
+/*
+ * Plain C kernels, see BatchKernels
+ */
+static int
+batch_filter_int64_c(BatchCmp cmp, int64 c, const int64 *values,
+					 int *sel, int n)
+{
+	int			i;
+	int			m = 0;
+
+	switch (cmp)
+	{
+		case BATCH_CMP_EQ:
+			BATCH_FILTER(values[i] == c);
+			break;
+		case BATCH_CMP_NE:
+			BATCH_FILTER(values[i] != c);
+			break;
+		case BATCH_CMP_LT:
+			BATCH_FILTER(values[i] < c);
+			break;
+		case BATCH_CMP_LE:
+			BATCH_FILTER(values[i] <= c);
+			break;
+		case BATCH_CMP_GT:
+			BATCH_FILTER(values[i] > c);
+			break;
+		case BATCH_CMP_GE:
+			BATCH_FILTER(values[i] >= c);
+			break;
+	}
+
+	return m;
+}
+
+static int
+batch_filter_float8_c(BatchCmp cmp, double c, const double *values,
+					  int *sel, int n)
+{
+	int			i;
+	int			m = 0;
+
+	/* use the float8 comparison functions, to get NaNs right */
+	switch (cmp)
+	{
+		case BATCH_CMP_EQ:
+			BATCH_FILTER(float8_eq(values[i], c));
+			break;
+		case BATCH_CMP_NE:
+			BATCH_FILTER(float8_ne(values[i], c));
+			break;
+		case BATCH_CMP_LT:
+			BATCH_FILTER(float8_lt(values[i], c));
+			break;
+		case BATCH_CMP_LE:
+			BATCH_FILTER(float8_le(values[i], c));
+			break;
+		case BATCH_CMP_GT:
+			BATCH_FILTER(float8_gt(values[i], c));
+			break;
+		case BATCH_CMP_GE:
+			BATCH_FILTER(float8_ge(values[i], c));
+			break;
+	}
+
+	return m;
+}
+
+static int64
+batch_sum_int64_c(const int64 *values, int n)
+{
+	int64		sum = 0;
+	int			i;
+
+	for (i = 0; i < n; i++)
+		sum += values[i];
+	return sum;
+}
+
+static int64
+batch_min_int64_c(const int64 *values, int n)
+{
+	int64		result = values[0];
+	int			i;
+
+	for (i = 1; i < n; i++)
+	{
+		if (values[i] < result)
+			result = values[i];
+	}
+	return result;
+}
+
+static int64
+batch_max_int64_c(const int64 *values, int n)
+{
+	int64		result = values[0];
+	int			i;
+
+	for (i = 1; i < n; i++)
+	{
+		if (values[i] > result)
+			result = values[i];
+	}
+	return result;
+}
+
+/*
+ * Choose the kernels to use, depending on what the CPU supports
+ */
+static const BatchKernels *
+batch_choose_kernels(void)
+{
+#ifdef USE_AVX2_BATCH_WITH_RUNTIME_CHECK
+	if (pg_cpu_x86_have_avx2())
+		return &batch_kernels_avx2;
+#endif
+	return &batch_kernels_c;
+}
+
+/*
+ * ExecInitBatchAggTrans
+ *
+ * Check whether an aggregate transition function, whose input is the given
+ * column of the batches (or that has no input, if attno is -1), can be
+ * advanced a batch at a time, and if so fill in *trans.  The caller must
+ * make sure that the column is of the transition function's input type.
+ */
+bool
+ExecInitBatchAggTrans(Oid transfn, int attno, BatchAggTrans *trans)
+{
+	int			i;
+
+	for (i = 0; i < lengthof(batch_agg_funcs); i++)
+	{
+		if (batch_agg_funcs[i].transfn == transfn)
+		{
+			trans->kind = batch_agg_funcs[i].kind;
+			trans->coltype = batch_agg_funcs[i].coltype;
+			trans->attno = attno;
+
+			/* count(*) is the only one without an input column */
+			return (attno < 0) == (trans->kind == BATCH_AGG_COUNT_STAR);
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Convert between the Datum and the gathered representations of a value
+ */
+static int64
+batch_datum_get_int(Datum value, BatchValueType coltype)
+{
+	switch (coltype)
+	{
+		case BATCH_INT2:
+			return DatumGetInt16(value);
+		case BATCH_INT4:
+			return DatumGetInt32(value);
+		case BATCH_INT8:
+			return DatumGetInt64(value);
+		case BATCH_OID:
+			return DatumGetObjectId(value);
+		default:
+			elog(ERROR, "unexpected batch column type %d", coltype);
+	}
+	return 0;					/* keep compiler quiet */
+}
+
+static Datum
+batch_int_get_datum(int64 value, BatchValueType coltype)
+{
+	switch (coltype)
+	{
+		case BATCH_INT2:
+			return Int16GetDatum((int16) value);
+		case BATCH_INT4:
+			return Int32GetDatum((int32) value);
+		case BATCH_INT8:
+			return Int64GetDatum(value);
+		case BATCH_OID:
+			return ObjectIdGetDatum((Oid) value);
+		default:
+			elog(ERROR, "unexpected batch column type %d", coltype);
+	}
+	return (Datum) 0;			/* keep compiler quiet */
+}
+
+/*
+ * ExecBatchAggAdvance
+ *
+ * Advance an aggregate transition state over the selected rows of a batch,
+ * with the same result as calling the transition function for each of them
+ * in turn.  None of the transition functions keeps a state other than a
+ * pass-by-value Datum; min, max and sum of float8 are strict and start with
+ * a NULL state, which the first non-null input replaces.
+ */
+void
+ExecBatchAggAdvance(BatchAggTrans *trans, TupleBatch *batch,
+					Datum *transValue, bool *transValueIsNull)
+{
+	int64		count;
+	int64		ivalue;
+	double		fvalue;
+	int			n;
+	int			i;
+
+	switch (trans->kind)
+	{
+		case BATCH_AGG_COUNT_STAR:
+		case BATCH_AGG_COUNT:
+			if (trans->kind == BATCH_AGG_COUNT_STAR)
+				n = batch->nselected;
+			else
+			{
+				bool	   *isnull = batch->isnull[trans->attno];
+
+				for (i = 0, n = 0; i < batch->nselected; i++)
+					n += !isnull[batch->sel[i]];
+			}
+			/* as in int8inc */
+			if (unlikely(pg_add_s64_overflow(DatumGetInt64(*transValue), n,
+											 &count)))
+				ereport(ERROR,
+						(errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+						 errmsg("bigint out of range")));
+			*transValue = Int64GetDatum(count);
+			break;
+
+		case BATCH_AGG_SUM_INT:
+			n = batch_gather_int(batch, trans->attno, trans->coltype,
+								 batch->iscratch);
+			if (n == 0)
+				break;
+			/* as in int2_sum and int4_sum, which don't check for overflow */
+			ivalue = batch_kernels->sum_int64(batch->iscratch, n);
+			if (!*transValueIsNull)
+				ivalue += DatumGetInt64(*transValue);
+			*transValue = Int64GetDatum(ivalue);
+			*transValueIsNull = false;
+			break;
+
+		case BATCH_AGG_SUM_FLOAT8:
+			n = batch_gather_float(batch, trans->attno, trans->coltype,
+								   batch->fscratch);
+			if (n == 0)
+				break;
+
+			/*
+			 * Add the values up one by one, in order, so that we get exactly
+			 * the same rounding as float8pl would.
+			 */
+			i = 0;
+			if (*transValueIsNull)
+				fvalue = batch->fscratch[i++];
+			else
+				fvalue = DatumGetFloat8(*transValue);
+			for (; i < n; i++)
+				fvalue = float8_pl(fvalue, batch->fscratch[i]);
+			*transValue = Float8GetDatum(fvalue);
+			*transValueIsNull = false;
+			break;
+
+		case BATCH_AGG_MIN:
+		case BATCH_AGG_MAX:
+			if (trans->coltype == BATCH_FLOAT4 ||
+				trans->coltype == BATCH_FLOAT8)
+			{
+				n = batch_gather_float(batch, trans->attno, trans->coltype,
+									   batch->fscratch);
+				if (n == 0)
+					break;
+
+				/*
+				 * Compare exactly as float8smaller and friends do, so that
+				 * NaNs and zeroes of either sign come out the same.
+				 */
+				i = 0;
+				if (*transValueIsNull)
+					fvalue = batch->fscratch[i++];
+				else if (trans->coltype == BATCH_FLOAT4)
+					fvalue = DatumGetFloat4(*transValue);
+				else
+					fvalue = DatumGetFloat8(*transValue);
+				for (; i < n; i++)
+				{
+					if (trans->kind == BATCH_AGG_MIN ?
+						!float8_lt(fvalue, batch->fscratch[i]) :
+						!float8_gt(fvalue, batch->fscratch[i]))
+						fvalue = batch->fscratch[i];
+				}
+				if (trans->coltype == BATCH_FLOAT4)
+					*transValue = Float4GetDatum((float4) fvalue);
+				else
+					*transValue = Float8GetDatum(fvalue);
+			}
+			else
+			{
+				n = batch_gather_int(batch, trans->attno, trans->coltype,
+									 batch->iscratch);
+				if (n == 0)
+					break;
+
+				if (trans->kind == BATCH_AGG_MIN)
+				{
+					ivalue = batch_kernels->min_int64(batch->iscratch, n);
+					if (!*transValueIsNull)
+						ivalue = Min(ivalue,
+									 batch_datum_get_int(*transValue,
+														 trans->coltype));
+				}
+				else
+				{
+					ivalue = batch_kernels->max_int64(batch->iscratch, n);
+					if (!*transValueIsNull)
+						ivalue = Max(ivalue,
+									 batch_datum_get_int(*transValue,
+														 trans->coltype));
+				}
+				*transValue = batch_int_get_datum(ivalue, trans->coltype);
+			}
+			*transValueIsNull = false;
+			break;
+	}
+}
+
+/*
+ * ExecCreateTupleBatch
+ *
+ * Create an empty batch able to hold maxrows rows of natts attributes each.
+ */
+TupleBatch *
+ExecCreateTupleBatch(int maxrows, int natts)
+{
+	TupleBatch *batch;
+	int			i;
+
+	Assert(maxrows > 0);
+
+	if (batch_kernels == NULL)
+		batch_kernels = batch_choose_kernels();
+
+	batch = (TupleBatch *) palloc0(sizeof(TupleBatch));
+	batch->maxrows = maxrows;
+	batch->natts = natts;
+	batch->values = (Datum **) palloc(natts * sizeof(Datum *));
+	batch->isnull = (bool **) palloc(natts * sizeof(bool *));
+	for (i = 0; i < natts; i++)
+	{
+		batch->values[i] = (Datum *) palloc(maxrows * sizeof(Datum));
+		batch->isnull[i] = (bool *) palloc(maxrows * sizeof(bool));
+	}
+	batch->tids = (ItemPointerData *) palloc(maxrows * sizeof(ItemPointerData));
+	batch->sel = (int *) palloc(maxrows * sizeof(int));
+	batch->iscratch = (int64 *) palloc(maxrows * sizeof(int64));
+	batch->fscratch = (double *) palloc(maxrows * sizeof(double));
+	batch->lastrow = -1;
+
+	return batch;
+}
+
+/*
+ * ExecResetTupleBatch
+ *
+ * Empty a batch, releasing the buffer pins it holds.
+ */
+void
+ExecResetTupleBatch(TupleBatch *batch)
+{
+	int			i;
+
+	for (i = 0; i < batch->nbuffers; i++)
+		ReleaseBuffer(batch->buffers[i]);
+	batch->nbuffers = 0;
+	batch->nrows = 0;
+	batch->nselected = 0;
+	batch->next = 0;
+	batch->lastrow = -1;
+}
+
+/*
+ * ExecTupleBatchAddRow
+ *
+ * Add the row in the given slot, which must hold a tuple in a buffer, to
+ * the batch.  Returns false without adding it if that would require pinning
+ * more buffers than a batch may hold; the caller should then process the
+ * batch, reset it and try again.
+ */
+bool
+ExecTupleBatchAddRow(TupleBatch *batch, TupleTableSlot *slot)
+{
+	BufferHeapTupleTableSlot *bslot = (BufferHeapTupleTableSlot *) slot;
+	int			row = batch->nrows;
+	int			i;
+
+	Assert(TTS_IS_BUFFERTUPLE(slot) && BufferIsValid(bslot->buffer));
+	Assert(row < batch->maxrows);
+
+	/* make sure the batch holds a pin on the row's buffer */
+	if (batch->nbuffers == 0 ||
+		batch->buffers[batch->nbuffers - 1] != bslot->buffer)
+	{
+		if (batch->nbuffers >= TUPLE_BATCH_MAX_BUFFERS)
+			return false;
+		IncrBufferRefCount(bslot->buffer);
+		batch->buffers[batch->nbuffers++] = bslot->buffer;
+	}
+
+	slot_getsomeattrs(slot, batch->natts);
+	for (i = 0; i < batch->natts; i++)
+	{
+		batch->values[i][row] = slot->tts_values[i];
+		batch->isnull[i][row] = slot->tts_isnull[i];
+	}
+	batch->tids[row] = slot->tts_tid;
+	batch->nrows++;
+
+	return true;
+}
+
+/*
+ * ExecStoreBatchRow
+ *
+ * Store one row of a batch into a virtual slot.  Only the batch's natts
+ * attributes are set; the caller must have set the slot's remaining
+ * attributes, which nothing should look at, to NULL.  The slot's tts_tid is
+ * set to the row's TID.
+ */
+void
+ExecStoreBatchRow(TupleBatch *batch, int row, TupleTableSlot *slot)
+{
+	int			i;
+
+	Assert(TTS_IS_VIRTUAL(slot));
+	Assert(row >= 0 && row < batch->nrows);
+
+	ExecClearTuple(slot);
+	for (i = 0; i < batch->natts; i++)
+	{
+		slot->tts_values[i] = batch->values[i][row];
+		slot->tts_isnull[i] = batch->isnull[i][row];
+	}
+	ExecStoreVirtualTuple(slot);
+	slot->tts_tid = batch->tids[row];
+}
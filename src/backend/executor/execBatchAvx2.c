@@ -0,0 +1,284 @@
+/*-------------------------------------------------------------------------
+ *
+ * execBatchAvx2.c
+ *	  AVX2 implementations of the batch kernels.
+ *
+ * See BatchKernels in executor/execBatch.h.  This file is compiled with
+ * the extra CFLAGS needed for AVX2; execBatch.c only uses these kernels
+ * if the CPU supports AVX2.
+ *
+ * The filter kernels compare four values at a time, and turn the resulting
+ * lane mask into a bitmask whose set bits tell which entries of the
+ * selection vector to keep.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *	  src/backend/executor/execBatchAvx2.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#ifdef USE_AVX2_BATCH_WITH_RUNTIME_CHECK
+
+#include <immintrin.h>
+
+#include "executor/execBatch.h"
+#include "port/pg_bitutils.h"
+#include "utils/float.h"
+
+static int	batch_filter_int64_avx2(BatchCmp cmp, int64 c,
+									const int64 *values, int *sel, int n);
+static int	batch_filter_float8_avx2(BatchCmp cmp, double c,
+									 const double *values, int *sel, int n);
+static int64 batch_sum_int64_avx2(const int64 *values, int n);
+static int64 batch_min_int64_avx2(const int64 *values, int n);
+static int64 batch_max_int64_avx2(const int64 *values, int n);
+
+const BatchKernels batch_kernels_avx2 = {
+	batch_filter_int64_avx2,
+	batch_filter_float8_avx2,
+	batch_sum_int64_avx2,
+	batch_min_int64_avx2,
+	batch_max_int64_avx2
+};
+
+/* bitmask of the lanes of a comparison result that are all ones */
+static inline int
+int64_lane_mask(__m256i r)
+{
+	return _mm256_movemask_pd(_mm256_castsi256_pd(r));
+}
+
+/*
+ * Keep the entries of sel[] whose value passes a comparison.  "compare"
+ * computes the bitmask for the four values loaded into v, and "test" checks
+ * values[i] for the last few values.
+ *
+ * sel[] is compacted in place: an entry is always written at or before the
+ * position it was read from, and after all the entries before it were read.
+ */
+#define AVX2_FILTER(load, compare, test) \
+	do { \
+		for (; i + 4 <= n; i += 4) \
+		{ \
+			int			mask; \
+			\
+			v = (load); \
+			mask = (compare); \
+			while (mask != 0) \
+			{ \
+				sel[m++] = sel[i + pg_rightmost_one_pos32(mask)]; \
+				mask &= mask - 1; \
+			} \
+		} \
+		for (; i < n; i++) \
+		{ \
+			if (test) \
+				sel[m++] = sel[i]; \
+		} \
+	} while (0)
+
+#define LOAD_INT64	_mm256_loadu_si256((const __m256i *) &values[i])
+#define LOAD_FLOAT8 _mm256_loadu_pd(&values[i])
+
+static int
+batch_filter_int64_avx2(BatchCmp cmp, int64 c, const int64 *values,
+						int *sel, int n)
+{
+	__m256i		cv = _mm256_set1_epi64x(c);
+	__m256i		v;
+	int			i = 0;
+	int			m = 0;
+
+	switch (cmp)
+	{
+		case BATCH_CMP_EQ:
+			AVX2_FILTER(LOAD_INT64,
+						int64_lane_mask(_mm256_cmpeq_epi64(v, cv)),
+						values[i] == c);
+			break;
+		case BATCH_CMP_NE:
+			AVX2_FILTER(LOAD_INT64,
+						int64_lane_mask(_mm256_cmpeq_epi64(v, cv)) ^ 0xF,
+						values[i] != c);
+			break;
+		case BATCH_CMP_LT:
+			AVX2_FILTER(LOAD_INT64,
+						int64_lane_mask(_mm256_cmpgt_epi64(cv, v)),
+						values[i] < c);
+			break;
+		case BATCH_CMP_LE:
+			AVX2_FILTER(LOAD_INT64,
+						int64_lane_mask(_mm256_cmpgt_epi64(v, cv)) ^ 0xF,
+						values[i] <= c);
+			break;
+		case BATCH_CMP_GT:
+			AVX2_FILTER(LOAD_INT64,
+						int64_lane_mask(_mm256_cmpgt_epi64(v, cv)),
+						values[i] > c);
+			break;
+		case BATCH_CMP_GE:
+			AVX2_FILTER(LOAD_INT64,
+						int64_lane_mask(_mm256_cmpgt_epi64(cv, v)) ^ 0xF,
+						values[i] >= c);
+			break;
+	}
+
+	return m;
+}
+
+/*
+ * With a constant that isn't NaN, the unordered predicates used for "<>",
+ * ">" and ">=" give the answers of the SQL operators, which sort NaN above
+ * all other values; the ordered ones do for the rest.
+ */
+static int
+batch_filter_float8_avx2(BatchCmp cmp, double c, const double *values,
+						 int *sel, int n)
+{
+	__m256d		cv = _mm256_set1_pd(c);
+	__m256d		v;
+	int			i = 0;
+	int			m = 0;
+
+	Assert(!isnan(c));
+
+	switch (cmp)
+	{
+		case BATCH_CMP_EQ:
+			AVX2_FILTER(LOAD_FLOAT8,
+						_mm256_movemask_pd(_mm256_cmp_pd(v, cv, _CMP_EQ_OQ)),
+						float8_eq(values[i], c));
+			break;
+		case BATCH_CMP_NE:
+			AVX2_FILTER(LOAD_FLOAT8,
+						_mm256_movemask_pd(_mm256_cmp_pd(v, cv, _CMP_NEQ_UQ)),
+						float8_ne(values[i], c));
+			break;
+		case BATCH_CMP_LT:
+			AVX2_FILTER(LOAD_FLOAT8,
+						_mm256_movemask_pd(_mm256_cmp_pd(v, cv, _CMP_LT_OQ)),
+						float8_lt(values[i], c));
+			break;
+		case BATCH_CMP_LE:
+			AVX2_FILTER(LOAD_FLOAT8,
+						_mm256_movemask_pd(_mm256_cmp_pd(v, cv, _CMP_LE_OQ)),
+						float8_le(values[i], c));
+			break;
+		case BATCH_CMP_GT:
+			AVX2_FILTER(LOAD_FLOAT8,
+						_mm256_movemask_pd(_mm256_cmp_pd(v, cv, _CMP_NLE_UQ)),
+						float8_gt(values[i], c));
+			break;
+		case BATCH_CMP_GE:
+			AVX2_FILTER(LOAD_FLOAT8,
+						_mm256_movemask_pd(_mm256_cmp_pd(v, cv, _CMP_NLT_UQ)),
+						float8_ge(values[i], c));
+			break;
+	}
+
+	return m;
+}
+
+/*
+ * Integer addition wraps around the same whichever order it's done in, so
+ * summing in four lanes gives the same answer as summing one by one.
+ */
+static int64
+batch_sum_int64_avx2(const int64 *values, int n)
+{
+	__m256i		acc = _mm256_setzero_si256();
+	int64		lanes[4];
+	int64		sum;
+	int			i;
+
+	for (i = 0; i + 4 <= n; i += 4)
+		acc = _mm256_add_epi64(acc, LOAD_INT64);
+
+	_mm256_storeu_si256((__m256i *) lanes, acc);
+	sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	for (; i < n; i++)
+		sum += values[i];
+
+	return sum;
+}
+
+/*
+ * AVX2 has no 64-bit integer min and max instructions, so compare and
+ * blend instead.
+ */
+static int64
+batch_min_int64_avx2(const int64 *values, int n)
+{
+	__m256i		acc;
+	int64		lanes[4];
+	int64		result;
+	int			i;
+
+	Assert(n > 0);
+
+	if (n < 4)
+	{
+		result = values[0];
+		for (i = 1; i < n; i++)
+			result = Min(result, values[i]);
+		return result;
+	}
+
+	i = 0;
+	acc = LOAD_INT64;
+	for (i = 4; i + 4 <= n; i += 4)
+	{
+		__m256i		v = LOAD_INT64;
+
+		acc = _mm256_blendv_epi8(acc, v, _mm256_cmpgt_epi64(acc, v));
+	}
+
+	_mm256_storeu_si256((__m256i *) lanes, acc);
+	result = Min(Min(lanes[0], lanes[1]), Min(lanes[2], lanes[3]));
+	for (; i < n; i++)
+		result = Min(result, values[i]);
+
+	return result;
+}
+
+static int64
+batch_max_int64_avx2(const int64 *values, int n)
+{
+	__m256i		acc;
+	int64		lanes[4];
+	int64		result;
+	int			i;
+
+	Assert(n > 0);
+
+	if (n < 4)
+	{
+		result = values[0];
+		for (i = 1; i < n; i++)
+			result = Max(result, values[i]);
+		return result;
+	}
+
+	i = 0;
+	acc = LOAD_INT64;
+	for (i = 4; i + 4 <= n; i += 4)
+	{
+		__m256i		v = LOAD_INT64;
+
+		acc = _mm256_blendv_epi8(acc, v, _mm256_cmpgt_epi64(v, acc));
+	}
+
+	_mm256_storeu_si256((__m256i *) lanes, acc);
+	result = Max(Max(lanes[0], lanes[1]), Max(lanes[2], lanes[3]));
+	for (; i < n; i++)
+		result = Max(result, values[i]);
+
+	return result;
+}
+
+#endif							/* USE_AVX2_BATCH_WITH_RUNTIME_CHECK */
@@ -206,6 +206,15 @@ execCurrentOf(CurrentOfExpr *cexpr,
 
 			*current_tid = scan->xs_heaptid;
 		}
+		else if (IsA(scanstate, SeqScanState) &&
+				 ((SeqScanState *) scanstate)->batch != NULL)
+		{
+			/*
+			 * A SeqScan in batch mode returns its rows in a virtual slot,
+			 * which has no ctid column, but it does set the slot's tts_tid.
+			 */
+			*current_tid = scanstate->ss_ScanTupleSlot->tts_tid;
+		}
 		else
 		{
 			/*
@@ -325,6 +334,7 @@ search_plan_tree(PlanState *node, Oid table_oid,
 		case T_IndexOnlyScanState:
 		case T_BitmapHeapScanState:
 		case T_TidScanState:
+		case T_TidRangeScanState:
 		case T_ForeignScanState:
 		case T_CustomScanState:
 			{
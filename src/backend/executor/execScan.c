@@ -19,6 +19,7 @@
 #include "postgres.h"
 
 #include "executor/executor.h"
+#include "executor/nodeHash.h"
 #include "miscadmin.h"
 #include "utils/memutils.h"
 
@@ -173,10 +174,11 @@ ExecScan(ScanState *node,
 	/* interrupt checks are in ExecScanFetch */
 
 	/*
-	 * If we have neither a qual to check nor a projection to do, just skip
-	 * all the overhead and return the raw scan tuple.
+	 * If we have neither a qual to check nor a projection to do, nor a
+	 * runtime filter to apply, just skip all the overhead and return the raw
+	 * scan tuple.
 	 */
-	if (!qual && !projInfo)
+	if (!qual && !projInfo && !node->ss_RuntimeFilter)
 	{
 		ResetExprContext(econtext);
 		return ExecScanFetch(node, accessMtd, recheckMtd);
@@ -212,6 +214,18 @@ ExecScan(ScanState *node,
 				return slot;
 		}
 
+		/*
+		 * If the join above us gave us a runtime filter, discard tuples that
+		 * it says can't have a join partner before doing anything else.
+		 */
+		if (node->ss_RuntimeFilter &&
+			!ExecRuntimeFilterTest(node->ss_RuntimeFilter, slot, econtext))
+		{
+			InstrCountFiltered3(node, 1);
+			ResetExprContext(econtext);
+			continue;
+		}
+
 		/*
 		 * place the current tuple into the expr context
 		 */
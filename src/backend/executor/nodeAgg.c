@@ -228,6 +228,18 @@
  *    to filter expressions having to be evaluated early, and allows to JIT
  *    the entire expression into one native function.
  *
+ *    Batch input:
+ *
+ *    A plain aggregate (no grouping) over a sequential scan, whose
+ *    aggregates are all simple count, sum, min or max calls on columns of
+ *    the scan, doesn't need the expression machinery at all.  Such an Agg
+ *    asks the scan to run in batch mode, and if it does so with its whole
+ *    qual evaluated over batches, the Agg takes the scan's batches of
+ *    column vectors and advances its transition states over each of them
+ *    at once (see execBatch.c), bypassing ExecProcNode for the scan.  A
+ *    Result node with a one-time filter between the two passes the batches
+ *    on.
+ *
  * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
  * Portions Copyright (c) 1994, Regents of the University of California
  *
@@ -244,6 +256,7 @@
 #include "catalog/pg_aggregate.h"
 #include "catalog/pg_proc.h"
 #include "catalog/pg_type.h"
+#include "executor/execBatch.h"
 #include "executor/execExpr.h"
 #include "executor/executor.h"
 #include "executor/nodeAgg.h"
@@ -450,6 +463,12 @@ static int	find_compatible_pertrans(AggState *aggstate, Aggref *newagg,
 									 Oid aggserialfn, Oid aggdeserialfn,
 									 Datum initValue, bool initValueIsNull,
 									 List *transnos);
+static bool agg_batch_input_ok(Agg *node);
+static bool agg_batch_aggrefs_walker(Node *node, Plan *outerPlan);
+static bool agg_batch_trans_for_aggref(Aggref *aggref, Oid transfn,
+									   Plan *outerPlan, BatchAggTrans *trans);
+static BatchAggTrans *agg_batch_init(AggState *aggstate);
+static void agg_batch_advance(AggState *aggstate, AggStatePerGroup pergroup);
 
 
 /*
@@ -2323,9 +2342,10 @@ agg_retrieve_direct(AggState *aggstate)
 
 			/*
 			 * If we don't already have the first tuple of the new group,
-			 * fetch it from the outer plan.
+			 * fetch it from the outer plan (unless we're consuming batches).
 			 */
-			if (aggstate->grp_firstTuple == NULL)
+			if (aggstate->grp_firstTuple == NULL &&
+				aggstate->batchtrans == NULL)
 			{
 				outerslot = fetch_input_tuple(aggstate);
 				if (!TupIsNull(outerslot))
@@ -2386,7 +2406,13 @@ agg_retrieve_direct(AggState *aggstate)
 			 */
 			initialize_aggregates(aggstate, pergroups, numReset);
 
-			if (aggstate->grp_firstTuple != NULL)
+			if (aggstate->batchtrans != NULL)
+			{
+				/* aggregate the whole input, batch by batch */
+				agg_batch_advance(aggstate, pergroups[0]);
+				aggstate->agg_done = true;
+			}
+			else if (aggstate->grp_firstTuple != NULL)
 			{
 				/*
 				 * Store the copied first input tuple in the tuple table slot
@@ -3183,6 +3209,7 @@ ExecInitAgg(Agg *node, EState *estate, int eflags)
 	int			j = 0;
 	bool		use_hashing = (node->aggstrategy == AGG_HASHED ||
 							   node->aggstrategy == AGG_MIXED);
+	bool		batchinput;
 
 	/* check for unsupported flags */
 	Assert(!(eflags & (EXEC_FLAG_BACKWARD | EXEC_FLAG_MARK)));
@@ -3285,12 +3312,16 @@ ExecInitAgg(Agg *node, EState *estate, int eflags)
 	 * Initialize child nodes.
 	 *
 	 * If we are doing a hashed aggregation then the child plan does not need
-	 * to handle REWIND efficiently; see ExecReScanAgg.
+	 * to handle REWIND efficiently; see ExecReScanAgg.  If we might consume
+	 * the child's batches, ask it to produce them.
 	 */
 	if (node->aggstrategy == AGG_HASHED)
 		eflags &= ~EXEC_FLAG_REWIND;
 	outerPlan = outerPlan(node);
-	outerPlanState(aggstate) = ExecInitNode(outerPlan, estate, eflags);
+	batchinput = agg_batch_input_ok(node);
+	outerPlanState(aggstate) = ExecInitNode(outerPlan, estate,
+											batchinput ?
+											eflags | EXEC_FLAG_BATCH : eflags);
 
 	/*
 	 * initialize source tuple type.
@@ -4001,6 +4032,13 @@ ExecInitAgg(Agg *node, EState *estate, int eflags)
 		phase->evaltrans_cache[0][0] = phase->evaltrans;
 	}
 
+	/*
+	 * If our input runs in batch mode at our request, see whether we can
+	 * consume its batches.
+	 */
+	if (batchinput && ExecBatchOutputReady(outerPlanState(aggstate)))
+		aggstate->batchtrans = agg_batch_init(aggstate);
+
 	return aggstate;
 }
 
@@ -4477,6 +4515,179 @@ find_compatible_pertrans(AggState *aggstate, Aggref *newagg, bool shareable,
 	return -1;
 }
 
+/*
+ * agg_batch_input_ok
+ *
+ * Could the given Agg consume the batches of its input, instead of its
+ * tuples?  That's possible for a plain aggregate, without grouping sets,
+ * over a plan that supports batch output, if each of its aggregates has a
+ * transition function that can be advanced over a batch (see
+ * agg_batch_trans_for_aggref).
+ *
+ * This has to be decided before initializing the scan, which only runs in
+ * batch mode without any qual to evaluate over batches if we ask it to, so
+ * we look at the Aggrefs in the plan rather than at our per-trans states.
+ */
+static bool
+agg_batch_input_ok(Agg *node)
+{
+	Plan	   *outerPlan = outerPlan(node);
+
+	if (executor_batch_size <= 0 ||
+		node->aggstrategy != AGG_PLAIN ||
+		node->groupingSets != NIL ||
+		DO_AGGSPLIT_COMBINE(node->aggsplit) ||
+		!ExecSupportsBatchOutput(outerPlan))
+		return false;
+
+	return !agg_batch_aggrefs_walker((Node *) node->plan.targetlist,
+									 outerPlan) &&
+		!agg_batch_aggrefs_walker((Node *) node->plan.qual, outerPlan);
+}
+
+/*
+ * Walker for agg_batch_input_ok: returns true if it finds an Aggref that
+ * can't be advanced over batches.
+ */
+static bool
+agg_batch_aggrefs_walker(Node *node, Plan *outerPlan)
+{
+	if (node == NULL)
+		return false;
+	if (IsA(node, Aggref))
+	{
+		Aggref	   *aggref = (Aggref *) node;
+		HeapTuple	aggTuple;
+		Oid			transfn;
+		BatchAggTrans trans;
+
+		aggTuple = SearchSysCache1(AGGFNOID,
+								   ObjectIdGetDatum(aggref->aggfnoid));
+		if (!HeapTupleIsValid(aggTuple))
+			elog(ERROR, "cache lookup failed for aggregate %u",
+				 aggref->aggfnoid);
+		transfn = ((Form_pg_aggregate) GETSTRUCT(aggTuple))->aggtransfn;
+		ReleaseSysCache(aggTuple);
+
+		return !agg_batch_trans_for_aggref(aggref, transfn, outerPlan,
+										   &trans) ||
+			!get_typbyval(aggref->aggtranstype);
+	}
+	return expression_tree_walker(node, agg_batch_aggrefs_walker,
+								  (void *) outerPlan);
+}
+
+/*
+ * agg_batch_trans_for_aggref
+ *
+ * Check whether the given aggregate, with the given transition function,
+ * can be advanced over the batches of outerPlan, and if so set up *trans
+ * for it.  Its only argument, if any, has to be a column of the scanned
+ * relation passed up as is.
+ */
+static bool
+agg_batch_trans_for_aggref(Aggref *aggref, Oid transfn, Plan *outerPlan,
+						   BatchAggTrans *trans)
+{
+	int			attno = -1;
+
+	if (aggref->aggfilter != NULL ||
+		aggref->aggdistinct != NIL ||
+		aggref->aggorder != NIL ||
+		aggref->aggdirectargs != NIL ||
+		list_length(aggref->args) > 1)
+		return false;
+
+	if (aggref->args != NIL)
+	{
+		Node	   *arg = (Node *) linitial_node(TargetEntry, aggref->args)->expr;
+
+		while (IsA(arg, RelabelType))
+			arg = (Node *) ((RelabelType *) arg)->arg;
+		if (!IsA(arg, Var) || ((Var *) arg)->varno != OUTER_VAR)
+			return false;
+
+		attno = ExecBatchOutputAttr(outerPlan, ((Var *) arg)->varattno);
+		if (attno < 0)
+			return false;
+	}
+
+	return ExecInitBatchAggTrans(transfn, attno, trans);
+}
+
+/*
+ * agg_batch_init
+ *
+ * Set up to consume the batches of our input, which runs in batch mode.
+ * Returns the per-trans batch transitions, or NULL if we have to go row by
+ * row after all.
+ */
+static BatchAggTrans *
+agg_batch_init(AggState *aggstate)
+{
+	PlanState  *outerNode = outerPlanState(aggstate);
+	BatchAggTrans *batchtrans;
+	int			natts = 0;
+	int			transno;
+
+	batchtrans = palloc(Max(aggstate->numtrans, 1) * sizeof(BatchAggTrans));
+	for (transno = 0; transno < aggstate->numtrans; transno++)
+	{
+		AggStatePerTrans pertrans = &aggstate->pertrans[transno];
+
+		/*
+		 * The count functions are strict, so a user-defined aggregate using
+		 * them with a NULL initial value would behave differently.
+		 */
+		if (!pertrans->transtypeByVal ||
+			!agg_batch_trans_for_aggref(pertrans->aggref,
+										pertrans->transfn_oid,
+										outerNode->plan,
+										&batchtrans[transno]) ||
+			((batchtrans[transno].kind == BATCH_AGG_COUNT_STAR ||
+			  batchtrans[transno].kind == BATCH_AGG_COUNT) &&
+			 pertrans->initValueIsNull))
+		{
+			pfree(batchtrans);
+			return NULL;
+		}
+		natts = Max(natts, batchtrans[transno].attno + 1);
+	}
+
+	/* the scan needn't deform the columns that only its tlist uses */
+	ExecLimitBatchAttrs(outerNode, natts);
+
+	return batchtrans;
+}
+
+/*
+ * agg_batch_advance
+ *
+ * Advance the transition states of a plain aggregate over all the batches
+ * of its input.
+ */
+static void
+agg_batch_advance(AggState *aggstate, AggStatePerGroup pergroup)
+{
+	TupleBatch *batch;
+	int			transno;
+
+	while ((batch = ExecGetBatch(outerPlanState(aggstate))) != NULL)
+	{
+		for (transno = 0; transno < aggstate->numtrans; transno++)
+		{
+			AggStatePerGroup pergroupstate = &pergroup[transno];
+
+			ExecBatchAggAdvance(&aggstate->batchtrans[transno], batch,
+								&pergroupstate->transValue,
+								&pergroupstate->transValueIsNull);
+
+			/* the state can only still be NULL if there was no input yet */
+			pergroupstate->noTransValue = pergroupstate->transValueIsNull;
+		}
+	}
+}
+
 void
 ExecEndAgg(AggState *node)
 {
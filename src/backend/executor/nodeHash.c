@@ -30,6 +30,7 @@
 #include "access/parallel.h"
 #include "catalog/pg_statistic.h"
 #include "commands/tablespace.h"
+#include "executor/execBatch.h"
 #include "executor/execdebug.h"
 #include "executor/hashjoin.h"
 #include "executor/nodeHash.h"
@@ -43,6 +44,9 @@
 #include "utils/memutils.h"
 #include "utils/syscache.h"
 
+/* GUC parameter */
+bool		hash_join_bucket_tags = false;
+
 static void ExecHashIncreaseNumBatches(HashJoinTable hashtable);
 static void ExecHashIncreaseNumBuckets(HashJoinTable hashtable);
 static void ExecParallelHashIncreaseNumBatches(HashJoinTable hashtable);
@@ -60,11 +64,18 @@ static HashJoinTuple ExecParallelHashTupleAlloc(HashJoinTable hashtable,
 												size_t size,
 												dsa_pointer *shared);
 static void MultiExecPrivateHash(HashState *node);
+static void MultiExecPrivateHashBatches(HashState *node);
+static void ExecHashBuildTuple(HashState *node, TupleTableSlot *slot);
 static void MultiExecParallelHash(HashState *node);
+static bool ExecHashBatchInputOk(Hash *node);
 static inline HashJoinTuple ExecParallelHashFirstTuple(HashJoinTable table,
 													   int bucketno);
 static inline HashJoinTuple ExecParallelHashNextTuple(HashJoinTable table,
 													  HashJoinTuple tuple);
+static inline void ExecHashPushTuple(HashJoinTable hashtable, int bucketno,
+									 HashJoinTuple tuple);
+static inline int ExecHashPrefetchBucketNo(HashJoinTable hashtable,
+										   uint32 hashvalue, bool checktag);
 static inline void ExecParallelHashPushTuple(dsa_pointer_atomic *head,
 											 HashJoinTuple tuple,
 											 dsa_pointer tuple_shared);
@@ -79,6 +90,24 @@ static bool ExecParallelHashTuplePrealloc(HashJoinTable hashtable,
 										  size_t size);
 static void ExecParallelHashMergeCounters(HashJoinTable hashtable);
 static void ExecParallelHashCloseBatchAccessors(HashJoinTable hashtable);
+static void ExecParallelHashMergeRuntimeFilter(HashJoinTable hashtable);
+static void ExecParallelHashLoadRuntimeFilter(HashJoinTable hashtable);
+static void ExecRuntimeFilterExtendRange(RuntimeFilterKey *key,
+										 RuntimeFilterRange *range,
+										 Datum min, Datum max);
+
+/*
+ * A runtime filter must reject at least RUNTIME_FILTER_MIN_REJECT of the
+ * first RUNTIME_FILTER_SAMPLE rows it tests to keep being used.
+ */
+#define RUNTIME_FILTER_SAMPLE		10000
+#define RUNTIME_FILTER_MIN_REJECT	0.1
+
+/*
+ * A runtime filter's Bloom filter may use at most this fraction of the hash
+ * table's memory budget.
+ */
+#define RUNTIME_FILTER_MEM_FRACTION	0.25
 
 
 /* ----------------------------------------------------------------
@@ -138,11 +167,8 @@ static void
 MultiExecPrivateHash(HashState *node)
 {
 	PlanState  *outerNode;
-	List	   *hashkeys;
 	HashJoinTable hashtable;
 	TupleTableSlot *slot;
-	ExprContext *econtext;
-	uint32		hashvalue;
 
 	/*
 	 * get state info from node
@@ -150,43 +176,20 @@ MultiExecPrivateHash(HashState *node)
 	outerNode = outerPlanState(node);
 	hashtable = node->hashtable;
 
-	/*
-	 * set expression context
-	 */
-	hashkeys = node->hashkeys;
-	econtext = node->ps.ps_ExprContext;
-
 	/*
 	 * Get all tuples from the node below the Hash node and insert into the
 	 * hash table (or temp files).
 	 */
-	for (;;)
+	if (node->batchattrs != NULL)
+		MultiExecPrivateHashBatches(node);
+	else
 	{
-		slot = ExecProcNode(outerNode);
-		if (TupIsNull(slot))
-			break;
-		/* We have to compute the hash value */
-		econtext->ecxt_outertuple = slot;
-		if (ExecHashGetHashValue(hashtable, econtext, hashkeys,
-								 false, hashtable->keepNulls,
-								 &hashvalue))
+		for (;;)
 		{
-			int			bucketNumber;
-
-			bucketNumber = ExecHashGetSkewBucket(hashtable, hashvalue);
-			if (bucketNumber != INVALID_SKEW_BUCKET_NO)
-			{
-				/* It's a skew tuple, so put it into that hash table */
-				ExecHashSkewTableInsert(hashtable, slot, hashvalue,
-										bucketNumber);
-				hashtable->skewTuples += 1;
-			}
-			else
-			{
-				/* Not subject to skew optimization, so insert normally */
-				ExecHashTableInsert(hashtable, slot, hashvalue);
-			}
-			hashtable->totalTuples += 1;
+			slot = ExecProcNode(outerNode);
+			if (TupIsNull(slot))
+				break;
+			ExecHashBuildTuple(node, slot);
 		}
 	}
 
@@ -195,13 +198,94 @@ MultiExecPrivateHash(HashState *node)
 		ExecHashIncreaseNumBuckets(hashtable);
 
 	/* Account for the buckets in spaceUsed (reported in EXPLAIN ANALYZE) */
-	hashtable->spaceUsed += hashtable->nbuckets * sizeof(HashJoinTuple);
+	hashtable->spaceUsed += hashtable->nbuckets * HJ_BUCKET_SIZE(hashtable);
 	if (hashtable->spaceUsed > hashtable->spacePeak)
 		hashtable->spacePeak = hashtable->spaceUsed;
 
 	hashtable->partialTuples = hashtable->totalTuples;
 }
 
+/* ----------------------------------------------------------------
+ *		MultiExecPrivateHashBatches
+ *
+ *		take all tuples from the node below the Hash node a batch of
+ *		rows at a time (see execBatch.c), and insert them into the
+ *		hash table.  The rows listed in the selection vector of each
+ *		batch are stored into batchslot as the tuples the node would
+ *		have returned, without going through its ExecProcNode and
+ *		projection.
+ * ----------------------------------------------------------------
+ */
+static void
+MultiExecPrivateHashBatches(HashState *node)
+{
+	TupleTableSlot *slot = node->batchslot;
+	int			natts = slot->tts_tupleDescriptor->natts;
+	TupleBatch *batch;
+	int			i;
+	int			attno;
+
+	while ((batch = ExecGetBatch(outerPlanState(node))) != NULL)
+	{
+		for (i = 0; i < batch->nselected; i++)
+		{
+			int			row = batch->sel[i];
+
+			ExecClearTuple(slot);
+			for (attno = 0; attno < natts; attno++)
+			{
+				int			col = node->batchattrs[attno];
+
+				slot->tts_values[attno] = batch->values[col][row];
+				slot->tts_isnull[attno] = batch->isnull[col][row];
+			}
+			ExecStoreVirtualTuple(slot);
+
+			ExecHashBuildTuple(node, slot);
+		}
+	}
+}
+
+/* ----------------------------------------------------------------
+ *		ExecHashBuildTuple
+ *
+ *		compute the hash value of a tuple of the node below the Hash
+ *		node, and insert it into the private hash table (or temp
+ *		files)
+ * ----------------------------------------------------------------
+ */
+static void
+ExecHashBuildTuple(HashState *node, TupleTableSlot *slot)
+{
+	HashJoinTable hashtable = node->hashtable;
+	ExprContext *econtext = node->ps.ps_ExprContext;
+	uint32		hashvalue;
+
+	/* We have to compute the hash value */
+	econtext->ecxt_outertuple = slot;
+	if (ExecHashGetHashValue(hashtable, econtext, node->hashkeys,
+							 false, hashtable->keepNulls,
+							 &hashvalue))
+	{
+		int			bucketNumber;
+
+		bucketNumber = ExecHashGetSkewBucket(hashtable, hashvalue);
+		if (bucketNumber != INVALID_SKEW_BUCKET_NO)
+		{
+			/* It's a skew tuple, so put it into that hash table */
+			ExecHashSkewTableInsert(hashtable, slot, hashvalue,
+									bucketNumber);
+			hashtable->skewTuples += 1;
+		}
+		else
+		{
+			/* Not subject to skew optimization, so insert normally */
+			ExecHashTableInsert(hashtable, slot, hashvalue);
+		}
+		hashtable->totalTuples += 1;
+	}
+}
+
 /* ----------------------------------------------------------------
  *		MultiExecParallelHash
  *
@@ -303,6 +387,10 @@ MultiExecParallelHash(HashState *node)
 			 */
 			ExecParallelHashMergeCounters(hashtable);
 
+			/* Add the inner tuples we hashed to the shared runtime filter. */
+			if (hashtable->runtimefilter != NULL)
+				ExecParallelHashMergeRuntimeFilter(hashtable);
+
 			BarrierDetach(&pstate->grow_buckets_barrier);
 			BarrierDetach(&pstate->grow_batches_barrier);
 
@@ -334,6 +422,10 @@ MultiExecParallelHash(HashState *node)
 	hashtable->totalTuples = pstate->total_tuples;
 	ExecParallelHashEnsureBatchAccessors(hashtable);
 
+	/* Our runtime filter must cover the tuples everyone hashed. */
+	if (hashtable->runtimefilter != NULL)
+		ExecParallelHashLoadRuntimeFilter(hashtable);
+
 	/*
 	 * The next synchronization point is in ExecHashJoin's HJ_BUILD_HASHTABLE
 	 * case, which will bring the build phase to PHJ_BUILD_DONE (if it isn't
@@ -353,6 +445,7 @@ HashState *
 ExecInitHash(Hash *node, EState *estate, int eflags)
 {
 	HashState  *hashstate;
+	bool		batchinput;
 
 	/* check for unsupported flags */
 	Assert(!(eflags & (EXEC_FLAG_BACKWARD | EXEC_FLAG_MARK)));
@@ -366,6 +459,8 @@ ExecInitHash(Hash *node, EState *estate, int eflags)
 	hashstate->ps.ExecProcNode = ExecHash;
 	hashstate->hashtable = NULL;
 	hashstate->hashkeys = NIL;	/* will be set by parent HashJoin */
+	hashstate->batchattrs = NULL;
+	hashstate->batchslot = NULL;
 
 	/*
 	 * Miscellaneous initialization
@@ -375,9 +470,13 @@ ExecInitHash(Hash *node, EState *estate, int eflags)
 	ExecAssignExprContext(estate, &hashstate->ps);
 
 	/*
-	 * initialize child nodes
+	 * initialize child nodes.  If we might build the hash table from the
+	 * child's batches of rows, ask it to produce them.
 	 */
-	outerPlanState(hashstate) = ExecInitNode(outerPlan(node), estate, eflags);
+	batchinput = ExecHashBatchInputOk(node);
+	outerPlanState(hashstate) = ExecInitNode(outerPlan(node), estate,
+											 batchinput ?
+											 eflags | EXEC_FLAG_BATCH : eflags);
 
 	/*
 	 * initialize our result slot and type. No need to build projection
@@ -393,9 +492,63 @@ ExecInitHash(Hash *node, EState *estate, int eflags)
 	hashstate->hashkeys =
 		ExecInitExprList(node->hashkeys, (PlanState *) hashstate);
 
+	/*
+	 * If the child runs in batch mode at our request, find its output
+	 * columns in the batches, and a slot to store its rows in.
+	 */
+	if (batchinput && ExecBatchOutputReady(outerPlanState(hashstate)))
+	{
+		PlanState  *outerNode = outerPlanState(hashstate);
+		TupleDesc	tupdesc = ExecGetResultType(outerNode);
+		int			natts = 0;
+		int			attno;
+
+		hashstate->batchattrs = palloc(Max(tupdesc->natts, 1) * sizeof(int));
+		for (attno = 0; attno < tupdesc->natts; attno++)
+		{
+			hashstate->batchattrs[attno] =
+				ExecBatchOutputAttr(outerNode->plan, attno + 1);
+			Assert(hashstate->batchattrs[attno] >= 0);
+			natts = Max(natts, hashstate->batchattrs[attno] + 1);
+		}
+		hashstate->batchslot = ExecInitExtraTupleSlot(estate, tupdesc,
+													  &TTSOpsVirtual);
+		ExecLimitBatchAttrs(outerNode, natts);
+	}
+
 	return hashstate;
 }
 
+/*
+ * ExecHashBatchInputOk
+ *
+ * Could the given Hash node build its hash table from batches of rows of
+ * its input, instead of from its tuples?  That's possible for a hash table
+ * private to this process, if each output column of the input is a column
+ * of the scanned relation, passed up as is.
+ */
+static bool
+ExecHashBatchInputOk(Hash *node)
+{
+	Plan	   *outerPlan = outerPlan(node);
+	ListCell   *lc;
+
+	if (executor_batch_size <= 0 ||
+		node->plan.parallel_aware ||
+		!ExecSupportsBatchOutput(outerPlan))
+		return false;
+
+	foreach(lc, outerPlan->targetlist)
+	{
+		TargetEntry *tle = lfirst_node(TargetEntry, lc);
+
+		if (ExecBatchOutputAttr(outerPlan, tle->resno) < 0)
+			return false;
+	}
+
+	return true;
+}
+
 /* ---------------------------------------------------------------
  *		ExecEndHash
  *
@@ -485,6 +638,7 @@ ExecHashTableCreate(HashState *state, List *hashOperators, List *hashCollations,
 	hashtable->log2_nbuckets = log2_nbuckets;
 	hashtable->log2_nbuckets_optimal = log2_nbuckets;
 	hashtable->buckets.unshared = NULL;
+	hashtable->bucketTags = NULL;
 	hashtable->keepNulls = keepNulls;
 	hashtable->skewEnabled = false;
 	hashtable->skewBucket = NULL;
@@ -512,6 +666,7 @@ ExecHashTableCreate(HashState *state, List *hashOperators, List *hashCollations,
 	hashtable->parallel_state = state->parallel_state;
 	hashtable->area = state->ps.state->es_query_dsa;
 	hashtable->batches = NULL;
+	hashtable->runtimefilter = NULL;
 
 #ifdef HJDEBUG
 	printf("Hashjoin %p: initial nbatch = %d, nbuckets = %d\n",
@@ -637,6 +792,9 @@ ExecHashTableCreate(HashState *state, List *hashOperators, List *hashCollations,
 
 		hashtable->buckets.unshared = (HashJoinTuple *)
 			palloc0(nbuckets * sizeof(HashJoinTuple));
+		if (hash_join_bucket_tags)
+			hashtable->bucketTags = (HashJoinBucketTag *)
+				palloc0(nbuckets * sizeof(HashJoinBucketTag));
 
 		/*
 		 * Set up for skew optimization, if possible and there's a need for
@@ -955,6 +1113,10 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
 		hashtable->buckets.unshared =
 			repalloc(hashtable->buckets.unshared,
 					 sizeof(HashJoinTuple) * hashtable->nbuckets);
+		if (hashtable->bucketTags)
+			hashtable->bucketTags =
+				repalloc(hashtable->bucketTags,
+						 sizeof(HashJoinBucketTag) * hashtable->nbuckets);
 	}
 
 	/*
@@ -964,6 +1126,9 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
 	 */
 	memset(hashtable->buckets.unshared, 0,
 		   sizeof(HashJoinTuple) * hashtable->nbuckets);
+	if (hashtable->bucketTags)
+		memset(hashtable->bucketTags, 0,
+			   sizeof(HashJoinBucketTag) * hashtable->nbuckets);
 	oldchunks = hashtable->chunks;
 	hashtable->chunks = NULL;
 
@@ -997,8 +1162,7 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
 				memcpy(copyTuple, hashTuple, hashTupleSize);
 
 				/* and add it back to the appropriate bucket */
-				copyTuple->next.unshared = hashtable->buckets.unshared[bucketno];
-				hashtable->buckets.unshared[bucketno] = copyTuple;
+				ExecHashPushTuple(hashtable, bucketno, copyTuple);
 			}
 			else
 			{
@@ -1421,6 +1585,78 @@ ExecParallelHashMergeCounters(HashJoinTable hashtable)
 	LWLockRelease(&pstate->lock);
 }
 
+/*
+ * Combine the runtime filter over the inner tuples we hashed with those of
+ * the other participants.  The first participant to get here copies its
+ * filter into DSA memory, and the rest add theirs to that.
+ */
+static void
+ExecParallelHashMergeRuntimeFilter(HashJoinTable hashtable)
+{
+	ParallelHashJoinState *pstate = hashtable->parallel_state;
+	RuntimeFilter filter = hashtable->runtimefilter;
+	SharedRuntimeFilter *shared;
+	Size		bloomsize = filter->bloom ? bloom_size(filter->bloom) : 0;
+	int			i;
+
+	LWLockAcquire(&pstate->lock, LW_EXCLUSIVE);
+	if (!DsaPointerIsValid(pstate->runtime_filter))
+	{
+		pstate->runtime_filter =
+			dsa_allocate(hashtable->area,
+						 SharedRuntimeFilterBloomOffset(filter->nkeys) +
+						 bloomsize);
+		shared = dsa_get_address(hashtable->area, pstate->runtime_filter);
+		shared->nkeys = filter->nkeys;
+		for (i = 0; i < filter->nkeys; i++)
+			shared->ranges[i] = filter->keys[i].range;
+		if (filter->bloom != NULL)
+			memcpy(SharedRuntimeFilterBloom(shared), filter->bloom, bloomsize);
+	}
+	else
+	{
+		shared = dsa_get_address(hashtable->area, pstate->runtime_filter);
+		Assert(shared->nkeys == filter->nkeys);
+		for (i = 0; i < filter->nkeys; i++)
+		{
+			RuntimeFilterKey *key = &filter->keys[i];
+
+			if (key->hasrange && !key->range.empty)
+				ExecRuntimeFilterExtendRange(key, &shared->ranges[i],
+											 key->range.min, key->range.max);
+		}
+		if (filter->bloom != NULL)
+			bloom_union(SharedRuntimeFilterBloom(shared), filter->bloom);
+	}
+	LWLockRelease(&pstate->lock);
+}
+
+/*
+ * Make our runtime filter the combination of all the participants' filters,
+ * once they've all been merged.  If there's no combined filter to be had,
+ * we have none either.
+ */
+static void
+ExecParallelHashLoadRuntimeFilter(HashJoinTable hashtable)
+{
+	ParallelHashJoinState *pstate = hashtable->parallel_state;
+	RuntimeFilter filter = hashtable->runtimefilter;
+	SharedRuntimeFilter *shared;
+	int			i;
+
+	if (!DsaPointerIsValid(pstate->runtime_filter))
+	{
+		hashtable->runtimefilter = NULL;
+		return;
+	}
+
+	shared = dsa_get_address(hashtable->area, pstate->runtime_filter);
+	for (i = 0; i < filter->nkeys; i++)
+		filter->keys[i].range = shared->ranges[i];
+	if (filter->bloom != NULL)
+		bloom_union(filter->bloom, SharedRuntimeFilterBloom(shared));
+}
+
 /*
  * ExecHashIncreaseNumBuckets
  *		increase the original number of buckets in order to reduce
@@ -1460,6 +1696,15 @@ ExecHashIncreaseNumBuckets(HashJoinTable hashtable)
 	memset(hashtable->buckets.unshared, 0,
 		   hashtable->nbuckets * sizeof(HashJoinTuple));
 
+	if (hashtable->bucketTags)
+	{
+		hashtable->bucketTags = (HashJoinBucketTag *)
+			repalloc(hashtable->bucketTags,
+					 hashtable->nbuckets * sizeof(HashJoinBucketTag));
+		memset(hashtable->bucketTags, 0,
+			   hashtable->nbuckets * sizeof(HashJoinBucketTag));
+	}
+
 	/* scan through all tuples in all chunks to rebuild the hash table */
 	for (chunk = hashtable->chunks; chunk != NULL; chunk = chunk->next.unshared)
 	{
@@ -1476,8 +1721,7 @@ ExecHashIncreaseNumBuckets(HashJoinTable hashtable)
 									  &bucketno, &batchno);
 
 			/* add the tuple to the proper bucket */
-			hashTuple->next.unshared = hashtable->buckets.unshared[bucketno];
-			hashtable->buckets.unshared[bucketno] = hashTuple;
+			ExecHashPushTuple(hashtable, bucketno, hashTuple);
 
 			/* advance index past the tuple */
 			idx += MAXALIGN(HJTUPLE_OVERHEAD +
@@ -1629,8 +1873,7 @@ ExecHashTableInsert(HashJoinTable hashtable,
 		HeapTupleHeaderClearMatch(HJTUPLE_MINTUPLE(hashTuple));
 
 		/* Push it onto the front of the bucket's list */
-		hashTuple->next.unshared = hashtable->buckets.unshared[bucketno];
-		hashtable->buckets.unshared[bucketno] = hashTuple;
+		ExecHashPushTuple(hashtable, bucketno, hashTuple);
 
 		/*
 		 * Increase the (optimal) number of buckets if we just exceeded the
@@ -1654,7 +1897,7 @@ ExecHashTableInsert(HashJoinTable hashtable,
 		if (hashtable->spaceUsed > hashtable->spacePeak)
 			hashtable->spacePeak = hashtable->spaceUsed;
 		if (hashtable->spaceUsed +
-			hashtable->nbuckets_optimal * sizeof(HashJoinTuple)
+			hashtable->nbuckets_optimal * HJ_BUCKET_SIZE(hashtable)
 			> hashtable->spaceAllowed)
 			ExecHashIncreaseNumBatches(hashtable);
 	}
@@ -1785,6 +2028,9 @@ ExecParallelHashTableInsertCurrentBatch(HashJoinTable hashtable,
  * and stored at *hashvalue.  A false result means the tuple cannot match
  * because it contains a null attribute, and hence it should be discarded
  * immediately.  (If keep_nulls is true then false is never returned.)
+ *
+ * If the hash table has a runtime filter, inner tuples with a true result
+ * are added to it.
  */
 bool
 ExecHashGetHashValue(HashJoinTable hashtable,
@@ -1856,17 +2102,180 @@ ExecHashGetHashValue(HashJoinTable hashtable,
 
 			hkey = DatumGetUInt32(FunctionCall1Coll(&hashfunctions[i], hashtable->collations[i], keyval));
 			hashkey ^= hkey;
+
+			if (!outer_tuple && hashtable->runtimefilter != NULL &&
+				hashtable->runtimefilter->keys[i].hasrange)
+				ExecRuntimeFilterExtendRange(&hashtable->runtimefilter->keys[i],
+											 &hashtable->runtimefilter->keys[i].range,
+											 keyval, keyval);
 		}
 
 		i++;
 	}
 
+	if (!outer_tuple && hashtable->runtimefilter != NULL &&
+		hashtable->runtimefilter->bloom != NULL)
+		bloom_add_element(hashtable->runtimefilter->bloom,
+						  (unsigned char *) &hashkey, sizeof(hashkey));
+
 	MemoryContextSwitchTo(oldContext);
 
 	*hashvalue = hashkey;
 	return true;
 }
 
+/*
+ * ExecHashTableBeginRuntimeFilter
+ *		Start building a runtime filter along with the hash table
+ *
+ * Any filter built for a previous hash table is forgotten.  The caller
+ * must make sure the scan doesn't use the filter until the hash table has
+ * been built.
+ *
+ * The Bloom filter lives as long as the hash table, so it comes out of the
+ * hash table's memory budget: it gets at most RUNTIME_FILTER_MEM_FRACTION of
+ * it, and a private hash table has that much less left for tuples.  (All
+ * participants of a Parallel Hash size it alike, from the same budget.)
+ * bloom_create() won't go below 1MB, so with a smaller budget we do without
+ * the Bloom filter and check just the key ranges, or don't filter at all if
+ * there are none.
+ */
+void
+ExecHashTableBeginRuntimeFilter(HashJoinTable hashtable, RuntimeFilter filter)
+{
+	Size		bloom_mem;
+	bool		hasrange = false;
+	int			i;
+
+	Assert(filter->scan->ss_RuntimeFilter == NULL);
+
+	if (filter->bloom != NULL)
+		bloom_free(filter->bloom);
+	filter->bloom = NULL;
+
+	bloom_mem = hashtable->spaceAllowed * RUNTIME_FILTER_MEM_FRACTION;
+	if (bloom_mem >= 1024 * 1024)
+	{
+		filter->bloom = bloom_create(filter->nelems,
+									 (int) Min(bloom_mem / 1024, INT_MAX), 0);
+		if (hashtable->parallel_state == NULL)
+			hashtable->spaceAllowed -= bloom_size(filter->bloom);
+	}
+
+	for (i = 0; i < filter->nkeys; i++)
+	{
+		filter->keys[i].range.empty = true;
+		hasrange |= filter->keys[i].hasrange;
+	}
+
+	if (filter->bloom == NULL && !hasrange)
+		return;
+
+	filter->ntested = 0;
+	filter->nrejected = 0;
+
+	hashtable->runtimefilter = filter;
+}
+
+/*
+ * ExecRuntimeFilterExtendRange
+ *		Widen a key's range to include the values from min to max
+ */
+static void
+ExecRuntimeFilterExtendRange(RuntimeFilterKey *key, RuntimeFilterRange *range,
+							 Datum min, Datum max)
+{
+	if (range->empty)
+	{
+		range->min = min;
+		range->max = max;
+		range->empty = false;
+		return;
+	}
+
+	if (DatumGetInt32(FunctionCall2Coll(&key->cmpfn, key->collation,
+										min, range->min)) < 0)
+		range->min = min;
+	if (DatumGetInt32(FunctionCall2Coll(&key->cmpfn, key->collation,
+										max, range->max)) > 0)
+		range->max = max;
+}
+
+/*
+ * ExecRuntimeFilterTest
+ *		Check whether a row of the outer scan may have a join partner
+ *
+ * slot holds a row of the scan's relation.  Returns false if the row
+ * certainly has no partner among the inner tuples, true if it might.
+ * Memory is allocated in econtext's per-tuple context.
+ *
+ * After RUNTIME_FILTER_SAMPLE rows, we check how many of them the filter
+ * rejected, and if too few, tell the scan to stop using it.
+ */
+bool
+ExecRuntimeFilterTest(RuntimeFilter filter, TupleTableSlot *slot,
+					  ExprContext *econtext)
+{
+	uint32		hashkey = 0;
+	bool		result = true;
+	MemoryContext oldContext;
+	int			i;
+
+	oldContext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+
+	/* this must compute the same hash value as ExecHashGetHashValue */
+	for (i = 0; i < filter->nkeys; i++)
+	{
+		RuntimeFilterKey *key = &filter->keys[i];
+		Datum		keyval;
+		bool		isNull;
+
+		/* rotate hashkey left 1 bit at each step */
+		hashkey = (hashkey << 1) | ((hashkey & 0x80000000) ? 1 : 0);
+
+		keyval = slot_getattr(slot, key->attno, &isNull);
+		if (isNull)
+		{
+			if (key->strict)
+			{
+				result = false;
+				break;
+			}
+			continue;
+		}
+
+		if (key->hasrange &&
+			(key->range.empty ||
+			 DatumGetInt32(FunctionCall2Coll(&key->cmpfn, key->collation,
+											 keyval, key->range.min)) < 0 ||
+			 DatumGetInt32(FunctionCall2Coll(&key->cmpfn, key->collation,
+											 keyval, key->range.max)) > 0))
+		{
+			result = false;
+			break;
+		}
+
+		hashkey ^= DatumGetUInt32(FunctionCall1Coll(&key->hashfn,
+													key->collation,
+													keyval));
+	}
+
+	if (result && filter->bloom != NULL &&
+		bloom_lacks_element(filter->bloom, (unsigned char *) &hashkey,
+							sizeof(hashkey)))
+		result = false;
+
+	MemoryContextSwitchTo(oldContext);
+
+	if (!result)
+		filter->nrejected++;
+	if (++filter->ntested == RUNTIME_FILTER_SAMPLE &&
+		filter->nrejected < RUNTIME_FILTER_SAMPLE * RUNTIME_FILTER_MIN_REJECT)
+		filter->scan->ss_RuntimeFilter = NULL;
+
+	return result;
+}
+
 /*
  * ExecHashGetBucketAndBatch
  *		Determine the bucket number and batch number for a hash value
@@ -1916,6 +2325,92 @@ ExecHashGetBucketAndBatch(HashJoinTable hashtable,
 	}
 }
 
+/*
+ * ExecHashPrefetchBuckets
+ *		start loading the buckets that a group of outer tuples will probe
+ *
+ * Probing a bucket costs a cache miss for the bucket header and then another
+ * for the first tuple in it, which can't start until the first one is done,
+ * so once the hash table is much bigger than the CPU caches, probing one
+ * outer tuple at a time spends most of its time waiting for memory.  Given
+ * the hash values of the next few outer tuples, we prefetch all of their
+ * bucket headers (or tags) first, and then all of their first tuples, so
+ * that the misses of the whole group overlap.
+ *
+ * This is only a hint; tuples that turn out to belong to a skew bucket just
+ * waste a prefetch.
+ */
+void
+ExecHashPrefetchBuckets(HashJoinTable hashtable, const uint32 *hashvalues,
+						int n)
+{
+	int			bucketno;
+	int			i;
+
+	/* Bucket headers, or the tags if we have them */
+	for (i = 0; i < n; i++)
+	{
+		bucketno = ExecHashPrefetchBucketNo(hashtable, hashvalues[i], false);
+		if (bucketno < 0)
+			continue;
+		if (hashtable->parallel_state)
+			pg_prefetch_mem(&hashtable->buckets.shared[bucketno]);
+		else if (hashtable->bucketTags)
+			pg_prefetch_mem(&hashtable->bucketTags[bucketno]);
+		else
+			pg_prefetch_mem(&hashtable->buckets.unshared[bucketno]);
+	}
+
+	/* The headers of the buckets whose tags say they might have a match */
+	if (hashtable->bucketTags)
+	{
+		for (i = 0; i < n; i++)
+		{
+			bucketno = ExecHashPrefetchBucketNo(hashtable, hashvalues[i], true);
+			if (bucketno >= 0)
+				pg_prefetch_mem(&hashtable->buckets.unshared[bucketno]);
+		}
+	}
+
+	/* The first tuple of each bucket */
+	for (i = 0; i < n; i++)
+	{
+		HashJoinTuple hashTuple;
+
+		bucketno = ExecHashPrefetchBucketNo(hashtable, hashvalues[i], true);
+		if (bucketno < 0)
+			continue;
+		if (hashtable->parallel_state)
+			hashTuple = ExecParallelHashFirstTuple(hashtable, bucketno);
+		else
+			hashTuple = hashtable->buckets.unshared[bucketno];
+		if (hashTuple != NULL)
+			pg_prefetch_mem(hashTuple);
+	}
+}
+
+/*
+ * The bucket that ExecHashPrefetchBuckets should prefetch for an outer tuple
+ * with the given hash value, or -1 if the tuple belongs to a later batch or,
+ * if checktag is true, the bucket's tag says the tuple has no match.
+ */
+static inline int
+ExecHashPrefetchBucketNo(HashJoinTable hashtable, uint32 hashvalue,
+						 bool checktag)
+{
+	int			bucketno;
+	int			batchno;
+
+	ExecHashGetBucketAndBatch(hashtable, hashvalue, &bucketno, &batchno);
+	if (batchno != hashtable->curbatch)
+		return -1;
+	if (checktag && hashtable->bucketTags != NULL &&
+		(hashtable->bucketTags[bucketno] & HJ_BUCKET_TAG(hashvalue)) == 0)
+		return -1;
+
+	return bucketno;
+}
+
 /*
  * ExecScanHashBucket
  *		scan a hash bucket for matches to the current outer tuple
@@ -1946,6 +2441,10 @@ ExecScanHashBucket(HashJoinState *hjstate,
 		hashTuple = hashTuple->next.unshared;
 	else if (hjstate->hj_CurSkewBucketNo != INVALID_SKEW_BUCKET_NO)
 		hashTuple = hashtable->skewBucket[hjstate->hj_CurSkewBucketNo]->tuples;
+	else if (hashtable->bucketTags != NULL &&
+			 (hashtable->bucketTags[hjstate->hj_CurBucketNo] &
+			  HJ_BUCKET_TAG(hashvalue)) == 0)
+		return false;			/* no tuple in the bucket can match */
 	else
 		hashTuple = hashtable->buckets.unshared[hjstate->hj_CurBucketNo];
 
@@ -2149,6 +2648,9 @@ ExecHashTableReset(HashJoinTable hashtable)
 	/* Reallocate and reinitialize the hash bucket headers. */
 	hashtable->buckets.unshared = (HashJoinTuple *)
 		palloc0(nbuckets * sizeof(HashJoinTuple));
+	if (hashtable->bucketTags)
+		hashtable->bucketTags = (HashJoinBucketTag *)
+			palloc0(nbuckets * sizeof(HashJoinBucketTag));
 
 	hashtable->spaceUsed = 0;
 
@@ -2506,8 +3008,7 @@ ExecHashRemoveNextSkewBucket(HashJoinTable hashtable)
 			memcpy(copyTuple, hashTuple, tupleSize);
 			pfree(hashTuple);
 
-			copyTuple->next.unshared = hashtable->buckets.unshared[bucketno];
-			hashtable->buckets.unshared[bucketno] = copyTuple;
+			ExecHashPushTuple(hashtable, bucketno, copyTuple);
 
 			/* We have reduced skew space, but overall space doesn't change */
 			hashtable->spaceUsedSkew -= tupleSize;
@@ -3196,12 +3697,31 @@ ExecHashTableDetach(HashJoinTable hashtable)
 				dsa_free(hashtable->area, pstate->batches);
 				pstate->batches = InvalidDsaPointer;
 			}
+			if (DsaPointerIsValid(pstate->runtime_filter))
+			{
+				dsa_free(hashtable->area, pstate->runtime_filter);
+				pstate->runtime_filter = InvalidDsaPointer;
+			}
 		}
 
 		hashtable->parallel_state = NULL;
 	}
 }
 
+/*
+ * Insert a tuple at the front of a bucket of a private hash table, and set
+ * its bit in the bucket's tag.
+ */
+static inline void
+ExecHashPushTuple(HashJoinTable hashtable, int bucketno, HashJoinTuple tuple)
+{
+	Assert(!hashtable->parallel_state);
+	tuple->next.unshared = hashtable->buckets.unshared[bucketno];
+	hashtable->buckets.unshared[bucketno] = tuple;
+	if (hashtable->bucketTags)
+		hashtable->bucketTags[bucketno] |= HJ_BUCKET_TAG(tuple->hashvalue);
+}
+
 /*
  * Get the first tuple in a given bucket identified by number.
  */
@@ -107,16 +107,43 @@
 #include "postgres.h"
 
 #include "access/htup_details.h"
+#include "access/nbtree.h"
 #include "access/parallel.h"
 #include "executor/executor.h"
 #include "executor/hashjoin.h"
 #include "executor/nodeHash.h"
 #include "executor/nodeHashjoin.h"
 #include "miscadmin.h"
+#include "optimizer/optimizer.h"
+#include "parser/parsetree.h"
 #include "pgstat.h"
+#include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/sharedtuplestore.h"
 
+/* GUC parameters */
+bool		runtime_join_filter = true;
+bool		hash_join_prefetch = true;
+
+/*
+ * When hash_join_prefetch is on, we read up to this many outer tuples ahead
+ * and prefetch the buckets they'll probe, if the hash table has at least
+ * HJ_PREFETCH_MIN_BUCKETS buckets.  A smaller table (which, at one tuple per
+ * bucket, takes up less than a megabyte or so) is likely to stay in cache
+ * anyway, and then copying the outer tuples costs more than it saves.
+ *
+ * Reading ahead means the outer plan may produce up to
+ * HJ_PREFETCH_GROUP_SIZE - 1 rows that the join never looks at, if its
+ * caller stops early (say, under a LIMIT).  To keep that small for joins
+ * that only return a few rows, the first group of each batch has
+ * HJ_PREFETCH_INITIAL_GROUP_SIZE tuples, and each group after that is twice
+ * as big as the one before, up to HJ_PREFETCH_GROUP_SIZE; so we never read
+ * ahead more than about as many rows as we've already returned.
+ */
+#define HJ_PREFETCH_INITIAL_GROUP_SIZE	2
+#define HJ_PREFETCH_GROUP_SIZE			16
+#define HJ_PREFETCH_MIN_BUCKETS			16384
+
 
 /*
  * States of the ExecHashJoin state machine
@@ -143,9 +170,14 @@ static TupleTableSlot *ExecHashJoinGetSavedTuple(HashJoinState *hjstate,
 												 BufFile *file,
 												 uint32 *hashvalue,
 												 TupleTableSlot *tupleSlot);
+static pg_attribute_always_inline TupleTableSlot *ExecHashJoinNextOuterTuple(PlanState *outerNode,
+																			  HashJoinState *hjstate,
+																			  uint32 *hashvalue,
+																			  bool parallel);
 static bool ExecHashJoinNewBatch(HashJoinState *hjstate);
 static bool ExecParallelHashJoinNewBatch(HashJoinState *hjstate);
 static void ExecParallelHashJoinPartitionOuter(HashJoinState *node);
+static RuntimeFilter ExecHashJoinInitRuntimeFilter(HashJoinState *hjstate);
 
 
 /* ----------------------------------------------------------------
@@ -282,6 +314,10 @@ ExecHashJoinImpl(PlanState *pstate, bool parallel)
 												HJ_FILL_INNER(node));
 				node->hj_HashTable = hashtable;
 
+				if (node->hj_RuntimeFilter)
+					ExecHashTableBeginRuntimeFilter(hashtable,
+													node->hj_RuntimeFilter);
+
 				/*
 				 * Execute the Hash node, to build the hash table.  If using
 				 * Parallel Hash, then we'll try to help hashing unless we
@@ -290,6 +326,14 @@ ExecHashJoinImpl(PlanState *pstate, bool parallel)
 				hashNode->hashtable = hashtable;
 				(void) MultiExecProcNode((PlanState *) hashNode);
 
+				/*
+				 * Now that the runtime filter covers all of the inner
+				 * relation, the outer scan can start using it.
+				 */
+				if (hashtable->runtimefilter)
+					hashtable->runtimefilter->scan->ss_RuntimeFilter =
+						hashtable->runtimefilter;
+
 				/*
 				 * If the inner relation is completely empty, and we're not
 				 * doing a left outer join, we can quit without scanning the
@@ -347,13 +391,9 @@ ExecHashJoinImpl(PlanState *pstate, bool parallel)
 				/*
 				 * We don't have an outer tuple, try to get the next one
 				 */
-				if (parallel)
-					outerTupleSlot =
-						ExecParallelHashJoinOuterGetTuple(outerNode, node,
-														  &hashvalue);
-				else
-					outerTupleSlot =
-						ExecHashJoinOuterGetTuple(outerNode, node, &hashvalue);
+				outerTupleSlot = ExecHashJoinNextOuterTuple(outerNode, node,
+															&hashvalue,
+															parallel);
 
 				if (TupIsNull(outerTupleSlot))
 				{
@@ -676,6 +716,28 @@ ExecInitHashJoin(HashJoin *node, EState *estate, int eflags)
 	hjstate->hj_OuterTupleSlot = ExecInitExtraTupleSlot(estate, outerDesc,
 														ops);
 
+	/*
+	 * Slots to read outer tuples ahead into; see ExecHashJoinNextOuterTuple.
+	 * Our expressions were compiled for the kind of slot the outer plan
+	 * returns, so these have to be of the same kind as hj_OuterTupleSlot.
+	 *
+	 * Don't read ahead if the outer plan computes volatile functions, so that
+	 * they're not run for rows we might never ask for.
+	 */
+	if (hash_join_prefetch &&
+		!contain_volatile_functions((Node *) outerNode->targetlist))
+	{
+		int			i;
+
+		hjstate->hj_ProbeSlots = (TupleTableSlot **)
+			palloc(HJ_PREFETCH_GROUP_SIZE * sizeof(TupleTableSlot *));
+		for (i = 0; i < HJ_PREFETCH_GROUP_SIZE; i++)
+			hjstate->hj_ProbeSlots[i] =
+				ExecInitExtraTupleSlot(estate, outerDesc, ops);
+		hjstate->hj_ProbeHashValues = (uint32 *)
+			palloc(HJ_PREFETCH_GROUP_SIZE * sizeof(uint32));
+	}
+
 	/*
 	 * detect whether we need only consider the first matching inner tuple
 	 */
@@ -747,14 +809,136 @@ ExecInitHashJoin(HashJoin *node, EState *estate, int eflags)
 												 (PlanState *) hjstate);
 	hjstate->hj_HashOperators = node->hashoperators;
 	hjstate->hj_Collations = node->hashcollations;
+	hjstate->hj_RuntimeFilter = ExecHashJoinInitRuntimeFilter(hjstate);
 
 	hjstate->hj_JoinState = HJ_BUILD_HASHTABLE;
 	hjstate->hj_MatchedOuter = false;
 	hjstate->hj_OuterNotEmpty = false;
+	hjstate->hj_ProbeCount = 0;
+	hjstate->hj_ProbeNext = 0;
+	hjstate->hj_ProbeGroupSize = HJ_PREFETCH_INITIAL_GROUP_SIZE;
+	hjstate->hj_ProbeExhausted = false;
 
 	return hjstate;
 }
 
+/*
+ * ExecHashJoinInitRuntimeFilter
+ *
+ *		Set up a runtime filter for the scan on our outer side, if it is a
+ *		heap scan and all the outer hash keys are columns it fetches.  See
+ *		executor/hashjoin.h.
+ */
+static RuntimeFilter
+ExecHashJoinInitRuntimeFilter(HashJoinState *hjstate)
+{
+	HashJoin   *node = (HashJoin *) hjstate->js.ps.plan;
+	Plan	   *outerNode = outerPlan(node);
+	Hash	   *hashNode = (Hash *) innerPlan(node);
+	PlanState  *outerState = outerPlanState(hjstate);
+	RuntimeFilter filter;
+	double		nelems;
+	ListCell   *lc1,
+			   *lc2,
+			   *lc3;
+	int			i;
+
+	if (!runtime_join_filter)
+		return NULL;
+
+	/* the join must drop outer rows without a match */
+	if (node->join.jointype != JOIN_INNER &&
+		node->join.jointype != JOIN_SEMI &&
+		node->join.jointype != JOIN_RIGHT)
+		return NULL;
+
+	if (!IsA(outerState, SeqScanState) &&
+		!IsA(outerState, BitmapHeapScanState))
+		return NULL;
+
+	filter = (RuntimeFilter) palloc0(sizeof(RuntimeFilterData));
+	filter->scan = (ScanState *) outerState;
+	filter->nkeys = list_length(node->hashkeys);
+	filter->keys = (RuntimeFilterKey *)
+		palloc0(filter->nkeys * sizeof(RuntimeFilterKey));
+
+	i = 0;
+	forthree(lc1, node->hashkeys,
+			 lc2, node->hashoperators,
+			 lc3, node->hashcollations)
+	{
+		RuntimeFilterKey *key = &filter->keys[i++];
+		Expr	   *expr = (Expr *) lfirst(lc1);
+		Oid			hashop = lfirst_oid(lc2);
+		TargetEntry *tle;
+		Var		   *var;
+		Oid			left_hashfn;
+		Oid			right_hashfn;
+		Oid			lefttype;
+		Oid			righttype;
+		List	   *opfamilies;
+
+		/*
+		 * The key must be a plain column of the outer scan's relation, which
+		 * it passes up unchanged.
+		 */
+		while (IsA(expr, RelabelType))
+			expr = ((RelabelType *) expr)->arg;
+		if (!IsA(expr, Var) || ((Var *) expr)->varno != OUTER_VAR)
+			return NULL;
+		tle = get_tle_by_resno(outerNode->targetlist,
+							   ((Var *) expr)->varattno);
+		if (tle == NULL)
+			return NULL;
+		expr = tle->expr;
+		while (IsA(expr, RelabelType))
+			expr = ((RelabelType *) expr)->arg;
+		if (!IsA(expr, Var))
+			return NULL;
+		var = (Var *) expr;
+		if (var->varno != ((Scan *) outerNode)->scanrelid ||
+			var->varattno <= 0 || var->varlevelsup != 0)
+			return NULL;
+		key->attno = var->varattno;
+
+		if (!get_op_hash_functions(hashop, &left_hashfn, &right_hashfn))
+			elog(ERROR, "could not find hash function for hash operator %u",
+				 hashop);
+		fmgr_info(left_hashfn, &key->hashfn);
+		key->collation = lfirst_oid(lc3);
+		key->strict = op_strict(hashop);
+
+		/*
+		 * Track the range of the inner values if the operator is the
+		 * equality of a btree opfamily, and copying the values around is
+		 * cheap.  Cross-type operators would need two comparison functions,
+		 * so we don't bother with them.
+		 */
+		op_input_types(hashop, &lefttype, &righttype);
+		opfamilies = get_mergejoin_opfamilies(hashop);
+		if (key->strict && lefttype == righttype &&
+			get_typbyval(lefttype) && opfamilies != NIL)
+		{
+			Oid			cmpproc;
+
+			cmpproc = get_opfamily_proc(linitial_oid(opfamilies),
+										lefttype, lefttype, BTORDER_PROC);
+			if (OidIsValid(cmpproc))
+			{
+				fmgr_info(cmpproc, &key->cmpfn);
+				key->hasrange = true;
+			}
+		}
+	}
+
+	/* as in ExecHashTableCreate */
+	nelems = hashNode->plan.parallel_aware ?
+		hashNode->rows_total : outerPlan(hashNode)->plan_rows;
+	filter->nelems = (int64) Max(nelems, 1.0);
+
+	return filter;
+}
+
 /* ----------------------------------------------------------------
  *		ExecEndHashJoin
  *
@@ -792,6 +976,91 @@ ExecEndHashJoin(HashJoinState *node)
 	ExecEndNode(innerPlanState(node));
 }
 
+/*
+ * ExecHashJoinNextOuterTuple
+ *
+ *		get the next outer tuple to probe the hash table with
+ *
+ * This returns what ExecHashJoinOuterGetTuple or
+ * ExecParallelHashJoinOuterGetTuple would, but if the hash table is large,
+ * it reads a group of outer tuples ahead and prefetches the buckets they
+ * will probe (see ExecHashPrefetchBuckets) before returning the first of
+ * them.  The outer plan may reuse its slot for the next tuple, so the tuples
+ * read ahead are copied into hj_ProbeSlots.  The groups grow from
+ * HJ_PREFETCH_INITIAL_GROUP_SIZE to HJ_PREFETCH_GROUP_SIZE tuples.
+ *
+ * The group is always used up before the end of the batch is reported, so
+ * there's nothing to discard when we switch to another batch.
+ */
+static pg_attribute_always_inline TupleTableSlot *
+ExecHashJoinNextOuterTuple(PlanState *outerNode,
+						   HashJoinState *hjstate,
+						   uint32 *hashvalue,
+						   bool parallel)
+{
+	HashJoinTable hashtable = hjstate->hj_HashTable;
+	TupleTableSlot *slot;
+	int			n;
+
+	if (hjstate->hj_ProbeNext < hjstate->hj_ProbeCount)
+	{
+		n = hjstate->hj_ProbeNext++;
+		*hashvalue = hjstate->hj_ProbeHashValues[n];
+		return hjstate->hj_ProbeSlots[n];
+	}
+
+	if (hjstate->hj_ProbeExhausted)
+	{
+		/* we read ahead up to the end of the batch */
+		hjstate->hj_ProbeCount = hjstate->hj_ProbeNext = 0;
+		hjstate->hj_ProbeGroupSize = HJ_PREFETCH_INITIAL_GROUP_SIZE;
+		hjstate->hj_ProbeExhausted = false;
+		return NULL;
+	}
+
+	if (hjstate->hj_ProbeSlots == NULL ||
+		hashtable->nbuckets < HJ_PREFETCH_MIN_BUCKETS)
+	{
+		if (parallel)
+			return ExecParallelHashJoinOuterGetTuple(outerNode, hjstate,
+													 hashvalue);
+		else
+			return ExecHashJoinOuterGetTuple(outerNode, hjstate, hashvalue);
+	}
+
+	for (n = 0; n < hjstate->hj_ProbeGroupSize; n++)
+	{
+		uint32	   *hv = &hjstate->hj_ProbeHashValues[n];
+
+		if (parallel)
+			slot = ExecParallelHashJoinOuterGetTuple(outerNode, hjstate, hv);
+		else
+			slot = ExecHashJoinOuterGetTuple(outerNode, hjstate, hv);
+		if (TupIsNull(slot))
+		{
+			hjstate->hj_ProbeExhausted = (n > 0);
+			break;
+		}
+		ExecCopySlot(hjstate->hj_ProbeSlots[n], slot);
+	}
+
+	hjstate->hj_ProbeCount = n;
+	hjstate->hj_ProbeNext = 0;
+	if (n == 0)
+	{
+		hjstate->hj_ProbeGroupSize = HJ_PREFETCH_INITIAL_GROUP_SIZE;
+		return NULL;
+	}
+	hjstate->hj_ProbeGroupSize = Min(hjstate->hj_ProbeGroupSize * 2,
+									 HJ_PREFETCH_GROUP_SIZE);
+
+	ExecHashPrefetchBuckets(hashtable, hjstate->hj_ProbeHashValues, n);
+
+	hjstate->hj_ProbeNext = 1;
+	*hashvalue = hjstate->hj_ProbeHashValues[0];
+	return hjstate->hj_ProbeSlots[0];
+}
+
 /*
  * ExecHashJoinOuterGetTuple
  *
@@ -1350,6 +1619,10 @@ ExecReScanHashJoin(HashJoinState *node)
 			/* for safety, be sure to clear child plan node's pointer too */
 			hashNode->hashtable = NULL;
 
+			/* the outer scan mustn't use the old table's runtime filter */
+			if (node->hj_RuntimeFilter)
+				node->hj_RuntimeFilter->scan->ss_RuntimeFilter = NULL;
+
 			ExecHashTableDestroy(node->hj_HashTable);
 			node->hj_HashTable = NULL;
 			node->hj_JoinState = HJ_BUILD_HASHTABLE;
@@ -1372,6 +1645,12 @@ ExecReScanHashJoin(HashJoinState *node)
 	node->hj_MatchedOuter = false;
 	node->hj_FirstOuterTupleSlot = NULL;
 
+	/* Forget any outer tuples we read ahead */
+	node->hj_ProbeCount = 0;
+	node->hj_ProbeNext = 0;
+	node->hj_ProbeGroupSize = HJ_PREFETCH_INITIAL_GROUP_SIZE;
+	node->hj_ProbeExhausted = false;
+
 	/*
 	 * if chgParam of subnode is not null then plan will be re-scanned by
 	 * first ExecProcNode.
@@ -1486,6 +1765,7 @@ ExecHashJoinInitializeDSM(HashJoinState *state, ParallelContext *pcxt)
 	pg_atomic_init_u32(&pstate->distributor, 0);
 	pstate->nparticipants = pcxt->nworkers + 1;
 	pstate->total_tuples = 0;
+	pstate->runtime_filter = InvalidDsaPointer;
 	LWLockInitialize(&pstate->lock,
 					 LWTRANCHE_PARALLEL_HASH_JOIN);
 	BarrierInit(&pstate->build_barrier, 0);
@@ -33,6 +33,10 @@
  *		controlled plan at all.  If it's true, we run the controlled
  *		plan normally and pass back the results.
  *
+ *		A Result node over a plan returning batches of rows (see
+ *		ExecGetBatch) passes them on unchanged to a parent that
+ *		consumes batches, as long as it has no per-row qual.
+ *
  *
  * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
  * Portions Copyright (c) 1994, Regents of the University of California
@@ -139,6 +143,51 @@ ExecResult(PlanState *pstate)
 	return NULL;
 }
 
+/* ----------------------------------------------------------------
+ *		ExecResultGetBatch(node)
+ *
+ *		Return the next batch of the outer plan, or NULL at the end
+ *		or if the constant qual isn't satisfied.  This is for a parent
+ *		that consumes whole batches (see ExecGetBatch).  We have no
+ *		per-row qual then, and the parent finds our output columns in
+ *		the batch itself, so our projection isn't applied.
+ * ----------------------------------------------------------------
+ */
+TupleBatch *
+ExecResultGetBatch(ResultState *node)
+{
+	Instrumentation *instr = node->ps.instrument;
+	TupleBatch *batch = NULL;
+
+	Assert(node->ps.qual == NULL && outerPlanState(node) != NULL);
+
+	CHECK_FOR_INTERRUPTS();
+
+	/* do what ExecProcNode would */
+	if (node->ps.chgParam != NULL)
+		ExecReScan((PlanState *) node);
+	if (instr)
+		InstrStartNode(instr);
+
+	if (node->rs_checkqual)
+	{
+		bool		qualResult = ExecQual(node->resconstantqual,
+										  node->ps.ps_ExprContext);
+
+		node->rs_checkqual = false;
+		if (!qualResult)
+			node->rs_done = true;
+	}
+
+	if (!node->rs_done)
+		batch = ExecGetBatch(outerPlanState(node));
+
+	if (instr)
+		InstrStopNode(instr, batch != NULL ? batch->nselected : 0);
+
+	return batch;
+}
+
 /* ----------------------------------------------------------------
  *		ExecResultMarkPos
  * ----------------------------------------------------------------
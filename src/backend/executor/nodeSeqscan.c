@@ -15,6 +15,9 @@
 /*
  * INTERFACE ROUTINES
  *		ExecSeqScan				sequentially scans a relation.
+ *		ExecSeqScanBatch		sequentially scans a relation in batch mode.
+ *		ExecSeqScanGetBatch		returns the next batch of a scan in batch mode.
+ *		ExecSeqScanLimitBatchAttrs	limits the attributes batches hold.
  *		ExecSeqNext				retrieve next tuple in sequential order.
  *		ExecInitSeqScan			creates and initializes a seqscan node.
  *		ExecEndSeqScan			releases any storage allocated.
@@ -29,11 +32,17 @@
 
 #include "access/relscan.h"
 #include "access/tableam.h"
+#include "executor/execBatch.h"
 #include "executor/execdebug.h"
+#include "executor/instrument.h"
+#include "executor/nodeHash.h"
 #include "executor/nodeSeqscan.h"
+#include "miscadmin.h"
 #include "utils/rel.h"
 
 static TupleTableSlot *SeqNext(SeqScanState *node);
+static bool SeqNextBatch(SeqScanState *node);
+static void SeqResetBatch(SeqScanState *node);
 
 /* ----------------------------------------------------------------
  *						Scan Support
@@ -82,6 +91,73 @@ SeqNext(SeqScanState *node)
 	return NULL;
 }
 
+/* ----------------------------------------------------------------
+ *		SeqNextBatch
+ *
+ *		Fetch the next batch of rows from the table and evaluate the
+ *		batch part of the qual over it.  Returns false at end of scan.
+ * ----------------------------------------------------------------
+ */
+static bool
+SeqNextBatch(SeqScanState *node)
+{
+	TableScanDesc scandesc = node->ss.ss_currentScanDesc;
+	EState	   *estate = node->ss.ps.state;
+	TupleBatch *batch = node->batch;
+	TupleTableSlot *slot = node->batchslot;
+
+	ExecResetTupleBatch(batch);
+
+	if (scandesc == NULL)
+	{
+		/* see SeqNext */
+		scandesc = table_beginscan(node->ss.ss_currentRelation,
+								   estate->es_snapshot,
+								   0, NULL);
+		node->ss.ss_currentScanDesc = scandesc;
+	}
+
+	/* first the row that didn't fit into the previous batch, if any */
+	if (node->batchpending)
+	{
+		if (!ExecTupleBatchAddRow(batch, slot))
+			elog(ERROR, "could not add row to empty batch");
+		node->batchpending = false;
+	}
+
+	while (!node->batchdone && batch->nrows < batch->maxrows)
+	{
+		if (!table_scan_getnextslot(scandesc, estate->es_direction, slot))
+		{
+			node->batchdone = true;
+			break;
+		}
+		if (!ExecTupleBatchAddRow(batch, slot))
+		{
+			node->batchpending = true;
+			break;
+		}
+	}
+
+	if (batch->nrows == 0)
+		return false;
+
+	ExecBatchQualEval(node->batchqual, batch);
+	return true;
+}
+
+/*
+ * SeqResetBatch -- forget any rows fetched ahead in batch mode
+ */
+static void
+SeqResetBatch(SeqScanState *node)
+{
+	ExecResetTupleBatch(node->batch);
+	ExecClearTuple(node->batchslot);
+	node->batchpending = false;
+	node->batchdone = false;
+}
+
 /*
  * SeqRecheck -- access method routine to recheck a tuple in EvalPlanQual
  */
@@ -114,6 +190,141 @@ ExecSeqScan(PlanState *pstate)
 					(ExecScanRecheckMtd) SeqRecheck);
 }
 
+/* ----------------------------------------------------------------
+ *		ExecSeqScanBatch(node)
+ *
+ *		Like ExecSeqScan, but for a scan in batch mode: the rows are
+ *		fetched a batch at a time and pre-filtered by the batch qual,
+ *		and the rows that pass are returned one by one after checking
+ *		the rest of the qual and projecting them, as ExecScan would.
+ * ----------------------------------------------------------------
+ */
+static TupleTableSlot *
+ExecSeqScanBatch(PlanState *pstate)
+{
+	SeqScanState *node = castNode(SeqScanState, pstate);
+	TupleBatch *batch = node->batch;
+	ExprContext *econtext = node->ss.ps.ps_ExprContext;
+	ExprState  *qual = node->ss.ps.qual;
+	ProjectionInfo *projInfo = node->ss.ps.ps_ProjInfo;
+	TupleTableSlot *slot = node->ss.ss_ScanTupleSlot;
+
+	/*
+	 * Reset per-tuple memory context to free any expression evaluation
+	 * storage allocated in the previous tuple cycle.
+	 */
+	ResetExprContext(econtext);
+
+	for (;;)
+	{
+		int			row;
+
+		CHECK_FOR_INTERRUPTS();
+
+		if (batch->next >= batch->nselected)
+		{
+			/* the rows after the last one returned were filtered out */
+			InstrCountFiltered1(node, batch->nrows - batch->lastrow - 1);
+
+			if (!SeqNextBatch(node))
+			{
+				if (projInfo)
+					return ExecClearTuple(projInfo->pi_state.resultslot);
+				else
+					return ExecClearTuple(slot);
+			}
+			continue;
+		}
+
+		row = batch->sel[batch->next++];
+		InstrCountFiltered1(node, row - batch->lastrow - 1);
+		batch->lastrow = row;
+
+		ExecStoreBatchRow(batch, row, slot);
+
+		if (node->ss.ss_RuntimeFilter &&
+			!ExecRuntimeFilterTest(node->ss.ss_RuntimeFilter, slot, econtext))
+		{
+			InstrCountFiltered3(node, 1);
+			ResetExprContext(econtext);
+			continue;
+		}
+
+		econtext->ecxt_scantuple = slot;
+
+		if (qual == NULL || ExecQual(qual, econtext))
+		{
+			if (projInfo)
+				return ExecProject(projInfo);
+			return slot;
+		}
+		else
+			InstrCountFiltered1(node, 1);
+
+		ResetExprContext(econtext);
+	}
+}
+
+/* ----------------------------------------------------------------
+ *		ExecSeqScanGetBatch(node)
+ *
+ *		Return the next batch of a scan in batch mode, with its
+ *		selection vector listing the rows that pass the qual, or NULL
+ *		at end of scan.  This is for a parent node that consumes whole
+ *		batches instead of calling ExecProcNode, which it may only do
+ *		if all of our qual is evaluated over batches.  The scan's
+ *		projection isn't applied.
+ * ----------------------------------------------------------------
+ */
+TupleBatch *
+ExecSeqScanGetBatch(SeqScanState *node)
+{
+	Instrumentation *instr = node->ss.ps.instrument;
+	TupleBatch *batch = node->batch;
+	bool		found;
+
+	Assert(batch != NULL && node->ss.ps.qual == NULL);
+
+	CHECK_FOR_INTERRUPTS();
+
+	/* do what ExecProcNode would */
+	if (node->ss.ps.chgParam != NULL)
+		ExecReScan((PlanState *) node);
+	if (instr)
+		InstrStartNode(instr);
+
+	found = SeqNextBatch(node);
+	if (found)
+		InstrCountFiltered1(node, batch->nrows - batch->nselected);
+
+	if (instr)
+		InstrStopNode(instr, found ? batch->nselected : 0);
+
+	return found ? batch : NULL;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecSeqScanLimitBatchAttrs(node, natts)
+ *
+ *		Tell a scan whose batches the parent consumes that the parent
+ *		only looks at the first natts attributes, so that we needn't
+ *		deform any more than those and the ones our qual needs.  After
+ *		this, the scan may only be read with ExecSeqScanGetBatch.
+ * ----------------------------------------------------------------
+ */
+void
+ExecSeqScanLimitBatchAttrs(SeqScanState *node, int natts)
+{
+	SeqScan    *plan = (SeqScan *) node->ss.ps.plan;
+	int			qualnatts;
+
+	Assert(node->batch != NULL && node->ss.ps.qual == NULL);
+
+	if (!ExecBatchScanAttrs(NIL, plan->plan.qual, plan->scanrelid,
+							&qualnatts))
+		elog(ERROR, "unexpected qual in batch-mode scan");
+	node->batch->natts = Min(node->batch->natts, Max(natts, qualnatts));
+}
 
 /* ----------------------------------------------------------------
  *		ExecInitSeqScan
@@ -123,6 +334,10 @@ SeqScanState *
 ExecInitSeqScan(SeqScan *node, EState *estate, int eflags)
 {
 	SeqScanState *scanstate;
+	Relation	rel;
+	List	   *qual = node->plan.qual;
+	bool		usebatch = false;
+	int			batchnatts;
 
 	/*
 	 * Once upon a time it was possible to have an outerPlan of a SeqScan, but
@@ -154,10 +369,63 @@ ExecInitSeqScan(SeqScan *node, EState *estate, int eflags)
 							 node->scanrelid,
 							 eflags);
 
-	/* and create slot with the appropriate rowtype */
-	ExecInitScanTupleSlot(estate, &scanstate->ss,
-						  RelationGetDescr(scanstate->ss.ss_currentRelation),
-						  table_slot_callbacks(scanstate->ss.ss_currentRelation));
+	rel = scanstate->ss.ss_currentRelation;
+
+	/*
+	 * Decide whether to run the scan in batch mode.  That's worthwhile only
+	 * if part of the qual can be evaluated over a batch, or if our parent
+	 * can consume batches and none of the qual has to be evaluated per row.
+	 * Batches hold on to the buffers of the rows in them, so we need a table
+	 * AM returning rows in buffers.  We don't use batches for scans that may
+	 * run backwards, or in EvalPlanQual rechecks, which substitute their own
+	 * test tuple.
+	 */
+	if (executor_batch_size > 0 &&
+		!(eflags & EXEC_FLAG_BACKWARD) &&
+		estate->es_epq_active == NULL &&
+		table_slot_callbacks(rel) == &TTSOpsBufferHeapTuple &&
+		ExecBatchScanAttrs(node->plan.targetlist, node->plan.qual,
+						   node->scanrelid, &batchnatts))
+	{
+		scanstate->batchqual = ExecInitBatchQual(node->plan.qual,
+												 node->scanrelid, &qual);
+		usebatch = scanstate->batchqual != NULL ||
+			((eflags & EXEC_FLAG_BATCH) && qual == NIL);
+	}
+
+	if (usebatch)
+	{
+		TupleDesc	tupdesc = RelationGetDescr(rel);
+		TupleTableSlot *slot;
+		int			i;
+
+		/*
+		 * Rows are fetched into batchslot and deformed into the batch, and
+		 * the rows to return are stored one by one in a virtual scan slot,
+		 * whose attributes beyond those in the batch are never looked at.
+		 */
+		scanstate->batch = ExecCreateTupleBatch(executor_batch_size,
+												batchnatts);
+		scanstate->batchslot = ExecInitExtraTupleSlot(estate, tupdesc,
+													  table_slot_callbacks(rel));
+		ExecInitScanTupleSlot(estate, &scanstate->ss, tupdesc,
+							  &TTSOpsVirtual);
+		slot = scanstate->ss.ss_ScanTupleSlot;
+		for (i = batchnatts; i < tupdesc->natts; i++)
+		{
+			slot->tts_values[i] = (Datum) 0;
+			slot->tts_isnull[i] = true;
+		}
+
+		scanstate->ss.ps.ExecProcNode = ExecSeqScanBatch;
+	}
+	else
+	{
+		/* create slot with the appropriate rowtype */
+		ExecInitScanTupleSlot(estate, &scanstate->ss,
+							  RelationGetDescr(rel),
+							  table_slot_callbacks(rel));
+	}
 
 	/*
 	 * Initialize result type and projection.
@@ -169,7 +437,7 @@ ExecInitSeqScan(SeqScan *node, EState *estate, int eflags)
 	 * initialize child expressions
 	 */
 	scanstate->ss.ps.qual =
-		ExecInitQual(node->plan.qual, (PlanState *) scanstate);
+		ExecInitQual(qual, (PlanState *) scanstate);
 
 	return scanstate;
 }
@@ -201,6 +469,8 @@ ExecEndSeqScan(SeqScanState *node)
 	if (node->ss.ps.ps_ResultTupleSlot)
 		ExecClearTuple(node->ss.ps.ps_ResultTupleSlot);
 	ExecClearTuple(node->ss.ss_ScanTupleSlot);
+	if (node->batch)
+		SeqResetBatch(node);
 
 	/*
 	 * close heap scan
@@ -227,6 +497,9 @@ ExecReScanSeqScan(SeqScanState *node)
 
 	scan = node->ss.ss_currentScanDesc;
 
+	if (node->batch)
+		SeqResetBatch(node);
+
 	if (scan != NULL)
 		table_rescan(scan,		/* scan desc */
 					 NULL);		/* new scan keys */
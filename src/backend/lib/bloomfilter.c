@@ -172,6 +172,42 @@ bloom_lacks_element(bloom_filter *filter, unsigned char *elem, size_t len)
 	return false;
 }
 
+/*
+ * Add all elements of another Bloom filter to filter
+ *
+ * Both filters must have been created with the same total_elems,
+ * bloom_work_mem and seed, so that they have the same size and hash
+ * functions.  Afterwards, filter lacks only elements that both lacked.
+ */
+void
+bloom_union(bloom_filter *filter, bloom_filter *other)
+{
+	uint64		bitset_bytes = filter->m / BITS_PER_BYTE;
+	uint64		i;
+
+	if (filter->m != other->m ||
+		filter->k_hash_funcs != other->k_hash_funcs ||
+		filter->seed != other->seed)
+		elog(ERROR, "cannot combine Bloom filters of different shapes");
+
+	for (i = 0; i < bitset_bytes; i++)
+		filter->bitset[i] |= other->bitset[i];
+}
+
+/*
+ * Size of Bloom filter, including its bitset
+ *
+ * A Bloom filter is a single chunk of memory without any pointers, so
+ * callers may copy it elsewhere, such as into shared memory, and use the
+ * copy just like the original.
+ */
+Size
+bloom_size(bloom_filter *filter)
+{
+	return offsetof(bloom_filter, bitset) +
+		sizeof(unsigned char) * filter->m / BITS_PER_BYTE;
+}
+
 /*
  * What proportion of bits are currently set?
  *
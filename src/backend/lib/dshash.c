@@ -17,8 +17,15 @@
  * is only expected to happen a small number of times until a stable size is
  * found, since growth is geometric.
  *
- * Future versions may support iterators and incremental resizing; for now
- * the implementation is minimalist.
+ * A sequential scan locks one partition at a time, and returns all entries
+ * in that partition before moving on to the next.  Since a resize needs all
+ * partition locks, the buckets can't be split while a partition is being
+ * scanned, and as an entry stays in the same partition across resizes, the
+ * scan returns every entry that is present for its whole duration exactly
+ * once.
+ *
+ * Future versions may support incremental resizing; for now the
+ * implementation is minimalist.
  *
  * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
  * Portions Copyright (c) 1994, Regents of the University of California
@@ -574,6 +581,115 @@ dshash_release_lock(dshash_table *hash_table, void *entry)
 	LWLockRelease(PARTITION_LOCK(hash_table, partition_index));
 }
 
+/*
+ * Initialize a sequential scan over the whole hash table.  If 'exclusive' is
+ * true, partitions are locked exclusively, so that the caller can modify the
+ * entries returned, or delete them with dshash_delete_current.
+ *
+ * The scan holds a partition lock between calls to dshash_seq_next, so the
+ * caller must not access the same hash table by other means until the scan
+ * has been ended with dshash_seq_term.
+ */
+void
+dshash_seq_init(dshash_seq_status *status, dshash_table *hash_table,
+				bool exclusive)
+{
+	Assert(hash_table->control->magic == DSHASH_MAGIC);
+	Assert(!hash_table->find_locked);
+
+	status->hash_table = hash_table;
+	status->curpartition = -1;
+	status->curbucket = 0;
+	status->endbucket = 0;
+	status->curitem = NULL;
+	status->pnextitem = InvalidDsaPointer;
+	status->exclusive = exclusive;
+}
+
+/*
+ * Return the next entry of a sequential scan, or NULL at the end.  When the
+ * end is reached, the last partition lock is released, but the caller must
+ * still call dshash_seq_term.
+ */
+void *
+dshash_seq_next(dshash_seq_status *status)
+{
+	dshash_table *hash_table = status->hash_table;
+
+	if (status->curpartition >= DSHASH_NUM_PARTITIONS)
+		return NULL;
+
+	while (!DsaPointerIsValid(status->pnextitem))
+	{
+		/* try the next bucket of the current partition */
+		if (status->curbucket < status->endbucket)
+		{
+			status->pnextitem = hash_table->buckets[status->curbucket++];
+			continue;
+		}
+
+		/* move on to the next partition */
+		if (status->curpartition >= 0)
+			LWLockRelease(PARTITION_LOCK(hash_table, status->curpartition));
+		if (++status->curpartition >= DSHASH_NUM_PARTITIONS)
+		{
+			status->curitem = NULL;
+			return NULL;
+		}
+
+		LWLockAcquire(PARTITION_LOCK(hash_table, status->curpartition),
+					  status->exclusive ? LW_EXCLUSIVE : LW_SHARED);
+		ensure_valid_bucket_pointers(hash_table);
+		status->curbucket =
+			BUCKET_INDEX_FOR_PARTITION(status->curpartition,
+									   hash_table->size_log2);
+		status->endbucket =
+			BUCKET_INDEX_FOR_PARTITION(status->curpartition + 1,
+									   hash_table->size_log2);
+	}
+
+	status->curitem = dsa_get_address(hash_table->area, status->pnextitem);
+
+	/* remember the next item, in case the caller deletes this one */
+	status->pnextitem = status->curitem->next;
+
+	return ENTRY_FROM_ITEM(status->curitem);
+}
+
+/*
+ * End a sequential scan, releasing the partition lock it holds, if any.
+ */
+void
+dshash_seq_term(dshash_seq_status *status)
+{
+	if (status->curpartition >= 0 &&
+		status->curpartition < DSHASH_NUM_PARTITIONS)
+		LWLockRelease(PARTITION_LOCK(status->hash_table,
+									 status->curpartition));
+	status->curpartition = DSHASH_NUM_PARTITIONS;
+	status->curitem = NULL;
+}
+
+/*
+ * Remove the entry last returned by dshash_seq_next.  The scan must have been
+ * started with 'exclusive' set.
+ */
+void
+dshash_delete_current(dshash_seq_status *status)
+{
+	dshash_table *hash_table = status->hash_table;
+
+	Assert(status->exclusive);
+	Assert(status->curitem != NULL);
+	Assert(hash_table->control->magic == DSHASH_MAGIC);
+	Assert(LWLockHeldByMeInMode(PARTITION_LOCK(hash_table,
+											   status->curpartition),
+								LW_EXCLUSIVE));
+
+	delete_item(hash_table, status->curitem);
+	status->curitem = NULL;
+}
+
 /*
  * A compare function that forwards to memcmp.
  */
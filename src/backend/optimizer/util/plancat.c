@@ -441,6 +441,17 @@ get_relation_info(PlannerInfo *root, Oid relationObjectId, bool inhparent,
 
 	rel->statlist = get_relation_statistics(rel, relation);
 
+	rel->amflags = 0;
+
+	/*
+	 * Check if the table AM can do TID range scans; it must provide both of
+	 * the callbacks for that.
+	 */
+	if (relation->rd_tableam &&
+		relation->rd_tableam->scan_set_tidrange != NULL &&
+		relation->rd_tableam->scan_getnextslot_tidrange != NULL)
+		rel->amflags |= AMFLAG_HAS_TID_RANGE;
+
 	/* Grab foreign-table info using the relcache, while we have it */
 	if (relation->rd_rel->relkind == RELKIND_FOREIGN_TABLE)
 	{
@@ -0,0 +1,200 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_numa.c
+ *	  Basic NUMA (non-uniform memory access) support for the backend.
+ *
+ * On Linux, this uses the mbind(), get_mempolicy(), move_pages() and
+ * getcpu() system calls.  Elsewhere, there is always just one node as far as
+ * we are concerned, and placing memory on nodes fails with ENOSYS.
+ *
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/backend/port/pg_numa.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "port/pg_numa.h"
+
+#ifdef USE_NUMA
+
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* Highest node number we can deal with, plus one */
+#define PG_NUMA_MAX_NODES	1024
+
+#define NODEMASK_BITS		(sizeof(unsigned long) * BITS_PER_BYTE)
+#define NODEMASK_WORDS		(PG_NUMA_MAX_NODES / NODEMASK_BITS)
+
+/* Nodes we may allocate memory on, in ascending order; set up on first use */
+static bool numa_initialized = false;
+static int	numa_num_nodes = 0;
+static int	numa_nodes[PG_NUMA_MAX_NODES];
+static unsigned long numa_allowed_mask[NODEMASK_WORDS];
+
+static void
+pg_numa_initialize(void)
+{
+	int			node;
+
+	if (numa_initialized)
+		return;
+
+	memset(numa_allowed_mask, 0, sizeof(numa_allowed_mask));
+	if (syscall(__NR_get_mempolicy, NULL, numa_allowed_mask,
+				PG_NUMA_MAX_NODES, NULL, MPOL_F_MEMS_ALLOWED) == 0)
+	{
+		for (node = 0; node < PG_NUMA_MAX_NODES; node++)
+		{
+			if (numa_allowed_mask[node / NODEMASK_BITS] &
+				(1UL << (node % NODEMASK_BITS)))
+				numa_nodes[numa_num_nodes++] = node;
+		}
+	}
+
+	/* If the kernel doesn't know about NUMA, treat it as a single node */
+	if (numa_num_nodes == 0)
+	{
+		numa_nodes[0] = 0;
+		numa_num_nodes = 1;
+	}
+
+	numa_initialized = true;
+}
+
+static int
+pg_numa_mbind(void *addr, Size size, int mode, unsigned long *mask)
+{
+	/* The kernel ignores the last bit of the mask, hence the + 1 */
+	return syscall(__NR_mbind, addr, (unsigned long) size, mode, mask,
+				   (unsigned long) PG_NUMA_MAX_NODES + 1, MPOL_MF_MOVE);
+}
+
+#endif							/* USE_NUMA */
+
+/*
+ * Number of nodes this process may allocate memory on.
+ */
+int
+pg_numa_num_nodes(void)
+{
+#ifdef USE_NUMA
+	pg_numa_initialize();
+	return numa_num_nodes;
+#else
+	return 1;
+#endif
+}
+
+/*
+ * The operating system's number for the given node.
+ */
+int
+pg_numa_node_id(int node)
+{
+#ifdef USE_NUMA
+	pg_numa_initialize();
+	Assert(node >= 0 && node < numa_num_nodes);
+	return numa_nodes[node];
+#else
+	Assert(node == 0);
+	return 0;
+#endif
+}
+
+/*
+ * The node of the CPU we are currently running on, or -1 if not known.
+ *
+ * The result can be out of date as soon as it's returned, since the
+ * operating system may move the process to another CPU at any time.
+ */
+int
+pg_numa_current_node(void)
+{
+#ifdef USE_NUMA
+	unsigned	cpu;
+	unsigned	node_id;
+	int			node;
+
+	pg_numa_initialize();
+
+	if (syscall(__NR_getcpu, &cpu, &node_id, NULL) != 0)
+		return -1;
+
+	for (node = 0; node < numa_num_nodes; node++)
+	{
+		if (numa_nodes[node] == node_id)
+			return node;
+	}
+	return -1;
+#else
+	return 0;
+#endif
+}
+
+/*
+ * Spread the pages of the given memory range round-robin over all nodes.
+ *
+ * Pages that are already present are moved, if they are not shared with
+ * other processes yet.
+ */
+int
+pg_numa_interleave(void *addr, Size size)
+{
+#ifdef USE_NUMA
+	pg_numa_initialize();
+	return pg_numa_mbind(addr, size, MPOL_INTERLEAVE, numa_allowed_mask);
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+/*
+ * Allocate the pages of the given memory range on the given node, if it has
+ * free memory.  Otherwise they are allocated elsewhere.
+ *
+ * Pages that are already present are moved, if they are not shared with
+ * other processes yet.
+ */
+int
+pg_numa_prefer(void *addr, Size size, int node)
+{
+#ifdef USE_NUMA
+	unsigned long mask[NODEMASK_WORDS];
+	int			node_id = pg_numa_node_id(node);
+
+	memset(mask, 0, sizeof(mask));
+	mask[node_id / NODEMASK_BITS] |= 1UL << (node_id % NODEMASK_BITS);
+
+	return pg_numa_mbind(addr, size, MPOL_PREFERRED, mask);
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+/*
+ * Find out where the given pages of memory are.
+ *
+ * On success, status[i] is set to the operating system's number of the node
+ * that holds pages[i], or to a negative errno value if that couldn't be
+ * determined, notably -ENOENT if the page has not been touched yet.
+ */
+int
+pg_numa_query_pages(int count, void **pages, int *status)
+{
+#ifdef USE_NUMA
+	return syscall(__NR_move_pages, 0, (unsigned long) count, pages, NULL,
+				   status, 0) < 0 ? -1 : 0;
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
@@ -95,6 +95,7 @@ typedef enum
 
 unsigned long UsedShmemSegID = 0;
 void	   *UsedShmemSegAddr = NULL;
+Size		UsedShmemPageSize = 0;
 
 static Size AnonymousShmemSize;
 static void *AnonymousShmem = NULL;
@@ -556,6 +557,8 @@ CreateAnonymousSegment(Size *size)
 		if (huge_pages == HUGE_PAGES_TRY && ptr == MAP_FAILED)
 			elog(DEBUG1, "mmap(%zu) with MAP_HUGETLB failed, huge pages disabled: %m",
 				 allocsize);
+		if (ptr != MAP_FAILED)
+			UsedShmemPageSize = hugepagesize;
 	}
 #endif
 
@@ -569,6 +572,7 @@ CreateAnonymousSegment(Size *size)
 		ptr = mmap(NULL, allocsize, PROT_READ | PROT_WRITE,
 				   PG_MMAP_FLAGS, -1, 0);
 		mmap_errno = errno;
+		UsedShmemPageSize = sysconf(_SC_PAGESIZE);
 	}
 
 	if (ptr == MAP_FAILED)
@@ -663,7 +667,10 @@ PGSharedMemoryCreate(Size size,
 		sysvsize = sizeof(PGShmemHeader);
 	}
 	else
+	{
 		sysvsize = size;
+		UsedShmemPageSize = sysconf(_SC_PAGESIZE);
+	}
 
 	/*
 	 * Loop till we find a free IPC key.  Trust CreateDataDirLockFile() to
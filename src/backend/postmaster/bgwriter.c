@@ -215,6 +215,12 @@ BackgroundWriterMain(void)
 	 */
 	prev_hibernate = false;
 
+	/*
+	 * Advertise our latch that backends can use to wake us up when they need
+	 * another WAL segment prepared.
+	 */
+	ProcGlobal->bgwriterLatch = &MyProc->procLatch;
+
 	/*
 	 * Loop forever
 	 */
@@ -291,6 +297,15 @@ BackgroundWriterMain(void)
 			}
 		}
 
+		/*
+		 * Make sure the next WAL segments exist, so that backends don't have
+		 * to create and fill them when they move on to a new segment.  This
+		 * is done here rather than in the walwriter so that it doesn't delay
+		 * flushing asynchronous commits.
+		 */
+		if (XLogPreallocSegments())
+			can_hibernate = false;
+
 		/*
 		 * Sleep until we are signaled or BgWriterDelay has elapsed.
 		 *
@@ -486,7 +486,7 @@ CheckpointerMain(void)
 		CheckArchiveTimeout();
 
 		/*
-		 * Send off activity statistics to the stats collector.  (The reason
+		 * Send off activity statistics to shared memory.  (The reason
 		 * why we re-use bgwriter-related code for this is that the bgwriter
 		 * and checkpointer used to be just one process.  It's probably not
 		 * worth the trouble to split the stats support into two independent
@@ -554,6 +554,9 @@ HandleCheckpointerInterrupts(void)
 		ExitOnAnyError = true;
 		/* Close down the database */
 		ShutdownXLOG(0, 0);
+		/* Save the statistics, including the shutdown checkpoint's */
+		pgstat_send_bgwriter();
+		pgstat_write_statsfile();
 		/* Normal exit from the checkpointer is here */
 		proc_exit(0);		/* done */
 	}
@@ -691,7 +694,7 @@ CheckpointWriteDelay(int flags, double progress)
 		CheckArchiveTimeout();
 
 		/*
-		 * Report interim activity statistics to the stats collector.
+		 * Report interim activity statistics to shared memory.
 		 */
 		pgstat_send_bgwriter();
 
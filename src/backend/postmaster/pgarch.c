@@ -164,9 +164,12 @@ pgarch_start(void)
 			/* Close the postmaster's sockets */
 			ClosePostmasterPorts(false);
 
-			/* Drop our connection to postmaster's shared memory, as well */
+			/*
+			 * Drop our connection to dynamic shared memory.  We stay attached
+			 * to the main shared memory segment, which holds the archiver
+			 * statistics.
+			 */
 			dsm_detach_all();
-			PGSharedMemoryDetach();
 
 			PgArchiverMain(0, NULL);
 			break;
@@ -1,9 +1,15 @@
 /* ----------
  * pgstat.c
  *
- *	All the statistics collector stuff hacked up in one big, ugly file.
+ *	All the cumulative statistics stuff hacked up in one big, ugly file.
  *
- *	TODO:	- Separate collector, postmaster and backend stuff
+ *	The statistics are kept in shared memory.  Each backend accumulates its
+ *	counters locally, and flushes them to shared memory in batches, at most
+ *	every PGSTAT_STAT_INTERVAL milliseconds.  The statistics are written to
+ *	a file when the server shuts down, and read back when it starts up
+ *	again, unless crash recovery is needed.
+ *
+ *	TODO:	- Separate shared-memory and backend stuff
  *			  into different files.
  *
  *			- Add some automatic call for pgstat vacuuming.
@@ -22,15 +28,8 @@
 #include <fcntl.h>
 #include <sys/param.h>
 #include <sys/time.h>
-#include <sys/socket.h>
-#include <netdb.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
 #include <signal.h>
 #include <time.h>
-#ifdef HAVE_SYS_SELECT_H
-#include <sys/select.h>
-#endif
 
 #include "access/heapam.h"
 #include "access/htup_details.h"
@@ -38,18 +37,16 @@
 #include "access/transam.h"
 #include "access/twophase_rmgr.h"
 #include "access/xact.h"
+#include "access/xlogprefetch.h"
 #include "catalog/pg_database.h"
 #include "catalog/pg_proc.h"
-#include "common/ip.h"
+#include "lib/dshash.h"
 #include "libpq/libpq.h"
-#include "libpq/pqsignal.h"
 #include "mb/pg_wchar.h"
 #include "miscadmin.h"
 #include "pg_trace.h"
 #include "pgstat.h"
 #include "postmaster/autovacuum.h"
-#include "postmaster/fork_process.h"
-#include "postmaster/interrupt.h"
 #include "postmaster/postmaster.h"
 #include "replication/walsender.h"
 #include "storage/backendid.h"
@@ -58,13 +55,14 @@
 #include "storage/ipc.h"
 #include "storage/latch.h"
 #include "storage/lmgr.h"
-#include "storage/pg_shmem.h"
 #include "storage/procsignal.h"
+#include "storage/shmem.h"
 #include "storage/sinvaladt.h"
+#include "storage/spin.h"
 #include "utils/ascii.h"
+#include "utils/dsa.h"
 #include "utils/guc.h"
 #include "utils/memutils.h"
-#include "utils/ps_status.h"
 #include "utils/rel.h"
 #include "utils/snapmgr.h"
 #include "utils/timestamp.h"
@@ -73,37 +71,27 @@
  * Timer definitions.
  * ----------
  */
-#define PGSTAT_STAT_INTERVAL	500 /* Minimum time between stats file
-									 * updates; in milliseconds. */
-
-#define PGSTAT_RETRY_DELAY		10	/* How long to wait between checks for a
-									 * new file; in milliseconds. */
-
-#define PGSTAT_MAX_WAIT_TIME	10000	/* Maximum time to wait for a stats
-										 * file update; in milliseconds. */
-
-#define PGSTAT_INQ_INTERVAL		640 /* How often to ping the collector for a
-									 * new file; in milliseconds. */
-
-#define PGSTAT_RESTART_INTERVAL 60	/* How often to attempt to restart a
-									 * failed statistics collector; in
-									 * seconds. */
-
-#define PGSTAT_POLL_LOOP_COUNT	(PGSTAT_MAX_WAIT_TIME / PGSTAT_RETRY_DELAY)
-#define PGSTAT_INQ_LOOP_COUNT	(PGSTAT_INQ_INTERVAL / PGSTAT_RETRY_DELAY)
-
-/* Minimum receive buffer size for the collector's socket. */
-#define PGSTAT_MIN_RCVBUF		(100 * 1024)
+#define PGSTAT_STAT_INTERVAL	500 /* Minimum time between flushes of a
+									 * backend's counters to shared memory;
+									 * in milliseconds. */
 
 
 /* ----------
- * The initial size hints for the hash tables used in the collector.
+ * The initial size hints for the backend-local hash tables.
  * ----------
  */
 #define PGSTAT_DB_HASH_SIZE		16
 #define PGSTAT_TAB_HASH_SIZE	512
 #define PGSTAT_FUNCTION_HASH_SIZE	512
 
+/* ----------
+ * Size of the part of the statistics' DSA area that is allocated in the main
+ * shared memory segment.  The area is extended with dynamic shared memory
+ * segments if that isn't enough.
+ * ----------
+ */
+#define PGSTAT_DSA_INITIAL_SIZE	(256 * 1024)
+
 
 /* ----------
  * Total number of backends including auxiliary
@@ -126,14 +114,6 @@ bool		pgstat_track_counts = false;
 int			pgstat_track_functions = TRACK_FUNC_OFF;
 int			pgstat_track_activity_query_size = 1024;
 
-/* ----------
- * Built from GUC parameter
- * ----------
- */
-char	   *pgstat_stat_directory = NULL;
-char	   *pgstat_stat_filename = NULL;
-char	   *pgstat_stat_tmpname = NULL;
-
 /*
  * BgWriter global statistics counters (unused in other processes).
  * Stored directly in a stats message structure so it can be sent
@@ -161,21 +141,125 @@ static char *slru_names[] = {"async", "clog", "commit_timestamp",
 /* entries in the same order as slru_names */
 PgStat_MsgSLRU SLRUStats[SLRU_NUM_ELEMENTS];
 
+/*
+ * Shared buffer I/O done by this process that hasn't been sent yet, and
+ * whether there is any.
+ */
+static PgStat_IOCounts PendingIOStats;
+static bool have_io_stats = false;
+
+/* Group WAL flushes led by this process that haven't been sent yet */
+static PgStat_WalFlushCounts PendingWalFlushStats;
+static bool have_wal_flush_stats = false;
+
+/* IOContext names, indexed by IOContext */
+static const char *const io_context_names[] = {
+	"normal",
+	"bulkread",
+	"bulkwrite",
+	"vacuum"
+};
+
+StaticAssertDecl(lengthof(io_context_names) == IOCONTEXT_NUM_TYPES,
+				 "io_context_names array size mismatch");
+
 /* ----------
- * Local data
+ * Shared-memory statistics
+ *
+ * The statistics for databases, tables and functions are kept in dshash
+ * tables, in a DSA area that starts out in the main shared memory segment,
+ * right after StatsShmemStruct.  Tables and functions are keyed by database
+ * OID and object OID, so that each lives in a single hash table for the
+ * whole cluster.
+ *
+ * Entries are locked by the hash tables' partition locks.  A process never
+ * holds an entry lock of more than one of the hash tables at a time.
+ *
+ * The cluster-wide statistics are small enough to be kept in
+ * StatsShmemStruct directly, protected by a spinlock.  The archiver doesn't
+ * have a PGPROC and so can't take LWLocks; it only ever updates these.
  * ----------
  */
-NON_EXEC_STATIC pgsocket pgStatSock = PGINVALID_SOCKET;
 
-static struct sockaddr_storage pgStatAddr;
+/* "typedef struct StatsShmemStruct StatsShmemStruct" appears in pgstat.h */
+struct StatsShmemStruct
+{
+	dshash_table_handle db_hash_handle;
+	dshash_table_handle tab_hash_handle;
+	dshash_table_handle func_hash_handle;
+
+	slock_t		mutex;			/* protects the fields below */
+	PgStat_GlobalStats global_stats;
+	PgStat_ArchiverStats archiver_stats;
+	PgStat_SLRUStats slru_stats[SLRU_NUM_ELEMENTS];
+	PgStat_IOStats io_stats;
+	PgStat_WalFlushStats wal_flush_stats;
+};
+
+#define StatsShmemDSAArea() \
+	((void *) ((char *) StatsShmem + MAXALIGN(sizeof(StatsShmemStruct))))
+
+/* Key of the shared table and function hash tables */
+typedef struct PgStat_StatObjKey
+{
+	Oid			databaseid;
+	Oid			objectid;
+} PgStat_StatObjKey;
+
+typedef struct PgStat_SharedTabEntry
+{
+	PgStat_StatObjKey key;
+	PgStat_StatTabEntry stats;
+} PgStat_SharedTabEntry;
+
+typedef struct PgStat_SharedFuncEntry
+{
+	PgStat_StatObjKey key;
+	PgStat_StatFuncEntry stats;
+} PgStat_SharedFuncEntry;
+
+static const dshash_parameters db_hash_params = {
+	sizeof(Oid),
+	sizeof(PgStat_StatDBEntry),
+	dshash_memcmp,
+	dshash_memhash,
+	LWTRANCHE_STATS_HASH
+};
+
+static const dshash_parameters tab_hash_params = {
+	sizeof(PgStat_StatObjKey),
+	sizeof(PgStat_SharedTabEntry),
+	dshash_memcmp,
+	dshash_memhash,
+	LWTRANCHE_STATS_HASH
+};
 
-static time_t last_pgstat_start_time;
+static const dshash_parameters func_hash_params = {
+	sizeof(PgStat_StatObjKey),
+	sizeof(PgStat_SharedFuncEntry),
+	dshash_memcmp,
+	dshash_memhash,
+	LWTRANCHE_STATS_HASH
+};
 
-static bool pgStatRunningInCollector = false;
+NON_EXEC_STATIC StatsShmemStruct *StatsShmem = NULL;
+
+/* This process' attachment to the DSA area and the hash tables */
+static dsa_area *pgStatDSA = NULL;
+static dshash_table *pgStatSharedDBHash = NULL;
+static dshash_table *pgStatSharedTabHash = NULL;
+static dshash_table *pgStatSharedFuncHash = NULL;
+
+/*
+ * Set once pgstat_beshutdown_hook() has run.  Later on_shmem_exit and
+ * on_proc_exit callbacks, such as the one closing temporary files, can no
+ * longer take the hash tables' locks, so whatever they report is dropped.
+ */
+static bool pgstat_shutdown = false;
 
 /*
  * Structures in which backends store per-table info that's waiting to be
- * sent to the collector.
+ * flushed to shared memory.
  *
  * NOTE: once allocated, TabStatusArray structures are never moved or deleted
  * for the life of the backend.  Also, we zero out the t_id fields of the
@@ -210,14 +294,14 @@ typedef struct TabStatHashEntry
 static HTAB *pgStatTabHash = NULL;
 
 /*
- * Backends store per-function info that's waiting to be sent to the collector
- * in this hash table (indexed by function OID).
+ * Backends store per-function info that's waiting to be flushed to shared
+ * memory in this hash table (indexed by function OID).
  */
 static HTAB *pgStatFunctions = NULL;
 
 /*
  * Indicates if backend has some function stats that it hasn't yet
- * sent to the collector.
+ * flushed to shared memory.
  */
 static bool have_function_stats = false;
 
@@ -257,10 +341,36 @@ typedef struct TwoPhasePgStatRecord
 } TwoPhasePgStatRecord;
 
 /*
- * Info about current "snapshot" of stats file
+ * Info about the current "snapshot" of the shared statistics.  Entries are
+ * copied from shared memory the first time they are fetched in a
+ * transaction, so that repeated fetches give consistent results.  Entries
+ * that weren't found are remembered too, with 'found' set to false.
  */
+typedef struct PgStat_SnapshotDBEntry
+{
+	Oid			databaseid;
+	bool		found;
+	PgStat_StatDBEntry stats;
+} PgStat_SnapshotDBEntry;
+
+typedef struct PgStat_SnapshotTabEntry
+{
+	PgStat_StatObjKey key;
+	bool		found;
+	PgStat_StatTabEntry stats;
+} PgStat_SnapshotTabEntry;
+
+typedef struct PgStat_SnapshotFuncEntry
+{
+	PgStat_StatObjKey key;
+	bool		found;
+	PgStat_StatFuncEntry stats;
+} PgStat_SnapshotFuncEntry;
+
 static MemoryContext pgStatLocalContext = NULL;
-static HTAB *pgStatDBHash = NULL;
+static HTAB *pgStatSnapshotDBHash = NULL;
+static HTAB *pgStatSnapshotTabHash = NULL;
+static HTAB *pgStatSnapshotFuncHash = NULL;
 
 /* Status for backends including auxiliary */
 static LocalPgBackendStatus *localBackendStatusTable = NULL;
@@ -269,20 +379,15 @@ static LocalPgBackendStatus *localBackendStatusTable = NULL;
 static int	localNumBackends = 0;
 
 /*
- * Cluster wide statistics, kept in the stats collector.
- * Contains statistics that are not collected per database
- * or per table.
+ * Snapshot of the cluster wide statistics, which are not collected per
+ * database or per table.
  */
+static bool have_global_snapshot = false;
 static PgStat_ArchiverStats archiverStats;
 static PgStat_GlobalStats globalStats;
 static PgStat_SLRUStats slruStats[SLRU_NUM_ELEMENTS];
-
-/*
- * List of OIDs of databases we need to write out.  If an entry is InvalidOid,
- * it means to write only the shared-catalog stats ("DB 0"); otherwise, we
- * will write both that DB's data and the shared stats.
- */
-static List *pending_write_requests = NIL;
+static PgStat_IOStats ioStats;
+static PgStat_WalFlushStats walFlushStats;
 
 /*
  * Total time charged to functions so far in the current backend.
@@ -296,26 +401,16 @@ static instr_time total_func_time;
  * Local function forward declarations
  * ----------
  */
-#ifdef EXEC_BACKEND
-static pid_t pgstat_forkexec(void);
-#endif
-
-NON_EXEC_STATIC void PgstatCollectorMain(int argc, char *argv[]) pg_attribute_noreturn();
+static void pgstat_attach_shmem(void);
 static void pgstat_beshutdown_hook(int code, Datum arg);
 
 static PgStat_StatDBEntry *pgstat_get_db_entry(Oid databaseid, bool create);
-static PgStat_StatTabEntry *pgstat_get_tab_entry(PgStat_StatDBEntry *dbentry,
-												 Oid tableoid, bool create);
-static void pgstat_write_statsfiles(bool permanent, bool allDbs);
-static void pgstat_write_db_statsfile(PgStat_StatDBEntry *dbentry, bool permanent);
-static HTAB *pgstat_read_statsfiles(Oid onlydb, bool permanent, bool deep);
-static void pgstat_read_db_statsfile(Oid databaseid, HTAB *tabhash, HTAB *funchash, bool permanent);
-static void backend_read_statsfile(void);
+static PgStat_SharedTabEntry *pgstat_get_tab_entry(Oid databaseid, Oid tableoid,
+												   bool create);
+static void pgstat_drop_db_objects(Oid databaseid);
+static void pgstat_snapshot_global_stats(void);
 static void pgstat_read_current_status(void);
 
-static bool pgstat_write_statsfile_needed(void);
-static bool pgstat_db_requested(Oid databaseid);
-
 static void pgstat_send_tabstat(PgStat_MsgTabstat *tsmsg);
 static void pgstat_send_funcstats(void);
 static void pgstat_send_slru(void);
@@ -334,7 +429,6 @@ static const char *pgstat_get_wait_io(WaitEventIO w);
 static void pgstat_setheader(PgStat_MsgHdr *hdr, StatMsgType mtype);
 static void pgstat_send(void *msg, int len);
 
-static void pgstat_recv_inquiry(PgStat_MsgInquiry *msg, int len);
 static void pgstat_recv_tabstat(PgStat_MsgTabstat *msg, int len);
 static void pgstat_recv_tabpurge(PgStat_MsgTabpurge *msg, int len);
 static void pgstat_recv_dropdb(PgStat_MsgDropdb *msg, int len);
@@ -348,6 +442,8 @@ static void pgstat_recv_analyze(PgStat_MsgAnalyze *msg, int len);
 static void pgstat_recv_archiver(PgStat_MsgArchiver *msg, int len);
 static void pgstat_recv_bgwriter(PgStat_MsgBgWriter *msg, int len);
 static void pgstat_recv_slru(PgStat_MsgSLRU *msg, int len);
+static void pgstat_recv_io(PgStat_MsgIO *msg, int len);
+static void pgstat_recv_wal_flush(PgStat_MsgWalFlush *msg, int len);
 static void pgstat_recv_funcstat(PgStat_MsgFuncstat *msg, int len);
 static void pgstat_recv_funcpurge(PgStat_MsgFuncpurge *msg, int len);
 static void pgstat_recv_recoveryconflict(PgStat_MsgRecoveryConflict *msg, int len);
@@ -360,471 +456,138 @@ static void pgstat_recv_tempfile(PgStat_MsgTempFile *msg, int len);
  * ------------------------------------------------------------
  */
 
-/* ----------
- * pgstat_init() -
- *
- *	Called from postmaster at startup. Create the resources required
- *	by the statistics collector process.  If unable to do so, do not
- *	fail --- better to let the postmaster start with stats collection
- *	disabled.
- * ----------
+/*
+ * Report shared-memory space needed by StatsShmemInit.
  */
-void
-pgstat_init(void)
+Size
+StatsShmemSize(void)
 {
-	ACCEPT_TYPE_ARG3 alen;
-	struct addrinfo *addrs = NULL,
-			   *addr,
-				hints;
-	int			ret;
-	fd_set		rset;
-	struct timeval tv;
-	char		test_byte;
-	int			sel_res;
-	int			tries = 0;
-
-#define TESTBYTEVAL ((char) 199)
-
-	/*
-	 * This static assertion verifies that we didn't mess up the calculations
-	 * involved in selecting maximum payload sizes for our UDP messages.
-	 * Because the only consequence of overrunning PGSTAT_MAX_MSG_SIZE would
-	 * be silent performance loss from fragmentation, it seems worth having a
-	 * compile-time cross-check that we didn't.
-	 */
-	StaticAssertStmt(sizeof(PgStat_Msg) <= PGSTAT_MAX_MSG_SIZE,
-					 "maximum stats message size exceeds PGSTAT_MAX_MSG_SIZE");
-
-	/*
-	 * Create the UDP socket for sending and receiving statistic messages
-	 */
-	hints.ai_flags = AI_PASSIVE;
-	hints.ai_family = AF_UNSPEC;
-	hints.ai_socktype = SOCK_DGRAM;
-	hints.ai_protocol = 0;
-	hints.ai_addrlen = 0;
-	hints.ai_addr = NULL;
-	hints.ai_canonname = NULL;
-	hints.ai_next = NULL;
-	ret = pg_getaddrinfo_all("localhost", NULL, &hints, &addrs);
-	if (ret || !addrs)
-	{
-		ereport(LOG,
-				(errmsg("could not resolve \"localhost\": %s",
-						gai_strerror(ret))));
-		goto startup_failed;
-	}
-
-	/*
-	 * On some platforms, pg_getaddrinfo_all() may return multiple addresses
-	 * only one of which will actually work (eg, both IPv6 and IPv4 addresses
-	 * when kernel will reject IPv6).  Worse, the failure may occur at the
-	 * bind() or perhaps even connect() stage.  So we must loop through the
-	 * results till we find a working combination. We will generate LOG
-	 * messages, but no error, for bogus combinations.
-	 */
-	for (addr = addrs; addr; addr = addr->ai_next)
-	{
-#ifdef HAVE_UNIX_SOCKETS
-		/* Ignore AF_UNIX sockets, if any are returned. */
-		if (addr->ai_family == AF_UNIX)
-			continue;
-#endif
-
-		if (++tries > 1)
-			ereport(LOG,
-					(errmsg("trying another address for the statistics collector")));
-
-		/*
-		 * Create the socket.
-		 */
-		if ((pgStatSock = socket(addr->ai_family, SOCK_DGRAM, 0)) == PGINVALID_SOCKET)
-		{
-			ereport(LOG,
-					(errcode_for_socket_access(),
-					 errmsg("could not create socket for statistics collector: %m")));
-			continue;
-		}
-
-		/*
-		 * Bind it to a kernel assigned port on localhost and get the assigned
-		 * port via getsockname().
-		 */
-		if (bind(pgStatSock, addr->ai_addr, addr->ai_addrlen) < 0)
-		{
-			ereport(LOG,
-					(errcode_for_socket_access(),
-					 errmsg("could not bind socket for statistics collector: %m")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
-
-		alen = sizeof(pgStatAddr);
-		if (getsockname(pgStatSock, (struct sockaddr *) &pgStatAddr, &alen) < 0)
-		{
-			ereport(LOG,
-					(errcode_for_socket_access(),
-					 errmsg("could not get address of socket for statistics collector: %m")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
-
-		/*
-		 * Connect the socket to its own address.  This saves a few cycles by
-		 * not having to respecify the target address on every send. This also
-		 * provides a kernel-level check that only packets from this same
-		 * address will be received.
-		 */
-		if (connect(pgStatSock, (struct sockaddr *) &pgStatAddr, alen) < 0)
-		{
-			ereport(LOG,
-					(errcode_for_socket_access(),
-					 errmsg("could not connect socket for statistics collector: %m")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
-
-		/*
-		 * Try to send and receive a one-byte test message on the socket. This
-		 * is to catch situations where the socket can be created but will not
-		 * actually pass data (for instance, because kernel packet filtering
-		 * rules prevent it).
-		 */
-		test_byte = TESTBYTEVAL;
-
-retry1:
-		if (send(pgStatSock, &test_byte, 1, 0) != 1)
-		{
-			if (errno == EINTR)
-				goto retry1;	/* if interrupted, just retry */
-			ereport(LOG,
-					(errcode_for_socket_access(),
-					 errmsg("could not send test message on socket for statistics collector: %m")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
-
-		/*
-		 * There could possibly be a little delay before the message can be
-		 * received.  We arbitrarily allow up to half a second before deciding
-		 * it's broken.
-		 */
-		for (;;)				/* need a loop to handle EINTR */
-		{
-			FD_ZERO(&rset);
-			FD_SET(pgStatSock, &rset);
-
-			tv.tv_sec = 0;
-			tv.tv_usec = 500000;
-			sel_res = select(pgStatSock + 1, &rset, NULL, NULL, &tv);
-			if (sel_res >= 0 || errno != EINTR)
-				break;
-		}
-		if (sel_res < 0)
-		{
-			ereport(LOG,
-					(errcode_for_socket_access(),
-					 errmsg("select() failed in statistics collector: %m")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
-		if (sel_res == 0 || !FD_ISSET(pgStatSock, &rset))
-		{
-			/*
-			 * This is the case we actually think is likely, so take pains to
-			 * give a specific message for it.
-			 *
-			 * errno will not be set meaningfully here, so don't use it.
-			 */
-			ereport(LOG,
-					(errcode(ERRCODE_CONNECTION_FAILURE),
-					 errmsg("test message did not get through on socket for statistics collector")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
-
-		test_byte++;			/* just make sure variable is changed */
-
-retry2:
-		if (recv(pgStatSock, &test_byte, 1, 0) != 1)
-		{
-			if (errno == EINTR)
-				goto retry2;	/* if interrupted, just retry */
-			ereport(LOG,
-					(errcode_for_socket_access(),
-					 errmsg("could not receive test message on socket for statistics collector: %m")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
-
-		if (test_byte != TESTBYTEVAL)	/* strictly paranoia ... */
-		{
-			ereport(LOG,
-					(errcode(ERRCODE_INTERNAL_ERROR),
-					 errmsg("incorrect test message transmission on socket for statistics collector")));
-			closesocket(pgStatSock);
-			pgStatSock = PGINVALID_SOCKET;
-			continue;
-		}
-
-		/* If we get here, we have a working socket */
-		break;
-	}
-
-	/* Did we find a working address? */
-	if (!addr || pgStatSock == PGINVALID_SOCKET)
-		goto startup_failed;
-
-	/*
-	 * Set the socket to non-blocking IO.  This ensures that if the collector
-	 * falls behind, statistics messages will be discarded; backends won't
-	 * block waiting to send messages to the collector.
-	 */
-	if (!pg_set_noblock(pgStatSock))
-	{
-		ereport(LOG,
-				(errcode_for_socket_access(),
-				 errmsg("could not set statistics collector socket to nonblocking mode: %m")));
-		goto startup_failed;
-	}
-
-	/*
-	 * Try to ensure that the socket's receive buffer is at least
-	 * PGSTAT_MIN_RCVBUF bytes, so that it won't easily overflow and lose
-	 * data.  Use of UDP protocol means that we are willing to lose data under
-	 * heavy load, but we don't want it to happen just because of ridiculously
-	 * small default buffer sizes (such as 8KB on older Windows versions).
-	 */
-	{
-		int			old_rcvbuf;
-		int			new_rcvbuf;
-		ACCEPT_TYPE_ARG3 rcvbufsize = sizeof(old_rcvbuf);
-
-		if (getsockopt(pgStatSock, SOL_SOCKET, SO_RCVBUF,
-					   (char *) &old_rcvbuf, &rcvbufsize) < 0)
-		{
-			elog(LOG, "getsockopt(SO_RCVBUF) failed: %m");
-			/* if we can't get existing size, always try to set it */
-			old_rcvbuf = 0;
-		}
-
-		new_rcvbuf = PGSTAT_MIN_RCVBUF;
-		if (old_rcvbuf < new_rcvbuf)
-		{
-			if (setsockopt(pgStatSock, SOL_SOCKET, SO_RCVBUF,
-						   (char *) &new_rcvbuf, sizeof(new_rcvbuf)) < 0)
-				elog(LOG, "setsockopt(SO_RCVBUF) failed: %m");
-		}
-	}
-
-	pg_freeaddrinfo_all(hints.ai_family, addrs);
-
-	/* Now that we have a long-lived socket, tell fd.c about it. */
-	ReserveExternalFD();
-
-	return;
-
-startup_failed:
-	ereport(LOG,
-			(errmsg("disabling statistics collector for lack of working socket")));
-
-	if (addrs)
-		pg_freeaddrinfo_all(hints.ai_family, addrs);
-
-	if (pgStatSock != PGINVALID_SOCKET)
-		closesocket(pgStatSock);
-	pgStatSock = PGINVALID_SOCKET;
-
-	/*
-	 * Adjust GUC variables to suppress useless activity, and for debugging
-	 * purposes (seeing track_counts off is a clue that we failed here). We
-	 * use PGC_S_OVERRIDE because there is no point in trying to turn it back
-	 * on from postgresql.conf without a restart.
-	 */
-	SetConfigOption("track_counts", "off", PGC_INTERNAL, PGC_S_OVERRIDE);
+	return add_size(MAXALIGN(sizeof(StatsShmemStruct)),
+					PGSTAT_DSA_INITIAL_SIZE);
 }
 
 /*
- * subroutine for pgstat_reset_all
+ * Initialize the shared statistics, including empty hash tables for
+ * databases, tables and functions.
  */
-static void
-pgstat_reset_remove_files(const char *directory)
+void
+StatsShmemInit(void)
 {
-	DIR		   *dir;
-	struct dirent *entry;
-	char		fname[MAXPGPATH * 2];
+	bool		found;
+
+	StatsShmem = (StatsShmemStruct *)
+		ShmemInitStruct("Shared Statistics", StatsShmemSize(), &found);
 
-	dir = AllocateDir(directory);
-	while ((entry = ReadDir(dir, directory)) != NULL)
+	if (!found)
 	{
-		int			nchars;
-		Oid			tmp_oid;
+		dsa_area   *dsa;
+		dshash_table *dsh;
+		TimestampTz ts = GetCurrentTimestamp();
+		int			i;
 
-		/*
-		 * Skip directory entries that don't match the file names we write.
-		 * See get_dbstat_filename for the database-specific pattern.
-		 */
-		if (strncmp(entry->d_name, "global.", 7) == 0)
-			nchars = 7;
-		else
-		{
-			nchars = 0;
-			(void) sscanf(entry->d_name, "db_%u.%n",
-						  &tmp_oid, &nchars);
-			if (nchars <= 0)
-				continue;
-			/* %u allows leading whitespace, so reject that */
-			if (strchr("0123456789", entry->d_name[3]) == NULL)
-				continue;
-		}
+		MemSet(StatsShmem, 0, sizeof(StatsShmemStruct));
+		SpinLockInit(&StatsShmem->mutex);
 
-		if (strcmp(entry->d_name + nchars, "tmp") != 0 &&
-			strcmp(entry->d_name + nchars, "stat") != 0)
-			continue;
+		StatsShmem->global_stats.stat_reset_timestamp = ts;
+		StatsShmem->archiver_stats.stat_reset_timestamp = ts;
+		for (i = 0; i < SLRU_NUM_ELEMENTS; i++)
+			StatsShmem->slru_stats[i].stat_reset_timestamp = ts;
+		StatsShmem->io_stats.stat_reset_timestamp = ts;
+		StatsShmem->wal_flush_stats.stat_reset_timestamp = ts;
 
-		snprintf(fname, sizeof(fname), "%s/%s", directory,
-				 entry->d_name);
-		unlink(fname);
+		/*
+		 * Create the hash tables in the part of the area that is in the main
+		 * shared memory segment.  The postmaster must not create dynamic
+		 * shared memory segments, so prevent the area from growing until the
+		 * tables have been created.  The area is pinned, so that it survives
+		 * while no process is attached to it.
+		 */
+		dsa = dsa_create_in_place(StatsShmemDSAArea(),
+								  PGSTAT_DSA_INITIAL_SIZE,
+								  LWTRANCHE_STATS_DSA, NULL);
+		dsa_pin(dsa);
+		dsa_set_size_limit(dsa, PGSTAT_DSA_INITIAL_SIZE);
+
+		dsh = dshash_create(dsa, &db_hash_params, NULL);
+		StatsShmem->db_hash_handle = dshash_get_hash_table_handle(dsh);
+		dshash_detach(dsh);
+
+		dsh = dshash_create(dsa, &tab_hash_params, NULL);
+		StatsShmem->tab_hash_handle = dshash_get_hash_table_handle(dsh);
+		dshash_detach(dsh);
+
+		dsh = dshash_create(dsa, &func_hash_params, NULL);
+		StatsShmem->func_hash_handle = dshash_get_hash_table_handle(dsh);
+		dshash_detach(dsh);
+
+		dsa_set_size_limit(dsa, (size_t) -1);
+		dsa_detach(dsa);
 	}
-	FreeDir(dir);
 }
 
 /*
  * pgstat_reset_all() -
  *
- * Remove the stats files.  This is currently used only if WAL
+ * Remove the stats file.  This is currently used only if WAL
  * recovery is needed after a crash.
  */
 void
 pgstat_reset_all(void)
 {
-	pgstat_reset_remove_files(pgstat_stat_directory);
-	pgstat_reset_remove_files(PGSTAT_STAT_PERMANENT_DIRECTORY);
+	if (unlink(PGSTAT_STAT_PERMANENT_FILENAME) < 0 && errno != ENOENT)
+		ereport(LOG,
+				(errcode_for_file_access(),
+				 errmsg("could not remove file \"%s\": %m",
+						PGSTAT_STAT_PERMANENT_FILENAME)));
 }
 
-#ifdef EXEC_BACKEND
-
-/*
- * pgstat_forkexec() -
- *
- * Format up the arglist for, then fork and exec, statistics collector process
+/* ------------------------------------------------------------
+ * Public functions used by backends follow
+ *------------------------------------------------------------
  */
-static pid_t
-pgstat_forkexec(void)
-{
-	char	   *av[10];
-	int			ac = 0;
-
-	av[ac++] = "postgres";
-	av[ac++] = "--forkcol";
-	av[ac++] = NULL;			/* filled in by postmaster_forkexec */
-
-	av[ac] = NULL;
-	Assert(ac < lengthof(av));
 
-	return postmaster_forkexec(ac, av);
-}
-#endif							/* EXEC_BACKEND */
-
-
-/*
- * pgstat_start() -
- *
- *	Called from postmaster at startup or after an existing collector
- *	died.  Attempt to fire up a fresh statistics collector.
- *
- *	Returns PID of child process, or 0 if fail.
+/* ----------
+ * pgstat_attach_shmem() -
  *
- *	Note: if fail, we will be called again from the postmaster main loop.
+ *	Attach to the DSA area and the hash tables of the shared statistics, if
+ *	not done yet in this process.  The mappings are kept until the process
+ *	exits.
+ * ----------
  */
-int
-pgstat_start(void)
+static void
+pgstat_attach_shmem(void)
 {
-	time_t		curtime;
-	pid_t		pgStatPid;
-
-	/*
-	 * Check that the socket is there, else pgstat_init failed and we can do
-	 * nothing useful.
-	 */
-	if (pgStatSock == PGINVALID_SOCKET)
-		return 0;
-
-	/*
-	 * Do nothing if too soon since last collector start.  This is a safety
-	 * valve to protect against continuous respawn attempts if the collector
-	 * is dying immediately at launch.  Note that since we will be re-called
-	 * from the postmaster main loop, we will get another chance later.
-	 */
-	curtime = time(NULL);
-	if ((unsigned int) (curtime - last_pgstat_start_time) <
-		(unsigned int) PGSTAT_RESTART_INTERVAL)
-		return 0;
-	last_pgstat_start_time = curtime;
-
-	/*
-	 * Okay, fork off the collector.
-	 */
-#ifdef EXEC_BACKEND
-	switch ((pgStatPid = pgstat_forkexec()))
-#else
-	switch ((pgStatPid = fork_process()))
-#endif
-	{
-		case -1:
-			ereport(LOG,
-					(errmsg("could not fork statistics collector: %m")));
-			return 0;
-
-#ifndef EXEC_BACKEND
-		case 0:
-			/* in postmaster child ... */
-			InitPostmasterChild();
+	MemoryContext oldcontext;
 
-			/* Close the postmaster's sockets */
-			ClosePostmasterPorts(false);
+	if (pgStatDSA != NULL)
+		return;
 
-			/* Drop our connection to postmaster's shared memory, as well */
-			dsm_detach_all();
-			PGSharedMemoryDetach();
+	Assert(IsUnderPostmaster && StatsShmem != NULL);
 
-			PgstatCollectorMain(0, NULL);
-			break;
-#endif
+	oldcontext = MemoryContextSwitchTo(TopMemoryContext);
 
-		default:
-			return (int) pgStatPid;
-	}
+	pgStatDSA = dsa_attach_in_place(StatsShmemDSAArea(), NULL);
+	dsa_pin_mapping(pgStatDSA);
+	on_shmem_exit(dsa_on_shmem_exit_release_in_place,
+				  PointerGetDatum(StatsShmemDSAArea()));
 
-	/* shouldn't get here */
-	return 0;
-}
+	pgStatSharedDBHash = dshash_attach(pgStatDSA, &db_hash_params,
+									   StatsShmem->db_hash_handle, NULL);
+	pgStatSharedTabHash = dshash_attach(pgStatDSA, &tab_hash_params,
+										StatsShmem->tab_hash_handle, NULL);
+	pgStatSharedFuncHash = dshash_attach(pgStatDSA, &func_hash_params,
+										 StatsShmem->func_hash_handle, NULL);
 
-void
-allow_immediate_pgstat_restart(void)
-{
-	last_pgstat_start_time = 0;
+	MemoryContextSwitchTo(oldcontext);
 }
 
-/* ------------------------------------------------------------
- * Public functions used by backends follow
- *------------------------------------------------------------
- */
-
 
 /* ----------
  * pgstat_report_stat() -
  *
  *	Must be called by processes that performs DML: tcop/postgres.c, logical
  *	receiver processes, SPI worker, etc. to send the so far collected
- *	per-table and function usage statistics to the collector.  Note that this
+ *	per-table and function usage statistics to shared memory.  Note that this
  *	is called only when not within a transaction, so it is fair to use
  *	transaction stop time as an approximation of current time.
  * ----------
@@ -845,7 +608,7 @@ pgstat_report_stat(bool force)
 	/* Don't expend a clock check if nothing to do */
 	if ((pgStatTabList == NULL || pgStatTabList->tsa_used == 0) &&
 		pgStatXactCommit == 0 && pgStatXactRollback == 0 &&
-		!have_function_stats)
+		!have_function_stats && !have_io_stats && !have_wal_flush_stats)
 		return;
 
 	/*
@@ -932,8 +695,14 @@ pgstat_report_stat(bool force)
 	/* Now, send function statistics */
 	pgstat_send_funcstats();
 
-	/* Finally send SLRU statistics */
+	/* Send SLRU statistics */
 	pgstat_send_slru();
+
+	/* Send I/O statistics */
+	pgstat_send_io();
+
+	/* Finally send group WAL flush statistics */
+	pgstat_send_wal_flush();
 }
 
 /*
@@ -945,8 +714,8 @@ pgstat_send_tabstat(PgStat_MsgTabstat *tsmsg)
 	int			n;
 	int			len;
 
-	/* It's unlikely we'd get here with no socket, but maybe not impossible */
-	if (pgStatSock == PGINVALID_SOCKET)
+	/* Statistics are not kept in single-user mode */
+	if (!IsUnderPostmaster)
 		return;
 
 	/*
@@ -1039,7 +808,7 @@ pgstat_send_funcstats(void)
 /* ----------
  * pgstat_vacuum_stat() -
  *
- *	Will tell the collector about objects he can get rid of.
+ *	Remove the statistics of objects that don't exist anymore.
  * ----------
  */
 void
@@ -1048,20 +817,18 @@ pgstat_vacuum_stat(void)
 	HTAB	   *htab;
 	PgStat_MsgTabpurge msg;
 	PgStat_MsgFuncpurge f_msg;
-	HASH_SEQ_STATUS hstat;
+	dshash_seq_status hstat;
 	PgStat_StatDBEntry *dbentry;
-	PgStat_StatTabEntry *tabentry;
-	PgStat_StatFuncEntry *funcentry;
+	PgStat_SharedTabEntry *tabentry;
+	PgStat_SharedFuncEntry *funcentry;
+	List	   *deadobjs;
+	ListCell   *lc;
 	int			len;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (!IsUnderPostmaster)
 		return;
 
-	/*
-	 * If not done for this transaction, read the statistics collector stats
-	 * file into some hash tables.
-	 */
-	backend_read_statsfile();
+	pgstat_attach_shmem();
 
 	/*
 	 * Read pg_database and make a list of OIDs of all existing databases
@@ -1069,61 +836,69 @@ pgstat_vacuum_stat(void)
 	htab = pgstat_collect_oids(DatabaseRelationId, Anum_pg_database_oid);
 
 	/*
-	 * Search the database hash table for dead databases and tell the
-	 * collector to drop them.
+	 * Search the database hash table for dead databases.  We can't drop them
+	 * while the scan holds the partition locks, so just remember them.
 	 */
-	hash_seq_init(&hstat, pgStatDBHash);
-	while ((dbentry = (PgStat_StatDBEntry *) hash_seq_search(&hstat)) != NULL)
+	deadobjs = NIL;
+	dshash_seq_init(&hstat, pgStatSharedDBHash, false);
+	while ((dbentry = (PgStat_StatDBEntry *) dshash_seq_next(&hstat)) != NULL)
 	{
 		Oid			dbid = dbentry->databaseid;
 
-		CHECK_FOR_INTERRUPTS();
-
 		/* the DB entry for shared tables (with InvalidOid) is never dropped */
 		if (OidIsValid(dbid) &&
 			hash_search(htab, (void *) &dbid, HASH_FIND, NULL) == NULL)
-			pgstat_drop_database(dbid);
+			deadobjs = lappend_oid(deadobjs, dbid);
+	}
+	dshash_seq_term(&hstat);
+
+	foreach(lc, deadobjs)
+	{
+		CHECK_FOR_INTERRUPTS();
+
+		pgstat_drop_database(lfirst_oid(lc));
 	}
 
 	/* Clean up */
+	list_free(deadobjs);
 	hash_destroy(htab);
 
 	/*
-	 * Lookup our own database entry; if not found, nothing more to do.
-	 */
-	dbentry = (PgStat_StatDBEntry *) hash_search(pgStatDBHash,
-												 (void *) &MyDatabaseId,
-												 HASH_FIND, NULL);
-	if (dbentry == NULL || dbentry->tables == NULL)
-		return;
-
-	/*
-	 * Similarly to above, make a list of all known relations in this DB.
+	 * Similarly to above, make a list of all known relations in this DB, and
+	 * of the dead ones in the table hash table.
 	 */
 	htab = pgstat_collect_oids(RelationRelationId, Anum_pg_class_oid);
 
-	/*
-	 * Initialize our messages table counter to zero
-	 */
-	msg.m_nentries = 0;
-
-	/*
-	 * Check for all tables listed in stats hashtable if they still exist.
-	 */
-	hash_seq_init(&hstat, dbentry->tables);
-	while ((tabentry = (PgStat_StatTabEntry *) hash_seq_search(&hstat)) != NULL)
+	deadobjs = NIL;
+	dshash_seq_init(&hstat, pgStatSharedTabHash, false);
+	while ((tabentry = (PgStat_SharedTabEntry *) dshash_seq_next(&hstat)) != NULL)
 	{
-		Oid			tabid = tabentry->tableid;
+		Oid			tabid = tabentry->key.objectid;
 
-		CHECK_FOR_INTERRUPTS();
-
-		if (hash_search(htab, (void *) &tabid, HASH_FIND, NULL) != NULL)
+		if (tabentry->key.databaseid != MyDatabaseId ||
+			hash_search(htab, (void *) &tabid, HASH_FIND, NULL) != NULL)
 			continue;
 
+		deadobjs = lappend_oid(deadobjs, tabid);
+	}
+	dshash_seq_term(&hstat);
+
+	/* Clean up */
+	hash_destroy(htab);
+
+	/*
+	 * Initialize our messages table counter to zero
+	 */
+	msg.m_nentries = 0;
+
+	foreach(lc, deadobjs)
+	{
+		CHECK_FOR_INTERRUPTS();
+
 		/*
-		 * Not there, so add this table's Oid to the message
+		 * Add this table's Oid to the message
 		 */
-		msg.m_tableid[msg.m_nentries++] = tabid;
+		msg.m_tableid[msg.m_nentries++] = lfirst_oid(lc);
 
 		/*
 		 * If the message is full, send it out and reinitialize to empty
@@ -1154,15 +929,25 @@ pgstat_vacuum_stat(void)
 		pgstat_send(&msg, len);
 	}
 
-	/* Clean up */
-	hash_destroy(htab);
+	list_free(deadobjs);
 
 	/*
 	 * Now repeat the above steps for functions.  However, we needn't bother
-	 * in the common case where no function stats are being collected.
+	 * reading pg_proc in the common case where no function stats are being
+	 * collected.
 	 */
-	if (dbentry->functions != NULL &&
-		hash_get_num_entries(dbentry->functions) > 0)
+	deadobjs = NIL;
+	dshash_seq_init(&hstat, pgStatSharedFuncHash, false);
+	while ((funcentry = (PgStat_SharedFuncEntry *) dshash_seq_next(&hstat)) != NULL)
+	{
+		if (funcentry->key.databaseid != MyDatabaseId)
+			continue;
+
+		deadobjs = lappend_oid(deadobjs, funcentry->key.objectid);
+	}
+	dshash_seq_term(&hstat);
+
+	if (deadobjs != NIL)
 	{
 		htab = pgstat_collect_oids(ProcedureRelationId, Anum_pg_proc_oid);
 
@@ -1170,10 +955,9 @@ pgstat_vacuum_stat(void)
 		f_msg.m_databaseid = MyDatabaseId;
 		f_msg.m_nentries = 0;
 
-		hash_seq_init(&hstat, dbentry->functions);
-		while ((funcentry = (PgStat_StatFuncEntry *) hash_seq_search(&hstat)) != NULL)
+		foreach(lc, deadobjs)
 		{
-			Oid			funcid = funcentry->functionid;
+			Oid			funcid = lfirst_oid(lc);
 
 			CHECK_FOR_INTERRUPTS();
 
@@ -1211,6 +995,7 @@ pgstat_vacuum_stat(void)
 		}
 
 		hash_destroy(htab);
+		list_free(deadobjs);
 	}
 }
 
@@ -1269,7 +1054,7 @@ pgstat_collect_oids(Oid catalogid, AttrNumber anum_oid)
 /* ----------
  * pgstat_drop_database() -
  *
- *	Tell the collector that we just dropped a database.
+ *	Report that we just dropped a database.
  *	(If the message gets lost, we will still clean the dead DB eventually
  *	via future invocations of pgstat_vacuum_stat().)
  * ----------
@@ -1279,7 +1064,7 @@ pgstat_drop_database(Oid databaseid)
 {
 	PgStat_MsgDropdb msg;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (!IsUnderPostmaster)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_DROPDB);
@@ -1291,7 +1076,7 @@ pgstat_drop_database(Oid databaseid)
 /* ----------
  * pgstat_drop_relation() -
  *
- *	Tell the collector that we just dropped a relation.
+ *	Report that we just dropped a relation.
  *	(If the message gets lost, we will still clean the dead entry eventually
  *	via future invocations of pgstat_vacuum_stat().)
  *
@@ -1306,7 +1091,7 @@ pgstat_drop_relation(Oid relid)
 	PgStat_MsgTabpurge msg;
 	int			len;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (!IsUnderPostmaster)
 		return;
 
 	msg.m_tableid[0] = relid;
@@ -1324,7 +1109,7 @@ pgstat_drop_relation(Oid relid)
 /* ----------
  * pgstat_reset_counters() -
  *
- *	Tell the statistics collector to reset counters for our database.
+ *	Reset counters for our database.
  *
  *	Permission checking for this function is managed through the normal
  *	GRANT system.
@@ -1335,7 +1120,7 @@ pgstat_reset_counters(void)
 {
 	PgStat_MsgResetcounter msg;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (!IsUnderPostmaster)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_RESETCOUNTER);
@@ -1346,7 +1131,7 @@ pgstat_reset_counters(void)
 /* ----------
  * pgstat_reset_shared_counters() -
  *
- *	Tell the statistics collector to reset cluster-wide shared counters.
+ *	Reset cluster-wide shared counters.
  *
  *	Permission checking for this function is managed through the normal
  *	GRANT system.
@@ -1357,18 +1142,31 @@ pgstat_reset_shared_counters(const char *target)
 {
 	PgStat_MsgResetsharedcounter msg;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (!IsUnderPostmaster)
 		return;
 
 	if (strcmp(target, "archiver") == 0)
 		msg.m_resettarget = RESET_ARCHIVER;
 	else if (strcmp(target, "bgwriter") == 0)
 		msg.m_resettarget = RESET_BGWRITER;
+	else if (strcmp(target, "io") == 0)
+		msg.m_resettarget = RESET_IO;
+	else if (strcmp(target, "wal_flush") == 0)
+		msg.m_resettarget = RESET_WAL_FLUSH;
+	else if (strcmp(target, "recovery_prefetch") == 0)
+	{
+		/*
+		 * We can't ask the stats subsystem to do this for us, because
+		 * pg_stat_recovery_prefetch is not backed by the stats subsystem.
+		 */
+		XLogPrefetchRequestResetStats();
+		return;
+	}
 	else
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
 				 errmsg("unrecognized reset target: \"%s\"", target),
-				 errhint("Target must be \"archiver\" or \"bgwriter\".")));
+				 errhint("Target must be \"archiver\", \"bgwriter\", \"io\", \"recovery_prefetch\" or \"wal_flush\".")));
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_RESETSHAREDCOUNTER);
 	pgstat_send(&msg, sizeof(msg));
@@ -1377,7 +1175,7 @@ pgstat_reset_shared_counters(const char *target)
 /* ----------
  * pgstat_reset_single_counter() -
  *
- *	Tell the statistics collector to reset a single counter.
+ *	Reset a single counter.
  *
  *	Permission checking for this function is managed through the normal
  *	GRANT system.
@@ -1388,7 +1186,7 @@ pgstat_reset_single_counter(Oid objoid, PgStat_Single_Reset_Type type)
 {
 	PgStat_MsgResetsinglecounter msg;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (!IsUnderPostmaster)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_RESETSINGLECOUNTER);
@@ -1402,7 +1200,7 @@ pgstat_reset_single_counter(Oid objoid, PgStat_Single_Reset_Type type)
 /* ----------
  * pgstat_reset_slru_counter() -
  *
- *	Tell the statistics collector to reset a single SLRU counter, or all
+ *	Reset a single SLRU counter, or all
  *	SLRU counters (when name is null).
  *
  *	Permission checking for this function is managed through the normal
@@ -1414,7 +1212,7 @@ pgstat_reset_slru_counter(const char *name)
 {
 	PgStat_MsgResetslrucounter msg;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (!IsUnderPostmaster)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_RESETSLRUCOUNTER);
@@ -1436,7 +1234,7 @@ pgstat_report_autovac(Oid dboid)
 {
 	PgStat_MsgAutovacStart msg;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (!IsUnderPostmaster)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_AUTOVAC_START);
@@ -1450,7 +1248,7 @@ pgstat_report_autovac(Oid dboid)
 /* ---------
  * pgstat_report_vacuum() -
  *
- *	Tell the collector about the table we just vacuumed.
+ *	Report about the table we just vacuumed.
  * ---------
  */
 void
@@ -1459,7 +1257,7 @@ pgstat_report_vacuum(Oid tableoid, bool shared,
 {
 	PgStat_MsgVacuum msg;
 
-	if (pgStatSock == PGINVALID_SOCKET || !pgstat_track_counts)
+	if (!IsUnderPostmaster || !pgstat_track_counts)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_VACUUM);
@@ -1475,7 +1273,7 @@ pgstat_report_vacuum(Oid tableoid, bool shared,
 /* --------
  * pgstat_report_analyze() -
  *
- *	Tell the collector about the table we just analyzed.
+ *	Report about the table we just analyzed.
  *
  * Caller must provide new live- and dead-tuples estimates, as well as a
  * flag indicating whether to reset the changes_since_analyze counter.
@@ -1488,7 +1286,7 @@ pgstat_report_analyze(Relation rel,
 {
 	PgStat_MsgAnalyze msg;
 
-	if (pgStatSock == PGINVALID_SOCKET || !pgstat_track_counts)
+	if (!IsUnderPostmaster || !pgstat_track_counts)
 		return;
 
 	/*
@@ -1496,9 +1294,9 @@ pgstat_report_analyze(Relation rel,
 	 * already inserted and/or deleted rows in the target table. ANALYZE will
 	 * have counted such rows as live or dead respectively. Because we will
 	 * report our counts of such rows at transaction end, we should subtract
-	 * off these counts from what we send to the collector now, else they'll
-	 * be double-counted after commit.  (This approach also ensures that the
-	 * collector ends up with the right numbers if we abort instead of
+	 * off these counts from what we report now, else they'll be
+	 * double-counted after commit.  (This approach also ensures that the
+	 * shared statistics end up with the right numbers if we abort instead of
 	 * committing.)
 	 */
 	if (rel->pgstat_info != NULL)
@@ -1531,7 +1329,7 @@ pgstat_report_analyze(Relation rel,
 /* --------
  * pgstat_report_recovery_conflict() -
  *
- *	Tell the collector about a Hot Standby recovery conflict.
+ *	Report a Hot Standby recovery conflict.
  * --------
  */
 void
@@ -1539,7 +1337,7 @@ pgstat_report_recovery_conflict(int reason)
 {
 	PgStat_MsgRecoveryConflict msg;
 
-	if (pgStatSock == PGINVALID_SOCKET || !pgstat_track_counts)
+	if (!IsUnderPostmaster || !pgstat_track_counts)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_RECOVERYCONFLICT);
@@ -1551,7 +1349,7 @@ pgstat_report_recovery_conflict(int reason)
 /* --------
  * pgstat_report_deadlock() -
  *
- *	Tell the collector about a deadlock detected.
+ *	Report a deadlock detected.
  * --------
  */
 void
@@ -1559,7 +1357,7 @@ pgstat_report_deadlock(void)
 {
 	PgStat_MsgDeadlock msg;
 
-	if (pgStatSock == PGINVALID_SOCKET || !pgstat_track_counts)
+	if (!IsUnderPostmaster || !pgstat_track_counts)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_DEADLOCK);
@@ -1572,7 +1370,7 @@ pgstat_report_deadlock(void)
 /* --------
  * pgstat_report_checksum_failures_in_db() -
  *
- *	Tell the collector about one or more checksum failures.
+ *	Report one or more checksum failures.
  * --------
  */
 void
@@ -1580,7 +1378,7 @@ pgstat_report_checksum_failures_in_db(Oid dboid, int failurecount)
 {
 	PgStat_MsgChecksumFailure msg;
 
-	if (pgStatSock == PGINVALID_SOCKET || !pgstat_track_counts)
+	if (!IsUnderPostmaster || !pgstat_track_counts)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_CHECKSUMFAILURE);
@@ -1594,7 +1392,7 @@ pgstat_report_checksum_failures_in_db(Oid dboid, int failurecount)
 /* --------
  * pgstat_report_checksum_failure() -
  *
- *	Tell the collector about a checksum failure.
+ *	Report a checksum failure.
  * --------
  */
 void
@@ -1606,7 +1404,7 @@ pgstat_report_checksum_failure(void)
 /* --------
  * pgstat_report_tempfile() -
  *
- *	Tell the collector about a temporary file.
+ *	Report a temporary file.
  * --------
  */
 void
@@ -1614,7 +1412,7 @@ pgstat_report_tempfile(size_t filesize)
 {
 	PgStat_MsgTempFile msg;
 
-	if (pgStatSock == PGINVALID_SOCKET || !pgstat_track_counts)
+	if (!IsUnderPostmaster || !pgstat_track_counts)
 		return;
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_TEMPFILE);
@@ -1624,43 +1422,6 @@ pgstat_report_tempfile(size_t filesize)
 }
 
 
-/* ----------
- * pgstat_ping() -
- *
- *	Send some junk data to the collector to increase traffic.
- * ----------
- */
-void
-pgstat_ping(void)
-{
-	PgStat_MsgDummy msg;
-
-	if (pgStatSock == PGINVALID_SOCKET)
-		return;
-
-	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_DUMMY);
-	pgstat_send(&msg, sizeof(msg));
-}
-
-/* ----------
- * pgstat_send_inquiry() -
- *
- *	Notify collector that we need fresh data.
- * ----------
- */
-static void
-pgstat_send_inquiry(TimestampTz clock_time, TimestampTz cutoff_time, Oid databaseid)
-{
-	PgStat_MsgInquiry msg;
-
-	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_INQUIRY);
-	msg.clock_time = clock_time;
-	msg.cutoff_time = cutoff_time;
-	msg.databaseid = databaseid;
-	pgstat_send(&msg, sizeof(msg));
-}
-
-
 /*
  * Initialize function call usage data.
  * Called by the executor before invoking a function.
@@ -1811,7 +1572,7 @@ pgstat_initstats(Relation rel)
 		return;
 	}
 
-	if (pgStatSock == PGINVALID_SOCKET || !pgstat_track_counts)
+	if (!IsUnderPostmaster || !pgstat_track_counts)
 	{
 		/* We're not counting at all */
 		rel->pgstat_info = NULL;
@@ -2367,7 +2128,7 @@ AtPrepare_PgStat(void)
  *
  * All we need do here is unlink the transaction stats state from the
  * nontransactional state.  The nontransactional action counts will be
- * reported to the stats collector immediately, while the effects on live
+ * reported to shared memory immediately, while the effects on live
  * and dead tuple counts are preserved in the 2PC state file.
  *
  * Note: AtEOXact_PgStat is not called during PREPARE.
@@ -2472,24 +2233,56 @@ pgstat_twophase_postabort(TransactionId xid, uint16 info,
  *	Support function for the SQL-callable pgstat* functions. Returns
  *	the collected statistics for one database or NULL. NULL doesn't mean
  *	that the database doesn't exist, it is just not yet known by the
- *	collector, so the caller is better off to report ZERO instead.
+ *	statistics system, so the caller is better off to report ZERO instead.
  * ----------
  */
 PgStat_StatDBEntry *
 pgstat_fetch_stat_dbentry(Oid dbid)
 {
-	/*
-	 * If not done for this transaction, read the statistics collector stats
-	 * file into some hash tables.
-	 */
-	backend_read_statsfile();
+	PgStat_SnapshotDBEntry *snapent;
+	bool		found;
+
+	if (!IsUnderPostmaster)
+		return NULL;
+
+	pgstat_attach_shmem();
+	pgstat_setup_memcxt();
+
+	if (pgStatSnapshotDBHash == NULL)
+	{
+		HASHCTL		hash_ctl;
+
+		memset(&hash_ctl, 0, sizeof(hash_ctl));
+		hash_ctl.keysize = sizeof(Oid);
+		hash_ctl.entrysize = sizeof(PgStat_SnapshotDBEntry);
+		hash_ctl.hcxt = pgStatLocalContext;
+		pgStatSnapshotDBHash = hash_create("Databases snapshot hash",
+										   PGSTAT_DB_HASH_SIZE, &hash_ctl,
+										   HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	}
 
 	/*
-	 * Lookup the requested database; return NULL if not found
+	 * If we haven't looked at this database in this transaction yet, copy
+	 * its entry from shared memory.
 	 */
-	return (PgStat_StatDBEntry *) hash_search(pgStatDBHash,
-											  (void *) &dbid,
-											  HASH_FIND, NULL);
+	snapent = (PgStat_SnapshotDBEntry *) hash_search(pgStatSnapshotDBHash,
+													 (void *) &dbid,
+													 HASH_ENTER, &found);
+	if (!found)
+	{
+		PgStat_StatDBEntry *dbentry;
+
+		dbentry = (PgStat_StatDBEntry *)
+			dshash_find(pgStatSharedDBHash, &dbid, false);
+		snapent->found = (dbentry != NULL);
+		if (dbentry != NULL)
+		{
+			memcpy(&snapent->stats, dbentry, sizeof(PgStat_StatDBEntry));
+			dshash_release_lock(pgStatSharedDBHash, dbentry);
+		}
+	}
+
+	return snapent->found ? &snapent->stats : NULL;
 }
 
 
@@ -2499,55 +2292,81 @@ pgstat_fetch_stat_dbentry(Oid dbid)
  *	Support function for the SQL-callable pgstat* functions. Returns
  *	the collected statistics for one table or NULL. NULL doesn't mean
  *	that the table doesn't exist, it is just not yet known by the
- *	collector, so the caller is better off to report ZERO instead.
+ *	statistics system, so the caller is better off to report ZERO instead.
  * ----------
  */
 PgStat_StatTabEntry *
 pgstat_fetch_stat_tabentry(Oid relid)
 {
-	Oid			dbid;
-	PgStat_StatDBEntry *dbentry;
 	PgStat_StatTabEntry *tabentry;
 
 	/*
-	 * If not done for this transaction, read the statistics collector stats
-	 * file into some hash tables.
+	 * Look in our database first.  If we don't find it there, maybe it's a
+	 * shared table.
 	 */
-	backend_read_statsfile();
+	tabentry = pgstat_fetch_stat_tabentry_ext(false, relid);
+	if (tabentry != NULL)
+		return tabentry;
 
-	/*
-	 * Lookup our database, then look in its table hash table.
-	 */
-	dbid = MyDatabaseId;
-	dbentry = (PgStat_StatDBEntry *) hash_search(pgStatDBHash,
-												 (void *) &dbid,
-												 HASH_FIND, NULL);
-	if (dbentry != NULL && dbentry->tables != NULL)
+	return pgstat_fetch_stat_tabentry_ext(true, relid);
+}
+
+
+/* ----------
+ * pgstat_fetch_stat_tabentry_ext() -
+ *
+ *	Like pgstat_fetch_stat_tabentry(), but only looks either at the shared
+ *	tables or at the tables of our database, as specified by 'shared'.
+ * ----------
+ */
+PgStat_StatTabEntry *
+pgstat_fetch_stat_tabentry_ext(bool shared, Oid relid)
+{
+	PgStat_SnapshotTabEntry *snapent;
+	PgStat_StatObjKey key;
+	bool		found;
+
+	if (!IsUnderPostmaster)
+		return NULL;
+
+	pgstat_attach_shmem();
+	pgstat_setup_memcxt();
+
+	if (pgStatSnapshotTabHash == NULL)
 	{
-		tabentry = (PgStat_StatTabEntry *) hash_search(dbentry->tables,
-													   (void *) &relid,
-													   HASH_FIND, NULL);
-		if (tabentry)
-			return tabentry;
+		HASHCTL		hash_ctl;
+
+		memset(&hash_ctl, 0, sizeof(hash_ctl));
+		hash_ctl.keysize = sizeof(PgStat_StatObjKey);
+		hash_ctl.entrysize = sizeof(PgStat_SnapshotTabEntry);
+		hash_ctl.hcxt = pgStatLocalContext;
+		pgStatSnapshotTabHash = hash_create("Tables snapshot hash",
+											PGSTAT_TAB_HASH_SIZE, &hash_ctl,
+											HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
 	}
 
-	/*
-	 * If we didn't find it, maybe it's a shared table.
-	 */
-	dbid = InvalidOid;
-	dbentry = (PgStat_StatDBEntry *) hash_search(pgStatDBHash,
-												 (void *) &dbid,
-												 HASH_FIND, NULL);
-	if (dbentry != NULL && dbentry->tables != NULL)
+	key.databaseid = shared ? InvalidOid : MyDatabaseId;
+	key.objectid = relid;
+
+	snapent = (PgStat_SnapshotTabEntry *) hash_search(pgStatSnapshotTabHash,
+													  (void *) &key,
+													  HASH_ENTER, &found);
+	if (!found)
 	{
-		tabentry = (PgStat_StatTabEntry *) hash_search(dbentry->tables,
-													   (void *) &relid,
-													   HASH_FIND, NULL);
-		if (tabentry)
-			return tabentry;
+		PgStat_SharedTabEntry *tabentry;
+
+		tabentry = (PgStat_SharedTabEntry *)
+			dshash_find(pgStatSharedTabHash, &key, false);
+		snapent->found = (tabentry != NULL);
+		if (tabentry != NULL)
+		{
+			memcpy(&snapent->stats, &tabentry->stats,
+				   sizeof(PgStat_StatTabEntry));
+			dshash_release_lock(pgStatSharedTabHash, tabentry);
+		}
 	}
 
-	return NULL;
+	return snapent->found ? &snapent->stats : NULL;
 }
 
 
@@ -2561,22 +2380,52 @@ pgstat_fetch_stat_tabentry(Oid relid)
 PgStat_StatFuncEntry *
 pgstat_fetch_stat_funcentry(Oid func_id)
 {
-	PgStat_StatDBEntry *dbentry;
-	PgStat_StatFuncEntry *funcentry = NULL;
+	PgStat_SnapshotFuncEntry *snapent;
+	PgStat_StatObjKey key;
+	bool		found;
+
+	if (!IsUnderPostmaster)
+		return NULL;
+
+	pgstat_attach_shmem();
+	pgstat_setup_memcxt();
+
+	if (pgStatSnapshotFuncHash == NULL)
+	{
+		HASHCTL		hash_ctl;
+
+		memset(&hash_ctl, 0, sizeof(hash_ctl));
+		hash_ctl.keysize = sizeof(PgStat_StatObjKey);
+		hash_ctl.entrysize = sizeof(PgStat_SnapshotFuncEntry);
+		hash_ctl.hcxt = pgStatLocalContext;
+		pgStatSnapshotFuncHash = hash_create("Functions snapshot hash",
+											 PGSTAT_FUNCTION_HASH_SIZE,
+											 &hash_ctl,
+											 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	}
 
-	/* load the stats file if needed */
-	backend_read_statsfile();
+	key.databaseid = MyDatabaseId;
+	key.objectid = func_id;
 
-	/* Lookup our database, then find the requested function.  */
-	dbentry = pgstat_fetch_stat_dbentry(MyDatabaseId);
-	if (dbentry != NULL && dbentry->functions != NULL)
+	snapent = (PgStat_SnapshotFuncEntry *) hash_search(pgStatSnapshotFuncHash,
+													   (void *) &key,
+													   HASH_ENTER, &found);
+	if (!found)
 	{
-		funcentry = (PgStat_StatFuncEntry *) hash_search(dbentry->functions,
-														 (void *) &func_id,
-														 HASH_FIND, NULL);
+		PgStat_SharedFuncEntry *funcentry;
+
+		funcentry = (PgStat_SharedFuncEntry *)
+			dshash_find(pgStatSharedFuncHash, &key, false);
+		snapent->found = (funcentry != NULL);
+		if (funcentry != NULL)
+		{
+			memcpy(&snapent->stats, &funcentry->stats,
+				   sizeof(PgStat_StatFuncEntry));
+			dshash_release_lock(pgStatSharedFuncHash, funcentry);
+		}
 	}
 
-	return funcentry;
+	return snapent->found ? &snapent->stats : NULL;
 }
 
 
@@ -2650,7 +2499,7 @@ pgstat_fetch_stat_numbackends(void)
 PgStat_ArchiverStats *
 pgstat_fetch_stat_archiver(void)
 {
-	backend_read_statsfile();
+	pgstat_snapshot_global_stats();
 
 	return &archiverStats;
 }
@@ -2667,7 +2516,7 @@ pgstat_fetch_stat_archiver(void)
 PgStat_GlobalStats *
 pgstat_fetch_global(void)
 {
-	backend_read_statsfile();
+	pgstat_snapshot_global_stats();
 
 	return &globalStats;
 }
@@ -2684,12 +2533,87 @@ pgstat_fetch_global(void)
 PgStat_SLRUStats *
 pgstat_fetch_slru(void)
 {
-	backend_read_statsfile();
+	pgstat_snapshot_global_stats();
 
 	return slruStats;
 }
 
 
+/*
+ * ---------
+ * pgstat_fetch_stat_io() -
+ *
+ *	Support function for the SQL-callable pgstat* functions. Returns
+ *	a pointer to the shared buffer I/O statistics struct.
+ * ---------
+ */
+PgStat_IOStats *
+pgstat_fetch_stat_io(void)
+{
+	pgstat_snapshot_global_stats();
+
+	return &ioStats;
+}
+
+
+/*
+ * ---------
+ * pgstat_fetch_stat_wal_flush() -
+ *
+ *	Support function for the SQL-callable pgstat* functions. Returns
+ *	a pointer to the group WAL flush statistics struct.
+ * ---------
+ */
+PgStat_WalFlushStats *
+pgstat_fetch_stat_wal_flush(void)
+{
+	pgstat_snapshot_global_stats();
+
+	return &walFlushStats;
+}
+
+
+/*
+ * ---------
+ * pgstat_snapshot_global_stats() -
+ *
+ *	Copy the cluster-wide statistics from shared memory, if not done yet in
+ *	this transaction.  The time of the copy is reported as the snapshot's
+ *	timestamp.
+ * ---------
+ */
+static void
+pgstat_snapshot_global_stats(void)
+{
+	if (have_global_snapshot)
+		return;
+
+	if (!IsUnderPostmaster)
+	{
+		memset(&globalStats, 0, sizeof(globalStats));
+		memset(&archiverStats, 0, sizeof(archiverStats));
+		memset(&slruStats, 0, sizeof(slruStats));
+		memset(&ioStats, 0, sizeof(ioStats));
+		memset(&walFlushStats, 0, sizeof(walFlushStats));
+	}
+	else
+	{
+		SpinLockAcquire(&StatsShmem->mutex);
+		memcpy(&globalStats, &StatsShmem->global_stats, sizeof(globalStats));
+		memcpy(&archiverStats, &StatsShmem->archiver_stats,
+			   sizeof(archiverStats));
+		memcpy(&slruStats, &StatsShmem->slru_stats, sizeof(slruStats));
+		memcpy(&ioStats, &StatsShmem->io_stats, sizeof(ioStats));
+		memcpy(&walFlushStats, &StatsShmem->wal_flush_stats,
+			   sizeof(walFlushStats));
+		SpinLockRelease(&StatsShmem->mutex);
+	}
+
+	globalStats.stats_timestamp = GetCurrentTimestamp();
+	have_global_snapshot = true;
+}
+
+
 /* ------------------------------------------------------------
  * Functions for management of the shared-memory PgBackendStatus array
  * ------------------------------------------------------------
@@ -2900,8 +2824,16 @@ pgstat_initialize(void)
 		MyBEEntry = &BackendStatusArray[MaxBackends + MyAuxProcType];
 	}
 
-	/* Set up a process-exit hook to clean up */
-	on_shmem_exit(pgstat_beshutdown_hook, 0);
+	/* Attach to the shared statistics before the exit hook needs them */
+	if (IsUnderPostmaster)
+		pgstat_attach_shmem();
+
+	/*
+	 * Set up a process-exit hook to clean up.  It flushes to the shared
+	 * hash tables, so it has to run before dsm_backend_shutdown() unmaps
+	 * the DSA segments.
+	 */
+	before_shmem_exit(pgstat_beshutdown_hook, 0);
 }
 
 /* ----------
@@ -3082,7 +3014,7 @@ pgstat_bestart(void)
 /*
  * Shut down a single backend's statistics reporting at process exit.
  *
- * Flush any remaining statistics counts out to the collector.
+ * Flush any remaining statistics counts out to shared memory.
  * Without this, operations triggered during backend exit (such as
  * temp table deletions) won't be counted.
  *
@@ -3095,13 +3027,20 @@ pgstat_beshutdown_hook(int code, Datum arg)
 
 	/*
 	 * If we got as far as discovering our own database ID, we can report what
-	 * we did to the collector.  Otherwise, we'd be sending an invalid
+	 * we did.  Otherwise, we'd be sending an invalid
 	 * database ID, so forget it.  (This means that accesses to pg_database
 	 * during failed backend starts might never get counted.)
 	 */
 	if (OidIsValid(MyDatabaseId))
 		pgstat_report_stat(true);
 
+	/*
+	 * Processes that never report table statistics, like the startup
+	 * process, may still have done I/O or flushed WAL.
+	 */
+	pgstat_send_io();
+	pgstat_send_wal_flush();
+
 	/*
 	 * Clear my status entry, following the protocol of bumping st_changecount
 	 * before and after.  We use a volatile pointer here to ensure the
@@ -3112,6 +3051,8 @@ pgstat_beshutdown_hook(int code, Datum arg)
 	beentry->st_procpid = 0;	/* mark invalid */
 
 	PGSTAT_END_WRITE_ACTIVITY(beentry);
+
+	pgstat_shutdown = true;
 }
 
 
@@ -3372,7 +3313,6 @@ pgstat_read_current_status(void)
 #endif
 	int			i;
 
-	Assert(!pgStatRunningInCollector);
 	if (localBackendStatusTable)
 		return;					/* already done */
 
@@ -3661,15 +3601,15 @@ pgstat_get_wait_activity(WaitEventActivity w)
 		case WAIT_EVENT_CHECKPOINTER_MAIN:
 			event_name = "CheckpointerMain";
 			break;
+		case WAIT_EVENT_IO_WORKER_MAIN:
+			event_name = "IoWorkerMain";
+			break;
 		case WAIT_EVENT_LOGICAL_APPLY_MAIN:
 			event_name = "LogicalApplyMain";
 			break;
 		case WAIT_EVENT_LOGICAL_LAUNCHER_MAIN:
 			event_name = "LogicalLauncherMain";
 			break;
-		case WAIT_EVENT_PGSTAT_MAIN:
-			event_name = "PgStatMain";
-			break;
 		case WAIT_EVENT_RECOVERY_WAL_STREAM:
 			event_name = "RecoveryWalStream";
 			break;
@@ -3682,6 +3622,9 @@ pgstat_get_wait_activity(WaitEventActivity w)
 		case WAIT_EVENT_WAL_SENDER_MAIN:
 			event_name = "WalSenderMain";
 			break;
+		case WAIT_EVENT_WAL_SUMMARIZER_WAL:
+			event_name = "WalSummarizerWal";
+			break;
 		case WAIT_EVENT_WAL_WRITER_MAIN:
 			event_name = "WalWriterMain";
 			break;
@@ -3750,6 +3693,12 @@ pgstat_get_wait_ipc(WaitEventIPC w)
 
 	switch (w)
 	{
+		case WAIT_EVENT_AIO_COMPLETION:
+			event_name = "AioCompletion";
+			break;
+		case WAIT_EVENT_BACKUP_WAIT_PARALLEL_WORKERS:
+			event_name = "BackupWaitParallelWorkers";
+			break;
 		case WAIT_EVENT_BACKUP_WAIT_WAL_ARCHIVE:
 			event_name = "BackupWaitWalArchive";
 			break;
@@ -3762,6 +3711,9 @@ pgstat_get_wait_ipc(WaitEventIPC w)
 		case WAIT_EVENT_BTREE_PAGE:
 			event_name = "BtreePage";
 			break;
+		case WAIT_EVENT_BUFFER_IO:
+			event_name = "BufferIO";
+			break;
 		case WAIT_EVENT_CHECKPOINT_DONE:
 			event_name = "CheckpointDone";
 			break;
@@ -3846,6 +3798,9 @@ pgstat_get_wait_ipc(WaitEventIPC w)
 		case WAIT_EVENT_PARALLEL_FINISH:
 			event_name = "ParallelFinish";
 			break;
+		case WAIT_EVENT_PARALLEL_REDO_DRAIN:
+			event_name = "ParallelRedoDrain";
+			break;
 		case WAIT_EVENT_PROCARRAY_GROUP_UPDATE:
 			event_name = "ProcArrayGroupUpdate";
 			break;
@@ -3873,6 +3828,12 @@ pgstat_get_wait_ipc(WaitEventIPC w)
 		case WAIT_EVENT_SYNC_REP:
 			event_name = "SyncRep";
 			break;
+		case WAIT_EVENT_WAL_FLUSH_GROUP:
+			event_name = "WALFlushGroup";
+			break;
+		case WAIT_EVENT_WAL_SUMMARY_READY:
+			event_name = "WalSummaryReady";
+			break;
 			/* no default case, so that compiler will warn */
 	}
 
@@ -4124,6 +4085,12 @@ pgstat_get_wait_io(WaitEventIO w)
 		case WAIT_EVENT_WAL_READ:
 			event_name = "WALRead";
 			break;
+		case WAIT_EVENT_WAL_SUMMARY_READ:
+			event_name = "WalSummaryRead";
+			break;
+		case WAIT_EVENT_WAL_SUMMARY_WRITE:
+			event_name = "WalSummaryWrite";
+			break;
 		case WAIT_EVENT_WAL_SYNC:
 			event_name = "WALSync";
 			break;
@@ -4319,36 +4286,120 @@ pgstat_setheader(PgStat_MsgHdr *hdr, StatMsgType mtype)
 /* ----------
  * pgstat_send() -
  *
- *		Send out one statistics message to the collector
+ *		Apply one statistics message to the shared statistics
  * ----------
  */
 static void
 pgstat_send(void *msg, int len)
 {
-	int			rc;
+	PgStat_MsgHdr *hdr = (PgStat_MsgHdr *) msg;
 
-	if (pgStatSock == PGINVALID_SOCKET)
+	if (!IsUnderPostmaster || pgstat_shutdown)
 		return;
 
-	((PgStat_MsgHdr *) msg)->m_size = len;
+	hdr->m_size = len;
 
-	/* We'll retry after EINTR, but ignore all other failures */
-	do
+	switch (hdr->m_type)
 	{
-		rc = send(pgStatSock, msg, len, 0);
-	} while (rc < 0 && errno == EINTR);
+		case PGSTAT_MTYPE_TABSTAT:
+			pgstat_recv_tabstat((PgStat_MsgTabstat *) msg, len);
+			break;
 
-#ifdef USE_ASSERT_CHECKING
-	/* In debug builds, log send failures ... */
-	if (rc < 0)
-		elog(LOG, "could not send to statistics collector: %m");
-#endif
+		case PGSTAT_MTYPE_TABPURGE:
+			pgstat_recv_tabpurge((PgStat_MsgTabpurge *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_DROPDB:
+			pgstat_recv_dropdb((PgStat_MsgDropdb *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_RESETCOUNTER:
+			pgstat_recv_resetcounter((PgStat_MsgResetcounter *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_RESETSHAREDCOUNTER:
+			pgstat_recv_resetsharedcounter((PgStat_MsgResetsharedcounter *) msg,
+										   len);
+			break;
+
+		case PGSTAT_MTYPE_RESETSINGLECOUNTER:
+			pgstat_recv_resetsinglecounter((PgStat_MsgResetsinglecounter *) msg,
+										   len);
+			break;
+
+		case PGSTAT_MTYPE_RESETSLRUCOUNTER:
+			pgstat_recv_resetslrucounter((PgStat_MsgResetslrucounter *) msg,
+										 len);
+			break;
+
+		case PGSTAT_MTYPE_AUTOVAC_START:
+			pgstat_recv_autovac((PgStat_MsgAutovacStart *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_VACUUM:
+			pgstat_recv_vacuum((PgStat_MsgVacuum *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_ANALYZE:
+			pgstat_recv_analyze((PgStat_MsgAnalyze *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_ARCHIVER:
+			pgstat_recv_archiver((PgStat_MsgArchiver *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_BGWRITER:
+			pgstat_recv_bgwriter((PgStat_MsgBgWriter *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_SLRU:
+			pgstat_recv_slru((PgStat_MsgSLRU *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_IO:
+			pgstat_recv_io((PgStat_MsgIO *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_WALFLUSH:
+			pgstat_recv_wal_flush((PgStat_MsgWalFlush *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_FUNCSTAT:
+			pgstat_recv_funcstat((PgStat_MsgFuncstat *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_FUNCPURGE:
+			pgstat_recv_funcpurge((PgStat_MsgFuncpurge *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_RECOVERYCONFLICT:
+			pgstat_recv_recoveryconflict((PgStat_MsgRecoveryConflict *) msg,
+										 len);
+			break;
+
+		case PGSTAT_MTYPE_DEADLOCK:
+			pgstat_recv_deadlock((PgStat_MsgDeadlock *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_TEMPFILE:
+			pgstat_recv_tempfile((PgStat_MsgTempFile *) msg, len);
+			break;
+
+		case PGSTAT_MTYPE_CHECKSUMFAILURE:
+			pgstat_recv_checksum_failure((PgStat_MsgChecksumFailure *) msg,
+										 len);
+			break;
+
+		default:
+			elog(ERROR, "unrecognized statistics message type: %d",
+				 (int) hdr->m_type);
+	}
 }
 
 /* ----------
  * pgstat_send_archiver() -
  *
- *	Tell the collector about the WAL file that we successfully
+ *	Report the WAL file that we successfully
  *	archived or failed to archive.
  * ----------
  */
@@ -4370,7 +4421,7 @@ pgstat_send_archiver(const char *xlog, bool failed)
 /* ----------
  * pgstat_send_bgwriter() -
  *
- *		Send bgwriter statistics to the collector
+ *		Send bgwriter statistics to shared memory
  * ----------
  */
 void
@@ -4381,8 +4432,7 @@ pgstat_send_bgwriter(void)
 
 	/*
 	 * This function can be called even if nothing at all has happened. In
-	 * this case, avoid sending a completely empty message to the stats
-	 * collector.
+	 * this case, avoid applying a completely empty message.
 	 */
 	if (memcmp(&BgWriterStats, &all_zeroes, sizeof(PgStat_MsgBgWriter)) == 0)
 		return;
@@ -4397,12 +4447,61 @@ pgstat_send_bgwriter(void)
 	 * Clear out the statistics buffer, so it can be re-used.
 	 */
 	MemSet(&BgWriterStats, 0, sizeof(BgWriterStats));
+
+	/* The bgwriter and checkpointer report their I/O along with this */
+	pgstat_send_io();
+	pgstat_send_wal_flush();
+}
+
+/* ----------
+ * pgstat_send_io() -
+ *
+ *		Send this process's shared buffer I/O statistics to shared memory
+ * ----------
+ */
+void
+pgstat_send_io(void)
+{
+	PgStat_MsgIO msg;
+
+	if (!have_io_stats)
+		return;
+
+	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_IO);
+	msg.m_backend_type = MyBackendType;
+	memcpy(&msg.m_counts, &PendingIOStats, sizeof(PgStat_IOCounts));
+	pgstat_send(&msg, sizeof(msg));
+
+	MemSet(&PendingIOStats, 0, sizeof(PendingIOStats));
+	have_io_stats = false;
+}
+
+/* ----------
+ * pgstat_send_wal_flush() -
+ *
+ *		Send this process's group WAL flush statistics to shared memory
+ * ----------
+ */
+void
+pgstat_send_wal_flush(void)
+{
+	PgStat_MsgWalFlush msg;
+
+	if (!have_wal_flush_stats)
+		return;
+
+	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_WALFLUSH);
+	memcpy(&msg.m_counts, &PendingWalFlushStats, sizeof(PgStat_WalFlushCounts));
+	pgstat_send(&msg, sizeof(msg));
+
+	MemSet(&PendingWalFlushStats, 0, sizeof(PendingWalFlushStats));
+	have_wal_flush_stats = false;
 }
 
 /* ----------
  * pgstat_send_slru() -
  *
- *		Send SLRU statistics to the collector
+ *		Send SLRU statistics to shared memory
  * ----------
  */
 static void
@@ -4417,8 +4516,7 @@ pgstat_send_slru(void)
 	{
 		/*
 		 * This function can be called even if nothing at all has happened. In
-		 * this case, avoid sending a completely empty message to the stats
-		 * collector.
+		 * this case, avoid applying a completely empty message.
 		 */
 		if (memcmp(&SLRUStats[i], &all_zeroes, sizeof(PgStat_MsgSLRU)) == 0)
 			continue;
@@ -4440,284 +4538,13 @@ pgstat_send_slru(void)
 }
 
 
-/* ----------
- * PgstatCollectorMain() -
- *
- *	Start up the statistics collector process.  This is the body of the
- *	postmaster child process.
- *
- *	The argc/argv parameters are valid only in EXEC_BACKEND case.
- * ----------
- */
-NON_EXEC_STATIC void
-PgstatCollectorMain(int argc, char *argv[])
-{
-	int			len;
-	PgStat_Msg	msg;
-	int			wr;
-
-	/*
-	 * Ignore all signals usually bound to some action in the postmaster,
-	 * except SIGHUP and SIGQUIT.  Note we don't need a SIGUSR1 handler to
-	 * support latch operations, because we only use a local latch.
-	 */
-	pqsignal(SIGHUP, SignalHandlerForConfigReload);
-	pqsignal(SIGINT, SIG_IGN);
-	pqsignal(SIGTERM, SIG_IGN);
-	pqsignal(SIGQUIT, SignalHandlerForShutdownRequest);
-	pqsignal(SIGALRM, SIG_IGN);
-	pqsignal(SIGPIPE, SIG_IGN);
-	pqsignal(SIGUSR1, SIG_IGN);
-	pqsignal(SIGUSR2, SIG_IGN);
-	/* Reset some signals that are accepted by postmaster but not here */
-	pqsignal(SIGCHLD, SIG_DFL);
-	PG_SETMASK(&UnBlockSig);
-
-	MyBackendType = B_STATS_COLLECTOR;
-	init_ps_display(NULL);
-
-	/*
-	 * Read in existing stats files or initialize the stats to zero.
-	 */
-	pgStatRunningInCollector = true;
-	pgStatDBHash = pgstat_read_statsfiles(InvalidOid, true, true);
-
-	/*
-	 * Loop to process messages until we get SIGQUIT or detect ungraceful
-	 * death of our parent postmaster.
-	 *
-	 * For performance reasons, we don't want to do ResetLatch/WaitLatch after
-	 * every message; instead, do that only after a recv() fails to obtain a
-	 * message.  (This effectively means that if backends are sending us stuff
-	 * like mad, we won't notice postmaster death until things slack off a
-	 * bit; which seems fine.)	To do that, we have an inner loop that
-	 * iterates as long as recv() succeeds.  We do check ConfigReloadPending
-	 * inside the inner loop, which means that such interrupts will get
-	 * serviced but the latch won't get cleared until next time there is a
-	 * break in the action.
-	 */
-	for (;;)
-	{
-		/* Clear any already-pending wakeups */
-		ResetLatch(MyLatch);
-
-		/*
-		 * Quit if we get SIGQUIT from the postmaster.
-		 */
-		if (ShutdownRequestPending)
-			break;
-
-		/*
-		 * Inner loop iterates as long as we keep getting messages, or until
-		 * ShutdownRequestPending becomes set.
-		 */
-		while (!ShutdownRequestPending)
-		{
-			/*
-			 * Reload configuration if we got SIGHUP from the postmaster.
-			 */
-			if (ConfigReloadPending)
-			{
-				ConfigReloadPending = false;
-				ProcessConfigFile(PGC_SIGHUP);
-			}
-
-			/*
-			 * Write the stats file(s) if a new request has arrived that is
-			 * not satisfied by existing file(s).
-			 */
-			if (pgstat_write_statsfile_needed())
-				pgstat_write_statsfiles(false, false);
-
-			/*
-			 * Try to receive and process a message.  This will not block,
-			 * since the socket is set to non-blocking mode.
-			 *
-			 * XXX On Windows, we have to force pgwin32_recv to cooperate,
-			 * despite the previous use of pg_set_noblock() on the socket.
-			 * This is extremely broken and should be fixed someday.
-			 */
-#ifdef WIN32
-			pgwin32_noblock = 1;
-#endif
-
-			len = recv(pgStatSock, (char *) &msg,
-					   sizeof(PgStat_Msg), 0);
-
-#ifdef WIN32
-			pgwin32_noblock = 0;
-#endif
-
-			if (len < 0)
-			{
-				if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
-					break;		/* out of inner loop */
-				ereport(ERROR,
-						(errcode_for_socket_access(),
-						 errmsg("could not read statistics message: %m")));
-			}
-
-			/*
-			 * We ignore messages that are smaller than our common header
-			 */
-			if (len < sizeof(PgStat_MsgHdr))
-				continue;
-
-			/*
-			 * The received length must match the length in the header
-			 */
-			if (msg.msg_hdr.m_size != len)
-				continue;
-
-			/*
-			 * O.K. - we accept this message.  Process it.
-			 */
-			switch (msg.msg_hdr.m_type)
-			{
-				case PGSTAT_MTYPE_DUMMY:
-					break;
-
-				case PGSTAT_MTYPE_INQUIRY:
-					pgstat_recv_inquiry(&msg.msg_inquiry, len);
-					break;
-
-				case PGSTAT_MTYPE_TABSTAT:
-					pgstat_recv_tabstat(&msg.msg_tabstat, len);
-					break;
-
-				case PGSTAT_MTYPE_TABPURGE:
-					pgstat_recv_tabpurge(&msg.msg_tabpurge, len);
-					break;
-
-				case PGSTAT_MTYPE_DROPDB:
-					pgstat_recv_dropdb(&msg.msg_dropdb, len);
-					break;
-
-				case PGSTAT_MTYPE_RESETCOUNTER:
-					pgstat_recv_resetcounter(&msg.msg_resetcounter, len);
-					break;
-
-				case PGSTAT_MTYPE_RESETSHAREDCOUNTER:
-					pgstat_recv_resetsharedcounter(&msg.msg_resetsharedcounter,
-												   len);
-					break;
-
-				case PGSTAT_MTYPE_RESETSINGLECOUNTER:
-					pgstat_recv_resetsinglecounter(&msg.msg_resetsinglecounter,
-												   len);
-					break;
-
-				case PGSTAT_MTYPE_RESETSLRUCOUNTER:
-					pgstat_recv_resetslrucounter(&msg.msg_resetslrucounter,
-												 len);
-					break;
-
-				case PGSTAT_MTYPE_AUTOVAC_START:
-					pgstat_recv_autovac(&msg.msg_autovacuum_start, len);
-					break;
-
-				case PGSTAT_MTYPE_VACUUM:
-					pgstat_recv_vacuum(&msg.msg_vacuum, len);
-					break;
-
-				case PGSTAT_MTYPE_ANALYZE:
-					pgstat_recv_analyze(&msg.msg_analyze, len);
-					break;
-
-				case PGSTAT_MTYPE_ARCHIVER:
-					pgstat_recv_archiver(&msg.msg_archiver, len);
-					break;
-
-				case PGSTAT_MTYPE_BGWRITER:
-					pgstat_recv_bgwriter(&msg.msg_bgwriter, len);
-					break;
-
-				case PGSTAT_MTYPE_SLRU:
-					pgstat_recv_slru(&msg.msg_slru, len);
-					break;
-
-				case PGSTAT_MTYPE_FUNCSTAT:
-					pgstat_recv_funcstat(&msg.msg_funcstat, len);
-					break;
-
-				case PGSTAT_MTYPE_FUNCPURGE:
-					pgstat_recv_funcpurge(&msg.msg_funcpurge, len);
-					break;
-
-				case PGSTAT_MTYPE_RECOVERYCONFLICT:
-					pgstat_recv_recoveryconflict(&msg.msg_recoveryconflict,
-												 len);
-					break;
-
-				case PGSTAT_MTYPE_DEADLOCK:
-					pgstat_recv_deadlock(&msg.msg_deadlock, len);
-					break;
-
-				case PGSTAT_MTYPE_TEMPFILE:
-					pgstat_recv_tempfile(&msg.msg_tempfile, len);
-					break;
-
-				case PGSTAT_MTYPE_CHECKSUMFAILURE:
-					pgstat_recv_checksum_failure(&msg.msg_checksumfailure,
-												 len);
-					break;
-
-				default:
-					break;
-			}
-		}						/* end of inner message-processing loop */
-
-		/* Sleep until there's something to do */
-#ifndef WIN32
-		wr = WaitLatchOrSocket(MyLatch,
-							   WL_LATCH_SET | WL_POSTMASTER_DEATH | WL_SOCKET_READABLE,
-							   pgStatSock, -1L,
-							   WAIT_EVENT_PGSTAT_MAIN);
-#else
-
-		/*
-		 * Windows, at least in its Windows Server 2003 R2 incarnation,
-		 * sometimes loses FD_READ events.  Waking up and retrying the recv()
-		 * fixes that, so don't sleep indefinitely.  This is a crock of the
-		 * first water, but until somebody wants to debug exactly what's
-		 * happening there, this is the best we can do.  The two-second
-		 * timeout matches our pre-9.2 behavior, and needs to be short enough
-		 * to not provoke "using stale statistics" complaints from
-		 * backend_read_statsfile.
-		 */
-		wr = WaitLatchOrSocket(MyLatch,
-							   WL_LATCH_SET | WL_POSTMASTER_DEATH | WL_SOCKET_READABLE | WL_TIMEOUT,
-							   pgStatSock,
-							   2 * 1000L /* msec */ ,
-							   WAIT_EVENT_PGSTAT_MAIN);
-#endif
-
-		/*
-		 * Emergency bailout if postmaster has died.  This is to avoid the
-		 * necessity for manual cleanup of all postmaster children.
-		 */
-		if (wr & WL_POSTMASTER_DEATH)
-			break;
-	}							/* end of outer loop */
-
-	/*
-	 * Save the final stats to reuse at next startup.
-	 */
-	pgstat_write_statsfiles(true, true);
-
-	exit(0);
-}
 
 /*
  * Subroutine to clear stats in a database entry
- *
- * Tables and functions hashes are initialized to empty.
  */
 static void
 reset_dbentry_counters(PgStat_StatDBEntry *dbentry)
 {
-	HASHCTL		hash_ctl;
-
 	dbentry->n_xact_commit = 0;
 	dbentry->n_xact_rollback = 0;
 	dbentry->n_blocks_fetched = 0;
@@ -4742,48 +4569,33 @@ reset_dbentry_counters(PgStat_StatDBEntry *dbentry)
 	dbentry->n_block_write_time = 0;
 
 	dbentry->stat_reset_timestamp = GetCurrentTimestamp();
-	dbentry->stats_timestamp = 0;
-
-	memset(&hash_ctl, 0, sizeof(hash_ctl));
-	hash_ctl.keysize = sizeof(Oid);
-	hash_ctl.entrysize = sizeof(PgStat_StatTabEntry);
-	dbentry->tables = hash_create("Per-database table",
-								  PGSTAT_TAB_HASH_SIZE,
-								  &hash_ctl,
-								  HASH_ELEM | HASH_BLOBS);
-
-	hash_ctl.keysize = sizeof(Oid);
-	hash_ctl.entrysize = sizeof(PgStat_StatFuncEntry);
-	dbentry->functions = hash_create("Per-database function",
-									 PGSTAT_FUNCTION_HASH_SIZE,
-									 &hash_ctl,
-									 HASH_ELEM | HASH_BLOBS);
 }
 
 /*
- * Lookup the hash table entry for the specified database. If no hash
+ * Lookup the shared hash table entry for the specified database. If no hash
  * table entry exists, initialize it, if the create parameter is true.
  * Else, return NULL.
+ *
+ * The entry is returned locked exclusively; release it with
+ * dshash_release_lock(pgStatSharedDBHash, entry).
  */
 static PgStat_StatDBEntry *
 pgstat_get_db_entry(Oid databaseid, bool create)
 {
 	PgStat_StatDBEntry *result;
 	bool		found;
-	HASHACTION	action = (create ? HASH_ENTER : HASH_FIND);
 
-	/* Lookup or create the hash table entry for this database */
-	result = (PgStat_StatDBEntry *) hash_search(pgStatDBHash,
-												&databaseid,
-												action, &found);
+	pgstat_attach_shmem();
 
-	if (!create && !found)
-		return NULL;
+	if (!create)
+		return (PgStat_StatDBEntry *)
+			dshash_find(pgStatSharedDBHash, &databaseid, true);
 
-	/*
-	 * If not found, initialize the new one.  This creates empty hash tables
-	 * for tables and functions, too.
-	 */
+	/* Lookup or create the hash table entry for this database */
+	result = (PgStat_StatDBEntry *)
+		dshash_find_or_insert(pgStatSharedDBHash, &databaseid, &found);
+
+	/* If not found, initialize the new one. */
 	if (!found)
 		reset_dbentry_counters(result);
 
@@ -4792,80 +4604,125 @@ pgstat_get_db_entry(Oid databaseid, bool create)
 
 
 /*
- * Lookup the hash table entry for the specified table. If no hash
+ * Lookup the shared hash table entry for the specified table. If no hash
  * table entry exists, initialize it, if the create parameter is true.
  * Else, return NULL.
+ *
+ * The entry is returned locked exclusively; release it with
+ * dshash_release_lock(pgStatSharedTabHash, entry).
  */
-static PgStat_StatTabEntry *
-pgstat_get_tab_entry(PgStat_StatDBEntry *dbentry, Oid tableoid, bool create)
+static PgStat_SharedTabEntry *
+pgstat_get_tab_entry(Oid databaseid, Oid tableoid, bool create)
 {
-	PgStat_StatTabEntry *result;
+	PgStat_SharedTabEntry *result;
+	PgStat_StatObjKey key;
 	bool		found;
-	HASHACTION	action = (create ? HASH_ENTER : HASH_FIND);
 
-	/* Lookup or create the hash table entry for this table */
-	result = (PgStat_StatTabEntry *) hash_search(dbentry->tables,
-												 &tableoid,
-												 action, &found);
+	pgstat_attach_shmem();
 
-	if (!create && !found)
-		return NULL;
+	key.databaseid = databaseid;
+	key.objectid = tableoid;
+
+	if (!create)
+		return (PgStat_SharedTabEntry *)
+			dshash_find(pgStatSharedTabHash, &key, true);
+
+	/* Lookup or create the hash table entry for this table */
+	result = (PgStat_SharedTabEntry *)
+		dshash_find_or_insert(pgStatSharedTabHash, &key, &found);
 
 	/* If not found, initialize the new one. */
 	if (!found)
 	{
-		result->numscans = 0;
-		result->tuples_returned = 0;
-		result->tuples_fetched = 0;
-		result->tuples_inserted = 0;
-		result->tuples_updated = 0;
-		result->tuples_deleted = 0;
-		result->tuples_hot_updated = 0;
-		result->n_live_tuples = 0;
-		result->n_dead_tuples = 0;
-		result->changes_since_analyze = 0;
-		result->inserts_since_vacuum = 0;
-		result->blocks_fetched = 0;
-		result->blocks_hit = 0;
-		result->vacuum_timestamp = 0;
-		result->vacuum_count = 0;
-		result->autovac_vacuum_timestamp = 0;
-		result->autovac_vacuum_count = 0;
-		result->analyze_timestamp = 0;
-		result->analyze_count = 0;
-		result->autovac_analyze_timestamp = 0;
-		result->autovac_analyze_count = 0;
+		result->stats.tableid = tableoid;
+		result->stats.numscans = 0;
+		result->stats.tuples_returned = 0;
+		result->stats.tuples_fetched = 0;
+		result->stats.tuples_inserted = 0;
+		result->stats.tuples_updated = 0;
+		result->stats.tuples_deleted = 0;
+		result->stats.tuples_hot_updated = 0;
+		result->stats.n_live_tuples = 0;
+		result->stats.n_dead_tuples = 0;
+		result->stats.changes_since_analyze = 0;
+		result->stats.inserts_since_vacuum = 0;
+		result->stats.blocks_fetched = 0;
+		result->stats.blocks_hit = 0;
+		result->stats.vacuum_timestamp = 0;
+		result->stats.vacuum_count = 0;
+		result->stats.autovac_vacuum_timestamp = 0;
+		result->stats.autovac_vacuum_count = 0;
+		result->stats.analyze_timestamp = 0;
+		result->stats.analyze_count = 0;
+		result->stats.autovac_analyze_timestamp = 0;
+		result->stats.autovac_analyze_count = 0;
 	}
 
 	return result;
 }
 
+/*
+ * Delete the shared table and function entries of a database.
+ */
+static void
+pgstat_drop_db_objects(Oid databaseid)
+{
+	dshash_seq_status hstat;
+	PgStat_SharedTabEntry *tabentry;
+	PgStat_SharedFuncEntry *funcentry;
+
+	pgstat_attach_shmem();
+
+	dshash_seq_init(&hstat, pgStatSharedTabHash, true);
+	while ((tabentry = (PgStat_SharedTabEntry *) dshash_seq_next(&hstat)) != NULL)
+	{
+		if (tabentry->key.databaseid == databaseid)
+			dshash_delete_current(&hstat);
+	}
+	dshash_seq_term(&hstat);
+
+	dshash_seq_init(&hstat, pgStatSharedFuncHash, true);
+	while ((funcentry = (PgStat_SharedFuncEntry *) dshash_seq_next(&hstat)) != NULL)
+	{
+		if (funcentry->key.databaseid == databaseid)
+			dshash_delete_current(&hstat);
+	}
+	dshash_seq_term(&hstat);
+}
+
 
 /* ----------
- * pgstat_write_statsfiles() -
- *		Write the global statistics file, as well as requested DB files.
+ * pgstat_write_statsfile() -
+ *		Write the shared statistics to the permanent stats file.
  *
- *	'permanent' specifies writing to the permanent files not temporary ones.
- *	When true (happens only when the collector is shutting down), also remove
- *	the temporary files so that backends starting up under a new postmaster
- *	can't read old data before the new collector is ready.
- *
- *	When 'allDbs' is false, only the requested databases (listed in
- *	pending_write_requests) will be written; otherwise, all databases
- *	will be written.
+ *	Called by the checkpointer when the server is shut down, after the
+ *	shutdown checkpoint, so that the statistics can be restored by
+ *	pgstat_restore_stats() at the next startup.
  * ----------
  */
-static void
-pgstat_write_statsfiles(bool permanent, bool allDbs)
+void
+pgstat_write_statsfile(void)
 {
-	HASH_SEQ_STATUS hstat;
+	dshash_seq_status hstat;
 	PgStat_StatDBEntry *dbentry;
+	PgStat_SharedTabEntry *tabentry;
+	PgStat_SharedFuncEntry *funcentry;
+	PgStat_GlobalStats globalbuf;
+	PgStat_ArchiverStats archiverbuf;
+	PgStat_SLRUStats slrubuf[SLRU_NUM_ELEMENTS];
+	PgStat_IOStats iobuf;
+	PgStat_WalFlushStats walflushbuf;
 	FILE	   *fpout;
 	int32		format_id;
-	const char *tmpfile = permanent ? PGSTAT_STAT_PERMANENT_TMPFILE : pgstat_stat_tmpname;
-	const char *statfile = permanent ? PGSTAT_STAT_PERMANENT_FILENAME : pgstat_stat_filename;
+	const char *tmpfile = PGSTAT_STAT_PERMANENT_TMPFILE;
+	const char *statfile = PGSTAT_STAT_PERMANENT_FILENAME;
 	int			rc;
 
+	if (!IsUnderPostmaster)
+		return;
+
+	pgstat_attach_shmem();
+
 	elog(DEBUG2, "writing stats file \"%s\"", statfile);
 
 	/*
@@ -4881,11 +4738,6 @@ pgstat_write_statsfiles(bool permanent, bool allDbs)
 		return;
 	}
 
-	/*
-	 * Set the timestamp of the stats file.
-	 */
-	globalStats.stats_timestamp = GetCurrentTimestamp();
-
 	/*
 	 * Write the file header --- currently just a format ID.
 	 */
@@ -4894,184 +4746,64 @@ pgstat_write_statsfiles(bool permanent, bool allDbs)
 	(void) rc;					/* we'll check for error with ferror */
 
 	/*
-	 * Write global stats struct
+	 * Write the global, archiver, SLRU, I/O and WAL flush stats structs.
 	 */
-	rc = fwrite(&globalStats, sizeof(globalStats), 1, fpout);
-	(void) rc;					/* we'll check for error with ferror */
+	SpinLockAcquire(&StatsShmem->mutex);
+	memcpy(&globalbuf, &StatsShmem->global_stats, sizeof(globalbuf));
+	memcpy(&archiverbuf, &StatsShmem->archiver_stats, sizeof(archiverbuf));
+	memcpy(slrubuf, StatsShmem->slru_stats, sizeof(slrubuf));
+	memcpy(&iobuf, &StatsShmem->io_stats, sizeof(iobuf));
+	memcpy(&walflushbuf, &StatsShmem->wal_flush_stats, sizeof(walflushbuf));
+	SpinLockRelease(&StatsShmem->mutex);
 
-	/*
-	 * Write archiver stats struct
-	 */
-	rc = fwrite(&archiverStats, sizeof(archiverStats), 1, fpout);
-	(void) rc;					/* we'll check for error with ferror */
+	globalbuf.stats_timestamp = GetCurrentTimestamp();
 
-	/*
-	 * Write SLRU stats struct
-	 */
-	rc = fwrite(slruStats, sizeof(slruStats), 1, fpout);
+	rc = fwrite(&globalbuf, sizeof(globalbuf), 1, fpout);
+	(void) rc;					/* we'll check for error with ferror */
+	rc = fwrite(&archiverbuf, sizeof(archiverbuf), 1, fpout);
+	(void) rc;					/* we'll check for error with ferror */
+	rc = fwrite(slrubuf, sizeof(slrubuf), 1, fpout);
+	(void) rc;					/* we'll check for error with ferror */
+	rc = fwrite(&iobuf, sizeof(iobuf), 1, fpout);
+	(void) rc;					/* we'll check for error with ferror */
+	rc = fwrite(&walflushbuf, sizeof(walflushbuf), 1, fpout);
 	(void) rc;					/* we'll check for error with ferror */
 
 	/*
 	 * Walk through the database table.
 	 */
-	hash_seq_init(&hstat, pgStatDBHash);
-	while ((dbentry = (PgStat_StatDBEntry *) hash_seq_search(&hstat)) != NULL)
+	dshash_seq_init(&hstat, pgStatSharedDBHash, false);
+	while ((dbentry = (PgStat_StatDBEntry *) dshash_seq_next(&hstat)) != NULL)
 	{
-		/*
-		 * Write out the table and function stats for this DB into the
-		 * appropriate per-DB stat file, if required.
-		 */
-		if (allDbs || pgstat_db_requested(dbentry->databaseid))
-		{
-			/* Make DB's timestamp consistent with the global stats */
-			dbentry->stats_timestamp = globalStats.stats_timestamp;
-
-			pgstat_write_db_statsfile(dbentry, permanent);
-		}
-
-		/*
-		 * Write out the DB entry. We don't write the tables or functions
-		 * pointers, since they're of no use to any other process.
-		 */
 		fputc('D', fpout);
-		rc = fwrite(dbentry, offsetof(PgStat_StatDBEntry, tables), 1, fpout);
+		rc = fwrite(dbentry, sizeof(PgStat_StatDBEntry), 1, fpout);
 		(void) rc;				/* we'll check for error with ferror */
 	}
+	dshash_seq_term(&hstat);
 
 	/*
-	 * No more output to be done. Close the temp file and replace the old
-	 * pgstat.stat with it.  The ferror() check replaces testing for error
-	 * after each individual fputc or fwrite above.
-	 */
-	fputc('E', fpout);
-
-	if (ferror(fpout))
-	{
-		ereport(LOG,
-				(errcode_for_file_access(),
-				 errmsg("could not write temporary statistics file \"%s\": %m",
-						tmpfile)));
-		FreeFile(fpout);
-		unlink(tmpfile);
-	}
-	else if (FreeFile(fpout) < 0)
-	{
-		ereport(LOG,
-				(errcode_for_file_access(),
-				 errmsg("could not close temporary statistics file \"%s\": %m",
-						tmpfile)));
-		unlink(tmpfile);
-	}
-	else if (rename(tmpfile, statfile) < 0)
-	{
-		ereport(LOG,
-				(errcode_for_file_access(),
-				 errmsg("could not rename temporary statistics file \"%s\" to \"%s\": %m",
-						tmpfile, statfile)));
-		unlink(tmpfile);
-	}
-
-	if (permanent)
-		unlink(pgstat_stat_filename);
-
-	/*
-	 * Now throw away the list of requests.  Note that requests sent after we
-	 * started the write are still waiting on the network socket.
-	 */
-	list_free(pending_write_requests);
-	pending_write_requests = NIL;
-}
-
-/*
- * return the filename for a DB stat file; filename is the output buffer,
- * of length len.
- */
-static void
-get_dbstat_filename(bool permanent, bool tempname, Oid databaseid,
-					char *filename, int len)
-{
-	int			printed;
-
-	/* NB -- pgstat_reset_remove_files knows about the pattern this uses */
-	printed = snprintf(filename, len, "%s/db_%u.%s",
-					   permanent ? PGSTAT_STAT_PERMANENT_DIRECTORY :
-					   pgstat_stat_directory,
-					   databaseid,
-					   tempname ? "tmp" : "stat");
-	if (printed >= len)
-		elog(ERROR, "overlength pgstat path");
-}
-
-/* ----------
- * pgstat_write_db_statsfile() -
- *		Write the stat file for a single database.
- *
- *	If writing to the permanent file (happens when the collector is
- *	shutting down only), remove the temporary file so that backends
- *	starting up under a new postmaster can't read the old data before
- *	the new collector is ready.
- * ----------
- */
-static void
-pgstat_write_db_statsfile(PgStat_StatDBEntry *dbentry, bool permanent)
-{
-	HASH_SEQ_STATUS tstat;
-	HASH_SEQ_STATUS fstat;
-	PgStat_StatTabEntry *tabentry;
-	PgStat_StatFuncEntry *funcentry;
-	FILE	   *fpout;
-	int32		format_id;
-	Oid			dbid = dbentry->databaseid;
-	int			rc;
-	char		tmpfile[MAXPGPATH];
-	char		statfile[MAXPGPATH];
-
-	get_dbstat_filename(permanent, true, dbid, tmpfile, MAXPGPATH);
-	get_dbstat_filename(permanent, false, dbid, statfile, MAXPGPATH);
-
-	elog(DEBUG2, "writing stats file \"%s\"", statfile);
-
-	/*
-	 * Open the statistics temp file to write out the current values.
-	 */
-	fpout = AllocateFile(tmpfile, PG_BINARY_W);
-	if (fpout == NULL)
-	{
-		ereport(LOG,
-				(errcode_for_file_access(),
-				 errmsg("could not open temporary statistics file \"%s\": %m",
-						tmpfile)));
-		return;
-	}
-
-	/*
-	 * Write the file header --- currently just a format ID.
-	 */
-	format_id = PGSTAT_FILE_FORMAT_ID;
-	rc = fwrite(&format_id, sizeof(format_id), 1, fpout);
-	(void) rc;					/* we'll check for error with ferror */
-
-	/*
-	 * Walk through the database's access stats per table.
+	 * Walk through the access stats per table, of all databases.
 	 */
-	hash_seq_init(&tstat, dbentry->tables);
-	while ((tabentry = (PgStat_StatTabEntry *) hash_seq_search(&tstat)) != NULL)
+	dshash_seq_init(&hstat, pgStatSharedTabHash, false);
+	while ((tabentry = (PgStat_SharedTabEntry *) dshash_seq_next(&hstat)) != NULL)
 	{
 		fputc('T', fpout);
-		rc = fwrite(tabentry, sizeof(PgStat_StatTabEntry), 1, fpout);
+		rc = fwrite(tabentry, sizeof(PgStat_SharedTabEntry), 1, fpout);
 		(void) rc;				/* we'll check for error with ferror */
 	}
+	dshash_seq_term(&hstat);
 
 	/*
-	 * Walk through the database's function stats table.
+	 * Walk through the function stats, of all databases.
 	 */
-	hash_seq_init(&fstat, dbentry->functions);
-	while ((funcentry = (PgStat_StatFuncEntry *) hash_seq_search(&fstat)) != NULL)
+	dshash_seq_init(&hstat, pgStatSharedFuncHash, false);
+	while ((funcentry = (PgStat_SharedFuncEntry *) dshash_seq_next(&hstat)) != NULL)
 	{
 		fputc('F', fpout);
-		rc = fwrite(funcentry, sizeof(PgStat_StatFuncEntry), 1, fpout);
+		rc = fwrite(funcentry, sizeof(PgStat_SharedFuncEntry), 1, fpout);
 		(void) rc;				/* we'll check for error with ferror */
 	}
+	dshash_seq_term(&hstat);
 
 	/*
 	 * No more output to be done. Close the temp file and replace the old
@@ -5105,102 +4837,53 @@ pgstat_write_db_statsfile(PgStat_StatDBEntry *dbentry, bool permanent)
 						tmpfile, statfile)));
 		unlink(tmpfile);
 	}
-
-	if (permanent)
-	{
-		get_dbstat_filename(false, false, dbid, statfile, MAXPGPATH);
-
-		elog(DEBUG2, "removing temporary stats file \"%s\"", statfile);
-		unlink(statfile);
-	}
 }
 
 /* ----------
- * pgstat_read_statsfiles() -
- *
- *	Reads in some existing statistics collector files and returns the
- *	databases hash table that is the top level of the data.
+ * pgstat_restore_stats() -
  *
- *	If 'onlydb' is not InvalidOid, it means we only want data for that DB
- *	plus the shared catalogs ("DB 0").  We'll still populate the DB hash
- *	table for all databases, but we don't bother even creating table/function
- *	hash tables for other databases.
- *
- *	'permanent' specifies reading from the permanent files not temporary ones.
- *	When true (happens only when the collector is starting up), remove the
- *	files after reading; the in-memory status is now authoritative, and the
- *	files would be out of date in case somebody else reads them.
- *
- *	If a 'deep' read is requested, table/function stats are read, otherwise
- *	the table/function hash tables remain empty.
+ *	Load the statistics saved by pgstat_write_statsfile() into shared memory.
+ *	Called by the startup process, when no WAL recovery is needed.  The file
+ *	is removed afterwards; the shared-memory statistics are now
+ *	authoritative, and the file would be out of date if the server crashed.
  * ----------
  */
-static HTAB *
-pgstat_read_statsfiles(Oid onlydb, bool permanent, bool deep)
+void
+pgstat_restore_stats(void)
 {
-	PgStat_StatDBEntry *dbentry;
 	PgStat_StatDBEntry dbbuf;
-	HASHCTL		hash_ctl;
-	HTAB	   *dbhash;
+	PgStat_SharedTabEntry tabbuf;
+	PgStat_SharedFuncEntry funcbuf;
+	PgStat_GlobalStats globalbuf;
+	PgStat_ArchiverStats archiverbuf;
+	PgStat_SLRUStats slrubuf[SLRU_NUM_ELEMENTS];
+	PgStat_IOStats iobuf;
+	PgStat_WalFlushStats walflushbuf;
 	FILE	   *fpin;
 	int32		format_id;
 	bool		found;
-	const char *statfile = permanent ? PGSTAT_STAT_PERMANENT_FILENAME : pgstat_stat_filename;
-	int			i;
-
-	/*
-	 * The tables will live in pgStatLocalContext.
-	 */
-	pgstat_setup_memcxt();
-
-	/*
-	 * Create the DB hashtable
-	 */
-	memset(&hash_ctl, 0, sizeof(hash_ctl));
-	hash_ctl.keysize = sizeof(Oid);
-	hash_ctl.entrysize = sizeof(PgStat_StatDBEntry);
-	hash_ctl.hcxt = pgStatLocalContext;
-	dbhash = hash_create("Databases hash", PGSTAT_DB_HASH_SIZE, &hash_ctl,
-						 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	const char *statfile = PGSTAT_STAT_PERMANENT_FILENAME;
 
-	/*
-	 * Clear out global and archiver statistics so they start from zero in
-	 * case we can't load an existing statsfile.
-	 */
-	memset(&globalStats, 0, sizeof(globalStats));
-	memset(&archiverStats, 0, sizeof(archiverStats));
-	memset(&slruStats, 0, sizeof(slruStats));
+	if (!IsUnderPostmaster)
+		return;
 
-	/*
-	 * Set the current timestamp (will be kept only in case we can't load an
-	 * existing statsfile).
-	 */
-	globalStats.stat_reset_timestamp = GetCurrentTimestamp();
-	archiverStats.stat_reset_timestamp = globalStats.stat_reset_timestamp;
+	pgstat_attach_shmem();
 
 	/*
-	 * Set the same reset timestamp for all SLRU items too.
-	 */
-	for (i = 0; i < SLRU_NUM_ELEMENTS; i++)
-		slruStats[i].stat_reset_timestamp = globalStats.stat_reset_timestamp;
-
-	/*
-	 * Try to open the stats file. If it doesn't exist, the backends simply
-	 * return zero for anything and the collector simply starts from scratch
-	 * with empty counters.
+	 * Try to open the stats file. If it doesn't exist, we simply start from
+	 * scratch with empty counters.
 	 *
-	 * ENOENT is a possibility if the stats collector is not running or has
-	 * not yet written the stats file the first time.  Any other failure
-	 * condition is suspicious.
+	 * ENOENT is a possibility if the stats were discarded or the server was
+	 * not shut down cleanly.  Any other failure condition is suspicious.
 	 */
 	if ((fpin = AllocateFile(statfile, PG_BINARY_R)) == NULL)
 	{
 		if (errno != ENOENT)
-			ereport(pgStatRunningInCollector ? LOG : WARNING,
+			ereport(LOG,
 					(errcode_for_file_access(),
 					 errmsg("could not open statistics file \"%s\": %m",
 							statfile)));
-		return dbhash;
+		return;
 	}
 
 	/*
@@ -5209,57 +4892,36 @@ pgstat_read_statsfiles(Oid onlydb, bool permanent, bool deep)
 	if (fread(&format_id, 1, sizeof(format_id), fpin) != sizeof(format_id) ||
 		format_id != PGSTAT_FILE_FORMAT_ID)
 	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
+		ereport(LOG,
 				(errmsg("corrupted statistics file \"%s\"", statfile)));
 		goto done;
 	}
 
 	/*
-	 * Read global stats struct
+	 * Read the global, archiver, SLRU, I/O and WAL flush stats structs
 	 */
-	if (fread(&globalStats, 1, sizeof(globalStats), fpin) != sizeof(globalStats))
+	if (fread(&globalbuf, 1, sizeof(globalbuf), fpin) != sizeof(globalbuf) ||
+		fread(&archiverbuf, 1, sizeof(archiverbuf), fpin) != sizeof(archiverbuf) ||
+		fread(slrubuf, 1, sizeof(slrubuf), fpin) != sizeof(slrubuf) ||
+		fread(&iobuf, 1, sizeof(iobuf), fpin) != sizeof(iobuf) ||
+		fread(&walflushbuf, 1, sizeof(walflushbuf), fpin) != sizeof(walflushbuf))
 	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
+		ereport(LOG,
 				(errmsg("corrupted statistics file \"%s\"", statfile)));
-		memset(&globalStats, 0, sizeof(globalStats));
 		goto done;
 	}
 
-	/*
-	 * In the collector, disregard the timestamp we read from the permanent
-	 * stats file; we should be willing to write a temp stats file immediately
-	 * upon the first request from any backend.  This only matters if the old
-	 * file's timestamp is less than PGSTAT_STAT_INTERVAL ago, but that's not
-	 * an unusual scenario.
-	 */
-	if (pgStatRunningInCollector)
-		globalStats.stats_timestamp = 0;
-
-	/*
-	 * Read archiver stats struct
-	 */
-	if (fread(&archiverStats, 1, sizeof(archiverStats), fpin) != sizeof(archiverStats))
-	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
-				(errmsg("corrupted statistics file \"%s\"", statfile)));
-		memset(&archiverStats, 0, sizeof(archiverStats));
-		goto done;
-	}
+	SpinLockAcquire(&StatsShmem->mutex);
+	memcpy(&StatsShmem->global_stats, &globalbuf, sizeof(globalbuf));
+	memcpy(&StatsShmem->archiver_stats, &archiverbuf, sizeof(archiverbuf));
+	memcpy(StatsShmem->slru_stats, slrubuf, sizeof(slrubuf));
+	memcpy(&StatsShmem->io_stats, &iobuf, sizeof(iobuf));
+	memcpy(&StatsShmem->wal_flush_stats, &walflushbuf, sizeof(walflushbuf));
+	SpinLockRelease(&StatsShmem->mutex);
 
 	/*
-	 * Read SLRU stats struct
-	 */
-	if (fread(slruStats, 1, sizeof(slruStats), fpin) != sizeof(slruStats))
-	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
-				(errmsg("corrupted statistics file \"%s\"", statfile)));
-		memset(&slruStats, 0, sizeof(slruStats));
-		goto done;
-	}
-
-	/*
-	 * We found an existing collector stats file. Read it and put all the
-	 * hashtable entries into place.
+	 * We found an existing stats file. Read it and put all the hashtable
+	 * entries into place.
 	 */
 	for (;;)
 	{
@@ -5270,399 +4932,105 @@ pgstat_read_statsfiles(Oid onlydb, bool permanent, bool deep)
 				 * follows.
 				 */
 			case 'D':
-				if (fread(&dbbuf, 1, offsetof(PgStat_StatDBEntry, tables),
-						  fpin) != offsetof(PgStat_StatDBEntry, tables))
-				{
-					ereport(pgStatRunningInCollector ? LOG : WARNING,
-							(errmsg("corrupted statistics file \"%s\"",
-									statfile)));
-					goto done;
-				}
-
-				/*
-				 * Add to the DB hash
-				 */
-				dbentry = (PgStat_StatDBEntry *) hash_search(dbhash,
-															 (void *) &dbbuf.databaseid,
-															 HASH_ENTER,
-															 &found);
-				if (found)
-				{
-					ereport(pgStatRunningInCollector ? LOG : WARNING,
-							(errmsg("corrupted statistics file \"%s\"",
-									statfile)));
-					goto done;
-				}
-
-				memcpy(dbentry, &dbbuf, sizeof(PgStat_StatDBEntry));
-				dbentry->tables = NULL;
-				dbentry->functions = NULL;
-
-				/*
-				 * In the collector, disregard the timestamp we read from the
-				 * permanent stats file; we should be willing to write a temp
-				 * stats file immediately upon the first request from any
-				 * backend.
-				 */
-				if (pgStatRunningInCollector)
-					dbentry->stats_timestamp = 0;
-
-				/*
-				 * Don't create tables/functions hashtables for uninteresting
-				 * databases.
-				 */
-				if (onlydb != InvalidOid)
 				{
-					if (dbbuf.databaseid != onlydb &&
-						dbbuf.databaseid != InvalidOid)
-						break;
-				}
-
-				memset(&hash_ctl, 0, sizeof(hash_ctl));
-				hash_ctl.keysize = sizeof(Oid);
-				hash_ctl.entrysize = sizeof(PgStat_StatTabEntry);
-				hash_ctl.hcxt = pgStatLocalContext;
-				dbentry->tables = hash_create("Per-database table",
-											  PGSTAT_TAB_HASH_SIZE,
-											  &hash_ctl,
-											  HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
-
-				hash_ctl.keysize = sizeof(Oid);
-				hash_ctl.entrysize = sizeof(PgStat_StatFuncEntry);
-				hash_ctl.hcxt = pgStatLocalContext;
-				dbentry->functions = hash_create("Per-database function",
-												 PGSTAT_FUNCTION_HASH_SIZE,
-												 &hash_ctl,
-												 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
-
-				/*
-				 * If requested, read the data from the database-specific
-				 * file.  Otherwise we just leave the hashtables empty.
-				 */
-				if (deep)
-					pgstat_read_db_statsfile(dbentry->databaseid,
-											 dbentry->tables,
-											 dbentry->functions,
-											 permanent);
-
-				break;
-
-			case 'E':
-				goto done;
-
-			default:
-				ereport(pgStatRunningInCollector ? LOG : WARNING,
-						(errmsg("corrupted statistics file \"%s\"",
-								statfile)));
-				goto done;
-		}
-	}
-
-done:
-	FreeFile(fpin);
-
-	/* If requested to read the permanent file, also get rid of it. */
-	if (permanent)
-	{
-		elog(DEBUG2, "removing permanent stats file \"%s\"", statfile);
-		unlink(statfile);
-	}
-
-	return dbhash;
-}
+					PgStat_StatDBEntry *dbentry;
 
+					if (fread(&dbbuf, 1, sizeof(dbbuf), fpin) != sizeof(dbbuf))
+					{
+						ereport(LOG,
+								(errmsg("corrupted statistics file \"%s\"",
+										statfile)));
+						goto done;
+					}
 
-/* ----------
- * pgstat_read_db_statsfile() -
- *
- *	Reads in the existing statistics collector file for the given database,
- *	filling the passed-in tables and functions hash tables.
- *
- *	As in pgstat_read_statsfiles, if the permanent file is requested, it is
- *	removed after reading.
- *
- *	Note: this code has the ability to skip storing per-table or per-function
- *	data, if NULL is passed for the corresponding hashtable.  That's not used
- *	at the moment though.
- * ----------
- */
-static void
-pgstat_read_db_statsfile(Oid databaseid, HTAB *tabhash, HTAB *funchash,
-						 bool permanent)
-{
-	PgStat_StatTabEntry *tabentry;
-	PgStat_StatTabEntry tabbuf;
-	PgStat_StatFuncEntry funcbuf;
-	PgStat_StatFuncEntry *funcentry;
-	FILE	   *fpin;
-	int32		format_id;
-	bool		found;
-	char		statfile[MAXPGPATH];
-
-	get_dbstat_filename(permanent, false, databaseid, statfile, MAXPGPATH);
-
-	/*
-	 * Try to open the stats file. If it doesn't exist, the backends simply
-	 * return zero for anything and the collector simply starts from scratch
-	 * with empty counters.
-	 *
-	 * ENOENT is a possibility if the stats collector is not running or has
-	 * not yet written the stats file the first time.  Any other failure
-	 * condition is suspicious.
-	 */
-	if ((fpin = AllocateFile(statfile, PG_BINARY_R)) == NULL)
-	{
-		if (errno != ENOENT)
-			ereport(pgStatRunningInCollector ? LOG : WARNING,
-					(errcode_for_file_access(),
-					 errmsg("could not open statistics file \"%s\": %m",
-							statfile)));
-		return;
-	}
-
-	/*
-	 * Verify it's of the expected format.
-	 */
-	if (fread(&format_id, 1, sizeof(format_id), fpin) != sizeof(format_id) ||
-		format_id != PGSTAT_FILE_FORMAT_ID)
-	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
-				(errmsg("corrupted statistics file \"%s\"", statfile)));
-		goto done;
-	}
-
-	/*
-	 * We found an existing collector stats file. Read it and put all the
-	 * hashtable entries into place.
-	 */
-	for (;;)
-	{
-		switch (fgetc(fpin))
-		{
-				/*
-				 * 'T'	A PgStat_StatTabEntry follows.
-				 */
-			case 'T':
-				if (fread(&tabbuf, 1, sizeof(PgStat_StatTabEntry),
-						  fpin) != sizeof(PgStat_StatTabEntry))
-				{
-					ereport(pgStatRunningInCollector ? LOG : WARNING,
-							(errmsg("corrupted statistics file \"%s\"",
-									statfile)));
-					goto done;
-				}
-
-				/*
-				 * Skip if table data not wanted.
-				 */
-				if (tabhash == NULL)
+					dbentry = (PgStat_StatDBEntry *)
+						dshash_find_or_insert(pgStatSharedDBHash,
+											  &dbbuf.databaseid, &found);
+					if (!found)
+						memcpy(dbentry, &dbbuf, sizeof(dbbuf));
+					dshash_release_lock(pgStatSharedDBHash, dbentry);
+					if (found)
+					{
+						ereport(LOG,
+								(errmsg("corrupted statistics file \"%s\"",
+										statfile)));
+						goto done;
+					}
 					break;
-
-				tabentry = (PgStat_StatTabEntry *) hash_search(tabhash,
-															   (void *) &tabbuf.tableid,
-															   HASH_ENTER, &found);
-
-				if (found)
-				{
-					ereport(pgStatRunningInCollector ? LOG : WARNING,
-							(errmsg("corrupted statistics file \"%s\"",
-									statfile)));
-					goto done;
 				}
 
-				memcpy(tabentry, &tabbuf, sizeof(tabbuf));
-				break;
-
 				/*
-				 * 'F'	A PgStat_StatFuncEntry follows.
+				 * 'T'	A PgStat_SharedTabEntry follows.
 				 */
-			case 'F':
-				if (fread(&funcbuf, 1, sizeof(PgStat_StatFuncEntry),
-						  fpin) != sizeof(PgStat_StatFuncEntry))
-				{
-					ereport(pgStatRunningInCollector ? LOG : WARNING,
-							(errmsg("corrupted statistics file \"%s\"",
-									statfile)));
-					goto done;
-				}
-
-				/*
-				 * Skip if function data not wanted.
-				 */
-				if (funchash == NULL)
-					break;
-
-				funcentry = (PgStat_StatFuncEntry *) hash_search(funchash,
-																 (void *) &funcbuf.functionid,
-																 HASH_ENTER, &found);
-
-				if (found)
+			case 'T':
 				{
-					ereport(pgStatRunningInCollector ? LOG : WARNING,
-							(errmsg("corrupted statistics file \"%s\"",
-									statfile)));
-					goto done;
-				}
-
-				memcpy(funcentry, &funcbuf, sizeof(funcbuf));
-				break;
-
-				/*
-				 * 'E'	The EOF marker of a complete stats file.
-				 */
-			case 'E':
-				goto done;
+					PgStat_SharedTabEntry *tabentry;
 
-			default:
-				ereport(pgStatRunningInCollector ? LOG : WARNING,
-						(errmsg("corrupted statistics file \"%s\"",
-								statfile)));
-				goto done;
-		}
-	}
-
-done:
-	FreeFile(fpin);
-
-	if (permanent)
-	{
-		elog(DEBUG2, "removing permanent stats file \"%s\"", statfile);
-		unlink(statfile);
-	}
-}
-
-/* ----------
- * pgstat_read_db_statsfile_timestamp() -
- *
- *	Attempt to determine the timestamp of the last db statfile write.
- *	Returns true if successful; the timestamp is stored in *ts.
- *
- *	This needs to be careful about handling databases for which no stats file
- *	exists, such as databases without a stat entry or those not yet written:
- *
- *	- if there's a database entry in the global file, return the corresponding
- *	stats_timestamp value.
- *
- *	- if there's no db stat entry (e.g. for a new or inactive database),
- *	there's no stats_timestamp value, but also nothing to write so we return
- *	the timestamp of the global statfile.
- * ----------
- */
-static bool
-pgstat_read_db_statsfile_timestamp(Oid databaseid, bool permanent,
-								   TimestampTz *ts)
-{
-	PgStat_StatDBEntry dbentry;
-	PgStat_GlobalStats myGlobalStats;
-	PgStat_ArchiverStats myArchiverStats;
-	PgStat_SLRUStats mySLRUStats[SLRU_NUM_ELEMENTS];
-	FILE	   *fpin;
-	int32		format_id;
-	const char *statfile = permanent ? PGSTAT_STAT_PERMANENT_FILENAME : pgstat_stat_filename;
-
-	/*
-	 * Try to open the stats file.  As above, anything but ENOENT is worthy of
-	 * complaining about.
-	 */
-	if ((fpin = AllocateFile(statfile, PG_BINARY_R)) == NULL)
-	{
-		if (errno != ENOENT)
-			ereport(pgStatRunningInCollector ? LOG : WARNING,
-					(errcode_for_file_access(),
-					 errmsg("could not open statistics file \"%s\": %m",
-							statfile)));
-		return false;
-	}
-
-	/*
-	 * Verify it's of the expected format.
-	 */
-	if (fread(&format_id, 1, sizeof(format_id), fpin) != sizeof(format_id) ||
-		format_id != PGSTAT_FILE_FORMAT_ID)
-	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
-				(errmsg("corrupted statistics file \"%s\"", statfile)));
-		FreeFile(fpin);
-		return false;
-	}
-
-	/*
-	 * Read global stats struct
-	 */
-	if (fread(&myGlobalStats, 1, sizeof(myGlobalStats),
-			  fpin) != sizeof(myGlobalStats))
-	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
-				(errmsg("corrupted statistics file \"%s\"", statfile)));
-		FreeFile(fpin);
-		return false;
-	}
-
-	/*
-	 * Read archiver stats struct
-	 */
-	if (fread(&myArchiverStats, 1, sizeof(myArchiverStats),
-			  fpin) != sizeof(myArchiverStats))
-	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
-				(errmsg("corrupted statistics file \"%s\"", statfile)));
-		FreeFile(fpin);
-		return false;
-	}
-
-	/*
-	 * Read SLRU stats struct
-	 */
-	if (fread(mySLRUStats, 1, sizeof(mySLRUStats), fpin) != sizeof(mySLRUStats))
-	{
-		ereport(pgStatRunningInCollector ? LOG : WARNING,
-				(errmsg("corrupted statistics file \"%s\"", statfile)));
-		FreeFile(fpin);
-		return false;
-	}
-
-	/* By default, we're going to return the timestamp of the global file. */
-	*ts = myGlobalStats.stats_timestamp;
+					if (fread(&tabbuf, 1, sizeof(tabbuf), fpin) != sizeof(tabbuf))
+					{
+						ereport(LOG,
+								(errmsg("corrupted statistics file \"%s\"",
+										statfile)));
+						goto done;
+					}
 
-	/*
-	 * We found an existing collector stats file.  Read it and look for a
-	 * record for the requested database.  If found, use its timestamp.
-	 */
-	for (;;)
-	{
-		switch (fgetc(fpin))
-		{
-				/*
-				 * 'D'	A PgStat_StatDBEntry struct describing a database
-				 * follows.
-				 */
-			case 'D':
-				if (fread(&dbentry, 1, offsetof(PgStat_StatDBEntry, tables),
-						  fpin) != offsetof(PgStat_StatDBEntry, tables))
-				{
-					ereport(pgStatRunningInCollector ? LOG : WARNING,
-							(errmsg("corrupted statistics file \"%s\"",
-									statfile)));
-					goto done;
+					tabentry = (PgStat_SharedTabEntry *)
+						dshash_find_or_insert(pgStatSharedTabHash,
+											  &tabbuf.key, &found);
+					if (!found)
+						memcpy(&tabentry->stats, &tabbuf.stats,
+							   sizeof(PgStat_StatTabEntry));
+					dshash_release_lock(pgStatSharedTabHash, tabentry);
+					if (found)
+					{
+						ereport(LOG,
+								(errmsg("corrupted statistics file \"%s\"",
+										statfile)));
+						goto done;
+					}
+					break;
 				}
 
 				/*
-				 * If this is the DB we're looking for, save its timestamp and
-				 * we're done.
+				 * 'F'	A PgStat_SharedFuncEntry follows.
 				 */
-				if (dbentry.databaseid == databaseid)
+			case 'F':
 				{
-					*ts = dbentry.stats_timestamp;
-					goto done;
-				}
+					PgStat_SharedFuncEntry *funcentry;
 
-				break;
+					if (fread(&funcbuf, 1, sizeof(funcbuf), fpin) != sizeof(funcbuf))
+					{
+						ereport(LOG,
+								(errmsg("corrupted statistics file \"%s\"",
+										statfile)));
+						goto done;
+					}
+
+					funcentry = (PgStat_SharedFuncEntry *)
+						dshash_find_or_insert(pgStatSharedFuncHash,
+											  &funcbuf.key, &found);
+					if (!found)
+						memcpy(&funcentry->stats, &funcbuf.stats,
+							   sizeof(PgStat_StatFuncEntry));
+					dshash_release_lock(pgStatSharedFuncHash, funcentry);
+					if (found)
+					{
+						ereport(LOG,
+								(errmsg("corrupted statistics file \"%s\"",
+										statfile)));
+						goto done;
+					}
+					break;
+				}
 
+				/*
+				 * 'E'	The EOF marker of a complete stats file.
+				 */
 			case 'E':
 				goto done;
 
 			default:
-				ereport(pgStatRunningInCollector ? LOG : WARNING,
+				ereport(LOG,
 						(errmsg("corrupted statistics file \"%s\"",
 								statfile)));
 				goto done;
@@ -5671,142 +5039,11 @@ pgstat_read_db_statsfile_timestamp(Oid databaseid, bool permanent,
 
 done:
 	FreeFile(fpin);
-	return true;
-}
-
-/*
- * If not already done, read the statistics collector stats file into
- * some hash tables.  The results will be kept until pgstat_clear_snapshot()
- * is called (typically, at end of transaction).
- */
-static void
-backend_read_statsfile(void)
-{
-	TimestampTz min_ts = 0;
-	TimestampTz ref_ts = 0;
-	Oid			inquiry_db;
-	int			count;
-
-	/* already read it? */
-	if (pgStatDBHash)
-		return;
-	Assert(!pgStatRunningInCollector);
-
-	/*
-	 * In a normal backend, we check staleness of the data for our own DB, and
-	 * so we send MyDatabaseId in inquiry messages.  In the autovac launcher,
-	 * check staleness of the shared-catalog data, and send InvalidOid in
-	 * inquiry messages so as not to force writing unnecessary data.
-	 */
-	if (IsAutoVacuumLauncherProcess())
-		inquiry_db = InvalidOid;
-	else
-		inquiry_db = MyDatabaseId;
-
-	/*
-	 * Loop until fresh enough stats file is available or we ran out of time.
-	 * The stats inquiry message is sent repeatedly in case collector drops
-	 * it; but not every single time, as that just swamps the collector.
-	 */
-	for (count = 0; count < PGSTAT_POLL_LOOP_COUNT; count++)
-	{
-		bool		ok;
-		TimestampTz file_ts = 0;
-		TimestampTz cur_ts;
-
-		CHECK_FOR_INTERRUPTS();
 
-		ok = pgstat_read_db_statsfile_timestamp(inquiry_db, false, &file_ts);
-
-		cur_ts = GetCurrentTimestamp();
-		/* Calculate min acceptable timestamp, if we didn't already */
-		if (count == 0 || cur_ts < ref_ts)
-		{
-			/*
-			 * We set the minimum acceptable timestamp to PGSTAT_STAT_INTERVAL
-			 * msec before now.  This indirectly ensures that the collector
-			 * needn't write the file more often than PGSTAT_STAT_INTERVAL. In
-			 * an autovacuum worker, however, we want a lower delay to avoid
-			 * using stale data, so we use PGSTAT_RETRY_DELAY (since the
-			 * number of workers is low, this shouldn't be a problem).
-			 *
-			 * We don't recompute min_ts after sleeping, except in the
-			 * unlikely case that cur_ts went backwards.  So we might end up
-			 * accepting a file a bit older than PGSTAT_STAT_INTERVAL.  In
-			 * practice that shouldn't happen, though, as long as the sleep
-			 * time is less than PGSTAT_STAT_INTERVAL; and we don't want to
-			 * tell the collector that our cutoff time is less than what we'd
-			 * actually accept.
-			 */
-			ref_ts = cur_ts;
-			if (IsAutoVacuumWorkerProcess())
-				min_ts = TimestampTzPlusMilliseconds(ref_ts,
-													 -PGSTAT_RETRY_DELAY);
-			else
-				min_ts = TimestampTzPlusMilliseconds(ref_ts,
-													 -PGSTAT_STAT_INTERVAL);
-		}
-
-		/*
-		 * If the file timestamp is actually newer than cur_ts, we must have
-		 * had a clock glitch (system time went backwards) or there is clock
-		 * skew between our processor and the stats collector's processor.
-		 * Accept the file, but send an inquiry message anyway to make
-		 * pgstat_recv_inquiry do a sanity check on the collector's time.
-		 */
-		if (ok && file_ts > cur_ts)
-		{
-			/*
-			 * A small amount of clock skew between processors isn't terribly
-			 * surprising, but a large difference is worth logging.  We
-			 * arbitrarily define "large" as 1000 msec.
-			 */
-			if (file_ts >= TimestampTzPlusMilliseconds(cur_ts, 1000))
-			{
-				char	   *filetime;
-				char	   *mytime;
-
-				/* Copy because timestamptz_to_str returns a static buffer */
-				filetime = pstrdup(timestamptz_to_str(file_ts));
-				mytime = pstrdup(timestamptz_to_str(cur_ts));
-				elog(LOG, "stats collector's time %s is later than backend local time %s",
-					 filetime, mytime);
-				pfree(filetime);
-				pfree(mytime);
-			}
-
-			pgstat_send_inquiry(cur_ts, min_ts, inquiry_db);
-			break;
-		}
-
-		/* Normal acceptance case: file is not older than cutoff time */
-		if (ok && file_ts >= min_ts)
-			break;
-
-		/* Not there or too old, so kick the collector and wait a bit */
-		if ((count % PGSTAT_INQ_LOOP_COUNT) == 0)
-			pgstat_send_inquiry(cur_ts, min_ts, inquiry_db);
-
-		pg_usleep(PGSTAT_RETRY_DELAY * 1000L);
-	}
-
-	if (count >= PGSTAT_POLL_LOOP_COUNT)
-		ereport(LOG,
-				(errmsg("using stale statistics instead of current ones "
-						"because stats collector is not responding")));
-
-	/*
-	 * Autovacuum launcher wants stats about all databases, but a shallow read
-	 * is sufficient.  Regular backends want a deep read for just the tables
-	 * they can see (MyDatabaseId + shared catalogs).
-	 */
-	if (IsAutoVacuumLauncherProcess())
-		pgStatDBHash = pgstat_read_statsfiles(InvalidOid, false, false);
-	else
-		pgStatDBHash = pgstat_read_statsfiles(MyDatabaseId, false, true);
+	elog(DEBUG2, "removing permanent stats file \"%s\"", statfile);
+	unlink(statfile);
 }
 
-
 /* ----------
  * pgstat_setup_memcxt() -
  *
@@ -5842,118 +5079,84 @@ pgstat_clear_snapshot(void)
 
 	/* Reset variables */
 	pgStatLocalContext = NULL;
-	pgStatDBHash = NULL;
+	pgStatSnapshotDBHash = NULL;
+	pgStatSnapshotTabHash = NULL;
+	pgStatSnapshotFuncHash = NULL;
+	have_global_snapshot = false;
 	localBackendStatusTable = NULL;
 	localNumBackends = 0;
 }
 
 
 /* ----------
- * pgstat_recv_inquiry() -
+ * pgstat_recv_tabstat() -
  *
- *	Process stat inquiry requests.
+ *	Count what the backend has done.
  * ----------
  */
 static void
-pgstat_recv_inquiry(PgStat_MsgInquiry *msg, int len)
+pgstat_recv_tabstat(PgStat_MsgTabstat *msg, int len)
 {
 	PgStat_StatDBEntry *dbentry;
-
-	elog(DEBUG2, "received inquiry for database %u", msg->databaseid);
+	PgStat_TableCounts totals;
+	int			i;
 
 	/*
-	 * If there's already a write request for this DB, there's nothing to do.
-	 *
-	 * Note that if a request is found, we return early and skip the below
-	 * check for clock skew.  This is okay, since the only way for a DB
-	 * request to be present in the list is that we have been here since the
-	 * last write round.  It seems sufficient to check for clock skew once per
-	 * write round.
+	 * Process all table entries in the message.  The per-table stats are
+	 * summed up here, and added to the per-database entry afterwards, so
+	 * that we don't lock entries of both hash tables at the same time.
 	 */
-	if (list_member_oid(pending_write_requests, msg->databaseid))
-		return;
+	memset(&totals, 0, sizeof(totals));
 
-	/*
-	 * Check to see if we last wrote this database at a time >= the requested
-	 * cutoff time.  If so, this is a stale request that was generated before
-	 * we updated the DB file, and we don't need to do so again.
-	 *
-	 * If the requestor's local clock time is older than stats_timestamp, we
-	 * should suspect a clock glitch, ie system time going backwards; though
-	 * the more likely explanation is just delayed message receipt.  It is
-	 * worth expending a GetCurrentTimestamp call to be sure, since a large
-	 * retreat in the system clock reading could otherwise cause us to neglect
-	 * to update the stats file for a long time.
-	 */
-	dbentry = pgstat_get_db_entry(msg->databaseid, false);
-	if (dbentry == NULL)
+	for (i = 0; i < msg->m_nentries; i++)
 	{
+		PgStat_TableEntry *tabmsg = &(msg->m_entry[i]);
+		PgStat_SharedTabEntry *shentry;
+		PgStat_StatTabEntry *tabentry;
+
+		shentry = pgstat_get_tab_entry(msg->m_databaseid, tabmsg->t_id, true);
+		tabentry = &shentry->stats;
+
 		/*
-		 * We have no data for this DB.  Enter a write request anyway so that
-		 * the global stats will get updated.  This is needed to prevent
-		 * backend_read_statsfile from waiting for data that we cannot supply,
-		 * in the case of a new DB that nobody has yet reported any stats for.
-		 * See the behavior of pgstat_read_db_statsfile_timestamp.
+		 * Add the values to the entry, which starts out with zeroes if it's
+		 * new.
 		 */
-	}
-	else if (msg->clock_time < dbentry->stats_timestamp)
-	{
-		TimestampTz cur_ts = GetCurrentTimestamp();
-
-		if (cur_ts < dbentry->stats_timestamp)
-		{
-			/*
-			 * Sure enough, time went backwards.  Force a new stats file write
-			 * to get back in sync; but first, log a complaint.
-			 */
-			char	   *writetime;
-			char	   *mytime;
-
-			/* Copy because timestamptz_to_str returns a static buffer */
-			writetime = pstrdup(timestamptz_to_str(dbentry->stats_timestamp));
-			mytime = pstrdup(timestamptz_to_str(cur_ts));
-			elog(LOG,
-				 "stats_timestamp %s is later than collector's time %s for database %u",
-				 writetime, mytime, dbentry->databaseid);
-			pfree(writetime);
-			pfree(mytime);
-		}
-		else
+		tabentry->numscans += tabmsg->t_counts.t_numscans;
+		tabentry->tuples_returned += tabmsg->t_counts.t_tuples_returned;
+		tabentry->tuples_fetched += tabmsg->t_counts.t_tuples_fetched;
+		tabentry->tuples_inserted += tabmsg->t_counts.t_tuples_inserted;
+		tabentry->tuples_updated += tabmsg->t_counts.t_tuples_updated;
+		tabentry->tuples_deleted += tabmsg->t_counts.t_tuples_deleted;
+		tabentry->tuples_hot_updated += tabmsg->t_counts.t_tuples_hot_updated;
+		/* If table was truncated, first reset the live/dead counters */
+		if (tabmsg->t_counts.t_truncated)
 		{
-			/*
-			 * Nope, it's just an old request.  Assuming msg's clock_time is
-			 * >= its cutoff_time, it must be stale, so we can ignore it.
-			 */
-			return;
+			tabentry->n_live_tuples = 0;
+			tabentry->n_dead_tuples = 0;
+			tabentry->inserts_since_vacuum = 0;
 		}
-	}
-	else if (msg->cutoff_time <= dbentry->stats_timestamp)
-	{
-		/* Stale request, ignore it */
-		return;
-	}
+		tabentry->n_live_tuples += tabmsg->t_counts.t_delta_live_tuples;
+		tabentry->n_dead_tuples += tabmsg->t_counts.t_delta_dead_tuples;
+		tabentry->changes_since_analyze += tabmsg->t_counts.t_changed_tuples;
+		tabentry->inserts_since_vacuum += tabmsg->t_counts.t_tuples_inserted;
+		tabentry->blocks_fetched += tabmsg->t_counts.t_blocks_fetched;
+		tabentry->blocks_hit += tabmsg->t_counts.t_blocks_hit;
 
-	/*
-	 * We need to write this DB, so create a request.
-	 */
-	pending_write_requests = lappend_oid(pending_write_requests,
-										 msg->databaseid);
-}
+		/* Clamp n_live_tuples in case of negative delta_live_tuples */
+		tabentry->n_live_tuples = Max(tabentry->n_live_tuples, 0);
+		/* Likewise for n_dead_tuples */
+		tabentry->n_dead_tuples = Max(tabentry->n_dead_tuples, 0);
 
+		dshash_release_lock(pgStatSharedTabHash, shentry);
 
-/* ----------
- * pgstat_recv_tabstat() -
- *
- *	Count what the backend has done.
- * ----------
- */
-static void
-pgstat_recv_tabstat(PgStat_MsgTabstat *msg, int len)
-{
-	PgStat_StatDBEntry *dbentry;
-	PgStat_StatTabEntry *tabentry;
-	int			i;
-	bool		found;
+		totals.t_tuples_returned += tabmsg->t_counts.t_tuples_returned;
+		totals.t_tuples_fetched += tabmsg->t_counts.t_tuples_fetched;
+		totals.t_tuples_inserted += tabmsg->t_counts.t_tuples_inserted;
+		totals.t_tuples_updated += tabmsg->t_counts.t_tuples_updated;
+		totals.t_tuples_deleted += tabmsg->t_counts.t_tuples_deleted;
+		totals.t_blocks_fetched += tabmsg->t_counts.t_blocks_fetched;
+		totals.t_blocks_hit += tabmsg->t_counts.t_blocks_hit;
+	}
 
 	dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
 
@@ -5966,88 +5169,17 @@ pgstat_recv_tabstat(PgStat_MsgTabstat *msg, int len)
 	dbentry->n_block_write_time += msg->m_block_write_time;
 
 	/*
-	 * Process all table entries in the message.
+	 * Add per-table stats to the per-database entry, too.
 	 */
-	for (i = 0; i < msg->m_nentries; i++)
-	{
-		PgStat_TableEntry *tabmsg = &(msg->m_entry[i]);
-
-		tabentry = (PgStat_StatTabEntry *) hash_search(dbentry->tables,
-													   (void *) &(tabmsg->t_id),
-													   HASH_ENTER, &found);
-
-		if (!found)
-		{
-			/*
-			 * If it's a new table entry, initialize counters to the values we
-			 * just got.
-			 */
-			tabentry->numscans = tabmsg->t_counts.t_numscans;
-			tabentry->tuples_returned = tabmsg->t_counts.t_tuples_returned;
-			tabentry->tuples_fetched = tabmsg->t_counts.t_tuples_fetched;
-			tabentry->tuples_inserted = tabmsg->t_counts.t_tuples_inserted;
-			tabentry->tuples_updated = tabmsg->t_counts.t_tuples_updated;
-			tabentry->tuples_deleted = tabmsg->t_counts.t_tuples_deleted;
-			tabentry->tuples_hot_updated = tabmsg->t_counts.t_tuples_hot_updated;
-			tabentry->n_live_tuples = tabmsg->t_counts.t_delta_live_tuples;
-			tabentry->n_dead_tuples = tabmsg->t_counts.t_delta_dead_tuples;
-			tabentry->changes_since_analyze = tabmsg->t_counts.t_changed_tuples;
-			tabentry->inserts_since_vacuum = tabmsg->t_counts.t_tuples_inserted;
-			tabentry->blocks_fetched = tabmsg->t_counts.t_blocks_fetched;
-			tabentry->blocks_hit = tabmsg->t_counts.t_blocks_hit;
-
-			tabentry->vacuum_timestamp = 0;
-			tabentry->vacuum_count = 0;
-			tabentry->autovac_vacuum_timestamp = 0;
-			tabentry->autovac_vacuum_count = 0;
-			tabentry->analyze_timestamp = 0;
-			tabentry->analyze_count = 0;
-			tabentry->autovac_analyze_timestamp = 0;
-			tabentry->autovac_analyze_count = 0;
-		}
-		else
-		{
-			/*
-			 * Otherwise add the values to the existing entry.
-			 */
-			tabentry->numscans += tabmsg->t_counts.t_numscans;
-			tabentry->tuples_returned += tabmsg->t_counts.t_tuples_returned;
-			tabentry->tuples_fetched += tabmsg->t_counts.t_tuples_fetched;
-			tabentry->tuples_inserted += tabmsg->t_counts.t_tuples_inserted;
-			tabentry->tuples_updated += tabmsg->t_counts.t_tuples_updated;
-			tabentry->tuples_deleted += tabmsg->t_counts.t_tuples_deleted;
-			tabentry->tuples_hot_updated += tabmsg->t_counts.t_tuples_hot_updated;
-			/* If table was truncated, first reset the live/dead counters */
-			if (tabmsg->t_counts.t_truncated)
-			{
-				tabentry->n_live_tuples = 0;
-				tabentry->n_dead_tuples = 0;
-				tabentry->inserts_since_vacuum = 0;
-			}
-			tabentry->n_live_tuples += tabmsg->t_counts.t_delta_live_tuples;
-			tabentry->n_dead_tuples += tabmsg->t_counts.t_delta_dead_tuples;
-			tabentry->changes_since_analyze += tabmsg->t_counts.t_changed_tuples;
-			tabentry->inserts_since_vacuum += tabmsg->t_counts.t_tuples_inserted;
-			tabentry->blocks_fetched += tabmsg->t_counts.t_blocks_fetched;
-			tabentry->blocks_hit += tabmsg->t_counts.t_blocks_hit;
-		}
-
-		/* Clamp n_live_tuples in case of negative delta_live_tuples */
-		tabentry->n_live_tuples = Max(tabentry->n_live_tuples, 0);
-		/* Likewise for n_dead_tuples */
-		tabentry->n_dead_tuples = Max(tabentry->n_dead_tuples, 0);
+	dbentry->n_tuples_returned += totals.t_tuples_returned;
+	dbentry->n_tuples_fetched += totals.t_tuples_fetched;
+	dbentry->n_tuples_inserted += totals.t_tuples_inserted;
+	dbentry->n_tuples_updated += totals.t_tuples_updated;
+	dbentry->n_tuples_deleted += totals.t_tuples_deleted;
+	dbentry->n_blocks_fetched += totals.t_blocks_fetched;
+	dbentry->n_blocks_hit += totals.t_blocks_hit;
 
-		/*
-		 * Add per-table stats to the per-database entry, too.
-		 */
-		dbentry->n_tuples_returned += tabmsg->t_counts.t_tuples_returned;
-		dbentry->n_tuples_fetched += tabmsg->t_counts.t_tuples_fetched;
-		dbentry->n_tuples_inserted += tabmsg->t_counts.t_tuples_inserted;
-		dbentry->n_tuples_updated += tabmsg->t_counts.t_tuples_updated;
-		dbentry->n_tuples_deleted += tabmsg->t_counts.t_tuples_deleted;
-		dbentry->n_blocks_fetched += tabmsg->t_counts.t_blocks_fetched;
-		dbentry->n_blocks_hit += tabmsg->t_counts.t_blocks_hit;
-	}
+	dshash_release_lock(pgStatSharedDBHash, dbentry);
 }
 
 
@@ -6060,26 +5192,20 @@ pgstat_recv_tabstat(PgStat_MsgTabstat *msg, int len)
 static void
 pgstat_recv_tabpurge(PgStat_MsgTabpurge *msg, int len)
 {
-	PgStat_StatDBEntry *dbentry;
+	PgStat_StatObjKey key;
 	int			i;
 
-	dbentry = pgstat_get_db_entry(msg->m_databaseid, false);
-
-	/*
-	 * No need to purge if we don't even know the database.
-	 */
-	if (!dbentry || !dbentry->tables)
-		return;
+	pgstat_attach_shmem();
 
 	/*
 	 * Process all table entries in the message.
 	 */
+	key.databaseid = msg->m_databaseid;
 	for (i = 0; i < msg->m_nentries; i++)
 	{
 		/* Remove from hashtable if present; we don't care if it's not. */
-		(void) hash_search(dbentry->tables,
-						   (void *) &(msg->m_tableid[i]),
-						   HASH_REMOVE, NULL);
+		key.objectid = msg->m_tableid[i];
+		(void) dshash_delete_key(pgStatSharedTabHash, &key);
 	}
 }
 
@@ -6094,36 +5220,15 @@ static void
 pgstat_recv_dropdb(PgStat_MsgDropdb *msg, int len)
 {
 	Oid			dbid = msg->m_databaseid;
-	PgStat_StatDBEntry *dbentry;
 
-	/*
-	 * Lookup the database in the hashtable.
-	 */
-	dbentry = pgstat_get_db_entry(dbid, false);
+	pgstat_attach_shmem();
 
 	/*
-	 * If found, remove it (along with the db statfile).
+	 * Remove the database's entry, if it's there, and its tables' and
+	 * functions' entries.
 	 */
-	if (dbentry)
-	{
-		char		statfile[MAXPGPATH];
-
-		get_dbstat_filename(false, false, dbid, statfile, MAXPGPATH);
-
-		elog(DEBUG2, "removing stats file \"%s\"", statfile);
-		unlink(statfile);
-
-		if (dbentry->tables != NULL)
-			hash_destroy(dbentry->tables);
-		if (dbentry->functions != NULL)
-			hash_destroy(dbentry->functions);
-
-		if (hash_search(pgStatDBHash,
-						(void *) &dbid,
-						HASH_REMOVE, NULL) == NULL)
-			ereport(ERROR,
-					(errmsg("database hash table corrupted during cleanup --- abort")));
-	}
+	(void) dshash_delete_key(pgStatSharedDBHash, &dbid);
+	pgstat_drop_db_objects(dbid);
 }
 
 
@@ -6147,22 +5252,16 @@ pgstat_recv_resetcounter(PgStat_MsgResetcounter *msg, int len)
 		return;
 
 	/*
-	 * We simply throw away all the database's table entries by recreating a
-	 * new hash table for them.
+	 * Reset database-level stats.
 	 */
-	if (dbentry->tables != NULL)
-		hash_destroy(dbentry->tables);
-	if (dbentry->functions != NULL)
-		hash_destroy(dbentry->functions);
+	reset_dbentry_counters(dbentry);
 
-	dbentry->tables = NULL;
-	dbentry->functions = NULL;
+	dshash_release_lock(pgStatSharedDBHash, dbentry);
 
 	/*
-	 * Reset database-level stats, too.  This creates empty hash tables for
-	 * tables and functions.
+	 * We simply throw away all the database's table and function entries.
 	 */
-	reset_dbentry_counters(dbentry);
+	pgstat_drop_db_objects(msg->m_databaseid);
 }
 
 /* ----------
@@ -6174,18 +5273,34 @@ pgstat_recv_resetcounter(PgStat_MsgResetcounter *msg, int len)
 static void
 pgstat_recv_resetsharedcounter(PgStat_MsgResetsharedcounter *msg, int len)
 {
+	TimestampTz ts = GetCurrentTimestamp();
+
+	SpinLockAcquire(&StatsShmem->mutex);
 	if (msg->m_resettarget == RESET_BGWRITER)
 	{
 		/* Reset the global background writer statistics for the cluster. */
-		memset(&globalStats, 0, sizeof(globalStats));
-		globalStats.stat_reset_timestamp = GetCurrentTimestamp();
+		memset(&StatsShmem->global_stats, 0, sizeof(PgStat_GlobalStats));
+		StatsShmem->global_stats.stat_reset_timestamp = ts;
 	}
 	else if (msg->m_resettarget == RESET_ARCHIVER)
 	{
 		/* Reset the archiver statistics for the cluster. */
-		memset(&archiverStats, 0, sizeof(archiverStats));
-		archiverStats.stat_reset_timestamp = GetCurrentTimestamp();
+		memset(&StatsShmem->archiver_stats, 0, sizeof(PgStat_ArchiverStats));
+		StatsShmem->archiver_stats.stat_reset_timestamp = ts;
+	}
+	else if (msg->m_resettarget == RESET_IO)
+	{
+		/* Reset the shared buffer I/O statistics for the cluster. */
+		memset(&StatsShmem->io_stats, 0, sizeof(PgStat_IOStats));
+		StatsShmem->io_stats.stat_reset_timestamp = ts;
 	}
+	else if (msg->m_resettarget == RESET_WAL_FLUSH)
+	{
+		/* Reset the group WAL flush statistics for the cluster. */
+		memset(&StatsShmem->wal_flush_stats, 0, sizeof(PgStat_WalFlushStats));
+		StatsShmem->wal_flush_stats.stat_reset_timestamp = ts;
+	}
+	SpinLockRelease(&StatsShmem->mutex);
 
 	/*
 	 * Presumably the sender of this message validated the target, don't
@@ -6203,6 +5318,7 @@ static void
 pgstat_recv_resetsinglecounter(PgStat_MsgResetsinglecounter *msg, int len)
 {
 	PgStat_StatDBEntry *dbentry;
+	PgStat_StatObjKey key;
 
 	dbentry = pgstat_get_db_entry(msg->m_databaseid, false);
 
@@ -6212,13 +5328,15 @@ pgstat_recv_resetsinglecounter(PgStat_MsgResetsinglecounter *msg, int len)
 	/* Set the reset timestamp for the whole database */
 	dbentry->stat_reset_timestamp = GetCurrentTimestamp();
 
+	dshash_release_lock(pgStatSharedDBHash, dbentry);
+
 	/* Remove object if it exists, ignore it if not */
+	key.databaseid = msg->m_databaseid;
+	key.objectid = msg->m_objectid;
 	if (msg->m_resettype == RESET_TABLE)
-		(void) hash_search(dbentry->tables, (void *) &(msg->m_objectid),
-						   HASH_REMOVE, NULL);
+		(void) dshash_delete_key(pgStatSharedTabHash, &key);
 	else if (msg->m_resettype == RESET_FUNCTION)
-		(void) hash_search(dbentry->functions, (void *) &(msg->m_objectid),
-						   HASH_REMOVE, NULL);
+		(void) dshash_delete_key(pgStatSharedFuncHash, &key);
 }
 
 /* ----------
@@ -6233,17 +5351,17 @@ pgstat_recv_resetslrucounter(PgStat_MsgResetslrucounter *msg, int len)
 	int			i;
 	TimestampTz	ts = GetCurrentTimestamp();
 
-	memset(&slruStats, 0, sizeof(slruStats));
-
+	SpinLockAcquire(&StatsShmem->mutex);
 	for (i = 0; i < SLRU_NUM_ELEMENTS; i++)
 	{
 		/* reset entry with the given index, or all entries (index is -1) */
 		if ((msg->m_index == -1) || (msg->m_index == i))
 		{
-			memset(&slruStats[i], 0, sizeof(slruStats[i]));
-			slruStats[i].stat_reset_timestamp = ts;
+			memset(&StatsShmem->slru_stats[i], 0, sizeof(PgStat_SLRUStats));
+			StatsShmem->slru_stats[i].stat_reset_timestamp = ts;
 		}
 	}
+	SpinLockRelease(&StatsShmem->mutex);
 }
 
 /* ----------
@@ -6263,6 +5381,8 @@ pgstat_recv_autovac(PgStat_MsgAutovacStart *msg, int len)
 	dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
 
 	dbentry->last_autovac_time = msg->m_start_time;
+
+	dshash_release_lock(pgStatSharedDBHash, dbentry);
 }
 
 /* ----------
@@ -6275,14 +5395,18 @@ static void
 pgstat_recv_vacuum(PgStat_MsgVacuum *msg, int len)
 {
 	PgStat_StatDBEntry *dbentry;
+	PgStat_SharedTabEntry *shentry;
 	PgStat_StatTabEntry *tabentry;
 
 	/*
-	 * Store the data in the table's hashtable entry.
+	 * Make sure the database has an entry, then store the data in the
+	 * table's hashtable entry.
 	 */
 	dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
+	dshash_release_lock(pgStatSharedDBHash, dbentry);
 
-	tabentry = pgstat_get_tab_entry(dbentry, msg->m_tableoid, true);
+	shentry = pgstat_get_tab_entry(msg->m_databaseid, msg->m_tableoid, true);
+	tabentry = &shentry->stats;
 
 	tabentry->n_live_tuples = msg->m_live_tuples;
 	tabentry->n_dead_tuples = msg->m_dead_tuples;
@@ -6309,6 +5433,8 @@ pgstat_recv_vacuum(PgStat_MsgVacuum *msg, int len)
 		tabentry->vacuum_timestamp = msg->m_vacuumtime;
 		tabentry->vacuum_count++;
 	}
+
+	dshash_release_lock(pgStatSharedTabHash, shentry);
 }
 
 /* ----------
@@ -6321,14 +5447,18 @@ static void
 pgstat_recv_analyze(PgStat_MsgAnalyze *msg, int len)
 {
 	PgStat_StatDBEntry *dbentry;
+	PgStat_SharedTabEntry *shentry;
 	PgStat_StatTabEntry *tabentry;
 
 	/*
-	 * Store the data in the table's hashtable entry.
+	 * Make sure the database has an entry, then store the data in the
+	 * table's hashtable entry.
 	 */
 	dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
+	dshash_release_lock(pgStatSharedDBHash, dbentry);
 
-	tabentry = pgstat_get_tab_entry(dbentry, msg->m_tableoid, true);
+	shentry = pgstat_get_tab_entry(msg->m_databaseid, msg->m_tableoid, true);
+	tabentry = &shentry->stats;
 
 	tabentry->n_live_tuples = msg->m_live_tuples;
 	tabentry->n_dead_tuples = msg->m_dead_tuples;
@@ -6351,6 +5481,8 @@ pgstat_recv_analyze(PgStat_MsgAnalyze *msg, int len)
 		tabentry->analyze_timestamp = msg->m_analyzetime;
 		tabentry->analyze_count++;
 	}
+
+	dshash_release_lock(pgStatSharedTabHash, shentry);
 }
 
 
@@ -6363,22 +5495,26 @@ pgstat_recv_analyze(PgStat_MsgAnalyze *msg, int len)
 static void
 pgstat_recv_archiver(PgStat_MsgArchiver *msg, int len)
 {
+	PgStat_ArchiverStats *archiver_stats = &StatsShmem->archiver_stats;
+
+	SpinLockAcquire(&StatsShmem->mutex);
 	if (msg->m_failed)
 	{
 		/* Failed archival attempt */
-		++archiverStats.failed_count;
-		memcpy(archiverStats.last_failed_wal, msg->m_xlog,
-			   sizeof(archiverStats.last_failed_wal));
-		archiverStats.last_failed_timestamp = msg->m_timestamp;
+		++archiver_stats->failed_count;
+		memcpy(archiver_stats->last_failed_wal, msg->m_xlog,
+			   sizeof(archiver_stats->last_failed_wal));
+		archiver_stats->last_failed_timestamp = msg->m_timestamp;
 	}
 	else
 	{
 		/* Successful archival operation */
-		++archiverStats.archived_count;
-		memcpy(archiverStats.last_archived_wal, msg->m_xlog,
-			   sizeof(archiverStats.last_archived_wal));
-		archiverStats.last_archived_timestamp = msg->m_timestamp;
+		++archiver_stats->archived_count;
+		memcpy(archiver_stats->last_archived_wal, msg->m_xlog,
+			   sizeof(archiver_stats->last_archived_wal));
+		archiver_stats->last_archived_timestamp = msg->m_timestamp;
 	}
+	SpinLockRelease(&StatsShmem->mutex);
 }
 
 /* ----------
@@ -6390,16 +5526,20 @@ pgstat_recv_archiver(PgStat_MsgArchiver *msg, int len)
 static void
 pgstat_recv_bgwriter(PgStat_MsgBgWriter *msg, int len)
 {
-	globalStats.timed_checkpoints += msg->m_timed_checkpoints;
-	globalStats.requested_checkpoints += msg->m_requested_checkpoints;
-	globalStats.checkpoint_write_time += msg->m_checkpoint_write_time;
-	globalStats.checkpoint_sync_time += msg->m_checkpoint_sync_time;
-	globalStats.buf_written_checkpoints += msg->m_buf_written_checkpoints;
-	globalStats.buf_written_clean += msg->m_buf_written_clean;
-	globalStats.maxwritten_clean += msg->m_maxwritten_clean;
-	globalStats.buf_written_backend += msg->m_buf_written_backend;
-	globalStats.buf_fsync_backend += msg->m_buf_fsync_backend;
-	globalStats.buf_alloc += msg->m_buf_alloc;
+	PgStat_GlobalStats *global_stats = &StatsShmem->global_stats;
+
+	SpinLockAcquire(&StatsShmem->mutex);
+	global_stats->timed_checkpoints += msg->m_timed_checkpoints;
+	global_stats->requested_checkpoints += msg->m_requested_checkpoints;
+	global_stats->checkpoint_write_time += msg->m_checkpoint_write_time;
+	global_stats->checkpoint_sync_time += msg->m_checkpoint_sync_time;
+	global_stats->buf_written_checkpoints += msg->m_buf_written_checkpoints;
+	global_stats->buf_written_clean += msg->m_buf_written_clean;
+	global_stats->maxwritten_clean += msg->m_maxwritten_clean;
+	global_stats->buf_written_backend += msg->m_buf_written_backend;
+	global_stats->buf_fsync_backend += msg->m_buf_fsync_backend;
+	global_stats->buf_alloc += msg->m_buf_alloc;
+	SpinLockRelease(&StatsShmem->mutex);
 }
 
 /* ----------
@@ -6411,13 +5551,63 @@ pgstat_recv_bgwriter(PgStat_MsgBgWriter *msg, int len)
 static void
 pgstat_recv_slru(PgStat_MsgSLRU *msg, int len)
 {
-	slruStats[msg->m_index].blocks_zeroed += msg->m_blocks_zeroed;
-	slruStats[msg->m_index].blocks_hit += msg->m_blocks_hit;
-	slruStats[msg->m_index].blocks_read += msg->m_blocks_read;
-	slruStats[msg->m_index].blocks_written += msg->m_blocks_written;
-	slruStats[msg->m_index].blocks_exists += msg->m_blocks_exists;
-	slruStats[msg->m_index].flush += msg->m_flush;
-	slruStats[msg->m_index].truncate += msg->m_truncate;
+	PgStat_SLRUStats *slru_stats = &StatsShmem->slru_stats[msg->m_index];
+
+	SpinLockAcquire(&StatsShmem->mutex);
+	slru_stats->blocks_zeroed += msg->m_blocks_zeroed;
+	slru_stats->blocks_hit += msg->m_blocks_hit;
+	slru_stats->blocks_read += msg->m_blocks_read;
+	slru_stats->blocks_written += msg->m_blocks_written;
+	slru_stats->blocks_exists += msg->m_blocks_exists;
+	slru_stats->flush += msg->m_flush;
+	slru_stats->truncate += msg->m_truncate;
+	SpinLockRelease(&StatsShmem->mutex);
+}
+
+/* ----------
+ * pgstat_recv_io() -
+ *
+ *	Process an IO message.
+ * ----------
+ */
+static void
+pgstat_recv_io(PgStat_MsgIO *msg, int len)
+{
+	PgStat_IOCounts *io_counts = &StatsShmem->io_stats.stats[msg->m_backend_type];
+	int			i,
+				j;
+
+	SpinLockAcquire(&StatsShmem->mutex);
+	for (i = 0; i < IOCONTEXT_NUM_TYPES; i++)
+	{
+		for (j = 0; j < IOOP_NUM_TYPES; j++)
+		{
+			io_counts->counts[i][j] += msg->m_counts.counts[i][j];
+			io_counts->times[i][j] += msg->m_counts.times[i][j];
+		}
+	}
+	SpinLockRelease(&StatsShmem->mutex);
+}
+
+/* ----------
+ * pgstat_recv_wal_flush() -
+ *
+ *	Process a WALFLUSH message.
+ * ----------
+ */
+static void
+pgstat_recv_wal_flush(PgStat_MsgWalFlush *msg, int len)
+{
+	PgStat_WalFlushCounts *counts = &StatsShmem->wal_flush_stats.counts;
+
+	SpinLockAcquire(&StatsShmem->mutex);
+	counts->groups += msg->m_counts.groups;
+	counts->members += msg->m_counts.members;
+	counts->max_members = Max(counts->max_members, msg->m_counts.max_members);
+	counts->flush_time += msg->m_counts.flush_time;
+	counts->max_flush_time = Max(counts->max_flush_time,
+								 msg->m_counts.max_flush_time);
+	SpinLockRelease(&StatsShmem->mutex);
 }
 
 /* ----------
@@ -6458,6 +5648,8 @@ pgstat_recv_recoveryconflict(PgStat_MsgRecoveryConflict *msg, int len)
 			dbentry->n_conflict_startup_deadlock++;
 			break;
 	}
+
+	dshash_release_lock(pgStatSharedDBHash, dbentry);
 }
 
 /* ----------
@@ -6474,6 +5666,8 @@ pgstat_recv_deadlock(PgStat_MsgDeadlock *msg, int len)
 	dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
 
 	dbentry->n_deadlocks++;
+
+	dshash_release_lock(pgStatSharedDBHash, dbentry);
 }
 
 /* ----------
@@ -6491,6 +5685,8 @@ pgstat_recv_checksum_failure(PgStat_MsgChecksumFailure *msg, int len)
 
 	dbentry->n_checksum_failures += msg->m_failurecount;
 	dbentry->last_checksum_failure = msg->m_failure_time;
+
+	dshash_release_lock(pgStatSharedDBHash, dbentry);
 }
 
 /* ----------
@@ -6508,6 +5704,8 @@ pgstat_recv_tempfile(PgStat_MsgTempFile *msg, int len)
 
 	dbentry->n_temp_bytes += msg->m_filesize;
 	dbentry->n_temp_files += 1;
+
+	dshash_release_lock(pgStatSharedDBHash, dbentry);
 }
 
 /* ----------
@@ -6521,20 +5719,27 @@ pgstat_recv_funcstat(PgStat_MsgFuncstat *msg, int len)
 {
 	PgStat_FunctionEntry *funcmsg = &(msg->m_entry[0]);
 	PgStat_StatDBEntry *dbentry;
-	PgStat_StatFuncEntry *funcentry;
+	PgStat_StatObjKey key;
 	int			i;
 	bool		found;
 
+	/* Make sure the database has an entry */
 	dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
+	dshash_release_lock(pgStatSharedDBHash, dbentry);
 
 	/*
 	 * Process all function entries in the message.
 	 */
+	key.databaseid = msg->m_databaseid;
 	for (i = 0; i < msg->m_nentries; i++, funcmsg++)
 	{
-		funcentry = (PgStat_StatFuncEntry *) hash_search(dbentry->functions,
-														 (void *) &(funcmsg->f_id),
-														 HASH_ENTER, &found);
+		PgStat_SharedFuncEntry *shentry;
+		PgStat_StatFuncEntry *funcentry;
+
+		key.objectid = funcmsg->f_id;
+		shentry = (PgStat_SharedFuncEntry *)
+			dshash_find_or_insert(pgStatSharedFuncHash, &key, &found);
+		funcentry = &shentry->stats;
 
 		if (!found)
 		{
@@ -6542,6 +5747,7 @@ pgstat_recv_funcstat(PgStat_MsgFuncstat *msg, int len)
 			 * If it's a new function entry, initialize counters to the values
 			 * we just got.
 			 */
+			funcentry->functionid = funcmsg->f_id;
 			funcentry->f_numcalls = funcmsg->f_numcalls;
 			funcentry->f_total_time = funcmsg->f_total_time;
 			funcentry->f_self_time = funcmsg->f_self_time;
@@ -6555,6 +5761,8 @@ pgstat_recv_funcstat(PgStat_MsgFuncstat *msg, int len)
 			funcentry->f_total_time += funcmsg->f_total_time;
 			funcentry->f_self_time += funcmsg->f_self_time;
 		}
+
+		dshash_release_lock(pgStatSharedFuncHash, shentry);
 	}
 }
 
@@ -6567,70 +5775,23 @@ pgstat_recv_funcstat(PgStat_MsgFuncstat *msg, int len)
 static void
 pgstat_recv_funcpurge(PgStat_MsgFuncpurge *msg, int len)
 {
-	PgStat_StatDBEntry *dbentry;
+	PgStat_StatObjKey key;
 	int			i;
 
-	dbentry = pgstat_get_db_entry(msg->m_databaseid, false);
-
-	/*
-	 * No need to purge if we don't even know the database.
-	 */
-	if (!dbentry || !dbentry->functions)
-		return;
+	pgstat_attach_shmem();
 
 	/*
 	 * Process all function entries in the message.
 	 */
+	key.databaseid = msg->m_databaseid;
 	for (i = 0; i < msg->m_nentries; i++)
 	{
 		/* Remove from hashtable if present; we don't care if it's not. */
-		(void) hash_search(dbentry->functions,
-						   (void *) &(msg->m_functionid[i]),
-						   HASH_REMOVE, NULL);
+		key.objectid = msg->m_functionid[i];
+		(void) dshash_delete_key(pgStatSharedFuncHash, &key);
 	}
 }
 
-/* ----------
- * pgstat_write_statsfile_needed() -
- *
- *	Do we need to write out any stats files?
- * ----------
- */
-static bool
-pgstat_write_statsfile_needed(void)
-{
-	if (pending_write_requests != NIL)
-		return true;
-
-	/* Everything was written recently */
-	return false;
-}
-
-/* ----------
- * pgstat_db_requested() -
- *
- *	Checks whether stats for a particular DB need to be written to a file.
- * ----------
- */
-static bool
-pgstat_db_requested(Oid databaseid)
-{
-	/*
-	 * If any requests are outstanding at all, we should write the stats for
-	 * shared catalogs (the "database" with OID 0).  This ensures that
-	 * backends will see up-to-date stats for shared catalogs, even though
-	 * they send inquiry messages mentioning only their own DB.
-	 */
-	if (databaseid == InvalidOid && pending_write_requests != NIL)
-		return true;
-
-	/* Search to see if there's an open request to write this database. */
-	if (list_member_oid(pending_write_requests, databaseid))
-		return true;
-
-	return false;
-}
-
 /*
  * Convert a potentially unsafely truncated activity string (see
  * PgBackendStatus.st_activity_raw's documentation) into a correctly truncated
@@ -6772,3 +5933,69 @@ pgstat_count_slru_truncate(SlruCtl ctl)
 {
 	slru_entry(ctl)->m_truncate += 1;
 }
+
+/*
+ * pgstat_count_io_op
+ *
+ * Count one shared buffer I/O operation of the given kind.
+ */
+void
+pgstat_count_io_op(IOContext io_context, IOOp io_op)
+{
+	PendingIOStats.counts[io_context][io_op]++;
+	have_io_stats = true;
+}
+
+/*
+ * pgstat_count_io_time
+ *
+ * Add the time an I/O operation took.  Callers only measure that when
+ * track_io_timing is on; the operation itself is counted by
+ * pgstat_count_io_op().
+ */
+void
+pgstat_count_io_time(IOContext io_context, IOOp io_op, instr_time io_time)
+{
+	PendingIOStats.times[io_context][io_op] += INSTR_TIME_GET_MICROSEC(io_time);
+	have_io_stats = true;
+}
+
+/*
+ * pgstat_io_context_desc
+ *
+ * Returns the name of the given IOContext, as shown in pg_stat_io.
+ */
+const char *
+pgstat_io_context_desc(IOContext io_context)
+{
+	Assert(io_context >= 0 && io_context < IOCONTEXT_NUM_TYPES);
+
+	return io_context_names[io_context];
+}
+
+/*
+ * pgstat_count_wal_flush_group
+ *
+ * Count one group WAL flush led by this process, satisfying the flush
+ * requests of the given number of members.  flush_time is the time it took
+ * to write and flush the WAL, or NULL if it wasn't measured.
+ *
+ * This is called in a critical section, so it must not allocate memory.
+ */
+void
+pgstat_count_wal_flush_group(int members, instr_time *flush_time)
+{
+	PendingWalFlushStats.groups++;
+	PendingWalFlushStats.members += members;
+	PendingWalFlushStats.max_members = Max(PendingWalFlushStats.max_members,
+										   members);
+	if (flush_time != NULL)
+	{
+		PgStat_Counter us = INSTR_TIME_GET_MICROSEC(*flush_time);
+
+		PendingWalFlushStats.flush_time += us;
+		PendingWalFlushStats.max_flush_time =
+			Max(PendingWalFlushStats.max_flush_time, us);
+	}
+	have_wal_flush_stats = true;
+}
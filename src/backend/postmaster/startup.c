@@ -20,6 +20,7 @@
 #include "postgres.h"
 
 #include "access/xlog.h"
+#include "access/xlogparallel.h"
 #include "libpq/pqsignal.h"
 #include "miscadmin.h"
 #include "pgstat.h"
@@ -156,6 +157,9 @@ HandleStartupProcInterrupts(void)
 	if (IsUnderPostmaster && !PostmasterIsAlive())
 		exit(1);
 
+	/* Give up if a parallel redo worker failed to replay a record */
+	ParallelRedoCheckWorkers();
+
 	/* Process barrier events */
 	if (ProcSignalBarrierPending)
 		ProcessProcSignalBarrier();
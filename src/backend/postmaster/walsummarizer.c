@@ -0,0 +1,882 @@
+/*-------------------------------------------------------------------------
+ *
+ * walsummarizer.c
+ *
+ * The WAL summarizer is a background worker that reads the WAL as it is
+ * generated (or replayed, on a standby) and records which blocks of which
+ * relation forks each range of WAL modifies.  The results are written to WAL
+ * summary files (see replication/walsummary.c), which incremental base
+ * backups use to find the blocks that changed since a prior backup.
+ *
+ * A summary normally ends at a checkpoint record, so that the start of any
+ * base backup, which is the redo pointer of some checkpoint, falls in a
+ * summary that ends soon after it.  A summary also ends at a timeline
+ * switch, and when it grows too large to keep in memory.  Summaries on one
+ * timeline are contiguous: each one starts where the previous one ended.
+ *
+ * The summarizer is started by the postmaster when summarize_wal is enabled.
+ * When it restarts, it picks up where the newest existing summary left off,
+ * provided that the WAL is still available; otherwise it starts from the
+ * last checkpoint's redo pointer, leaving a gap that incremental backups
+ * will refuse to span.  WAL is kept until it has been summarized.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ *
+ *
+ * IDENTIFICATION
+ *	  src/backend/postmaster/walsummarizer.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <time.h>
+#include <unistd.h>
+
+#include "access/heapam_xlog.h"
+#include "access/timeline.h"
+#include "access/visibilitymap.h"
+#include "access/xlog.h"
+#include "access/xlog_internal.h"
+#include "access/xlogreader.h"
+#include "access/xlogutils.h"
+#include "catalog/pg_control.h"
+#include "catalog/storage_xlog.h"
+#include "commands/dbcommands_xlog.h"
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "postmaster/bgworker.h"
+#include "postmaster/interrupt.h"
+#include "postmaster/walsummarizer.h"
+#include "replication/walsummary.h"
+#include "storage/condition_variable.h"
+#include "storage/fd.h"
+#include "storage/ipc.h"
+#include "storage/latch.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
+#include "utils/guc.h"
+#include "utils/memutils.h"
+#include "utils/timestamp.h"
+
+/*
+ * Start a new summary once this many block references have been collected,
+ * even without a checkpoint, to bound the summarizer's memory use (4 bytes
+ * per reference).
+ */
+#define MAX_BLOCKS_PER_SUMMARY		(16 * 1024 * 1024)
+
+/* Bounds of the exponential backoff used while waiting for new WAL, in ms */
+#define WAL_SUMMARIZER_MIN_SLEEP	10
+#define WAL_SUMMARIZER_MAX_SLEEP	1000
+
+/* How often to look for summaries older than wal_summary_keep_time, in s */
+#define WAL_SUMMARY_REMOVAL_INTERVAL	60
+
+/* Shared state of the WAL summarizer */
+typedef struct WalSummarizerData
+{
+	slock_t		mutex;			/* protects the fields below */
+	Latch	   *summarizer_latch;	/* NULL if the summarizer isn't running */
+	TimeLineID	summarized_tli; /* timeline of summarized_lsn */
+	XLogRecPtr	summarized_lsn; /* all WAL before this has been summarized */
+	ConditionVariable summary_file_cv;	/* broadcast after each summary */
+} WalSummarizerData;
+
+static WalSummarizerData *WalSummarizerCtl = NULL;
+
+/* GUC variables */
+bool		summarize_wal = false;
+int			wal_summary_keep_time = 10 * 24 * 60;	/* minutes */
+
+/* Current sleep time while waiting for WAL, in ms */
+static long sleep_ms = WAL_SUMMARIZER_MIN_SLEEP;
+
+static void walsummarizer_exit(int code, Datum arg);
+static void walsummarizer_process_interrupts(void);
+static XLogRecPtr walsummarizer_get_latest_lsn(TimeLineID *tli);
+static XLogRecPtr walsummarizer_find_start(TimeLineID *tli);
+static void walsummarizer_remove_temp_files(void);
+static void walsummarizer_remove_old_summaries(void);
+static void walsummarizer_publish(TimeLineID tli, XLogRecPtr lsn);
+static int	walsummarizer_read_page(XLogReaderState *state,
+									XLogRecPtr targetPagePtr, int reqLen,
+									XLogRecPtr targetRecPtr, char *cur_page);
+static int	walsummarizer_segment_open(XLogSegNo nextSegNo,
+									   WALSegmentContext *segcxt,
+									   TimeLineID *tli_p);
+static bool SummarizeRecord(BlockRefTable *brtab,
+							XLogReaderState *xlogreader);
+static void SummarizeHeapRecord(BlockRefTable *brtab,
+								XLogReaderState *xlogreader);
+static void SummarizeHeap2Record(BlockRefTable *brtab,
+								 XLogReaderState *xlogreader);
+static void mark_vm_block_modified(BlockRefTable *brtab,
+								   XLogReaderState *xlogreader,
+								   uint8 block_id);
+
+/*
+ * Amount of shared memory needed by the WAL summarizer.
+ */
+Size
+WalSummarizerShmemSize(void)
+{
+	return sizeof(WalSummarizerData);
+}
+
+/*
+ * Create or attach to the WAL summarizer's shared memory.
+ */
+void
+WalSummarizerShmemInit(void)
+{
+	bool		found;
+
+	WalSummarizerCtl = (WalSummarizerData *)
+		ShmemInitStruct("Wal Summarizer Ctl", WalSummarizerShmemSize(),
+						&found);
+	if (!found)
+	{
+		SpinLockInit(&WalSummarizerCtl->mutex);
+		WalSummarizerCtl->summarizer_latch = NULL;
+		WalSummarizerCtl->summarized_tli = 0;
+		WalSummarizerCtl->summarized_lsn = InvalidXLogRecPtr;
+		ConditionVariableInit(&WalSummarizerCtl->summary_file_cv);
+	}
+}
+
+/*
+ * Register the WAL summarizer background worker, if summarize_wal is on.
+ * Called by the postmaster at startup.
+ */
+void
+WalSummarizerRegister(void)
+{
+	BackgroundWorker bgw;
+
+	if (!summarize_wal)
+		return;
+
+	memset(&bgw, 0, sizeof(bgw));
+	bgw.bgw_flags = BGWORKER_SHMEM_ACCESS;
+	bgw.bgw_start_time = BgWorkerStart_PostmasterStart;
+	snprintf(bgw.bgw_library_name, BGW_MAXLEN, "postgres");
+	snprintf(bgw.bgw_function_name, BGW_MAXLEN, "WalSummarizerMain");
+	snprintf(bgw.bgw_name, BGW_MAXLEN, "walsummarizer");
+	snprintf(bgw.bgw_type, BGW_MAXLEN, "walsummarizer");
+	bgw.bgw_restart_time = 10;
+	bgw.bgw_notify_pid = 0;
+	bgw.bgw_main_arg = (Datum) 0;
+
+	RegisterBackgroundWorker(&bgw);
+}
+
+/*
+ * Main entry point of the WAL summarizer.
+ */
+void
+WalSummarizerMain(Datum main_arg)
+{
+	XLogReaderState *xlogreader;
+	BlockRefTable *brtab;
+	TimeLineID	summary_tli;
+	XLogRecPtr	summary_start_lsn;
+	XLogRecPtr	switch_lsn = InvalidXLogRecPtr;
+	TimeLineID	next_tli = 0;
+	pg_time_t	last_removal_time = 0;
+
+	pqsignal(SIGHUP, SignalHandlerForConfigReload);
+	pqsignal(SIGTERM, SignalHandlerForShutdownRequest);
+	BackgroundWorkerUnblockSignals();
+
+	SpinLockAcquire(&WalSummarizerCtl->mutex);
+	if (WalSummarizerCtl->summarizer_latch != NULL)
+	{
+		SpinLockRelease(&WalSummarizerCtl->mutex);
+		elog(ERROR, "WAL summarizer is already running");
+	}
+	WalSummarizerCtl->summarizer_latch = MyLatch;
+	SpinLockRelease(&WalSummarizerCtl->mutex);
+	on_shmem_exit(walsummarizer_exit, 0);
+
+	if (MakePGDirectory(WAL_SUMMARY_DIR) < 0 && errno != EEXIST)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not create directory \"%s\": %m",
+						WAL_SUMMARY_DIR)));
+	walsummarizer_remove_temp_files();
+
+	summary_start_lsn = walsummarizer_find_start(&summary_tli);
+	walsummarizer_publish(summary_tli, summary_start_lsn);
+	ereport(DEBUG1,
+			(errmsg("WAL summarizer starting at %X/%X on timeline %u",
+					(uint32) (summary_start_lsn >> 32),
+					(uint32) summary_start_lsn, summary_tli)));
+
+	xlogreader = XLogReaderAllocate(wal_segment_size, NULL,
+									walsummarizer_read_page, NULL);
+	if (xlogreader == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of memory"),
+				 errdetail("Failed while allocating a WAL reading processor.")));
+	XLogBeginRead(xlogreader, summary_start_lsn);
+
+	brtab = CreateBlockRefTable();
+
+	for (;;)
+	{
+		XLogRecord *record;
+		char	   *errormsg;
+		bool		end_summary;
+
+		walsummarizer_process_interrupts();
+
+		record = XLogReadRecord(xlogreader, &errormsg);
+		if (record == NULL)
+		{
+			if (errormsg)
+				ereport(ERROR,
+						(errmsg("could not read WAL at %X/%X: %s",
+								(uint32) (xlogreader->EndRecPtr >> 32),
+								(uint32) xlogreader->EndRecPtr, errormsg)));
+			else
+				ereport(ERROR,
+						(errmsg("could not read WAL at %X/%X",
+								(uint32) (xlogreader->EndRecPtr >> 32),
+								(uint32) xlogreader->EndRecPtr)));
+		}
+
+		/*
+		 * If the server has moved on to a newer timeline, find out where the
+		 * one we're summarizing ends.  A record at or beyond that point
+		 * belongs to the next timeline, so the current summary has to end
+		 * there and a new one begin.
+		 */
+		for (;;)
+		{
+			if (XLogRecPtrIsInvalid(switch_lsn) &&
+				summary_tli != ThisTimeLineID)
+			{
+				List	   *history = readTimeLineHistory(ThisTimeLineID);
+
+				switch_lsn = tliSwitchPoint(summary_tli, history, &next_tli);
+				list_free_deep(history);
+			}
+			if (XLogRecPtrIsInvalid(switch_lsn) ||
+				xlogreader->ReadRecPtr < switch_lsn)
+				break;
+
+			WriteWalSummary(brtab, summary_tli, summary_start_lsn,
+							switch_lsn);
+			FreeBlockRefTable(brtab);
+			brtab = CreateBlockRefTable();
+			summary_tli = next_tli;
+			summary_start_lsn = switch_lsn;
+			switch_lsn = InvalidXLogRecPtr;
+			walsummarizer_publish(summary_tli, summary_start_lsn);
+		}
+
+		end_summary = SummarizeRecord(brtab, xlogreader);
+		if (!end_summary &&
+			BlockRefTableNumBlocks(brtab) < MAX_BLOCKS_PER_SUMMARY)
+			continue;
+
+		WriteWalSummary(brtab, summary_tli, summary_start_lsn,
+						xlogreader->EndRecPtr);
+		FreeBlockRefTable(brtab);
+		brtab = CreateBlockRefTable();
+		summary_start_lsn = xlogreader->EndRecPtr;
+		walsummarizer_publish(summary_tli, summary_start_lsn);
+
+		if (wal_summary_keep_time > 0 &&
+			(pg_time_t) time(NULL) - last_removal_time >=
+			WAL_SUMMARY_REMOVAL_INTERVAL)
+		{
+			walsummarizer_remove_old_summaries();
+			last_removal_time = (pg_time_t) time(NULL);
+		}
+	}
+}
+
+/*
+ * Return the oldest LSN that has not been summarized yet, and its timeline,
+ * or InvalidXLogRecPtr if WAL summarization isn't running.  WAL from there
+ * on must not be removed.
+ */
+XLogRecPtr
+GetOldestUnsummarizedLSN(TimeLineID *tli)
+{
+	XLogRecPtr	lsn;
+
+	if (!summarize_wal || WalSummarizerCtl == NULL)
+		return InvalidXLogRecPtr;
+
+	SpinLockAcquire(&WalSummarizerCtl->mutex);
+	lsn = WalSummarizerCtl->summarized_lsn;
+	if (tli != NULL)
+		*tli = WalSummarizerCtl->summarized_tli;
+	SpinLockRelease(&WalSummarizerCtl->mutex);
+
+	return lsn;
+}
+
+/*
+ * Wait until all WAL before the given LSN has been summarized.
+ */
+void
+WaitForWalSummarization(XLogRecPtr lsn)
+{
+	TimestampTz start_time = GetCurrentTimestamp();
+	TimestampTz last_warning = start_time;
+
+	if (!summarize_wal)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("WAL summarization is not enabled"),
+				 errhint("Set summarize_wal to on and restart the server.")));
+
+	ConditionVariablePrepareToSleep(&WalSummarizerCtl->summary_file_cv);
+	for (;;)
+	{
+		XLogRecPtr	summarized_lsn;
+		Latch	   *latch;
+		TimestampTz now;
+
+		SpinLockAcquire(&WalSummarizerCtl->mutex);
+		summarized_lsn = WalSummarizerCtl->summarized_lsn;
+		latch = WalSummarizerCtl->summarizer_latch;
+		SpinLockRelease(&WalSummarizerCtl->mutex);
+
+		if (summarized_lsn >= lsn)
+			break;
+
+		/* The summarizer may be sleeping with a long timeout; wake it. */
+		if (latch != NULL)
+			SetLatch(latch);
+
+		now = GetCurrentTimestamp();
+		if (TimestampDifferenceExceeds(last_warning, now, 60000))
+		{
+			ereport(WARNING,
+					(errmsg("still waiting for WAL summarization through %X/%X after %ld seconds",
+							(uint32) (lsn >> 32), (uint32) lsn,
+							(long) ((now - start_time) / USECS_PER_SEC)),
+					 errdetail("Summarization has reached %X/%X.",
+							   (uint32) (summarized_lsn >> 32),
+							   (uint32) summarized_lsn)));
+			last_warning = now;
+		}
+
+		(void) ConditionVariableTimedSleep(&WalSummarizerCtl->summary_file_cv,
+										   1000, WAIT_EVENT_WAL_SUMMARY_READY);
+	}
+	ConditionVariableCancelSleep();
+}
+
+/*
+ * on_shmem_exit callback: mark the summarizer as no longer running.
+ */
+static void
+walsummarizer_exit(int code, Datum arg)
+{
+	SpinLockAcquire(&WalSummarizerCtl->mutex);
+	WalSummarizerCtl->summarizer_latch = NULL;
+	SpinLockRelease(&WalSummarizerCtl->mutex);
+}
+
+static void
+walsummarizer_process_interrupts(void)
+{
+	if (ConfigReloadPending)
+	{
+		ConfigReloadPending = false;
+		ProcessConfigFile(PGC_SIGHUP);
+	}
+
+	/*
+	 * Summaries already written stay valid, and whatever was collected since
+	 * the last one is simply summarized again after a restart.
+	 */
+	if (ShutdownRequestPending)
+		proc_exit(0);
+
+	CHECK_FOR_INTERRUPTS();
+}
+
+/*
+ * Return the LSN up to which WAL can be read, and set *tli and
+ * ThisTimeLineID to the timeline the server is currently on.
+ */
+static XLogRecPtr
+walsummarizer_get_latest_lsn(TimeLineID *tli)
+{
+	XLogRecPtr	lsn;
+
+	/*
+	 * RecoveryInProgress() will update ThisTimeLineID when it first notices
+	 * that recovery has finished.
+	 */
+	if (!RecoveryInProgress())
+		lsn = GetFlushRecPtr();
+	else
+		lsn = GetXLogReplayRecPtr(&ThisTimeLineID);
+	*tli = ThisTimeLineID;
+
+	return lsn;
+}
+
+/*
+ * Decide where to start summarizing: at the end of the newest existing
+ * summary if that is on the server's timeline history and its WAL is still
+ * around, otherwise at the redo pointer of the last checkpoint.  Waits until
+ * the startup process has established where that is.
+ */
+static XLogRecPtr
+walsummarizer_find_start(TimeLineID *tli)
+{
+	for (;;)
+	{
+		TimeLineID	latest_tli;
+		XLogRecPtr	latest_lsn;
+		XLogRecPtr	redo_lsn;
+
+		latest_lsn = walsummarizer_get_latest_lsn(&latest_tli);
+		redo_lsn = GetRedoRecPtr();
+
+		if (latest_tli != 0 && !XLogRecPtrIsInvalid(latest_lsn) &&
+			!XLogRecPtrIsInvalid(redo_lsn))
+		{
+			List	   *history = readTimeLineHistory(latest_tli);
+			List	   *wslist = GetWalSummaries(0, InvalidXLogRecPtr,
+												 InvalidXLogRecPtr);
+			WalSummaryFile *newest = NULL;
+			XLogRecPtr	start_lsn = redo_lsn;
+			ListCell   *lc;
+
+			foreach(lc, wslist)
+			{
+				WalSummaryFile *ws = lfirst(lc);
+
+				if (newest == NULL || ws->end_lsn > newest->end_lsn)
+					newest = ws;
+			}
+
+			if (newest != NULL && newest->end_lsn <= latest_lsn &&
+				tliOfPointInHistory(newest->end_lsn - 1, history) == newest->tli)
+			{
+				XLogSegNo	segno;
+
+				XLByteToSeg(newest->end_lsn, segno, wal_segment_size);
+				if (segno > XLogGetLastRemovedSegno())
+					start_lsn = newest->end_lsn;
+			}
+
+			*tli = tliOfPointInHistory(start_lsn, history);
+			list_free_deep(wslist);
+			list_free_deep(history);
+			return start_lsn;
+		}
+
+		walsummarizer_process_interrupts();
+		(void) WaitLatch(MyLatch, WL_LATCH_SET | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+						 WAL_SUMMARIZER_MAX_SLEEP, WAIT_EVENT_WAL_SUMMARIZER_WAL);
+		ResetLatch(MyLatch);
+	}
+}
+
+/*
+ * Remove any summary files that were left half-written by a crash.
+ */
+static void
+walsummarizer_remove_temp_files(void)
+{
+	DIR		   *sdir;
+	struct dirent *de;
+
+	sdir = AllocateDir(WAL_SUMMARY_DIR);
+	while ((de = ReadDir(sdir, WAL_SUMMARY_DIR)) != NULL)
+	{
+		size_t		len = strlen(de->d_name);
+		char		path[MAXPGPATH];
+
+		if (len < 4 || strcmp(de->d_name + len - 4, ".tmp") != 0)
+			continue;
+
+		snprintf(path, MAXPGPATH, "%s/%s", WAL_SUMMARY_DIR, de->d_name);
+		if (unlink(path) != 0)
+			ereport(LOG,
+					(errcode_for_file_access(),
+					 errmsg("could not remove file \"%s\": %m", path)));
+	}
+	FreeDir(sdir);
+}
+
+/*
+ * Remove summaries older than wal_summary_keep_time, except the newest one,
+ * which tells a restarted summarizer where to resume.
+ */
+static void
+walsummarizer_remove_old_summaries(void)
+{
+	List	   *wslist;
+	pg_time_t	cutoff_time;
+	ListCell   *lc;
+	WalSummaryFile *newest = NULL;
+
+	cutoff_time = (pg_time_t) time(NULL) - wal_summary_keep_time * 60;
+	wslist = GetWalSummaries(0, InvalidXLogRecPtr, InvalidXLogRecPtr);
+	foreach(lc, wslist)
+	{
+		WalSummaryFile *ws = lfirst(lc);
+
+		if (newest == NULL || ws->end_lsn > newest->end_lsn)
+			newest = ws;
+	}
+	foreach(lc, wslist)
+	{
+		WalSummaryFile *ws = lfirst(lc);
+
+		if (ws != newest)
+			RemoveWalSummaryIfOlderThan(ws, cutoff_time);
+	}
+	list_free_deep(wslist);
+}
+
+/*
+ * Advertise that all WAL before lsn has been summarized, and wake up anyone
+ * waiting for that.
+ */
+static void
+walsummarizer_publish(TimeLineID tli, XLogRecPtr lsn)
+{
+	SpinLockAcquire(&WalSummarizerCtl->mutex);
+	WalSummarizerCtl->summarized_tli = tli;
+	WalSummarizerCtl->summarized_lsn = lsn;
+	SpinLockRelease(&WalSummarizerCtl->mutex);
+
+	ConditionVariableBroadcast(&WalSummarizerCtl->summary_file_cv);
+}
+
+/*
+ * read_page callback for the summarizer's WAL reader.  This is like
+ * read_local_xlog_page(), except that it sleeps on the latch with a backoff
+ * while waiting for more WAL, and reacts to configuration reloads and
+ * shutdown requests.
+ */
+static int
+walsummarizer_read_page(XLogReaderState *state, XLogRecPtr targetPagePtr,
+						int reqLen, XLogRecPtr targetRecPtr, char *cur_page)
+{
+	XLogRecPtr	read_upto,
+				loc;
+	TimeLineID	tli;
+	int			count;
+	WALReadError errinfo;
+
+	loc = targetPagePtr + reqLen;
+
+	for (;;)
+	{
+		read_upto = walsummarizer_get_latest_lsn(&tli);
+
+		/* See read_local_xlog_page() for why this is done on every loop. */
+		XLogReadDetermineTimeline(state, targetPagePtr, reqLen);
+
+		if (state->currTLI == ThisTimeLineID)
+		{
+			if (loc <= read_upto)
+			{
+				sleep_ms = WAL_SUMMARIZER_MIN_SLEEP;
+				break;
+			}
+
+			walsummarizer_process_interrupts();
+			(void) WaitLatch(MyLatch,
+							 WL_LATCH_SET | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+							 sleep_ms, WAIT_EVENT_WAL_SUMMARIZER_WAL);
+			ResetLatch(MyLatch);
+			sleep_ms = Min(sleep_ms * 2, WAL_SUMMARIZER_MAX_SLEEP);
+		}
+		else
+		{
+			/* Historic timeline: it ends at the switch point, no waiting. */
+			read_upto = state->currTLIValidUntil;
+			tli = state->currTLI;
+			break;
+		}
+	}
+
+	if (targetPagePtr + XLOG_BLCKSZ <= read_upto)
+		count = XLOG_BLCKSZ;
+	else if (targetPagePtr + reqLen > read_upto)
+		return -1;
+	else
+		count = read_upto - targetPagePtr;
+
+	if (!WALRead(cur_page, targetPagePtr, XLOG_BLCKSZ, tli, &state->seg,
+				 &state->segcxt, walsummarizer_segment_open, &errinfo))
+		WALReadRaiseError(&errinfo);
+
+	return count;
+}
+
+/*
+ * segment_open callback for WALRead().
+ */
+static int
+walsummarizer_segment_open(XLogSegNo nextSegNo, WALSegmentContext *segcxt,
+						   TimeLineID *tli_p)
+{
+	char		path[MAXPGPATH];
+	int			fd;
+
+	XLogFilePath(path, *tli_p, nextSegNo, segcxt->ws_segsize);
+	fd = BasicOpenFile(path, O_RDONLY | PG_BINARY);
+	if (fd >= 0)
+		return fd;
+
+	if (errno == ENOENT)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("requested WAL segment %s has already been removed",
+						path)));
+	else
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not open file \"%s\": %m",
+						path)));
+
+	return -1;					/* keep compiler quiet */
+}
+
+/*
+ * Add the blocks modified by a WAL record to the block reference table.
+ * Returns true if the record should end the current summary.
+ */
+static bool
+SummarizeRecord(BlockRefTable *brtab, XLogReaderState *xlogreader)
+{
+	uint8		rmid = XLogRecGetRmid(xlogreader);
+	uint8		info = XLogRecGetInfo(xlogreader) & ~XLR_INFO_MASK;
+	int			block_id;
+
+	switch (rmid)
+	{
+		case RM_SMGR_ID:
+			if (info == XLOG_SMGR_CREATE)
+			{
+				xl_smgr_create *xlrec;
+
+				/* A new relation fork: nothing in a prior backup applies. */
+				xlrec = (xl_smgr_create *) XLogRecGetData(xlogreader);
+				BlockRefTableSetLimitBlock(brtab, &xlrec->rnode,
+										   xlrec->forkNum, 0);
+			}
+			else if (info == XLOG_SMGR_TRUNCATE)
+			{
+				xl_smgr_truncate *xlrec;
+
+				xlrec = (xl_smgr_truncate *) XLogRecGetData(xlogreader);
+				if ((xlrec->flags & SMGR_TRUNCATE_HEAP) != 0)
+					BlockRefTableSetLimitBlock(brtab, &xlrec->rnode,
+											   MAIN_FORKNUM, xlrec->blkno);
+
+				/*
+				 * Truncating the visibility map also clears bits on its new
+				 * last page without WAL-logging that page.
+				 */
+				if ((xlrec->flags & SMGR_TRUNCATE_VM) != 0)
+					BlockRefTableSetLimitBlock(brtab, &xlrec->rnode,
+											   VISIBILITYMAP_FORKNUM,
+											   visibilitymap_map_block(xlrec->blkno));
+			}
+			break;
+
+		case RM_DBASE_ID:
+			if (info == XLOG_DBASE_CREATE)
+			{
+				xl_dbase_create_rec *xlrec;
+				RelFileNode rnode;
+
+				/*
+				 * The new database's files are copied from the template
+				 * without being WAL-logged.  Record that with an entry for
+				 * relfilenode 0, which makes incremental backups send the
+				 * whole database.
+				 */
+				xlrec = (xl_dbase_create_rec *) XLogRecGetData(xlogreader);
+				rnode.spcNode = xlrec->tablespace_id;
+				rnode.dbNode = xlrec->db_id;
+				rnode.relNode = InvalidOid;
+				BlockRefTableSetLimitBlock(brtab, &rnode, MAIN_FORKNUM, 0);
+			}
+			break;
+
+		case RM_XLOG_ID:
+			if (info == XLOG_PARAMETER_CHANGE)
+			{
+				xl_parameter_change xlrec;
+
+				/*
+				 * At wal_level=minimal, some relation changes aren't
+				 * WAL-logged at all, so the summaries would miss them.  The
+				 * postmaster refuses to start the summarizer at that level,
+				 * but older WAL may still have been written with it.
+				 */
+				memcpy(&xlrec, XLogRecGetData(xlogreader),
+					   sizeof(xl_parameter_change));
+				if (xlrec.wal_level < WAL_LEVEL_REPLICA)
+					ereport(ERROR,
+							(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+							 errmsg("WAL generated with wal_level=minimal cannot be summarized"),
+							 errdetail("WAL record at %X/%X changed wal_level to \"minimal\".",
+									   (uint32) (xlogreader->ReadRecPtr >> 32),
+									   (uint32) xlogreader->ReadRecPtr)));
+			}
+			break;
+
+		case RM_HEAP_ID:
+			SummarizeHeapRecord(brtab, xlogreader);
+			break;
+
+		case RM_HEAP2_ID:
+			SummarizeHeap2Record(brtab, xlogreader);
+			break;
+
+		default:
+			break;
+	}
+
+	for (block_id = 0; block_id <= xlogreader->max_block_id; block_id++)
+	{
+		RelFileNode rnode;
+		ForkNumber	forknum;
+		BlockNumber blocknum;
+
+		if (!XLogRecGetBlockTag(xlogreader, block_id, &rnode, &forknum,
+								&blocknum))
+			continue;
+
+		/* The free space map is always backed up in full. */
+		if (forknum == FSM_FORKNUM)
+			continue;
+
+		BlockRefTableMarkBlockModified(brtab, &rnode, forknum, blocknum);
+	}
+
+	return rmid == RM_XLOG_ID &&
+		(info == XLOG_CHECKPOINT_SHUTDOWN ||
+		 info == XLOG_CHECKPOINT_ONLINE ||
+		 info == XLOG_END_OF_RECOVERY);
+}
+
+/*
+ * Heap records that clear visibility map bits don't register the map page,
+ * so record the modification of the page covering each affected heap page.
+ */
+static void
+SummarizeHeapRecord(BlockRefTable *brtab, XLogReaderState *xlogreader)
+{
+	uint8		info = XLogRecGetInfo(xlogreader) & XLOG_HEAP_OPMASK;
+
+	switch (info)
+	{
+		case XLOG_HEAP_INSERT:
+			{
+				xl_heap_insert *xlrec;
+
+				xlrec = (xl_heap_insert *) XLogRecGetData(xlogreader);
+				if ((xlrec->flags & XLH_INSERT_ALL_VISIBLE_CLEARED) != 0)
+					mark_vm_block_modified(brtab, xlogreader, 0);
+				break;
+			}
+		case XLOG_HEAP_DELETE:
+			{
+				xl_heap_delete *xlrec;
+
+				xlrec = (xl_heap_delete *) XLogRecGetData(xlogreader);
+				if ((xlrec->flags & XLH_DELETE_ALL_VISIBLE_CLEARED) != 0)
+					mark_vm_block_modified(brtab, xlogreader, 0);
+				break;
+			}
+		case XLOG_HEAP_UPDATE:
+		case XLOG_HEAP_HOT_UPDATE:
+			{
+				xl_heap_update *xlrec;
+
+				xlrec = (xl_heap_update *) XLogRecGetData(xlogreader);
+				/* The old page is block 1 if it differs from the new one. */
+				if ((xlrec->flags & XLH_UPDATE_OLD_ALL_VISIBLE_CLEARED) != 0)
+					mark_vm_block_modified(brtab, xlogreader,
+										   XLogRecHasBlockRef(xlogreader, 1) ? 1 : 0);
+				if ((xlrec->flags & XLH_UPDATE_NEW_ALL_VISIBLE_CLEARED) != 0)
+					mark_vm_block_modified(brtab, xlogreader, 0);
+				break;
+			}
+		case XLOG_HEAP_LOCK:
+			{
+				xl_heap_lock *xlrec;
+
+				xlrec = (xl_heap_lock *) XLogRecGetData(xlogreader);
+				if ((xlrec->flags & XLH_LOCK_ALL_FROZEN_CLEARED) != 0)
+					mark_vm_block_modified(brtab, xlogreader, 0);
+				break;
+			}
+		default:
+			break;
+	}
+}
+
+/*
+ * Like SummarizeHeapRecord(), for RM_HEAP2_ID records.
+ */
+static void
+SummarizeHeap2Record(BlockRefTable *brtab, XLogReaderState *xlogreader)
+{
+	uint8		info = XLogRecGetInfo(xlogreader) & XLOG_HEAP_OPMASK;
+
+	switch (info)
+	{
+		case XLOG_HEAP2_MULTI_INSERT:
+			{
+				xl_heap_multi_insert *xlrec;
+
+				xlrec = (xl_heap_multi_insert *) XLogRecGetData(xlogreader);
+				if ((xlrec->flags & XLH_INSERT_ALL_VISIBLE_CLEARED) != 0)
+					mark_vm_block_modified(brtab, xlogreader, 0);
+				break;
+			}
+		case XLOG_HEAP2_LOCK_UPDATED:
+			{
+				xl_heap_lock_updated *xlrec;
+
+				xlrec = (xl_heap_lock_updated *) XLogRecGetData(xlogreader);
+				if ((xlrec->flags & XLH_LOCK_ALL_FROZEN_CLEARED) != 0)
+					mark_vm_block_modified(brtab, xlogreader, 0);
+				break;
+			}
+		default:
+			break;
+	}
+}
+
+/*
+ * Mark the visibility map page covering the heap page of the given block
+ * reference as modified.
+ */
+static void
+mark_vm_block_modified(BlockRefTable *brtab, XLogReaderState *xlogreader,
+					   uint8 block_id)
+{
+	RelFileNode rnode;
+	ForkNumber	forknum;
+	BlockNumber blocknum;
+
+	if (!XLogRecGetBlockTag(xlogreader, block_id, &rnode, &forknum,
+							&blocknum))
+		return;
+
+	BlockRefTableMarkBlockModified(brtab, &rnode, VISIBILITYMAP_FORKNUM,
+								   visibilitymap_map_block(blocknum));
+}
@@ -18,9 +18,11 @@
 
 #include "access/timeline.h"
 #include "access/xlog_internal.h"	/* for pg_start/stop_backup */
+#include "catalog/pg_tablespace_d.h"
 #include "catalog/pg_type.h"
 #include "common/checksum_helper.h"
 #include "common/file_perm.h"
+#include "common/incremental_backup.h"
 #include "commands/progress.h"
 #include "lib/stringinfo.h"
 #include "libpq/libpq.h"
@@ -32,6 +34,9 @@
 #include "port.h"
 #include "postmaster/syslogger.h"
 #include "replication/basebackup.h"
+#include "replication/basebackup_compress.h"
+#include "replication/basebackup_incremental.h"
+#include "replication/basebackup_parallel.h"
 #include "replication/walsender.h"
 #include "replication/walsender_private.h"
 #include "storage/buffile.h"
@@ -41,6 +46,7 @@
 #include "storage/fd.h"
 #include "storage/ipc.h"
 #include "storage/reinit.h"
+#include "storage/smgr.h"
 #include "utils/builtins.h"
 #include "utils/json.h"
 #include "utils/ps_status.h"
@@ -66,6 +72,12 @@ typedef struct
 	bool		sendtblspcmapfile;
 	manifest_option manifest;
 	pg_checksum_type manifest_checksum_type;
+	IncrementalBackupInfo *incremental;
+	pg_backup_compression compression;
+	int			compression_level;	/* -1 for the default */
+	int			compression_workers;
+	int			parallel;		/* connections, leader included, or 0 */
+	int			parallel_leader_pid;	/* leader to join as a worker, or 0 */
 } basebackup_options;
 
 struct manifest_info
@@ -83,11 +95,22 @@ struct manifest_info
 static int64 sendDir(const char *path, int basepathlen, bool sizeonly,
 					 List *tablespaces, bool sendtblspclinks,
 					 manifest_info *manifest, const char *spcoid);
+static bool sendIncrementalFile(const char *readfilename,
+								const char *tarfilename,
+								struct stat *statbuf, unsigned segno,
+								Oid dboid, manifest_info *manifest,
+								const char *spcoid,
+								unsigned num_blocks_required,
+								const BlockNumber *relative_block_numbers,
+								unsigned truncation_block_length);
 static bool sendFile(const char *readfilename, const char *tarfilename,
 					 struct stat *statbuf, bool missing_ok, Oid dboid,
 					 manifest_info *manifest, const char *spcoid);
 static void sendFileWithContent(const char *filename, const char *content,
 								manifest_info *manifest);
+static void sendTarData(const char *data, size_t len);
+static void startTarStream(void);
+static void endTarStream(void);
 static int64 _tarWriteHeader(const char *filename, const char *linktarget,
 							 struct stat *statbuf, bool sizeonly);
 static int64 _tarWriteDir(const char *pathbuf, int basepathlen, struct stat *statbuf,
@@ -105,11 +128,14 @@ static void AddFileToManifest(manifest_info *manifest, const char *spcoid,
 static void AddWALInfoToManifest(manifest_info *manifest, XLogRecPtr startptr,
 								 TimeLineID starttli, XLogRecPtr endptr,
 								 TimeLineID endtli);
+static void AppendWorkerManifests(manifest_info *manifest);
 static void SendBackupManifest(manifest_info *manifest);
 static void perform_base_backup(basebackup_options *opt);
+static void perform_parallel_backup_worker(basebackup_options *opt);
 static void parse_basebackup_options(List *options, basebackup_options *opt);
 static void SendXlogRecPtrResult(XLogRecPtr ptr, TimeLineID tli);
 static int	compareWalFileNames(const ListCell *a, const ListCell *b);
+static void setup_throttling(uint32 maxrate);
 static void throttle(size_t increment);
 static void update_basebackup_progress(int64 delta);
 static bool is_checksummed_file(const char *fullpath, const char *filename);
@@ -117,9 +143,6 @@ static bool is_checksummed_file(const char *fullpath, const char *filename);
 /* Was the backup currently in-progress initiated in recovery mode? */
 static bool backup_started_in_recovery = false;
 
-/* Relative path of temporary statistics directory */
-static char *statrelpath = NULL;
-
 /*
  * Size of each block sent into the tar stream for larger files.
  */
@@ -173,6 +196,22 @@ static long long int total_checksum_failures;
 /* Do not verify checksums. */
 static bool noverify_checksums = false;
 
+/*
+ * For an incremental backup, what changed since the prior backup, and a
+ * RELSEG_SIZE-long scratch array for the blocks of one file to send.
+ */
+static IncrementalBackupInfo *incremental_info = NULL;
+static BlockNumber *relative_block_numbers = NULL;
+
+/* Compressor for the tar streams, if the client asked for compression. */
+static BackupCompressor *tar_compressor = NULL;
+
+/*
+ * The parallel backup we're taking part in, if any.  For the leader, this
+ * is only set while the workers may still be sending files.
+ */
+static ParallelBackupState *parallel_backup = NULL;
+
 /*
  * Total amount of backup data that will be streamed.
  * -1 means that the size is not estimated.
@@ -205,9 +244,8 @@ struct exclude_list_item
 static const char *const excludeDirContents[] =
 {
 	/*
-	 * Skip temporary statistics files. PG_STAT_TMP_DIR must be skipped even
-	 * when stats_temp_directory is set because PGSS_TEXT_FILE is always
-	 * created there.
+	 * Skip temporary statistics files, such as PGSS_TEXT_FILE of
+	 * pg_stat_statements.
 	 */
 	PG_STAT_TMP_DIR,
 
@@ -313,7 +351,6 @@ perform_base_backup(basebackup_options *opt)
 	StringInfo	labelfile;
 	StringInfo	tblspc_map_file = NULL;
 	manifest_info manifest;
-	int			datadirpathlen;
 	List	   *tablespaces = NIL;
 
 	backup_total = 0;
@@ -336,8 +373,6 @@ perform_base_backup(basebackup_options *opt)
 	Assert(CurrentResourceOwner == NULL);
 	CurrentResourceOwner = ResourceOwnerCreate(NULL, "base backup");
 
-	datadirpathlen = strlen(DataDir);
-
 	backup_started_in_recovery = RecoveryInProgress();
 
 	labelfile = makeStringInfo();
@@ -345,6 +380,13 @@ perform_base_backup(basebackup_options *opt)
 	InitializeManifest(&manifest, opt);
 
 	total_checksum_failures = 0;
+	incremental_info = NULL;
+	parallel_backup = NULL;
+	tar_compressor = NULL;
+	if (opt->compression != BACKUP_COMPRESSION_NONE)
+		tar_compressor = CreateBackupCompressor(opt->compression,
+												opt->compression_level,
+												opt->compression_workers);
 
 	pgstat_progress_update_param(PROGRESS_BASEBACKUP_PHASE,
 								 PROGRESS_BASEBACKUP_PHASE_WAIT_CHECKPOINT);
@@ -367,16 +409,26 @@ perform_base_backup(basebackup_options *opt)
 		int			tblspc_streamed = 0;
 
 		/*
-		 * Calculate the relative path of temporary statistics directory in
-		 * order to skip the files which are located in that directory later.
+		 * For an incremental backup, find out what has changed since the
+		 * prior backup.  do_pg_start_backup() estimated the tablespace sizes
+		 * as if every file was sent in full, so estimate them again.
 		 */
-		if (is_absolute_path(pgstat_stat_directory) &&
-			strncmp(pgstat_stat_directory, DataDir, datadirpathlen) == 0)
-			statrelpath = psprintf("./%s", pgstat_stat_directory + datadirpathlen + 1);
-		else if (strncmp(pgstat_stat_directory, "./", 2) != 0)
-			statrelpath = psprintf("./%s", pgstat_stat_directory);
-		else
-			statrelpath = pgstat_stat_directory;
+		if (opt->incremental != NULL)
+		{
+			PrepareForIncrementalBackup(opt->incremental, startptr, starttli,
+										labelfile);
+			relative_block_numbers = palloc(sizeof(BlockNumber) * RELSEG_SIZE);
+			incremental_info = opt->incremental;
+
+			if (opt->progress)
+			{
+				foreach(lc, tablespaces)
+				{
+					ti = (tablespaceinfo *) lfirst(lc);
+					ti->size = sendTablespace(ti->path, ti->oid, true, NULL);
+				}
+			}
+		}
 
 		/* Add a node for the base directory at the end */
 		ti = palloc0(sizeof(tablespaceinfo));
@@ -415,6 +467,30 @@ perform_base_backup(basebackup_options *opt)
 			pgstat_progress_update_multi_param(3, index, val);
 		}
 
+		/*
+		 * In a parallel backup, let the workers join before the client
+		 * learns about the tablespaces and opens their connections.
+		 */
+		if (opt->parallel > 0)
+		{
+			ParallelBackupParams params;
+
+			params.nparticipants = opt->parallel;
+			params.startptr = startptr;
+			params.started_in_recovery = backup_started_in_recovery;
+			params.noverify_checksums = noverify_checksums;
+			params.maxrate = opt->maxrate;
+			params.compression = opt->compression;
+			params.compression_level = opt->compression_level;
+			params.compression_workers = opt->compression_workers;
+			params.manifest = (opt->manifest != MANIFEST_OPTION_NO);
+			params.manifest_force_encode =
+				(opt->manifest == MANIFEST_OPTION_FORCE_ENCODE);
+			params.manifest_checksum_type = opt->manifest_checksum_type;
+
+			parallel_backup = ParallelBackupBegin(&params, tablespaces);
+		}
+
 		/* Send the starting position of the backup */
 		SendXlogRecPtrResult(startptr, starttli);
 
@@ -422,40 +498,14 @@ perform_base_backup(basebackup_options *opt)
 		SendBackupHeader(tablespaces);
 
 		/* Setup and activate network throttling, if client requested it */
-		if (opt->maxrate > 0)
-		{
-			throttling_sample =
-				(int64) opt->maxrate * (int64) 1024 / THROTTLING_FREQUENCY;
-
-			/*
-			 * The minimum amount of time for throttling_sample bytes to be
-			 * transferred.
-			 */
-			elapsed_min_unit = USECS_PER_SEC / THROTTLING_FREQUENCY;
-
-			/* Enable throttling. */
-			throttling_counter = 0;
-
-			/* The 'real data' starts now (header was ignored). */
-			throttled_last = GetCurrentTimestamp();
-		}
-		else
-		{
-			/* Disable throttling. */
-			throttling_counter = -1;
-		}
+		setup_throttling(opt->maxrate);
 
 		/* Send off our tablespaces one by one */
 		foreach(lc, tablespaces)
 		{
 			tablespaceinfo *ti = (tablespaceinfo *) lfirst(lc);
-			StringInfoData buf;
 
-			/* Send CopyOutResponse message */
-			pq_beginmessage(&buf, 'H');
-			pq_sendbyte(&buf, 0);	/* overall format */
-			pq_sendint16(&buf, 0);	/* natts */
-			pq_endmessage(&buf);
+			startTarStream();
 
 			if (ti->path == NULL)
 			{
@@ -480,6 +530,19 @@ perform_base_backup(basebackup_options *opt)
 					sendDir(".", 1, false, tablespaces, true,
 							&manifest, NULL);
 
+				/*
+				 * In a parallel backup, the workers must be done with their
+				 * share of the files before pg_control is sent, too.
+				 */
+				if (parallel_backup != NULL)
+				{
+					ParallelBackupWaitForWorkers(parallel_backup,
+												 &total_checksum_failures);
+					AppendWorkerManifests(&manifest);
+					ParallelBackupEnd(parallel_backup);
+					parallel_backup = NULL;
+				}
+
 				/* ... and pg_control after everything else. */
 				if (lstat(XLOG_CONTROL_FILE, &statbuf) != 0)
 					ereport(ERROR,
@@ -503,7 +566,7 @@ perform_base_backup(basebackup_options *opt)
 				Assert(lnext(tablespaces, lc) == NULL);
 			}
 			else
-				pq_putemptymessage('c');	/* CopyDone */
+				endTarStream();
 
 			tblspc_streamed++;
 			pgstat_progress_update_param(PROGRESS_BASEBACKUP_TBLSPC_STREAMED,
@@ -686,9 +749,7 @@ perform_base_backup(basebackup_options *opt)
 			{
 				CheckXLogRemoved(segno, tli);
 				/* Send the chunk as a CopyData message */
-				if (pq_putmessage('d', buf, cnt))
-					ereport(ERROR,
-							(errmsg("base backup could not send data, aborting backup")));
+				sendTarData(buf, cnt);
 				update_basebackup_progress(cnt);
 
 				len += cnt;
@@ -751,7 +812,7 @@ perform_base_backup(basebackup_options *opt)
 		}
 
 		/* Send CopyDone message for the last tar file */
-		pq_putemptymessage('c');
+		endTarStream();
 	}
 
 	AddWALInfoToManifest(&manifest, startptr, starttli, endptr, endtli);
@@ -777,6 +838,107 @@ perform_base_backup(basebackup_options *opt)
 	pgstat_progress_end_command();
 }
 
+/*
+ * Take part in a parallel base backup as a worker.
+ *
+ * The leader has started the backup, and sends everything but a share of
+ * the files.  We send the rest, as one tar stream for each tablespace, in
+ * the same order as the leader.  Our manifest entries go to a file that the
+ * leader appends to its manifest, and our checksum failures are reported
+ * by the leader, too.
+ */
+static void
+perform_parallel_backup_worker(basebackup_options *opt)
+{
+	ParallelBackupParams params;
+	List	   *tablespaces;
+	ListCell   *lc;
+	manifest_info manifest;
+	int			tblspc_streamed = 0;
+
+	backup_total = -1;
+	backup_streamed = 0;
+	pgstat_progress_start_command(PROGRESS_COMMAND_BASEBACKUP, InvalidOid);
+	pgstat_progress_update_param(PROGRESS_BASEBACKUP_BACKUP_TOTAL,
+								 backup_total);
+
+	/* we're going to use a BufFile, so we need a ResourceOwner */
+	Assert(CurrentResourceOwner == NULL);
+	CurrentResourceOwner = ResourceOwnerCreate(NULL, "base backup");
+
+	parallel_backup = ParallelBackupJoin(opt->parallel_leader_pid, &params,
+										 &tablespaces);
+
+	startptr = params.startptr;
+	backup_started_in_recovery = params.started_in_recovery;
+	noverify_checksums = params.noverify_checksums;
+	total_checksum_failures = 0;
+	incremental_info = NULL;
+	tar_compressor = NULL;
+	if (params.compression != BACKUP_COMPRESSION_NONE)
+		tar_compressor = CreateBackupCompressor(params.compression,
+												params.compression_level,
+												params.compression_workers);
+
+	/*
+	 * The leader writes the start and the end of the manifest, and its
+	 * checksum, so our entries all just follow on from the previous one.
+	 */
+	if (params.manifest)
+		manifest.buffile = ParallelBackupCreateManifest(parallel_backup);
+	else
+		manifest.buffile = NULL;
+	manifest.checksum_type = params.manifest_checksum_type;
+	manifest.manifest_size = UINT64CONST(0);
+	manifest.force_encode = params.manifest_force_encode;
+	manifest.first_file = false;
+	manifest.still_checksumming = false;
+
+	{
+		const int	index[] = {
+			PROGRESS_BASEBACKUP_PHASE,
+			PROGRESS_BASEBACKUP_TBLSPC_TOTAL
+		};
+		const int64 val[] = {
+			PROGRESS_BASEBACKUP_PHASE_STREAM_BACKUP,
+			list_length(tablespaces)
+		};
+
+		pgstat_progress_update_multi_param(2, index, val);
+	}
+
+	setup_throttling(params.maxrate);
+
+	foreach(lc, tablespaces)
+	{
+		tablespaceinfo *ti = (tablespaceinfo *) lfirst(lc);
+
+		startTarStream();
+
+		/* The leader sends the tablespace links, if needed */
+		if (ti->path == NULL)
+			sendDir(".", 1, false, tablespaces, false, &manifest, NULL);
+		else
+			sendTablespace(ti->path, ti->oid, false, &manifest);
+
+		endTarStream();
+
+		tblspc_streamed++;
+		pgstat_progress_update_param(PROGRESS_BASEBACKUP_TBLSPC_STREAMED,
+									 tblspc_streamed);
+	}
+
+	ParallelBackupWorkerDone(parallel_backup, manifest.buffile,
+							 total_checksum_failures);
+	ParallelBackupEnd(parallel_backup);
+	parallel_backup = NULL;
+
+	/* clean up the resource owner we created */
+	WalSndResourceCleanup(true);
+
+	pgstat_progress_end_command();
+}
+
 /*
  * list_sort comparison function, to compare log/seg portion of WAL segment
  * filenames, ignoring the timeline portion.
@@ -807,10 +969,18 @@ parse_basebackup_options(List *options, basebackup_options *opt)
 	bool		o_noverify_checksums = false;
 	bool		o_manifest = false;
 	bool		o_manifest_checksums = false;
+	bool		o_incremental = false;
+	bool		o_compression = false;
+	bool		o_compression_level = false;
+	bool		o_compression_workers = false;
+	bool		o_parallel = false;
+	bool		o_parallel_worker = false;
 
 	MemSet(opt, 0, sizeof(*opt));
 	opt->manifest = MANIFEST_OPTION_NO;
 	opt->manifest_checksum_type = CHECKSUM_TYPE_CRC32C;
+	opt->compression = BACKUP_COMPRESSION_NONE;
+	opt->compression_level = -1;
 
 	foreach(lopt, options)
 	{
@@ -939,6 +1109,82 @@ parse_basebackup_options(List *options, basebackup_options *opt)
 								optval)));
 			o_manifest_checksums = true;
 		}
+		else if (strcmp(defel->defname, "incremental") == 0)
+		{
+			List	   *args = (List *) defel->arg;
+			uint32		hi,
+						lo;
+
+			if (o_incremental)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("duplicate option \"%s\"", defel->defname)));
+			if (sscanf(strVal(linitial(args)), "%X/%X", &hi, &lo) != 2)
+				elog(ERROR, "invalid prior backup location \"%s\"",
+					 strVal(linitial(args)));
+			opt->incremental =
+				CreateIncrementalBackupInfo(((uint64) hi) << 32 | lo,
+											(TimeLineID) intVal(lsecond(args)));
+			o_incremental = true;
+		}
+		else if (strcmp(defel->defname, "compression") == 0)
+		{
+			char	   *optval = strVal(defel->arg);
+
+			if (o_compression)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("duplicate option \"%s\"", defel->defname)));
+			if (!parse_backup_compression(optval, &opt->compression))
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("unrecognized compression method: \"%s\"",
+								optval)));
+			o_compression = true;
+		}
+		else if (strcmp(defel->defname, "compression_level") == 0)
+		{
+			if (o_compression_level)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("duplicate option \"%s\"", defel->defname)));
+			opt->compression_level = intVal(defel->arg);
+			o_compression_level = true;
+		}
+		else if (strcmp(defel->defname, "compression_workers") == 0)
+		{
+			if (o_compression_workers)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("duplicate option \"%s\"", defel->defname)));
+			opt->compression_workers = intVal(defel->arg);
+			o_compression_workers = true;
+		}
+		else if (strcmp(defel->defname, "parallel") == 0)
+		{
+			int			parallel = intVal(defel->arg);
+
+			if (o_parallel)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("duplicate option \"%s\"", defel->defname)));
+			if (parallel < 2 || parallel > max_wal_senders)
+				ereport(ERROR,
+						(errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+						 errmsg("%d is outside the valid range for parameter \"%s\" (%d .. %d)",
+								parallel, "PARALLEL", 2, max_wal_senders)));
+			opt->parallel = parallel;
+			o_parallel = true;
+		}
+		else if (strcmp(defel->defname, "parallel_worker") == 0)
+		{
+			if (o_parallel_worker)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("duplicate option \"%s\"", defel->defname)));
+			opt->parallel_leader_pid = intVal(defel->arg);
+			o_parallel_worker = true;
+		}
 		else
 			elog(ERROR, "option \"%s\" not recognized",
 				 defel->defname);
@@ -953,6 +1199,39 @@ parse_basebackup_options(List *options, basebackup_options *opt)
 					 errmsg("manifest checksums require a backup manifest")));
 		opt->manifest_checksum_type = CHECKSUM_TYPE_NONE;
 	}
+
+	/*
+	 * An incremental backup can only be used together with its manifest,
+	 * which is what identifies it as the prior backup of the next one.
+	 */
+	if (o_incremental && opt->manifest == MANIFEST_OPTION_NO)
+		ereport(ERROR,
+				(errcode(ERRCODE_SYNTAX_ERROR),
+				 errmsg("incremental backups require a backup manifest")));
+
+	if ((o_compression_level || o_compression_workers) &&
+		opt->compression == BACKUP_COMPRESSION_NONE)
+		ereport(ERROR,
+				(errcode(ERRCODE_SYNTAX_ERROR),
+				 errmsg("compression level and workers require a compression method")));
+	CheckBackupCompressionOptions(opt->compression, opt->compression_level,
+								  opt->compression_workers);
+
+	/*
+	 * The workers of a parallel backup can't tell what changed since the
+	 * prior backup, so incremental backups are only taken by one process.
+	 */
+	if (o_parallel && o_incremental)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("incremental backups cannot be taken in parallel")));
+
+	/* A worker gets all its options from the leader */
+	if (o_parallel_worker && list_length(options) > 1)
+		ereport(ERROR,
+				(errcode(ERRCODE_SYNTAX_ERROR),
+				 errmsg("option \"%s\" cannot be combined with other options",
+						"PARALLEL_WORKER")));
 }
 
 
@@ -981,7 +1260,10 @@ SendBaseBackup(BaseBackupCmd *cmd)
 		set_ps_display(activitymsg);
 	}
 
-	perform_base_backup(&opt);
+	if (opt.parallel_leader_pid != 0)
+		perform_parallel_backup_worker(&opt);
+	else
+		perform_base_backup(&opt);
 }
 
 static void
@@ -1332,6 +1614,35 @@ AddWALInfoToManifest(manifest_info *manifest, XLogRecPtr startptr,
 	AppendStringToManifest(manifest, "\n],\n");
 }
 
+/*
+ * Append the manifest entries written by the workers of a parallel backup.
+ * The leader always sends backup_label first, so they can all follow on
+ * from the entries already there.
+ */
+static void
+AppendWorkerManifests(manifest_info *manifest)
+{
+	int			nworkers = ParallelBackupNumWorkers(parallel_backup);
+	int			i;
+
+	if (!IsManifestEnabled(manifest))
+		return;
+
+	for (i = 1; i <= nworkers; i++)
+	{
+		BufFile    *file = ParallelBackupOpenManifest(parallel_backup, i);
+		char		buf[BLCKSZ + 1];
+		size_t		nread;
+
+		while ((nread = BufFileRead(file, buf, BLCKSZ)) > 0)
+		{
+			buf[nread] = '\0';
+			AppendStringToManifest(manifest, buf);
+		}
+		BufFileClose(file);
+	}
+}
+
 /*
  * Finalize the backup manifest, and send it to the client.
  */
@@ -1501,7 +1812,7 @@ sendFileWithContent(const char *filename, const char *content,
 
 	_tarWriteHeader(filename, NULL, &statbuf, false);
 	/* Send the contents as a CopyData message */
-	pq_putmessage('d', content, len);
+	sendTarData(content, len);
 	update_basebackup_progress(len);
 
 	/* Pad to 512 byte boundary, per tar format requirements */
@@ -1511,7 +1822,7 @@ sendFileWithContent(const char *filename, const char *content,
 		char		buf[512];
 
 		MemSet(buf, 0, pad);
-		pq_putmessage('d', buf, pad);
+		sendTarData(buf, pad);
 		update_basebackup_progress(pad);
 	}
 
@@ -1592,6 +1903,7 @@ sendDir(const char *path, int basepathlen, bool sizeonly, List *tablespaces,
 	int64		size = 0;
 	const char *lastDir;		/* Split last dir from parent path. */
 	bool		isDbDir = false;	/* Does this directory contain relations? */
+	bool		isGlobalDir;	/* Is this the directory of shared relations? */
 
 	/*
 	 * Determine if the current path is a database directory that can contain
@@ -1620,6 +1932,7 @@ sendDir(const char *path, int basepathlen, bool sizeonly, List *tablespaces,
 					 sizeof(TABLESPACE_VERSION_DIRECTORY) - 1) == 0))
 			isDbDir = true;
 	}
+	isGlobalDir = (strcmp(path, "./global") == 0);
 
 	dir = AllocateDir(path);
 	while ((de = ReadDir(dir, path)) != NULL)
@@ -1648,6 +1961,8 @@ sendDir(const char *path, int basepathlen, bool sizeonly, List *tablespaces,
 		 * the backup early than continue to the end and fail there.
 		 */
 		CHECK_FOR_INTERRUPTS();
+		if (parallel_backup != NULL)
+			ParallelBackupCheckForFailure(parallel_backup);
 		if (RecoveryInProgress() != backup_started_in_recovery)
 			ereport(ERROR,
 					(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
@@ -1750,17 +2065,6 @@ sendDir(const char *path, int basepathlen, bool sizeonly, List *tablespaces,
 		if (excludeFound)
 			continue;
 
-		/*
-		 * Exclude contents of directory specified by statrelpath if not set
-		 * to the default (pg_stat_tmp) which is caught in the loop above.
-		 */
-		if (statrelpath != NULL && strcmp(pathbuf, statrelpath) == 0)
-		{
-			elog(DEBUG1, "contents of directory \"%s\" excluded from backup", statrelpath);
-			size += _tarWriteDir(pathbuf, basepathlen, &statbuf, sizeonly);
-			continue;
-		}
-
 		/*
 		 * We can skip pg_wal, the WAL segments need to be fetched from the
 		 * WAL archive anyway. But include it as an empty directory anyway, so
@@ -1869,8 +2173,66 @@ sendDir(const char *path, int basepathlen, bool sizeonly, List *tablespaces,
 		else if (S_ISREG(statbuf.st_mode))
 		{
 			bool		sent = false;
+			FileBackupMethod method = BACK_UP_FILE_FULLY;
+			unsigned	segno = 0;
+			unsigned	num_blocks_required = 0;
+			unsigned	truncation_block_length = 0;
+			pgoff_t		sendsize = statbuf.st_size;
+
+			/* In a parallel backup, other participants send some files */
+			if (parallel_backup != NULL && !sizeonly &&
+				!ParallelBackupIsMyFile(parallel_backup,
+										pathbuf + basepathlen + 1))
+				continue;
+
+			/*
+			 * In an incremental backup, relation files may be sent as just
+			 * the blocks changed since the prior backup.
+			 */
+			if (incremental_info != NULL && (isDbDir || isGlobalDir) &&
+				parse_filename_for_nontemp_relation(de->d_name, &relOidChars,
+													&relForkNum))
+			{
+				RelFileNode rnode;
+				const char *segpath = strchr(de->d_name, '.');
 
-			if (!sizeonly)
+				if (spcoid != NULL)
+					rnode.spcNode = atooid(spcoid);
+				else if (isGlobalDir)
+					rnode.spcNode = GLOBALTABLESPACE_OID;
+				else
+					rnode.spcNode = DEFAULTTABLESPACE_OID;
+				rnode.dbNode = isGlobalDir ? InvalidOid : atooid(lastDir + 1);
+				rnode.relNode = atooid(de->d_name);
+				if (segpath != NULL)
+					segno = atoi(segpath + 1);
+
+				method = GetFileBackupMethod(incremental_info, &rnode,
+											 relForkNum, segno,
+											 statbuf.st_size,
+											 &num_blocks_required,
+											 relative_block_numbers,
+											 &truncation_block_length);
+			}
+
+			if (method == BACK_UP_FILE_INCREMENTALLY)
+			{
+				char		tarfilename[MAXPGPATH * 2];
+
+				snprintf(tarfilename, sizeof(tarfilename), "%s/%s%s",
+						 path + basepathlen + 1, INCREMENTAL_PREFIX,
+						 de->d_name);
+				sendsize = INCREMENTAL_FILE_SIZE(num_blocks_required);
+				if (!sizeonly)
+					sent = sendIncrementalFile(pathbuf, tarfilename, &statbuf,
+											   segno,
+											   isDbDir ? atooid(lastDir + 1) : InvalidOid,
+											   manifest, spcoid,
+											   num_blocks_required,
+											   relative_block_numbers,
+											   truncation_block_length);
+			}
+			else if (!sizeonly)
 				sent = sendFile(pathbuf, pathbuf + basepathlen + 1, &statbuf,
 								true, isDbDir ? atooid(lastDir + 1) : InvalidOid,
 								manifest, spcoid);
@@ -1878,7 +2240,7 @@ sendDir(const char *path, int basepathlen, bool sizeonly, List *tablespaces,
 			if (sent || sizeonly)
 			{
 				/* Add size, rounded up to 512byte block */
-				size += ((statbuf.st_size + 511) & ~511);
+				size += ((sendsize + 511) & ~511);
 				size += 512;	/* Size of the header of the file */
 			}
 		}
@@ -2130,9 +2492,7 @@ sendFile(const char *readfilename, const char *tarfilename,
 		}
 
 		/* Send the chunk as a CopyData message */
-		if (pq_putmessage('d', buf, cnt))
-			ereport(ERROR,
-					(errmsg("base backup could not send data, aborting backup")));
+		sendTarData(buf, cnt);
 		update_basebackup_progress(cnt);
 
 		/* Also feed it to the checksum machinery. */
@@ -2161,7 +2521,7 @@ sendFile(const char *readfilename, const char *tarfilename,
 		while (len < statbuf->st_size)
 		{
 			cnt = Min(sizeof(buf), statbuf->st_size - len);
-			pq_putmessage('d', buf, cnt);
+			sendTarData(buf, cnt);
 			pg_checksum_update(&checksum_ctx, (uint8 *) buf, cnt);
 			update_basebackup_progress(cnt);
 			len += cnt;
@@ -2178,7 +2538,7 @@ sendFile(const char *readfilename, const char *tarfilename,
 	if (pad > 0)
 	{
 		MemSet(buf, 0, pad);
-		pq_putmessage('d', buf, pad);
+		sendTarData(buf, pad);
 		update_basebackup_progress(pad);
 	}
 
@@ -2204,6 +2564,215 @@ sendFile(const char *readfilename, const char *tarfilename,
 }
 
 
+/*
+ * Send the blocks of a relation segment listed in relative_block_numbers,
+ * as an incremental file named tarfilename (see common/incremental_backup.h
+ * for the format).
+ *
+ * Page checksums of the blocks sent are verified as in sendFile(), and
+ * checksum failures are reported the same way.
+ *
+ * Returns true if the file was successfully sent, false if it no longer
+ * exists.
+ */
+static bool
+sendIncrementalFile(const char *readfilename, const char *tarfilename,
+					struct stat *statbuf, unsigned segno, Oid dboid,
+					manifest_info *manifest, const char *spcoid,
+					unsigned num_blocks_required,
+					const BlockNumber *relative_block_numbers,
+					unsigned truncation_block_length)
+{
+	int			fd;
+	struct stat incstatbuf;
+	uint32		header[3];
+	PGAlignedBlock buf;
+	char	   *page = buf.data;
+	PageHeader	phdr = (PageHeader) page;
+	uint16		checksum;
+	int			checksum_failures = 0;
+	bool		verify_checksum = false;
+	pgoff_t		len = 0;
+	size_t		pad;
+	unsigned	i;
+	pg_checksum_context checksum_ctx;
+
+	pg_checksum_init(&checksum_ctx, manifest->checksum_type);
+
+	fd = OpenTransientFile(readfilename, O_RDONLY | PG_BINARY);
+	if (fd < 0)
+	{
+		if (errno == ENOENT)
+			return false;
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not open file \"%s\": %m", readfilename)));
+	}
+
+	memcpy(&incstatbuf, statbuf, sizeof(struct stat));
+	incstatbuf.st_size = INCREMENTAL_FILE_SIZE(num_blocks_required);
+	_tarWriteHeader(tarfilename, NULL, &incstatbuf, false);
+
+	if (!noverify_checksums && DataChecksumsEnabled() &&
+		is_checksummed_file(readfilename, last_dir_separator(readfilename) + 1))
+		verify_checksum = true;
+
+	/* The header, followed by the block numbers. */
+	header[0] = INCREMENTAL_MAGIC;
+	header[1] = num_blocks_required;
+	header[2] = truncation_block_length;
+	sendTarData((char *) header, sizeof(header));
+	if (num_blocks_required > 0)
+		sendTarData((char *) relative_block_numbers,
+					sizeof(BlockNumber) * num_blocks_required);
+	pg_checksum_update(&checksum_ctx, (uint8 *) header, sizeof(header));
+	pg_checksum_update(&checksum_ctx, (uint8 *) relative_block_numbers,
+					   sizeof(BlockNumber) * num_blocks_required);
+	len = INCREMENTAL_FILE_SIZE(0) + sizeof(BlockNumber) * num_blocks_required;
+	update_basebackup_progress(len);
+	throttle(len);
+
+	/* Then the blocks themselves. */
+	for (i = 0; i < num_blocks_required; i++)
+	{
+		BlockNumber relblkno = relative_block_numbers[i];
+		bool		block_retry = false;
+		int			rc;
+
+		CHECK_FOR_INTERRUPTS();
+
+retry:
+		rc = pg_pread(fd, page, BLCKSZ, (off_t) relblkno * BLCKSZ);
+		if (rc < 0)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not read file \"%s\": %m", readfilename)));
+
+		/*
+		 * If the file was truncated while we were sending it, send zeros in
+		 * place of the missing data; it will be restored from WAL.
+		 */
+		if (rc < BLCKSZ)
+		{
+			MemSet(page + rc, 0, BLCKSZ - rc);
+		}
+		else if (verify_checksum && !PageIsNew(page) &&
+				 PageGetLSN(page) < startptr)
+		{
+			/* Same rules as in sendFile(), including one retry per block. */
+			checksum = pg_checksum_page(page, relblkno + segno * RELSEG_SIZE);
+			if (phdr->pd_checksum != checksum)
+			{
+				if (!block_retry)
+				{
+					block_retry = true;
+					goto retry;
+				}
+
+				checksum_failures++;
+
+				if (checksum_failures <= 5)
+					ereport(WARNING,
+							(errmsg("checksum verification failed in "
+									"file \"%s\", block %u: calculated "
+									"%X but expected %X",
+									readfilename, relblkno, checksum,
+									phdr->pd_checksum)));
+				if (checksum_failures == 5)
+					ereport(WARNING,
+							(errmsg("further checksum verification "
+									"failures in file \"%s\" will not "
+									"be reported", readfilename)));
+			}
+		}
+
+		sendTarData(page, BLCKSZ);
+		update_basebackup_progress(BLCKSZ);
+		pg_checksum_update(&checksum_ctx, (uint8 *) page, BLCKSZ);
+		len += BLCKSZ;
+		throttle(BLCKSZ);
+	}
+
+	Assert(len == incstatbuf.st_size);
+
+	/* Pad to 512 byte boundary, per tar format requirements. */
+	pad = ((len + 511) & ~511) - len;
+	if (pad > 0)
+	{
+		MemSet(page, 0, pad);
+		sendTarData(page, pad);
+		update_basebackup_progress(pad);
+	}
+
+	if (CloseTransientFile(fd) != 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not close file \"%s\": %m", readfilename)));
+
+	if (checksum_failures > 1)
+	{
+		ereport(WARNING,
+				(errmsg_plural("file \"%s\" has a total of %d checksum verification failure",
+							   "file \"%s\" has a total of %d checksum verification failures",
+							   checksum_failures,
+							   readfilename, checksum_failures)));
+
+		pgstat_report_checksum_failures_in_db(dboid, checksum_failures);
+	}
+
+	total_checksum_failures += checksum_failures;
+
+	AddFileToManifest(manifest, spcoid, tarfilename, incstatbuf.st_size,
+					  (pg_time_t) statbuf->st_mtime, &checksum_ctx);
+
+	return true;
+}
+
+
+/*
+ * Send data belonging to the current tar stream, compressing it first if
+ * the client asked for that.
+ */
+static void
+sendTarData(const char *data, size_t len)
+{
+	if (tar_compressor != NULL)
+		BackupCompressorWrite(tar_compressor, data, len);
+	else if (pq_putmessage('d', data, len))
+		ereport(ERROR,
+				(errmsg("base backup could not send data, aborting backup")));
+}
+
+/*
+ * Start sending a tar stream, as a CopyOutResponse.
+ */
+static void
+startTarStream(void)
+{
+	StringInfoData buf;
+
+	pq_beginmessage(&buf, 'H');
+	pq_sendbyte(&buf, 0);		/* overall format */
+	pq_sendint16(&buf, 0);		/* natts */
+	pq_endmessage(&buf);
+
+	if (tar_compressor != NULL)
+		BackupCompressorBegin(tar_compressor);
+}
+
+/*
+ * Finish the current tar stream.  A compressed stream is a complete tar
+ * file, including the trailer that the client adds to others.
+ */
+static void
+endTarStream(void)
+{
+	if (tar_compressor != NULL)
+		BackupCompressorEnd(tar_compressor);
+
+	pq_putemptymessage('c');	/* CopyDone */
+}
+
 static int64
 _tarWriteHeader(const char *filename, const char *linktarget,
 				struct stat *statbuf, bool sizeonly)
@@ -2236,7 +2805,7 @@ _tarWriteHeader(const char *filename, const char *linktarget,
 				elog(ERROR, "unrecognized tar error: %d", rc);
 		}
 
-		pq_putmessage('d', h, sizeof(h));
+		sendTarData(h, sizeof(h));
 		update_basebackup_progress(sizeof(h));
 	}
 
@@ -2262,6 +2831,37 @@ _tarWriteDir(const char *pathbuf, int basepathlen, struct stat *statbuf,
 	return _tarWriteHeader(pathbuf + basepathlen + 1, NULL, statbuf, sizeonly);
 }
 
+/*
+ * Set up network throttling to maxrate kilobytes per second, or disable it
+ * if maxrate is 0.
+ */
+static void
+setup_throttling(uint32 maxrate)
+{
+	if (maxrate > 0)
+	{
+		throttling_sample =
+			(int64) maxrate * (int64) 1024 / THROTTLING_FREQUENCY;
+
+		/*
+		 * The minimum amount of time for throttling_sample bytes to be
+		 * transferred.
+		 */
+		elapsed_min_unit = USECS_PER_SEC / THROTTLING_FREQUENCY;
+
+		/* Enable throttling. */
+		throttling_counter = 0;
+
+		/* The 'real data' starts now (header was ignored). */
+		throttled_last = GetCurrentTimestamp();
+	}
+	else
+	{
+		/* Disable throttling. */
+		throttling_counter = -1;
+	}
+}
+
 /*
  * Increment the network transfer counter by the given number of bytes,
  * and sleep if necessary to comply with the requested network transfer
@@ -0,0 +1,475 @@
+/*-------------------------------------------------------------------------
+ *
+ * basebackup_compress.c
+ *	  compress the tar streams of a base backup on the server
+ *
+ * With the COMPRESSION option of BASE_BACKUP, each tar stream is compressed
+ * before it is sent, so that the client receives a .tar.gz, .tar.lz4 or
+ * .tar.zst file.  This saves network bandwidth, and with zstd the work can
+ * be spread over several threads.  The compressed stream of each tablespace
+ * is a single gzip member, LZ4 frame or zstd frame, which the usual
+ * command-line tools can decompress.
+ *
+ * Since a compressed stream can't be appended to by the client, it's
+ * terminated by the two zero blocks that mark the end of a tar archive.
+ *
+ * The compression libraries allocate their state with malloc(), so it is
+ * released by a reset callback of the memory context the compressor lives
+ * in, both after success and after an error.
+ *
+ * Portions Copyright (c) 2010-2020, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  src/backend/replication/basebackup_compress.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+#ifdef USE_LZ4
+#include <lz4frame.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "libpq/libpq.h"
+#include "replication/basebackup_compress.h"
+#include "utils/memutils.h"
+
+/*
+ * Size of the buffer for compressed output, and of the pieces of input fed
+ * to LZ4 at a time, which must be bounded to bound its output.
+ */
+#define COMPRESS_BUFSIZE	65536
+#define LZ4_INPUT_CHUNK		32768
+
+struct BackupCompressor
+{
+	pg_backup_compression method;
+	int			level;			/* -1 means the library's default */
+	int			workers;		/* extra zstd threads, 0 for none */
+
+	/* Compressed data not yet sent */
+	char	   *outbuf;
+	size_t		outbufsize;
+	size_t		outlen;
+
+#ifdef HAVE_LIBZ
+	z_stream	zs;
+	bool		zs_initialized;
+#endif
+#ifdef USE_LZ4
+	LZ4F_compressionContext_t lz4ctx;
+	LZ4F_preferences_t lz4prefs;
+#endif
+#ifdef USE_ZSTD
+	ZSTD_CCtx  *zstdctx;
+#endif
+
+	MemoryContextCallback cleanup;
+};
+
+static void flush_output(BackupCompressor *bc);
+static void free_compressor(void *arg);
+
+/*
+ * Check that the given compression options can be used, before the backup
+ * starts.  level is -1 if not specified.
+ */
+void
+CheckBackupCompressionOptions(pg_backup_compression method, int level,
+							  int workers)
+{
+	int			min_level = 1;
+	int			max_level = 0;
+
+	if (!backup_compression_supported(method))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("compression method %s is not supported by this build",
+						backup_compression_name(method))));
+
+	switch (method)
+	{
+		case BACKUP_COMPRESSION_NONE:
+			break;
+		case BACKUP_COMPRESSION_GZIP:
+			max_level = 9;
+			break;
+		case BACKUP_COMPRESSION_LZ4:
+			max_level = 12;
+			break;
+		case BACKUP_COMPRESSION_ZSTD:
+#ifdef USE_ZSTD
+			max_level = ZSTD_maxCLevel();
+#endif
+			break;
+	}
+
+	if (level != -1 && (level < min_level || level > max_level))
+		ereport(ERROR,
+				(errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+				 errmsg("%d is outside the valid range for parameter \"%s\" (%d .. %d)",
+						level, "COMPRESSION_LEVEL", min_level, max_level)));
+
+	if (workers > 0 && method != BACKUP_COMPRESSION_ZSTD)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("compression method %s does not support compression workers",
+						backup_compression_name(method))));
+}
+
+/*
+ * Set up to compress tar streams with the given method, which must have
+ * been checked with CheckBackupCompressionOptions().
+ */
+BackupCompressor *
+CreateBackupCompressor(pg_backup_compression method, int level, int workers)
+{
+	BackupCompressor *bc = palloc0(sizeof(BackupCompressor));
+
+	Assert(method != BACKUP_COMPRESSION_NONE);
+
+	bc->method = method;
+	bc->level = level;
+	bc->workers = workers;
+	bc->outbufsize = COMPRESS_BUFSIZE;
+
+	bc->cleanup.func = free_compressor;
+	bc->cleanup.arg = bc;
+	MemoryContextRegisterResetCallback(CurrentMemoryContext, &bc->cleanup);
+
+	switch (method)
+	{
+		case BACKUP_COMPRESSION_NONE:
+		case BACKUP_COMPRESSION_GZIP:
+			break;
+
+		case BACKUP_COMPRESSION_LZ4:
+#ifdef USE_LZ4
+			{
+				LZ4F_errorCode_t err;
+
+				err = LZ4F_createCompressionContext(&bc->lz4ctx, LZ4F_VERSION);
+				if (LZ4F_isError(err))
+					ereport(ERROR,
+							(errmsg("could not create LZ4 compression context: %s",
+									LZ4F_getErrorName(err))));
+				if (level != -1)
+					bc->lz4prefs.compressionLevel = level;
+				bc->outbufsize = LZ4F_compressBound(LZ4_INPUT_CHUNK,
+													&bc->lz4prefs);
+			}
+#endif
+			break;
+
+		case BACKUP_COMPRESSION_ZSTD:
+#ifdef USE_ZSTD
+			{
+				size_t		ret;
+
+				bc->zstdctx = ZSTD_createCCtx();
+				if (bc->zstdctx == NULL)
+					ereport(ERROR,
+							(errcode(ERRCODE_OUT_OF_MEMORY),
+							 errmsg("out of memory")));
+				if (level != -1)
+				{
+					ret = ZSTD_CCtx_setParameter(bc->zstdctx,
+												 ZSTD_c_compressionLevel,
+												 level);
+					if (ZSTD_isError(ret))
+						ereport(ERROR,
+								(errmsg("could not set compression level %d: %s",
+										level, ZSTD_getErrorName(ret))));
+				}
+				if (workers > 0)
+				{
+					ret = ZSTD_CCtx_setParameter(bc->zstdctx,
+												 ZSTD_c_nbWorkers, workers);
+					if (ZSTD_isError(ret))
+						ereport(ERROR,
+								(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+								 errmsg("could not set compression worker count to %d: %s",
+										workers, ZSTD_getErrorName(ret))));
+				}
+				bc->outbufsize = ZSTD_CStreamOutSize();
+			}
+#endif
+			break;
+	}
+
+	bc->outbuf = palloc(bc->outbufsize);
+
+	return bc;
+}
+
+/*
+ * Start compressing a new tar stream.
+ */
+void
+BackupCompressorBegin(BackupCompressor *bc)
+{
+	bc->outlen = 0;
+
+	switch (bc->method)
+	{
+		case BACKUP_COMPRESSION_NONE:
+			break;
+
+		case BACKUP_COMPRESSION_GZIP:
+#ifdef HAVE_LIBZ
+			/* windowBits + 16 asks for a gzip header and trailer */
+			if (deflateInit2(&bc->zs,
+							 bc->level == -1 ? Z_DEFAULT_COMPRESSION : bc->level,
+							 Z_DEFLATED, 15 + 16, 8,
+							 Z_DEFAULT_STRATEGY) != Z_OK)
+				ereport(ERROR,
+						(errmsg("could not initialize compression library: %s",
+								bc->zs.msg ? bc->zs.msg : "unknown error")));
+			bc->zs_initialized = true;
+#endif
+			break;
+
+		case BACKUP_COMPRESSION_LZ4:
+#ifdef USE_LZ4
+			{
+				size_t		len;
+
+				len = LZ4F_compressBegin(bc->lz4ctx, bc->outbuf,
+										 bc->outbufsize, &bc->lz4prefs);
+				if (LZ4F_isError(len))
+					ereport(ERROR,
+							(errmsg("could not write LZ4 header: %s",
+									LZ4F_getErrorName(len))));
+				bc->outlen = len;
+			}
+#endif
+			break;
+
+		case BACKUP_COMPRESSION_ZSTD:
+#ifdef USE_ZSTD
+			ZSTD_CCtx_reset(bc->zstdctx, ZSTD_reset_session_only);
+#endif
+			break;
+	}
+}
+
+/*
+ * Compress some data of the current tar stream, sending compressed data to
+ * the client as the output buffer fills up.
+ */
+void
+BackupCompressorWrite(BackupCompressor *bc, const char *data, size_t len)
+{
+	switch (bc->method)
+	{
+		case BACKUP_COMPRESSION_NONE:
+			break;
+
+		case BACKUP_COMPRESSION_GZIP:
+#ifdef HAVE_LIBZ
+			bc->zs.next_in = (Bytef *) data;
+			bc->zs.avail_in = len;
+			while (bc->zs.avail_in > 0)
+			{
+				if (bc->outlen == bc->outbufsize)
+					flush_output(bc);
+				bc->zs.next_out = (Bytef *) bc->outbuf + bc->outlen;
+				bc->zs.avail_out = bc->outbufsize - bc->outlen;
+				if (deflate(&bc->zs, Z_NO_FLUSH) == Z_STREAM_ERROR)
+					ereport(ERROR,
+							(errmsg("could not compress data: %s",
+									bc->zs.msg ? bc->zs.msg : "unknown error")));
+				bc->outlen = bc->outbufsize - bc->zs.avail_out;
+			}
+#endif
+			break;
+
+		case BACKUP_COMPRESSION_LZ4:
+#ifdef USE_LZ4
+			while (len > 0)
+			{
+				size_t		chunk = Min(len, LZ4_INPUT_CHUNK);
+				size_t		ret;
+
+				if (bc->outbufsize - bc->outlen <
+					LZ4F_compressBound(chunk, &bc->lz4prefs))
+					flush_output(bc);
+				ret = LZ4F_compressUpdate(bc->lz4ctx, bc->outbuf + bc->outlen,
+										  bc->outbufsize - bc->outlen,
+										  data, chunk, NULL);
+				if (LZ4F_isError(ret))
+					ereport(ERROR,
+							(errmsg("could not compress data: %s",
+									LZ4F_getErrorName(ret))));
+				bc->outlen += ret;
+				data += chunk;
+				len -= chunk;
+			}
+#endif
+			break;
+
+		case BACKUP_COMPRESSION_ZSTD:
+#ifdef USE_ZSTD
+			{
+				ZSTD_inBuffer in = {data, len, 0};
+
+				while (in.pos < in.size)
+				{
+					ZSTD_outBuffer out;
+					size_t		ret;
+
+					if (bc->outlen == bc->outbufsize)
+						flush_output(bc);
+					out.dst = bc->outbuf;
+					out.size = bc->outbufsize;
+					out.pos = bc->outlen;
+					ret = ZSTD_compressStream2(bc->zstdctx, &out, &in,
+											   ZSTD_e_continue);
+					if (ZSTD_isError(ret))
+						ereport(ERROR,
+								(errmsg("could not compress data: %s",
+										ZSTD_getErrorName(ret))));
+					bc->outlen = out.pos;
+				}
+			}
+#endif
+			break;
+	}
+}
+
+/*
+ * Finish the current tar stream: terminate the tar archive, flush the
+ * compressor and send everything that is left.
+ */
+void
+BackupCompressorEnd(BackupCompressor *bc)
+{
+	char		zerobuf[1024];
+
+	MemSet(zerobuf, 0, sizeof(zerobuf));
+	BackupCompressorWrite(bc, zerobuf, sizeof(zerobuf));
+
+	switch (bc->method)
+	{
+		case BACKUP_COMPRESSION_NONE:
+			break;
+
+		case BACKUP_COMPRESSION_GZIP:
+#ifdef HAVE_LIBZ
+			{
+				int			ret;
+
+				bc->zs.next_in = NULL;
+				bc->zs.avail_in = 0;
+				do
+				{
+					if (bc->outlen == bc->outbufsize)
+						flush_output(bc);
+					bc->zs.next_out = (Bytef *) bc->outbuf + bc->outlen;
+					bc->zs.avail_out = bc->outbufsize - bc->outlen;
+					ret = deflate(&bc->zs, Z_FINISH);
+					if (ret == Z_STREAM_ERROR)
+						ereport(ERROR,
+								(errmsg("could not compress data: %s",
+										bc->zs.msg ? bc->zs.msg : "unknown error")));
+					bc->outlen = bc->outbufsize - bc->zs.avail_out;
+				} while (ret != Z_STREAM_END);
+
+				deflateEnd(&bc->zs);
+				bc->zs_initialized = false;
+			}
+#endif
+			break;
+
+		case BACKUP_COMPRESSION_LZ4:
+#ifdef USE_LZ4
+			{
+				size_t		ret;
+
+				if (bc->outbufsize - bc->outlen <
+					LZ4F_compressBound(0, &bc->lz4prefs))
+					flush_output(bc);
+				ret = LZ4F_compressEnd(bc->lz4ctx, bc->outbuf + bc->outlen,
+									   bc->outbufsize - bc->outlen, NULL);
+				if (LZ4F_isError(ret))
+					ereport(ERROR,
+							(errmsg("could not end LZ4 compression: %s",
+									LZ4F_getErrorName(ret))));
+				bc->outlen += ret;
+			}
+#endif
+			break;
+
+		case BACKUP_COMPRESSION_ZSTD:
+#ifdef USE_ZSTD
+			{
+				ZSTD_inBuffer in = {NULL, 0, 0};
+				size_t		remaining;
+
+				do
+				{
+					ZSTD_outBuffer out;
+
+					if (bc->outlen == bc->outbufsize)
+						flush_output(bc);
+					out.dst = bc->outbuf;
+					out.size = bc->outbufsize;
+					out.pos = bc->outlen;
+					remaining = ZSTD_compressStream2(bc->zstdctx, &out, &in,
+													 ZSTD_e_end);
+					if (ZSTD_isError(remaining))
+						ereport(ERROR,
+								(errmsg("could not end zstd compression: %s",
+										ZSTD_getErrorName(remaining))));
+					bc->outlen = out.pos;
+				} while (remaining != 0);
+			}
+#endif
+			break;
+	}
+
+	flush_output(bc);
+}
+
+/*
+ * Send the compressed data collected in the output buffer to the client.
+ */
+static void
+flush_output(BackupCompressor *bc)
+{
+	if (bc->outlen > 0 && pq_putmessage('d', bc->outbuf, bc->outlen))
+		ereport(ERROR,
+				(errmsg("base backup could not send data, aborting backup")));
+	bc->outlen = 0;
+}
+
+/*
+ * Memory context reset callback releasing the compression library's state.
+ */
+static void
+free_compressor(void *arg)
+{
+	BackupCompressor *bc pg_attribute_unused() = (BackupCompressor *) arg;
+
+#ifdef HAVE_LIBZ
+	if (bc->zs_initialized)
+		deflateEnd(&bc->zs);
+	bc->zs_initialized = false;
+#endif
+#ifdef USE_LZ4
+	if (bc->lz4ctx != NULL)
+		LZ4F_freeCompressionContext(bc->lz4ctx);
+	bc->lz4ctx = NULL;
+#endif
+#ifdef USE_ZSTD
+	if (bc->zstdctx != NULL)
+		ZSTD_freeCCtx(bc->zstdctx);
+	bc->zstdctx = NULL;
+#endif
+}
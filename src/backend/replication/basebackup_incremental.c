@@ -0,0 +1,237 @@
+/*-------------------------------------------------------------------------
+ *
+ * basebackup_incremental.c
+ *	  code for incremental base backups
+ *
+ * An incremental base backup is taken relative to a prior backup, which is
+ * identified by the LSN and timeline at which it started.  Relation files
+ * are sent as "incremental files" holding only the blocks that the WAL
+ * between the start of the prior backup and the start of this one may have
+ * modified (see common/incremental_backup.h for the format); all other files
+ * are sent in full.  Which blocks those are is read from the WAL summaries
+ * written by the WAL summarizer.
+ *
+ * Portions Copyright (c) 2010-2020, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  src/backend/replication/basebackup_incremental.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/timeline.h"
+#include "common/incremental_backup.h"
+#include "miscadmin.h"
+#include "postmaster/walsummarizer.h"
+#include "replication/basebackup_incremental.h"
+#include "replication/walsummary.h"
+
+/*
+ * If an incremental file would contain more than this fraction of the
+ * segment's blocks, it's cheaper to send the whole file: it saves the
+ * header, and reconstructing it needs no older backup.
+ */
+#define INCREMENTAL_MAX_FRACTION	0.9
+
+struct IncrementalBackupInfo
+{
+	/* Where the prior backup started */
+	XLogRecPtr	prior_lsn;
+	TimeLineID	prior_tli;
+
+	/* Blocks modified since then, from the WAL summaries */
+	BlockRefTable *brtab;
+};
+
+/*
+ * Set up for an incremental backup relative to the backup that started at
+ * prior_lsn on timeline prior_tli.
+ */
+IncrementalBackupInfo *
+CreateIncrementalBackupInfo(XLogRecPtr prior_lsn, TimeLineID prior_tli)
+{
+	IncrementalBackupInfo *ib = palloc0(sizeof(IncrementalBackupInfo));
+
+	ib->prior_lsn = prior_lsn;
+	ib->prior_tli = prior_tli;
+
+	return ib;
+}
+
+/*
+ * Once the backup has started, at backup_start_lsn on backup_start_tli,
+ * collect the blocks modified since the prior backup, and note the prior
+ * backup in the backup label.
+ *
+ * This waits for the WAL summarizer to have summarized everything up to the
+ * start of this backup, and fails if any of the WAL since the prior backup
+ * has not been summarized, because then we can't know what changed.
+ */
+void
+PrepareForIncrementalBackup(IncrementalBackupInfo *ib,
+							XLogRecPtr backup_start_lsn,
+							TimeLineID backup_start_tli,
+							StringInfo labelfile)
+{
+	List	   *history;
+	ListCell   *lc;
+	bool		found_prior_tli = false;
+
+	if (ib->prior_lsn > backup_start_lsn)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("prior backup start location %X/%X is later than this backup's start location %X/%X",
+						(uint32) (ib->prior_lsn >> 32), (uint32) ib->prior_lsn,
+						(uint32) (backup_start_lsn >> 32),
+						(uint32) backup_start_lsn)));
+
+	/*
+	 * The prior backup must have been taken on this server's timeline
+	 * history, or the WAL since then doesn't lead to the current state.
+	 */
+	history = readTimeLineHistory(backup_start_tli);
+	foreach(lc, history)
+	{
+		TimeLineHistoryEntry *tle = (TimeLineHistoryEntry *) lfirst(lc);
+
+		if (tle->tli == ib->prior_tli &&
+			(XLogRecPtrIsInvalid(tle->begin) || tle->begin <= ib->prior_lsn) &&
+			(XLogRecPtrIsInvalid(tle->end) || ib->prior_lsn <= tle->end))
+		{
+			found_prior_tli = true;
+			break;
+		}
+	}
+	if (!found_prior_tli)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("prior backup start location %X/%X on timeline %u is not in the history of timeline %u",
+						(uint32) (ib->prior_lsn >> 32), (uint32) ib->prior_lsn,
+						ib->prior_tli, backup_start_tli)));
+
+	WaitForWalSummarization(backup_start_lsn);
+
+	/*
+	 * Load the summaries for the part of each timeline that lies between the
+	 * two backups.
+	 */
+	ib->brtab = CreateBlockRefTable();
+	foreach(lc, history)
+	{
+		TimeLineHistoryEntry *tle = (TimeLineHistoryEntry *) lfirst(lc);
+		XLogRecPtr	tli_start_lsn = Max(tle->begin, ib->prior_lsn);
+		XLogRecPtr	tli_end_lsn = backup_start_lsn;
+		XLogRecPtr	missing_lsn;
+		List	   *wslist;
+		ListCell   *lc2;
+
+		if (!XLogRecPtrIsInvalid(tle->end) && tle->end < tli_end_lsn)
+			tli_end_lsn = tle->end;
+		if (tli_start_lsn >= tli_end_lsn)
+			continue;
+
+		wslist = GetWalSummaries(tle->tli, tli_start_lsn, tli_end_lsn);
+		if (!WalSummariesAreComplete(wslist, tli_start_lsn, tli_end_lsn,
+									 &missing_lsn))
+			ereport(ERROR,
+					(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+					 errmsg("WAL summaries are required on timeline %u from %X/%X to %X/%X, but the summaries for that timeline and LSN range are incomplete",
+							tle->tli,
+							(uint32) (tli_start_lsn >> 32),
+							(uint32) tli_start_lsn,
+							(uint32) (tli_end_lsn >> 32),
+							(uint32) tli_end_lsn),
+					 errdetail("The first unsummarized LSN in this range is %X/%X.",
+							   (uint32) (missing_lsn >> 32),
+							   (uint32) missing_lsn)));
+
+		foreach(lc2, wslist)
+		{
+			CHECK_FOR_INTERRUPTS();
+			ReadWalSummary(ib->brtab, (WalSummaryFile *) lfirst(lc2));
+		}
+		list_free_deep(wslist);
+	}
+	list_free_deep(history);
+
+	appendStringInfo(labelfile, "%s: %X/%X\n", INCREMENTAL_FROM_LSN_LABEL,
+					 (uint32) (ib->prior_lsn >> 32), (uint32) ib->prior_lsn);
+	appendStringInfo(labelfile, "%s: %u\n", INCREMENTAL_FROM_TLI_LABEL,
+					 ib->prior_tli);
+}
+
+/*
+ * Decide whether segment segno of the given relation fork, which is size
+ * bytes long, should be sent in full or incrementally.
+ *
+ * For an incremental file, the numbers of the blocks to send, relative to
+ * the start of the segment, are stored in relative_block_numbers, which must
+ * have room for RELSEG_SIZE entries, and their count in
+ * *num_blocks_required.  *truncation_block_length is set to the length of
+ * the segment in blocks.
+ */
+FileBackupMethod
+GetFileBackupMethod(IncrementalBackupInfo *ib, const RelFileNode *rnode,
+					ForkNumber forknum, unsigned segno, off_t size,
+					unsigned *num_blocks_required,
+					BlockNumber *relative_block_numbers,
+					unsigned *truncation_block_length)
+{
+	RelFileNode dbnode;
+	BlockNumber limit_block;
+	BlockNumber start_blkno;
+	BlockNumber stop_blkno;
+	BlockNumber blkno;
+	unsigned	nblocks;
+	int			n;
+	int			i;
+
+	/*
+	 * The free space map isn't WAL-logged reliably, and init forks are never
+	 * modified after creation; both are small, so just send them.
+	 */
+	if (forknum == FSM_FORKNUM || forknum == INIT_FORKNUM)
+		return BACK_UP_FILE_FULLY;
+
+	/* Be careful with files that aren't a whole number of blocks. */
+	if (size <= 0 || size % BLCKSZ != 0 || size / BLCKSZ > RELSEG_SIZE)
+		return BACK_UP_FILE_FULLY;
+	nblocks = size / BLCKSZ;
+
+	/*
+	 * If the database was created since the prior backup, its files were
+	 * copied without being WAL-logged block by block.
+	 */
+	dbnode.spcNode = rnode->spcNode;
+	dbnode.dbNode = rnode->dbNode;
+	dbnode.relNode = InvalidOid;
+	if (OidIsValid(rnode->dbNode) &&
+		BlockRefTableLookup(ib->brtab, &dbnode, MAIN_FORKNUM, &limit_block))
+		return BACK_UP_FILE_FULLY;
+
+	/*
+	 * Every block at or beyond the limit block must be sent.  If the whole
+	 * segment is, there's no point in an incremental file.
+	 */
+	start_blkno = segno * RELSEG_SIZE;
+	stop_blkno = start_blkno + nblocks;
+	(void) BlockRefTableLookup(ib->brtab, rnode, forknum, &limit_block);
+	if (limit_block <= start_blkno)
+		return BACK_UP_FILE_FULLY;
+
+	n = BlockRefTableGetBlocks(ib->brtab, rnode, forknum, start_blkno,
+							   Min(stop_blkno, limit_block),
+							   relative_block_numbers, RELSEG_SIZE);
+	for (i = 0; i < n; i++)
+		relative_block_numbers[i] -= start_blkno;
+	for (blkno = limit_block; blkno < stop_blkno; blkno++)
+		relative_block_numbers[n++] = blkno - start_blkno;
+
+	if (n > nblocks * INCREMENTAL_MAX_FRACTION)
+		return BACK_UP_FILE_FULLY;
+
+	*num_blocks_required = n;
+	*truncation_block_length = nblocks;
+	return BACK_UP_FILE_INCREMENTALLY;
+}
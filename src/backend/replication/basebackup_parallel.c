@@ -0,0 +1,522 @@
+/*-------------------------------------------------------------------------
+ *
+ * basebackup_parallel.c
+ *	  coordinate a base backup taken over several connections at once
+ *
+ * A parallel base backup is started by a leader, a walsender running
+ * BASE_BACKUP with the PARALLEL option, which starts and stops the backup
+ * just like a regular one.  Once the backup has started, the client opens
+ * more replication connections that join it as workers by running
+ * BASE_BACKUP with PARALLEL_WORKER and the leader's process ID.  Each
+ * participant walks the whole data directory and all tablespaces, sends the
+ * directories, and sends the files that hash to it; see
+ * ParallelBackupIsMyFile().  The leader alone sends the backup_label and
+ * tablespace_map files, the WAL and, after all workers have finished,
+ * pg_control, so that the backup is consistent as a whole.
+ *
+ * Workers write their backup manifest entries to files in a SharedFileSet,
+ * which the leader appends to its own manifest.  The leader and its workers
+ * find each other through a slot in shared memory, and share the options of
+ * the backup and the list of tablespaces through a DSM segment.  Either side
+ * marks the slot as failed when it detaches from the segment without having
+ * finished, which makes the others give up too.
+ *
+ * Portions Copyright (c) 2010-2020, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  src/backend/replication/basebackup_parallel.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "common/hashfn.h"
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "replication/basebackup.h"
+#include "replication/basebackup_parallel.h"
+#include "replication/walsender.h"
+#include "storage/condition_variable.h"
+#include "storage/dsm.h"
+#include "storage/fd.h"
+#include "storage/sharedfileset.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
+#include "utils/timestamp.h"
+
+/* How long the leader sleeps between checks on its workers, in ms */
+#define PARALLEL_BACKUP_WAIT_INTERVAL	1000
+
+/*
+ * Shared memory slot of a parallel backup in progress.
+ */
+typedef struct ParallelBackupSlot
+{
+	slock_t		mutex;			/* protects the fields below */
+	int			leader_pid;		/* 0 if the slot is free */
+	dsm_handle	handle;			/* segment with ParallelBackupShared */
+	int			nworkers;		/* workers expected */
+	int			nattached;		/* workers that have joined so far */
+	int			nfinished;		/* workers that have finished */
+	bool		failed;			/* has any participant failed? */
+	long long	checksum_failures;	/* reported by the workers */
+
+	ConditionVariable cv;		/* signaled when a worker finishes or fails */
+} ParallelBackupSlot;
+
+/*
+ * Contents of the DSM segment of a parallel backup.  The tablespaces other
+ * than the main data directory are stored as a sequence of three
+ * NUL-terminated strings each, their OID, path and relative path within
+ * PGDATA, which is empty if they're located elsewhere.
+ */
+typedef struct ParallelBackupShared
+{
+	ParallelBackupParams params;
+	SharedFileSet fileset;		/* for the manifest files of the workers */
+	Size		tblspc_len;
+	char		tblspc_data[FLEXIBLE_ARRAY_MEMBER];
+} ParallelBackupShared;
+
+/* Backend-local state of a participant in a parallel backup */
+struct ParallelBackupState
+{
+	ParallelBackupSlot *slot;
+	int			leader_pid;
+	dsm_segment *seg;
+	ParallelBackupShared *shared;
+	int			participant;	/* 0 for the leader, from 1 for workers */
+	bool		finished;		/* worker is done */
+	TimestampTz begin_time;		/* when workers could start to join */
+};
+
+static ParallelBackupSlot *ParallelBackupSlots = NULL;
+
+static char *copy_string(char *dest, const char *src);
+static void parallel_backup_detach(dsm_segment *seg, Datum arg);
+
+/*
+ * Amount of shared memory needed for parallel backups.  Every walsender can
+ * lead one.
+ */
+Size
+ParallelBackupShmemSize(void)
+{
+	return mul_size(max_wal_senders, sizeof(ParallelBackupSlot));
+}
+
+/*
+ * Create or attach to the shared memory for parallel backups.
+ */
+void
+ParallelBackupShmemInit(void)
+{
+	bool		found;
+	int			i;
+
+	ParallelBackupSlots = (ParallelBackupSlot *)
+		ShmemInitStruct("Parallel Base Backup Slots",
+						ParallelBackupShmemSize(), &found);
+	if (!found)
+	{
+		for (i = 0; i < max_wal_senders; i++)
+		{
+			ParallelBackupSlot *slot = &ParallelBackupSlots[i];
+
+			SpinLockInit(&slot->mutex);
+			slot->leader_pid = 0;
+			ConditionVariableInit(&slot->cv);
+		}
+	}
+}
+
+/*
+ * Called by the leader once the backup has started, to let workers join.
+ * tablespaces is the list of tablespaces in the order they'll be sent, with
+ * the main data directory last.
+ */
+ParallelBackupState *
+ParallelBackupBegin(const ParallelBackupParams *params, List *tablespaces)
+{
+	ParallelBackupState *pb = palloc0(sizeof(ParallelBackupState));
+	ParallelBackupShared *shared;
+	ParallelBackupSlot *slot = NULL;
+	Size		tblspc_len = 0;
+	char	   *p;
+	ListCell   *lc;
+	int			i;
+
+	Assert(params->nparticipants > 1);
+
+	foreach(lc, tablespaces)
+	{
+		tablespaceinfo *ti = (tablespaceinfo *) lfirst(lc);
+
+		if (ti->path == NULL)
+		{
+			Assert(lnext(tablespaces, lc) == NULL);
+			continue;
+		}
+		tblspc_len += strlen(ti->oid) + strlen(ti->path) + 3;
+		if (ti->rpath != NULL)
+			tblspc_len += strlen(ti->rpath);
+	}
+
+	pb->leader_pid = MyProcPid;
+	pb->participant = 0;
+
+	/*
+	 * The segment belongs to the backup's resource owner, so the slot is
+	 * released if the backup fails; otherwise, by ParallelBackupEnd().
+	 */
+	pb->seg = dsm_create(add_size(offsetof(ParallelBackupShared, tblspc_data),
+								  tblspc_len), 0);
+	on_dsm_detach(pb->seg, parallel_backup_detach, PointerGetDatum(pb));
+
+	shared = pb->shared = (ParallelBackupShared *) dsm_segment_address(pb->seg);
+	memcpy(&shared->params, params, sizeof(ParallelBackupParams));
+
+	/*
+	 * Outside of a transaction, temp_tablespaces hasn't been looked at; the
+	 * manifest files just go into the default tablespace.
+	 */
+	if (!TempTablespacesAreSet())
+		SetTempTablespaces(NULL, 0);
+	SharedFileSetInit(&shared->fileset, pb->seg);
+
+	shared->tblspc_len = tblspc_len;
+	p = shared->tblspc_data;
+	foreach(lc, tablespaces)
+	{
+		tablespaceinfo *ti = (tablespaceinfo *) lfirst(lc);
+
+		if (ti->path == NULL)
+			continue;
+		p = copy_string(p, ti->oid);
+		p = copy_string(p, ti->path);
+		p = copy_string(p, ti->rpath ? ti->rpath : "");
+	}
+	Assert(p == shared->tblspc_data + tblspc_len);
+
+	/* Claim a free slot. */
+	for (i = 0; i < max_wal_senders && slot == NULL; i++)
+	{
+		SpinLockAcquire(&ParallelBackupSlots[i].mutex);
+		if (ParallelBackupSlots[i].leader_pid == 0)
+		{
+			slot = &ParallelBackupSlots[i];
+			slot->leader_pid = MyProcPid;
+			slot->handle = dsm_segment_handle(pb->seg);
+			slot->nworkers = params->nparticipants - 1;
+			slot->nattached = 0;
+			slot->nfinished = 0;
+			slot->failed = false;
+			slot->checksum_failures = 0;
+		}
+		SpinLockRelease(&ParallelBackupSlots[i].mutex);
+	}
+	if (slot == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_CONFIGURATION_LIMIT_EXCEEDED),
+				 errmsg("too many parallel base backups in progress")));
+
+	pb->slot = slot;
+	pb->begin_time = GetCurrentTimestamp();
+
+	return pb;
+}
+
+/*
+ * Called by the leader once it has sent its share of the files, to wait for
+ * the workers to send theirs.  Their checksum failures are added to
+ * *checksum_failures.
+ *
+ * Workers that haven't joined within wal_sender_timeout of the start of the
+ * backup are taken to have been lost.
+ */
+void
+ParallelBackupWaitForWorkers(ParallelBackupState *pb,
+							 long long *checksum_failures)
+{
+	ParallelBackupSlot *slot = pb->slot;
+
+	for (;;)
+	{
+		bool		failed;
+		int			nattached;
+		int			nfinished;
+
+		CHECK_FOR_INTERRUPTS();
+
+		SpinLockAcquire(&slot->mutex);
+		failed = slot->failed;
+		nattached = slot->nattached;
+		nfinished = slot->nfinished;
+		SpinLockRelease(&slot->mutex);
+
+		if (failed)
+			ereport(ERROR,
+					(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+					 errmsg("a parallel base backup worker failed")));
+		if (nfinished == slot->nworkers)
+			break;
+		if (nattached < slot->nworkers && wal_sender_timeout > 0 &&
+			TimestampDifferenceExceeds(pb->begin_time, GetCurrentTimestamp(),
+									   wal_sender_timeout))
+			ereport(ERROR,
+					(errcode(ERRCODE_CONNECTION_FAILURE),
+					 errmsg("only %d of %d parallel base backup workers connected",
+							nattached, slot->nworkers)));
+
+		(void) ConditionVariableTimedSleep(&slot->cv,
+										   PARALLEL_BACKUP_WAIT_INTERVAL,
+										   WAIT_EVENT_BACKUP_WAIT_PARALLEL_WORKERS);
+	}
+	ConditionVariableCancelSleep();
+
+	SpinLockAcquire(&slot->mutex);
+	*checksum_failures += slot->checksum_failures;
+	SpinLockRelease(&slot->mutex);
+}
+
+/*
+ * Open the manifest entries written by the given worker, numbered from 1.
+ */
+BufFile *
+ParallelBackupOpenManifest(ParallelBackupState *pb, int worker)
+{
+	char		name[MAXPGPATH];
+
+	Assert(pb->participant == 0);
+	snprintf(name, sizeof(name), "manifest.%d", worker);
+
+	return BufFileOpenShared(&pb->shared->fileset, name);
+}
+
+/*
+ * Join the parallel backup led by the walsender with the given process ID,
+ * as a worker.  The options of the backup are returned in *params, and the
+ * tablespaces to send in *tablespaces, in the same order as the leader sends
+ * them.
+ */
+ParallelBackupState *
+ParallelBackupJoin(int leader_pid, ParallelBackupParams *params,
+				   List **tablespaces)
+{
+	ParallelBackupState *pb = palloc0(sizeof(ParallelBackupState));
+	ParallelBackupShared *shared;
+	ParallelBackupSlot *slot = NULL;
+	dsm_handle	handle = DSM_HANDLE_INVALID;
+	tablespaceinfo *ti;
+	char	   *p;
+	char	   *end;
+	int			i;
+
+	for (i = 0; i < max_wal_senders && slot == NULL; i++)
+	{
+		SpinLockAcquire(&ParallelBackupSlots[i].mutex);
+		if (leader_pid != 0 && ParallelBackupSlots[i].leader_pid == leader_pid)
+		{
+			slot = &ParallelBackupSlots[i];
+			handle = slot->handle;
+		}
+		SpinLockRelease(&ParallelBackupSlots[i].mutex);
+	}
+	if (slot == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("no parallel base backup is in progress in process %d",
+						leader_pid)));
+
+	pb->leader_pid = leader_pid;
+	pb->seg = dsm_attach(handle);
+	if (pb->seg == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("parallel base backup in process %d has ended",
+						leader_pid)));
+	on_dsm_detach(pb->seg, parallel_backup_detach, PointerGetDatum(pb));
+
+	/*
+	 * Only take a worker number once attached, so that a failure from now on
+	 * is noticed by the leader.
+	 */
+	SpinLockAcquire(&slot->mutex);
+	if (slot->leader_pid == leader_pid && slot->handle == handle &&
+		!slot->failed && slot->nattached < slot->nworkers)
+		pb->participant = ++slot->nattached;
+	SpinLockRelease(&slot->mutex);
+	if (pb->participant == 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("parallel base backup in process %d cannot be joined",
+						leader_pid)));
+	pb->slot = slot;
+
+	shared = pb->shared = (ParallelBackupShared *) dsm_segment_address(pb->seg);
+	SharedFileSetAttach(&shared->fileset, pb->seg);
+	memcpy(params, &shared->params, sizeof(ParallelBackupParams));
+
+	*tablespaces = NIL;
+	p = shared->tblspc_data;
+	end = p + shared->tblspc_len;
+	while (p < end)
+	{
+		ti = palloc0(sizeof(tablespaceinfo));
+		ti->oid = pstrdup(p);
+		p += strlen(p) + 1;
+		ti->path = pstrdup(p);
+		p += strlen(p) + 1;
+		ti->rpath = (*p != '\0') ? pstrdup(p) : NULL;
+		p += strlen(p) + 1;
+		ti->size = -1;
+		*tablespaces = lappend(*tablespaces, ti);
+	}
+
+	/* The main data directory comes last, as for the leader */
+	ti = palloc0(sizeof(tablespaceinfo));
+	ti->size = -1;
+	*tablespaces = lappend(*tablespaces, ti);
+
+	return pb;
+}
+
+/*
+ * Create the file a worker writes its manifest entries to.
+ */
+BufFile *
+ParallelBackupCreateManifest(ParallelBackupState *pb)
+{
+	char		name[MAXPGPATH];
+
+	Assert(pb->participant > 0);
+	snprintf(name, sizeof(name), "manifest.%d", pb->participant);
+
+	return BufFileCreateShared(&pb->shared->fileset, name);
+}
+
+/*
+ * Called by a worker when it has sent all its files.  The manifest file, if
+ * any, is handed over to the leader.
+ */
+void
+ParallelBackupWorkerDone(ParallelBackupState *pb, BufFile *manifest,
+						 long long checksum_failures)
+{
+	ParallelBackupSlot *slot = pb->slot;
+
+	if (manifest != NULL)
+	{
+		BufFileExportShared(manifest);
+		BufFileClose(manifest);
+	}
+
+	SpinLockAcquire(&slot->mutex);
+	if (slot->leader_pid == pb->leader_pid)
+	{
+		slot->nfinished++;
+		slot->checksum_failures += checksum_failures;
+	}
+	SpinLockRelease(&slot->mutex);
+	pb->finished = true;
+
+	ConditionVariableBroadcast(&slot->cv);
+}
+
+/*
+ * Leave a parallel backup.  For the leader, this releases its slot, so it
+ * must only be called once the workers are done.
+ */
+void
+ParallelBackupEnd(ParallelBackupState *pb)
+{
+	dsm_detach(pb->seg);
+}
+
+/*
+ * Number of workers taking part in the backup, besides the leader.
+ */
+int
+ParallelBackupNumWorkers(ParallelBackupState *pb)
+{
+	return pb->shared->params.nparticipants - 1;
+}
+
+/*
+ * Is the given file, named by its path in the tar stream, to be sent by
+ * this participant?  Files are spread over the participants by a hash of
+ * their name, which balances well enough because large relations are
+ * split into many segments.
+ */
+bool
+ParallelBackupIsMyFile(ParallelBackupState *pb, const char *path)
+{
+	uint32		hash;
+
+	hash = hash_bytes((const unsigned char *) path, strlen(path));
+
+	return hash % pb->shared->params.nparticipants == pb->participant;
+}
+
+/*
+ * Give up if another participant has failed.
+ */
+void
+ParallelBackupCheckForFailure(ParallelBackupState *pb)
+{
+	ParallelBackupSlot *slot = pb->slot;
+	bool		failed;
+
+	SpinLockAcquire(&slot->mutex);
+	failed = slot->failed || slot->leader_pid != pb->leader_pid;
+	SpinLockRelease(&slot->mutex);
+
+	if (failed)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("parallel base backup failed in another process")));
+}
+
+/*
+ * Copy a string including its terminating NUL, returning the end of the copy.
+ */
+static char *
+copy_string(char *dest, const char *src)
+{
+	size_t		len = strlen(src) + 1;
+
+	memcpy(dest, src, len);
+	return dest + len;
+}
+
+/*
+ * DSM detach callback.  When the leader detaches, the backup is over, and
+ * the slot is released; when a worker detaches before it has finished, the
+ * backup has failed.
+ */
+static void
+parallel_backup_detach(dsm_segment *seg, Datum arg)
+{
+	ParallelBackupState *pb = (ParallelBackupState *) DatumGetPointer(arg);
+	ParallelBackupSlot *slot = pb->slot;
+
+	/* Nothing to do if we failed before taking part in a backup */
+	if (slot == NULL)
+		return;
+
+	SpinLockAcquire(&slot->mutex);
+	if (slot->leader_pid == pb->leader_pid)
+	{
+		if (pb->participant == 0)
+		{
+			slot->failed = true;
+			slot->leader_pid = 0;
+			slot->handle = DSM_HANDLE_INVALID;
+		}
+		else if (!pb->finished)
+			slot->failed = true;
+	}
+	SpinLockRelease(&slot->mutex);
+
+	ConditionVariableBroadcast(&slot->cv);
+}
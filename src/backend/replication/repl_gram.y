@@ -89,6 +89,12 @@ static SQLCmd *make_sqlcmd(void);
 %token K_USE_SNAPSHOT
 %token K_MANIFEST
 %token K_MANIFEST_CHECKSUMS
+%token K_INCREMENTAL
+%token K_COMPRESSION
+%token K_COMPRESSION_LEVEL
+%token K_COMPRESSION_WORKERS
+%token K_PARALLEL
+%token K_PARALLEL_WORKER
 
 %type <node>	command
 %type <node>	base_backup start_replication start_logical_replication
@@ -158,7 +164,11 @@ var_name:	IDENT	{ $$ = $1; }
 /*
  * BASE_BACKUP [LABEL '<label>'] [PROGRESS] [FAST] [WAL] [NOWAIT]
  * [MAX_RATE %d] [TABLESPACE_MAP] [NOVERIFY_CHECKSUMS]
- * [MANIFEST %s] [MANIFEST_CHECKSUMS %s]
+ * [MANIFEST %s] [MANIFEST_CHECKSUMS %s] [INCREMENTAL %X/%X TIMELINE %d]
+ * [COMPRESSION %s] [COMPRESSION_LEVEL %d] [COMPRESSION_WORKERS %d]
+ * [PARALLEL %d]
+ *
+ * BASE_BACKUP PARALLEL_WORKER %d
  */
 base_backup:
 			K_BASE_BACKUP base_backup_opt_list
@@ -227,6 +237,41 @@ base_backup_opt:
 				  $$ = makeDefElem("manifest_checksums",
 								   (Node *)makeString($2), -1);
 				}
+			| K_INCREMENTAL RECPTR K_TIMELINE UCONST
+				{
+				  char	   *lsn = psprintf("%X/%X",
+										   (uint32) ($2 >> 32),
+										   (uint32) $2);
+
+				  $$ = makeDefElem("incremental",
+								   (Node *)list_make2(makeString(lsn),
+													  makeInteger($4)), -1);
+				}
+			| K_COMPRESSION SCONST
+				{
+				  $$ = makeDefElem("compression",
+								   (Node *)makeString($2), -1);
+				}
+			| K_COMPRESSION_LEVEL UCONST
+				{
+				  $$ = makeDefElem("compression_level",
+								   (Node *)makeInteger($2), -1);
+				}
+			| K_COMPRESSION_WORKERS UCONST
+				{
+				  $$ = makeDefElem("compression_workers",
+								   (Node *)makeInteger($2), -1);
+				}
+			| K_PARALLEL UCONST
+				{
+				  $$ = makeDefElem("parallel",
+								   (Node *)makeInteger($2), -1);
+				}
+			| K_PARALLEL_WORKER UCONST
+				{
+				  $$ = makeDefElem("parallel_worker",
+								   (Node *)makeInteger($2), -1);
+				}
 			;
 
 create_replication_slot:
@@ -0,0 +1,760 @@
+/*-------------------------------------------------------------------------
+ *
+ * walsummary.c
+ *	  Block reference tables, and the WAL summary files that store them
+ *
+ * A block reference table maps each relation fork to the set of its blocks
+ * that were modified, plus a "limit block": the lowest length to which the
+ * fork was truncated, or 0 if it was created.  Every block at or beyond the
+ * limit block must be considered modified, even if it is not listed.
+ *
+ * The WAL summarizer (see postmaster/walsummarizer.c) builds one table per
+ * range of WAL and writes it out to a WAL summary file, named after the
+ * timeline and LSN range that it covers:
+ *
+ *		pg_wal/summaries/TTTTTTTTXXXXXXXXXXXXXXXXYYYYYYYYYYYYYYYY.summary
+ *
+ * Incremental base backups read the summaries covering the WAL between the
+ * prior backup and the current one back into a single table, to find out
+ * which blocks have to be sent.
+ *
+ * A summary file consists of a magic number, the number of entries, the
+ * entries themselves (relation fork, limit block, and sorted block numbers)
+ * and a CRC-32C of everything before it, all in native byte order.
+ *
+ * Portions Copyright (c) 2010-2020, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  src/backend/replication/walsummary.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "port/pg_crc32c.h"
+#include "replication/walsummary.h"
+#include "storage/fd.h"
+#include "utils/hsearch.h"
+#include "utils/memutils.h"
+
+#define WAL_SUMMARY_MAGIC		0x7a1d5c39
+
+/* length of "TTTTTTTTXXXXXXXXXXXXXXXXYYYYYYYYYYYYYYYY" */
+#define WAL_SUMMARY_NAME_LEN	40
+
+/* size of the buffer used to write out summary files */
+#define WAL_SUMMARY_WRITE_BUFSIZE	65536
+
+typedef struct BlockRefTableKey
+{
+	RelFileNode rnode;
+	ForkNumber	forknum;
+} BlockRefTableKey;
+
+typedef struct BlockRefTableEntry
+{
+	BlockRefTableKey key;		/* hash key; must be first */
+	BlockNumber limit_block;	/* InvalidBlockNumber if never truncated */
+	uint32		nblocks;		/* number of used entries in blocks[] */
+	uint32		nsorted;		/* leading entries known sorted and unique */
+	uint32		maxblocks;		/* allocated length of blocks[] */
+	BlockNumber *blocks;
+} BlockRefTableEntry;
+
+struct BlockRefTable
+{
+	MemoryContext mcxt;
+	HTAB	   *hash;
+	uint64		nblocks;		/* total over all entries, for memory limits */
+};
+
+/* On-disk header of each entry in a summary file */
+typedef struct WalSummaryEntryHeader
+{
+	RelFileNode rnode;
+	int32		forknum;
+	BlockNumber limit_block;
+	uint32		nblocks;
+} WalSummaryEntryHeader;
+
+/* Buffered writer for summary files */
+typedef struct WalSummaryWriter
+{
+	int			fd;
+	const char *path;
+	pg_crc32c	crc;
+	int			len;
+	char		buf[WAL_SUMMARY_WRITE_BUFSIZE];
+} WalSummaryWriter;
+
+static BlockRefTableEntry *block_ref_table_get_entry(BlockRefTable *brtab,
+													 const RelFileNode *rnode,
+													 ForkNumber forknum);
+static void block_ref_table_compact(BlockRefTable *brtab,
+									BlockRefTableEntry *entry);
+static void block_ref_table_reserve(BlockRefTable *brtab,
+									BlockRefTableEntry *entry, uint32 nmore);
+static int	blocknumber_cmp(const void *a, const void *b);
+static int	walsummary_start_cmp(const ListCell *a, const ListCell *b);
+static bool parse_wal_summary_name(const char *name, WalSummaryFile *ws);
+static void wal_summary_path(char *path, TimeLineID tli,
+							 XLogRecPtr start_lsn, XLogRecPtr end_lsn);
+static void summary_write(WalSummaryWriter *writer, const void *data,
+						  size_t len);
+static void summary_flush(WalSummaryWriter *writer);
+
+/*
+ * Create an empty block reference table, in a memory context of its own
+ * below the current one.
+ */
+BlockRefTable *
+CreateBlockRefTable(void)
+{
+	MemoryContext mcxt;
+	BlockRefTable *brtab;
+	HASHCTL		ctl;
+
+	mcxt = AllocSetContextCreate(CurrentMemoryContext,
+								 "block reference table",
+								 ALLOCSET_DEFAULT_SIZES);
+	brtab = MemoryContextAlloc(mcxt, sizeof(BlockRefTable));
+	brtab->mcxt = mcxt;
+	brtab->nblocks = 0;
+
+	memset(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(BlockRefTableKey);
+	ctl.entrysize = sizeof(BlockRefTableEntry);
+	ctl.hcxt = mcxt;
+	brtab->hash = hash_create("block reference table", 1024, &ctl,
+							  HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+	return brtab;
+}
+
+/*
+ * Release all memory used by a block reference table.
+ */
+void
+FreeBlockRefTable(BlockRefTable *brtab)
+{
+	MemoryContextDelete(brtab->mcxt);
+}
+
+/*
+ * Record that a block of a relation fork was modified.
+ */
+void
+BlockRefTableMarkBlockModified(BlockRefTable *brtab, const RelFileNode *rnode,
+							   ForkNumber forknum, BlockNumber blknum)
+{
+	BlockRefTableEntry *entry;
+
+	entry = block_ref_table_get_entry(brtab, rnode, forknum);
+
+	/* Consecutive records very often modify the same block. */
+	if (entry->nblocks > 0 && entry->blocks[entry->nblocks - 1] == blknum)
+		return;
+
+	if (entry->nblocks >= entry->maxblocks)
+		block_ref_table_reserve(brtab, entry, 1);
+
+	if (entry->nsorted == entry->nblocks &&
+		(entry->nblocks == 0 || entry->blocks[entry->nblocks - 1] < blknum))
+		entry->nsorted++;
+	entry->blocks[entry->nblocks++] = blknum;
+	brtab->nblocks++;
+}
+
+/*
+ * Record that a relation fork was truncated to limit_block blocks, or was
+ * created (limit_block 0).  We only need to remember the lowest such limit.
+ */
+void
+BlockRefTableSetLimitBlock(BlockRefTable *brtab, const RelFileNode *rnode,
+						   ForkNumber forknum, BlockNumber limit_block)
+{
+	BlockRefTableEntry *entry;
+
+	entry = block_ref_table_get_entry(brtab, rnode, forknum);
+	if (limit_block < entry->limit_block)
+		entry->limit_block = limit_block;
+}
+
+/*
+ * Does the table have an entry for this relation fork?  If so, also return
+ * its limit block, which is InvalidBlockNumber if there is none.
+ */
+bool
+BlockRefTableLookup(BlockRefTable *brtab, const RelFileNode *rnode,
+					ForkNumber forknum, BlockNumber *limit_block)
+{
+	BlockRefTableKey key;
+	BlockRefTableEntry *entry;
+
+	memset(&key, 0, sizeof(key));
+	key.rnode = *rnode;
+	key.forknum = forknum;
+	entry = hash_search(brtab->hash, &key, HASH_FIND, NULL);
+	if (entry == NULL)
+	{
+		*limit_block = InvalidBlockNumber;
+		return false;
+	}
+
+	*limit_block = entry->limit_block;
+	return true;
+}
+
+/*
+ * Store into blocks[] the modified blocks of a relation fork that lie in
+ * [start_blkno, stop_blkno), in ascending order.  At most nblocks are
+ * returned; the return value is the number stored.
+ */
+int
+BlockRefTableGetBlocks(BlockRefTable *brtab, const RelFileNode *rnode,
+					   ForkNumber forknum, BlockNumber start_blkno,
+					   BlockNumber stop_blkno, BlockNumber *blocks,
+					   int nblocks)
+{
+	BlockRefTableKey key;
+	BlockRefTableEntry *entry;
+	uint32		lo,
+				hi;
+	int			n = 0;
+
+	memset(&key, 0, sizeof(key));
+	key.rnode = *rnode;
+	key.forknum = forknum;
+	entry = hash_search(brtab->hash, &key, HASH_FIND, NULL);
+	if (entry == NULL)
+		return 0;
+
+	block_ref_table_compact(brtab, entry);
+
+	/* Binary search for the first block >= start_blkno. */
+	lo = 0;
+	hi = entry->nblocks;
+	while (lo < hi)
+	{
+		uint32		mid = lo + (hi - lo) / 2;
+
+		if (entry->blocks[mid] < start_blkno)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	while (lo < entry->nblocks && entry->blocks[lo] < stop_blkno &&
+		   n < nblocks)
+		blocks[n++] = entry->blocks[lo++];
+
+	return n;
+}
+
+/*
+ * Number of block numbers stored in the table, including any duplicates not
+ * yet compacted away.  Used to bound memory use.
+ */
+uint64
+BlockRefTableNumBlocks(BlockRefTable *brtab)
+{
+	return brtab->nblocks;
+}
+
+/*
+ * Find or create the entry for a relation fork.
+ */
+static BlockRefTableEntry *
+block_ref_table_get_entry(BlockRefTable *brtab, const RelFileNode *rnode,
+						  ForkNumber forknum)
+{
+	BlockRefTableKey key;
+	BlockRefTableEntry *entry;
+	bool		found;
+
+	memset(&key, 0, sizeof(key));
+	key.rnode = *rnode;
+	key.forknum = forknum;
+	entry = hash_search(brtab->hash, &key, HASH_ENTER, &found);
+	if (!found)
+	{
+		entry->limit_block = InvalidBlockNumber;
+		entry->nblocks = 0;
+		entry->nsorted = 0;
+		entry->maxblocks = 0;
+		entry->blocks = NULL;
+	}
+
+	return entry;
+}
+
+/*
+ * Sort an entry's block numbers and remove duplicates.
+ */
+static void
+block_ref_table_compact(BlockRefTable *brtab, BlockRefTableEntry *entry)
+{
+	uint32		i,
+				n;
+
+	if (entry->nsorted == entry->nblocks)
+		return;
+
+	qsort(entry->blocks, entry->nblocks, sizeof(BlockNumber),
+		  blocknumber_cmp);
+	n = 1;
+	for (i = 1; i < entry->nblocks; i++)
+	{
+		if (entry->blocks[i] != entry->blocks[n - 1])
+			entry->blocks[n++] = entry->blocks[i];
+	}
+
+	brtab->nblocks -= entry->nblocks - n;
+	entry->nblocks = n;
+	entry->nsorted = n;
+}
+
+/*
+ * Make room for at least nmore additional block numbers in an entry.  If the
+ * array is full of duplicates, compacting it may be enough.
+ */
+static void
+block_ref_table_reserve(BlockRefTable *brtab, BlockRefTableEntry *entry,
+						uint32 nmore)
+{
+	uint64		newmax;
+
+	if (entry->nblocks + nmore <= entry->maxblocks)
+		return;
+
+	block_ref_table_compact(brtab, entry);
+	if (entry->nblocks + nmore <= entry->maxblocks &&
+		entry->nblocks <= entry->maxblocks / 2)
+		return;
+
+	newmax = Max(entry->maxblocks, 16);
+	while (newmax < (uint64) entry->nblocks + nmore)
+		newmax *= 2;
+	if (newmax > MaxAllocHugeSize / sizeof(BlockNumber))
+		elog(ERROR, "too many modified blocks in relation %u/%u/%u fork %d",
+			 entry->key.rnode.spcNode, entry->key.rnode.dbNode,
+			 entry->key.rnode.relNode, entry->key.forknum);
+
+	if (entry->blocks == NULL)
+		entry->blocks = MemoryContextAllocHuge(brtab->mcxt,
+											   newmax * sizeof(BlockNumber));
+	else
+		entry->blocks = repalloc_huge(entry->blocks,
+									  newmax * sizeof(BlockNumber));
+	entry->maxblocks = (uint32) newmax;
+}
+
+static int
+blocknumber_cmp(const void *a, const void *b)
+{
+	BlockNumber aa = *(const BlockNumber *) a;
+	BlockNumber bb = *(const BlockNumber *) b;
+
+	if (aa < bb)
+		return -1;
+	if (aa > bb)
+		return 1;
+	return 0;
+}
+
+/*
+ * List the WAL summary files on the given timeline (any timeline, if tli is
+ * 0) whose LSN range overlaps [start_lsn, end_lsn).  Either bound may be
+ * InvalidXLogRecPtr, meaning that it's unbounded.  The result is a list of
+ * palloc'd WalSummaryFile, sorted by start LSN.
+ */
+List *
+GetWalSummaries(TimeLineID tli, XLogRecPtr start_lsn, XLogRecPtr end_lsn)
+{
+	DIR		   *sdir;
+	struct dirent *de;
+	List	   *result = NIL;
+
+	sdir = AllocateDir(WAL_SUMMARY_DIR);
+	if (sdir == NULL && errno == ENOENT)
+		return NIL;
+
+	while ((de = ReadDir(sdir, WAL_SUMMARY_DIR)) != NULL)
+	{
+		WalSummaryFile ws;
+		WalSummaryFile *wsp;
+
+		if (!parse_wal_summary_name(de->d_name, &ws))
+			continue;
+		if (tli != 0 && ws.tli != tli)
+			continue;
+		if (!XLogRecPtrIsInvalid(start_lsn) && ws.end_lsn <= start_lsn)
+			continue;
+		if (!XLogRecPtrIsInvalid(end_lsn) && ws.start_lsn >= end_lsn)
+			continue;
+
+		wsp = palloc(sizeof(WalSummaryFile));
+		memcpy(wsp, &ws, sizeof(WalSummaryFile));
+		result = lappend(result, wsp);
+	}
+	FreeDir(sdir);
+
+	list_sort(result, walsummary_start_cmp);
+
+	return result;
+}
+
+/*
+ * Do the WAL summaries in wslist, which must all be on one timeline, cover
+ * the whole of [start_lsn, end_lsn)?  If not, *missing_lsn is set to the
+ * first LSN in that range that is not covered.
+ */
+bool
+WalSummariesAreComplete(List *wslist, XLogRecPtr start_lsn,
+						XLogRecPtr end_lsn, XLogRecPtr *missing_lsn)
+{
+	XLogRecPtr	current_lsn = start_lsn;
+	ListCell   *lc;
+
+	if (current_lsn >= end_lsn)
+		return true;
+
+	/* GetWalSummaries() returns the list sorted by start LSN. */
+	foreach(lc, wslist)
+	{
+		WalSummaryFile *ws = lfirst(lc);
+
+		if (ws->start_lsn > current_lsn)
+			break;
+		if (ws->end_lsn > current_lsn)
+		{
+			current_lsn = ws->end_lsn;
+			if (current_lsn >= end_lsn)
+				return true;
+		}
+	}
+
+	*missing_lsn = current_lsn;
+	return false;
+}
+
+/*
+ * Write a block reference table out as the WAL summary for the given
+ * timeline and LSN range.  The file is first written under a temporary name
+ * and then durably renamed into place, so a summary file that exists is
+ * always complete.
+ */
+void
+WriteWalSummary(BlockRefTable *brtab, TimeLineID tli,
+				XLogRecPtr start_lsn, XLogRecPtr end_lsn)
+{
+	char		final_path[MAXPGPATH];
+	char		temp_path[MAXPGPATH];
+	WalSummaryWriter *writer;
+	HASH_SEQ_STATUS status;
+	BlockRefTableEntry *entry;
+	uint32		magic = WAL_SUMMARY_MAGIC;
+	uint32		nentries;
+
+	wal_summary_path(final_path, tli, start_lsn, end_lsn);
+	snprintf(temp_path, MAXPGPATH, "%s.tmp", final_path);
+
+	writer = palloc(sizeof(WalSummaryWriter));
+	writer->path = temp_path;
+	writer->len = 0;
+	INIT_CRC32C(writer->crc);
+	writer->fd = OpenTransientFile(temp_path,
+								   O_WRONLY | O_CREAT | O_TRUNC | PG_BINARY);
+	if (writer->fd < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not create file \"%s\": %m", temp_path)));
+
+	nentries = (uint32) hash_get_num_entries(brtab->hash);
+	summary_write(writer, &magic, sizeof(magic));
+	summary_write(writer, &nentries, sizeof(nentries));
+
+	hash_seq_init(&status, brtab->hash);
+	while ((entry = hash_seq_search(&status)) != NULL)
+	{
+		WalSummaryEntryHeader hdr;
+
+		block_ref_table_compact(brtab, entry);
+
+		memset(&hdr, 0, sizeof(hdr));
+		hdr.rnode = entry->key.rnode;
+		hdr.forknum = (int32) entry->key.forknum;
+		hdr.limit_block = entry->limit_block;
+		hdr.nblocks = entry->nblocks;
+		summary_write(writer, &hdr, sizeof(hdr));
+		summary_write(writer, entry->blocks,
+					  sizeof(BlockNumber) * entry->nblocks);
+	}
+
+	FIN_CRC32C(writer->crc);
+	{
+		pg_crc32c	crc = writer->crc;
+
+		summary_write(writer, &crc, sizeof(crc));
+	}
+	summary_flush(writer);
+
+	pgstat_report_wait_start(WAIT_EVENT_WAL_SUMMARY_WRITE);
+	if (pg_fsync(writer->fd) != 0)
+		ereport(data_sync_elevel(ERROR),
+				(errcode_for_file_access(),
+				 errmsg("could not fsync file \"%s\": %m", temp_path)));
+	pgstat_report_wait_end();
+
+	if (CloseTransientFile(writer->fd) != 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not close file \"%s\": %m", temp_path)));
+	pfree(writer);
+
+	durable_rename(temp_path, final_path, ERROR);
+}
+
+/*
+ * Read the given WAL summary file and merge its contents into brtab.
+ */
+void
+ReadWalSummary(BlockRefTable *brtab, WalSummaryFile *ws)
+{
+	char		path[MAXPGPATH];
+	int			fd;
+	struct stat st;
+	char	   *buf;
+	char	   *p;
+	char	   *end;
+	ssize_t		nread;
+	pg_crc32c	crc;
+	pg_crc32c	file_crc;
+	uint32		magic;
+	uint32		nentries;
+	uint32		i;
+
+	wal_summary_path(path, ws->tli, ws->start_lsn, ws->end_lsn);
+
+	fd = OpenTransientFile(path, O_RDONLY | PG_BINARY);
+	if (fd < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not open file \"%s\": %m", path)));
+	if (fstat(fd, &st) != 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not stat file \"%s\": %m", path)));
+	if (st.st_size < (off_t) (2 * sizeof(uint32) + sizeof(pg_crc32c)))
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("WAL summary file \"%s\" is too short", path)));
+
+	buf = palloc_extended(st.st_size, MCXT_ALLOC_HUGE);
+	pgstat_report_wait_start(WAIT_EVENT_WAL_SUMMARY_READ);
+	nread = pg_pread(fd, buf, st.st_size, 0);
+	pgstat_report_wait_end();
+	if (nread < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not read file \"%s\": %m", path)));
+	if (nread != st.st_size)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("could not read file \"%s\": read %d of %zu",
+						path, (int) nread, (Size) st.st_size)));
+	if (CloseTransientFile(fd) != 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not close file \"%s\": %m", path)));
+
+	/* Verify the CRC before trusting anything else in the file. */
+	end = buf + st.st_size - sizeof(pg_crc32c);
+	INIT_CRC32C(crc);
+	COMP_CRC32C(crc, buf, end - buf);
+	FIN_CRC32C(crc);
+	memcpy(&file_crc, end, sizeof(pg_crc32c));
+	if (!EQ_CRC32C(crc, file_crc))
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("calculated CRC checksum does not match value stored in file \"%s\"",
+						path)));
+
+	p = buf;
+	memcpy(&magic, p, sizeof(uint32));
+	p += sizeof(uint32);
+	memcpy(&nentries, p, sizeof(uint32));
+	p += sizeof(uint32);
+	if (magic != WAL_SUMMARY_MAGIC)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("WAL summary file \"%s\" has invalid magic number %08X",
+						path, magic)));
+
+	for (i = 0; i < nentries; i++)
+	{
+		WalSummaryEntryHeader hdr;
+		BlockRefTableEntry *entry;
+
+		if (end - p < (ptrdiff_t) sizeof(hdr))
+			break;
+		memcpy(&hdr, p, sizeof(hdr));
+		p += sizeof(hdr);
+		if (hdr.forknum < 0 || hdr.forknum > MAX_FORKNUM ||
+			(uint64) (end - p) < (uint64) hdr.nblocks * sizeof(BlockNumber))
+			break;
+
+		entry = block_ref_table_get_entry(brtab, &hdr.rnode,
+										  (ForkNumber) hdr.forknum);
+		if (hdr.limit_block < entry->limit_block)
+			entry->limit_block = hdr.limit_block;
+
+		if (hdr.nblocks > 0)
+		{
+			block_ref_table_reserve(brtab, entry, hdr.nblocks);
+			memcpy(entry->blocks + entry->nblocks, p,
+				   sizeof(BlockNumber) * hdr.nblocks);
+			/* Each entry in the file is sorted; the merge may not be. */
+			if (entry->nblocks == 0)
+				entry->nsorted = hdr.nblocks;
+			entry->nblocks += hdr.nblocks;
+			brtab->nblocks += hdr.nblocks;
+			p += sizeof(BlockNumber) * hdr.nblocks;
+		}
+	}
+
+	if (i < nentries || p != end)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("WAL summary file \"%s\" is corrupt", path)));
+
+	pfree(buf);
+}
+
+/*
+ * Remove a WAL summary file if it was last modified before cutoff_time.
+ */
+void
+RemoveWalSummaryIfOlderThan(WalSummaryFile *ws, pg_time_t cutoff_time)
+{
+	char		path[MAXPGPATH];
+	struct stat statbuf;
+
+	wal_summary_path(path, ws->tli, ws->start_lsn, ws->end_lsn);
+	if (lstat(path, &statbuf) != 0)
+	{
+		if (errno == ENOENT)
+			return;
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not stat file \"%s\": %m", path)));
+	}
+	if (statbuf.st_mtime >= cutoff_time)
+		return;
+	if (unlink(path) != 0 && errno != ENOENT)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not remove file \"%s\": %m", path)));
+	ereport(DEBUG2,
+			(errmsg("removed WAL summary file \"%s\"", path)));
+}
+
+static int
+walsummary_start_cmp(const ListCell *a, const ListCell *b)
+{
+	WalSummaryFile *wa = lfirst(a);
+	WalSummaryFile *wb = lfirst(b);
+
+	if (wa->start_lsn < wb->start_lsn)
+		return -1;
+	if (wa->start_lsn > wb->start_lsn)
+		return 1;
+	return 0;
+}
+
+/*
+ * Parse the name of a WAL summary file.  Returns false if the name doesn't
+ * look like one.
+ */
+static bool
+parse_wal_summary_name(const char *name, WalSummaryFile *ws)
+{
+	uint32		tli,
+				start_hi,
+				start_lo,
+				end_hi,
+				end_lo;
+
+	if (strspn(name, "0123456789ABCDEF") != WAL_SUMMARY_NAME_LEN ||
+		strcmp(name + WAL_SUMMARY_NAME_LEN, ".summary") != 0)
+		return false;
+	if (sscanf(name, "%08X%08X%08X%08X%08X",
+			   &tli, &start_hi, &start_lo, &end_hi, &end_lo) != 5)
+		return false;
+
+	ws->tli = tli;
+	ws->start_lsn = ((uint64) start_hi) << 32 | start_lo;
+	ws->end_lsn = ((uint64) end_hi) << 32 | end_lo;
+	return true;
+}
+
+static void
+wal_summary_path(char *path, TimeLineID tli, XLogRecPtr start_lsn,
+				 XLogRecPtr end_lsn)
+{
+	snprintf(path, MAXPGPATH, "%s/%08X%08X%08X%08X%08X.summary",
+			 WAL_SUMMARY_DIR, tli,
+			 (uint32) (start_lsn >> 32), (uint32) start_lsn,
+			 (uint32) (end_lsn >> 32), (uint32) end_lsn);
+}
+
+/*
+ * Append data to a summary file being written, updating its CRC.
+ */
+static void
+summary_write(WalSummaryWriter *writer, const void *data, size_t len)
+{
+	const char *p = data;
+
+	COMP_CRC32C(writer->crc, data, len);
+	while (len > 0)
+	{
+		size_t		n = Min(len, (size_t) (WAL_SUMMARY_WRITE_BUFSIZE - writer->len));
+
+		memcpy(writer->buf + writer->len, p, n);
+		writer->len += n;
+		p += n;
+		len -= n;
+		if (writer->len == WAL_SUMMARY_WRITE_BUFSIZE)
+			summary_flush(writer);
+	}
+}
+
+static void
+summary_flush(WalSummaryWriter *writer)
+{
+	int			written;
+
+	if (writer->len == 0)
+		return;
+
+	errno = 0;
+	pgstat_report_wait_start(WAIT_EVENT_WAL_SUMMARY_WRITE);
+	written = write(writer->fd, writer->buf, writer->len);
+	pgstat_report_wait_end();
+	if (written != writer->len)
+	{
+		/* if write didn't set errno, assume problem is no disk space */
+		if (errno == 0)
+			errno = ENOSPC;
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not write file \"%s\": %m", writer->path)));
+	}
+	writer->len = 0;
+}
@@ -0,0 +1,678 @@
+/*-------------------------------------------------------------------------
+ *
+ * aio.c
+ *	  Asynchronous I/O subsystem: I/O handles and their life cycle.
+ *
+ * See README for an overview.  This file contains the method-independent
+ * parts: handing out handles, staging and submitting I/O, waiting for it,
+ * running completion callbacks and cleaning up after errors.  io_method=sync
+ * is implemented here as well, since it just executes I/O right away.
+ *
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/backend/storage/aio/aio.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <unistd.h>
+
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "port/atomics.h"
+#include "storage/aio_internal.h"
+#include "storage/bufmgr.h"
+#include "storage/ipc.h"
+#include "storage/proc.h"
+#include "storage/shmem.h"
+#include "utils/resowner_private.h"
+
+/*
+ * Number of staged I/Os at which they are submitted without waiting for
+ * somebody to ask for it.  Larger batches mean fewer system calls, but the
+ * first I/O in the batch is started later.
+ */
+#define PGAIO_SUBMIT_BATCH_SIZE 32
+
+/* GUC variables */
+int			io_method = DEFAULT_IO_METHOD;
+int			io_max_concurrency = 64;
+
+/* Shared array of handles, io_max_concurrency per PGPROC */
+PgAioHandle *pgaio_handles = NULL;
+int			pgaio_num_handles = 0;
+
+/* I/Os staged by this backend, but not yet submitted */
+static PgAioHandle *pgaio_staged[PGAIO_SUBMIT_BATCH_SIZE];
+static int	pgaio_num_staged = 0;
+
+/* where to start looking for an idle handle */
+static int	pgaio_next_handle = 0;
+
+static bool pgaio_exit_callback_registered = false;
+
+static void pgaio_io_wait_internal(PgAioHandle *ioh);
+static void pgaio_shmem_exit(int code, Datum arg);
+
+
+/*
+ * Report shared memory space needed by AioShmemInit
+ */
+Size
+AioShmemSize(void)
+{
+	Size		size;
+
+	size = mul_size(mul_size(MaxBackends + NUM_AUXILIARY_PROCS,
+							 io_max_concurrency),
+					sizeof(PgAioHandle));
+
+	if (io_method == IOMETHOD_WORKER)
+		size = add_size(size, pgaio_worker_shmem_size());
+#ifdef USE_IO_URING
+	if (io_method == IOMETHOD_IO_URING)
+		size = add_size(size, pgaio_uring_shmem_size());
+#endif
+
+	return size;
+}
+
+/*
+ * Initialize the shared I/O handles, and whatever the configured io_method
+ * needs.
+ */
+void
+AioShmemInit(void)
+{
+	bool		found;
+
+	pgaio_num_handles = (MaxBackends + NUM_AUXILIARY_PROCS) * io_max_concurrency;
+	pgaio_handles = (PgAioHandle *)
+		ShmemInitStruct("AIO Handles",
+						mul_size(pgaio_num_handles, sizeof(PgAioHandle)),
+						&found);
+
+	if (!found)
+	{
+		int			i;
+
+		for (i = 0; i < pgaio_num_handles; i++)
+		{
+			PgAioHandle *ioh = &pgaio_handles[i];
+
+			ioh->state = AHS_IDLE;
+			ioh->op = PGAIO_OP_INVALID;
+			ioh->cb = PGAIO_CB_NONE;
+			ioh->owner_procno = i / io_max_concurrency;
+			ioh->fd = -1;
+			ConditionVariableInit(&ioh->cv);
+		}
+	}
+
+	if (io_method == IOMETHOD_WORKER)
+		pgaio_worker_shmem_init();
+#ifdef USE_IO_URING
+	if (io_method == IOMETHOD_IO_URING)
+		pgaio_uring_shmem_init();
+#endif
+}
+
+/*
+ * Per-process initialization, called once MyProc is set.
+ */
+void
+pgaio_init_backend(void)
+{
+#ifdef USE_IO_URING
+	if (io_method == IOMETHOD_IO_URING)
+		pgaio_uring_init_backend();
+#endif
+}
+
+/*
+ * Number of file descriptors the postmaster keeps open only so that child
+ * processes can inherit them.  Children close those they don't need in
+ * pgaio_init_backend(), and reserve the rest with fd.c.
+ */
+int
+pgaio_inherited_fds(void)
+{
+#ifdef USE_IO_URING
+	if (io_method == IOMETHOD_IO_URING)
+		return pgaio_uring_inherited_fds();
+#endif
+	return 0;
+}
+
+/*
+ * Acquire an idle I/O handle owned by this backend.
+ *
+ * Returns NULL if all of this backend's handles are in use, or if the
+ * process cannot use asynchronous I/O at all; the caller is expected to fall
+ * back to synchronous I/O in that case.  The handle is remembered by the
+ * current resource owner, and must be returned with pgaio_io_release().
+ */
+PgAioHandle *
+pgaio_io_acquire_nb(void)
+{
+	int			first;
+	int			i;
+
+	if (pgaio_handles == NULL || MyProc == NULL || CurrentResourceOwner == NULL)
+		return NULL;
+
+	if (!pgaio_exit_callback_registered)
+	{
+		on_shmem_exit(pgaio_shmem_exit, 0);
+		pgaio_exit_callback_registered = true;
+	}
+
+	ResourceOwnerEnlargeAioHandles(CurrentResourceOwner);
+
+	first = MyProc->pgprocno * io_max_concurrency;
+	for (i = 0; i < io_max_concurrency; i++)
+	{
+		int			slot = (pgaio_next_handle + i) % io_max_concurrency;
+		PgAioHandle *ioh = &pgaio_handles[first + slot];
+
+		if (ioh->state != AHS_IDLE)
+			continue;
+
+		Assert(ioh->owner_procno == MyProc->pgprocno);
+
+		ioh->op = PGAIO_OP_INVALID;
+		ioh->cb = PGAIO_CB_NONE;
+		ioh->flags = 0;
+		ioh->status[0] = PGAIO_RS_UNKNOWN;
+		ioh->status_data[0] = 0;
+		ioh->fd = -1;
+		ioh->iovcnt = 0;
+		ioh->amount = 0;
+		ioh->result = 0;
+		ioh->ncb_data = 0;
+		ioh->state = AHS_HANDED_OUT;
+
+		pgaio_next_handle = (slot + 1) % io_max_concurrency;
+
+		ResourceOwnerRememberAioHandle(CurrentResourceOwner,
+									   pgaio_io_get_id(ioh));
+		return ioh;
+	}
+
+	return NULL;
+}
+
+/*
+ * Return a handle to the idle pool.
+ *
+ * The I/O must have completed, or never have been staged.
+ */
+void
+pgaio_io_release(PgAioHandle *ioh)
+{
+	Assert(ioh->owner_procno == MyProc->pgprocno);
+	Assert(ioh->state == AHS_COMPLETED || ioh->state == AHS_HANDED_OUT);
+
+	ResourceOwnerForgetAioHandle(CurrentResourceOwner, pgaio_io_get_id(ioh));
+	ioh->state = AHS_IDLE;
+}
+
+/*
+ * Release a handle on behalf of the resource owner mechanism, waiting for
+ * the I/O first if necessary.
+ */
+void
+pgaio_io_release_resowner(int id)
+{
+	PgAioHandle *ioh = &pgaio_handles[id];
+
+	Assert(ioh->owner_procno == MyProc->pgprocno);
+
+	if (ioh->state == AHS_HANDED_OUT && ioh->cb != PGAIO_CB_NONE)
+		pgaio_wait_all_owned();
+	else if (ioh->state == AHS_STAGED || ioh->state == AHS_IN_FLIGHT)
+		pgaio_io_wait_internal(ioh);
+
+	ResourceOwnerForgetAioHandle(CurrentResourceOwner, id);
+	ioh->state = AHS_IDLE;
+}
+
+int
+pgaio_io_get_id(PgAioHandle *ioh)
+{
+	return ioh - pgaio_handles;
+}
+
+/*
+ * Record which block an I/O is for.  This is used by I/O workers to reopen
+ * the file, and by completion callbacks and error reports.
+ */
+void
+pgaio_io_set_target(PgAioHandle *ioh, RelFileNodeBackend rnode,
+					ForkNumber forknum, BlockNumber blocknum)
+{
+	ioh->rnode = rnode;
+	ioh->forknum = forknum;
+	ioh->blocknum = blocknum;
+}
+
+void
+pgaio_io_get_target(PgAioHandle *ioh, RelFileNodeBackend *rnode,
+					ForkNumber *forknum, BlockNumber *blocknum)
+{
+	*rnode = ioh->rnode;
+	*forknum = ioh->forknum;
+	*blocknum = ioh->blocknum;
+}
+
+/*
+ * Set the callback to run when the I/O completes.  Once a callback is set,
+ * the handle is responsible for running it: if the I/O is abandoned before
+ * being staged, it is completed with an error by pgaio_wait_all_owned().
+ */
+void
+pgaio_io_set_callback(PgAioHandle *ioh, PgAioCallbackId cb, int flags)
+{
+	Assert(ioh->state == AHS_HANDED_OUT);
+
+	ioh->cb = cb;
+	ioh->flags = flags;
+}
+
+/*
+ * Add an argument for the completion callback, such as a buffer that the
+ * I/O reads into.  The callback becomes responsible for it right away, see
+ * pgaio_io_set_callback().
+ */
+void
+pgaio_io_add_cb_data(PgAioHandle *ioh, int cb_data)
+{
+	Assert(ioh->state == AHS_HANDED_OUT);
+	Assert(ioh->cb != PGAIO_CB_NONE);
+	Assert(ioh->ncb_data < PGAIO_MAX_IOV);
+
+	ioh->cb_data[ioh->ncb_data++] = cb_data;
+}
+
+/*
+ * Define a read at "offset" of file descriptor "fd" into the given iovecs,
+ * which are copied into the handle.  This is normally called by fd.c, see
+ * FilePrepareReadV().
+ *
+ * I/O workers call this on handles that are already in flight, after
+ * reopening the file in their own process.
+ */
+void
+pgaio_io_prep_readv(PgAioHandle *ioh, int fd, const struct iovec *iov,
+					int iovcnt, off_t offset)
+{
+	int			i;
+
+	Assert(ioh->state == AHS_HANDED_OUT || ioh->state == AHS_IN_FLIGHT);
+	Assert(iovcnt > 0 && iovcnt <= PGAIO_MAX_IOV);
+
+	ioh->op = PGAIO_OP_READ;
+	ioh->fd = fd;
+	ioh->offset = offset;
+	ioh->iovcnt = iovcnt;
+	ioh->amount = 0;
+	for (i = 0; i < iovcnt; i++)
+	{
+		ioh->iov[i] = iov[i];
+		ioh->amount += iov[i].iov_len;
+	}
+}
+
+/*
+ * Stage a fully defined I/O for submission.
+ *
+ * With io_method=sync the I/O is executed right away.  Otherwise it may be
+ * submitted later, so callers that stage I/O must call pgaio_submit_staged()
+ * before doing anything that could wait for another backend: that backend
+ * might in turn be waiting for the staged I/O.
+ */
+void
+pgaio_io_stage(PgAioHandle *ioh)
+{
+	Assert(ioh->state == AHS_HANDED_OUT);
+	Assert(ioh->op != PGAIO_OP_INVALID);
+
+	if (io_method == IOMETHOD_SYNC)
+	{
+		ioh->state = AHS_IN_FLIGHT;
+		pgaio_io_perform_synchronously(ioh);
+		return;
+	}
+
+	ioh->state = AHS_STAGED;
+	pgaio_staged[pgaio_num_staged++] = ioh;
+
+	if (pgaio_num_staged == PGAIO_SUBMIT_BATCH_SIZE)
+		pgaio_submit_staged();
+}
+
+/*
+ * Submit all I/Os staged by this backend.
+ */
+void
+pgaio_submit_staged(void)
+{
+	PgAioHandle *ios[PGAIO_SUBMIT_BATCH_SIZE];
+	int			nios = pgaio_num_staged;
+	int			i;
+
+	if (nios == 0)
+		return;
+
+	memcpy(ios, pgaio_staged, sizeof(PgAioHandle *) * nios);
+	pgaio_num_staged = 0;
+
+	/* make the definition of the I/Os visible before they go in flight */
+	pg_write_barrier();
+	for (i = 0; i < nios; i++)
+		ios[i]->state = AHS_IN_FLIGHT;
+
+	switch (io_method)
+	{
+		case IOMETHOD_WORKER:
+			pgaio_worker_submit(nios, ios);
+			break;
+#ifdef USE_IO_URING
+		case IOMETHOD_IO_URING:
+			pgaio_uring_submit(nios, ios);
+			break;
+#endif
+		default:
+			for (i = 0; i < nios; i++)
+				pgaio_io_perform_synchronously(ios[i]);
+			break;
+	}
+}
+
+/*
+ * If an I/O is about to use a file descriptor that is being closed, submit
+ * it now.  fd.c calls this before closing a kernel file descriptor.
+ */
+void
+pgaio_closing_fd(int fd)
+{
+	int			i;
+
+	for (i = 0; i < pgaio_num_staged; i++)
+	{
+		if (pgaio_staged[i]->fd == fd)
+		{
+			pgaio_submit_staged();
+			break;
+		}
+	}
+
+	/*
+	 * I/O already handed to the kernel keeps its own reference to the file,
+	 * so nothing more is needed for io_uring.  I/O workers reopen the file
+	 * themselves.
+	 */
+}
+
+/*
+ * Execute an I/O in the current process, then complete it.
+ */
+void
+pgaio_io_perform_synchronously(PgAioHandle *ioh)
+{
+	int			rc;
+
+	Assert(ioh->state == AHS_IN_FLIGHT);
+	Assert(ioh->op == PGAIO_OP_READ);
+
+retry:
+	pgstat_report_wait_start(WAIT_EVENT_DATA_FILE_READ);
+	rc = pg_preadv(ioh->fd, ioh->iov, ioh->iovcnt, ioh->offset);
+	pgstat_report_wait_end();
+
+	if (rc < 0)
+	{
+#ifdef WIN32
+		DWORD		error = GetLastError();
+
+		switch (error)
+		{
+			case ERROR_NO_SYSTEM_RESOURCES:
+				pg_usleep(1000L);
+				errno = EINTR;
+				break;
+			default:
+				_dosmaperr(error);
+				break;
+		}
+#endif
+		if (errno == EINTR)
+			goto retry;
+		ioh->result = -errno;
+	}
+	else
+		ioh->result = rc;
+
+	pgaio_io_process_completion(ioh);
+}
+
+/*
+ * Run the completion callback of an I/O whose result is known, and mark it
+ * as completed.  May be called in any process; must not throw errors.
+ */
+void
+pgaio_io_process_completion(PgAioHandle *ioh)
+{
+	Assert(ioh->state == AHS_IN_FLIGHT);
+
+	switch ((PgAioCallbackId) ioh->cb)
+	{
+		case PGAIO_CB_NONE:
+			ioh->status[0] = ioh->result < 0 ? PGAIO_RS_ERROR : PGAIO_RS_OK;
+			break;
+		case PGAIO_CB_SHARED_BUFFER_READ:
+			SharedBufferReadComplete(ioh);
+			break;
+	}
+
+	pg_write_barrier();
+	ioh->state = AHS_COMPLETED;
+
+	ConditionVariableBroadcast(&ioh->cv);
+}
+
+/*
+ * Wait for an I/O owned by this backend to complete.
+ */
+void
+pgaio_io_wait(PgAioHandle *ioh)
+{
+	Assert(ioh->owner_procno == MyProc->pgprocno);
+	Assert(ioh->state != AHS_IDLE && ioh->state != AHS_HANDED_OUT);
+
+	pgaio_io_wait_internal(ioh);
+}
+
+/*
+ * Wait until the I/O with the given id, which may belong to any backend, is
+ * no longer staged or in flight.  Handles are reused, so by the time this
+ * returns the id may well describe an unrelated I/O; callers must recheck
+ * whatever condition made them wait.
+ */
+void
+pgaio_wait_for_id(int id)
+{
+	Assert(id >= 0 && id < pgaio_num_handles);
+
+	pgaio_io_wait_internal(&pgaio_handles[id]);
+}
+
+static void
+pgaio_io_wait_internal(PgAioHandle *ioh)
+{
+	for (;;)
+	{
+		uint8		state = ioh->state;
+
+		pg_read_barrier();
+
+		if (state == AHS_STAGED)
+		{
+			if (ioh->owner_procno == MyProc->pgprocno)
+				pgaio_submit_staged();
+			else
+			{
+				/*
+				 * The owner will submit the I/O soon, but it won't tell us
+				 * when it does, so poll.
+				 */
+				ConditionVariablePrepareToSleep(&ioh->cv);
+				if (ioh->state == AHS_STAGED)
+					ConditionVariableTimedSleep(&ioh->cv, 10,
+												WAIT_EVENT_AIO_COMPLETION);
+				ConditionVariableCancelSleep();
+			}
+		}
+		else if (state == AHS_IN_FLIGHT)
+		{
+#ifdef USE_IO_URING
+			if (io_method == IOMETHOD_IO_URING)
+				pgaio_uring_wait_one(ioh);
+			else
+#endif
+				pgaio_io_wait_cv(ioh);
+		}
+		else
+			break;
+	}
+}
+
+/*
+ * Sleep on the handle's condition variable until it is no longer in flight.
+ */
+void
+pgaio_io_wait_cv(PgAioHandle *ioh)
+{
+	ConditionVariablePrepareToSleep(&ioh->cv);
+	while (ioh->state == AHS_IN_FLIGHT)
+		ConditionVariableSleep(&ioh->cv, WAIT_EVENT_AIO_COMPLETION);
+	ConditionVariableCancelSleep();
+}
+
+/*
+ * Get the arguments for the completion callback.  Returns their number, and
+ * sets *cb_data to point to them.
+ */
+int
+pgaio_io_get_cb_data(PgAioHandle *ioh, int **cb_data)
+{
+	*cb_data = ioh->cb_data;
+	return ioh->ncb_data;
+}
+
+int
+pgaio_io_get_flags(PgAioHandle *ioh)
+{
+	return ioh->flags;
+}
+
+int
+pgaio_io_get_result(PgAioHandle *ioh)
+{
+	return ioh->result;
+}
+
+/*
+ * Get the status of a completed I/O for its i'th callback argument, as set
+ * by its completion callback.  Pass 0 for an I/O without callback arguments.
+ */
+PgAioResultStatus
+pgaio_io_get_status(PgAioHandle *ioh, int i, int *status_data)
+{
+	Assert(ioh->state == AHS_COMPLETED);
+	Assert(i == 0 || i < ioh->ncb_data);
+
+	if (status_data)
+		*status_data = ioh->status_data[i];
+	return (PgAioResultStatus) ioh->status[i];
+}
+
+/*
+ * Set the status of an I/O for its i'th callback argument.  For use by
+ * completion callbacks, which decide what "status_data" means; it must fit
+ * in a uint8.
+ */
+void
+pgaio_io_set_status(PgAioHandle *ioh, int i, PgAioResultStatus status,
+					int status_data)
+{
+	Assert(i < PGAIO_MAX_IOV);
+	Assert(status_data >= 0 && status_data <= PG_UINT8_MAX);
+
+	ioh->status[i] = status;
+	ioh->status_data[i] = status_data;
+}
+
+/*
+ * Wait for all I/O owned by this backend to finish, after an error.
+ *
+ * Handles that were given a completion callback but were never staged are
+ * completed with an error, so that the callback releases whatever the I/O
+ * was protecting.  Handles are not released here; that is left to the
+ * resource owner, so that an outer subtransaction can still collect the
+ * results of its I/O.
+ */
+void
+pgaio_wait_all_owned(void)
+{
+	int			first;
+	int			i;
+
+	if (pgaio_handles == NULL || MyProc == NULL)
+		return;
+
+	first = MyProc->pgprocno * io_max_concurrency;
+
+	for (i = first; i < first + io_max_concurrency; i++)
+	{
+		PgAioHandle *ioh = &pgaio_handles[i];
+
+		if (ioh->state == AHS_HANDED_OUT && ioh->cb != PGAIO_CB_NONE)
+		{
+			ioh->state = AHS_IN_FLIGHT;
+			ioh->result = -EIO;
+			pgaio_io_process_completion(ioh);
+		}
+	}
+
+	pgaio_submit_staged();
+
+	for (i = first; i < first + io_max_concurrency; i++)
+	{
+		PgAioHandle *ioh = &pgaio_handles[i];
+
+		if (ioh->state == AHS_STAGED || ioh->state == AHS_IN_FLIGHT)
+			pgaio_io_wait_internal(ioh);
+	}
+}
+
+/*
+ * At process exit, wait for our I/O and return all handles to the idle pool,
+ * so that the next process using our PGPROC finds them unused.
+ */
+static void
+pgaio_shmem_exit(int code, Datum arg)
+{
+	int			first;
+	int			i;
+
+	pgaio_wait_all_owned();
+
+	first = MyProc->pgprocno * io_max_concurrency;
+	for (i = first; i < first + io_max_concurrency; i++)
+		pgaio_handles[i].state = AHS_IDLE;
+}
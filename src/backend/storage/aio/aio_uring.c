@@ -0,0 +1,450 @@
+/*-------------------------------------------------------------------------
+ *
+ * aio_uring.c
+ *	  Asynchronous I/O using Linux io_uring (io_method=io_uring).
+ *
+ * The postmaster creates one ring per PGPROC when it sets up shared memory,
+ * and all child processes inherit them.  A backend only ever submits to its
+ * own ring, so submission needs no locking.  Completions may be reaped by
+ * any backend, since a backend waiting for a buffer that another backend is
+ * reading cannot rely on the issuer to notice that the read has finished;
+ * a per-ring LWLock serializes reaping.  The lock is held only while
+ * processing completions that are already available, never while blocking.
+ *
+ * Each child closes its copies of the other processes' ring descriptors at
+ * startup, keeping only the mappings, which are all that reaping needs.  So
+ * a backend can block in the kernel only on its own ring; to wait for
+ * another backend's I/O it polls that ring's completion queue, sleeping on
+ * the handle's condition variable in between.
+ *
+ * We use the kernel's system call interface directly rather than liburing;
+ * we need only a small part of it.
+ *
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/backend/storage/aio/aio_uring.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "storage/aio_internal.h"
+
+#ifdef USE_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "port/atomics.h"
+#include "storage/condition_variable.h"
+#include "storage/fd.h"
+#include "storage/ipc.h"
+#include "storage/lwlock.h"
+#include "storage/proc.h"
+#include "storage/shmem.h"
+#include "utils/memutils.h"
+
+/*
+ * A ring, as mapped into the postmaster's (and thereby every backend's)
+ * address space.  The pointers point into memory shared with the kernel.
+ */
+typedef struct PgAioUringRing
+{
+	int			fd;
+
+	/* submission queue */
+	unsigned   *sq_head;
+	unsigned   *sq_tail;
+	unsigned   *sq_mask;
+	unsigned   *sq_array;
+	struct io_uring_sqe *sqes;
+
+	/* completion queue */
+	unsigned   *cq_head;
+	unsigned   *cq_tail;
+	unsigned   *cq_mask;
+	struct io_uring_cqe *cqes;
+
+	/* mappings, for cleanup */
+	void	   *sq_ring;
+	size_t		sq_ring_size;
+	void	   *cq_ring;
+	size_t		cq_ring_size;
+	size_t		sqes_size;
+} PgAioUringRing;
+
+/* process-local array of rings, inherited from the postmaster */
+static PgAioUringRing *pgaio_uring_rings = NULL;
+static int	pgaio_uring_num_rings = 0;
+
+/*
+ * Shared per-ring state.  owner_waiting is set, under the lock, while the
+ * ring's owner is blocked in the kernel waiting for a completion.  Other
+ * backends mustn't reap completions from the ring meanwhile: the owner would
+ * keep sleeping on an empty completion queue even though its I/O is done.
+ */
+typedef struct PgAioUringRingShared
+{
+	LWLock		lock;			/* serializes reaping completions */
+	bool		owner_waiting;
+} PgAioUringRingShared;
+
+static PgAioUringRingShared *pgaio_uring_shared = NULL;
+
+static void pgaio_uring_create_ring(PgAioUringRing *ring);
+static int	pgaio_uring_drain_locked(PgAioUringRing *ring);
+static void pgaio_uring_shmem_exit(int code, Datum arg);
+
+
+static int
+pgaio_uring_setup(unsigned entries, struct io_uring_params *p)
+{
+	return syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int
+pgaio_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+				  unsigned flags)
+{
+	return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags,
+				   NULL, 0);
+}
+
+Size
+pgaio_uring_shmem_size(void)
+{
+	return mul_size(MaxBackends + NUM_AUXILIARY_PROCS,
+					sizeof(PgAioUringRingShared));
+}
+
+void
+pgaio_uring_shmem_init(void)
+{
+	int			nrings = MaxBackends + NUM_AUXILIARY_PROCS;
+	bool		found;
+	int			i;
+
+	pgaio_uring_shared = (PgAioUringRingShared *)
+		ShmemInitStruct("AIO io_uring Rings", pgaio_uring_shmem_size(),
+						&found);
+
+	if (!found)
+	{
+		for (i = 0; i < nrings; i++)
+		{
+			LWLockInitialize(&pgaio_uring_shared[i].lock,
+							 LWTRANCHE_AIO_URING_COMPLETION);
+			pgaio_uring_shared[i].owner_waiting = false;
+		}
+	}
+
+	LWLockRegisterTranche(LWTRANCHE_AIO_URING_COMPLETION,
+						  "aio_uring_completion");
+
+	/*
+	 * The rings themselves are created only once, by the postmaster (or a
+	 * standalone backend), and inherited by all children.
+	 */
+	if (IsUnderPostmaster)
+		return;
+
+	pgaio_uring_rings = (PgAioUringRing *)
+		MemoryContextAllocZero(TopMemoryContext,
+							   sizeof(PgAioUringRing) * nrings);
+	pgaio_uring_num_rings = 0;
+	on_shmem_exit(pgaio_uring_shmem_exit, 0);
+
+	for (i = 0; i < nrings; i++)
+	{
+		pgaio_uring_create_ring(&pgaio_uring_rings[i]);
+		pgaio_uring_num_rings++;
+	}
+}
+
+static void
+pgaio_uring_create_ring(PgAioUringRing *ring)
+{
+	struct io_uring_params p;
+	char	   *sq;
+	char	   *cq;
+
+	memset(&p, 0, sizeof(p));
+
+	/*
+	 * A backend can't have more I/Os in flight than it has handles, so the
+	 * queues can't overflow.
+	 */
+	ring->fd = pgaio_uring_setup(io_max_concurrency, &p);
+	if (ring->fd < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not create io_uring: %m"),
+				 errhint("io_method = io_uring requires Linux 5.6 or later.")));
+
+	ring->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	ring->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+	ring->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+
+	if (p.features & IORING_FEAT_SINGLE_MMAP)
+		ring->sq_ring_size = ring->cq_ring_size =
+			Max(ring->sq_ring_size, ring->cq_ring_size);
+
+	ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+						 MAP_SHARED | MAP_POPULATE, ring->fd,
+						 IORING_OFF_SQ_RING);
+	if (ring->sq_ring == MAP_FAILED)
+		ereport(ERROR,
+				(errmsg("could not map io_uring submission queue: %m")));
+
+	if (p.features & IORING_FEAT_SINGLE_MMAP)
+		ring->cq_ring = ring->sq_ring;
+	else
+	{
+		ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+							 MAP_SHARED | MAP_POPULATE, ring->fd,
+							 IORING_OFF_CQ_RING);
+		if (ring->cq_ring == MAP_FAILED)
+			ereport(ERROR,
+					(errmsg("could not map io_uring completion queue: %m")));
+	}
+
+	ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+					  MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED)
+		ereport(ERROR,
+				(errmsg("could not map io_uring submission queue entries: %m")));
+
+	sq = (char *) ring->sq_ring;
+	ring->sq_head = (unsigned *) (sq + p.sq_off.head);
+	ring->sq_tail = (unsigned *) (sq + p.sq_off.tail);
+	ring->sq_mask = (unsigned *) (sq + p.sq_off.ring_mask);
+	ring->sq_array = (unsigned *) (sq + p.sq_off.array);
+
+	cq = (char *) ring->cq_ring;
+	ring->cq_head = (unsigned *) (cq + p.cq_off.head);
+	ring->cq_tail = (unsigned *) (cq + p.cq_off.tail);
+	ring->cq_mask = (unsigned *) (cq + p.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *) (cq + p.cq_off.cqes);
+}
+
+/*
+ * Number of ring descriptors the postmaster holds on behalf of its children.
+ * Each child closes all but its own, see pgaio_uring_init_backend().
+ */
+int
+pgaio_uring_inherited_fds(void)
+{
+	return pgaio_uring_num_rings;
+}
+
+/*
+ * Close the descriptors of the rings that belong to other processes, and
+ * account for our own with fd.c.  The rings stay mapped, so we can still reap
+ * their completions.  Called once MyProc is set.
+ */
+void
+pgaio_uring_init_backend(void)
+{
+	int			i;
+
+	Assert(MyProc != NULL);
+
+	for (i = 0; i < pgaio_uring_num_rings; i++)
+	{
+		PgAioUringRing *ring = &pgaio_uring_rings[i];
+
+		if (i == MyProc->pgprocno || ring->fd < 0)
+			continue;
+
+		close(ring->fd);
+		ring->fd = -1;
+	}
+
+	ReserveExternalFD();
+}
+
+/*
+ * Close all rings when the postmaster resets shared memory or exits.
+ */
+static void
+pgaio_uring_shmem_exit(int code, Datum arg)
+{
+	int			i;
+
+	for (i = 0; i < pgaio_uring_num_rings; i++)
+	{
+		PgAioUringRing *ring = &pgaio_uring_rings[i];
+
+		munmap(ring->sqes, ring->sqes_size);
+		if (ring->cq_ring != ring->sq_ring)
+			munmap(ring->cq_ring, ring->cq_ring_size);
+		munmap(ring->sq_ring, ring->sq_ring_size);
+		if (ring->fd >= 0)
+			close(ring->fd);
+	}
+
+	pfree(pgaio_uring_rings);
+	pgaio_uring_rings = NULL;
+	pgaio_uring_num_rings = 0;
+}
+
+/*
+ * Submit I/Os to our own ring.
+ */
+void
+pgaio_uring_submit(int nios, PgAioHandle **ios)
+{
+	PgAioUringRing *ring = &pgaio_uring_rings[MyProc->pgprocno];
+	unsigned	mask = *ring->sq_mask;
+	unsigned	tail = *ring->sq_tail;
+	int			submitted = 0;
+	int			i;
+
+	for (i = 0; i < nios; i++)
+	{
+		PgAioHandle *ioh = ios[i];
+		unsigned	idx = tail & mask;
+		struct io_uring_sqe *sqe = &ring->sqes[idx];
+
+		Assert(ioh->op == PGAIO_OP_READ);
+
+		memset(sqe, 0, sizeof(*sqe));
+		sqe->opcode = IORING_OP_READV;
+		sqe->fd = ioh->fd;
+		sqe->off = ioh->offset;
+		sqe->addr = (uint64) (uintptr_t) ioh->iov;
+		sqe->len = ioh->iovcnt;
+		sqe->user_data = pgaio_io_get_id(ioh);
+
+		ring->sq_array[idx] = idx;
+		tail++;
+	}
+
+	/* the kernel must see the entries before the new tail */
+	pg_write_barrier();
+	*(volatile unsigned *) ring->sq_tail = tail;
+
+	while (submitted < nios)
+	{
+		int			rc;
+
+		rc = pgaio_uring_enter(ring->fd, nios - submitted, 0, 0);
+		if (rc < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN || errno == EBUSY)
+			{
+				/* make room by reaping completions, then retry */
+				LWLockAcquire(&pgaio_uring_shared[MyProc->pgprocno].lock,
+							  LW_EXCLUSIVE);
+				pgaio_uring_drain_locked(ring);
+				LWLockRelease(&pgaio_uring_shared[MyProc->pgprocno].lock);
+				continue;
+			}
+
+			/*
+			 * The I/Os are in the submission queue, and we have no way to
+			 * take them back.  Buffers would be left with I/O in progress
+			 * forever, so there's no choice but to PANIC.
+			 */
+			elog(PANIC, "could not submit I/O to io_uring: %m");
+		}
+		submitted += rc;
+	}
+}
+
+/*
+ * Process all completions available in a ring.  Caller must hold the ring's
+ * completion lock.  Returns the number of completions processed.
+ */
+static int
+pgaio_uring_drain_locked(PgAioUringRing *ring)
+{
+	unsigned	mask = *ring->cq_mask;
+	unsigned	head = *ring->cq_head;
+	unsigned	tail;
+	int			nreaped = 0;
+
+	tail = *(volatile unsigned *) ring->cq_tail;
+	pg_read_barrier();
+
+	while (head != tail)
+	{
+		struct io_uring_cqe *cqe = &ring->cqes[head & mask];
+		PgAioHandle *ioh = &pgaio_handles[cqe->user_data];
+
+		ioh->result = cqe->res;
+		head++;
+		nreaped++;
+
+		pgaio_io_process_completion(ioh);
+	}
+
+	/* we're done reading the entries, let the kernel reuse them */
+	pg_memory_barrier();
+	*(volatile unsigned *) ring->cq_head = head;
+
+	return nreaped;
+}
+
+/*
+ * Wait for an in-flight I/O, which may belong to any backend, reaping
+ * completions from its owner's ring as needed.
+ *
+ * If the I/O is ours, we block in the kernel until our ring has a completion,
+ * without holding the ring's lock.  We can't enter another backend's ring, so
+ * for its I/Os we check its completion queue periodically, in case the owner
+ * isn't around to reap, and otherwise sleep on the handle's condition
+ * variable.
+ */
+void
+pgaio_uring_wait_one(PgAioHandle *ioh)
+{
+	int			owner = ioh->owner_procno;
+	PgAioUringRing *ring = &pgaio_uring_rings[owner];
+	PgAioUringRingShared *shared = &pgaio_uring_shared[owner];
+	bool		mine = (owner == MyProc->pgprocno);
+
+	ConditionVariablePrepareToSleep(&ioh->cv);
+
+	while (ioh->state == AHS_IN_FLIGHT)
+	{
+		bool		block = false;
+
+		LWLockAcquire(&shared->lock, LW_EXCLUSIVE);
+		if (mine || !shared->owner_waiting)
+			pgaio_uring_drain_locked(ring);
+		if (mine && ioh->state == AHS_IN_FLIGHT)
+			shared->owner_waiting = block = true;
+		LWLockRelease(&shared->lock);
+
+		if (block)
+		{
+			int			rc;
+
+			pgstat_report_wait_start(WAIT_EVENT_AIO_COMPLETION);
+			rc = pgaio_uring_enter(ring->fd, 0, 1, IORING_ENTER_GETEVENTS);
+			pgstat_report_wait_end();
+
+			shared->owner_waiting = false;
+
+			if (rc < 0 && errno != EINTR)
+				elog(ERROR, "could not wait for io_uring completion: %m");
+		}
+		else if (ioh->state == AHS_IN_FLIGHT)
+			ConditionVariableTimedSleep(&ioh->cv, 1,
+										WAIT_EVENT_AIO_COMPLETION);
+	}
+
+	ConditionVariableCancelSleep();
+}
+
+#endif							/* USE_IO_URING */
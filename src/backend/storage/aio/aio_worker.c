@@ -0,0 +1,337 @@
+/*-------------------------------------------------------------------------
+ *
+ * aio_worker.c
+ *	  Asynchronous I/O executed by I/O worker processes (io_method=worker).
+ *
+ * Backends put the ids of I/O handles into a shared submission queue and
+ * wake up an idle worker.  Since file descriptors are private to each
+ * process, a worker reopens the file through smgr for every I/O it
+ * executes; that also protects it against using a descriptor that refers to
+ * a file that has been dropped and replaced in the meantime.
+ *
+ * If no worker is running, which can happen early during startup, during a
+ * smart shutdown or after a worker crashed, submitters execute their I/O
+ * themselves.
+ *
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/backend/storage/aio/aio_worker.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "port/pg_bitutils.h"
+#include "postmaster/bgworker.h"
+#include "postmaster/interrupt.h"
+#include "storage/aio_internal.h"
+#include "storage/ipc.h"
+#include "storage/latch.h"
+#include "storage/proc.h"
+#include "storage/shmem.h"
+#include "storage/smgr.h"
+#include "storage/spin.h"
+#include "utils/guc.h"
+
+/* GUC variable */
+int			io_workers = 3;
+
+typedef struct PgAioWorkerControl
+{
+	slock_t		lock;			/* protects all fields below */
+
+	int			nworkers_running;	/* workers accepting I/O */
+	uint32		idle_workers;	/* bitmap of workers waiting for I/O */
+	Latch	   *latches[MAX_IO_WORKERS];
+
+	/* circular queue of handle ids */
+	int			queue_size;
+	int			queue_head;		/* next entry to dequeue */
+	int			queue_count;	/* number of queued entries */
+	int			queue[FLEXIBLE_ARRAY_MEMBER];
+} PgAioWorkerControl;
+
+static PgAioWorkerControl *pgaio_worker_control = NULL;
+
+/* our worker id, if we are an I/O worker that is accepting I/O */
+static int	MyIoWorkerId = -1;
+
+static void pgaio_worker_perform(PgAioHandle *ioh);
+static void pgaio_worker_die(int code, Datum arg);
+
+
+static int
+pgaio_worker_queue_size(void)
+{
+	/* every handle can be queued at most once, so the queue can't overflow */
+	return (MaxBackends + NUM_AUXILIARY_PROCS) * io_max_concurrency;
+}
+
+Size
+pgaio_worker_shmem_size(void)
+{
+	return add_size(offsetof(PgAioWorkerControl, queue),
+					mul_size(pgaio_worker_queue_size(), sizeof(int)));
+}
+
+void
+pgaio_worker_shmem_init(void)
+{
+	bool		found;
+
+	pgaio_worker_control = (PgAioWorkerControl *)
+		ShmemInitStruct("AIO Worker Control", pgaio_worker_shmem_size(),
+						&found);
+
+	if (!found)
+	{
+		SpinLockInit(&pgaio_worker_control->lock);
+		pgaio_worker_control->nworkers_running = 0;
+		pgaio_worker_control->idle_workers = 0;
+		memset(pgaio_worker_control->latches, 0,
+			   sizeof(pgaio_worker_control->latches));
+		pgaio_worker_control->queue_size = pgaio_worker_queue_size();
+		pgaio_worker_control->queue_head = 0;
+		pgaio_worker_control->queue_count = 0;
+	}
+}
+
+/*
+ * Register the I/O worker processes.  Called by the postmaster at startup,
+ * before InitializeMaxBackends().
+ */
+void
+IoWorkersRegister(void)
+{
+	BackgroundWorker bgw;
+	int			i;
+
+	if (io_method != IOMETHOD_WORKER)
+		return;
+
+	for (i = 0; i < io_workers; i++)
+	{
+		memset(&bgw, 0, sizeof(bgw));
+		bgw.bgw_flags = BGWORKER_SHMEM_ACCESS;
+		bgw.bgw_start_time = BgWorkerStart_PostmasterStart;
+		snprintf(bgw.bgw_library_name, BGW_MAXLEN, "postgres");
+		snprintf(bgw.bgw_function_name, BGW_MAXLEN, "IoWorkerMain");
+		snprintf(bgw.bgw_name, BGW_MAXLEN, "io worker %d", i);
+		snprintf(bgw.bgw_type, BGW_MAXLEN, "io worker");
+		bgw.bgw_restart_time = 1;
+		bgw.bgw_notify_pid = 0;
+		bgw.bgw_main_arg = Int32GetDatum(i);
+
+		RegisterBackgroundWorker(&bgw);
+	}
+}
+
+/*
+ * Queue I/Os for execution by the workers.
+ */
+void
+pgaio_worker_submit(int nios, PgAioHandle **ios)
+{
+	PgAioWorkerControl *ctl = pgaio_worker_control;
+	Latch	   *wakeup[MAX_IO_WORKERS];
+	int			nwakeup = 0;
+	bool		run_locally = false;
+	int			i;
+
+	SpinLockAcquire(&ctl->lock);
+	if (ctl->nworkers_running == 0)
+		run_locally = true;
+	else
+	{
+		for (i = 0; i < nios; i++)
+		{
+			int			pos = (ctl->queue_head + ctl->queue_count) % ctl->queue_size;
+
+			ctl->queue[pos] = pgaio_io_get_id(ios[i]);
+			ctl->queue_count++;
+		}
+
+		/* wake up one idle worker per I/O */
+		while (nwakeup < nios && ctl->idle_workers != 0)
+		{
+			int			worker = pg_rightmost_one_pos32(ctl->idle_workers);
+
+			ctl->idle_workers &= ~((uint32) 1 << worker);
+			wakeup[nwakeup++] = ctl->latches[worker];
+		}
+	}
+	SpinLockRelease(&ctl->lock);
+
+	if (run_locally)
+	{
+		for (i = 0; i < nios; i++)
+			pgaio_io_perform_synchronously(ios[i]);
+		return;
+	}
+
+	for (i = 0; i < nwakeup; i++)
+		SetLatch(wakeup[i]);
+}
+
+/*
+ * Execute one I/O on behalf of another backend.
+ */
+static void
+pgaio_worker_perform(PgAioHandle *ioh)
+{
+	RelFileNodeBackend rnode;
+	ForkNumber	forknum;
+	BlockNumber blocknum;
+	char	   *buffers[PGAIO_MAX_IOV];
+	BlockNumber nblocks = 0;
+	SMgrRelation volatile reln = NULL;
+	volatile bool failed = false;
+	int			i;
+
+	pgaio_io_get_target(ioh, &rnode, &forknum, &blocknum);
+
+	/* recover the issuer's buffers, which are in shared memory */
+	for (i = 0; i < ioh->iovcnt; i++)
+	{
+		size_t		off;
+
+		for (off = 0; off < ioh->iov[i].iov_len; off += BLCKSZ)
+		{
+			Assert(nblocks < lengthof(buffers));
+			buffers[nblocks++] = (char *) ioh->iov[i].iov_base + off;
+		}
+	}
+
+	/*
+	 * Opening the file can fail, for example if the relation has been
+	 * dropped.  Report that to the issuer as a failed I/O, rather than
+	 * letting the error take down the worker.
+	 */
+	PG_TRY();
+	{
+		reln = smgropen(rnode.node, rnode.backend);
+		smgrpreparereadv(reln, forknum, blocknum, buffers, nblocks, ioh);
+	}
+	PG_CATCH();
+	{
+		EmitErrorReport();
+		FlushErrorState();
+		failed = true;
+	}
+	PG_END_TRY();
+
+	if (failed)
+	{
+		ioh->result = -EIO;
+		pgaio_io_process_completion(ioh);
+	}
+	else
+		pgaio_io_perform_synchronously(ioh);
+
+	if (reln != NULL)
+		smgrclose(reln);
+}
+
+/*
+ * Stop accepting I/O when exiting.
+ */
+static void
+pgaio_worker_die(int code, Datum arg)
+{
+	PgAioWorkerControl *ctl = pgaio_worker_control;
+
+	if (MyIoWorkerId < 0)
+		return;
+
+	SpinLockAcquire(&ctl->lock);
+	ctl->idle_workers &= ~((uint32) 1 << MyIoWorkerId);
+	ctl->latches[MyIoWorkerId] = NULL;
+	ctl->nworkers_running--;
+	SpinLockRelease(&ctl->lock);
+
+	MyIoWorkerId = -1;
+}
+
+/*
+ * Main entry point for I/O worker processes.
+ */
+void
+IoWorkerMain(Datum main_arg)
+{
+	PgAioWorkerControl *ctl = pgaio_worker_control;
+	int			worker_id = DatumGetInt32(main_arg);
+
+	Assert(worker_id >= 0 && worker_id < MAX_IO_WORKERS);
+
+	pqsignal(SIGHUP, SignalHandlerForConfigReload);
+	pqsignal(SIGTERM, SignalHandlerForShutdownRequest);
+	BackgroundWorkerUnblockSignals();
+
+	SpinLockAcquire(&ctl->lock);
+	if (ctl->latches[worker_id] != NULL)
+	{
+		SpinLockRelease(&ctl->lock);
+		elog(ERROR, "I/O worker %d is already running", worker_id);
+	}
+	ctl->latches[worker_id] = MyLatch;
+	ctl->nworkers_running++;
+	SpinLockRelease(&ctl->lock);
+
+	MyIoWorkerId = worker_id;
+	on_shmem_exit(pgaio_worker_die, 0);
+
+	for (;;)
+	{
+		int			id = -1;
+		bool		exiting = false;
+
+		SpinLockAcquire(&ctl->lock);
+		if (ctl->queue_count > 0)
+		{
+			id = ctl->queue[ctl->queue_head];
+			ctl->queue_head = (ctl->queue_head + 1) % ctl->queue_size;
+			ctl->queue_count--;
+		}
+		else if (ShutdownRequestPending)
+		{
+			/*
+			 * Only stop accepting I/O once the queue is empty, so that a
+			 * submitter never queues I/O that nobody will execute.
+			 */
+			ctl->idle_workers &= ~((uint32) 1 << worker_id);
+			ctl->latches[worker_id] = NULL;
+			ctl->nworkers_running--;
+			exiting = true;
+		}
+		else
+			ctl->idle_workers |= (uint32) 1 << worker_id;
+		SpinLockRelease(&ctl->lock);
+
+		if (id >= 0)
+		{
+			pgaio_worker_perform(&pgaio_handles[id]);
+			continue;
+		}
+
+		if (exiting)
+		{
+			MyIoWorkerId = -1;
+			proc_exit(0);
+		}
+
+		(void) WaitLatch(MyLatch, WL_LATCH_SET | WL_EXIT_ON_PM_DEATH, -1L,
+						 WAIT_EVENT_IO_WORKER_MAIN);
+		ResetLatch(MyLatch);
+
+		if (ConfigReloadPending)
+		{
+			ConfigReloadPending = false;
+			ProcessConfigFile(PGC_SIGHUP);
+		}
+	}
+}
@@ -0,0 +1,367 @@
+/*-------------------------------------------------------------------------
+ *
+ * read_stream.c
+ *	  Mechanism for reading a sequence of relation blocks ahead of use.
+ *
+ * A read stream is created with a callback that returns the block numbers a
+ * scan is going to need, in the order it is going to need them.  Each call
+ * to read_stream_next_buffer() returns the next of those blocks, pinned,
+ * while reads of the following blocks have already been started with
+ * StartReadBuffers().  With an asynchronous io_method, that lets the I/O for
+ * upcoming blocks proceed while the caller works on the current one.
+ *
+ * Runs of consecutive block numbers are read with a single I/O of up to
+ * io_combine_limit blocks.  To give runs a chance to grow to that size, a
+ * new run is only started when there is room for a full one, unless nothing
+ * at all is pending.
+ *
+ * The number of blocks started ahead of the caller, the lookahead distance,
+ * adapts to what the stream finds.  It starts at 1, which means no
+ * lookahead at all, and doubles every time an I/O is started, up to
+ * io_combine_limit blocks for each I/O allowed by effective_io_concurrency
+ * or maintenance_io_concurrency.  Every block that is already in shared
+ * buffers reduces it by one again.  So a stream over cached data doesn't pin
+ * buffers it doesn't need, while a stream over uncached data quickly gets
+ * enough I/O in flight.  The number of I/Os in progress is limited
+ * separately, so that a stream of scattered blocks doesn't start many more
+ * small I/Os than the setting allows.
+ *
+ * Each block that has been started is pinned, so the distance is also
+ * limited by the size of the access strategy's ring, if any, and by a fair
+ * share of shared_buffers per backend.
+ *
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/backend/storage/aio/read_stream.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "catalog/catalog.h"
+#include "miscadmin.h"
+#include "storage/aio.h"
+#include "storage/proc.h"
+#include "storage/read_stream.h"
+#include "utils/rel.h"
+#include "utils/spccache.h"
+
+struct ReadStream
+{
+	Relation	rel;
+	ForkNumber	forknum;
+	BufferAccessStrategy strategy;
+	ReadStreamBlockNumberCB callback;
+	void	   *callback_private_data;
+
+	int			max_pinned;		/* size of the queue below */
+	int			max_ios;		/* maximum number of I/Os in progress */
+	int			io_combine_limit;	/* maximum number of blocks per I/O */
+	int			initial_distance;	/* lookahead distance after a reset */
+	int			distance;		/* current lookahead distance */
+	int			ios_in_progress;	/* I/Os started and not yet waited for */
+	bool		finished;		/* callback returned InvalidBlockNumber */
+
+	/* block returned by the callback that didn't fit in the last run */
+	BlockNumber unused_blocknum;
+
+	/* circular queue of reads that have been started */
+	int			head;			/* oldest entry */
+	int			npending;		/* number of entries */
+
+	size_t		per_buffer_data_size;
+	char	   *per_buffer_data;	/* max_pinned entries of that size */
+
+	PendingBufferRead reads[FLEXIBLE_ARRAY_MEMBER];
+};
+
+static inline void *
+get_per_buffer_data(ReadStream *stream, int index)
+{
+	if (stream->per_buffer_data_size == 0)
+		return NULL;
+
+	return stream->per_buffer_data + stream->per_buffer_data_size * index;
+}
+
+/*
+ * Get the next block number from the callback, or the one it returned last
+ * time, if that couldn't be used yet.
+ */
+static BlockNumber
+read_stream_get_block(ReadStream *stream, int index)
+{
+	BlockNumber blocknum;
+
+	if (stream->unused_blocknum != InvalidBlockNumber)
+	{
+		/* its per-buffer data was stored at the same index already */
+		blocknum = stream->unused_blocknum;
+		stream->unused_blocknum = InvalidBlockNumber;
+		return blocknum;
+	}
+
+	return stream->callback(stream, stream->callback_private_data,
+							get_per_buffer_data(stream, index));
+}
+
+/*
+ * Start reads until the lookahead distance is reached or the callback runs
+ * out of blocks.
+ */
+static void
+read_stream_look_ahead(ReadStream *stream)
+{
+	bool		started = false;
+
+	while (!stream->finished && stream->npending < stream->distance &&
+		   stream->ios_in_progress < stream->max_ios)
+	{
+		int			index;
+		int			limit;
+		int			nblocks = 0;
+		BlockNumber first_blocknum = InvalidBlockNumber;
+
+		/* wait for room for a full run, see above */
+		limit = Min(stream->distance, stream->io_combine_limit);
+		if (stream->npending > 0 &&
+			stream->distance - stream->npending < limit)
+			break;
+
+		/* a run must not wrap around the end of the queue */
+		index = (stream->head + stream->npending) % stream->max_pinned;
+		limit = Min(limit, stream->max_pinned - index);
+
+		/* collect a run of consecutive blocks */
+		while (nblocks < limit)
+		{
+			BlockNumber blocknum;
+
+			blocknum = read_stream_get_block(stream, index + nblocks);
+			if (blocknum == InvalidBlockNumber)
+			{
+				stream->finished = true;
+				break;
+			}
+			if (nblocks > 0 && blocknum != first_blocknum + nblocks)
+			{
+				/* save it for the next run, which starts at its index */
+				stream->unused_blocknum = blocknum;
+				break;
+			}
+			if (nblocks == 0)
+				first_blocknum = blocknum;
+			nblocks++;
+		}
+
+		/* start the run, in as many pieces as StartReadBuffers() needs */
+		while (nblocks > 0)
+		{
+			int			nstarted = nblocks;
+
+			if (StartReadBuffers(&stream->reads[index], &nstarted,
+								 stream->rel, stream->forknum,
+								 first_blocknum, RBM_NORMAL,
+								 stream->strategy))
+			{
+				/* had to read it; look further ahead */
+				stream->distance = Min(stream->distance * 2,
+									   stream->max_pinned);
+				stream->ios_in_progress++;
+				started = true;
+			}
+			else if (stream->distance > 1)
+			{
+				/* buffer hit; lookahead doesn't seem to be paying off */
+				stream->distance--;
+			}
+			stream->npending += nstarted;
+			index += nstarted;
+			first_blocknum += nstarted;
+			nblocks -= nstarted;
+		}
+	}
+
+	/*
+	 * Get the reads we just started going.  This also makes sure nothing we
+	 * staged can be left behind while the caller waits for something else.
+	 */
+	if (started)
+		pgaio_submit_staged();
+}
+
+/*
+ * Create a new read stream for the given fork of a relation.
+ *
+ * The callback is called to obtain block numbers until it returns
+ * InvalidBlockNumber; see ReadStreamBlockNumberCB.  Blocks are read with
+ * RBM_NORMAL and the given strategy.
+ */
+ReadStream *
+read_stream_begin_relation(int flags,
+						   BufferAccessStrategy strategy,
+						   Relation rel,
+						   ForkNumber forknum,
+						   ReadStreamBlockNumberCB callback,
+						   void *callback_private_data,
+						   size_t per_buffer_data_size)
+{
+	ReadStream *stream;
+	int			max_ios;
+	int			max_pinned;
+	int			strategy_pin_limit;
+	int			combine_limit;
+
+	/*
+	 * Looking up the tablespace's settings reads the catalogs, which doesn't
+	 * work while they are being scanned to build the relcache, nor before
+	 * they exist in bootstrap mode.  Catalog scans just use the GUCs.
+	 */
+	if (IsBootstrapProcessingMode() || IsCatalogRelation(rel))
+		max_ios = (flags & READ_STREAM_MAINTENANCE) ?
+			maintenance_io_concurrency : effective_io_concurrency;
+	else if (flags & READ_STREAM_MAINTENANCE)
+		max_ios = get_tablespace_maintenance_io_concurrency(rel->rd_rel->reltablespace);
+	else
+		max_ios = get_tablespace_io_concurrency(rel->rd_rel->reltablespace);
+	max_ios = Min(max_ios, io_max_concurrency);
+
+	/*
+	 * Room for a full I/O for the caller to work through, plus one for each
+	 * I/O being read ahead.
+	 */
+	max_pinned = (max_ios + 1) * io_combine_limit;
+
+	/*
+	 * Reads of local buffers are always executed synchronously, so there is
+	 * nothing to gain from reading ahead.
+	 */
+	if (RelationUsesLocalBuffers(rel))
+		max_pinned = 1;
+
+	/*
+	 * Don't pin more than half of the strategy's ring, or the ring would
+	 * have to be bypassed to find buffers for the reads.  Likewise, don't
+	 * pin more than a fair share of shared_buffers.
+	 */
+	strategy_pin_limit = GetAccessStrategyBufferCount(strategy) / 2;
+	if (strategy_pin_limit > 0)
+		max_pinned = Min(max_pinned, strategy_pin_limit);
+	max_pinned = Min(max_pinned,
+					 NBuffers / (MaxBackends + NUM_AUXILIARY_PROCS));
+	max_pinned = Max(max_pinned, 1);
+
+	/*
+	 * Keep I/Os small enough that two of them fit, so that one can be read
+	 * while the caller works through the other.
+	 */
+	combine_limit = Min(io_combine_limit, Max(max_pinned / 2, 1));
+
+	stream = (ReadStream *) palloc0(offsetof(ReadStream, reads) +
+									sizeof(PendingBufferRead) * max_pinned);
+	stream->rel = rel;
+	stream->forknum = forknum;
+	stream->strategy = strategy;
+	stream->callback = callback;
+	stream->callback_private_data = callback_private_data;
+	stream->max_pinned = max_pinned;
+	stream->max_ios = Max(max_ios, 1);
+	stream->io_combine_limit = combine_limit;
+	stream->ios_in_progress = 0;
+	stream->initial_distance = (flags & READ_STREAM_FULL) ? max_pinned : 1;
+	stream->distance = stream->initial_distance;
+	stream->finished = false;
+	stream->unused_blocknum = InvalidBlockNumber;
+	stream->head = 0;
+	stream->npending = 0;
+	stream->per_buffer_data_size = MAXALIGN(per_buffer_data_size);
+	if (per_buffer_data_size > 0)
+		stream->per_buffer_data = palloc(stream->per_buffer_data_size *
+										 max_pinned);
+
+	return stream;
+}
+
+/*
+ * Return the next buffer in the stream, pinned but not locked, or
+ * InvalidBuffer at the end of the stream.  The caller is responsible for
+ * releasing the pin.
+ *
+ * If per_buffer_data is not NULL, *per_buffer_data is set to the data the
+ * callback stored for this block.  It stays valid until the next call.
+ */
+Buffer
+read_stream_next_buffer(ReadStream *stream, void **per_buffer_data)
+{
+	PendingBufferRead *read;
+	Buffer		buffer;
+	int			index;
+
+	read_stream_look_ahead(stream);
+
+	if (stream->npending == 0)
+	{
+		Assert(stream->finished);
+		if (per_buffer_data)
+			*per_buffer_data = NULL;
+		return InvalidBuffer;
+	}
+
+	index = stream->head;
+	read = &stream->reads[index];
+	if (read->ioh != NULL)
+		stream->ios_in_progress--;
+	buffer = WaitReadBuffer(read);
+
+	stream->head = (stream->head + 1) % stream->max_pinned;
+	stream->npending--;
+
+	if (per_buffer_data)
+		*per_buffer_data = get_per_buffer_data(stream, index);
+
+	return buffer;
+}
+
+/*
+ * Release all buffers that have been read ahead, and start over: the next
+ * call to read_stream_next_buffer() will call the callback again, even if it
+ * has already returned InvalidBlockNumber.
+ */
+void
+read_stream_reset(ReadStream *stream)
+{
+	while (stream->npending > 0)
+	{
+		PendingBufferRead *read = &stream->reads[stream->head];
+		Buffer		buffer;
+
+		if (read->ioh != NULL)
+			stream->ios_in_progress--;
+		buffer = WaitReadBuffer(read);
+		ReleaseBuffer(buffer);
+
+		stream->head = (stream->head + 1) % stream->max_pinned;
+		stream->npending--;
+	}
+
+	stream->head = 0;
+	stream->finished = false;
+	stream->unused_blocknum = InvalidBlockNumber;
+	stream->distance = stream->initial_distance;
+}
+
+/*
+ * Release all resources held by a read stream.
+ */
+void
+read_stream_end(ReadStream *stream)
+{
+	read_stream_reset(stream);
+
+	if (stream->per_buffer_data)
+		pfree(stream->per_buffer_data);
+	pfree(stream);
+}
@@ -14,15 +14,26 @@
  */
 #include "postgres.h"
 
+#include "port/pg_numa.h"
 #include "storage/buf_internals.h"
 #include "storage/bufmgr.h"
+#include "storage/pg_shmem.h"
 
 BufferDescPadded *BufferDescriptors;
 char	   *BufferBlocks;
-LWLockMinimallyPadded *BufferIOLWLockArray = NULL;
+BufferIO   *BufferIOArray = NULL;
 WritebackContext BackendWritebackContext;
 CkptSortItem *CkptBufferIds;
 
+/* GUC variable */
+int			numa_placement = NUMA_PLACEMENT_OFF;
+
+#ifdef USE_NUMA
+static void PlaceBufferPool(void);
+static bool PlaceBufferRange(int first_buffer, int num_buffers, int node);
+static bool PlaceMemory(char *start, Size size, int node);
+#endif
+
 
 /*
  * Data Structures:
@@ -68,7 +79,7 @@ InitBufferPool(void)
 {
 	bool		foundBufs,
 				foundDescs,
-				foundIOLocks,
+				foundIO,
 				foundBufCkpt;
 
 	/* Align descriptors to a cacheline boundary. */
@@ -77,17 +88,18 @@ InitBufferPool(void)
 						NBuffers * sizeof(BufferDescPadded),
 						&foundDescs);
 
+	/* Align buffer pages suitably for direct I/O */
 	BufferBlocks = (char *)
-		ShmemInitStruct("Buffer Blocks",
-						NBuffers * (Size) BLCKSZ, &foundBufs);
+		TYPEALIGN(PG_IO_ALIGN_SIZE,
+				  ShmemInitStruct("Buffer Blocks",
+								  NBuffers * (Size) BLCKSZ + PG_IO_ALIGN_SIZE,
+								  &foundBufs));
 
-	/* Align lwlocks to cacheline boundary */
-	BufferIOLWLockArray = (LWLockMinimallyPadded *)
-		ShmemInitStruct("Buffer IO Locks",
-						NBuffers * (Size) sizeof(LWLockMinimallyPadded),
-						&foundIOLocks);
+	BufferIOArray = (BufferIO *)
+		ShmemInitStruct("Buffer IO State",
+						NBuffers * (Size) sizeof(BufferIO),
+						&foundIO);
 
-	LWLockRegisterTranche(LWTRANCHE_BUFFER_IO_IN_PROGRESS, "buffer_io");
 	LWLockRegisterTranche(LWTRANCHE_BUFFER_CONTENT, "buffer_content");
 
 	/*
@@ -101,10 +113,10 @@ InitBufferPool(void)
 		ShmemInitStruct("Checkpoint BufferIds",
 						NBuffers * sizeof(CkptSortItem), &foundBufCkpt);
 
-	if (foundDescs || foundBufs || foundIOLocks || foundBufCkpt)
+	if (foundDescs || foundBufs || foundIO || foundBufCkpt)
 	{
 		/* should find all of these, or none of them */
-		Assert(foundDescs && foundBufs && foundIOLocks && foundBufCkpt);
+		Assert(foundDescs && foundBufs && foundIO && foundBufCkpt);
 		/* note: this path is only taken in EXEC_BACKEND case */
 	}
 	else
@@ -134,8 +146,8 @@ InitBufferPool(void)
 			LWLockInitialize(BufferDescriptorGetContentLock(buf),
 							 LWTRANCHE_BUFFER_CONTENT);
 
-			LWLockInitialize(BufferDescriptorGetIOLock(buf),
-							 LWTRANCHE_BUFFER_IO_IN_PROGRESS);
+			ConditionVariableInit(BufferDescriptorGetIOCV(buf));
+			BufferDescriptorGetIO(buf)->aio = -1;
 		}
 
 		/* Correct last entry of linked list */
@@ -145,11 +157,112 @@ InitBufferPool(void)
 	/* Init other shared buffer-management stuff */
 	StrategyInitialize(!foundDescs);
 
+#ifdef USE_NUMA
+	if (!foundDescs && numa_placement != NUMA_PLACEMENT_OFF)
+		PlaceBufferPool();
+#endif
+
 	/* Initialize per-backend file flush context */
 	WritebackContextInit(&BackendWritebackContext,
 						 &backend_flush_after);
 }
 
+#ifdef USE_NUMA
+/*
+ * Place the buffer descriptors and buffer pages on NUMA nodes, as selected
+ * by the numa setting.
+ *
+ * This is done by the process that created shared memory, before any other
+ * process has attached to it.  The buffer pages haven't been touched yet, so
+ * they will be allocated on the right node when they are first used.  The
+ * buffer descriptors have just been initialized by us, so the kernel moves
+ * them.
+ */
+static void
+PlaceBufferPool(void)
+{
+	int			i;
+
+	if (pg_numa_num_nodes() <= 1)
+		return;
+
+	/*
+	 * If the buffer pool is too small to tie its partitions to nodes, fall
+	 * back to interleaving it.
+	 */
+	if (numa_placement == NUMA_PLACEMENT_INTERLEAVE ||
+		StrategyPartitionNode(0) < 0)
+	{
+		PlaceBufferRange(0, NBuffers, -1);
+		return;
+	}
+
+	/* Place each partition of the buffer pool on its node (see freelist.c) */
+	for (i = 0; i < StrategyNumPartitions(); i++)
+	{
+		int			first_buffer;
+		int			num_buffers;
+		int			node = StrategyPartitionNode(i);
+
+		if (node < 0)
+			continue;
+
+		StrategyPartitionRange(i, &first_buffer, &num_buffers);
+		if (!PlaceBufferRange(first_buffer, num_buffers, node))
+			break;
+	}
+}
+
+/*
+ * Place the descriptors and pages of a range of buffers on the given node,
+ * or interleave them over all nodes if node is -1.  Returns false, after
+ * emitting a warning, if that fails.
+ */
+static bool
+PlaceBufferRange(int first_buffer, int num_buffers, int node)
+{
+	return PlaceMemory((char *) GetBufferDescriptor(first_buffer),
+					   num_buffers * sizeof(BufferDescPadded), node) &&
+		PlaceMemory(BufferBlocks + first_buffer * (Size) BLCKSZ,
+					num_buffers * (Size) BLCKSZ, node);
+}
+
+/*
+ * Memory can only be placed in whole pages, so a page that straddles the
+ * boundary between two ranges is left to the operating system.
+ */
+static bool
+PlaceMemory(char *start, Size size, int node)
+{
+	char	   *end = start + size;
+	int			rc;
+
+	start = (char *) TYPEALIGN(UsedShmemPageSize, start);
+	end = (char *) TYPEALIGN_DOWN(UsedShmemPageSize, end);
+	if (end <= start)
+		return true;
+
+	if (node < 0)
+		rc = pg_numa_interleave(start, end - start);
+	else
+		rc = pg_numa_prefer(start, end - start, node);
+
+	if (rc != 0)
+	{
+		if (node < 0)
+			ereport(WARNING,
+					(errmsg("could not interleave shared buffers over NUMA nodes: %m")));
+		else
+			ereport(WARNING,
+					(errmsg("could not place shared buffers on NUMA node %d: %m",
+							pg_numa_node_id(node))));
+		return false;
+	}
+
+	return true;
+}
+#endif							/* USE_NUMA */
+
 /*
  * BufferShmemSize
  *
@@ -166,24 +279,22 @@ BufferShmemSize(void)
 	/* to allow aligning buffer descriptors */
 	size = add_size(size, PG_CACHE_LINE_SIZE);
 
-	/* size of data pages */
+	/* size of data pages, plus alignment padding */
+	size = add_size(size, PG_IO_ALIGN_SIZE);
 	size = add_size(size, mul_size(NBuffers, BLCKSZ));
 
 	/* size of stuff controlled by freelist.c */
 	size = add_size(size, StrategyShmemSize());
 
 	/*
-	 * It would be nice to include the I/O locks in the BufferDesc, but that
+	 * It would be nice to include the I/O state in the BufferDesc, but that
 	 * would increase the size of a BufferDesc to more than one cache line,
 	 * and benchmarking has shown that keeping every BufferDesc aligned on a
-	 * cache line boundary is important for performance.  So, instead, the
-	 * array of I/O locks is allocated in a separate tranche.  Because those
-	 * locks are not highly contended, we lay out the array with minimal
-	 * padding.
+	 * cache line boundary is important for performance.  So, instead, it is
+	 * kept in a separate array.  It is not highly contended, so we don't
+	 * bother padding it.
 	 */
-	size = add_size(size, mul_size(NBuffers, sizeof(LWLockMinimallyPadded)));
-	/* to allow aligning the above */
-	size = add_size(size, PG_CACHE_LINE_SIZE);
+	size = add_size(size, mul_size(NBuffers, sizeof(BufferIO)));
 
 	/* size of checkpoint sort array in bufmgr.c */
 	size = add_size(size, mul_size(NBuffers, sizeof(CkptSortItem)));
@@ -9,6 +9,36 @@
  * in most cases the caller needs to adjust the buffer header contents
  * before the lock is released (see notes in README).
  *
+ * The one exception is BufTableLookup(), which may also be called without
+ * any lock, to let the common case of finding a page in shared buffers
+ * proceed without touching the partition lock's cache line.  To make that
+ * possible, the table is a simple chained hash table whose links are only
+ * ever updated atomically, rather than a dynahash table:
+ *
+ * The bucket array is sized as a power of 2 that is at least
+ * NUM_BUFFER_PARTITIONS, and a tag's bucket is chosen by the low-order bits
+ * of its hash code, like its partition.  So each bucket belongs to exactly
+ * one partition, and its chain is only modified by backends holding that
+ * partition's lock exclusively.
+ *
+ * Instead of allocating entries from a freelist, every buffer has two
+ * entries of its own.  A buffer can be in the table under two tags at a
+ * time, while BufferAlloc() moves it from its old tag to its new one, but
+ * never more.  The entries of a buffer are only changed by a backend that
+ * holds the mapping lock of the buffer's current tag, if any, so that needs
+ * no separate locking either.
+ *
+ * An entry is filled in completely before it is linked into a chain, and
+ * unlinked by a single store into its predecessor.  A backend that reads
+ * the chain without holding the lock sees each link either before or after
+ * a concurrent change, so it always ends up at the end of some chain, though
+ * possibly a different one than it started in, if the entry it was looking
+ * at was unlinked and reused meanwhile.  It might therefore miss an entry
+ * that is present, or find an entry whose tag it read while it was being
+ * overwritten.  The caller has to treat the result accordingly: see
+ * BufferAlloc() for how a buffer found this way is verified after pinning
+ * it.
+ *
  *
  * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
  * Portions Copyright (c) 1994, Regents of the University of California
@@ -21,19 +51,48 @@
  */
 #include "postgres.h"
 
+#include "common/hashfn.h"
+#include "port/atomics.h"
+#include "port/pg_bitutils.h"
 #include "storage/buf_internals.h"
 #include "storage/bufmgr.h"
+#include "storage/shmem.h"
 
 /* entry for buffer lookup hashtable */
 typedef struct
 {
 	BufferTag	key;			/* Tag of a disk page */
-	int			id;				/* Associated buffer ID */
+	uint32		hashcode;		/* hash code of key */
+	pg_atomic_uint32 next;		/* next entry in chain, see below */
+	bool		in_use;			/* is the entry linked into a chain? */
 } BufferLookupEnt;
 
-static HTAB *SharedBufHash;
+/*
+ * Links between entries, and from buckets to entries, are entry indexes
+ * plus one, so that zero can mark the end of a chain.  Entries
+ * 2 * buf_id and 2 * buf_id + 1 belong to buffer buf_id.
+ */
+#define BUF_TABLE_END				0
+#define BufTableLinkToEnt(link)		(&SharedBufEntries[(link) - 1])
+#define BufTableLinkToBufId(link)	((int) ((link) - 1) / 2)
+
+static pg_atomic_uint32 *SharedBufBuckets;
+static uint32 SharedBufBucketMask;
+static BufferLookupEnt *SharedBufEntries;
 
 
+/*
+ * Number of buckets for a table of the given size: the next power of 2, but
+ * at least one bucket per partition.
+ */
+static uint32
+BufTableNumBuckets(int size)
+{
+	Assert(size > 0);
+
+	return Max(pg_nextpower2_32((uint32) size), NUM_BUFFER_PARTITIONS);
+}
+
 /*
  * Estimate space needed for mapping hashtable
  *		size is the desired hash table size (possibly more than NBuffers)
@@ -41,7 +100,13 @@ static HTAB *SharedBufHash;
 Size
 BufTableShmemSize(int size)
 {
-	return hash_estimate_size(size, sizeof(BufferLookupEnt));
+	Size		result;
+
+	result = mul_size(BufTableNumBuckets(size), sizeof(pg_atomic_uint32));
+	result = add_size(result,
+					  mul_size(mul_size(NBuffers, 2), sizeof(BufferLookupEnt)));
+
+	return result;
 }
 
 /*
@@ -51,19 +116,38 @@ BufTableShmemSize(int size)
 void
 InitBufTable(int size)
 {
-	HASHCTL		info;
+	uint32		nbuckets = BufTableNumBuckets(size);
+	bool		foundBuckets,
+				foundEntries;
 
 	/* assume no locking is needed yet */
 
-	/* BufferTag maps to Buffer */
-	info.keysize = sizeof(BufferTag);
-	info.entrysize = sizeof(BufferLookupEnt);
-	info.num_partitions = NUM_BUFFER_PARTITIONS;
+	SharedBufBuckets = (pg_atomic_uint32 *)
+		ShmemInitStruct("Shared Buffer Lookup Table",
+						mul_size(nbuckets, sizeof(pg_atomic_uint32)),
+						&foundBuckets);
+	SharedBufEntries = (BufferLookupEnt *)
+		ShmemInitStruct("Shared Buffer Lookup Entries",
+						mul_size(mul_size(NBuffers, 2),
+								 sizeof(BufferLookupEnt)),
+						&foundEntries);
+	SharedBufBucketMask = nbuckets - 1;
+
+	if (!foundBuckets)
+	{
+		uint32		i;
+
+		Assert(!foundEntries);
+
+		for (i = 0; i < nbuckets; i++)
+			pg_atomic_init_u32(&SharedBufBuckets[i], BUF_TABLE_END);
 
-	SharedBufHash = ShmemInitHash("Shared Buffer Lookup Table",
-								  size, size,
-								  &info,
-								  HASH_ELEM | HASH_BLOBS | HASH_PARTITION);
+		for (i = 0; i < NBuffers * 2; i++)
+		{
+			pg_atomic_init_u32(&SharedBufEntries[i].next, BUF_TABLE_END);
+			SharedBufEntries[i].in_use = false;
+		}
+	}
 }
 
 /*
@@ -78,31 +162,47 @@ InitBufTable(int size)
 uint32
 BufTableHashCode(BufferTag *tagPtr)
 {
-	return get_hash_value(SharedBufHash, (void *) tagPtr);
+	return tag_hash((void *) tagPtr, sizeof(BufferTag));
 }
 
 /*
  * BufTableLookup
  *		Lookup the given BufferTag; return buffer ID, or -1 if not found
  *
- * Caller must hold at least share lock on BufMappingLock for tag's partition
+ * Caller should hold at least share lock on BufMappingLock for tag's
+ * partition.  Without the lock, the result is only a hint: a buffer that
+ * is in the table might not be found, and the buffer returned might not
+ * contain the page, so it must be checked under the buffer's header lock or
+ * while holding a pin on it.
  */
 int
 BufTableLookup(BufferTag *tagPtr, uint32 hashcode)
 {
-	BufferLookupEnt *result;
+	uint32		link;
+	int			steps = 0;
+
+	link = pg_atomic_read_u32(&SharedBufBuckets[hashcode & SharedBufBucketMask]);
+	while (link != BUF_TABLE_END)
+	{
+		BufferLookupEnt *ent = BufTableLinkToEnt(link);
+
+		/* read the entry's contents only after the link to it */
+		pg_read_barrier();
+
+		if (ent->hashcode == hashcode && BUFFERTAGS_EQUAL(ent->key, *tagPtr))
+			return BufTableLinkToBufId(link);
 
-	result = (BufferLookupEnt *)
-		hash_search_with_hash_value(SharedBufHash,
-									(void *) tagPtr,
-									hashcode,
-									HASH_FIND,
-									NULL);
+		/*
+		 * A chain can't be longer than the number of entries.  This only
+		 * stops a lockless reader that keeps getting moved to another chain.
+		 */
+		if (++steps > NBuffers * 2)
+			break;
 
-	if (!result)
-		return -1;
+		link = pg_atomic_read_u32(&ent->next);
+	}
 
-	return result->id;
+	return -1;
 }
 
 /*
@@ -113,28 +213,41 @@ BufTableLookup(BufferTag *tagPtr, uint32 hashcode)
  * Returns -1 on successful insertion.  If a conflicting entry exists
  * already, returns the buffer ID in that entry.
  *
- * Caller must hold exclusive lock on BufMappingLock for tag's partition
+ * Caller must hold exclusive lock on BufMappingLock for tag's partition,
+ * and, if the buffer is in the table under another tag, on that tag's
+ * partition as well.
  */
 int
 BufTableInsert(BufferTag *tagPtr, uint32 hashcode, int buf_id)
 {
-	BufferLookupEnt *result;
-	bool		found;
+	pg_atomic_uint32 *bucket = &SharedBufBuckets[hashcode & SharedBufBucketMask];
+	BufferLookupEnt *ent;
+	uint32		link;
+	int			existing;
 
 	Assert(buf_id >= 0);		/* -1 is reserved for not-in-table */
 	Assert(tagPtr->blockNum != P_NEW);	/* invalid tag */
 
-	result = (BufferLookupEnt *)
-		hash_search_with_hash_value(SharedBufHash,
-									(void *) tagPtr,
-									hashcode,
-									HASH_ENTER,
-									&found);
+	existing = BufTableLookup(tagPtr, hashcode);
+	if (existing >= 0)			/* found something already in the table */
+		return existing;
+
+	/* use whichever of the buffer's entries is free */
+	link = buf_id * 2 + 1;
+	if (BufTableLinkToEnt(link)->in_use)
+		link++;
+	ent = BufTableLinkToEnt(link);
+	if (ent->in_use)			/* shouldn't happen */
+		elog(ERROR, "shared buffer hash table corrupted");
 
-	if (found)					/* found something already in the table */
-		return result->id;
+	ent->key = *tagPtr;
+	ent->hashcode = hashcode;
+	ent->in_use = true;
+	pg_atomic_write_u32(&ent->next, pg_atomic_read_u32(bucket));
 
-	result->id = buf_id;
+	/* make the entry's contents visible before the entry itself */
+	pg_write_barrier();
+	pg_atomic_write_u32(bucket, link);
 
 	return -1;
 }
@@ -148,15 +261,28 @@ BufTableInsert(BufferTag *tagPtr, uint32 hashcode, int buf_id)
 void
 BufTableDelete(BufferTag *tagPtr, uint32 hashcode)
 {
-	BufferLookupEnt *result;
+	pg_atomic_uint32 *prev = &SharedBufBuckets[hashcode & SharedBufBucketMask];
+	uint32		link;
 
-	result = (BufferLookupEnt *)
-		hash_search_with_hash_value(SharedBufHash,
-									(void *) tagPtr,
-									hashcode,
-									HASH_REMOVE,
-									NULL);
+	while ((link = pg_atomic_read_u32(prev)) != BUF_TABLE_END)
+	{
+		BufferLookupEnt *ent = BufTableLinkToEnt(link);
 
-	if (!result)				/* shouldn't happen */
-		elog(ERROR, "shared buffer hash table corrupted");
+		if (ent->hashcode == hashcode && BUFFERTAGS_EQUAL(ent->key, *tagPtr))
+		{
+			/*
+			 * Unlink the entry.  Lockless readers that are looking at it
+			 * right now still see its old link, so leave that alone until
+			 * the entry is reused.
+			 */
+			pg_atomic_write_u32(prev, pg_atomic_read_u32(&ent->next));
+			ent->in_use = false;
+			return;
+		}
+
+		prev = &ent->next;
+	}
+
+	/* shouldn't happen */
+	elog(ERROR, "shared buffer hash table corrupted");
 }
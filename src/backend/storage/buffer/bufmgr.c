@@ -43,12 +43,14 @@
 #include "pg_trace.h"
 #include "pgstat.h"
 #include "postmaster/bgwriter.h"
+#include "storage/aio.h"
 #include "storage/buf_internals.h"
 #include "storage/bufmgr.h"
 #include "storage/ipc.h"
 #include "storage/proc.h"
 #include "storage/smgr.h"
 #include "storage/standby.h"
+#include "utils/memutils.h"
 #include "utils/ps_status.h"
 #include "utils/rel.h"
 #include "utils/resowner_private.h"
@@ -106,6 +108,25 @@ typedef struct CkptTsStatus
 	int			index;
 } CkptTsStatus;
 
+/*
+ * State of the background writer's LRU scan of one partition of the buffer
+ * pool, saved between calls of BgBufferSync so we can determine the strategy
+ * point's advance rate and avoid scanning already-cleaned buffers.  Buffer
+ * positions are relative to the start of the partition.
+ */
+typedef struct BgBufferSyncState
+{
+	bool		saved_info_valid;
+	int			prev_strategy_buf_id;
+	uint32		prev_strategy_passes;
+	int			next_to_clean;
+	uint32		next_passes;
+
+	/* Moving averages of allocation rate and clean-buffer density */
+	float		smoothed_alloc;
+	float		smoothed_density;
+} BgBufferSyncState;
+
 /*
  * Type for array used to sort SMgrRelations
  *
@@ -140,6 +161,12 @@ int			effective_io_concurrency = 0;
  */
 int			maintenance_io_concurrency = 0;
 
+/*
+ * Maximum number of consecutive blocks StartReadBuffers() reads with a single
+ * I/O.
+ */
+int			io_combine_limit = DEFAULT_IO_COMBINE_LIMIT;
+
 /*
  * GUC variables about triggering kernel writeback for buffers written; OS
  * dependent defaults are set via the GUC mechanism.
@@ -148,10 +175,22 @@ int			checkpoint_flush_after = 0;
 int			bgwriter_flush_after = 0;
 int			backend_flush_after = 0;
 
-/* local state for StartBufferIO and related functions */
-static BufferDesc *InProgressBuf = NULL;
+/*
+ * local state for StartBufferIO and related functions.  We do I/O on more
+ * than one buffer at a time only while writing a run of buffers in
+ * SyncBufferRun().
+ */
+static BufferDesc *InProgressBufs[MAX_IO_COMBINE_LIMIT];
+static int	NumInProgressBufs = 0;
 static bool IsForInput;
 
+/* argument of shared_buffer_writev_error_callback */
+typedef struct BufferRunErrorArg
+{
+	BufferDesc *first;			/* buffer holding the first block */
+	int			nbufs;			/* number of blocks written */
+} BufferRunErrorArg;
+
 /* local state for LockBufferForCleanup */
 static BufferDesc *PinCountWaitBuf = NULL;
 
@@ -452,18 +491,33 @@ static Buffer ReadBuffer_common(SMgrRelation reln, char relpersistence,
 								ForkNumber forkNum, BlockNumber blockNum,
 								ReadBufferMode mode, BufferAccessStrategy strategy,
 								bool *hit);
+static void ReadBufferBlock(SMgrRelation smgr, ForkNumber forkNum,
+							BlockNumber blockNum, ReadBufferMode mode,
+							Block bufBlock, IOContext io_context);
+static bool PinBufferForRead(PendingBufferRead *read, Relation reln,
+							 SMgrRelation smgr, ForkNumber forkNum,
+							 BlockNumber blockNum,
+							 BufferAccessStrategy strategy,
+							 BufferDesc **bufHdr);
 static bool PinBuffer(BufferDesc *buf, BufferAccessStrategy strategy);
 static void PinBuffer_Locked(BufferDesc *buf);
 static void UnpinBuffer(BufferDesc *buf, bool fixOwner);
 static void BufferSync(int flags);
 static uint32 WaitBufHdrUnlocked(BufferDesc *buf);
+static bool BgBufferSyncPartition(BgBufferSyncState *state, int partition,
+								  int *num_written,
+								  WritebackContext *wb_context);
 static int	SyncOneBuffer(int buf_id, bool skip_recently_used,
 						  WritebackContext *wb_context);
+static int	SyncBufferRun(CkptSortItem *items, int nitems,
+						  WritebackContext *wb_context, int *num_written);
 static void WaitIO(BufferDesc *buf);
 static bool StartBufferIO(BufferDesc *buf, bool forInput);
 static void TerminateBufferIO(BufferDesc *buf, bool clear_dirty,
 							  uint32 set_flag_bits);
+static void ForgetBufferIO(BufferDesc *buf);
 static void shared_buffer_write_error_callback(void *arg);
+static void shared_buffer_writev_error_callback(void *arg);
 static void local_buffer_write_error_callback(void *arg);
 static BufferDesc *BufferAlloc(SMgrRelation smgr,
 							   char relpersistence,
@@ -471,7 +525,10 @@ static BufferDesc *BufferAlloc(SMgrRelation smgr,
 							   BlockNumber blockNum,
 							   BufferAccessStrategy strategy,
 							   bool *foundPtr);
-static void FlushBuffer(BufferDesc *buf, SMgrRelation reln);
+static void FlushBuffer(BufferDesc *buf, SMgrRelation reln,
+						IOContext io_context);
+static void FlushBufferRun(BufferDesc **bufs, int nbufs,
+						   IOContext io_context);
 static void AtProcExit_Buffers(int code, Datum arg);
 static void CheckForBufferLeaks(void);
 static int	rnode_comparator(const void *p1, const void *p2);
@@ -491,7 +548,6 @@ PrefetchSharedBuffer(SMgrRelation smgr_reln,
 	PrefetchBufferResult result = {InvalidBuffer, false};
 	BufferTag	newTag;			/* identity of requested block */
 	uint32		newHash;		/* hash value for newTag */
-	LWLock	   *newPartitionLock;	/* buffer partition lock for it */
 	int			buf_id;
 
 	Assert(BlockNumberIsValid(blockNum));
@@ -500,14 +556,14 @@ PrefetchSharedBuffer(SMgrRelation smgr_reln,
 	INIT_BUFFERTAG(newTag, smgr_reln->smgr_rnode.node,
 				   forkNum, blockNum);
 
-	/* determine its hash code and partition lock ID */
+	/* determine its hash code */
 	newHash = BufTableHashCode(&newTag);
-	newPartitionLock = BufMappingPartitionLock(newHash);
 
-	/* see if the block is in the buffer pool already */
-	LWLockAcquire(newPartitionLock, LW_SHARED);
+	/*
+	 * See if the block is in the buffer pool already.  The result is only a
+	 * hint anyway, so don't bother to take the mapping lock.
+	 */
 	buf_id = BufTableLookup(&newTag, newHash);
-	LWLockRelease(newPartitionLock);
 
 	/* If not in buffers, initiate prefetch */
 	if (buf_id < 0)
@@ -706,6 +762,494 @@ ReadBufferWithoutRelcache(RelFileNode rnode, ForkNumber forkNum,
 }
 
 
+/*
+ * StartReadBuffer -- start reading a buffer, without waiting for the read
+ *
+ * Like StartReadBuffers(), for a single block.
+ */
+bool
+StartReadBuffer(PendingBufferRead *read, Relation reln, ForkNumber forkNum,
+				BlockNumber blockNum, ReadBufferMode mode,
+				BufferAccessStrategy strategy)
+{
+	int			nblocks = 1;
+
+	return StartReadBuffers(read, &nblocks, reln, forkNum, blockNum, mode,
+							strategy);
+}
+
+/*
+ * StartReadBuffers -- start reading a run of consecutive blocks, without
+ *		waiting for the reads
+ *
+ * This is like calling ReadBufferExtended() for up to *nblocks blocks,
+ * starting at blockNum, except that blocks that aren't in the buffer pool
+ * are read asynchronously, and consecutive ones with a single I/O of at most
+ * io_combine_limit blocks.  Each block handled is pinned and described by the
+ * next element of "reads", but its contents must not be looked at until
+ * WaitReadBuffer() has been called for it.  The reads must be waited for in
+ * order, since an I/O covering several blocks is only waited for with the
+ * first of them.
+ *
+ * Not all of the blocks may be handled: a read stops before io_combine_limit
+ * is exceeded, where the storage manager can't continue it, and at the first
+ * block that is already in the buffer pool.  *nblocks is set to the number of
+ * blocks handled, which is at least one; the caller is expected to call again
+ * for the rest.  Returns true if a read was started, false if the blocks were
+ * found in the buffer pool (or had to be read synchronously).
+ *
+ * Only RBM_NORMAL and RBM_ZERO_ON_ERROR are supported.  Reads of temporary
+ * relations are always synchronous, one block at a time.
+ *
+ * The read may only be staged when this returns; see pgaio_io_stage().
+ * Callers starting several reads in a row should call pgaio_submit_staged()
+ * when done, and before doing anything that could wait for another backend.
+ */
+bool
+StartReadBuffers(PendingBufferRead *reads, int *nblocks, Relation reln,
+				 ForkNumber forkNum, BlockNumber blockNum,
+				 ReadBufferMode mode, BufferAccessStrategy strategy)
+{
+	SMgrRelation smgr;
+	BufferDesc *bufHdrs[MAX_IO_COMBINE_LIMIT];
+	char	   *buffers[MAX_IO_COMBINE_LIMIT];
+	PgAioHandle *ioh;
+	IOContext	io_context = IOContextForStrategy(strategy);
+	int			maxblocks = Min(*nblocks, io_combine_limit);
+	int			nio_blocks;
+	int			flags = 0;
+	int			i;
+
+	Assert(mode == RBM_NORMAL || mode == RBM_ZERO_ON_ERROR);
+	Assert(blockNum != P_NEW);
+	Assert(maxblocks >= 1);
+
+	/* Open it at the smgr level if not already done */
+	RelationOpenSmgr(reln);
+	smgr = reln->rd_smgr;
+
+	/* See ReadBufferExtended() */
+	if (RELATION_IS_OTHER_TEMP(reln))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("cannot access temporary tables of other sessions")));
+
+	*nblocks = 1;
+
+	if (SmgrIsTemp(smgr))
+	{
+		bool		hit;
+
+		reads[0].ioh = NULL;
+		reads[0].nblocks = 0;
+		reads[0].rnode = smgr->smgr_rnode;
+		reads[0].forknum = forkNum;
+		reads[0].blocknum = blockNum;
+		reads[0].strategy = strategy;
+
+		pgstat_count_buffer_read(reln);
+		reads[0].buffer = ReadBuffer_common(smgr,
+											reln->rd_rel->relpersistence,
+											forkNum, blockNum, mode,
+											strategy, &hit);
+		if (hit)
+			pgstat_count_buffer_hit(reln);
+		return false;
+	}
+
+	if (!PinBufferForRead(&reads[0], reln, smgr, forkNum, blockNum, strategy,
+						  &bufHdrs[0]))
+		return false;
+
+	/*
+	 * BufferAlloc() has set BM_IO_IN_PROGRESS for us.  If we've run out of
+	 * I/O handles, just read the block synchronously.
+	 */
+	ioh = pgaio_io_acquire_nb();
+	if (ioh == NULL)
+	{
+		ReadBufferBlock(smgr, forkNum, blockNum, mode,
+						BufHdrGetBlock(bufHdrs[0]), io_context);
+		TerminateBufferIO(bufHdrs[0], false, BM_VALID);
+
+		TRACE_POSTGRESQL_BUFFER_READ_DONE(forkNum, blockNum,
+										  smgr->smgr_rnode.node.spcNode,
+										  smgr->smgr_rnode.node.dbNode,
+										  smgr->smgr_rnode.node.relNode,
+										  smgr->smgr_rnode.backend,
+										  false,
+										  false);
+		return false;
+	}
+
+	if (mode == RBM_ZERO_ON_ERROR || zero_damaged_pages)
+		flags |= PGAIO_FLAG_ZERO_ON_ERROR;
+
+	/*
+	 * Hand over responsibility for finishing the I/O on the buffer to the
+	 * I/O handle.  From here on, SharedBufferReadComplete() will clear
+	 * BM_IO_IN_PROGRESS, even if we fail before the read is started.
+	 */
+	pgaio_io_set_callback(ioh, PGAIO_CB_SHARED_BUFFER_READ, flags);
+	pgaio_io_add_cb_data(ioh, bufHdrs[0]->buf_id);
+	ForgetBufferIO(bufHdrs[0]);
+	buffers[0] = (char *) BufHdrGetBlock(bufHdrs[0]);
+	nio_blocks = 1;
+
+	/*
+	 * Add the following blocks to the same I/O, as long as they have to be
+	 * read too.  A block found in the buffer pool ends the I/O, but since it
+	 * is pinned already, it is handled here anyway.
+	 *
+	 * Meanwhile, anyone needing one of the buffers handed to the I/O sleeps
+	 * until it completes, and BufferAlloc() might make us wait for a buffer
+	 * that another backend is reading.  That can't deadlock, because
+	 * everybody adds blocks to an I/O in ascending order.
+	 */
+	maxblocks = Min(maxblocks, smgrmaxcombine(smgr, forkNum, blockNum));
+	while (*nblocks < maxblocks)
+	{
+		i = (*nblocks)++;
+
+		if (!PinBufferForRead(&reads[i], reln, smgr, forkNum, blockNum + i,
+							  strategy, &bufHdrs[i]))
+			break;
+
+		pgaio_io_add_cb_data(ioh, bufHdrs[i]->buf_id);
+		ForgetBufferIO(bufHdrs[i]);
+		buffers[i] = (char *) BufHdrGetBlock(bufHdrs[i]);
+		nio_blocks++;
+	}
+
+	for (i = 0; i < nio_blocks; i++)
+	{
+		uint32		buf_state;
+
+		buf_state = LockBufHdr(bufHdrs[i]);
+		BufferDescriptorGetIO(bufHdrs[i])->aio = pgaio_io_get_id(ioh);
+		UnlockBufHdr(bufHdrs[i], buf_state);
+		pgstat_count_io_op(io_context, IOOP_READ);
+	}
+
+	reads[0].ioh = ioh;
+	reads[0].nblocks = nio_blocks;
+	smgrstartreadv(smgr, forkNum, blockNum, buffers, nio_blocks, ioh);
+
+	return true;
+}
+
+/*
+ * PinBufferForRead -- pin the buffer for one block of StartReadBuffers()
+ *
+ * Fills in "read" and sets *bufHdr.  Returns true if the block has to be
+ * read, in which case BufferAlloc() has set BM_IO_IN_PROGRESS; false if it
+ * was found in the buffer pool.
+ */
+static bool
+PinBufferForRead(PendingBufferRead *read, Relation reln, SMgrRelation smgr,
+				 ForkNumber forkNum, BlockNumber blockNum,
+				 BufferAccessStrategy strategy, BufferDesc **bufHdr)
+{
+	bool		found;
+
+	read->ioh = NULL;
+	read->nblocks = 0;
+	read->rnode = smgr->smgr_rnode;
+	read->forknum = forkNum;
+	read->blocknum = blockNum;
+	read->strategy = strategy;
+
+	pgstat_count_buffer_read(reln);
+
+	/* Make sure we will have room to remember the buffer pin */
+	ResourceOwnerEnlargeBuffers(CurrentResourceOwner);
+
+	TRACE_POSTGRESQL_BUFFER_READ_START(forkNum, blockNum,
+									   smgr->smgr_rnode.node.spcNode,
+									   smgr->smgr_rnode.node.dbNode,
+									   smgr->smgr_rnode.node.relNode,
+									   smgr->smgr_rnode.backend,
+									   false);
+
+	*bufHdr = BufferAlloc(smgr, reln->rd_rel->relpersistence, forkNum,
+						  blockNum, strategy, &found);
+	read->buffer = BufferDescriptorGetBuffer(*bufHdr);
+
+	if (found)
+	{
+		pgBufferUsage.shared_blks_hit++;
+		VacuumPageHit++;
+		if (VacuumCostActive)
+			VacuumCostBalance += VacuumCostPageHit;
+		pgstat_count_buffer_hit(reln);
+		pgstat_count_io_op(IOContextForStrategy(strategy), IOOP_HIT);
+
+		TRACE_POSTGRESQL_BUFFER_READ_DONE(forkNum, blockNum,
+										  smgr->smgr_rnode.node.spcNode,
+										  smgr->smgr_rnode.node.dbNode,
+										  smgr->smgr_rnode.node.relNode,
+										  smgr->smgr_rnode.backend,
+										  false,
+										  true);
+		return false;
+	}
+
+	pgBufferUsage.shared_blks_read++;
+	VacuumPageMiss++;
+	if (VacuumCostActive)
+		VacuumCostBalance += VacuumCostPageMiss;
+
+	return true;
+}
+
+/*
+ * WaitReadBuffer -- finish a read started by StartReadBuffers()
+ *
+ * Waits for the read, if one was started, and reports any error.  For an I/O
+ * covering several blocks, this waits for all of them, and reports errors in
+ * any of them.  Returns the pinned buffer, whose contents are now valid.
+ */
+Buffer
+WaitReadBuffer(PendingBufferRead *read)
+{
+	PgAioHandle *ioh = read->ioh;
+	PgAioResultStatus status[MAX_IO_COMBINE_LIMIT];
+	int			checksum_failures[MAX_IO_COMBINE_LIMIT];
+	int			buf_ids[MAX_IO_COMBINE_LIMIT];
+	int		   *cb_data;
+	int			nbuffers PG_USED_FOR_ASSERTS_ONLY;
+	int			result;
+	int			flags;
+	int			i;
+	instr_time	io_start,
+				io_time;
+
+	if (ioh == NULL)
+		return read->buffer;
+
+	if (track_io_timing)
+		INSTR_TIME_SET_CURRENT(io_start);
+
+	pgaio_io_wait(ioh);
+
+	if (track_io_timing)
+	{
+		INSTR_TIME_SET_CURRENT(io_time);
+		INSTR_TIME_SUBTRACT(io_time, io_start);
+		pgstat_count_buffer_read_time(INSTR_TIME_GET_MICROSEC(io_time));
+		pgstat_count_io_time(IOContextForStrategy(read->strategy), IOOP_READ,
+							 io_time);
+		INSTR_TIME_ADD(pgBufferUsage.blk_read_time, io_time);
+	}
+
+	nbuffers = pgaio_io_get_cb_data(ioh, &cb_data);
+	Assert(nbuffers == read->nblocks);
+	for (i = 0; i < read->nblocks; i++)
+	{
+		status[i] = pgaio_io_get_status(ioh, i, &checksum_failures[i]);
+		buf_ids[i] = cb_data[i];
+	}
+	result = pgaio_io_get_result(ioh);
+	flags = pgaio_io_get_flags(ioh);
+	pgaio_io_release(ioh);
+	read->ioh = NULL;
+
+	/* the completion callback couldn't report anything itself */
+	for (i = 0; i < read->nblocks; i++)
+	{
+		BlockNumber blocknum = read->blocknum + i;
+
+		if (checksum_failures[i] > 0)
+		{
+			ereport(WARNING,
+					(errcode(ERRCODE_DATA_CORRUPTED),
+					 errmsg("page verification failed in block %u of relation %s",
+							blocknum,
+							relpath(read->rnode, read->forknum))));
+			pgstat_report_checksum_failure();
+		}
+
+		switch (status[i])
+		{
+			case PGAIO_RS_OK:
+				break;
+			case PGAIO_RS_ZEROED:
+				ereport(WARNING,
+						(errcode(ERRCODE_DATA_CORRUPTED),
+						 errmsg("invalid page in block %u of relation %s; zeroing out page",
+								blocknum,
+								relpath(read->rnode, read->forknum))));
+				break;
+			case PGAIO_RS_SHORT_READ:
+				{
+					BufferDesc *bufHdr = GetBufferDescriptor(buf_ids[i]);
+
+					/*
+					 * The file ended, or the kernel returned less than we
+					 * asked for.  Read the block again synchronously, which
+					 * tells the two apart, and knows what to do at the end of
+					 * the file.  Someone else may have done so already.
+					 */
+					if (StartBufferIO(bufHdr, true))
+					{
+						ReadBufferBlock(smgropen(read->rnode.node,
+												 read->rnode.backend),
+										read->forknum, blocknum,
+										(flags & PGAIO_FLAG_ZERO_ON_ERROR) ?
+										RBM_ZERO_ON_ERROR : RBM_NORMAL,
+										BufHdrGetBlock(bufHdr),
+										IOContextForStrategy(read->strategy));
+						TerminateBufferIO(bufHdr, false, BM_VALID);
+					}
+				}
+				break;
+			case PGAIO_RS_INVALID_PAGE:
+				ereport(ERROR,
+						(errcode(ERRCODE_DATA_CORRUPTED),
+						 errmsg("invalid page in block %u of relation %s",
+								blocknum,
+								relpath(read->rnode, read->forknum))));
+				break;
+			case PGAIO_RS_ERROR:
+			case PGAIO_RS_UNKNOWN:
+				errno = -result;
+				ereport(ERROR,
+						(errcode_for_file_access(),
+						 errmsg("could not read block %u of relation %s: %m",
+								blocknum,
+								relpath(read->rnode, read->forknum))));
+				break;
+		}
+
+		TRACE_POSTGRESQL_BUFFER_READ_DONE(read->forknum, blocknum,
+										  read->rnode.node.spcNode,
+										  read->rnode.node.dbNode,
+										  read->rnode.node.relNode,
+										  read->rnode.backend,
+										  false,
+										  false);
+	}
+
+	return read->buffer;
+}
+
+/*
+ * SharedBufferReadComplete -- completion callback for reads started by
+ *		StartReadBuffers()
+ *
+ * This runs in whichever process notices that the read has finished, so it
+ * must not throw errors or log anything.  It verifies each page, marks the
+ * buffers valid or failed, and wakes up anyone waiting for them; problems
+ * are reported by WaitReadBuffer() in the backend that started the read.
+ */
+void
+SharedBufferReadComplete(PgAioHandle *ioh)
+{
+	int		   *buf_ids;
+	int			nbuffers = pgaio_io_get_cb_data(ioh, &buf_ids);
+	int			result = pgaio_io_get_result(ioh);
+	int			flags = pgaio_io_get_flags(ioh);
+	int			i;
+
+	for (i = 0; i < nbuffers; i++)
+	{
+		BufferDesc *bufHdr = GetBufferDescriptor(buf_ids[i]);
+		Block		bufBlock = BufHdrGetBlock(bufHdr);
+		PgAioResultStatus status;
+		bool		checksum_failure = false;
+		uint32		buf_state;
+
+		if (result < 0)
+			status = PGAIO_RS_ERROR;
+		else if (result < (i + 1) * BLCKSZ)
+		{
+			/* WaitReadBuffer() reads the block again synchronously */
+			status = PGAIO_RS_SHORT_READ;
+		}
+		else if (!PageIsVerifiedExtended((Page) bufBlock,
+										 bufHdr->tag.blockNum,
+										 0, &checksum_failure))
+		{
+			if (flags & PGAIO_FLAG_ZERO_ON_ERROR)
+			{
+				MemSet((char *) bufBlock, 0, BLCKSZ);
+				status = PGAIO_RS_ZEROED;
+			}
+			else
+				status = PGAIO_RS_INVALID_PAGE;
+		}
+		else
+			status = PGAIO_RS_OK;
+
+		pgaio_io_set_status(ioh, i, status, checksum_failure ? 1 : 0);
+
+		/* like TerminateBufferIO(), but on behalf of the issuing backend */
+		buf_state = LockBufHdr(bufHdr);
+		Assert(buf_state & BM_IO_IN_PROGRESS);
+		buf_state &= ~(BM_IO_IN_PROGRESS | BM_IO_ERROR);
+		if (status == PGAIO_RS_OK || status == PGAIO_RS_ZEROED)
+			buf_state |= BM_VALID;
+		else
+			buf_state |= BM_IO_ERROR;
+		BufferDescriptorGetIO(bufHdr)->aio = -1;
+		UnlockBufHdr(bufHdr, buf_state);
+
+		ConditionVariableBroadcast(BufferDescriptorGetIOCV(bufHdr));
+	}
+}
+
+/*
+ * ReadBufferBlock -- synchronously read a block into a buffer and verify it
+ *
+ * Reads into shared buffers are counted in pg_stat_io under io_context.
+ */
+static void
+ReadBufferBlock(SMgrRelation smgr, ForkNumber forkNum, BlockNumber blockNum,
+				ReadBufferMode mode, Block bufBlock, IOContext io_context)
+{
+	bool		isLocalBuf = SmgrIsTemp(smgr);
+	instr_time	io_start,
+				io_time;
+
+	if (track_io_timing)
+		INSTR_TIME_SET_CURRENT(io_start);
+
+	smgrread(smgr, forkNum, blockNum, (char *) bufBlock);
+
+	if (!isLocalBuf)
+		pgstat_count_io_op(io_context, IOOP_READ);
+
+	if (track_io_timing)
+	{
+		INSTR_TIME_SET_CURRENT(io_time);
+		INSTR_TIME_SUBTRACT(io_time, io_start);
+		pgstat_count_buffer_read_time(INSTR_TIME_GET_MICROSEC(io_time));
+		if (!isLocalBuf)
+			pgstat_count_io_time(io_context, IOOP_READ, io_time);
+		INSTR_TIME_ADD(pgBufferUsage.blk_read_time, io_time);
+	}
+
+	/* check for garbage data */
+	if (!PageIsVerified((Page) bufBlock, blockNum))
+	{
+		if (mode == RBM_ZERO_ON_ERROR || zero_damaged_pages)
+		{
+			ereport(WARNING,
+					(errcode(ERRCODE_DATA_CORRUPTED),
+					 errmsg("invalid page in block %u of relation %s; zeroing out page",
+							blockNum,
+							relpath(smgr->smgr_rnode, forkNum))));
+			MemSet((char *) bufBlock, 0, BLCKSZ);
+		}
+		else
+			ereport(ERROR,
+					(errcode(ERRCODE_DATA_CORRUPTED),
+					 errmsg("invalid page in block %u of relation %s",
+							blockNum,
+							relpath(smgr->smgr_rnode, forkNum))));
+	}
+}
+
 /*
  * ReadBuffer_common -- common logic for all ReadBuffer variants
  *
@@ -721,6 +1265,7 @@ ReadBuffer_common(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 	bool		found;
 	bool		isExtend;
 	bool		isLocalBuf = SmgrIsTemp(smgr);
+	IOContext	io_context = IOContextForStrategy(strategy);
 
 	*hit = false;
 
@@ -778,6 +1323,8 @@ ReadBuffer_common(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 			/* Just need to update stats before we exit */
 			*hit = true;
 			VacuumPageHit++;
+			if (!isLocalBuf)
+				pgstat_count_io_op(io_context, IOOP_HIT);
 
 			if (VacuumCostActive)
 				VacuumCostBalance += VacuumCostPageHit;
@@ -877,11 +1424,29 @@ ReadBuffer_common(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 
 	if (isExtend)
 	{
+		instr_time	io_start,
+					io_time;
+
 		/* new buffers are zero-filled */
 		MemSet((char *) bufBlock, 0, BLCKSZ);
+
+		if (track_io_timing)
+			INSTR_TIME_SET_CURRENT(io_start);
+
 		/* don't set checksum for all-zero page */
 		smgrextend(smgr, forkNum, blockNum, (char *) bufBlock, false);
 
+		if (!isLocalBuf)
+		{
+			pgstat_count_io_op(io_context, IOOP_EXTEND);
+			if (track_io_timing)
+			{
+				INSTR_TIME_SET_CURRENT(io_time);
+				INSTR_TIME_SUBTRACT(io_time, io_start);
+				pgstat_count_io_time(io_context, IOOP_EXTEND, io_time);
+			}
+		}
+
 		/*
 		 * NB: we're *not* doing a ScheduleBufferTagForWriteback here;
 		 * although we're essentially performing a write. At least on linux
@@ -898,43 +1463,8 @@ ReadBuffer_common(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 		if (mode == RBM_ZERO_AND_LOCK || mode == RBM_ZERO_AND_CLEANUP_LOCK)
 			MemSet((char *) bufBlock, 0, BLCKSZ);
 		else
-		{
-			instr_time	io_start,
-						io_time;
-
-			if (track_io_timing)
-				INSTR_TIME_SET_CURRENT(io_start);
-
-			smgrread(smgr, forkNum, blockNum, (char *) bufBlock);
-
-			if (track_io_timing)
-			{
-				INSTR_TIME_SET_CURRENT(io_time);
-				INSTR_TIME_SUBTRACT(io_time, io_start);
-				pgstat_count_buffer_read_time(INSTR_TIME_GET_MICROSEC(io_time));
-				INSTR_TIME_ADD(pgBufferUsage.blk_read_time, io_time);
-			}
-
-			/* check for garbage data */
-			if (!PageIsVerified((Page) bufBlock, blockNum))
-			{
-				if (mode == RBM_ZERO_ON_ERROR || zero_damaged_pages)
-				{
-					ereport(WARNING,
-							(errcode(ERRCODE_DATA_CORRUPTED),
-							 errmsg("invalid page in block %u of relation %s; zeroing out page",
-									blockNum,
-									relpath(smgr->smgr_rnode, forkNum))));
-					MemSet((char *) bufBlock, 0, BLCKSZ);
-				}
-				else
-					ereport(ERROR,
-							(errcode(ERRCODE_DATA_CORRUPTED),
-							 errmsg("invalid page in block %u of relation %s",
-									blockNum,
-									relpath(smgr->smgr_rnode, forkNum))));
-			}
-		}
+			ReadBufferBlock(smgr, forkNum, blockNum, mode, bufBlock,
+							io_context);
 	}
 
 	/*
@@ -982,6 +1512,21 @@ ReadBuffer_common(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 	return BufferDescriptorGetBuffer(bufHdr);
 }
 
+/*
+ * BufferTagIsCurrent -- does a pinned buffer hold the given page?
+ *
+ * A buffer can't be assigned to another page while we hold a pin on it, so
+ * no lock is needed to read its tag.  PinBuffer() is a memory barrier, so we
+ * see any change made before our pin took effect.
+ */
+static inline bool
+BufferTagIsCurrent(BufferDesc *buf, BufferTag *tag)
+{
+	uint32		buf_state = pg_atomic_read_u32(&buf->state);
+
+	return (buf_state & BM_TAG_VALID) && BUFFERTAGS_EQUAL(buf->tag, *tag);
+}
+
 /*
  * BufferAlloc -- subroutine for ReadBuffer.  Handles lookup of a shared
  *		buffer.  If no buffer exists already, selects a replacement
@@ -1017,6 +1562,7 @@ BufferAlloc(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 	int			buf_id;
 	BufferDesc *buf;
 	bool		valid;
+	bool		from_ring;
 	uint32		buf_state;
 
 	/* create a tag so we can lookup the buffer */
@@ -1026,23 +1572,52 @@ BufferAlloc(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 	newHash = BufTableHashCode(&newTag);
 	newPartitionLock = BufMappingPartitionLock(newHash);
 
-	/* see if the block is in the buffer pool already */
-	LWLockAcquire(newPartitionLock, LW_SHARED);
+	/*
+	 * See if the block is in the buffer pool already.  First try without the
+	 * mapping lock.  If that finds a buffer, pin it so no one can steal it
+	 * from the buffer pool, and then check that it still holds our page: it
+	 * might have been recycled for another page before we pinned it, and
+	 * once pinned, it can't be.
+	 */
 	buf_id = BufTableLookup(&newTag, newHash);
 	if (buf_id >= 0)
 	{
-		/*
-		 * Found it.  Now, pin the buffer so no one can steal it from the
-		 * buffer pool, and check to see if the correct data has been loaded
-		 * into the buffer.
-		 */
 		buf = GetBufferDescriptor(buf_id);
 
 		valid = PinBuffer(buf, strategy);
 
+		if (!BufferTagIsCurrent(buf, &newTag))
+		{
+			UnpinBuffer(buf, true);
+			buf_id = -1;
+		}
+	}
+
+	/*
+	 * If that didn't work out, look again with the mapping lock held, which
+	 * gives a definitive answer.
+	 */
+	if (buf_id < 0)
+	{
+		LWLockAcquire(newPartitionLock, LW_SHARED);
+		buf_id = BufTableLookup(&newTag, newHash);
+		if (buf_id >= 0)
+		{
+			buf = GetBufferDescriptor(buf_id);
+
+			valid = PinBuffer(buf, strategy);
+		}
+
 		/* Can release the mapping lock as soon as we've pinned it */
 		LWLockRelease(newPartitionLock);
+	}
 
+	if (buf_id >= 0)
+	{
+		/*
+		 * Found it.  Now check to see if the correct data has been loaded
+		 * into the buffer.
+		 */
 		*foundPtr = true;
 
 		if (!valid)
@@ -1069,9 +1644,8 @@ BufferAlloc(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 
 	/*
 	 * Didn't find it in the buffer pool.  We'll have to initialize a new
-	 * buffer.  Remember to unlock the mapping lock while doing the work.
+	 * buffer.
 	 */
-	LWLockRelease(newPartitionLock);
 
 	/* Loop here in case we have to try another victim buffer */
 	for (;;)
@@ -1086,7 +1660,7 @@ BufferAlloc(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 		 * Select a victim buffer.  The buffer is returned with its header
 		 * spinlock still held!
 		 */
-		buf = StrategyGetBuffer(strategy, &buf_state);
+		buf = StrategyGetBuffer(strategy, &buf_state, &from_ring);
 
 		Assert(BUF_STATE_GET_REFCOUNT(buf_state) == 0);
 
@@ -1155,7 +1729,7 @@ BufferAlloc(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 														  smgr->smgr_rnode.node.dbNode,
 														  smgr->smgr_rnode.node.relNode);
 
-				FlushBuffer(buf, NULL);
+				FlushBuffer(buf, NULL, IOContextForStrategy(strategy));
 				LWLockRelease(BufferDescriptorGetContentLock(buf));
 
 				ScheduleBufferTagForWriteback(&BackendWritebackContext,
@@ -1336,6 +1910,15 @@ BufferAlloc(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 
 	LWLockRelease(newPartitionLock);
 
+	/*
+	 * If the buffer held another block, count that we threw it out.  Taking
+	 * a buffer back from the strategy's ring doesn't put any pressure on the
+	 * rest of shared buffers, so that is counted separately.
+	 */
+	if (oldPartitionLock != NULL)
+		pgstat_count_io_op(IOContextForStrategy(strategy),
+						   from_ring ? IOOP_REUSE : IOOP_EVICT);
+
 	/*
 	 * Buffer contents are currently invalid.  Try to get the io_in_progress
 	 * lock.  If StartBufferIO returns false, then someone else managed to
@@ -1730,7 +2313,6 @@ UnpinBuffer(BufferDesc *buf, bool fixOwner)
 
 		/* I'd better not still hold any locks on the buffer */
 		Assert(!LWLockHeldByMe(BufferDescriptorGetContentLock(buf)));
-		Assert(!LWLockHeldByMe(BufferDescriptorGetIOLock(buf)));
 
 		/*
 		 * Decrement the shared reference count.
@@ -1801,6 +2383,7 @@ BufferSync(int flags)
 	int			num_spaces;
 	int			num_processed;
 	int			num_written;
+	int			nitems;
 	CkptTsStatus *per_ts_stat = NULL;
 	Oid			last_tsid;
 	binaryheap *ts_heap;
@@ -1808,9 +2391,6 @@ BufferSync(int flags)
 	int			mask = BM_DIRTY;
 	WritebackContext wb_context;
 
-	/* Make sure we can handle the pin inside SyncOneBuffer */
-	ResourceOwnerEnlargeBuffers(CurrentResourceOwner);
-
 	/*
 	 * Unless this is a shutdown checkpoint or we have been explicitly told,
 	 * we write only permanent, dirty buffers.  But at shutdown or end of
@@ -1991,37 +2571,45 @@ BufferSync(int flags)
 
 		bufHdr = GetBufferDescriptor(buf_id);
 
-		num_processed++;
-
 		/*
 		 * We don't need to acquire the lock here, because we're only looking
 		 * at a single bit. It's possible that someone else writes the buffer
 		 * and clears the flag right after we check, but that doesn't matter
-		 * since SyncOneBuffer will then do nothing.  However, there is a
+		 * since SyncBufferRun will then do nothing.  However, there is a
 		 * further race condition: it's conceivable that between the time we
-		 * examine the bit here and the time SyncOneBuffer acquires the lock,
+		 * examine the bit here and the time SyncBufferRun acquires the lock,
 		 * someone else not only wrote the buffer but replaced it with another
-		 * page and dirtied it.  In that improbable case, SyncOneBuffer will
+		 * page and dirtied it.  In that improbable case, SyncBufferRun will
 		 * write the buffer though we didn't need to.  It doesn't seem worth
 		 * guarding against this, though.
+		 *
+		 * The buffers following this one in the tablespace's part of the
+		 * array are written along with it, if they hold the next blocks of
+		 * the same relation fork, up to io_combine_limit of them.
 		 */
 		if (pg_atomic_read_u32(&bufHdr->state) & BM_CHECKPOINT_NEEDED)
 		{
-			if (SyncOneBuffer(buf_id, false, &wb_context) & BUF_WRITTEN)
-			{
-				TRACE_POSTGRESQL_BUFFER_SYNC_WRITTEN(buf_id);
-				BgWriterStats.m_buf_written_checkpoints++;
-				num_written++;
-			}
+			int			buf_written;
+
+			nitems = SyncBufferRun(&CkptBufferIds[ts_stat->index],
+								   Min(ts_stat->num_to_scan - ts_stat->num_scanned,
+									   io_combine_limit),
+								   &wb_context, &buf_written);
+			BgWriterStats.m_buf_written_checkpoints += buf_written;
+			num_written += buf_written;
 		}
+		else
+			nitems = 1;
+
+		num_processed += nitems;
 
 		/*
 		 * Measure progress independent of actually having to flush the buffer
 		 * - otherwise writing become unbalanced.
 		 */
-		ts_stat->progress += ts_stat->progress_slice;
-		ts_stat->num_scanned++;
-		ts_stat->index++;
+		ts_stat->progress += ts_stat->progress_slice * nitems;
+		ts_stat->num_scanned += nitems;
+		ts_stat->index += nitems;
 
 		/* Have all the buffers from the tablespace been processed? */
 		if (ts_stat->num_scanned == ts_stat->num_to_scan)
@@ -2063,34 +2651,81 @@ BufferSync(int flags)
  *
  * This is called periodically by the background writer process.
  *
+ * Each partition of the buffer pool has a clock sweep of its own (see
+ * freelist.c), so we run the LRU scan once per partition.  The partitions
+ * share the bgwriter_lru_maxpages budget; the partition scanned first is
+ * rotated on every call, so that none of them is starved when the budget is
+ * used up.
+ *
  * Returns true if it's appropriate for the bgwriter process to go into
  * low-power hibernation mode.  (This happens if the strategy clock sweep
- * has been "lapped" and no buffer allocations have occurred recently,
- * or if the bgwriter has been effectively disabled by setting
- * bgwriter_lru_maxpages to 0.)
+ * of every partition has been "lapped" and no buffer allocations have
+ * occurred recently, or if the bgwriter has been effectively disabled by
+ * setting bgwriter_lru_maxpages to 0.)
  */
 bool
 BgBufferSync(WritebackContext *wb_context)
 {
+	static BgBufferSyncState *partition_state = NULL;
+	static int	first_partition = 0;
+	int			num_partitions = StrategyNumPartitions();
+	int			num_written = 0;
+	bool		hibernate = true;
+	int			i;
+
+	if (partition_state == NULL)
+	{
+		partition_state = (BgBufferSyncState *)
+			MemoryContextAlloc(TopMemoryContext,
+							   num_partitions * sizeof(BgBufferSyncState));
+		for (i = 0; i < num_partitions; i++)
+		{
+			partition_state[i].saved_info_valid = false;
+			partition_state[i].smoothed_alloc = 0;
+			partition_state[i].smoothed_density = 10.0;
+		}
+	}
+
+	/* Make sure we can handle the pin inside SyncOneBuffer */
+	ResourceOwnerEnlargeBuffers(CurrentResourceOwner);
+
+	for (i = 0; i < num_partitions; i++)
+	{
+		int			partition = (first_partition + i) % num_partitions;
+
+		if (!BgBufferSyncPartition(&partition_state[partition], partition,
+								   &num_written, wb_context))
+			hibernate = false;
+	}
+	first_partition = (first_partition + 1) % num_partitions;
+
+	BgWriterStats.m_buf_written_clean += num_written;
+
+	return hibernate;
+}
+
+/*
+ * BgBufferSyncPartition -- LRU scan of one partition of the buffer pool.
+ *
+ * *num_written is the number of buffers written by this BgBufferSync cycle
+ * so far, and is advanced by the number of buffers we write.
+ *
+ * Returns true if it's OK to hibernate as far as this partition is
+ * concerned.
+ */
+static bool
+BgBufferSyncPartition(BgBufferSyncState *state, int partition,
+					  int *num_written, WritebackContext *wb_context)
+{
+	/* range of buffers in the partition */
+	int			first_buffer;
+	int			num_buffers;
+
 	/* info obtained from freelist.c */
 	int			strategy_buf_id;
 	uint32		strategy_passes;
 	uint32		recent_alloc;
 
-	/*
-	 * Information saved between calls so we can determine the strategy
-	 * point's advance rate and avoid scanning already-cleaned buffers.
-	 */
-	static bool saved_info_valid = false;
-	static int	prev_strategy_buf_id;
-	static uint32 prev_strategy_passes;
-	static int	next_to_clean;
-	static uint32 next_passes;
-
-	/* Moving averages of allocation rate and clean-buffer density */
-	static float smoothed_alloc = 0;
-	static float smoothed_density = 10.0;
-
 	/* Potentially these could be tunables, but for now, not */
 	float		smoothing_samples = 16;
 	float		scan_whole_pool_milliseconds = 120000.0;
@@ -2106,18 +2741,20 @@ BgBufferSync(WritebackContext *wb_context)
 
 	/* Variables for the scanning loop proper */
 	int			num_to_scan;
-	int			num_written;
 	int			reusable_buffers;
 
 	/* Variables for final smoothed_density update */
 	long		new_strategy_delta;
 	uint32		new_recent_alloc;
 
+	StrategyPartitionRange(partition, &first_buffer, &num_buffers);
+
 	/*
-	 * Find out where the freelist clock sweep currently is, and how many
+	 * Find out where the partition's clock sweep currently is, and how many
 	 * buffer allocations have happened since our last call.
 	 */
-	strategy_buf_id = StrategySyncStart(&strategy_passes, &recent_alloc);
+	strategy_buf_id = StrategySyncStart(partition, &strategy_passes,
+										&recent_alloc) - first_buffer;
 
 	/* Report buffer alloc counts to pgstat */
 	BgWriterStats.m_buf_alloc += recent_alloc;
@@ -2129,7 +2766,7 @@ BgBufferSync(WritebackContext *wb_context)
 	 */
 	if (bgwriter_lru_maxpages <= 0)
 	{
-		saved_info_valid = false;
+		state->saved_info_valid = false;
 		return true;
 	}
 
@@ -2141,34 +2778,35 @@ BgBufferSync(WritebackContext *wb_context)
 	 * weird-looking coding of xxx_passes comparisons are to avoid bogus
 	 * behavior when the passes counts wrap around.
 	 */
-	if (saved_info_valid)
+	if (state->saved_info_valid)
 	{
-		int32		passes_delta = strategy_passes - prev_strategy_passes;
+		int32		passes_delta = strategy_passes - state->prev_strategy_passes;
 
-		strategy_delta = strategy_buf_id - prev_strategy_buf_id;
-		strategy_delta += (long) passes_delta * NBuffers;
+		strategy_delta = strategy_buf_id - state->prev_strategy_buf_id;
+		strategy_delta += (long) passes_delta * num_buffers;
 
 		Assert(strategy_delta >= 0);
 
-		if ((int32) (next_passes - strategy_passes) > 0)
+		if ((int32) (state->next_passes - strategy_passes) > 0)
 		{
 			/* we're one pass ahead of the strategy point */
-			bufs_to_lap = strategy_buf_id - next_to_clean;
+			bufs_to_lap = strategy_buf_id - state->next_to_clean;
 #ifdef BGW_DEBUG
 			elog(DEBUG2, "bgwriter ahead: bgw %u-%u strategy %u-%u delta=%ld lap=%d",
-				 next_passes, next_to_clean,
+				 state->next_passes, state->next_to_clean,
 				 strategy_passes, strategy_buf_id,
 				 strategy_delta, bufs_to_lap);
 #endif
 		}
-		else if (next_passes == strategy_passes &&
-				 next_to_clean >= strategy_buf_id)
+		else if (state->next_passes == strategy_passes &&
+				 state->next_to_clean >= strategy_buf_id)
 		{
 			/* on same pass, but ahead or at least not behind */
-			bufs_to_lap = NBuffers - (next_to_clean - strategy_buf_id);
+			bufs_to_lap = num_buffers -
+				(state->next_to_clean - strategy_buf_id);
 #ifdef BGW_DEBUG
 			elog(DEBUG2, "bgwriter ahead: bgw %u-%u strategy %u-%u delta=%ld lap=%d",
-				 next_passes, next_to_clean,
+				 state->next_passes, state->next_to_clean,
 				 strategy_passes, strategy_buf_id,
 				 strategy_delta, bufs_to_lap);
 #endif
@@ -2181,13 +2819,13 @@ BgBufferSync(WritebackContext *wb_context)
 			 */
 #ifdef BGW_DEBUG
 			elog(DEBUG2, "bgwriter behind: bgw %u-%u strategy %u-%u delta=%ld",
-				 next_passes, next_to_clean,
+				 state->next_passes, state->next_to_clean,
 				 strategy_passes, strategy_buf_id,
 				 strategy_delta);
 #endif
-			next_to_clean = strategy_buf_id;
-			next_passes = strategy_passes;
-			bufs_to_lap = NBuffers;
+			state->next_to_clean = strategy_buf_id;
+			state->next_passes = strategy_passes;
+			bufs_to_lap = num_buffers;
 		}
 	}
 	else
@@ -2201,15 +2839,15 @@ BgBufferSync(WritebackContext *wb_context)
 			 strategy_passes, strategy_buf_id);
 #endif
 		strategy_delta = 0;
-		next_to_clean = strategy_buf_id;
-		next_passes = strategy_passes;
-		bufs_to_lap = NBuffers;
+		state->next_to_clean = strategy_buf_id;
+		state->next_passes = strategy_passes;
+		bufs_to_lap = num_buffers;
 	}
 
 	/* Update saved info for next time */
-	prev_strategy_buf_id = strategy_buf_id;
-	prev_strategy_passes = strategy_passes;
-	saved_info_valid = true;
+	state->prev_strategy_buf_id = strategy_buf_id;
+	state->prev_strategy_passes = strategy_passes;
+	state->saved_info_valid = true;
 
 	/*
 	 * Compute how many buffers had to be scanned for each new allocation, ie,
@@ -2220,8 +2858,8 @@ BgBufferSync(WritebackContext *wb_context)
 	if (strategy_delta > 0 && recent_alloc > 0)
 	{
 		scans_per_alloc = (float) strategy_delta / (float) recent_alloc;
-		smoothed_density += (scans_per_alloc - smoothed_density) /
-			smoothing_samples;
+		state->smoothed_density +=
+			(scans_per_alloc - state->smoothed_density) / smoothing_samples;
 	}
 
 	/*
@@ -2229,22 +2867,23 @@ BgBufferSync(WritebackContext *wb_context)
 	 * strategy point and where we've scanned ahead to, based on the smoothed
 	 * density estimate.
 	 */
-	bufs_ahead = NBuffers - bufs_to_lap;
-	reusable_buffers_est = (float) bufs_ahead / smoothed_density;
+	bufs_ahead = num_buffers - bufs_to_lap;
+	reusable_buffers_est = (float) bufs_ahead / state->smoothed_density;
 
 	/*
 	 * Track a moving average of recent buffer allocations.  Here, rather than
 	 * a true average we want a fast-attack, slow-decline behavior: we
 	 * immediately follow any increase.
 	 */
-	if (smoothed_alloc <= (float) recent_alloc)
-		smoothed_alloc = recent_alloc;
+	if (state->smoothed_alloc <= (float) recent_alloc)
+		state->smoothed_alloc = recent_alloc;
 	else
-		smoothed_alloc += ((float) recent_alloc - smoothed_alloc) /
-			smoothing_samples;
+		state->smoothed_alloc +=
+			((float) recent_alloc - state->smoothed_alloc) / smoothing_samples;
 
 	/* Scale the estimate by a GUC to allow more aggressive tuning. */
-	upcoming_alloc_est = (int) (smoothed_alloc * bgwriter_lru_multiplier);
+	upcoming_alloc_est = (int) (state->smoothed_alloc *
+								bgwriter_lru_multiplier);
 
 	/*
 	 * If recent_alloc remains at zero for many cycles, smoothed_alloc will
@@ -2255,7 +2894,7 @@ BgBufferSync(WritebackContext *wb_context)
 	 * syndrome.  It will pop back up as soon as recent_alloc increases.
 	 */
 	if (upcoming_alloc_est == 0)
-		smoothed_alloc = 0;
+		state->smoothed_alloc = 0;
 
 	/*
 	 * Even in cases where there's been little or no buffer allocation
@@ -2267,7 +2906,7 @@ BgBufferSync(WritebackContext *wb_context)
 	 * the BGW will be called during the scan_whole_pool time; slice the
 	 * buffer pool into that many sections.
 	 */
-	min_scan_buffers = (int) (NBuffers / (scan_whole_pool_milliseconds / BgWriterDelay));
+	min_scan_buffers = (int) (num_buffers / (scan_whole_pool_milliseconds / BgWriterDelay));
 
 	if (upcoming_alloc_est < (min_scan_buffers + reusable_buffers_est))
 	{
@@ -2285,30 +2924,29 @@ BgBufferSync(WritebackContext *wb_context)
 	 * requirements, or hit the bgwriter_lru_maxpages limit.
 	 */
 
-	/* Make sure we can handle the pin inside SyncOneBuffer */
-	ResourceOwnerEnlargeBuffers(CurrentResourceOwner);
-
 	num_to_scan = bufs_to_lap;
-	num_written = 0;
 	reusable_buffers = reusable_buffers_est;
 
 	/* Execute the LRU scan */
-	while (num_to_scan > 0 && reusable_buffers < upcoming_alloc_est)
+	while (num_to_scan > 0 && reusable_buffers < upcoming_alloc_est &&
+		   *num_written < bgwriter_lru_maxpages)
 	{
-		int			sync_state = SyncOneBuffer(next_to_clean, true,
-											   wb_context);
+		int			sync_state;
 
-		if (++next_to_clean >= NBuffers)
+		sync_state = SyncOneBuffer(first_buffer + state->next_to_clean, true,
+								   wb_context);
+
+		if (++state->next_to_clean >= num_buffers)
 		{
-			next_to_clean = 0;
-			next_passes++;
+			state->next_to_clean = 0;
+			state->next_passes++;
 		}
 		num_to_scan--;
 
 		if (sync_state & BUF_WRITTEN)
 		{
 			reusable_buffers++;
-			if (++num_written >= bgwriter_lru_maxpages)
+			if (++(*num_written) >= bgwriter_lru_maxpages)
 			{
 				BgWriterStats.m_maxwritten_clean++;
 				break;
@@ -2318,14 +2956,13 @@ BgBufferSync(WritebackContext *wb_context)
 			reusable_buffers++;
 	}
 
-	BgWriterStats.m_buf_written_clean += num_written;
-
 #ifdef BGW_DEBUG
-	elog(DEBUG1, "bgwriter: recent_alloc=%u smoothed=%.2f delta=%ld ahead=%d density=%.2f reusable_est=%d upcoming_est=%d scanned=%d wrote=%d reusable=%d",
-		 recent_alloc, smoothed_alloc, strategy_delta, bufs_ahead,
-		 smoothed_density, reusable_buffers_est, upcoming_alloc_est,
+	elog(DEBUG1, "bgwriter: partition=%d recent_alloc=%u smoothed=%.2f delta=%ld ahead=%d density=%.2f reusable_est=%d upcoming_est=%d scanned=%d wrote_total=%d reusable=%d",
+		 partition, recent_alloc, state->smoothed_alloc, strategy_delta,
+		 bufs_ahead,
+		 state->smoothed_density, reusable_buffers_est, upcoming_alloc_est,
 		 bufs_to_lap - num_to_scan,
-		 num_written,
+		 *num_written,
 		 reusable_buffers - reusable_buffers_est);
 #endif
 
@@ -2342,13 +2979,13 @@ BgBufferSync(WritebackContext *wb_context)
 	if (new_strategy_delta > 0 && new_recent_alloc > 0)
 	{
 		scans_per_alloc = (float) new_strategy_delta / (float) new_recent_alloc;
-		smoothed_density += (scans_per_alloc - smoothed_density) /
-			smoothing_samples;
+		state->smoothed_density +=
+			(scans_per_alloc - state->smoothed_density) / smoothing_samples;
 
 #ifdef BGW_DEBUG
 		elog(DEBUG2, "bgwriter: cleaner density alloc=%u scan=%ld density=%.2f new smoothed=%.2f",
 			 new_recent_alloc, new_strategy_delta,
-			 scans_per_alloc, smoothed_density);
+			 scans_per_alloc, state->smoothed_density);
 #endif
 	}
 
@@ -2419,7 +3056,7 @@ SyncOneBuffer(int buf_id, bool skip_recently_used, WritebackContext *wb_context)
 	PinBuffer_Locked(bufHdr);
 	LWLockAcquire(BufferDescriptorGetContentLock(bufHdr), LW_SHARED);
 
-	FlushBuffer(bufHdr, NULL);
+	FlushBuffer(bufHdr, NULL, IOCONTEXT_NORMAL);
 
 	LWLockRelease(BufferDescriptorGetContentLock(bufHdr));
 
@@ -2432,6 +3069,120 @@ SyncOneBuffer(int buf_id, bool skip_recently_used, WritebackContext *wb_context)
 	return result | BUF_WRITTEN;
 }
 
+/*
+ * SyncBufferRun -- write out a run of buffers during a checkpoint.
+ *
+ * "items" are the next "nitems" entries of the sorted CkptBufferIds array,
+ * the first of which is marked BM_CHECKPOINT_NEEDED.  The first buffer is
+ * written the same way as by SyncOneBuffer(); those following it are
+ * written along with it by a single smgrwritev() call, as long as they
+ * still need to be written and hold the next blocks of the same relation
+ * fork.
+ *
+ * The content lock of all but the first buffer is only taken if it's free,
+ * since we already hold the locks of the preceding buffers and must not
+ * wait for someone who might wait for us.  A buffer that can't be locked
+ * ends the run, and is dealt with by the next call.
+ *
+ * Returns the number of items processed, which is at least one, and sets
+ * *num_written to the number of buffers written.
+ */
+static int
+SyncBufferRun(CkptSortItem *items, int nitems, WritebackContext *wb_context,
+			  int *num_written)
+{
+	BufferDesc *bufs[MAX_IO_COMBINE_LIMIT];
+	int			nbufs;
+	int			i;
+
+	Assert(nitems > 0 && nitems <= MAX_IO_COMBINE_LIMIT);
+
+	*num_written = 0;
+
+	for (nbufs = 0; nbufs < nitems; nbufs++)
+	{
+		BufferDesc *bufHdr = GetBufferDescriptor(items[nbufs].buf_id);
+		uint32		buf_state;
+
+		ReservePrivateRefCountEntry();
+		ResourceOwnerEnlargeBuffers(CurrentResourceOwner);
+
+		buf_state = LockBufHdr(bufHdr);
+
+		if (nbufs == 0)
+		{
+			/* see SyncOneBuffer() */
+			if (!(buf_state & BM_VALID) || !(buf_state & BM_DIRTY))
+			{
+				UnlockBufHdr(bufHdr, buf_state);
+				return 1;
+			}
+		}
+		else
+		{
+			/*
+			 * The buffer can join the run if it still needs writing, no I/O
+			 * is in progress on it, and it holds the next block.  The sort
+			 * key doesn't include the database, so compare the full tag.
+			 */
+			if ((buf_state & (BM_VALID | BM_DIRTY | BM_CHECKPOINT_NEEDED |
+							  BM_IO_IN_PROGRESS)) !=
+				(BM_VALID | BM_DIRTY | BM_CHECKPOINT_NEEDED) ||
+				!RelFileNodeEquals(bufHdr->tag.rnode, bufs[0]->tag.rnode) ||
+				bufHdr->tag.forkNum != bufs[0]->tag.forkNum ||
+				bufHdr->tag.blockNum != bufs[0]->tag.blockNum + nbufs)
+			{
+				UnlockBufHdr(bufHdr, buf_state);
+				break;
+			}
+		}
+
+		PinBuffer_Locked(bufHdr);
+
+		if (nbufs == 0)
+			LWLockAcquire(BufferDescriptorGetContentLock(bufHdr), LW_SHARED);
+		else if (!LWLockConditionalAcquire(BufferDescriptorGetContentLock(bufHdr),
+										   LW_SHARED))
+		{
+			UnpinBuffer(bufHdr, true);
+			break;
+		}
+
+		/* Someone else might have written the buffer meanwhile */
+		if (!StartBufferIO(bufHdr, false))
+		{
+			LWLockRelease(BufferDescriptorGetContentLock(bufHdr));
+			UnpinBuffer(bufHdr, true);
+			if (nbufs == 0)
+				return 1;
+			break;
+		}
+
+		bufs[nbufs] = bufHdr;
+	}
+
+	FlushBufferRun(bufs, nbufs, IOCONTEXT_NORMAL);
+
+	for (i = 0; i < nbufs; i++)
+	{
+		BufferTag	tag;
+
+		LWLockRelease(BufferDescriptorGetContentLock(bufs[i]));
+
+		tag = bufs[i]->tag;
+
+		UnpinBuffer(bufs[i], true);
+
+		ScheduleBufferTagForWriteback(wb_context, &tag);
+
+		TRACE_POSTGRESQL_BUFFER_SYNC_WRITTEN(items[i].buf_id);
+	}
+
+	*num_written = nbufs;
+
+	return nbufs;
+}
+
 /*
  *		AtEOXact_Buffers - clean up at end of transaction.
  *
@@ -2687,10 +3438,11 @@ BufferGetTag(Buffer buffer, RelFileNode *rnode, ForkNumber *forknum,
  * written.)
  *
  * If the caller has an smgr reference for the buffer's relation, pass it
- * as the second parameter.  If not, pass NULL.
+ * as the second parameter.  If not, pass NULL.  The write is counted in
+ * pg_stat_io under io_context.
  */
 static void
-FlushBuffer(BufferDesc *buf, SMgrRelation reln)
+FlushBuffer(BufferDesc *buf, SMgrRelation reln, IOContext io_context)
 {
 	XLogRecPtr	recptr;
 	ErrorContextCallback errcallback;
@@ -2787,10 +3539,12 @@ FlushBuffer(BufferDesc *buf, SMgrRelation reln)
 		INSTR_TIME_SET_CURRENT(io_time);
 		INSTR_TIME_SUBTRACT(io_time, io_start);
 		pgstat_count_buffer_write_time(INSTR_TIME_GET_MICROSEC(io_time));
+		pgstat_count_io_time(io_context, IOOP_WRITE, io_time);
 		INSTR_TIME_ADD(pgBufferUsage.blk_write_time, io_time);
 	}
 
 	pgBufferUsage.shared_blks_written++;
+	pgstat_count_io_op(io_context, IOOP_WRITE);
 
 	/*
 	 * Mark the buffer as clean (unless BM_JUST_DIRTIED has become set) and
@@ -2808,6 +3562,126 @@ FlushBuffer(BufferDesc *buf, SMgrRelation reln)
 	error_context_stack = errcallback.previous;
 }
 
+/*
+ * FlushBufferRun
+ *		Physically write out a run of shared buffers holding consecutive
+ *		blocks of one relation fork, with a single smgrwritev() call.
+ *
+ * This is the multi-block variant of FlushBuffer().  Unlike there, the
+ * caller must have pinned and share-locked all of the buffers, and must
+ * have started I/O on them with StartBufferIO().
+ */
+static void
+FlushBufferRun(BufferDesc **bufs, int nbufs, IOContext io_context)
+{
+	XLogRecPtr	recptr = InvalidXLogRecPtr;
+	ErrorContextCallback errcallback;
+	BufferRunErrorArg errarg;
+	instr_time	io_start,
+				io_time;
+	SMgrRelation reln;
+	char	   *buffers[MAX_IO_COMBINE_LIMIT];
+	static char *pageCopies = NULL;
+	int			i;
+
+	Assert(nbufs > 0 && nbufs <= MAX_IO_COMBINE_LIMIT);
+
+	/* Setup error traceback support for ereport() */
+	errarg.first = bufs[0];
+	errarg.nbufs = nbufs;
+	errcallback.callback = shared_buffer_writev_error_callback;
+	errcallback.arg = (void *) &errarg;
+	errcallback.previous = error_context_stack;
+	error_context_stack = &errcallback;
+
+	reln = smgropen(bufs[0]->tag.rnode, InvalidBackendId);
+
+	for (i = 0; i < nbufs; i++)
+	{
+		BufferDesc *buf = bufs[i];
+		uint32		buf_state;
+
+		TRACE_POSTGRESQL_BUFFER_FLUSH_START(buf->tag.forkNum,
+											buf->tag.blockNum,
+											reln->smgr_rnode.node.spcNode,
+											reln->smgr_rnode.node.dbNode,
+											reln->smgr_rnode.node.relNode);
+
+		/* See FlushBuffer() */
+		buf_state = LockBufHdr(buf);
+		if ((buf_state & BM_PERMANENT) && BufferGetLSN(buf) > recptr)
+			recptr = BufferGetLSN(buf);
+		buf_state &= ~BM_JUST_DIRTIED;
+		UnlockBufHdr(buf, buf_state);
+	}
+
+	/* Obey the WAL rule for all the blocks at once */
+	if (!XLogRecPtrIsInvalid(recptr))
+		XLogFlush(recptr);
+
+	/*
+	 * PageSetChecksumCopy() returns the same private copy every time, so
+	 * keep our own copy of each checksummed page.
+	 */
+	for (i = 0; i < nbufs; i++)
+	{
+		Page		page = (Page) BufHdrGetBlock(bufs[i]);
+		char	   *bufToWrite;
+
+		bufToWrite = PageSetChecksumCopy(page, bufs[i]->tag.blockNum);
+		if (bufToWrite != (char *) page)
+		{
+			if (pageCopies == NULL)
+				pageCopies = (char *)
+					TYPEALIGN(PG_IO_ALIGN_SIZE,
+							  MemoryContextAlloc(TopMemoryContext,
+												 MAX_IO_COMBINE_LIMIT * BLCKSZ +
+												 PG_IO_ALIGN_SIZE));
+			memcpy(pageCopies + i * BLCKSZ, bufToWrite, BLCKSZ);
+			bufToWrite = pageCopies + i * BLCKSZ;
+		}
+		buffers[i] = bufToWrite;
+	}
+
+	if (track_io_timing)
+		INSTR_TIME_SET_CURRENT(io_start);
+
+	smgrwritev(reln,
+			   bufs[0]->tag.forkNum,
+			   bufs[0]->tag.blockNum,
+			   buffers,
+			   nbufs,
+			   false);
+
+	if (track_io_timing)
+	{
+		INSTR_TIME_SET_CURRENT(io_time);
+		INSTR_TIME_SUBTRACT(io_time, io_start);
+		pgstat_count_buffer_write_time(INSTR_TIME_GET_MICROSEC(io_time));
+		pgstat_count_io_time(io_context, IOOP_WRITE, io_time);
+		INSTR_TIME_ADD(pgBufferUsage.blk_write_time, io_time);
+	}
+
+	for (i = 0; i < nbufs; i++)
+	{
+		BufferDesc *buf = bufs[i];
+
+		pgBufferUsage.shared_blks_written++;
+		pgstat_count_io_op(io_context, IOOP_WRITE);
+
+		TerminateBufferIO(buf, true, 0);
+
+		TRACE_POSTGRESQL_BUFFER_FLUSH_DONE(buf->tag.forkNum,
+										   buf->tag.blockNum,
+										   reln->smgr_rnode.node.spcNode,
+										   reln->smgr_rnode.node.dbNode,
+										   reln->smgr_rnode.node.relNode);
+	}
+
+	/* Pop the error context stack */
+	error_context_stack = errcallback.previous;
+}
+
 /*
  * RelationGetNumberOfBlocksInFork
  *		Determines the current number of pages in the specified relation fork.
@@ -3294,7 +4168,7 @@ FlushRelationBuffers(Relation rel)
 		{
 			PinBuffer_Locked(bufHdr);
 			LWLockAcquire(BufferDescriptorGetContentLock(bufHdr), LW_SHARED);
-			FlushBuffer(bufHdr, rel->rd_smgr);
+			FlushBuffer(bufHdr, rel->rd_smgr, IOCONTEXT_NORMAL);
 			LWLockRelease(BufferDescriptorGetContentLock(bufHdr));
 			UnpinBuffer(bufHdr, true);
 		}
@@ -3390,7 +4264,7 @@ FlushRelationsAllBuffers(SMgrRelation *smgrs, int nrels)
 		{
 			PinBuffer_Locked(bufHdr);
 			LWLockAcquire(BufferDescriptorGetContentLock(bufHdr), LW_SHARED);
-			FlushBuffer(bufHdr, srelent->srel);
+			FlushBuffer(bufHdr, srelent->srel, IOCONTEXT_NORMAL);
 			LWLockRelease(BufferDescriptorGetContentLock(bufHdr));
 			UnpinBuffer(bufHdr, true);
 		}
@@ -3446,7 +4320,7 @@ FlushDatabaseBuffers(Oid dbid)
 		{
 			PinBuffer_Locked(bufHdr);
 			LWLockAcquire(BufferDescriptorGetContentLock(bufHdr), LW_SHARED);
-			FlushBuffer(bufHdr, NULL);
+			FlushBuffer(bufHdr, NULL, IOCONTEXT_NORMAL);
 			LWLockRelease(BufferDescriptorGetContentLock(bufHdr));
 			UnpinBuffer(bufHdr, true);
 		}
@@ -3473,7 +4347,7 @@ FlushOneBuffer(Buffer buffer)
 
 	Assert(LWLockHeldByMe(BufferDescriptorGetContentLock(bufHdr)));
 
-	FlushBuffer(bufHdr, NULL);
+	FlushBuffer(bufHdr, NULL, IOCONTEXT_NORMAL);
 }
 
 /*
@@ -4025,16 +4899,19 @@ IsBufferCleanupOK(Buffer buffer)
 static void
 WaitIO(BufferDesc *buf)
 {
+	ConditionVariable *cv = BufferDescriptorGetIOCV(buf);
+
 	/*
-	 * Changed to wait until there's no IO - Inoue 01/13/2000
-	 *
-	 * Note this is *necessary* because an error abort in the process doing
-	 * I/O could release the io_in_progress_lock prematurely. See
-	 * AbortBufferIO.
+	 * The I/O we're about to wait for might depend on I/O that we have
+	 * staged ourselves, so make sure that's on its way first.
 	 */
+	pgaio_submit_staged();
+
+	ConditionVariablePrepareToSleep(cv);
 	for (;;)
 	{
 		uint32		buf_state;
+		int			aio;
 
 		/*
 		 * It may not be necessary to acquire the spinlock to check the flag
@@ -4042,13 +4919,25 @@ WaitIO(BufferDesc *buf)
 		 * play it safe.
 		 */
 		buf_state = LockBufHdr(buf);
+		aio = BufferDescriptorGetIO(buf)->aio;
 		UnlockBufHdr(buf, buf_state);
 
 		if (!(buf_state & BM_IO_IN_PROGRESS))
 			break;
-		LWLockAcquire(BufferDescriptorGetIOLock(buf), LW_SHARED);
-		LWLockRelease(BufferDescriptorGetIOLock(buf));
+
+		/*
+		 * If the buffer is being read asynchronously, the I/O may need our
+		 * help to make progress, for example by reaping its completion.
+		 */
+		if (aio >= 0)
+		{
+			pgaio_wait_for_id(aio);
+			continue;
+		}
+
+		ConditionVariableSleep(cv, WAIT_EVENT_BUFFER_IO);
 	}
+	ConditionVariableCancelSleep();
 }
 
 /*
@@ -4059,8 +4948,8 @@ WaitIO(BufferDesc *buf)
  *
  * In some scenarios there are race conditions in which multiple backends
  * could attempt the same I/O operation concurrently.  If someone else
- * has already started I/O on this buffer then we will block on the
- * io_in_progress lock until he's done.
+ * has already started I/O on this buffer then we will wait on the
+ * buffer's I/O condition variable until he's done.
  *
  * Input operations are only attempted on buffers that are not BM_VALID,
  * and output operations only on buffers that are BM_VALID and BM_DIRTY,
@@ -4074,29 +4963,17 @@ StartBufferIO(BufferDesc *buf, bool forInput)
 {
 	uint32		buf_state;
 
-	Assert(!InProgressBuf);
+	/* only writes are done on several buffers at once */
+	Assert(NumInProgressBufs == 0 || (!forInput && !IsForInput));
+	Assert(NumInProgressBufs < lengthof(InProgressBufs));
 
 	for (;;)
 	{
-		/*
-		 * Grab the io_in_progress lock so that other processes can wait for
-		 * me to finish the I/O.
-		 */
-		LWLockAcquire(BufferDescriptorGetIOLock(buf), LW_EXCLUSIVE);
-
 		buf_state = LockBufHdr(buf);
 
 		if (!(buf_state & BM_IO_IN_PROGRESS))
 			break;
-
-		/*
-		 * The only way BM_IO_IN_PROGRESS could be set when the io_in_progress
-		 * lock isn't held is if the process doing the I/O is recovering from
-		 * an error (see AbortBufferIO).  If that's the case, we must wait for
-		 * him to get unwedged.
-		 */
 		UnlockBufHdr(buf, buf_state);
-		LWLockRelease(BufferDescriptorGetIOLock(buf));
 		WaitIO(buf);
 	}
 
@@ -4106,14 +4983,13 @@ StartBufferIO(BufferDesc *buf, bool forInput)
 	{
 		/* someone else already did the I/O */
 		UnlockBufHdr(buf, buf_state);
-		LWLockRelease(BufferDescriptorGetIOLock(buf));
 		return false;
 	}
 
 	buf_state |= BM_IO_IN_PROGRESS;
 	UnlockBufHdr(buf, buf_state);
 
-	InProgressBuf = buf;
+	InProgressBufs[NumInProgressBufs++] = buf;
 	IsForInput = forInput;
 
 	return true;
@@ -4124,7 +5000,6 @@ StartBufferIO(BufferDesc *buf, bool forInput)
  *	(Assumptions)
  *	My process is executing IO for the buffer
  *	BM_IO_IN_PROGRESS bit is set for the buffer
- *	We hold the buffer's io_in_progress lock
  *	The buffer is Pinned
  *
  * If clear_dirty is true and BM_JUST_DIRTIED is not set, we clear the
@@ -4141,8 +5016,6 @@ TerminateBufferIO(BufferDesc *buf, bool clear_dirty, uint32 set_flag_bits)
 {
 	uint32		buf_state;
 
-	Assert(buf == InProgressBuf);
-
 	buf_state = LockBufHdr(buf);
 
 	Assert(buf_state & BM_IO_IN_PROGRESS);
@@ -4154,9 +5027,32 @@ TerminateBufferIO(BufferDesc *buf, bool clear_dirty, uint32 set_flag_bits)
 	buf_state |= set_flag_bits;
 	UnlockBufHdr(buf, buf_state);
 
-	InProgressBuf = NULL;
+	ForgetBufferIO(buf);
+
+	ConditionVariableBroadcast(BufferDescriptorGetIOCV(buf));
+}
+
+/*
+ * ForgetBufferIO: stop tracking a buffer we were doing I/O on
+ *
+ * This is called when the I/O is finished, or when the responsibility for
+ * finishing it has been handed over to an asynchronous I/O.
+ */
+static void
+ForgetBufferIO(BufferDesc *buf)
+{
+	int			i;
+
+	for (i = 0; i < NumInProgressBufs; i++)
+	{
+		if (InProgressBufs[i] == buf)
+		{
+			InProgressBufs[i] = InProgressBufs[--NumInProgressBufs];
+			return;
+		}
+	}
 
-	LWLockRelease(BufferDescriptorGetIOLock(buf));
+	elog(ERROR, "no I/O in progress on buffer %d", buf->buf_id);
 }
 
 /*
@@ -4167,24 +5063,20 @@ TerminateBufferIO(BufferDesc *buf, bool clear_dirty, uint32 set_flag_bits)
  *
  *	If I/O was in progress, we always set BM_IO_ERROR, even though it's
  *	possible the error condition wasn't related to the I/O.
+ *
+ *	Asynchronous reads we started can't be cancelled, so we wait for them
+ *	to complete, while our pins still protect the buffers they read into.
  */
 void
 AbortBufferIO(void)
 {
-	BufferDesc *buf = InProgressBuf;
+	pgaio_wait_all_owned();
 
-	if (buf)
+	while (NumInProgressBufs > 0)
 	{
+		BufferDesc *buf = InProgressBufs[NumInProgressBufs - 1];
 		uint32		buf_state;
 
-		/*
-		 * Since LWLockReleaseAll has already been called, we're not holding
-		 * the buffer's io_in_progress_lock. We have to re-acquire it so that
-		 * we can use TerminateBufferIO. Anyone who's executing WaitIO on the
-		 * buffer will be in a busy spin until we succeed in doing this.
-		 */
-		LWLockAcquire(BufferDescriptorGetIOLock(buf), LW_EXCLUSIVE);
-
 		buf_state = LockBufHdr(buf);
 		Assert(buf_state & BM_IO_IN_PROGRESS);
 		if (IsForInput)
@@ -4237,6 +5129,28 @@ shared_buffer_write_error_callback(void *arg)
 	}
 }
 
+/*
+ * Error context callback for errors occurring while writing a run of shared
+ * buffers with FlushBufferRun().
+ */
+static void
+shared_buffer_writev_error_callback(void *arg)
+{
+	BufferRunErrorArg *run = (BufferRunErrorArg *) arg;
+	BufferDesc *bufHdr = run->first;
+
+	/* Buffers are pinned, so we can read the tag without the spinlock */
+	if (bufHdr != NULL)
+	{
+		char	   *path = relpathperm(bufHdr->tag.rnode, bufHdr->tag.forkNum);
+
+		errcontext("writing blocks %u to %u of relation %s",
+				   bufHdr->tag.blockNum,
+				   bufHdr->tag.blockNum + run->nbufs - 1, path);
+		pfree(path);
+	}
+}
+
 /*
  * Error context callback for errors occurring during local buffer writes.
  */
@@ -16,6 +16,7 @@
 #include "postgres.h"
 
 #include "port/atomics.h"
+#include "port/pg_numa.h"
 #include "storage/buf_internals.h"
 #include "storage/bufmgr.h"
 #include "storage/proc.h"
@@ -24,17 +25,51 @@
 
 
 /*
- * The shared freelist control information.
+ * The buffer pool is divided into partitions, each a contiguous range of
+ * buffers with its own clock sweep and freelist, so that backends allocating
+ * buffers at the same time usually don't touch the same cache lines.  Small
+ * buffer pools use a single partition, since the clock sweep of a partition
+ * that is too small would recycle buffers before they had a chance to be
+ * used again.
+ *
+ * With numa = partition, the number of partitions is a multiple of the
+ * number of NUMA nodes, and each node gets an equal share of consecutive
+ * partitions, whose memory is placed on that node by InitBufferPool().
+ * Backends then allocate buffers from the partitions of the node they are
+ * running on, as long as those have unpinned buffers.  If the buffer pool
+ * is too small to give each node a partition of the minimum size, the
+ * partitions aren't tied to nodes, and the buffers are interleaved over
+ * all nodes instead.
+ */
+#define MAX_STRATEGY_PARTITIONS			64
+#define MIN_STRATEGY_PARTITION_BUFFERS	(128 * 1024 * 1024 / BLCKSZ)
+
+/*
+ * A backend allocates this many buffers from one partition before moving on
+ * to the next one.  Moving on spreads the allocations of each backend over
+ * the whole buffer pool, so that a single busy backend can still use all of
+ * it; doing so only every so often keeps the partition's cache lines in the
+ * backend's CPU cache in the meantime.
+ */
+#define STRATEGY_PARTITION_ALLOCS		64
+
+/*
+ * The shared control information for one partition.
  */
 typedef struct
 {
 	/* Spinlock: protects the values below */
 	slock_t		buffer_strategy_lock;
 
+	/* Range of buffers in this partition; constant after initialization */
+	int			firstBuffer;
+	int			numBuffers;
+
 	/*
-	 * Clock sweep hand: index of next buffer to consider grabbing. Note that
-	 * this isn't a concrete buffer - we only ever increase the value. So, to
-	 * get an actual buffer, it needs to be used modulo NBuffers.
+	 * Clock sweep hand: index of next buffer to consider grabbing, relative
+	 * to firstBuffer. Note that this isn't a concrete buffer - we only ever
+	 * increase the value. So, to get an actual buffer, it needs to be used
+	 * modulo numBuffers.
 	 */
 	pg_atomic_uint32 nextVictimBuffer;
 
@@ -52,17 +87,51 @@ typedef struct
 	 */
 	uint32		completePasses; /* Complete cycles of the clock sweep */
 	pg_atomic_uint32 numBufferAllocs;	/* Buffers allocated since last reset */
+} BufferStrategyPartition;
+
+/* Pad each partition to a cache line, so that they don't share any */
+typedef union
+{
+	BufferStrategyPartition part;
+	char		pad[PG_CACHE_LINE_SIZE];
+} BufferStrategyPartitionPadded;
+
+/*
+ * The shared freelist control information.
+ */
+typedef struct
+{
+	/* Spinlock: protects bgwprocno */
+	slock_t		bgwriter_notify_lock;
 
 	/*
 	 * Bgworker process to be notified upon activity or -1 if none. See
 	 * StrategyNotifyBgWriter.
 	 */
 	int			bgwprocno;
+
+	/* Number of partitions; constant after initialization */
+	int			numPartitions;
+
+	/*
+	 * Number of NUMA nodes the partitions are divided between, or 0 if they
+	 * are not tied to nodes; constant after initialization
+	 */
+	int			numaNodes;
+
+	BufferStrategyPartitionPadded partitions[FLEXIBLE_ARRAY_MEMBER];
 } BufferStrategyControl;
 
 /* Pointers to shared state */
 static BufferStrategyControl *StrategyControl = NULL;
 
+/*
+ * The partition this backend currently allocates buffers from, or -1 if not
+ * chosen yet, and the number of buffers allocated from it so far.
+ */
+static int	MyStrategyPartition = -1;
+static int	MyStrategyPartitionAllocs = 0;
+
 /*
  * Private (non-shared) state for managing a ring of shared buffers to re-use.
  * This is currently the only kind of BufferAccessStrategy object, but someday
@@ -103,14 +172,111 @@ static BufferDesc *GetBufferFromRing(BufferAccessStrategy strategy,
 static void AddBufferToRing(BufferAccessStrategy strategy,
 							BufferDesc *buf);
 
+/*
+ * Number of NUMA nodes to divide a buffer pool of nbuffers buffers between,
+ * or 0 if the partitions are not to be tied to nodes.  Each node needs at
+ * least one partition of at least MIN_STRATEGY_PARTITION_BUFFERS buffers.
+ */
+static int
+StrategyNumaNodesFor(int nbuffers)
+{
+	int			nnodes;
+
+	if (numa_placement != NUMA_PLACEMENT_PARTITION)
+		return 0;
+
+	nnodes = pg_numa_num_nodes();
+	if (nnodes <= 1 || nnodes > MAX_STRATEGY_PARTITIONS ||
+		nbuffers / MIN_STRATEGY_PARTITION_BUFFERS < nnodes)
+		return 0;
+
+	return nnodes;
+}
+
+/*
+ * Number of partitions to divide a buffer pool of nbuffers buffers into.
+ */
+static int
+StrategyPartitionsFor(int nbuffers)
+{
+	int			npartitions;
+	int			nnodes = StrategyNumaNodesFor(nbuffers);
+
+	npartitions = nbuffers / MIN_STRATEGY_PARTITION_BUFFERS;
+	npartitions = Min(npartitions, MAX_STRATEGY_PARTITIONS);
+	npartitions = Max(npartitions, 1);
+
+	/*
+	 * Give each node the same number of partitions.  Rounding down keeps the
+	 * partitions at least MIN_STRATEGY_PARTITION_BUFFERS buffers each, and
+	 * StrategyNumaNodesFor() made sure that leaves at least one per node.
+	 */
+	if (nnodes > 0)
+	{
+		npartitions = npartitions / nnodes * nnodes;
+		Assert(npartitions >= nnodes);
+	}
+
+	return npartitions;
+}
+
+/*
+ * Choose the partition for this backend's next run of allocations.
+ *
+ * If the partitions are tied to NUMA nodes, we cycle through the partitions
+ * of the node we're currently running on; otherwise, through all of them.
+ */
+static int
+StrategyChoosePartition(void)
+{
+	int			npartitions = StrategyControl->numPartitions;
+	int			procno = (MyProc != NULL ? MyProc->pgprocno : 0);
+
+	if (StrategyControl->numaNodes > 0)
+	{
+		int			node = pg_numa_current_node();
+
+		if (node >= 0)
+		{
+			int			per_node = npartitions / StrategyControl->numaNodes;
+			int			first = node * per_node;
+
+			if (MyStrategyPartition >= first &&
+				MyStrategyPartition < first + per_node)
+				return first + (MyStrategyPartition - first + 1) % per_node;
+			return first + procno % per_node;
+		}
+	}
+
+	if (MyStrategyPartition < 0)
+		return procno % npartitions;
+	return (MyStrategyPartition + 1) % npartitions;
+}
+
+/*
+ * Get the partition that the given buffer belongs to.  All partitions have
+ * the same size, except that the last one also gets the remainder.
+ */
+static inline BufferStrategyPartition *
+BufferGetStrategyPartition(BufferDesc *buf)
+{
+	int			partsize = NBuffers / StrategyControl->numPartitions;
+	int			partition;
+
+	partition = Min(buf->buf_id / partsize,
+					StrategyControl->numPartitions - 1);
+
+	return &StrategyControl->partitions[partition].part;
+}
+
 /*
  * ClockSweepTick - Helper routine for StrategyGetBuffer()
  *
- * Move the clock hand one buffer ahead of its current position and return the
- * id of the buffer now under the hand.
+ * Move the partition's clock hand one buffer ahead of its current position
+ * and return the id of the buffer now under the hand.
  */
 static inline uint32
-ClockSweepTick(void)
+ClockSweepTick(BufferStrategyPartition *part)
 {
 	uint32		victim;
 
@@ -120,14 +286,14 @@ ClockSweepTick(void)
 	 * apparent order.
 	 */
 	victim =
-		pg_atomic_fetch_add_u32(&StrategyControl->nextVictimBuffer, 1);
+		pg_atomic_fetch_add_u32(&part->nextVictimBuffer, 1);
 
-	if (victim >= NBuffers)
+	if (victim >= part->numBuffers)
 	{
 		uint32		originalVictim = victim;
 
 		/* always wrap what we look up in BufferDescriptors */
-		victim = victim % NBuffers;
+		victim = victim % part->numBuffers;
 
 		/*
 		 * If we're the one that just caused a wraparound, force
@@ -153,19 +319,19 @@ ClockSweepTick(void)
 				 * could lead to an overflow of nextVictimBuffers, but that's
 				 * highly unlikely and wouldn't be particularly harmful.
 				 */
-				SpinLockAcquire(&StrategyControl->buffer_strategy_lock);
+				SpinLockAcquire(&part->buffer_strategy_lock);
 
-				wrapped = expected % NBuffers;
+				wrapped = expected % part->numBuffers;
 
-				success = pg_atomic_compare_exchange_u32(&StrategyControl->nextVictimBuffer,
+				success = pg_atomic_compare_exchange_u32(&part->nextVictimBuffer,
 														 &expected, wrapped);
 				if (success)
-					StrategyControl->completePasses++;
-				SpinLockRelease(&StrategyControl->buffer_strategy_lock);
+					part->completePasses++;
+				SpinLockRelease(&part->buffer_strategy_lock);
 			}
 		}
 	}
-	return victim;
+	return part->firstBuffer + victim;
 }
 
 /*
@@ -179,10 +345,14 @@ ClockSweepTick(void)
 bool
 have_free_buffer()
 {
-	if (StrategyControl->firstFreeBuffer >= 0)
-		return true;
-	else
-		return false;
+	int			i;
+
+	for (i = 0; i < StrategyControl->numPartitions; i++)
+	{
+		if (StrategyControl->partitions[i].part.firstFreeBuffer >= 0)
+			return true;
+	}
+	return false;
 }
 
 /*
@@ -193,18 +363,25 @@ have_free_buffer()
  *	the selected buffer must not currently be pinned by anyone.
  *
  *	strategy is a BufferAccessStrategy object, or NULL for default strategy.
+ *	*from_ring is set to true if the buffer was taken from the strategy's ring,
+ *	which means that its previous contents were put there by the strategy.
  *
  *	To ensure that no one else can pin the buffer before we do, we must
  *	return the buffer with the buffer header spinlock still held.
  */
 BufferDesc *
-StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state)
+StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state,
+				  bool *from_ring)
 {
 	BufferDesc *buf;
+	BufferStrategyPartition *part;
 	int			bgwprocno;
 	int			trycounter;
+	int			partitions_left;
 	uint32		local_buf_state;	/* to avoid repeated (de-)referencing */
 
+	*from_ring = false;
+
 	/*
 	 * If given a strategy object, see whether it can select a buffer. We
 	 * assume strategy objects don't need buffer_strategy_lock.
@@ -213,7 +390,10 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state)
 	{
 		buf = GetBufferFromRing(strategy, buf_state);
 		if (buf != NULL)
+		{
+			*from_ring = true;
 			return buf;
+		}
 	}
 
 	/*
@@ -242,17 +422,30 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state)
 		SetLatch(&ProcGlobal->allProcs[bgwprocno].procLatch);
 	}
 
+	/*
+	 * Choose the partition to allocate from.  Backends start out in
+	 * different partitions, and move on to the next one every
+	 * STRATEGY_PARTITION_ALLOCS allocations.
+	 */
+	if (MyStrategyPartition < 0 ||
+		++MyStrategyPartitionAllocs >= STRATEGY_PARTITION_ALLOCS)
+	{
+		MyStrategyPartition = StrategyChoosePartition();
+		MyStrategyPartitionAllocs = 0;
+	}
+	part = &StrategyControl->partitions[MyStrategyPartition].part;
+
 	/*
 	 * We count buffer allocation requests so that the bgwriter can estimate
 	 * the rate of buffer consumption.  Note that buffers recycled by a
 	 * strategy object are intentionally not counted here.
 	 */
-	pg_atomic_fetch_add_u32(&StrategyControl->numBufferAllocs, 1);
+	pg_atomic_fetch_add_u32(&part->numBufferAllocs, 1);
 
 	/*
 	 * First check, without acquiring the lock, whether there's buffers in the
-	 * freelist. Since we otherwise don't require the spinlock in every
-	 * StrategyGetBuffer() invocation, it'd be sad to acquire it here -
+	 * partition's freelist. Since we otherwise don't require the spinlock in
+	 * every StrategyGetBuffer() invocation, it'd be sad to acquire it here -
 	 * uselessly in most cases. That obviously leaves a race where a buffer is
 	 * put on the freelist but we don't see the store yet - but that's pretty
 	 * harmless, it'll just get used during the next buffer acquisition.
@@ -264,32 +457,36 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state)
 	 * Note that the freeNext fields are considered to be protected by the
 	 * buffer_strategy_lock not the individual buffer spinlocks, so it's OK to
 	 * manipulate them without holding the spinlock.
+	 *
+	 * Only the freelist of the current partition is checked.  Since every
+	 * backend moves through all partitions, the other freelists will be
+	 * consumed soon enough.
 	 */
-	if (StrategyControl->firstFreeBuffer >= 0)
+	if (part->firstFreeBuffer >= 0)
 	{
 		while (true)
 		{
 			/* Acquire the spinlock to remove element from the freelist */
-			SpinLockAcquire(&StrategyControl->buffer_strategy_lock);
+			SpinLockAcquire(&part->buffer_strategy_lock);
 
-			if (StrategyControl->firstFreeBuffer < 0)
+			if (part->firstFreeBuffer < 0)
 			{
-				SpinLockRelease(&StrategyControl->buffer_strategy_lock);
+				SpinLockRelease(&part->buffer_strategy_lock);
 				break;
 			}
 
-			buf = GetBufferDescriptor(StrategyControl->firstFreeBuffer);
+			buf = GetBufferDescriptor(part->firstFreeBuffer);
 			Assert(buf->freeNext != FREENEXT_NOT_IN_LIST);
 
 			/* Unconditionally remove buffer from freelist */
-			StrategyControl->firstFreeBuffer = buf->freeNext;
+			part->firstFreeBuffer = buf->freeNext;
 			buf->freeNext = FREENEXT_NOT_IN_LIST;
 
 			/*
 			 * Release the lock so someone else can access the freelist while
 			 * we check out this buffer.
 			 */
-			SpinLockRelease(&StrategyControl->buffer_strategy_lock);
+			SpinLockRelease(&part->buffer_strategy_lock);
 
 			/*
 			 * If the buffer is pinned or has a nonzero usage_count, we cannot
@@ -312,11 +509,16 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state)
 		}
 	}
 
-	/* Nothing on the freelist, so run the "clock sweep" algorithm */
-	trycounter = NBuffers;
+	/*
+	 * Nothing on the freelist, so run the "clock sweep" algorithm over the
+	 * partition.  If all of its buffers are pinned, try the other partitions
+	 * in turn before giving up.
+	 */
+	trycounter = part->numBuffers;
+	partitions_left = StrategyControl->numPartitions - 1;
 	for (;;)
 	{
-		buf = GetBufferDescriptor(ClockSweepTick());
+		buf = GetBufferDescriptor(ClockSweepTick(part));
 
 		/*
 		 * If the buffer is pinned or has a nonzero usage_count, we cannot use
@@ -330,7 +532,7 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state)
 			{
 				local_buf_state -= BUF_USAGECOUNT_ONE;
 
-				trycounter = NBuffers;
+				trycounter = part->numBuffers;
 			}
 			else
 			{
@@ -344,26 +546,36 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state)
 		else if (--trycounter == 0)
 		{
 			/*
-			 * We've scanned all the buffers without making any state changes,
-			 * so all the buffers are pinned (or were when we looked at them).
-			 * We could hope that someone will free one eventually, but it's
-			 * probably better to fail than to risk getting stuck in an
-			 * infinite loop.
+			 * We've scanned all the buffers of the partition without making
+			 * any state changes, so all of them are pinned (or were when we
+			 * looked at them).  Move on to the next partition, if there are
+			 * any left.  Otherwise, we could hope that someone will free one
+			 * eventually, but it's probably better to fail than to risk
+			 * getting stuck in an infinite loop.
 			 */
 			UnlockBufHdr(buf, local_buf_state);
-			elog(ERROR, "no unpinned buffers available");
+			if (partitions_left-- == 0)
+				elog(ERROR, "no unpinned buffers available");
+			MyStrategyPartition = (MyStrategyPartition + 1) %
+				StrategyControl->numPartitions;
+			MyStrategyPartitionAllocs = 0;
+			part = &StrategyControl->partitions[MyStrategyPartition].part;
+			trycounter = part->numBuffers;
+			continue;
 		}
 		UnlockBufHdr(buf, local_buf_state);
 	}
 }
 
 /*
- * StrategyFreeBuffer: put a buffer on the freelist
+ * StrategyFreeBuffer: put a buffer on the freelist of its partition
  */
 void
 StrategyFreeBuffer(BufferDesc *buf)
 {
-	SpinLockAcquire(&StrategyControl->buffer_strategy_lock);
+	BufferStrategyPartition *part = BufferGetStrategyPartition(buf);
+
+	SpinLockAcquire(&part->buffer_strategy_lock);
 
 	/*
 	 * It is possible that we are told to put something in the freelist that
@@ -371,52 +583,100 @@ StrategyFreeBuffer(BufferDesc *buf)
 	 */
 	if (buf->freeNext == FREENEXT_NOT_IN_LIST)
 	{
-		buf->freeNext = StrategyControl->firstFreeBuffer;
+		buf->freeNext = part->firstFreeBuffer;
 		if (buf->freeNext < 0)
-			StrategyControl->lastFreeBuffer = buf->buf_id;
-		StrategyControl->firstFreeBuffer = buf->buf_id;
+			part->lastFreeBuffer = buf->buf_id;
+		part->firstFreeBuffer = buf->buf_id;
 	}
 
-	SpinLockRelease(&StrategyControl->buffer_strategy_lock);
+	SpinLockRelease(&part->buffer_strategy_lock);
+}
+
+/*
+ * StrategyNumPartitions -- number of partitions of the buffer pool
+ */
+int
+StrategyNumPartitions(void)
+{
+	return StrategyControl->numPartitions;
+}
+
+/*
+ * StrategyPartitionRange -- range of buffers of a partition
+ *
+ * The partition consists of buffer ids *first_buffer up to, but not
+ * including, *first_buffer + *num_buffers.
+ */
+void
+StrategyPartitionRange(int partition, int *first_buffer, int *num_buffers)
+{
+	BufferStrategyPartition *part;
+
+	Assert(partition >= 0 && partition < StrategyControl->numPartitions);
+	part = &StrategyControl->partitions[partition].part;
+
+	*first_buffer = part->firstBuffer;
+	*num_buffers = part->numBuffers;
+}
+
+/*
+ * StrategyPartitionNode -- NUMA node a partition is tied to, or -1 if none
+ */
+int
+StrategyPartitionNode(int partition)
+{
+	int			nnodes = StrategyControl->numaNodes;
+
+	Assert(partition >= 0 && partition < StrategyControl->numPartitions);
+
+	if (nnodes == 0)
+		return -1;
+	return partition / (StrategyControl->numPartitions / nnodes);
 }
 
 /*
  * StrategySyncStart -- tell BufferSync where to start syncing
  *
- * The result is the buffer index of the best buffer to sync first.
- * BufferSync() will proceed circularly around the buffer array from there.
+ * The result is the buffer index of the best buffer of the given partition
+ * to sync first.  BgBufferSync() will proceed circularly around the
+ * partition's range of buffers from there.
  *
- * In addition, we return the completed-pass count (which is effectively
- * the higher-order bits of nextVictimBuffer) and the count of recent buffer
- * allocs if non-NULL pointers are passed.  The alloc count is reset after
- * being read.
+ * In addition, we return the completed-pass count of the partition's clock
+ * sweep (which is effectively the higher-order bits of nextVictimBuffer) and
+ * the count of recent buffer allocs from the partition if non-NULL pointers
+ * are passed.  The alloc count is reset after being read.
  */
 int
-StrategySyncStart(uint32 *complete_passes, uint32 *num_buf_alloc)
+StrategySyncStart(int partition, uint32 *complete_passes,
+				  uint32 *num_buf_alloc)
 {
+	BufferStrategyPartition *part;
 	uint32		nextVictimBuffer;
 	int			result;
 
-	SpinLockAcquire(&StrategyControl->buffer_strategy_lock);
-	nextVictimBuffer = pg_atomic_read_u32(&StrategyControl->nextVictimBuffer);
-	result = nextVictimBuffer % NBuffers;
+	Assert(partition >= 0 && partition < StrategyControl->numPartitions);
+	part = &StrategyControl->partitions[partition].part;
+
+	SpinLockAcquire(&part->buffer_strategy_lock);
+	nextVictimBuffer = pg_atomic_read_u32(&part->nextVictimBuffer);
+	result = part->firstBuffer + nextVictimBuffer % part->numBuffers;
 
 	if (complete_passes)
 	{
-		*complete_passes = StrategyControl->completePasses;
+		*complete_passes = part->completePasses;
 
 		/*
 		 * Additionally add the number of wraparounds that happened before
 		 * completePasses could be incremented. C.f. ClockSweepTick().
 		 */
-		*complete_passes += nextVictimBuffer / NBuffers;
+		*complete_passes += nextVictimBuffer / part->numBuffers;
 	}
 
 	if (num_buf_alloc)
 	{
-		*num_buf_alloc = pg_atomic_exchange_u32(&StrategyControl->numBufferAllocs, 0);
+		*num_buf_alloc = pg_atomic_exchange_u32(&part->numBufferAllocs, 0);
 	}
-	SpinLockRelease(&StrategyControl->buffer_strategy_lock);
+	SpinLockRelease(&part->buffer_strategy_lock);
 	return result;
 }
 
@@ -432,13 +692,13 @@ void
 StrategyNotifyBgWriter(int bgwprocno)
 {
 	/*
-	 * We acquire buffer_strategy_lock just to ensure that the store appears
+	 * We acquire bgwriter_notify_lock just to ensure that the store appears
 	 * atomic to StrategyGetBuffer.  The bgwriter should call this rather
 	 * infrequently, so there's no performance penalty from being safe.
 	 */
-	SpinLockAcquire(&StrategyControl->buffer_strategy_lock);
+	SpinLockAcquire(&StrategyControl->bgwriter_notify_lock);
 	StrategyControl->bgwprocno = bgwprocno;
-	SpinLockRelease(&StrategyControl->buffer_strategy_lock);
+	SpinLockRelease(&StrategyControl->bgwriter_notify_lock);
 }
 
 
@@ -459,7 +719,9 @@ StrategyShmemSize(void)
 	size = add_size(size, BufTableShmemSize(NBuffers + NUM_BUFFER_PARTITIONS));
 
 	/* size of the shared replacement strategy control block */
-	size = add_size(size, MAXALIGN(sizeof(BufferStrategyControl)));
+	size = add_size(size, MAXALIGN(offsetof(BufferStrategyControl, partitions) +
+								   mul_size(StrategyPartitionsFor(NBuffers),
+											sizeof(BufferStrategyPartitionPadded))));
 
 	return size;
 }
@@ -475,16 +737,17 @@ void
 StrategyInitialize(bool init)
 {
 	bool		found;
+	int			npartitions = StrategyPartitionsFor(NBuffers);
 
 	/*
 	 * Initialize the shared buffer lookup hashtable.
 	 *
-	 * Since we can't tolerate running out of lookup table entries, we must be
-	 * sure to specify an adequate table size here.  The maximum steady-state
-	 * usage is of course NBuffers entries, but BufferAlloc() tries to insert
-	 * a new entry before deleting the old.  In principle this could be
-	 * happening in each partition concurrently, so we could need as many as
-	 * NBuffers + NUM_BUFFER_PARTITIONS entries.
+	 * The table has entries of its own for every buffer, so it can't run out
+	 * of them; the size only determines the number of hash buckets.  The
+	 * maximum steady-state usage is of course NBuffers entries, but
+	 * BufferAlloc() tries to insert a new entry before deleting the old.  In
+	 * principle this could be happening in each partition concurrently, so
+	 * there could be as many as NBuffers + NUM_BUFFER_PARTITIONS entries.
 	 */
 	InitBufTable(NBuffers + NUM_BUFFER_PARTITIONS);
 
@@ -493,34 +756,59 @@ StrategyInitialize(bool init)
 	 */
 	StrategyControl = (BufferStrategyControl *)
 		ShmemInitStruct("Buffer Strategy Status",
-						sizeof(BufferStrategyControl),
+						offsetof(BufferStrategyControl, partitions) +
+						npartitions * sizeof(BufferStrategyPartitionPadded),
 						&found);
 
 	if (!found)
 	{
+		int			partsize = NBuffers / npartitions;
+		int			i;
+
 		/*
 		 * Only done once, usually in postmaster
 		 */
 		Assert(init);
 
-		SpinLockInit(&StrategyControl->buffer_strategy_lock);
+		SpinLockInit(&StrategyControl->bgwriter_notify_lock);
 
-		/*
-		 * Grab the whole linked list of free buffers for our strategy. We
-		 * assume it was previously set up by InitBufferPool().
-		 */
-		StrategyControl->firstFreeBuffer = 0;
-		StrategyControl->lastFreeBuffer = NBuffers - 1;
+		/* No pending notification */
+		StrategyControl->bgwprocno = -1;
 
-		/* Initialize the clock sweep pointer */
-		pg_atomic_init_u32(&StrategyControl->nextVictimBuffer, 0);
+		StrategyControl->numPartitions = npartitions;
+		StrategyControl->numaNodes = StrategyNumaNodesFor(NBuffers);
 
-		/* Clear statistics */
-		StrategyControl->completePasses = 0;
-		pg_atomic_init_u32(&StrategyControl->numBufferAllocs, 0);
+		for (i = 0; i < npartitions; i++)
+		{
+			BufferStrategyPartition *part = &StrategyControl->partitions[i].part;
 
-		/* No pending notification */
-		StrategyControl->bgwprocno = -1;
+			SpinLockInit(&part->buffer_strategy_lock);
+
+			/* The last partition also gets the remainder */
+			part->firstBuffer = i * partsize;
+			if (i == npartitions - 1)
+				part->numBuffers = NBuffers - part->firstBuffer;
+			else
+				part->numBuffers = partsize;
+
+			/*
+			 * Grab this partition's part of the linked list of free buffers.
+			 * We assume the whole list was previously set up by
+			 * InitBufferPool(), in order of buffer id, so we just need to cut
+			 * it at the end of the partition.
+			 */
+			part->firstFreeBuffer = part->firstBuffer;
+			part->lastFreeBuffer = part->firstBuffer + part->numBuffers - 1;
+			GetBufferDescriptor(part->lastFreeBuffer)->freeNext =
+				FREENEXT_END_OF_LIST;
+
+			/* Initialize the clock sweep pointer */
+			pg_atomic_init_u32(&part->nextVictimBuffer, 0);
+
+			/* Clear statistics */
+			part->completePasses = 0;
+			pg_atomic_init_u32(&part->numBufferAllocs, 0);
+		}
 	}
 	else
 		Assert(!init);
@@ -601,6 +889,47 @@ FreeAccessStrategy(BufferAccessStrategy strategy)
 		pfree(strategy);
 }
 
+/*
+ * GetAccessStrategyBufferCount -- number of buffers in a strategy's ring
+ *
+ * Returns 0 for the "default" strategy, which has no ring.  Callers that pin
+ * several buffers at once, like read streams, use this to avoid pinning more
+ * buffers than the ring can supply.
+ */
+int
+GetAccessStrategyBufferCount(BufferAccessStrategy strategy)
+{
+	if (strategy == NULL)
+		return 0;
+
+	return strategy->ring_size;
+}
+
+/*
+ * IOContextForStrategy -- the IOContext that I/O done for a strategy is
+ *		counted under in pg_stat_io
+ */
+IOContext
+IOContextForStrategy(BufferAccessStrategy strategy)
+{
+	if (strategy == NULL)
+		return IOCONTEXT_NORMAL;
+
+	switch (strategy->btype)
+	{
+		case BAS_NORMAL:
+			break;
+		case BAS_BULKREAD:
+			return IOCONTEXT_BULKREAD;
+		case BAS_BULKWRITE:
+			return IOCONTEXT_BULKWRITE;
+		case BAS_VACUUM:
+			return IOCONTEXT_VACUUM;
+	}
+
+	return IOCONTEXT_NORMAL;
+}
+
 /*
  * GetBufferFromRing -- returns a buffer from the ring, or NULL if the
  *		ring is empty.
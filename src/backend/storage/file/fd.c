@@ -91,7 +91,9 @@
 #include "common/file_perm.h"
 #include "miscadmin.h"
 #include "pgstat.h"
+#include "port/pg_iovec.h"
 #include "portability/mem.h"
+#include "storage/aio.h"
 #include "storage/fd.h"
 #include "storage/ipc.h"
 #include "utils/guc.h"
@@ -156,6 +158,9 @@ int			max_safe_fds = FD_MINFREE;	/* default if not changed */
 /* Whether it is safe to continue running after fsync() fails. */
 bool		data_sync_retry = false;
 
+/* Which kinds of files are opened with O_DIRECT; set by the io_direct GUC */
+int			io_direct_flags;
+
 /* Debugging.... */
 
 #ifdef FDDEBUG
@@ -953,6 +958,13 @@ set_max_safe_fds(void)
 	count_usable_fds(max_files_per_process,
 					 &usable_fds, &already_open);
 
+	/*
+	 * Don't count descriptors that the postmaster holds only for its
+	 * children's benefit, such as every process's io_uring ring.  Children
+	 * close the ones they don't need, and reserve the others with fd.c.
+	 */
+	already_open -= pgaio_inherited_fds();
+
 	max_safe_fds = Min(usable_fds, max_files_per_process - already_open);
 
 	/*
@@ -1154,6 +1166,9 @@ LruDelete(File file)
 
 	vfdP = &VfdCache[file];
 
+	/* Don't close the kernel FD under an I/O that hasn't been submitted */
+	pgaio_closing_fd(vfdP->fd);
+
 	/*
 	 * Close the file.  We aren't expecting this to fail; if it does, better
 	 * to leak the FD than to mess up our internal state.
@@ -1834,6 +1849,8 @@ FileClose(File file)
 
 	if (!FileIsNotOpen(file))
 	{
+		pgaio_closing_fd(vfdP->fd);
+
 		/* close the file */
 		if (close(vfdP->fd) != 0)
 		{
@@ -1944,6 +1961,37 @@ FilePrefetch(File file, off_t offset, int amount, uint32 wait_event_info)
 #endif
 }
 
+/*
+ * FilePrepareReadV - prepare an asynchronous vectored read
+ *
+ * Defines a read at "offset" into the buffers described by "iov" in the I/O
+ * handle "ioh"; the read is started once the caller stages the handle.  As
+ * with FileReadV(), a negative result means the file could not be accessed,
+ * with errno set.  Errors of the read itself are reported through the I/O
+ * handle.
+ */
+int
+FilePrepareReadV(File file, const struct iovec *iov, int iovcnt, off_t offset,
+				 PgAioHandle *ioh)
+{
+	int			returnCode;
+
+	Assert(FileIsValid(file));
+
+	DO_DB(elog(LOG, "FilePrepareReadV: %d (%s) " INT64_FORMAT " %d",
+			   file, VfdCache[file].fileName,
+			   (int64) offset,
+			   iovcnt));
+
+	returnCode = FileAccess(file);
+	if (returnCode < 0)
+		return returnCode;
+
+	pgaio_io_prep_readv(ioh, VfdCache[file].fd, iov, iovcnt, offset);
+
+	return 0;
+}
+
 void
 FileWriteback(File file, off_t offset, off_t nbytes, uint32 wait_event_info)
 {
@@ -1970,16 +2018,33 @@ FileWriteback(File file, off_t offset, off_t nbytes, uint32 wait_event_info)
 int
 FileRead(File file, char *buffer, int amount, off_t offset,
 		 uint32 wait_event_info)
+{
+	struct iovec iov;
+
+	iov.iov_base = buffer;
+	iov.iov_len = amount;
+
+	return FileReadV(file, &iov, 1, offset, wait_event_info);
+}
+
+/*
+ * Read into several buffers from consecutive positions of a file, starting
+ * at "offset", with a single system call if possible.  Like FileRead(),
+ * returns the number of bytes read, which can be less than requested.
+ */
+int
+FileReadV(File file, const struct iovec *iov, int iovcnt, off_t offset,
+		  uint32 wait_event_info)
 {
 	int			returnCode;
 	Vfd		   *vfdP;
 
 	Assert(FileIsValid(file));
 
-	DO_DB(elog(LOG, "FileRead: %d (%s) " INT64_FORMAT " %d %p",
+	DO_DB(elog(LOG, "FileReadV: %d (%s) " INT64_FORMAT " %d",
 			   file, VfdCache[file].fileName,
 			   (int64) offset,
-			   amount, buffer));
+			   iovcnt));
 
 	returnCode = FileAccess(file);
 	if (returnCode < 0)
@@ -1989,7 +2054,7 @@ FileRead(File file, char *buffer, int amount, off_t offset,
 
 retry:
 	pgstat_report_wait_start(wait_event_info);
-	returnCode = pg_pread(vfdP->fd, buffer, amount, offset);
+	returnCode = pg_preadv(vfdP->fd, iov, iovcnt, offset);
 	pgstat_report_wait_end();
 
 	if (returnCode < 0)
@@ -2026,16 +2091,39 @@ retry:
 int
 FileWrite(File file, char *buffer, int amount, off_t offset,
 		  uint32 wait_event_info)
+{
+	struct iovec iov;
+
+	iov.iov_base = buffer;
+	iov.iov_len = amount;
+
+	return FileWriteV(file, &iov, 1, offset, wait_event_info);
+}
+
+/*
+ * Write from several buffers to consecutive positions of a file, starting at
+ * "offset", with a single system call if possible.  Like FileWrite(),
+ * returns the number of bytes written, which can be less than requested.
+ */
+int
+FileWriteV(File file, const struct iovec *iov, int iovcnt, off_t offset,
+		   uint32 wait_event_info)
 {
 	int			returnCode;
 	Vfd		   *vfdP;
+	int			amount;
+	int			i;
 
 	Assert(FileIsValid(file));
 
-	DO_DB(elog(LOG, "FileWrite: %d (%s) " INT64_FORMAT " %d %p",
+	DO_DB(elog(LOG, "FileWriteV: %d (%s) " INT64_FORMAT " %d",
 			   file, VfdCache[file].fileName,
 			   (int64) offset,
-			   amount, buffer));
+			   iovcnt));
+
+	amount = 0;
+	for (i = 0; i < iovcnt; i++)
+		amount += iov[i].iov_len;
 
 	returnCode = FileAccess(file);
 	if (returnCode < 0)
@@ -2071,7 +2159,7 @@ FileWrite(File file, char *buffer, int amount, off_t offset,
 retry:
 	errno = 0;
 	pgstat_report_wait_start(wait_event_info);
-	returnCode = pg_pwrite(VfdCache[file].fd, buffer, amount, offset);
+	returnCode = pg_pwritev(VfdCache[file].fd, iov, iovcnt, offset);
 	pgstat_report_wait_end();
 
 	/* if write didn't set errno, assume problem is no disk space */
@@ -118,6 +118,20 @@ static TransactionId latestObservedXid = InvalidTransactionId;
  */
 static TransactionId standbySnapshotPendingXmin;
 
+/*
+ * RecentXmin as of the last computation of RecentGlobalXmin by this backend.
+ * If RecentXmin has not advanced since, recomputing can't help.  It's kept as
+ * a FullTransactionId so that the lag can be measured even if the backend has
+ * been idle for more than 2^32 transactions.
+ */
+static FullTransactionId RecentGlobalXminLastXmin = {InvalidTransactionId};
+
+/*
+ * Recompute RecentGlobalXmin in GetSnapshotData() once our snapshots' xmin
+ * is this far ahead of it, to keep it well clear of XID wraparound.
+ */
+#define MAX_RECENT_GLOBAL_XMIN_LAG	(1U << 24)
+
 #ifdef XIDCACHE_DEBUG
 
 /* counters for XidCache measurement */
@@ -175,6 +189,9 @@ static void KnownAssignedXidsReset(void);
 static inline void ProcArrayEndTransactionInternal(PGPROC *proc,
 												   PGXACT *pgxact, TransactionId latestXid);
 static void ProcArrayGroupClearXid(PGPROC *proc, TransactionId latestXid);
+static bool GetSnapshotDataReuse(Snapshot snapshot);
+static void GetSnapshotDataInitNew(Snapshot snapshot);
+static FullTransactionId FullXidViaNextXid(TransactionId xid);
 
 /*
  * Report shared-memory space needed by CreateSharedProcArray.
@@ -249,6 +266,7 @@ CreateSharedProcArray(void)
 		procArray->lastOverflowedXid = InvalidTransactionId;
 		procArray->replication_slot_xmin = InvalidTransactionId;
 		procArray->replication_slot_catalog_xmin = InvalidTransactionId;
+		ShmemVariableCache->xactCompletionCount = 1;
 	}
 
 	allProcs = ProcGlobal->allProcs;
@@ -279,8 +297,15 @@ ProcArrayAdd(PGPROC *proc)
 {
 	ProcArrayStruct *arrayP = procArray;
 	int			index;
+	int			i;
 
+	/*
+	 * Adding an entry moves the entries of ProcGlobal->xids after it, which
+	 * requires holding XidGenLock too, since GetNewTransactionId() sets its
+	 * own entry while holding only that lock.
+	 */
 	LWLockAcquire(ProcArrayLock, LW_EXCLUSIVE);
+	LWLockAcquire(XidGenLock, LW_EXCLUSIVE);
 
 	if (arrayP->numProcs >= arrayP->maxProcs)
 	{
@@ -289,6 +314,7 @@ ProcArrayAdd(PGPROC *proc)
 		 * fixed supply of PGPROC structs too, and so we should have failed
 		 * earlier.)
 		 */
+		LWLockRelease(XidGenLock);
 		LWLockRelease(ProcArrayLock);
 		ereport(FATAL,
 				(errcode(ERRCODE_TOO_MANY_CONNECTIONS),
@@ -316,9 +342,17 @@ ProcArrayAdd(PGPROC *proc)
 
 	memmove(&arrayP->pgprocnos[index + 1], &arrayP->pgprocnos[index],
 			(arrayP->numProcs - index) * sizeof(int));
+	memmove(&ProcGlobal->xids[index + 1], &ProcGlobal->xids[index],
+			(arrayP->numProcs - index) * sizeof(TransactionId));
 	arrayP->pgprocnos[index] = proc->pgprocno;
+	ProcGlobal->xids[index] = allPgXact[proc->pgprocno].xid;
 	arrayP->numProcs++;
 
+	/* Adjust the array positions of the entries that moved */
+	for (i = index; i < arrayP->numProcs; i++)
+		allProcs[arrayP->pgprocnos[i]].pgxactoff = i;
+
+	LWLockRelease(XidGenLock);
 	LWLockRelease(ProcArrayLock);
 }
 
@@ -337,6 +371,7 @@ ProcArrayRemove(PGPROC *proc, TransactionId latestXid)
 {
 	ProcArrayStruct *arrayP = procArray;
 	int			index;
+	int			i;
 
 #ifdef XIDCACHE_DEBUG
 	/* dump stats at backend shutdown, but not prepared-xact end */
@@ -344,7 +379,9 @@ ProcArrayRemove(PGPROC *proc, TransactionId latestXid)
 		DisplayXidCache();
 #endif
 
+	/* See ProcArrayAdd() for why XidGenLock is needed */
 	LWLockAcquire(ProcArrayLock, LW_EXCLUSIVE);
+	LWLockAcquire(XidGenLock, LW_EXCLUSIVE);
 
 	if (TransactionIdIsValid(latestXid))
 	{
@@ -354,6 +391,9 @@ ProcArrayRemove(PGPROC *proc, TransactionId latestXid)
 		if (TransactionIdPrecedes(ShmemVariableCache->latestCompletedXid,
 								  latestXid))
 			ShmemVariableCache->latestCompletedXid = latestXid;
+
+		/* The set of running transactions changed, invalidate snapshots */
+		ShmemVariableCache->xactCompletionCount++;
 	}
 	else
 	{
@@ -368,14 +408,25 @@ ProcArrayRemove(PGPROC *proc, TransactionId latestXid)
 			/* Keep the PGPROC array sorted. See notes above */
 			memmove(&arrayP->pgprocnos[index], &arrayP->pgprocnos[index + 1],
 					(arrayP->numProcs - index - 1) * sizeof(int));
+			memmove(&ProcGlobal->xids[index], &ProcGlobal->xids[index + 1],
+					(arrayP->numProcs - index - 1) * sizeof(TransactionId));
 			arrayP->pgprocnos[arrayP->numProcs - 1] = -1;	/* for debugging */
+			ProcGlobal->xids[arrayP->numProcs - 1] = InvalidTransactionId;
 			arrayP->numProcs--;
+
+			/* Adjust the array positions of the entries that moved */
+			for (i = index; i < arrayP->numProcs; i++)
+				allProcs[arrayP->pgprocnos[i]].pgxactoff = i;
+			proc->pgxactoff = -1;
+
+			LWLockRelease(XidGenLock);
 			LWLockRelease(ProcArrayLock);
 			return;
 		}
 	}
 
 	/* Oops */
+	LWLockRelease(XidGenLock);
 	LWLockRelease(ProcArrayLock);
 
 	elog(LOG, "failed to find proc %p in ProcArray", proc);
@@ -454,6 +505,7 @@ ProcArrayEndTransactionInternal(PGPROC *proc, PGXACT *pgxact,
 								TransactionId latestXid)
 {
 	pgxact->xid = InvalidTransactionId;
+	ProcGlobal->xids[proc->pgxactoff] = InvalidTransactionId;
 	proc->lxid = InvalidLocalTransactionId;
 	pgxact->xmin = InvalidTransactionId;
 	/* must be cleared with xid/xmin: */
@@ -469,6 +521,9 @@ ProcArrayEndTransactionInternal(PGPROC *proc, PGXACT *pgxact,
 	if (TransactionIdPrecedes(ShmemVariableCache->latestCompletedXid,
 							  latestXid))
 		ShmemVariableCache->latestCompletedXid = latestXid;
+
+	/* Snapshots computed before this point no longer are current */
+	ShmemVariableCache->xactCompletionCount++;
 }
 
 /*
@@ -604,12 +659,19 @@ ProcArrayClearTransaction(PGPROC *proc)
 	PGXACT	   *pgxact = &allPgXact[proc->pgprocno];
 
 	/*
-	 * We can skip locking ProcArrayLock here, because this action does not
-	 * actually change anyone's view of the set of running XIDs: our entry is
-	 * duplicate with the gxact that has already been inserted into the
-	 * ProcArray.
+	 * This action does not actually change anyone else's view of the set of
+	 * running XIDs: our entry is duplicate with the gxact that has already
+	 * been inserted into the ProcArray.  But a snapshot never contains its
+	 * own backend's XID, so a snapshot we computed earlier must not be
+	 * reused: it would not show the prepared transaction as running.  Hence
+	 * we take ProcArrayLock to advance xactCompletionCount.
 	 */
+	LWLockAcquire(ProcArrayLock, LW_EXCLUSIVE);
+
 	pgxact->xid = InvalidTransactionId;
+	ProcGlobal->xids[proc->pgxactoff] = InvalidTransactionId;
+	ShmemVariableCache->xactCompletionCount++;
+
 	proc->lxid = InvalidLocalTransactionId;
 	pgxact->xmin = InvalidTransactionId;
 	proc->recoveryConflictPending = false;
@@ -621,6 +683,8 @@ ProcArrayClearTransaction(PGPROC *proc)
 	/* Clear the subtransaction-XID cache too */
 	pgxact->nxids = 0;
 	pgxact->overflowed = false;
+
+	LWLockRelease(ProcArrayLock);
 }
 
 /*
@@ -878,6 +942,8 @@ ProcArrayApplyRecoveryInfo(RunningTransactions running)
 
 	Assert(TransactionIdIsNormal(ShmemVariableCache->latestCompletedXid));
 
+	ShmemVariableCache->xactCompletionCount++;
+
 	LWLockRelease(ProcArrayLock);
 
 	/* ShmemVariableCache->nextFullXid must be beyond any observed xid. */
@@ -955,6 +1021,9 @@ ProcArrayApplyXidAssignment(TransactionId topxid,
 	if (TransactionIdPrecedes(procArray->lastOverflowedXid, max_xid))
 		procArray->lastOverflowedXid = max_xid;
 
+	/* Snapshots' suboverflowed state may have changed */
+	ShmemVariableCache->xactCompletionCount++;
+
 	LWLockRelease(ProcArrayLock);
 }
 
@@ -1487,17 +1556,23 @@ GetMaxSnapshotSubxidCount(void)
  * *may* need to be done to determine what's running (see XidInMVCCSnapshot()
  * in heapam_visibility.c).
  *
+ * Only backends with an assigned XID are of interest here, so we scan the
+ * dense ProcGlobal->xids array rather than every PGXACT; the cost of a
+ * snapshot thus does not grow with the number of idle connections.  If no
+ * transaction has ended since the given snapshot was last filled in by this
+ * function, its contents are still correct and are reused as they are (see
+ * GetSnapshotDataReuse).
+ *
  * We also update the following backend-global variables:
  *		TransactionXmin: the oldest xmin of any snapshot in use in the
  *			current transaction (this is the same as MyPgXact->xmin).
  *		RecentXmin: the xmin computed for the most recent snapshot.  XIDs
  *			older than this are known not running any more.
- *		RecentGlobalXmin: the global xmin (oldest TransactionXmin across all
- *			running transactions, except those running LAZY VACUUM).  This is
- *			the same computation done by
- *			GetOldestXmin(NULL, PROCARRAY_FLAGS_VACUUM).
- *		RecentGlobalDataXmin: the global xmin for non-catalog tables
- *			>= RecentGlobalXmin
+ *
+ * RecentGlobalXmin and RecentGlobalDataXmin are no longer computed here,
+ * since that requires looking at the xmin of every backend.  They are
+ * computed by the first snapshot of a backend and afterwards only when
+ * somebody needs a more recent value, see UpdateRecentGlobalXmin().
  *
  * Note: this function should probably not be called with an argument that's
  * not statically allocated (see xip allocation below).
@@ -1508,13 +1583,11 @@ GetSnapshotData(Snapshot snapshot)
 	ProcArrayStruct *arrayP = procArray;
 	TransactionId xmin;
 	TransactionId xmax;
-	TransactionId globalxmin;
 	int			index;
 	int			count = 0;
 	int			subcount = 0;
 	bool		suboverflowed = false;
-	TransactionId replication_slot_xmin = InvalidTransactionId;
-	TransactionId replication_slot_catalog_xmin = InvalidTransactionId;
+	uint64		curXactCompletionCount;
 
 	Assert(snapshot != NULL);
 
@@ -1556,49 +1629,44 @@ GetSnapshotData(Snapshot snapshot)
 	 */
 	LWLockAcquire(ProcArrayLock, LW_SHARED);
 
+	if (GetSnapshotDataReuse(snapshot))
+	{
+		LWLockRelease(ProcArrayLock);
+		return snapshot;
+	}
+
+	curXactCompletionCount = ShmemVariableCache->xactCompletionCount;
+
 	/* xmax is always latestCompletedXid + 1 */
 	xmax = ShmemVariableCache->latestCompletedXid;
 	Assert(TransactionIdIsNormal(xmax));
 	TransactionIdAdvance(xmax);
 
 	/* initialize xmin calculation with xmax */
-	globalxmin = xmin = xmax;
+	xmin = xmax;
 
 	snapshot->takenDuringRecovery = RecoveryInProgress();
 
 	if (!snapshot->takenDuringRecovery)
 	{
 		int		   *pgprocnos = arrayP->pgprocnos;
+		TransactionId *xids = ProcGlobal->xids;
 		int			numProcs;
+		int			mypgxactoff = MyProc->pgxactoff;
 
 		/*
-		 * Spin over procArray checking xid, xmin, and subxids.  The goal is
-		 * to gather all active xids, find the lowest xmin, and try to record
-		 * subxids.
+		 * Spin over the dense xids array, which has one entry for each
+		 * procArray member.  The goal is to gather all active xids, find the
+		 * lowest one, and try to record subxids.  Only entries with an XID
+		 * assigned require looking at the corresponding PGXACT.
 		 */
 		numProcs = arrayP->numProcs;
 		for (index = 0; index < numProcs; index++)
 		{
-			int			pgprocno = pgprocnos[index];
-			PGXACT	   *pgxact = &allPgXact[pgprocno];
-			TransactionId xid;
-
-			/*
-			 * Skip over backends doing logical decoding which manages xmin
-			 * separately (check below) and ones running LAZY VACUUM.
-			 */
-			if (pgxact->vacuumFlags &
-				(PROC_IN_LOGICAL_DECODING | PROC_IN_VACUUM))
-				continue;
-
-			/* Update globalxmin to be the smallest valid xmin */
-			xid = UINT32_ACCESS_ONCE(pgxact->xmin);
-			if (TransactionIdIsNormal(xid) &&
-				NormalTransactionIdPrecedes(xid, globalxmin))
-				globalxmin = xid;
-
 			/* Fetch xid just once - see GetNewTransactionId */
-			xid = UINT32_ACCESS_ONCE(pgxact->xid);
+			TransactionId xid = UINT32_ACCESS_ONCE(xids[index]);
+			int			pgprocno;
+			PGXACT	   *pgxact;
 
 			/*
 			 * If the transaction has no XID assigned, we can skip it; it
@@ -1606,17 +1674,28 @@ GetSnapshotData(Snapshot snapshot)
 			 * skip it; such transactions will be treated as running anyway
 			 * (and any sub-XIDs will also be >= xmax).
 			 */
-			if (!TransactionIdIsNormal(xid)
+			if (likely(!TransactionIdIsNormal(xid))
 				|| !NormalTransactionIdPrecedes(xid, xmax))
 				continue;
 
+			pgprocno = pgprocnos[index];
+			pgxact = &allPgXact[pgprocno];
+
+			/*
+			 * Skip over backends doing logical decoding which manages xmin
+			 * separately and ones running LAZY VACUUM.
+			 */
+			if (pgxact->vacuumFlags &
+				(PROC_IN_LOGICAL_DECODING | PROC_IN_VACUUM))
+				continue;
+
 			/*
 			 * We don't include our own XIDs (if any) in the snapshot, but we
 			 * must include them in xmin.
 			 */
 			if (NormalTransactionIdPrecedes(xid, xmin))
 				xmin = xid;
-			if (pgxact == MyPgXact)
+			if (index == mypgxactoff)
 				continue;
 
 			/* Add XID to snapshot. */
@@ -1699,48 +1778,11 @@ GetSnapshotData(Snapshot snapshot)
 	}
 
 
-	/*
-	 * Fetch into local variable while ProcArrayLock is held - the
-	 * LWLockRelease below is a barrier, ensuring this happens inside the
-	 * lock.
-	 */
-	replication_slot_xmin = procArray->replication_slot_xmin;
-	replication_slot_catalog_xmin = procArray->replication_slot_catalog_xmin;
-
 	if (!TransactionIdIsValid(MyPgXact->xmin))
 		MyPgXact->xmin = TransactionXmin = xmin;
 
 	LWLockRelease(ProcArrayLock);
 
-	/*
-	 * Update globalxmin to include actual process xids.  This is a slightly
-	 * different way of computing it than GetOldestXmin uses, but should give
-	 * the same result.
-	 */
-	if (TransactionIdPrecedes(xmin, globalxmin))
-		globalxmin = xmin;
-
-	/* Update global variables too */
-	RecentGlobalXmin = globalxmin - vacuum_defer_cleanup_age;
-	if (!TransactionIdIsNormal(RecentGlobalXmin))
-		RecentGlobalXmin = FirstNormalTransactionId;
-
-	/* Check whether there's a replication slot requiring an older xmin. */
-	if (TransactionIdIsValid(replication_slot_xmin) &&
-		NormalTransactionIdPrecedes(replication_slot_xmin, RecentGlobalXmin))
-		RecentGlobalXmin = replication_slot_xmin;
-
-	/* Non-catalog tables can be vacuumed if older than this xid */
-	RecentGlobalDataXmin = RecentGlobalXmin;
-
-	/*
-	 * Check whether there's a replication slot requiring an older catalog
-	 * xmin.
-	 */
-	if (TransactionIdIsNormal(replication_slot_catalog_xmin) &&
-		NormalTransactionIdPrecedes(replication_slot_catalog_xmin, RecentGlobalXmin))
-		RecentGlobalXmin = replication_slot_catalog_xmin;
-
 	RecentXmin = xmin;
 
 	snapshot->xmin = xmin;
@@ -1748,7 +1790,31 @@ GetSnapshotData(Snapshot snapshot)
 	snapshot->xcnt = count;
 	snapshot->subxcnt = subcount;
 	snapshot->suboverflowed = suboverflowed;
+	snapshot->snapXactCompletionCount = curXactCompletionCount;
+
+	GetSnapshotDataInitNew(snapshot);
+
+	/*
+	 * The horizons are computed when this backend takes its first snapshot,
+	 * and refreshed when they have fallen far behind, so that they never get
+	 * close to wrapping around.  Otherwise they're only recomputed on demand.
+	 */
+	if (!TransactionIdIsValid(RecentGlobalXmin) ||
+		U64FromFullTransactionId(FullXidViaNextXid(xmin)) -
+		U64FromFullTransactionId(RecentGlobalXminLastXmin) >
+		MAX_RECENT_GLOBAL_XMIN_LAG)
+		UpdateRecentGlobalXmin();
 
+	return snapshot;
+}
+
+/*
+ * Fill in the parts of a snapshot returned by GetSnapshotData() that are
+ * not determined by the set of running transactions.
+ */
+static void
+GetSnapshotDataInitNew(Snapshot snapshot)
+{
 	snapshot->curcid = GetCurrentCommandId(false);
 
 	/*
@@ -1777,10 +1843,218 @@ GetSnapshotData(Snapshot snapshot)
 		 */
 		snapshot->lsn = GetXLogInsertRecPtr();
 		snapshot->whenTaken = GetSnapshotCurrentTimestamp();
-		MaintainOldSnapshotTimeMapping(snapshot->whenTaken, xmin);
+		MaintainOldSnapshotTimeMapping(snapshot->whenTaken, snapshot->xmin);
 	}
+}
 
-	return snapshot;
+/*
+ * GetSnapshotDataReuse -- try to reuse the previous contents of a snapshot
+ *
+ * If no transaction has ended since the snapshot was last computed by
+ * GetSnapshotData(), as indicated by ShmemVariableCache->xactCompletionCount,
+ * its xmin, xmax and lists of running XIDs are still accurate.  A newly
+ * assigned XID can't be in the snapshot, but it is above the snapshot's xmax
+ * and so is treated as running anyway.  Reusing the snapshot avoids scanning
+ * the ProcArray, and the cost of copying the XIDs.
+ *
+ * Caller must hold ProcArrayLock.  Returns true if the snapshot was reused.
+ */
+static bool
+GetSnapshotDataReuse(Snapshot snapshot)
+{
+	Assert(LWLockHeldByMe(ProcArrayLock));
+
+	if (unlikely(snapshot->snapXactCompletionCount == 0))
+		return false;
+
+	if (snapshot->snapXactCompletionCount !=
+		ShmemVariableCache->xactCompletionCount)
+		return false;
+
+	/* A snapshot taken in recovery has its XIDs in a different format */
+	if (snapshot->takenDuringRecovery != RecoveryInProgress())
+		return false;
+
+	/*
+	 * If the snapshot's xmin is still the oldest running XID it is safe to
+	 * advertise it as our xmin: nothing older than it can have been removed,
+	 * as all the transactions it considers running still are, and they hold
+	 * back everybody's horizons.  As in GetSnapshotData(), a shared lock
+	 * suffices for that.
+	 */
+	if (!TransactionIdIsValid(MyPgXact->xmin))
+		MyPgXact->xmin = TransactionXmin = snapshot->xmin;
+
+	RecentXmin = snapshot->xmin;
+
+	GetSnapshotDataInitNew(snapshot);
+
+	return true;
+}
+
+/*
+ * Convert xid to a FullTransactionId, using the epoch of the next XID to be
+ * assigned.  xid must be one we've seen in a snapshot, so it can't follow the
+ * next XID nor be more than 2^31 behind it.
+ */
+static FullTransactionId
+FullXidViaNextXid(TransactionId xid)
+{
+	FullTransactionId nextXid;
+	uint32		epoch;
+
+#ifdef PG_HAVE_8BYTE_SINGLE_COPY_ATOMICITY
+	/*
+	 * Avoid XidGenLock where a 64-bit read can't be torn.  The value can't be
+	 * older than xid: it was advanced before xid could appear in any snapshot.
+	 */
+	nextXid.value = *(volatile uint64 *) &ShmemVariableCache->nextFullXid.value;
+#else
+	nextXid = ReadNextFullTransactionId();
+#endif
+
+	epoch = EpochFromFullTransactionId(nextXid);
+	if (xid > XidFromFullTransactionId(nextXid))
+		epoch--;
+
+	return FullTransactionIdFromEpochAndXid(epoch, xid);
+}
+
+/*
+ * UpdateRecentGlobalXmin -- recompute RecentGlobalXmin and RecentGlobalDataXmin
+ *
+ * RecentGlobalXmin is the global xmin (oldest TransactionXmin across all
+ * running transactions, except those running LAZY VACUUM).  This is the same
+ * computation done by GetOldestXmin(NULL, PROCARRAY_FLAGS_VACUUM).
+ * RecentGlobalDataXmin is the global xmin for non-catalog tables, and is
+ * >= RecentGlobalXmin.
+ *
+ * This requires looking at the xmin of every backend, which is why
+ * GetSnapshotData() does not do it every time.  Values computed earlier are
+ * still correct, if conservative, lower bounds.
+ */
+void
+UpdateRecentGlobalXmin(void)
+{
+	ProcArrayStruct *arrayP = procArray;
+	TransactionId globalxmin;
+	TransactionId replication_slot_xmin;
+	TransactionId replication_slot_catalog_xmin;
+	int			index;
+
+	LWLockAcquire(ProcArrayLock, LW_SHARED);
+
+	/* initialize with latestCompletedXid + 1, which is the current xmax */
+	globalxmin = ShmemVariableCache->latestCompletedXid;
+	Assert(TransactionIdIsNormal(globalxmin));
+	TransactionIdAdvance(globalxmin);
+
+	for (index = 0; index < arrayP->numProcs; index++)
+	{
+		int			pgprocno = arrayP->pgprocnos[index];
+		PGXACT	   *pgxact = &allPgXact[pgprocno];
+		TransactionId xid;
+
+		/*
+		 * Skip over backends doing logical decoding which manages xmin
+		 * separately (check below) and ones running LAZY VACUUM.
+		 */
+		if (pgxact->vacuumFlags &
+			(PROC_IN_LOGICAL_DECODING | PROC_IN_VACUUM))
+			continue;
+
+		/* Update globalxmin to be the smallest valid xmin */
+		xid = UINT32_ACCESS_ONCE(pgxact->xmin);
+		if (TransactionIdIsNormal(xid) &&
+			NormalTransactionIdPrecedes(xid, globalxmin))
+			globalxmin = xid;
+
+		/* Also include the XIDs of running transactions */
+		xid = UINT32_ACCESS_ONCE(pgxact->xid);
+		if (TransactionIdIsNormal(xid) &&
+			NormalTransactionIdPrecedes(xid, globalxmin))
+			globalxmin = xid;
+	}
+
+	/* In recovery, the running XIDs are tracked in KnownAssignedXids */
+	if (RecoveryInProgress())
+	{
+		TransactionId kaxmin = KnownAssignedXidsGetOldestXmin();
+
+		if (TransactionIdIsNormal(kaxmin) &&
+			NormalTransactionIdPrecedes(kaxmin, globalxmin))
+			globalxmin = kaxmin;
+	}
+
+	/*
+	 * Fetch into local variable while ProcArrayLock is held - the
+	 * LWLockRelease below is a barrier, ensuring this happens inside the
+	 * lock.
+	 */
+	replication_slot_xmin = procArray->replication_slot_xmin;
+	replication_slot_catalog_xmin = procArray->replication_slot_catalog_xmin;
+
+	LWLockRelease(ProcArrayLock);
+
+	/* Our own snapshots must not be affected */
+	if (TransactionIdIsValid(RecentXmin) &&
+		TransactionIdPrecedes(RecentXmin, globalxmin))
+		globalxmin = RecentXmin;
+
+	RecentGlobalXmin = globalxmin - vacuum_defer_cleanup_age;
+	if (!TransactionIdIsNormal(RecentGlobalXmin))
+		RecentGlobalXmin = FirstNormalTransactionId;
+
+	/* Check whether there's a replication slot requiring an older xmin. */
+	if (TransactionIdIsValid(replication_slot_xmin) &&
+		NormalTransactionIdPrecedes(replication_slot_xmin, RecentGlobalXmin))
+		RecentGlobalXmin = replication_slot_xmin;
+
+	/* Non-catalog tables can be vacuumed if older than this xid */
+	RecentGlobalDataXmin = RecentGlobalXmin;
+
+	/*
+	 * Check whether there's a replication slot requiring an older catalog
+	 * xmin.
+	 */
+	if (TransactionIdIsNormal(replication_slot_catalog_xmin) &&
+		NormalTransactionIdPrecedes(replication_slot_catalog_xmin, RecentGlobalXmin))
+		RecentGlobalXmin = replication_slot_catalog_xmin;
+
+	if (TransactionIdIsValid(RecentXmin))
+		RecentGlobalXminLastXmin = FullXidViaNextXid(RecentXmin);
+	else
+		RecentGlobalXminLastXmin = InvalidFullTransactionId;
+}
+
+/*
+ * MaybeUpdateRecentGlobalXmin -- refresh the horizons if that could help
+ *
+ * Callers about to test whether xid precedes RecentGlobalXmin (or
+ * RecentGlobalDataXmin), e.g. to decide whether it is worth pruning a page,
+ * call this first.  The horizons are only recomputed if the answer could
+ * change: xid must not already precede them, and must be older than
+ * RecentXmin, which has to have advanced since they were last computed.
+ */
+void
+MaybeUpdateRecentGlobalXmin(TransactionId xid)
+{
+	if (!TransactionIdIsValid(RecentGlobalXmin))
+	{
+		UpdateRecentGlobalXmin();
+		return;
+	}
+
+	if (!TransactionIdIsNormal(xid) ||
+		TransactionIdPrecedes(xid, RecentGlobalXmin))
+		return;
+
+	if (!TransactionIdIsValid(RecentXmin) ||
+		!TransactionIdPrecedes(xid, RecentXmin) ||
+		XidFromFullTransactionId(RecentGlobalXminLastXmin) == RecentXmin)
+		return;
+
+	UpdateRecentGlobalXmin();
 }
 
 /*
@@ -3213,6 +3487,9 @@ XidCacheRemoveRunningXids(TransactionId xid,
 							  latestXid))
 		ShmemVariableCache->latestCompletedXid = latestXid;
 
+	/* The aborted subtransactions are no longer running */
+	ShmemVariableCache->xactCompletionCount++;
+
 	LWLockRelease(ProcArrayLock);
 }
 
@@ -3394,6 +3671,8 @@ ExpireTreeKnownAssignedTransactionIds(TransactionId xid, int nsubxids,
 							  max_xid))
 		ShmemVariableCache->latestCompletedXid = max_xid;
 
+	ShmemVariableCache->xactCompletionCount++;
+
 	LWLockRelease(ProcArrayLock);
 }
 
@@ -3406,6 +3685,7 @@ ExpireAllKnownAssignedTransactionIds(void)
 {
 	LWLockAcquire(ProcArrayLock, LW_EXCLUSIVE);
 	KnownAssignedXidsRemovePreceding(InvalidTransactionId);
+	ShmemVariableCache->xactCompletionCount++;
 	LWLockRelease(ProcArrayLock);
 }
 
@@ -3418,6 +3698,7 @@ ExpireOldKnownAssignedTransactionIds(TransactionId xid)
 {
 	LWLockAcquire(ProcArrayLock, LW_EXCLUSIVE);
 	KnownAssignedXidsRemovePreceding(xid);
+	ShmemVariableCache->xactCompletionCount++;
 	LWLockRelease(ProcArrayLock);
 }
 
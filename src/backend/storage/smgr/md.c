@@ -31,6 +31,7 @@
 #include "miscadmin.h"
 #include "pg_trace.h"
 #include "pgstat.h"
+#include "port/pg_iovec.h"
 #include "postmaster/bgwriter.h"
 #include "storage/bufmgr.h"
 #include "storage/fd.h"
@@ -87,6 +88,12 @@ typedef struct _MdfdVec
 
 static MemoryContext MdCxt;		/* context for all MdfdVec objects */
 
+/*
+ * Bounce buffer for direct I/O, see md_io_buffers().  Allocated in MdCxt on
+ * first use, and aligned to PG_IO_ALIGN_SIZE.
+ */
+static char *md_bounce_buffer = NULL;
+
 
 /* Populate a file tag describing an md.c segment file. */
 #define INIT_MD_FILETAG(a,xx_rnode,xx_forknum,xx_segno) \
@@ -141,6 +148,58 @@ static BlockNumber _mdnblocks(SMgrRelation reln, ForkNumber forknum,
 							  MdfdVec *seg);
 
 
+/* Flags for opening the segment files of a relation */
+static inline int
+_mdfd_open_flags(void)
+{
+	int			flags = O_RDWR | PG_BINARY;
+
+	if (io_direct_flags & IO_DIRECT_DATA)
+		flags |= PG_O_DIRECT;
+
+	return flags;
+}
+
+/*
+ * Determine the buffers to transfer "nblocks" blocks from or to.
+ *
+ * With io_direct=data, the kernel requires I/O buffers to be aligned to
+ * PG_IO_ALIGN_SIZE.  Shared and local buffers always are, but pages that
+ * callers build in their own memory, for example during index builds, might
+ * not be.  Those are transferred through a bounce buffer instead, and
+ * iobuffers[i] differs from buffers[i].  Returns true if any block needs
+ * the bounce buffer.
+ */
+static bool
+md_io_buffers(char **iobuffers, char **buffers, int nblocks)
+{
+	bool		bounce = false;
+	int			i;
+
+	Assert(nblocks <= PG_IOV_MAX);
+
+	for (i = 0; i < nblocks; i++)
+	{
+		if ((io_direct_flags & IO_DIRECT_DATA) &&
+			(uintptr_t) buffers[i] != TYPEALIGN(PG_IO_ALIGN_SIZE, buffers[i]))
+		{
+			if (md_bounce_buffer == NULL)
+				md_bounce_buffer = (char *)
+					TYPEALIGN(PG_IO_ALIGN_SIZE,
+							  MemoryContextAlloc(MdCxt,
+												 PG_IOV_MAX * BLCKSZ +
+												 PG_IO_ALIGN_SIZE));
+			iobuffers[i] = md_bounce_buffer + i * BLCKSZ;
+			bounce = true;
+		}
+		else
+			iobuffers[i] = buffers[i];
+	}
+
+	return bounce;
+}
+
+
 /*
  *	mdinit() -- Initialize private state for magnetic disk storage manager.
  */
@@ -201,14 +260,14 @@ mdcreate(SMgrRelation reln, ForkNumber forkNum, bool isRedo)
 
 	path = relpath(reln->smgr_rnode, forkNum);
 
-	fd = PathNameOpenFile(path, O_RDWR | O_CREAT | O_EXCL | PG_BINARY);
+	fd = PathNameOpenFile(path, _mdfd_open_flags() | O_CREAT | O_EXCL);
 
 	if (fd < 0)
 	{
 		int			save_errno = errno;
 
 		if (isRedo)
-			fd = PathNameOpenFile(path, O_RDWR | PG_BINARY);
+			fd = PathNameOpenFile(path, _mdfd_open_flags());
 		if (fd < 0)
 		{
 			/* be sure to report the error reported by create, not open */
@@ -377,7 +436,7 @@ mdunlinkfork(RelFileNodeBackend rnode, ForkNumber forkNum, bool isRedo)
 /*
  *	mdextend() -- Add a block to the specified relation.
  *
- *		The semantics are nearly the same as mdwrite(): write at the
+ *		The semantics are nearly the same as mdwritev(): write at the
  *		specified position.  However, this is to be used for the case of
  *		extending a relation (i.e., blocknum is at or beyond the current
  *		EOF).  Note that we assume writing a block beyond current EOF
@@ -390,6 +449,7 @@ mdextend(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
 	off_t		seekpos;
 	int			nbytes;
 	MdfdVec    *v;
+	char	   *iobuffer;
 
 	/* This assert is too expensive to have on normally ... */
 #ifdef CHECK_WRITE_VS_EXTEND
@@ -414,7 +474,10 @@ mdextend(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
 
 	Assert(seekpos < (off_t) BLCKSZ * RELSEG_SIZE);
 
-	if ((nbytes = FileWrite(v->mdfd_vfd, buffer, BLCKSZ, seekpos, WAIT_EVENT_DATA_FILE_EXTEND)) != BLCKSZ)
+	if (md_io_buffers(&iobuffer, &buffer, 1))
+		memcpy(iobuffer, buffer, BLCKSZ);
+
+	if ((nbytes = FileWrite(v->mdfd_vfd, iobuffer, BLCKSZ, seekpos, WAIT_EVENT_DATA_FILE_EXTEND)) != BLCKSZ)
 	{
 		if (nbytes < 0)
 			ereport(ERROR,
@@ -460,7 +523,7 @@ mdopenfork(SMgrRelation reln, ForkNumber forknum, int behavior)
 
 	path = relpath(reln->smgr_rnode, forknum);
 
-	fd = PathNameOpenFile(path, O_RDWR | PG_BINARY);
+	fd = PathNameOpenFile(path, _mdfd_open_flags());
 
 	if (fd < 0)
 	{
@@ -540,7 +603,10 @@ mdprefetch(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum)
 
 	Assert(seekpos < (off_t) BLCKSZ * RELSEG_SIZE);
 
-	(void) FilePrefetch(v->mdfd_vfd, seekpos, BLCKSZ, WAIT_EVENT_DATA_FILE_PREFETCH);
+	/* with direct I/O, the kernel has no cache to read the block into */
+	if ((io_direct_flags & IO_DIRECT_DATA) == 0)
+		(void) FilePrefetch(v->mdfd_vfd, seekpos, BLCKSZ,
+							WAIT_EVENT_DATA_FILE_PREFETCH);
 #endif							/* USE_PREFETCH */
 
 	return true;
@@ -556,6 +622,10 @@ void
 mdwriteback(SMgrRelation reln, ForkNumber forknum,
 			BlockNumber blocknum, BlockNumber nblocks)
 {
+	/* with direct I/O, there are no dirty pages in the kernel to flush */
+	if (io_direct_flags & IO_DIRECT_DATA)
+		return;
+
 	/*
 	 * Issue flush requests in as few requests as possible; have to split at
 	 * segment boundaries though, since those are actually separate files.
@@ -599,21 +669,235 @@ mdwriteback(SMgrRelation reln, ForkNumber forknum,
 }
 
 /*
- *	mdread() -- Read the specified block from a relation.
+ * Fill in iovecs for reading or writing "nblocks" blocks from or to the given
+ * buffers.  Buffers that happen to be adjacent in memory are combined into a
+ * single iovec.  Returns the number of iovecs used.
+ */
+static int
+buffers_to_iovec(struct iovec *iov, char **buffers, int nblocks)
+{
+	int			iovcnt;
+	int			i;
+
+	Assert(nblocks >= 1);
+
+	iov[0].iov_base = buffers[0];
+	iov[0].iov_len = BLCKSZ;
+	iovcnt = 1;
+
+	for (i = 1; i < nblocks; i++)
+	{
+		struct iovec *prev = &iov[iovcnt - 1];
+
+		if ((char *) prev->iov_base + prev->iov_len == buffers[i])
+			prev->iov_len += BLCKSZ;
+		else
+		{
+			iov[iovcnt].iov_base = buffers[i];
+			iov[iovcnt].iov_len = BLCKSZ;
+			iovcnt++;
+		}
+	}
+
+	return iovcnt;
+}
+
+/*
+ * Adjust the iovecs for a partial transfer of "transferred" bytes, so that
+ * they describe the part that is still to be done.  Returns the number of
+ * iovecs left.
+ */
+static int
+compute_remaining_iovec(struct iovec *iov, int iovcnt, size_t transferred)
+{
+	int			skip = 0;
+	int			i;
+
+	/* skip the iovecs that were transferred completely */
+	while (skip < iovcnt && transferred >= iov[skip].iov_len)
+	{
+		transferred -= iov[skip].iov_len;
+		skip++;
+	}
+
+	for (i = skip; i < iovcnt; i++)
+		iov[i - skip] = iov[i];
+	iovcnt -= skip;
+
+	if (iovcnt > 0)
+	{
+		iov[0].iov_base = (char *) iov[0].iov_base + transferred;
+		iov[0].iov_len -= transferred;
+	}
+
+	return iovcnt;
+}
+
+/*
+ *	mdreadv() -- Read the specified blocks from a relation.
+ *
+ *		Reads "nblocks" consecutive blocks, starting at "blocknum", into the
+ *		given buffers, using as few system calls as possible.  A run of
+ *		blocks that crosses a segment boundary is read with one call per
+ *		segment.
+ */
+void
+mdreadv(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
+		char **buffers, BlockNumber nblocks)
+{
+	while (nblocks > 0)
+	{
+		struct iovec iov[PG_IOV_MAX];
+		char	   *iobuffers[PG_IOV_MAX];
+		bool		bounce;
+		int			iovcnt;
+		off_t		seekpos;
+		int			nbytes;
+		MdfdVec    *v;
+		BlockNumber nblocks_this_segment;
+		BlockNumber i;
+		size_t		transferred_this_segment;
+		size_t		size_this_segment;
+
+		v = _mdfd_getseg(reln, forknum, blocknum, false,
+						 EXTENSION_FAIL | EXTENSION_CREATE_RECOVERY);
+
+		seekpos = (off_t) BLCKSZ * (blocknum % ((BlockNumber) RELSEG_SIZE));
+
+		Assert(seekpos < (off_t) BLCKSZ * RELSEG_SIZE);
+
+		nblocks_this_segment =
+			Min(nblocks,
+				RELSEG_SIZE - (blocknum % ((BlockNumber) RELSEG_SIZE)));
+		nblocks_this_segment = Min(nblocks_this_segment, lengthof(iov));
+
+		bounce = md_io_buffers(iobuffers, buffers, nblocks_this_segment);
+		iovcnt = buffers_to_iovec(iov, iobuffers, nblocks_this_segment);
+		size_this_segment = nblocks_this_segment * BLCKSZ;
+		transferred_this_segment = 0;
+
+		/*
+		 * Inner loop to continue after a short read.  We'll keep going until
+		 * we hit EOF rather than assuming that a short read means we hit the
+		 * end.
+		 */
+		for (;;)
+		{
+			TRACE_POSTGRESQL_SMGR_MD_READ_START(forknum, blocknum,
+												reln->smgr_rnode.node.spcNode,
+												reln->smgr_rnode.node.dbNode,
+												reln->smgr_rnode.node.relNode,
+												reln->smgr_rnode.backend);
+			nbytes = FileReadV(v->mdfd_vfd, iov, iovcnt, seekpos,
+							   WAIT_EVENT_DATA_FILE_READ);
+			TRACE_POSTGRESQL_SMGR_MD_READ_DONE(forknum, blocknum,
+											   reln->smgr_rnode.node.spcNode,
+											   reln->smgr_rnode.node.dbNode,
+											   reln->smgr_rnode.node.relNode,
+											   reln->smgr_rnode.backend,
+											   nbytes,
+											   size_this_segment - transferred_this_segment);
+
+			if (nbytes < 0)
+				ereport(ERROR,
+						(errcode_for_file_access(),
+						 errmsg("could not read blocks %u..%u in file \"%s\": %m",
+								blocknum,
+								blocknum + nblocks_this_segment - 1,
+								FilePathName(v->mdfd_vfd))));
+
+			if (nbytes == 0)
+			{
+				/*
+				 * We are at or past EOF, or we read a partial block at EOF.
+				 * Normally this is an error; upper levels should never try
+				 * to read a nonexistent block.  However, if
+				 * zero_damaged_pages is ON or we are InRecovery, we should
+				 * instead return zeroes without complaining.  This allows,
+				 * for example, the case of trying to update a block that was
+				 * later truncated away.
+				 */
+				if (!zero_damaged_pages && !InRecovery)
+					ereport(ERROR,
+							(errcode(ERRCODE_DATA_CORRUPTED),
+							 errmsg("could not read blocks %u..%u in file \"%s\": read only %zu of %zu bytes",
+									blocknum,
+									blocknum + nblocks_this_segment - 1,
+									FilePathName(v->mdfd_vfd),
+									transferred_this_segment,
+									size_this_segment)));
+
+				for (i = transferred_this_segment / BLCKSZ;
+					 i < nblocks_this_segment;
+					 i++)
+					MemSet(iobuffers[i], 0, BLCKSZ);
+				break;
+			}
+
+			/* One loop should usually be enough. */
+			transferred_this_segment += nbytes;
+			Assert(transferred_this_segment <= size_this_segment);
+			if (transferred_this_segment == size_this_segment)
+				break;
+
+			/* Adjust position and vectors after a short read. */
+			seekpos += nbytes;
+			iovcnt = compute_remaining_iovec(iov, iovcnt, nbytes);
+		}
+
+		if (bounce)
+		{
+			for (i = 0; i < nblocks_this_segment; i++)
+				if (iobuffers[i] != buffers[i])
+					memcpy(buffers[i], iobuffers[i], BLCKSZ);
+		}
+
+		nblocks -= nblocks_this_segment;
+		buffers += nblocks_this_segment;
+		blocknum += nblocks_this_segment;
+	}
+}
+
+/*
+ *	mdmaxcombine() -- Return the maximum number of consecutive blocks,
+ *					  starting at the specified block, that can be read in
+ *					  one go.
+ *
+ *		A read can't span segment files.
+ */
+BlockNumber
+mdmaxcombine(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum)
+{
+	BlockNumber segoff;
+
+	segoff = blocknum % ((BlockNumber) RELSEG_SIZE);
+
+	return RELSEG_SIZE - segoff;
+}
+
+/*
+ *	mdpreparereadv() -- Prepare an asynchronous read of the specified blocks
+ *						of a relation into the supplied buffers.
+ *
+ *		The blocks must lie in one segment, see mdmaxcombine().  The read is
+ *		defined in the I/O handle "ioh" and started when the caller stages
+ *		the handle.  Errors and short reads are reported by the handle's
+ *		completion callback rather than here, see mdreadv().
  */
 void
-mdread(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
-	   char *buffer)
+mdpreparereadv(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
+			   char **buffers, BlockNumber nblocks, PgAioHandle *ioh)
 {
+	struct iovec iov[PG_IOV_MAX];
+	int			iovcnt;
 	off_t		seekpos;
-	int			nbytes;
 	MdfdVec    *v;
+#ifdef USE_ASSERT_CHECKING
+	BlockNumber i;
+#endif
 
-	TRACE_POSTGRESQL_SMGR_MD_READ_START(forknum, blocknum,
-										reln->smgr_rnode.node.spcNode,
-										reln->smgr_rnode.node.dbNode,
-										reln->smgr_rnode.node.relNode,
-										reln->smgr_rnode.backend);
+	Assert(nblocks >= 1 && nblocks <= lengthof(iov));
+	Assert(nblocks <= mdmaxcombine(reln, forknum, blocknum));
 
 	v = _mdfd_getseg(reln, forknum, blocknum, false,
 					 EXTENSION_FAIL | EXTENSION_CREATE_RECOVERY);
@@ -622,105 +906,135 @@ mdread(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
 
 	Assert(seekpos < (off_t) BLCKSZ * RELSEG_SIZE);
 
-	nbytes = FileRead(v->mdfd_vfd, buffer, BLCKSZ, seekpos, WAIT_EVENT_DATA_FILE_READ);
+	/* asynchronous reads are only done into shared buffers, no bounce needed */
+#ifdef USE_ASSERT_CHECKING
+	for (i = 0; i < nblocks; i++)
+		Assert((io_direct_flags & IO_DIRECT_DATA) == 0 ||
+			   buffers[i] == (char *) TYPEALIGN(PG_IO_ALIGN_SIZE, buffers[i]));
+#endif
 
-	TRACE_POSTGRESQL_SMGR_MD_READ_DONE(forknum, blocknum,
-									   reln->smgr_rnode.node.spcNode,
-									   reln->smgr_rnode.node.dbNode,
-									   reln->smgr_rnode.node.relNode,
-									   reln->smgr_rnode.backend,
-									   nbytes,
-									   BLCKSZ);
+	iovcnt = buffers_to_iovec(iov, buffers, nblocks);
 
-	if (nbytes != BLCKSZ)
-	{
-		if (nbytes < 0)
-			ereport(ERROR,
-					(errcode_for_file_access(),
-					 errmsg("could not read block %u in file \"%s\": %m",
-							blocknum, FilePathName(v->mdfd_vfd))));
-
-		/*
-		 * Short read: we are at or past EOF, or we read a partial block at
-		 * EOF.  Normally this is an error; upper levels should never try to
-		 * read a nonexistent block.  However, if zero_damaged_pages is ON or
-		 * we are InRecovery, we should instead return zeroes without
-		 * complaining.  This allows, for example, the case of trying to
-		 * update a block that was later truncated away.
-		 */
-		if (zero_damaged_pages || InRecovery)
-			MemSet(buffer, 0, BLCKSZ);
-		else
-			ereport(ERROR,
-					(errcode(ERRCODE_DATA_CORRUPTED),
-					 errmsg("could not read block %u in file \"%s\": read only %d of %d bytes",
-							blocknum, FilePathName(v->mdfd_vfd),
-							nbytes, BLCKSZ)));
-	}
+	if (FilePrepareReadV(v->mdfd_vfd, iov, iovcnt, seekpos, ioh) < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not read blocks %u..%u in file \"%s\": %m",
+						blocknum, blocknum + nblocks - 1,
+						FilePathName(v->mdfd_vfd))));
 }
 
 /*
- *	mdwrite() -- Write the supplied block at the appropriate location.
+ *	mdwritev() -- Write the supplied blocks at the appropriate location.
+ *
+ *		Writes "nblocks" consecutive blocks, starting at "blocknum", from the
+ *		given buffers, using as few system calls as possible.
  *
  *		This is to be used only for updating already-existing blocks of a
  *		relation (ie, those before the current EOF).  To extend a relation,
  *		use mdextend().
  */
 void
-mdwrite(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
-		char *buffer, bool skipFsync)
+mdwritev(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
+		 char **buffers, BlockNumber nblocks, bool skipFsync)
 {
-	off_t		seekpos;
-	int			nbytes;
-	MdfdVec    *v;
-
 	/* This assert is too expensive to have on normally ... */
 #ifdef CHECK_WRITE_VS_EXTEND
-	Assert(blocknum < mdnblocks(reln, forknum));
+	Assert(blocknum + nblocks <= mdnblocks(reln, forknum));
 #endif
 
-	TRACE_POSTGRESQL_SMGR_MD_WRITE_START(forknum, blocknum,
-										 reln->smgr_rnode.node.spcNode,
-										 reln->smgr_rnode.node.dbNode,
-										 reln->smgr_rnode.node.relNode,
-										 reln->smgr_rnode.backend);
+	while (nblocks > 0)
+	{
+		struct iovec iov[PG_IOV_MAX];
+		char	   *iobuffers[PG_IOV_MAX];
+		bool		bounce;
+		int			iovcnt;
+		off_t		seekpos;
+		int			nbytes;
+		MdfdVec    *v;
+		BlockNumber nblocks_this_segment;
+		BlockNumber i;
+		size_t		transferred_this_segment;
+		size_t		size_this_segment;
 
-	v = _mdfd_getseg(reln, forknum, blocknum, skipFsync,
-					 EXTENSION_FAIL | EXTENSION_CREATE_RECOVERY);
+		v = _mdfd_getseg(reln, forknum, blocknum, skipFsync,
+						 EXTENSION_FAIL | EXTENSION_CREATE_RECOVERY);
 
-	seekpos = (off_t) BLCKSZ * (blocknum % ((BlockNumber) RELSEG_SIZE));
+		seekpos = (off_t) BLCKSZ * (blocknum % ((BlockNumber) RELSEG_SIZE));
 
-	Assert(seekpos < (off_t) BLCKSZ * RELSEG_SIZE);
+		Assert(seekpos < (off_t) BLCKSZ * RELSEG_SIZE);
 
-	nbytes = FileWrite(v->mdfd_vfd, buffer, BLCKSZ, seekpos, WAIT_EVENT_DATA_FILE_WRITE);
+		nblocks_this_segment =
+			Min(nblocks,
+				RELSEG_SIZE - (blocknum % ((BlockNumber) RELSEG_SIZE)));
+		nblocks_this_segment = Min(nblocks_this_segment, lengthof(iov));
 
-	TRACE_POSTGRESQL_SMGR_MD_WRITE_DONE(forknum, blocknum,
-										reln->smgr_rnode.node.spcNode,
-										reln->smgr_rnode.node.dbNode,
-										reln->smgr_rnode.node.relNode,
-										reln->smgr_rnode.backend,
-										nbytes,
-										BLCKSZ);
+		bounce = md_io_buffers(iobuffers, buffers, nblocks_this_segment);
+		if (bounce)
+		{
+			for (i = 0; i < nblocks_this_segment; i++)
+				if (iobuffers[i] != buffers[i])
+					memcpy(iobuffers[i], buffers[i], BLCKSZ);
+		}
+		iovcnt = buffers_to_iovec(iov, iobuffers, nblocks_this_segment);
+		size_this_segment = nblocks_this_segment * BLCKSZ;
+		transferred_this_segment = 0;
 
-	if (nbytes != BLCKSZ)
-	{
-		if (nbytes < 0)
-			ereport(ERROR,
-					(errcode_for_file_access(),
-					 errmsg("could not write block %u in file \"%s\": %m",
-							blocknum, FilePathName(v->mdfd_vfd))));
-		/* short write: complain appropriately */
-		ereport(ERROR,
-				(errcode(ERRCODE_DISK_FULL),
-				 errmsg("could not write block %u in file \"%s\": wrote only %d of %d bytes",
-						blocknum,
-						FilePathName(v->mdfd_vfd),
-						nbytes, BLCKSZ),
-				 errhint("Check free disk space.")));
-	}
+		/* Inner loop to continue after a short write. */
+		for (;;)
+		{
+			TRACE_POSTGRESQL_SMGR_MD_WRITE_START(forknum, blocknum,
+												 reln->smgr_rnode.node.spcNode,
+												 reln->smgr_rnode.node.dbNode,
+												 reln->smgr_rnode.node.relNode,
+												 reln->smgr_rnode.backend);
+			nbytes = FileWriteV(v->mdfd_vfd, iov, iovcnt, seekpos,
+								WAIT_EVENT_DATA_FILE_WRITE);
+			TRACE_POSTGRESQL_SMGR_MD_WRITE_DONE(forknum, blocknum,
+												reln->smgr_rnode.node.spcNode,
+												reln->smgr_rnode.node.dbNode,
+												reln->smgr_rnode.node.relNode,
+												reln->smgr_rnode.backend,
+												nbytes,
+												size_this_segment - transferred_this_segment);
+
+			if (nbytes < 0)
+				ereport(ERROR,
+						(errcode_for_file_access(),
+						 errmsg("could not write blocks %u..%u in file \"%s\": %m",
+								blocknum,
+								blocknum + nblocks_this_segment - 1,
+								FilePathName(v->mdfd_vfd))));
 
-	if (!skipFsync && !SmgrIsTemp(reln))
-		register_dirty_segment(reln, forknum, v);
+			/* short write with no progress: complain appropriately */
+			if (nbytes == 0)
+				ereport(ERROR,
+						(errcode(ERRCODE_DISK_FULL),
+						 errmsg("could not write blocks %u..%u in file \"%s\": wrote only %zu of %zu bytes",
+								blocknum,
+								blocknum + nblocks_this_segment - 1,
+								FilePathName(v->mdfd_vfd),
+								transferred_this_segment,
+								size_this_segment),
+						 errhint("Check free disk space.")));
+
+			/* One loop should usually be enough. */
+			transferred_this_segment += nbytes;
+			Assert(transferred_this_segment <= size_this_segment);
+			if (transferred_this_segment == size_this_segment)
+				break;
+
+			/* Adjust position and vectors after a short write. */
+			seekpos += nbytes;
+			iovcnt = compute_remaining_iovec(iov, iovcnt, nbytes);
+		}
+
+		if (!skipFsync && !SmgrIsTemp(reln))
+			register_dirty_segment(reln, forknum, v);
+
+		nblocks -= nblocks_this_segment;
+		buffers += nblocks_this_segment;
+		blocknum += nblocks_this_segment;
+	}
 }
 
 /*
@@ -945,6 +1259,8 @@ static void
 register_dirty_segment(SMgrRelation reln, ForkNumber forknum, MdfdVec *seg)
 {
 	FileTag		tag;
+	instr_time	io_start,
+				io_time;
 
 	INIT_MD_FILETAG(tag, reln->smgr_rnode.node, forknum, seg->mdfd_segno);
 
@@ -956,11 +1272,22 @@ register_dirty_segment(SMgrRelation reln, ForkNumber forknum, MdfdVec *seg)
 		ereport(DEBUG1,
 				(errmsg("could not forward fsync request because request queue is full")));
 
+		if (track_io_timing)
+			INSTR_TIME_SET_CURRENT(io_start);
+
 		if (FileSync(seg->mdfd_vfd, WAIT_EVENT_DATA_FILE_SYNC) < 0)
 			ereport(data_sync_elevel(ERROR),
 					(errcode_for_file_access(),
 					 errmsg("could not fsync file \"%s\": %m",
 							FilePathName(seg->mdfd_vfd))));
+
+		pgstat_count_io_op(IOCONTEXT_NORMAL, IOOP_FSYNC);
+		if (track_io_timing)
+		{
+			INSTR_TIME_SET_CURRENT(io_time);
+			INSTR_TIME_SUBTRACT(io_time, io_start);
+			pgstat_count_io_time(IOCONTEXT_NORMAL, IOOP_FSYNC, io_time);
+		}
 	}
 }
 
@@ -1120,7 +1447,7 @@ _mdfd_openseg(SMgrRelation reln, ForkNumber forknum, BlockNumber segno,
 	fullpath = _mdfd_segpath(reln, forknum, segno);
 
 	/* open the file */
-	fd = PathNameOpenFile(fullpath, O_RDWR | PG_BINARY | oflags);
+	fd = PathNameOpenFile(fullpath, _mdfd_open_flags() | oflags);
 
 	pfree(fullpath);
 
@@ -1308,6 +1635,8 @@ mdsyncfiletag(const FileTag *ftag, char *path)
 	bool		need_to_close;
 	int			result,
 				save_errno;
+	instr_time	io_start,
+				io_time;
 
 	/* See if we already have the file open, or need to open it. */
 	if (ftag->segno < reln->md_num_open_segs[ftag->forknum])
@@ -1331,9 +1660,23 @@ mdsyncfiletag(const FileTag *ftag, char *path)
 	}
 
 	/* Sync the file. */
+	if (track_io_timing)
+		INSTR_TIME_SET_CURRENT(io_start);
+
 	result = FileSync(file, WAIT_EVENT_DATA_FILE_SYNC);
 	save_errno = errno;
 
+	if (result == 0)
+	{
+		pgstat_count_io_op(IOCONTEXT_NORMAL, IOOP_FSYNC);
+		if (track_io_timing)
+		{
+			INSTR_TIME_SET_CURRENT(io_time);
+			INSTR_TIME_SUBTRACT(io_time, io_start);
+			pgstat_count_io_time(IOCONTEXT_NORMAL, IOOP_FSYNC, io_time);
+		}
+	}
+
 	if (need_to_close)
 		FileClose(file);
 
@@ -51,10 +51,17 @@ typedef struct f_smgr
 								BlockNumber blocknum, char *buffer, bool skipFsync);
 	bool		(*smgr_prefetch) (SMgrRelation reln, ForkNumber forknum,
 								  BlockNumber blocknum);
-	void		(*smgr_read) (SMgrRelation reln, ForkNumber forknum,
-							  BlockNumber blocknum, char *buffer);
-	void		(*smgr_write) (SMgrRelation reln, ForkNumber forknum,
-							   BlockNumber blocknum, char *buffer, bool skipFsync);
+	void		(*smgr_readv) (SMgrRelation reln, ForkNumber forknum,
+							   BlockNumber blocknum, char **buffers,
+							   BlockNumber nblocks);
+	BlockNumber (*smgr_maxcombine) (SMgrRelation reln, ForkNumber forknum,
+									BlockNumber blocknum);
+	void		(*smgr_preparereadv) (SMgrRelation reln, ForkNumber forknum,
+									  BlockNumber blocknum, char **buffers,
+									  BlockNumber nblocks, PgAioHandle *ioh);
+	void		(*smgr_writev) (SMgrRelation reln, ForkNumber forknum,
+								BlockNumber blocknum, char **buffers,
+								BlockNumber nblocks, bool skipFsync);
 	void		(*smgr_writeback) (SMgrRelation reln, ForkNumber forknum,
 								   BlockNumber blocknum, BlockNumber nblocks);
 	BlockNumber (*smgr_nblocks) (SMgrRelation reln, ForkNumber forknum);
@@ -75,8 +82,10 @@ static const f_smgr smgrsw[] = {
 		.smgr_unlink = mdunlink,
 		.smgr_extend = mdextend,
 		.smgr_prefetch = mdprefetch,
-		.smgr_read = mdread,
-		.smgr_write = mdwrite,
+		.smgr_readv = mdreadv,
+		.smgr_maxcombine = mdmaxcombine,
+		.smgr_preparereadv = mdpreparereadv,
+		.smgr_writev = mdwritev,
 		.smgr_writeback = mdwriteback,
 		.smgr_nblocks = mdnblocks,
 		.smgr_truncate = mdtruncate,
@@ -547,7 +556,68 @@ void
 smgrread(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
 		 char *buffer)
 {
-	smgrsw[reln->smgr_which].smgr_read(reln, forknum, blocknum, buffer);
+	smgrsw[reln->smgr_which].smgr_readv(reln, forknum, blocknum, &buffer, 1);
+}
+
+/*
+ *	smgrreadv() -- read a run of consecutive blocks from a relation into the
+ *				   supplied buffers.
+ *
+ *		Like smgrread(), but reads "nblocks" blocks starting at "blocknum",
+ *		with as few system calls as the storage manager can manage.  The
+ *		buffers need not be adjacent in memory.
+ */
+void
+smgrreadv(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
+		  char **buffers, BlockNumber nblocks)
+{
+	smgrsw[reln->smgr_which].smgr_readv(reln, forknum, blocknum, buffers,
+										nblocks);
+}
+
+/*
+ *	smgrmaxcombine() -- the maximum number of consecutive blocks, starting at
+ *						the given one, that smgrstartreadv() can read at once.
+ */
+BlockNumber
+smgrmaxcombine(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum)
+{
+	return smgrsw[reln->smgr_which].smgr_maxcombine(reln, forknum, blocknum);
+}
+
+/*
+ *	smgrpreparereadv() -- define an asynchronous read of a run of consecutive
+ *						  blocks into the supplied buffers, without starting
+ *						  it.
+ *
+ *		Most callers want smgrstartreadv().  This is used directly by I/O
+ *		workers, which must reopen the file in their own process before they
+ *		can execute a read prepared by another backend.
+ */
+void
+smgrpreparereadv(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
+				 char **buffers, BlockNumber nblocks, PgAioHandle *ioh)
+{
+	pgaio_io_set_target(ioh, reln->smgr_rnode, forknum, blocknum);
+	smgrsw[reln->smgr_which].smgr_preparereadv(reln, forknum, blocknum,
+											   buffers, nblocks, ioh);
+}
+
+/*
+ *	smgrstartreadv() -- start an asynchronous read of a run of consecutive
+ *						blocks into the supplied buffers.
+ *
+ *		"nblocks" must not exceed smgrmaxcombine(), nor PG_IOV_MAX.  The read
+ *		is described by the I/O handle "ioh", whose completion callback must
+ *		already be set; see StartReadBuffers().  Depending on io_method, the
+ *		read may only be staged when this returns, see pgaio_io_stage().
+ */
+void
+smgrstartreadv(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
+			   char **buffers, BlockNumber nblocks, PgAioHandle *ioh)
+{
+	smgrpreparereadv(reln, forknum, blocknum, buffers, nblocks, ioh);
+	pgaio_io_stage(ioh);
 }
 
 /*
@@ -569,8 +639,24 @@ void
 smgrwrite(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
 		  char *buffer, bool skipFsync)
 {
-	smgrsw[reln->smgr_which].smgr_write(reln, forknum, blocknum,
-										buffer, skipFsync);
+	smgrsw[reln->smgr_which].smgr_writev(reln, forknum, blocknum,
+										 &buffer, 1, skipFsync);
+}
+
+/*
+ *	smgrwritev() -- Write the supplied buffers out to a run of consecutive
+ *					blocks.
+ *
+ *		Like smgrwrite(), but writes "nblocks" blocks starting at
+ *		"blocknum", with as few system calls as the storage manager can
+ *		manage.
+ */
+void
+smgrwritev(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
+		   char **buffers, BlockNumber nblocks, bool skipFsync)
+{
+	smgrsw[reln->smgr_which].smgr_writev(reln, forknum, blocknum,
+										 buffers, nblocks, skipFsync);
 }
 
 
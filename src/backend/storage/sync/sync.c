@@ -79,6 +79,8 @@ static CycleCtr checkpoint_cycle_ctr = 0;
 #define FSYNCS_PER_ABSORB		10
 #define UNLINKS_PER_ABSORB		10
 
+static void CreatePendingOps(void);
+
 /*
  * Function pointers for handling sync and unlink requests.
  */
@@ -111,34 +113,39 @@ InitSync(void)
 	 * or checkpointer auxiliary process.
 	 */
 	if (!IsUnderPostmaster || AmStartupProcess() || AmCheckpointerProcess())
-	{
-		HASHCTL		hash_ctl;
+		CreatePendingOps();
+}
 
-		/*
-		 * XXX: The checkpointer needs to add entries to the pending ops table
-		 * when absorbing fsync requests.  That is done within a critical
-		 * section, which isn't usually allowed, but we make an exception. It
-		 * means that there's a theoretical possibility that you run out of
-		 * memory while absorbing fsync requests, which leads to a PANIC.
-		 * Fortunately the hash table is small so that's unlikely to happen in
-		 * practice.
-		 */
-		pendingOpsCxt = AllocSetContextCreate(TopMemoryContext,
-											  "Pending ops context",
-											  ALLOCSET_DEFAULT_SIZES);
-		MemoryContextAllowInCriticalSection(pendingOpsCxt, true);
-
-		MemSet(&hash_ctl, 0, sizeof(hash_ctl));
-		hash_ctl.keysize = sizeof(FileTag);
-		hash_ctl.entrysize = sizeof(PendingFsyncEntry);
-		hash_ctl.hcxt = pendingOpsCxt;
-		pendingOps = hash_create("Pending Ops Table",
-								 100L,
-								 &hash_ctl,
-								 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
-		pendingUnlinks = NIL;
-	}
+/*
+ * Create the pending-operations hashtable.
+ */
+static void
+CreatePendingOps(void)
+{
+	HASHCTL		hash_ctl;
 
+	/*
+	 * XXX: The checkpointer needs to add entries to the pending ops table
+	 * when absorbing fsync requests.  That is done within a critical section,
+	 * which isn't usually allowed, but we make an exception. It means that
+	 * there's a theoretical possibility that you run out of memory while
+	 * absorbing fsync requests, which leads to a PANIC.  Fortunately the hash
+	 * table is small so that's unlikely to happen in practice.
+	 */
+	pendingOpsCxt = AllocSetContextCreate(TopMemoryContext,
+										  "Pending ops context",
+										  ALLOCSET_DEFAULT_SIZES);
+	MemoryContextAllowInCriticalSection(pendingOpsCxt, true);
+
+	MemSet(&hash_ctl, 0, sizeof(hash_ctl));
+	hash_ctl.keysize = sizeof(FileTag);
+	hash_ctl.entrysize = sizeof(PendingFsyncEntry);
+	hash_ctl.hcxt = pendingOpsCxt;
+	pendingOps = hash_create("Pending Ops Table",
+							 100L,
+							 &hash_ctl,
+							 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	pendingUnlinks = NIL;
 }
 
 /*
@@ -590,3 +597,16 @@ EnableSyncRequestForwarding(void)
 	 */
 	Assert(pendingUnlinks == NIL);
 }
+
+/*
+ * During crash recovery there is no checkpointer to forward requests to.
+ * Parallel redo workers call this to remember their requests locally, like
+ * the startup process does; they must perform them with ProcessSyncRequests()
+ * before the end-of-recovery checkpoint.
+ */
+void
+DisableSyncRequestForwarding(void)
+{
+	if (pendingOps == NULL)
+		CreatePendingOps();
+}
@@ -1697,12 +1697,12 @@ Datum
 pg_stat_get_slru(PG_FUNCTION_ARGS)
 {
 #define PG_STAT_GET_SLRU_COLS	9
-	ReturnSetInfo  *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
-	TupleDesc		tupdesc;
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
 	Tuplestorestate *tupstore;
-	MemoryContext 	per_query_ctx;
-	MemoryContext 	oldcontext;
-	int				i;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	int			i;
 	PgStat_SLRUStats *stats;
 
 	/* check to see if caller supports us returning a tuplestore */
@@ -1767,6 +1767,102 @@ pg_stat_get_slru(PG_FUNCTION_ARGS)
 	return (Datum) 0;
 }
 
+/*
+ * Returns shared buffer I/O statistics, by backend type and I/O context.
+ */
+Datum
+pg_stat_get_io(PG_FUNCTION_ARGS)
+{
+#define PG_STAT_GET_IO_COLS	14
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	int			bktype;
+	int			io_context;
+	PgStat_IOStats *stats;
+
+	/* check to see if caller supports us returning a tuplestore */
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not allowed in this context")));
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	stats = pgstat_fetch_stat_io();
+
+	for (bktype = 0; bktype < BACKEND_NUM_TYPES; bktype++)
+	{
+		/* these never do any shared buffer I/O */
+		if (bktype == B_INVALID || bktype == B_ARCHIVER || bktype == B_LOGGER)
+			continue;
+
+		for (io_context = 0; io_context < IOCONTEXT_NUM_TYPES; io_context++)
+		{
+			/* for each row */
+			Datum		values[PG_STAT_GET_IO_COLS];
+			bool		nulls[PG_STAT_GET_IO_COLS];
+			PgStat_Counter *counts = stats->stats[bktype].counts[io_context];
+			PgStat_Counter *times = stats->stats[bktype].times[io_context];
+
+			MemSet(values, 0, sizeof(values));
+			MemSet(nulls, 0, sizeof(nulls));
+
+			values[0] = CStringGetTextDatum(GetBackendTypeDesc(bktype));
+			values[1] = CStringGetTextDatum(pgstat_io_context_desc(io_context));
+			values[2] = Int64GetDatum(counts[IOOP_READ]);
+			/* convert times from microseconds to milliseconds */
+			values[3] = Float8GetDatum(((double) times[IOOP_READ]) / 1000.0);
+			values[4] = Int64GetDatum(counts[IOOP_WRITE]);
+			values[5] = Float8GetDatum(((double) times[IOOP_WRITE]) / 1000.0);
+			values[6] = Int64GetDatum(counts[IOOP_EXTEND]);
+			values[7] = Float8GetDatum(((double) times[IOOP_EXTEND]) / 1000.0);
+			values[8] = Int64GetDatum(counts[IOOP_HIT]);
+			values[9] = Int64GetDatum(counts[IOOP_EVICT]);
+			values[10] = Int64GetDatum(counts[IOOP_REUSE]);
+
+			/* files are only ever fsync'd outside of strategy rings */
+			if (io_context == IOCONTEXT_NORMAL)
+			{
+				values[11] = Int64GetDatum(counts[IOOP_FSYNC]);
+				values[12] = Float8GetDatum(((double) times[IOOP_FSYNC]) / 1000.0);
+			}
+			else
+			{
+				nulls[11] = true;
+				nulls[12] = true;
+			}
+
+			values[13] = TimestampTzGetDatum(stats->stat_reset_timestamp);
+
+			tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+		}
+	}
+
+	/* clean up and return the tuplestore */
+	tuplestore_donestoring(tupstore);
+
+	return (Datum) 0;
+}
+
 Datum
 pg_stat_get_xact_numscans(PG_FUNCTION_ARGS)
 {
@@ -2091,3 +2187,54 @@ pg_stat_get_archiver(PG_FUNCTION_ARGS)
 	/* Returns the record as Datum */
 	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
 }
+
+/*
+ * Returns statistics about group WAL flushes.
+ */
+Datum
+pg_stat_get_wal_flush(PG_FUNCTION_ARGS)
+{
+#define PG_STAT_GET_WAL_FLUSH_COLS	6
+	TupleDesc	tupdesc;
+	Datum		values[PG_STAT_GET_WAL_FLUSH_COLS];
+	bool		nulls[PG_STAT_GET_WAL_FLUSH_COLS];
+	PgStat_WalFlushStats *stats;
+
+	/* Initialise values and NULL flags arrays */
+	MemSet(values, 0, sizeof(values));
+	MemSet(nulls, 0, sizeof(nulls));
+
+	/* Initialise attributes information in the tuple descriptor */
+	tupdesc = CreateTemplateTupleDesc(PG_STAT_GET_WAL_FLUSH_COLS);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 1, "groups",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 2, "members",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 3, "max_members",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 4, "flush_time",
+					   FLOAT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 5, "max_flush_time",
+					   FLOAT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 6, "stats_reset",
+					   TIMESTAMPTZOID, -1, 0);
+
+	BlessTupleDesc(tupdesc);
+
+	stats = pgstat_fetch_stat_wal_flush();
+
+	values[0] = Int64GetDatum(stats->counts.groups);
+	values[1] = Int64GetDatum(stats->counts.members);
+	values[2] = Int64GetDatum(stats->counts.max_members);
+	/* convert times from microseconds to milliseconds */
+	values[3] = Float8GetDatum(((double) stats->counts.flush_time) / 1000.0);
+	values[4] = Float8GetDatum(((double) stats->counts.max_flush_time) / 1000.0);
+
+	if (stats->stat_reset_timestamp == 0)
+		nulls[5] = true;
+	else
+		values[5] = TimestampTzGetDatum(stats->stat_reset_timestamp);
+
+	/* Returns the record as Datum */
+	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
+}
@@ -34,6 +34,8 @@
 #include "access/twophase.h"
 #include "access/xact.h"
 #include "access/xlog_internal.h"
+#include "access/xlogparallel.h"
+#include "access/xlogprefetch.h"
 #include "catalog/namespace.h"
 #include "catalog/pg_authid.h"
 #include "catalog/storage.h"
@@ -44,6 +46,9 @@
 #include "commands/vacuum.h"
 #include "commands/variable.h"
 #include "common/string.h"
+#include "executor/execBatch.h"
+#include "executor/nodeHash.h"
+#include "executor/nodeHashjoin.h"
 #include "funcapi.h"
 #include "jit/jit.h"
 #include "libpq/auth.h"
@@ -60,11 +65,13 @@
 #include "parser/parser.h"
 #include "parser/scansup.h"
 #include "pgstat.h"
+#include "port/pg_numa.h"
 #include "postmaster/autovacuum.h"
 #include "postmaster/bgworker_internals.h"
 #include "postmaster/bgwriter.h"
 #include "postmaster/postmaster.h"
 #include "postmaster/syslogger.h"
+#include "postmaster/walsummarizer.h"
 #include "postmaster/walwriter.h"
 #include "replication/logicallauncher.h"
 #include "replication/reorderbuffer.h"
@@ -72,6 +79,7 @@
 #include "replication/syncrep.h"
 #include "replication/walreceiver.h"
 #include "replication/walsender.h"
+#include "storage/aio.h"
 #include "storage/bufmgr.h"
 #include "storage/dsm_impl.h"
 #include "storage/fd.h"
@@ -164,6 +172,9 @@ static bool check_wal_consistency_checking(char **newval, void **extra,
 										   GucSource source);
 static void assign_wal_consistency_checking(const char *newval, void *extra);
 
+static bool check_io_direct(char **newval, void **extra, GucSource source);
+static void assign_io_direct(const char *newval, void *extra);
+
 #ifdef HAVE_SYSLOG
 static int	syslog_facility = LOG_LOCAL0;
 #else
@@ -198,7 +209,7 @@ static bool check_max_wal_senders(int *newval, void **extra, GucSource source);
 static bool check_autovacuum_work_mem(int *newval, void **extra, GucSource source);
 static bool check_effective_io_concurrency(int *newval, void **extra, GucSource source);
 static bool check_maintenance_io_concurrency(int *newval, void **extra, GucSource source);
-static void assign_pgstat_temp_directory(const char *newval, void *extra);
+static bool check_recovery_prefetch(bool *newval, void **extra, GucSource source);
 static bool check_application_name(char **newval, void **extra, GucSource source);
 static void assign_application_name(const char *newval, void *extra);
 static bool check_cluster_name(char **newval, void **extra, GucSource source);
@@ -443,6 +454,43 @@ static const struct config_enum_entry huge_pages_options[] = {
 	{NULL, 0, false}
 };
 
+static const struct config_enum_entry wal_compression_options[] = {
+	{"pglz", WAL_COMPRESSION_PGLZ, false},
+#ifdef USE_LZ4
+	{"lz4", WAL_COMPRESSION_LZ4, false},
+#endif
+#ifdef USE_ZSTD
+	{"zstd", WAL_COMPRESSION_ZSTD, false},
+#endif
+	{"on", WAL_COMPRESSION_PGLZ, false},
+	{"off", WAL_COMPRESSION_NONE, false},
+	{"true", WAL_COMPRESSION_PGLZ, true},
+	{"false", WAL_COMPRESSION_NONE, true},
+	{"yes", WAL_COMPRESSION_PGLZ, true},
+	{"no", WAL_COMPRESSION_NONE, true},
+	{"1", WAL_COMPRESSION_PGLZ, true},
+	{"0", WAL_COMPRESSION_NONE, true},
+	{NULL, 0, false}
+};
+
+static const struct config_enum_entry io_method_options[] = {
+	{"sync", IOMETHOD_SYNC, false},
+	{"worker", IOMETHOD_WORKER, false},
+#ifdef USE_IO_URING
+	{"io_uring", IOMETHOD_IO_URING, false},
+#endif
+	{NULL, 0, false}
+};
+
+static const struct config_enum_entry numa_options[] = {
+	{"off", NUMA_PLACEMENT_OFF, false},
+#ifdef USE_NUMA
+	{"interleave", NUMA_PLACEMENT_INTERLEAVE, false},
+	{"partition", NUMA_PLACEMENT_PARTITION, false},
+#endif
+	{NULL, 0, false}
+};
+
 static const struct config_enum_entry force_parallel_mode_options[] = {
 	{"off", FORCE_PARALLEL_OFF, false},
 	{"on", FORCE_PARALLEL_ON, false},
@@ -563,8 +611,6 @@ char	   *HbaFileName;
 char	   *IdentFileName;
 char	   *external_pid_file;
 
-char	   *pgstat_temp_directory;
-
 char	   *application_name;
 
 int			tcp_keepalives_idle;
@@ -605,6 +651,7 @@ static char *log_timezone_string;
 static char *timezone_abbreviations_string;
 static char *data_directory;
 static char *session_authorization_string;
+static char *io_direct_string;
 static int	max_function_args;
 static int	max_index_keys;
 static int	max_identifier_length;
@@ -709,6 +756,10 @@ const char *const config_group_names[] =
 	gettext_noop("Write-Ahead Log / Checkpoints"),
 	/* WAL_ARCHIVING */
 	gettext_noop("Write-Ahead Log / Archiving"),
+	/* WAL_SUMMARIZATION */
+	gettext_noop("Write-Ahead Log / Summarization"),
+	/* WAL_RECOVERY */
+	gettext_noop("Write-Ahead Log / Recovery"),
 	/* WAL_ARCHIVE_RECOVERY */
 	gettext_noop("Write-Ahead Log / Archive Recovery"),
 	/* WAL_RECOVERY_TARGET */
@@ -1040,6 +1091,16 @@ static struct config_bool ConfigureNamesBool[] =
 		true,
 		NULL, NULL, NULL
 	},
+	{
+		{"enable_resultcache", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables the planner's use of result caching."),
+			NULL,
+			GUC_EXPLAIN
+		},
+		&enable_resultcache,
+		false,
+		NULL, NULL, NULL
+	},
 	{
 		{"enable_nestloop", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Enables the planner's use of nested-loop join plans."),
@@ -1284,11 +1345,11 @@ static struct config_bool ConfigureNamesBool[] =
 	},
 
 	{
-		{"wal_compression", PGC_SUSET, WAL_SETTINGS,
-			gettext_noop("Compresses full-page writes written in WAL file."),
+		{"summarize_wal", PGC_POSTMASTER, WAL_SUMMARIZATION,
+			gettext_noop("Starts the WAL summarizer process to enable incremental backup."),
 			NULL
 		},
-		&wal_compression,
+		&summarize_wal,
 		false,
 		NULL, NULL, NULL
 	},
@@ -1313,6 +1374,26 @@ static struct config_bool ConfigureNamesBool[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"wal_group_commit", PGC_SUSET, WAL_SETTINGS,
+			gettext_noop("Flushes WAL for groups of concurrently committing transactions at once."),
+			NULL
+		},
+		&wal_group_commit,
+		true,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"recovery_prefetch", PGC_SIGHUP, WAL_RECOVERY,
+			gettext_noop("Prefetch referenced blocks during recovery."),
+			gettext_noop("Read ahead of the current replay position to find uncached blocks.")
+		},
+		&recovery_prefetch,
+		false,
+		check_recovery_prefetch, NULL, NULL
+	},
+
 	{
 		{"log_checkpoints", PGC_SIGHUP, LOGGING_WHAT,
 			gettext_noop("Logs each checkpoint."),
@@ -1975,6 +2056,42 @@ static struct config_bool ConfigureNamesBool[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"runtime_join_filter", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Enables hash joins to filter the scan of their outer "
+						 "relation by the join keys of the inner relation."),
+			NULL,
+			GUC_EXPLAIN
+		},
+		&runtime_join_filter,
+		true,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"hash_join_prefetch", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Enables hash joins to prefetch the buckets of several "
+						 "outer tuples at a time."),
+			NULL,
+			GUC_EXPLAIN
+		},
+		&hash_join_prefetch,
+		true,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"hash_join_bucket_tags", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Enables hash joins to keep a tag for each hash "
+						 "bucket to skip buckets without a match."),
+			NULL,
+			GUC_EXPLAIN
+		},
+		&hash_join_bucket_tags,
+		false,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"jit_debugging_support", PGC_SU_BACKEND, DEVELOPER_OPTIONS,
 			gettext_noop("Register JIT compiled function with debugger."),
@@ -2080,6 +2197,16 @@ static struct config_int ConfigureNamesInt[] =
 		0, 0, INT_MAX / 2,
 		NULL, NULL, NULL
 	},
+	{
+		{"wal_summary_keep_time", PGC_SIGHUP, WAL_SUMMARIZATION,
+			gettext_noop("Time for which WAL summary files should be kept."),
+			gettext_noop("0 means never remove them."),
+			GUC_UNIT_MIN
+		},
+		&wal_summary_keep_time,
+		10 * 24 * 60, 0, INT_MAX / SECS_PER_MINUTE,
+		NULL, NULL, NULL
+	},
 	{
 		{"post_auth_delay", PGC_BACKEND, DEVELOPER_OPTIONS,
 			gettext_noop("Waits N seconds on connection startup after authentication."),
@@ -2100,6 +2227,16 @@ static struct config_int ConfigureNamesInt[] =
 		100, 1, 10000,
 		NULL, NULL, NULL
 	},
+	{
+		{"executor_batch_size", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Sets the number of rows a sequential scan fetches and "
+						 "filters at a time."),
+			gettext_noop("Zero fetches and filters one row at a time.")
+		},
+		&executor_batch_size,
+		1000, 0, 10000,
+		NULL, NULL, NULL
+	},
 	{
 		{"from_collapse_limit", PGC_USERSET, QUERY_TUNING_OTHER,
 			gettext_noop("Sets the FROM-list size beyond which subqueries "
@@ -2730,6 +2867,26 @@ static struct config_int ConfigureNamesInt[] =
 		check_wal_buffers, NULL, NULL
 	},
 
+	{
+		{"wal_prealloc_segments", PGC_SIGHUP, WAL_SETTINGS,
+			gettext_noop("Sets the number of WAL files the background writer prepares in advance."),
+			NULL
+		},
+		&wal_prealloc_segments,
+		2, 0, 1024,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"wal_insert_locks", PGC_POSTMASTER, WAL_SETTINGS,
+			gettext_noop("Sets the number of locks used for concurrent WAL insertion."),
+			NULL
+		},
+		&wal_insert_locks,
+		8, 1, 1024,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"wal_writer_delay", PGC_SIGHUP, WAL_SETTINGS,
 			gettext_noop("Time between WAL flushes performed in the WAL writer."),
@@ -2763,6 +2920,39 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"wal_record_compression_threshold", PGC_SUSET, WAL_SETTINGS,
+			gettext_noop("Minimum size of WAL record payload to compress."),
+			gettext_noop("Records without full-page images whose payload is at least this large "
+						 "are compressed with the wal_compression method. -1 disables."),
+			GUC_UNIT_BYTE
+		},
+		&wal_record_compression_threshold,
+		-1, -1, INT_MAX,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"max_recovery_prefetch_distance", PGC_SIGHUP, WAL_RECOVERY,
+			gettext_noop("Maximum distance to read ahead in the WAL to prefetch referenced blocks."),
+			gettext_noop("Set to 0 to disable prefetching during recovery."),
+			GUC_UNIT_BYTE
+		},
+		&max_recovery_prefetch_distance,
+		256 * 1024, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"max_parallel_redo_workers", PGC_SIGHUP, WAL_RECOVERY,
+			gettext_noop("Sets the maximum number of parallel processes used to replay WAL."),
+			gettext_noop("Set to 0 to replay WAL in the startup process only.")
+		},
+		&max_parallel_redo_workers,
+		0, 0, MAX_PARALLEL_WORKER_LIMIT,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"max_wal_senders", PGC_POSTMASTER, REPLICATION_SENDING,
 			gettext_noop("Sets the maximum number of simultaneously running WAL sender processes."),
@@ -2971,6 +3161,43 @@ static struct config_int ConfigureNamesInt[] =
 		check_maintenance_io_concurrency, NULL, NULL
 	},
 
+	{
+		{"io_combine_limit",
+			PGC_USERSET,
+			RESOURCES_ASYNCHRONOUS,
+			gettext_noop("Maximum number of consecutive blocks read with a single I/O."),
+			NULL,
+			GUC_UNIT_BLOCKS | GUC_EXPLAIN
+		},
+		&io_combine_limit,
+		DEFAULT_IO_COMBINE_LIMIT, 1, MAX_IO_COMBINE_LIMIT,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"io_max_concurrency",
+			PGC_POSTMASTER,
+			RESOURCES_ASYNCHRONOUS,
+			gettext_noop("Maximum number of asynchronous I/Os each process can have in flight."),
+			NULL
+		},
+		&io_max_concurrency,
+		64, 1, MAX_IO_MAX_CONCURRENCY,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"io_workers",
+			PGC_POSTMASTER,
+			RESOURCES_ASYNCHRONOUS,
+			gettext_noop("Number of I/O worker processes, for io_method=worker."),
+			NULL
+		},
+		&io_workers,
+		3, 1, MAX_IO_WORKERS,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"backend_flush_after", PGC_USERSET, RESOURCES_ASYNCHRONOUS,
 			gettext_noop("Number of pages after which previously performed writes are flushed to disk."),
@@ -4299,17 +4526,6 @@ static struct config_string ConfigureNamesString[] =
 		NULL, NULL, NULL
 	},
 
-	{
-		{"stats_temp_directory", PGC_SIGHUP, STATS_COLLECTOR,
-			gettext_noop("Writes temporary statistics files to the specified directory."),
-			NULL,
-			GUC_SUPERUSER_ONLY
-		},
-		&pgstat_temp_directory,
-		PG_STAT_TMP_DIR,
-		check_canonical_path, assign_pgstat_temp_directory, NULL
-	},
-
 	{
 		{"synchronous_standby_names", PGC_SIGHUP, REPLICATION_MASTER,
 			gettext_noop("Number of synchronous standbys and list of names of potential synchronous ones."),
@@ -4416,6 +4632,17 @@ static struct config_string ConfigureNamesString[] =
 		check_wal_consistency_checking, assign_wal_consistency_checking, NULL
 	},
 
+	{
+		{"io_direct", PGC_POSTMASTER, RESOURCES_ASYNCHRONOUS,
+			gettext_noop("Uses direct I/O for the given types of files."),
+			gettext_noop("Valid values are combinations of \"data\", \"wal\" and \"wal_init\"."),
+			GUC_LIST_INPUT
+		},
+		&io_direct_string,
+		"",
+		check_io_direct, assign_io_direct, NULL
+	},
+
 	{
 		{"jit_provider", PGC_POSTMASTER, CLIENT_CONN_PRELOAD,
 			gettext_noop("JIT provider to use."),
@@ -4655,6 +4882,16 @@ static struct config_enum ConfigureNamesEnum[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"wal_compression", PGC_SUSET, WAL_SETTINGS,
+			gettext_noop("Compresses full-page writes written in WAL file with specified method."),
+			NULL
+		},
+		&wal_compression,
+		WAL_COMPRESSION_NONE, wal_compression_options,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"dynamic_shared_memory_type", PGC_POSTMASTER, RESOURCES_MEM,
 			gettext_noop("Selects the dynamic shared memory implementation used."),
@@ -4716,6 +4953,26 @@ static struct config_enum ConfigureNamesEnum[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"numa", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Selects how shared buffers are placed on NUMA nodes."),
+			NULL
+		},
+		&numa_placement,
+		NUMA_PLACEMENT_OFF, numa_options,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"io_method", PGC_POSTMASTER, RESOURCES_ASYNCHRONOUS,
+			gettext_noop("Selects the method used for asynchronous I/O."),
+			NULL
+		},
+		&io_method,
+		DEFAULT_IO_METHOD, io_method_options,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"force_parallel_mode", PGC_USERSET, QUERY_TUNING_OTHER,
 			gettext_noop("Forces use of parallel query facilities."),
@@ -11248,6 +11505,96 @@ assign_log_destination(const char *newval, void *extra)
 	Log_destination = *((int *) extra);
 }
 
+static bool
+check_io_direct(char **newval, void **extra, GucSource source)
+{
+	char	   *rawstring;
+	List	   *elemlist;
+	ListCell   *l;
+	int			newflags = 0;
+
+	/* Need a modifiable copy of string */
+	rawstring = pstrdup(*newval);
+
+	/* Parse string into list of identifiers */
+	if (!SplitIdentifierString(rawstring, ',', &elemlist))
+	{
+		/* syntax error in list */
+		GUC_check_errdetail("List syntax is invalid.");
+		pfree(rawstring);
+		list_free(elemlist);
+		return false;
+	}
+
+	foreach(l, elemlist)
+	{
+		char	   *tok = (char *) lfirst(l);
+
+		if (pg_strcasecmp(tok, "data") == 0)
+			newflags |= IO_DIRECT_DATA;
+		else if (pg_strcasecmp(tok, "wal") == 0)
+			newflags |= IO_DIRECT_WAL;
+		else if (pg_strcasecmp(tok, "wal_init") == 0)
+			newflags |= IO_DIRECT_WAL_INIT;
+		else
+		{
+			GUC_check_errdetail("Unrecognized key word: \"%s\".", tok);
+			pfree(rawstring);
+			list_free(elemlist);
+			return false;
+		}
+	}
+
+	pfree(rawstring);
+	list_free(elemlist);
+
+#if PG_O_DIRECT == 0
+	if (newflags != 0)
+	{
+		GUC_check_errdetail("Direct I/O is not supported on this platform.");
+		return false;
+	}
+#endif
+
+	/*
+	 * Direct I/O requires buffers aligned to PG_IO_ALIGN_SIZE, which we can
+	 * only guarantee for stack variables if the compiler can align them, and
+	 * in units of whole blocks only if the block size is large enough.
+	 */
+#ifndef pg_attribute_aligned
+	if (newflags != 0)
+	{
+		GUC_check_errdetail("Direct I/O is not supported by this build.");
+		return false;
+	}
+#endif
+#if XLOG_BLCKSZ < PG_IO_ALIGN_SIZE
+	if (newflags & (IO_DIRECT_WAL | IO_DIRECT_WAL_INIT))
+	{
+		GUC_check_errdetail("Direct I/O is not supported for WAL because XLOG_BLCKSZ is too small.");
+		return false;
+	}
+#endif
+#if BLCKSZ < PG_IO_ALIGN_SIZE
+	if (newflags & IO_DIRECT_DATA)
+	{
+		GUC_check_errdetail("Direct I/O is not supported for data files because BLCKSZ is too small.");
+		return false;
+	}
+#endif
+
+	*extra = guc_malloc(ERROR, sizeof(int));
+	*((int *) *extra) = newflags;
+
+	return true;
+}
+
+static void
+assign_io_direct(const char *newval, void *extra)
+{
+	io_direct_flags = *((int *) extra);
+}
+
 static void
 assign_syslog_facility(int newval, void *extra)
 {
@@ -11586,33 +11933,17 @@ check_maintenance_io_concurrency(int *newval, void **extra, GucSource source)
 	return true;
 }
 
-static void
-assign_pgstat_temp_directory(const char *newval, void *extra)
+static bool
+check_recovery_prefetch(bool *newval, void **extra, GucSource source)
 {
-	/* check_canonical_path already canonicalized newval for us */
-	char	   *dname;
-	char	   *tname;
-	char	   *fname;
-
-	/* directory */
-	dname = guc_malloc(ERROR, strlen(newval) + 1);	/* runtime dir */
-	sprintf(dname, "%s", newval);
-
-	/* global stats */
-	tname = guc_malloc(ERROR, strlen(newval) + 12); /* /global.tmp */
-	sprintf(tname, "%s/global.tmp", newval);
-	fname = guc_malloc(ERROR, strlen(newval) + 13); /* /global.stat */
-	sprintf(fname, "%s/global.stat", newval);
-
-	if (pgstat_stat_directory)
-		free(pgstat_stat_directory);
-	pgstat_stat_directory = dname;
-	if (pgstat_stat_tmpname)
-		free(pgstat_stat_tmpname);
-	pgstat_stat_tmpname = tname;
-	if (pgstat_stat_filename)
-		free(pgstat_stat_filename);
-	pgstat_stat_filename = fname;
+#ifndef USE_PREFETCH
+	if (*newval)
+	{
+		GUC_check_errdetail("recovery_prefetch is not supported on platforms that lack posix_fadvise().");
+		return false;
+	}
+#endif							/* USE_PREFETCH */
+	return true;
 }
 
 static bool
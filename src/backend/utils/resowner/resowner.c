@@ -22,6 +22,7 @@
 
 #include "common/hashfn.h"
 #include "jit/jit.h"
+#include "storage/aio.h"
 #include "storage/bufmgr.h"
 #include "storage/ipc.h"
 #include "storage/predicate.h"
@@ -43,6 +44,8 @@
 #define DatumGetFile(datum) ((File) DatumGetInt32(datum))
 #define BufferGetDatum(buffer) Int32GetDatum(buffer)
 #define DatumGetBuffer(datum) ((Buffer) DatumGetInt32(datum))
+#define AioHandleGetDatum(id) Int32GetDatum(id)
+#define DatumGetAioHandle(datum) DatumGetInt32(datum)
 
 /*
  * ResourceArray is a common structure for storing all types of resource IDs.
@@ -128,6 +131,7 @@ typedef struct ResourceOwnerData
 	ResourceArray filearr;		/* open temporary files */
 	ResourceArray dsmarr;		/* dynamic shmem segments */
 	ResourceArray jitarr;		/* JIT contexts */
+	ResourceArray aiohandlearr;	/* asynchronous I/O handles */
 
 	/* We can remember up to MAX_RESOWNER_LOCKS references to local locks. */
 	int			nlocks;			/* number of owned locks */
@@ -175,6 +179,7 @@ static void PrintTupleDescLeakWarning(TupleDesc tupdesc);
 static void PrintSnapshotLeakWarning(Snapshot snapshot);
 static void PrintFileLeakWarning(File file);
 static void PrintDSMLeakWarning(dsm_segment *seg);
+static void PrintAioHandleLeakWarning(int id);
 
 
 /*****************************************************************************
@@ -444,6 +449,7 @@ ResourceOwnerCreate(ResourceOwner parent, const char *name)
 	ResourceArrayInit(&(owner->filearr), FileGetDatum(-1));
 	ResourceArrayInit(&(owner->dsmarr), PointerGetDatum(NULL));
 	ResourceArrayInit(&(owner->jitarr), PointerGetDatum(NULL));
+	ResourceArrayInit(&(owner->aiohandlearr), AioHandleGetDatum(-1));
 
 	return owner;
 }
@@ -508,6 +514,20 @@ ResourceOwnerReleaseInternal(ResourceOwner owner,
 
 	if (phase == RESOURCE_RELEASE_BEFORE_LOCKS)
 	{
+		/*
+		 * Release asynchronous I/O handles.  This waits for any I/O still in
+		 * flight, so it has to happen before buffer pins are released: the
+		 * I/O might be reading into one of those buffers.
+		 */
+		while (ResourceArrayGetAny(&(owner->aiohandlearr), &foundres))
+		{
+			int			res = DatumGetAioHandle(foundres);
+
+			if (isCommit)
+				PrintAioHandleLeakWarning(res);
+			pgaio_io_release_resowner(res);
+		}
+
 		/*
 		 * Release buffer pins.  Note that ReleaseBuffer will remove the
 		 * buffer entry from our array, so we just have to iterate till there
@@ -725,6 +745,7 @@ ResourceOwnerDelete(ResourceOwner owner)
 	Assert(owner->filearr.nitems == 0);
 	Assert(owner->dsmarr.nitems == 0);
 	Assert(owner->jitarr.nitems == 0);
+	Assert(owner->aiohandlearr.nitems == 0);
 	Assert(owner->nlocks == 0 || owner->nlocks == MAX_RESOWNER_LOCKS + 1);
 
 	/*
@@ -752,6 +773,7 @@ ResourceOwnerDelete(ResourceOwner owner)
 	ResourceArrayFree(&(owner->filearr));
 	ResourceArrayFree(&(owner->dsmarr));
 	ResourceArrayFree(&(owner->jitarr));
+	ResourceArrayFree(&(owner->aiohandlearr));
 
 	pfree(owner);
 }
@@ -1370,3 +1392,47 @@ ResourceOwnerForgetJIT(ResourceOwner owner, Datum handle)
 		elog(ERROR, "JIT context %p is not owned by resource owner %s",
 			 DatumGetPointer(handle), owner->name);
 }
+
+/*
+ * Make sure there is room for at least one more entry in a ResourceOwner's
+ * asynchronous I/O handle array.
+ *
+ * This is separate from actually inserting an entry because if we run out of
+ * memory, it's critical to do so *before* acquiring the resource.
+ */
+void
+ResourceOwnerEnlargeAioHandles(ResourceOwner owner)
+{
+	ResourceArrayEnlarge(&(owner->aiohandlearr));
+}
+
+/*
+ * Remember that an asynchronous I/O handle is owned by a ResourceOwner
+ *
+ * Caller must have previously done ResourceOwnerEnlargeAioHandles()
+ */
+void
+ResourceOwnerRememberAioHandle(ResourceOwner owner, int id)
+{
+	ResourceArrayAdd(&(owner->aiohandlearr), AioHandleGetDatum(id));
+}
+
+/*
+ * Forget that an asynchronous I/O handle is owned by a ResourceOwner
+ */
+void
+ResourceOwnerForgetAioHandle(ResourceOwner owner, int id)
+{
+	if (!ResourceArrayRemove(&(owner->aiohandlearr), AioHandleGetDatum(id)))
+		elog(ERROR, "I/O handle %d is not owned by resource owner %s",
+			 id, owner->name);
+}
+
+/*
+ * Debugging subroutine
+ */
+static void
+PrintAioHandleLeakWarning(int id)
+{
+	elog(WARNING, "I/O handle leak: handle %d still referenced", id);
+}
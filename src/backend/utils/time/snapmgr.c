@@ -161,7 +161,9 @@ static Snapshot HistoricSnapshot = NULL;
  * RecentGlobalXmin and RecentGlobalDataXmin are initialized to
  * InvalidTransactionId, to ensure that no one tries to use a stale
  * value. Readers should ensure that it has been set to something else
- * before using it.
+ * before using it.  GetSnapshotData only sets them for the first snapshot of
+ * a backend; afterwards they are recomputed lazily, see
+ * UpdateRecentGlobalXmin and MaybeUpdateRecentGlobalXmin.
  */
 TransactionId TransactionXmin = FirstNormalTransactionId;
 TransactionId RecentXmin = FirstNormalTransactionId;
@@ -604,6 +606,9 @@ SetTransactionSnapshot(Snapshot sourcesnap, VirtualTransactionId *sourcevxid,
 	CurrentSnapshot->takenDuringRecovery = sourcesnap->takenDuringRecovery;
 	/* NB: curcid should NOT be copied, it's a local matter */
 
+	/* The contents no longer match what GetSnapshotData would compute */
+	CurrentSnapshot->snapXactCompletionCount = 0;
+
 	/*
 	 * Now we have to fix what GetSnapshotData did with MyPgXact->xmin and
 	 * TransactionXmin.  There is a race condition: to make sure we are not
@@ -2211,6 +2216,7 @@ RestoreSnapshot(char *start_address)
 	snapshot->regd_count = 0;
 	snapshot->active_count = 0;
 	snapshot->copied = true;
+	snapshot->snapXactCompletionCount = 0;
 
 	return snapshot;
 }
@@ -25,11 +25,19 @@
 #ifdef HAVE_LIBZ
 #include <zlib.h>
 #endif
+#ifdef USE_LZ4
+#include <lz4frame.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
 
 #include "access/xlog_internal.h"
+#include "common/backup_compression.h"
 #include "common/file_perm.h"
 #include "common/file_utils.h"
 #include "common/logging.h"
+#include "common/parse_manifest.h"
 #include "common/string.h"
 #include "fe_utils/recovery_gen.h"
 #include "fe_utils/string_utils.h"
@@ -77,6 +85,13 @@ typedef struct WriteTarState
 #endif
 } WriteTarState;
 
+/* Where the prior backup of an incremental backup started */
+typedef struct WALRangeState
+{
+	XLogRecPtr	start_lsn;
+	TimeLineID	start_tli;
+} WALRangeState;
+
 typedef struct UnpackTarState
 {
 	int			tablespacenum;
@@ -88,6 +103,33 @@ typedef struct UnpackTarState
 	FILE	   *file;
 } UnpackTarState;
 
+/*
+ * State for unpacking a tar stream that the server compressed.  The
+ * decompressed data is cut into the pieces ReceiveTarAndUnpackCopyChunk()
+ * expects from an uncompressed stream: each tar header as a whole, the data
+ * of a file, and the padding after it on its own.
+ */
+typedef struct DecompressTarState
+{
+	UnpackTarState *unpack;
+	char		tarhdr[512];
+	size_t		tarhdrsz;		/* bytes of the next header received */
+	pgoff_t		data_left;		/* bytes of the current file still due */
+	int			padding;		/* padding after the current file */
+	int			padding_left;	/* ... and how much of it is still due */
+	char	   *outbuf;
+	size_t		outbufsize;
+#ifdef HAVE_LIBZ
+	z_stream	zstream;
+#endif
+#ifdef USE_LZ4
+	LZ4F_decompressionContext_t lz4ctx;
+#endif
+#ifdef USE_ZSTD
+	ZSTD_DCtx  *zstdctx;
+#endif
+} DecompressTarState;
+
 typedef struct WriteManifestState
 {
 	char		filename[MAXPGPATH];
@@ -150,6 +192,11 @@ static bool verify_checksums = true;
 static bool manifest = true;
 static bool manifest_force_encode = false;
 static char *manifest_checksums = NULL;
+static char *incremental_manifest = NULL;
+static pg_backup_compression server_compression = BACKUP_COMPRESSION_NONE;
+static int	server_compresslevel = -1;	/* -1 for the server's default */
+static int	server_compress_workers = 0;
+static int	num_jobs = 1;
 
 static bool success = false;
 static bool made_new_pgdata = false;
@@ -173,6 +220,11 @@ static int	bgpipe[2] = {-1, -1};
 static pid_t bgchild = -1;
 static bool in_log_streamer = false;
 
+/* Handles to the processes, or threads, receiving from parallel workers */
+static pid_t *jobchildren = NULL;
+static int	njobchildren = 0;
+static bool in_parallel_job = false;
+
 /* End position for xlog streaming, empty string if unknown yet */
 static XLogRecPtr xlogendptr;
 
@@ -192,7 +244,15 @@ static void progress_report(int tablespacenum, const char *filename, bool force)
 
 static void ReceiveTarFile(PGconn *conn, PGresult *res, int rownum);
 static void ReceiveTarCopyChunk(size_t r, char *copybuf, void *callback_data);
+static void ReceiveCompressedTarFile(PGconn *conn, PGresult *res, int rownum);
+static void ReceiveCompressedTarCopyChunk(size_t r, char *copybuf,
+										  void *callback_data);
 static void ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum);
+static void ReceiveAndDecompressCopyData(PGconn *conn, UnpackTarState *unpack);
+static void DecompressTarCopyChunk(size_t r, char *copybuf,
+								   void *callback_data);
+static void UnpackDecompressedData(DecompressTarState *state, char *data,
+								   size_t len) pg_attribute_unused();
 static void ReceiveTarAndUnpackCopyChunk(size_t r, char *copybuf,
 										 void *callback_data);
 static void ReceiveBackupManifest(PGconn *conn);
@@ -201,7 +261,20 @@ static void ReceiveBackupManifestChunk(size_t r, char *copybuf,
 static void ReceiveBackupManifestInMemory(PGconn *conn, PQExpBuffer buf);
 static void ReceiveBackupManifestInMemoryChunk(size_t r, char *copybuf,
 											   void *callback_data);
+static void GetPriorBackupStart(const char *manifest_path,
+								XLogRecPtr *start_lsn, TimeLineID *start_tli);
+static void prior_manifest_file(JsonManifestParseContext *context,
+								char *pathname, size_t size,
+								pg_checksum_type checksum_type,
+								int checksum_length, uint8 *checksum_payload);
+static void prior_manifest_wal_range(JsonManifestParseContext *context,
+									 TimeLineID tli,
+									 XLogRecPtr start_lsn, XLogRecPtr end_lsn);
+static void prior_manifest_error(JsonManifestParseContext *context,
+								 char *fmt,...) pg_attribute_printf(2, 3);
 static void BaseBackup(void);
+static void StartParallelJobs(PGresult *res, int leader_pid);
+static void WaitForParallelJobs(void);
 
 static bool reached_end_position(XLogRecPtr segendpos, uint32 timeline,
 								 bool segment_finished);
@@ -213,7 +286,7 @@ static void tablespace_list_append(const char *arg);
 static void
 cleanup_directories_atexit(void)
 {
-	if (success || in_log_streamer)
+	if (success || in_log_streamer || in_parallel_job)
 		return;
 
 	if (!noclean && !checksum_failure)
@@ -276,6 +349,21 @@ kill_bgchild_atexit(void)
 	if (bgchild > 0)
 		kill(bgchild, SIGTERM);
 }
+
+/*
+ * Likewise, kill off the processes receiving the files of a parallel backup.
+ */
+static void
+kill_jobchildren_atexit(void)
+{
+	int			i;
+
+	for (i = 0; i < njobchildren; i++)
+	{
+		if (jobchildren[i] > 0)
+			kill(jobchildren[i], SIGTERM);
+	}
+}
 #endif
 
 /*
@@ -382,6 +470,10 @@ usage(void)
 	printf(_("\nOptions controlling the output:\n"));
 	printf(_("  -D, --pgdata=DIRECTORY receive base backup into directory\n"));
 	printf(_("  -F, --format=p|t       output format (plain (default), tar)\n"));
+	printf(_("  -i, --incremental=OLDMANIFEST\n"
+			 "                         take incremental backup relative to the backup\n"
+			 "                         with the given manifest\n"));
+	printf(_("  -j, --jobs=NUM         use this many connections to receive the backup\n"));
 	printf(_("  -r, --max-rate=RATE    maximum transfer rate to transfer data directory\n"
 			 "                         (in kB/s, or use suffix \"k\" or \"M\")\n"));
 	printf(_("  -R, --write-recovery-conf\n"
@@ -393,6 +485,11 @@ usage(void)
 			 "                         include required WAL files with specified method\n"));
 	printf(_("  -z, --gzip             compress tar output\n"));
 	printf(_("  -Z, --compress=0-9     compress tar output with given compression level\n"));
+	printf(_("      --server-compress=METHOD[:LEVEL]\n"
+			 "                         have the server compress the backup with gzip,\n"
+			 "                         lz4 or zstd\n"));
+	printf(_("      --server-compress-workers=NUM\n"
+			 "                         use this many threads to compress with zstd\n"));
 	printf(_("\nGeneral options:\n"));
 	printf(_("  -c, --checkpoint=fast|spread\n"
 			 "                         set fast or spread checkpointing\n"));
@@ -710,6 +807,169 @@ StartLogStreamer(char *startpos, uint32 timeline, char *sysidentifier)
 #endif
 }
 
+typedef struct
+{
+	PGconn	   *jobconn;
+	PGresult   *res;			/* the tablespaces, from the backup header */
+	int			leader_pid;
+} paralleljob_param;
+
+static int
+ParallelJobMain(paralleljob_param *param)
+{
+	PGresult   *res;
+	char	   *command;
+	int			i;
+
+	command = psprintf("BASE_BACKUP PARALLEL_WORKER %d", param->leader_pid);
+	if (PQsendQuery(param->jobconn, command) == 0)
+	{
+		pg_log_error("could not send replication command \"%s\": %s",
+					 "BASE_BACKUP", PQerrorMessage(param->jobconn));
+		return 1;
+	}
+
+	/* We get the same tablespaces as the leader, in the same order */
+	for (i = 0; i < PQntuples(param->res); i++)
+		ReceiveAndUnpackTarFile(param->jobconn, param->res, i);
+
+	res = PQgetResult(param->jobconn);
+	if (PQresultStatus(res) != PGRES_COMMAND_OK)
+	{
+		pg_log_error("parallel backup job failed: %s",
+					 PQerrorMessage(param->jobconn));
+		return 1;
+	}
+	PQclear(res);
+
+	PQfinish(param->jobconn);
+
+	return 0;
+}
+
+/*
+ * Start the jobs of a parallel backup, one less than the number of
+ * connections requested.  Each opens a connection of its own, joins the
+ * backup led by the walsender of our main connection, and unpacks the files
+ * it receives into the same directories as we do.  Like the log streamer,
+ * a job is a child process on Unix and a thread on Windows.
+ */
+static void
+StartParallelJobs(PGresult *res, int leader_pid)
+{
+	int			i;
+
+	jobchildren = pg_malloc0(sizeof(pid_t) * (num_jobs - 1));
+
+	for (i = 0; i < num_jobs - 1; i++)
+	{
+		paralleljob_param *param;
+
+		param = pg_malloc0(sizeof(paralleljob_param));
+		param->res = res;
+		param->leader_pid = leader_pid;
+		param->jobconn = GetConnection();
+		if (!param->jobconn)
+			/* Error message already written in GetConnection() */
+			exit(1);
+
+#ifndef WIN32
+		jobchildren[i] = fork();
+		if (jobchildren[i] == 0)
+		{
+			/*
+			 * In child process.  Leave the main connection, the log streamer
+			 * and the output directories alone when exiting.
+			 */
+			conn = NULL;
+			bgchild = -1;
+			njobchildren = 0;
+			in_parallel_job = true;
+			exit(ParallelJobMain(param));
+		}
+		else if (jobchildren[i] < 0)
+		{
+			pg_log_error("could not create background process: %m");
+			exit(1);
+		}
+		if (njobchildren++ == 0)
+			atexit(kill_jobchildren_atexit);
+#else							/* WIN32 */
+		jobchildren[i] = _beginthreadex(NULL, 0, (void *) ParallelJobMain,
+										param, 0, NULL);
+		if (jobchildren[i] == 0)
+		{
+			pg_log_error("could not create background thread: %m");
+			exit(1);
+		}
+		njobchildren++;
+#endif
+	}
+}
+
+/*
+ * Wait for the jobs of a parallel backup to finish, and check that they
+ * succeeded.
+ */
+static void
+WaitForParallelJobs(void)
+{
+	int			i;
+
+	if (verbose)
+		pg_log_info("waiting for parallel backup jobs to finish ...");
+
+	for (i = 0; i < njobchildren; i++)
+	{
+#ifndef WIN32
+		int			status;
+		pid_t		r;
+
+		r = waitpid(jobchildren[i], &status, 0);
+		if (r == (pid_t) -1)
+		{
+			pg_log_error("could not wait for child process: %m");
+			exit(1);
+		}
+		if (status != 0)
+		{
+			pg_log_error("%s", wait_result_to_str(status));
+			exit(1);
+		}
+		/* Don't kill it off at exit, it's gone */
+		jobchildren[i] = -1;
+#else							/* WIN32 */
+		DWORD		status;
+
+		/*
+		 * get a pointer sized version of the handle to avoid warnings about
+		 * casting to a different size on WIN64.
+		 */
+		intptr_t	handle = jobchildren[i];
+
+		if (WaitForSingleObjectEx((HANDLE) handle, INFINITE, FALSE) !=
+			WAIT_OBJECT_0)
+		{
+			_dosmaperr(GetLastError());
+			pg_log_error("could not wait for child thread: %m");
+			exit(1);
+		}
+		if (GetExitCodeThread((HANDLE) handle, &status) == 0)
+		{
+			_dosmaperr(GetLastError());
+			pg_log_error("could not get child thread exit status: %m");
+			exit(1);
+		}
+		if (status != 0)
+		{
+			pg_log_error("child thread exited with error %u",
+						 (unsigned int) status);
+			exit(1);
+		}
+#endif
+	}
+}
+
 /*
  * Verify that the given directory exists and is empty. If it does not
  * exist, it is created. If it exists but is not empty, an error will
@@ -1459,6 +1719,68 @@ ReceiveTarCopyChunk(size_t r, char *copybuf, void *callback_data)
 	progress_report(state->tablespacenum, state->filename, false);
 }
 
+/*
+ * Receive a tar file that the server has compressed, and write it out as is.
+ *
+ * The file will be named base.tar.<ext> if it's for the main data directory
+ * or <tablespaceoid>.tar.<ext> if it's for another tablespace, with the
+ * extension of the compression method.  The server sends complete tar files
+ * in this case, so unlike ReceiveTarFile(), we don't add anything to them.
+ */
+static void
+ReceiveCompressedTarFile(PGconn *conn, PGresult *res, int rownum)
+{
+	WriteTarState state;
+	const char *ext = backup_compression_extension(server_compression);
+
+	memset(&state, 0, sizeof(state));
+	state.tablespacenum = rownum;
+	state.basetablespace = PQgetisnull(res, rownum, 0);
+
+	if (state.basetablespace)
+		snprintf(state.filename, sizeof(state.filename), "%s/base.tar%s",
+				 basedir, ext);
+	else
+		snprintf(state.filename, sizeof(state.filename), "%s/%s.tar%s",
+				 basedir, PQgetvalue(res, rownum, 0), ext);
+
+	state.tarfile = fopen(state.filename, "wb");
+	if (!state.tarfile)
+	{
+		pg_log_error("could not create file \"%s\": %m", state.filename);
+		exit(1);
+	}
+
+	ReceiveCopyData(conn, ReceiveCompressedTarCopyChunk, &state);
+
+	if (fclose(state.tarfile) != 0)
+	{
+		pg_log_error("could not close file \"%s\": %m", state.filename);
+		exit(1);
+	}
+
+	progress_report(rownum, state.filename, true);
+
+	/*
+	 * Do not sync the resulting tar file yet, all files are synced once at
+	 * the end.
+	 */
+}
+
+/*
+ * Receive one chunk of a tar file compressed by the server.
+ */
+static void
+ReceiveCompressedTarCopyChunk(size_t r, char *copybuf, void *callback_data)
+{
+	WriteTarState *state = callback_data;
+
+	writeTarData(state, copybuf, r);
+
+	totaldone += r;
+	progress_report(state->tablespacenum, state->filename, false);
+}
+
 
 /*
  * Retrieve tablespace path, either relocated or original depending on whether
@@ -1508,7 +1830,10 @@ ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
 				get_tablespace_mapping(PQgetvalue(res, rownum, 1)),
 				sizeof(state.current_path));
 
-	ReceiveCopyData(conn, ReceiveTarAndUnpackCopyChunk, &state);
+	if (server_compression != BACKUP_COMPRESSION_NONE)
+		ReceiveAndDecompressCopyData(conn, &state);
+	else
+		ReceiveCopyData(conn, ReceiveTarAndUnpackCopyChunk, &state);
 
 
 	if (state.file)
@@ -1522,15 +1847,248 @@ ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
 		exit(1);
 	}
 
-	if (basetablespace && writerecoveryconf)
-		WriteRecoveryConfig(conn, basedir, recoveryconfcontents);
-
 	/*
 	 * No data is synced here, everything is done for all tablespaces at the
 	 * end.
 	 */
 }
 
+/*
+ * Receive a tar stream that the server has compressed, and pass it on to
+ * ReceiveTarAndUnpackCopyChunk() decompressed.
+ */
+static void
+ReceiveAndDecompressCopyData(PGconn *conn, UnpackTarState *unpack)
+{
+	DecompressTarState state;
+
+	memset(&state, 0, sizeof(state));
+	state.unpack = unpack;
+	state.outbufsize = 65536;
+	state.outbuf = pg_malloc(state.outbufsize);
+
+	/*
+	 * main() has checked that we can handle the compression method, so the
+	 * ifdefs below are only to keep the compiler happy.
+	 */
+	switch (server_compression)
+	{
+		case BACKUP_COMPRESSION_NONE:
+			Assert(false);
+			break;
+		case BACKUP_COMPRESSION_GZIP:
+#ifdef HAVE_LIBZ
+			/* 15 + 16 means a zlib stream with gzip header and trailer */
+			if (inflateInit2(&state.zstream, 15 + 16) != Z_OK)
+			{
+				pg_log_error("could not initialize compression library");
+				exit(1);
+			}
+#endif
+			break;
+		case BACKUP_COMPRESSION_LZ4:
+#ifdef USE_LZ4
+			{
+				LZ4F_errorCode_t ret;
+
+				ret = LZ4F_createDecompressionContext(&state.lz4ctx,
+													  LZ4F_VERSION);
+				if (LZ4F_isError(ret))
+				{
+					pg_log_error("could not create LZ4 decompression context: %s",
+								 LZ4F_getErrorName(ret));
+					exit(1);
+				}
+			}
+#endif
+			break;
+		case BACKUP_COMPRESSION_ZSTD:
+#ifdef USE_ZSTD
+			state.zstdctx = ZSTD_createDCtx();
+			if (state.zstdctx == NULL)
+			{
+				pg_log_error("could not create zstd decompression context");
+				exit(1);
+			}
+#endif
+			break;
+	}
+
+	ReceiveCopyData(conn, DecompressTarCopyChunk, &state);
+
+	if (state.tarhdrsz != 0 || state.data_left != 0 || state.padding_left != 0)
+	{
+		pg_log_error("COPY stream ended before last file was finished");
+		exit(1);
+	}
+
+#ifdef HAVE_LIBZ
+	if (server_compression == BACKUP_COMPRESSION_GZIP)
+		inflateEnd(&state.zstream);
+#endif
+#ifdef USE_LZ4
+	if (server_compression == BACKUP_COMPRESSION_LZ4)
+		LZ4F_freeDecompressionContext(state.lz4ctx);
+#endif
+#ifdef USE_ZSTD
+	if (server_compression == BACKUP_COMPRESSION_ZSTD)
+		ZSTD_freeDCtx(state.zstdctx);
+#endif
+	pg_free(state.outbuf);
+}
+
+/*
+ * Decompress one chunk of a tar stream compressed by the server.
+ */
+static void
+DecompressTarCopyChunk(size_t r, char *copybuf, void *callback_data)
+{
+	DecompressTarState *state pg_attribute_unused() = callback_data;
+
+	switch (server_compression)
+	{
+		case BACKUP_COMPRESSION_NONE:
+			Assert(false);
+			break;
+		case BACKUP_COMPRESSION_GZIP:
+#ifdef HAVE_LIBZ
+			state->zstream.next_in = (Bytef *) copybuf;
+			state->zstream.avail_in = r;
+			do
+			{
+				int			ret;
+
+				state->zstream.next_out = (Bytef *) state->outbuf;
+				state->zstream.avail_out = state->outbufsize;
+				ret = inflate(&state->zstream, Z_NO_FLUSH);
+				if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+				{
+					pg_log_error("could not decompress data: %s",
+								 state->zstream.msg ? state->zstream.msg :
+								 "unknown error");
+					exit(1);
+				}
+				UnpackDecompressedData(state, state->outbuf,
+									   state->outbufsize - state->zstream.avail_out);
+				if (ret == Z_STREAM_END)
+					break;
+			} while (state->zstream.avail_in > 0 ||
+					 state->zstream.avail_out == 0);
+#endif
+			break;
+		case BACKUP_COMPRESSION_LZ4:
+#ifdef USE_LZ4
+			{
+				char	   *in = copybuf;
+				size_t		in_left = r;
+				size_t		outsize;
+
+				/* Loop until all input is consumed and all output drained */
+				do
+				{
+					size_t		insize = in_left;
+					size_t		ret;
+
+					outsize = state->outbufsize;
+					ret = LZ4F_decompress(state->lz4ctx, state->outbuf, &outsize,
+										  in, &insize, NULL);
+					if (LZ4F_isError(ret))
+					{
+						pg_log_error("could not decompress data: %s",
+									 LZ4F_getErrorName(ret));
+						exit(1);
+					}
+					UnpackDecompressedData(state, state->outbuf, outsize);
+					in += insize;
+					in_left -= insize;
+				} while (in_left > 0 || outsize == state->outbufsize);
+			}
+#endif
+			break;
+		case BACKUP_COMPRESSION_ZSTD:
+#ifdef USE_ZSTD
+			{
+				ZSTD_inBuffer in;
+				ZSTD_outBuffer out;
+
+				in.src = copybuf;
+				in.size = r;
+				in.pos = 0;
+				do
+				{
+					size_t		ret;
+
+					out.dst = state->outbuf;
+					out.size = state->outbufsize;
+					out.pos = 0;
+					ret = ZSTD_decompressStream(state->zstdctx, &out, &in);
+					if (ZSTD_isError(ret))
+					{
+						pg_log_error("could not decompress data: %s",
+									 ZSTD_getErrorName(ret));
+						exit(1);
+					}
+					UnpackDecompressedData(state, state->outbuf, out.pos);
+				} while (in.pos < in.size || out.pos == out.size);
+			}
+#endif
+			break;
+	}
+}
+
+/*
+ * Pass decompressed tar data on to ReceiveTarAndUnpackCopyChunk(), in the
+ * pieces it expects.  The blocks of zeroes that end the tar file are
+ * skipped.
+ */
+static void
+UnpackDecompressedData(DecompressTarState *state, char *data, size_t len)
+{
+	static char zerobuf[512];
+
+	while (len > 0)
+	{
+		size_t		n;
+
+		if (state->data_left > 0)
+		{
+			n = Min(len, state->data_left);
+			ReceiveTarAndUnpackCopyChunk(n, data, state->unpack);
+			state->data_left -= n;
+		}
+		else if (state->padding_left > 0)
+		{
+			n = Min(len, state->padding_left);
+			state->padding_left -= n;
+			if (state->padding_left == 0)
+				ReceiveTarAndUnpackCopyChunk(state->padding, zerobuf,
+											 state->unpack);
+		}
+		else
+		{
+			n = Min(len, sizeof(state->tarhdr) - state->tarhdrsz);
+			memcpy(state->tarhdr + state->tarhdrsz, data, n);
+			state->tarhdrsz += n;
+			if (state->tarhdrsz == sizeof(state->tarhdr))
+			{
+				state->tarhdrsz = 0;
+				if (memcmp(state->tarhdr, zerobuf, sizeof(zerobuf)) != 0)
+				{
+					state->data_left = read_tar_number(&state->tarhdr[124], 12);
+					state->padding = state->padding_left =
+						((state->data_left + 511) & ~511) - state->data_left;
+					ReceiveTarAndUnpackCopyChunk(sizeof(state->tarhdr),
+												 state->tarhdr,
+												 state->unpack);
+				}
+			}
+		}
+
+		data += n;
+		len -= n;
+	}
+}
+
 static void
 ReceiveTarAndUnpackCopyChunk(size_t r, char *copybuf, void *callback_data)
 {
@@ -1590,11 +2148,13 @@ ReceiveTarAndUnpackCopyChunk(size_t r, char *copybuf, void *callback_data)
 					 * specified, pg_wal (or pg_xlog) has already been created
 					 * as a symbolic link before starting the actual backup.
 					 * So just ignore creation failures on related
-					 * directories.
+					 * directories.  In a parallel backup, every connection
+					 * sends all the directories, so any of them may exist.
 					 */
 					if (!((pg_str_endswith(state->filename, "/pg_wal") ||
 						   pg_str_endswith(state->filename, "/pg_xlog") ||
-						   pg_str_endswith(state->filename, "/archive_status")) &&
+						   pg_str_endswith(state->filename, "/archive_status") ||
+						   num_jobs > 1) &&
 						  errno == EEXIST))
 					{
 						pg_log_error("could not create directory \"%s\": %m",
@@ -1765,6 +2325,107 @@ ReceiveBackupManifestInMemoryChunk(size_t r, char *copybuf,
 	appendPQExpBuffer(buf, copybuf, r);
 }
 
+/*
+ * Find out from its backup manifest where the prior backup of an
+ * incremental backup started.
+ *
+ * The manifest lists the WAL ranges needed to restore the backup, the one
+ * that includes the start of the backup last.
+ */
+static void
+GetPriorBackupStart(const char *manifest_path, XLogRecPtr *start_lsn,
+					TimeLineID *start_tli)
+{
+	int			fd;
+	struct stat statbuf;
+	char	   *buffer;
+	int			rc;
+	WALRangeState state;
+	JsonManifestParseContext context;
+
+	if ((fd = open(manifest_path, O_RDONLY | PG_BINARY, 0)) < 0)
+	{
+		pg_log_error("could not open file \"%s\": %m", manifest_path);
+		exit(1);
+	}
+	if (fstat(fd, &statbuf) != 0)
+	{
+		pg_log_error("could not stat file \"%s\": %m", manifest_path);
+		exit(1);
+	}
+
+	buffer = pg_malloc(statbuf.st_size);
+	rc = read(fd, buffer, statbuf.st_size);
+	if (rc != statbuf.st_size)
+	{
+		if (rc < 0)
+			pg_log_error("could not read file \"%s\": %m", manifest_path);
+		else
+			pg_log_error("could not read file \"%s\": read %d of %zu",
+						 manifest_path, rc, (size_t) statbuf.st_size);
+		exit(1);
+	}
+	close(fd);
+
+	state.start_lsn = InvalidXLogRecPtr;
+	state.start_tli = 0;
+	context.private_data = &state;
+	context.perfile_cb = prior_manifest_file;
+	context.perwalrange_cb = prior_manifest_wal_range;
+	context.error_cb = prior_manifest_error;
+	json_parse_manifest(&context, buffer, statbuf.st_size);
+
+	pg_free(buffer);
+
+	/* The parser insists on at least one WAL range, but be sure. */
+	if (state.start_tli == 0)
+	{
+		pg_log_error("backup manifest \"%s\" contains no WAL ranges",
+					 manifest_path);
+		exit(1);
+	}
+
+	*start_lsn = state.start_lsn;
+	*start_tli = state.start_tli;
+}
+
+/*
+ * Manifest parser callbacks for GetPriorBackupStart().
+ */
+static void
+prior_manifest_file(JsonManifestParseContext *context, char *pathname,
+					size_t size, pg_checksum_type checksum_type,
+					int checksum_length, uint8 *checksum_payload)
+{
+	/* Only the WAL ranges are of interest. */
+}
+
+static void
+prior_manifest_wal_range(JsonManifestParseContext *context, TimeLineID tli,
+						 XLogRecPtr start_lsn, XLogRecPtr end_lsn)
+{
+	WALRangeState *state = context->private_data;
+
+	state->start_lsn = start_lsn;
+	state->start_tli = tli;
+}
+
+/*
+ * Errors in the prior backup's manifest are fatal; the parser expects this
+ * function not to return.
+ */
+static void
+prior_manifest_error(JsonManifestParseContext *context, char *fmt,...)
+{
+	va_list		ap;
+
+	va_start(ap, fmt);
+	pg_log_generic_v(PG_LOG_FATAL, fmt, ap);
+	va_end(ap);
+
+	exit(1);
+}
+
 static void
 BaseBackup(void)
 {
@@ -1777,6 +2438,9 @@ BaseBackup(void)
 	char	   *maxrate_clause = NULL;
 	char	   *manifest_clause = NULL;
 	char	   *manifest_checksums_clause = "";
+	char	   *incremental_clause = "";
+	char	   *compression_clause = "";
+	char	   *parallel_clause = "";
 	int			i;
 	char		xlogstart[64];
 	char		xlogend[64];
@@ -1850,6 +2514,37 @@ BaseBackup(void)
 												 manifest_checksums);
 	}
 
+	if (incremental_manifest != NULL)
+	{
+		XLogRecPtr	prior_lsn;
+		TimeLineID	prior_tli;
+
+		GetPriorBackupStart(incremental_manifest, &prior_lsn, &prior_tli);
+		incremental_clause = psprintf("INCREMENTAL %X/%X TIMELINE %u",
+									  (uint32) (prior_lsn >> 32),
+									  (uint32) prior_lsn, prior_tli);
+	}
+
+	if (server_compression != BACKUP_COMPRESSION_NONE)
+	{
+		PQExpBufferData buf;
+
+		initPQExpBuffer(&buf);
+		appendPQExpBuffer(&buf, "COMPRESSION '%s'",
+						  backup_compression_name(server_compression));
+		if (server_compresslevel != -1)
+			appendPQExpBuffer(&buf, " COMPRESSION_LEVEL %d",
+							  server_compresslevel);
+		if (server_compress_workers > 0)
+			appendPQExpBuffer(&buf, " COMPRESSION_WORKERS %d",
+							  server_compress_workers);
+		compression_clause = pg_strdup(buf.data);
+		termPQExpBuffer(&buf);
+	}
+
+	if (num_jobs > 1)
+		parallel_clause = psprintf("PARALLEL %d", num_jobs);
+
 	if (verbose)
 		pg_log_info("initiating base backup, waiting for checkpoint to complete");
 
@@ -1863,7 +2558,7 @@ BaseBackup(void)
 	}
 
 	basebkp =
-		psprintf("BASE_BACKUP LABEL '%s' %s %s %s %s %s %s %s %s %s",
+		psprintf("BASE_BACKUP LABEL '%s' %s %s %s %s %s %s %s %s %s %s %s %s",
 				 escaped_label,
 				 estimatesize ? "PROGRESS" : "",
 				 includewal == FETCH_WAL ? "WAL" : "",
@@ -1873,7 +2568,10 @@ BaseBackup(void)
 				 format == 't' ? "TABLESPACE_MAP" : "",
 				 verify_checksums ? "" : "NOVERIFY_CHECKSUMS",
 				 manifest_clause ? manifest_clause : "",
-				 manifest_checksums_clause);
+				 manifest_checksums_clause,
+				 incremental_clause,
+				 compression_clause,
+				 parallel_clause);
 
 	if (PQsendQuery(conn, basebkp) == 0)
 	{
@@ -1980,17 +2678,40 @@ BaseBackup(void)
 		StartLogStreamer(xlogstart, starttli, sysidentifier);
 	}
 
+	/*
+	 * In a parallel backup, open the other connections, which receive their
+	 * share of the files while we receive ours.
+	 */
+	if (num_jobs > 1)
+	{
+		if (verbose)
+			pg_log_info("starting %d parallel backup jobs", num_jobs - 1);
+		StartParallelJobs(res, PQbackendPID(conn));
+	}
+
 	/*
 	 * Start receiving chunks
 	 */
 	for (i = 0; i < PQntuples(res); i++)
 	{
 		if (format == 't')
-			ReceiveTarFile(conn, res, i);
+		{
+			if (server_compression != BACKUP_COMPRESSION_NONE)
+				ReceiveCompressedTarFile(conn, res, i);
+			else
+				ReceiveTarFile(conn, res, i);
+		}
 		else
+		{
 			ReceiveAndUnpackTarFile(conn, res, i);
+			if (writerecoveryconf && PQgetisnull(res, i, 0))
+				WriteRecoveryConfig(conn, basedir, recoveryconfcontents);
+		}
 	}							/* Loop over all tablespaces */
 
+	if (njobchildren > 0)
+		WaitForParallelJobs();
+
 	/*
 	 * Now receive backup manifest, if appropriate.
 	 *
@@ -2205,6 +2926,8 @@ main(int argc, char **argv)
 		{"version", no_argument, NULL, 'V'},
 		{"pgdata", required_argument, NULL, 'D'},
 		{"format", required_argument, NULL, 'F'},
+		{"incremental", required_argument, NULL, 'i'},
+		{"jobs", required_argument, NULL, 'j'},
 		{"checkpoint", required_argument, NULL, 'c'},
 		{"create-slot", no_argument, NULL, 'C'},
 		{"max-rate", required_argument, NULL, 'r'},
@@ -2233,6 +2956,8 @@ main(int argc, char **argv)
 		{"no-manifest", no_argument, NULL, 5},
 		{"manifest-force-encode", no_argument, NULL, 6},
 		{"manifest-checksums", required_argument, NULL, 7},
+		{"server-compress", required_argument, NULL, 8},
+		{"server-compress-workers", required_argument, NULL, 9},
 		{NULL, 0, NULL, 0}
 	};
 	int			c;
@@ -2260,7 +2985,7 @@ main(int argc, char **argv)
 
 	atexit(cleanup_directories_atexit);
 
-	while ((c = getopt_long(argc, argv, "CD:F:r:RS:T:X:l:nNzZ:d:c:h:p:U:s:wWkvP",
+	while ((c = getopt_long(argc, argv, "CD:F:i:j:r:RS:T:X:l:nNzZ:d:c:h:p:U:s:wWkvP",
 							long_options, &option_index)) != -1)
 	{
 		switch (c)
@@ -2283,6 +3008,17 @@ main(int argc, char **argv)
 					exit(1);
 				}
 				break;
+			case 'i':
+				incremental_manifest = pg_strdup(optarg);
+				break;
+			case 'j':
+				num_jobs = atoi(optarg);
+				if (num_jobs <= 0)
+				{
+					pg_log_error("number of parallel jobs must be at least 1");
+					exit(1);
+				}
+				break;
 			case 'r':
 				maxrate = parse_max_rate(optarg);
 				break;
@@ -2413,6 +3149,44 @@ main(int argc, char **argv)
 			case 7:
 				manifest_checksums = pg_strdup(optarg);
 				break;
+			case 8:
+				{
+					char	   *method = pg_strdup(optarg);
+					char	   *sep = strchr(method, ':');
+
+					if (sep != NULL)
+					{
+						char	   *endptr;
+
+						*sep = '\0';
+						errno = 0;
+						server_compresslevel = strtol(sep + 1, &endptr, 10);
+						if (errno != 0 || *endptr != '\0' ||
+							endptr == sep + 1 || server_compresslevel < 1)
+						{
+							pg_log_error("invalid compression level \"%s\"",
+										 sep + 1);
+							exit(1);
+						}
+					}
+					if (!parse_backup_compression(method, &server_compression))
+					{
+						pg_log_error("invalid compression method \"%s\"",
+									 method);
+						exit(1);
+					}
+					pg_free(method);
+				}
+				break;
+			case 9:
+				server_compress_workers = atoi(optarg);
+				if (server_compress_workers <= 0)
+				{
+					pg_log_error("invalid number of compression workers \"%s\"",
+								 optarg);
+					exit(1);
+				}
+				break;
 			default:
 
 				/*
@@ -2551,6 +3325,14 @@ main(int argc, char **argv)
 		exit(1);
 	}
 
+	if (!manifest && incremental_manifest != NULL)
+	{
+		pg_log_error("--no-manifest and --incremental are incompatible options");
+		fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+				progname);
+		exit(1);
+	}
+
 	if (!manifest && manifest_force_encode)
 	{
 		pg_log_error("--no-manifest and --manifest-force-encode are incompatible options");
@@ -2559,6 +3341,85 @@ main(int argc, char **argv)
 		exit(1);
 	}
 
+	if (server_compression != BACKUP_COMPRESSION_NONE)
+	{
+		if (compresslevel != 0)
+		{
+			pg_log_error("--compress and --server-compress are incompatible options");
+			fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+					progname);
+			exit(1);
+		}
+
+		/*
+		 * The server sends complete compressed tar files, which we write out
+		 * as they are in tar mode, so we can't add anything to them.
+		 */
+		if (format == 't' && writerecoveryconf)
+		{
+			pg_log_error("cannot write recovery configuration into tar files compressed by the server");
+			fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+					progname);
+			exit(1);
+		}
+		if (format == 't' && strcmp(basedir, "-") == 0)
+		{
+			pg_log_error("cannot write tar files compressed by the server to stdout");
+			fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+					progname);
+			exit(1);
+		}
+
+		/* In plain mode, we have to decompress the data ourselves */
+		if (format == 'p' && !backup_compression_supported(server_compression))
+		{
+			pg_log_error("this build does not support compression method \"%s\"",
+						 backup_compression_name(server_compression));
+			exit(1);
+		}
+	}
+	else if (server_compresslevel != -1 || server_compress_workers != 0)
+	{
+		pg_log_error("--server-compress-workers requires --server-compress");
+		fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+				progname);
+		exit(1);
+	}
+
+	if (server_compress_workers != 0 &&
+		server_compression != BACKUP_COMPRESSION_ZSTD)
+	{
+		pg_log_error("--server-compress-workers can only be used with zstd compression");
+		fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+				progname);
+		exit(1);
+	}
+
+	if (num_jobs > 1)
+	{
+		if (format != 'p')
+		{
+			pg_log_error("parallel backups can only be taken in plain mode");
+			fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+					progname);
+			exit(1);
+		}
+		if (incremental_manifest != NULL)
+		{
+			pg_log_error("--jobs and --incremental are incompatible options");
+			fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+					progname);
+			exit(1);
+		}
+		if (showprogress)
+		{
+			pg_log_error("--jobs and --progress are incompatible options");
+			fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+					progname);
+			exit(1);
+		}
+	}
+
 	/* connection in replication mode to server */
 	conn = GetConnection();
 	if (!conn)
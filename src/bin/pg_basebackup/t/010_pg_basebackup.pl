@@ -6,7 +6,7 @@ use File::Basename qw(basename dirname);
 use File::Path qw(rmtree);
 use PostgresNode;
 use TestLib;
-use Test::More tests => 109;
+use Test::More tests => 132;
 
 program_help_ok('pg_basebackup');
 program_version_ok('pg_basebackup');
@@ -176,6 +176,92 @@ $node->command_ok([ 'pg_basebackup', '-D', "$tempdir/tarbackup", '-Ft' ],
 ok(-f "$tempdir/tarbackup/base.tar", 'backup tar was created');
 rmtree("$tempdir/tarbackup");
 
+$node->command_ok(
+	[ 'pg_basebackup', '-D', "$tempdir/backup_parallel", '-j', '3' ],
+	'parallel backup');
+ok(-f "$tempdir/backup_parallel/global/pg_control",
+	'parallel backup has pg_control');
+$node->command_ok([ 'pg_verifybackup', "$tempdir/backup_parallel" ],
+	'parallel backup matches its manifest');
+rmtree("$tempdir/backup_parallel");
+$node->command_fails(
+	[ 'pg_basebackup', '-D', "$tempdir/backup_foo", '-Ft', '-j', '2' ],
+	'parallel backup in tar format fails');
+$node->command_fails(
+	[ 'pg_basebackup', '-D', "$tempdir/backup_foo", '--server-compress=foo' ],
+	'invalid server compression method fails');
+
+# Backups compressed by the server, in both formats.  pg_verifybackup can
+# check a tar backup only once it's unpacked, which needs the program for
+# the method.
+my @server_compress_methods = (
+	[ 'gzip', '.gz',  check_pg_config("#define HAVE_LIBZ 1"), $ENV{GZIP_PROGRAM} ],
+	[ 'lz4',  '.lz4', check_pg_config("#define USE_LZ4 1"),  $ENV{LZ4} ],
+	[ 'zstd', '.zst', check_pg_config("#define USE_ZSTD 1"), $ENV{ZSTD} ]);
+foreach my $compress (@server_compress_methods)
+{
+	my ($method, $ext, $built, $program) = @$compress;
+
+  SKIP:
+	{
+		skip "$method compression not supported by this build", 6
+		  unless $built;
+
+		# zstd can use several threads on the server
+		my @workers =
+		  $method eq 'zstd' ? ('--server-compress-workers=2') : ();
+
+		$node->command_ok(
+			[
+				'pg_basebackup', '-D',
+				"$tempdir/backup_$method", "--server-compress=$method",
+				@workers
+			],
+			"plain backup compressed by the server with $method");
+		$node->command_ok([ 'pg_verifybackup', "$tempdir/backup_$method" ],
+			"plain backup compressed with $method matches its manifest");
+		rmtree("$tempdir/backup_$method");
+
+		$node->command_ok(
+			[
+				'pg_basebackup', '-D',
+				"$tempdir/tarbackup_$method", '-Ft',
+				"--server-compress=$method:1", @workers
+			],
+			"tar backup compressed by the server with $method");
+		my $tarfile = "$tempdir/tarbackup_$method/base.tar$ext";
+		ok(-f $tarfile, "backup tar compressed with $method was created");
+
+	  SKIP:
+		{
+			my $have_programs =
+			  defined $program && $program ne ''
+			  && defined $ENV{TAR} && $ENV{TAR} ne ''
+			  && eval { IPC::Run::run [ $program, '--version' ], '>', \my $out, '2>', \my $err };
+			skip "no $method program to decompress the backup", 2
+			  unless $have_programs;
+
+			my $unpacked = "$tempdir/tarbackup_${method}_unpacked";
+			mkdir $unpacked;
+			ok( IPC::Run::run(
+					[ $program, '-dc', $tarfile ], '|',
+					[ $ENV{TAR}, '-xf', '-', '-C', $unpacked ]),
+				"backup tar compressed with $method can be unpacked");
+
+			# The WAL is in pg_wal.tar, which we haven't unpacked
+			$node->command_ok(
+				[
+					'pg_verifybackup', '--no-parse-wal',
+					'--manifest-path',
+					"$tempdir/tarbackup_$method/backup_manifest", $unpacked
+				],
+				"tar backup compressed with $method matches its manifest");
+			rmtree($unpacked);
+		}
+		rmtree("$tempdir/tarbackup_$method");
+	}
+}
+
 $node->command_fails(
 	[ 'pg_basebackup', '-D', "$tempdir/backup_foo", '-Fp', "-T=/foo" ],
 	'-T with empty old directory fails');
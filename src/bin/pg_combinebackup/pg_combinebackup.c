@@ -0,0 +1,1191 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_combinebackup.c
+ *	  Combine an incremental backup with the backups it depends on to
+ *	  reconstruct a full backup.
+ *
+ * The backups are given oldest first: a full backup, followed by a chain of
+ * incremental backups, each taken relative to the one before it.  Every file
+ * of the last backup is written to the output directory.  Files that the last
+ * backup sent in full are copied as they are; incremental files are
+ * reconstructed from the blocks they contain and, for the blocks they don't,
+ * from the same file in the earlier backups.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ *
+ * src/bin/pg_combinebackup/pg_combinebackup.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres_fe.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "catalog/pg_control.h"
+#include "common/checksum_helper.h"
+#include "common/controldata_utils.h"
+#include "common/file_perm.h"
+#include "common/file_utils.h"
+#include "common/incremental_backup.h"
+#include "common/logging.h"
+#include "common/parse_manifest.h"
+#include "common/sha2.h"
+#include "getopt_long.h"
+#include "lib/stringinfo.h"
+#include "storage/block.h"
+
+#define pg_fatal(...) do { pg_log_fatal(__VA_ARGS__); exit(1); } while (0)
+
+/* Size of the buffer used to copy files that were sent in full */
+#define COPY_BUF_SIZE	(128 * 1024)
+
+/* A -T option */
+typedef struct TablespaceMapping
+{
+	struct TablespaceMapping *next;
+	char		old_dir[MAXPGPATH];
+	char		new_dir[MAXPGPATH];
+} TablespaceMapping;
+
+/* What the backup_label of each input backup says about it */
+typedef struct BackupInfo
+{
+	char	   *path;
+	XLogRecPtr	start_lsn;
+	TimeLineID	start_tli;
+	XLogRecPtr	prior_lsn;		/* InvalidXLogRecPtr for a full backup */
+	TimeLineID	prior_tli;
+} BackupInfo;
+
+/* A WAL range from the manifest of the final backup */
+typedef struct WALRange
+{
+	struct WALRange *next;
+	TimeLineID	tli;
+	XLogRecPtr	start_lsn;
+	XLogRecPtr	end_lsn;
+} WALRange;
+
+/* The backup manifest for the output directory, as it is built */
+typedef struct ManifestWriter
+{
+	StringInfoData buf;
+	pg_sha256_ctx manifest_ctx;
+	bool		first_file;
+} ManifestWriter;
+
+/*
+ * A version of a relation segment that blocks of the output file can be
+ * read from: an incremental file, or a file that was sent in full.
+ */
+typedef struct rfile
+{
+	char	   *filename;
+	int			fd;
+	off_t		header_length;	/* offset of the first block */
+	unsigned	num_blocks;
+	BlockNumber *relative_block_numbers;
+	unsigned	truncation_block_length;
+} rfile;
+
+/* An output directory, to be cleaned up if we fail */
+typedef struct OutputDir
+{
+	char	   *path;
+	bool		created;		/* did we create it, or was it empty? */
+} OutputDir;
+
+static const char *progname;
+
+static BackupInfo *backups;
+static int	nbackups;
+static TablespaceMapping *tablespace_mappings = NULL;
+static pg_checksum_type checksum_type = CHECKSUM_TYPE_CRC32C;
+static ManifestWriter *manifest = NULL;
+static char *output = NULL;
+
+static OutputDir *output_dirs = NULL;
+static int	noutput_dirs = 0;
+static bool success = false;
+
+static void usage(void);
+static void cleanup_directories_atexit(void);
+static void tablespace_mapping_append(const char *arg);
+static const char *get_tablespace_mapping(const char *dir);
+static void read_backup_label(BackupInfo *backup);
+static void check_backup_chain(void);
+static void check_control_files(void);
+static WALRange *read_final_manifest(void);
+static void manifest_file_cb(JsonManifestParseContext *context,
+							 char *pathname, size_t size,
+							 pg_checksum_type type,
+							 int checksum_length, uint8 *checksum_payload);
+static void manifest_wal_range_cb(JsonManifestParseContext *context,
+								  TimeLineID tli,
+								  XLogRecPtr start_lsn, XLogRecPtr end_lsn);
+static void manifest_error_cb(JsonManifestParseContext *context,
+							  char *fmt,...) pg_attribute_printf(2, 3);
+static void create_output_directory(const char *dirname);
+static void process_directory(const char *relpath, const char *outdir);
+static void copy_file(const char *relpath, const char *infile,
+					  const char *outfile, struct stat *statbuf);
+static void reconstruct_file(const char *reldir, const char *name,
+							 const char *outfile, struct stat *statbuf);
+static rfile *open_incremental_rfile(const char *filename);
+static rfile *open_full_rfile(const char *filename, off_t size);
+static void close_rfile(rfile *rf);
+static void read_bytes(rfile *rf, void *buffer, unsigned length);
+static void write_bytes(int fd, const char *filename, const void *buffer,
+						size_t length);
+static void write_backup_label(void);
+static void add_file_to_manifest(const char *pathname, uint64 size,
+								 time_t mtime, pg_checksum_context *ctx);
+static void write_manifest(WALRange *ranges);
+static void append_hex(StringInfo buf, const uint8 *data, int len);
+
+static void
+usage(void)
+{
+	printf(_("%s reconstructs a full backup from an incremental backup and the backups it depends on.\n\n"), progname);
+	printf(_("Usage:\n"));
+	printf(_("  %s [OPTION]... DIRECTORY...\n"), progname);
+	printf(_("\nOptions:\n"));
+	printf(_("  -N, --no-sync          do not wait for changes to be written safely to disk\n"));
+	printf(_("  -o, --output=DIRECTORY output directory\n"));
+	printf(_("  -T, --tablespace-mapping=OLDDIR=NEWDIR\n"
+			 "                         relocate tablespace in OLDDIR to NEWDIR\n"));
+	printf(_("      --manifest-checksums=SHA{224,256,384,512}|CRC32C|NONE\n"
+			 "                         use algorithm for manifest checksums\n"));
+	printf(_("      --no-manifest      suppress generation of backup manifest\n"));
+	printf(_("  -V, --version          output version information, then exit\n"));
+	printf(_("  -?, --help             show this help, then exit\n"));
+	printf(_("\nThe backups must be given oldest first, starting with a full backup.\n"));
+	printf(_("\nReport bugs to <%s>.\n"), PACKAGE_BUGREPORT);
+	printf(_("%s home page: <%s>\n"), PACKAGE_NAME, PACKAGE_URL);
+}
+
+int
+main(int argc, char **argv)
+{
+	static struct option long_options[] = {
+		{"no-sync", no_argument, NULL, 'N'},
+		{"output", required_argument, NULL, 'o'},
+		{"tablespace-mapping", required_argument, NULL, 'T'},
+		{"manifest-checksums", required_argument, NULL, 1},
+		{"no-manifest", no_argument, NULL, 2},
+		{NULL, 0, NULL, 0}
+	};
+	int			c;
+	int			option_index;
+	bool		do_sync = true;
+	bool		no_manifest = false;
+	WALRange   *ranges = NULL;
+	int			i;
+
+	pg_logging_init(argv[0]);
+	progname = get_progname(argv[0]);
+	set_pglocale_pgservice(argv[0], PG_TEXTDOMAIN("pg_combinebackup"));
+
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-?") == 0)
+		{
+			usage();
+			exit(0);
+		}
+		if (strcmp(argv[1], "--version") == 0 || strcmp(argv[1], "-V") == 0)
+		{
+			puts("pg_combinebackup (PostgreSQL) " PG_VERSION);
+			exit(0);
+		}
+	}
+
+	while ((c = getopt_long(argc, argv, "No:T:",
+							long_options, &option_index)) != -1)
+	{
+		switch (c)
+		{
+			case 'N':
+				do_sync = false;
+				break;
+			case 'o':
+				output = pg_strdup(optarg);
+				canonicalize_path(output);
+				break;
+			case 'T':
+				tablespace_mapping_append(optarg);
+				break;
+			case 1:
+				if (!pg_checksum_parse_type(optarg, &checksum_type))
+				{
+					pg_log_error("unrecognized manifest checksum algorithm: \"%s\"",
+								 optarg);
+					exit(1);
+				}
+				break;
+			case 2:
+				no_manifest = true;
+				break;
+			default:
+				fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+						progname);
+				exit(1);
+		}
+	}
+
+	if (optind >= argc)
+	{
+		pg_log_error("no input directories specified");
+		fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+				progname);
+		exit(1);
+	}
+
+	if (output == NULL)
+	{
+		pg_log_error("no output directory specified");
+		fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+				progname);
+		exit(1);
+	}
+
+	/* Find out what each backup is, and check that they fit together. */
+	nbackups = argc - optind;
+	backups = pg_malloc0(sizeof(BackupInfo) * nbackups);
+	for (i = 0; i < nbackups; i++)
+	{
+		backups[i].path = pg_strdup(argv[optind + i]);
+		canonicalize_path(backups[i].path);
+		read_backup_label(&backups[i]);
+	}
+	check_backup_chain();
+	check_control_files();
+
+	/* The new manifest lists the final backup's WAL ranges. */
+	if (!no_manifest)
+	{
+		ranges = read_final_manifest();
+		manifest = pg_malloc0(sizeof(ManifestWriter));
+		initStringInfo(&manifest->buf);
+		pg_sha256_init(&manifest->manifest_ctx);
+		manifest->first_file = true;
+		appendStringInfoString(&manifest->buf,
+							   "{ \"PostgreSQL-Backup-Manifest-Version\": 1,\n"
+							   "\"Files\": [");
+	}
+
+	/* Create the output with the permissions of the final backup. */
+	if (GetDataDirectoryCreatePerm(backups[nbackups - 1].path))
+		umask(pg_mode_mask);
+	atexit(cleanup_directories_atexit);
+	create_output_directory(output);
+
+	process_directory("", output);
+	write_backup_label();
+	if (manifest != NULL)
+		write_manifest(ranges);
+
+	if (do_sync)
+	{
+		pg_log_info("syncing data to disk ...");
+		fsync_pgdata(output, PG_VERSION_NUM);
+	}
+
+	success = true;
+	return 0;
+}
+
+/*
+ * Remove what we wrote if we didn't finish: the directories we created, and
+ * the contents of those that were empty.
+ */
+static void
+cleanup_directories_atexit(void)
+{
+	int			i;
+
+	if (success)
+		return;
+
+	for (i = 0; i < noutput_dirs; i++)
+	{
+		OutputDir  *dir = &output_dirs[i];
+
+		if (dir->created)
+		{
+			pg_log_info("removing directory \"%s\"", dir->path);
+			if (!rmtree(dir->path, true))
+				pg_log_error("failed to remove directory \"%s\"", dir->path);
+		}
+		else
+		{
+			pg_log_info("removing contents of directory \"%s\"", dir->path);
+			if (!rmtree(dir->path, false))
+				pg_log_error("failed to remove contents of directory \"%s\"",
+							 dir->path);
+		}
+	}
+}
+
+/*
+ * Split argument into old_dir and new_dir and append to tablespace mapping
+ * list.  As in pg_basebackup, "=" can be escaped with a backslash.
+ */
+static void
+tablespace_mapping_append(const char *arg)
+{
+	TablespaceMapping *cell = pg_malloc0(sizeof(TablespaceMapping));
+	char	   *dst;
+	char	   *dst_ptr;
+	const char *arg_ptr;
+
+	dst_ptr = dst = cell->old_dir;
+	for (arg_ptr = arg; *arg_ptr; arg_ptr++)
+	{
+		if (dst_ptr - dst >= MAXPGPATH)
+			pg_fatal("directory name too long");
+
+		if (*arg_ptr == '\\' && *(arg_ptr + 1) == '=')
+			;					/* skip backslash escaping = */
+		else if (*arg_ptr == '=' && (arg_ptr == arg || *(arg_ptr - 1) != '\\'))
+		{
+			if (*cell->new_dir)
+				pg_fatal("multiple \"=\" signs in tablespace mapping");
+			else
+				dst = dst_ptr = cell->new_dir;
+		}
+		else
+			*dst_ptr++ = *arg_ptr;
+	}
+
+	if (!*cell->old_dir || !*cell->new_dir)
+		pg_fatal("invalid tablespace mapping format \"%s\", must be \"OLDDIR=NEWDIR\"",
+				 arg);
+
+	if (!is_absolute_path(cell->old_dir))
+		pg_fatal("old directory is not an absolute path in tablespace mapping: %s",
+				 cell->old_dir);
+	if (!is_absolute_path(cell->new_dir))
+		pg_fatal("new directory is not an absolute path in tablespace mapping: %s",
+				 cell->new_dir);
+
+	canonicalize_path(cell->old_dir);
+	canonicalize_path(cell->new_dir);
+
+	cell->next = tablespace_mappings;
+	tablespace_mappings = cell;
+}
+
+/*
+ * Where to put the tablespace that is at dir in the final backup.
+ */
+static const char *
+get_tablespace_mapping(const char *dir)
+{
+	TablespaceMapping *cell;
+	char		canon_dir[MAXPGPATH];
+
+	strlcpy(canon_dir, dir, sizeof(canon_dir));
+	canonicalize_path(canon_dir);
+
+	for (cell = tablespace_mappings; cell; cell = cell->next)
+		if (strcmp(canon_dir, cell->old_dir) == 0)
+			return cell->new_dir;
+
+	return dir;
+}
+
+/*
+ * Read the start of the backup, and the prior backup if it's incremental,
+ * from the backup_label.
+ */
+static void
+read_backup_label(BackupInfo *backup)
+{
+	char		filename[MAXPGPATH];
+	FILE	   *fp;
+	char		line[MAXPGPATH];
+	uint32		hi,
+				lo;
+	bool		found_start = false;
+
+	snprintf(filename, sizeof(filename), "%s/backup_label", backup->path);
+	if ((fp = fopen(filename, "r")) == NULL)
+		pg_fatal("could not open file \"%s\": %m", filename);
+
+	backup->prior_lsn = InvalidXLogRecPtr;
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		if (sscanf(line, "START WAL LOCATION: %X/%X", &hi, &lo) == 2)
+		{
+			backup->start_lsn = ((uint64) hi) << 32 | lo;
+			found_start = true;
+		}
+		else if (sscanf(line, "START TIMELINE: %u", &backup->start_tli) == 1)
+			;
+		else if (sscanf(line, INCREMENTAL_FROM_LSN_LABEL ": %X/%X",
+						&hi, &lo) == 2)
+			backup->prior_lsn = ((uint64) hi) << 32 | lo;
+		else if (sscanf(line, INCREMENTAL_FROM_TLI_LABEL ": %u",
+						&backup->prior_tli) == 1)
+			;
+	}
+	if (ferror(fp))
+		pg_fatal("could not read file \"%s\": %m", filename);
+	fclose(fp);
+
+	if (!found_start || backup->start_tli == 0)
+		pg_fatal("invalid data in file \"%s\"", filename);
+	if (!XLogRecPtrIsInvalid(backup->prior_lsn) && backup->prior_tli == 0)
+		pg_fatal("invalid data in file \"%s\"", filename);
+}
+
+/*
+ * Check that each backup was taken relative to the one before it.
+ */
+static void
+check_backup_chain(void)
+{
+	int			i;
+
+	if (!XLogRecPtrIsInvalid(backups[0].prior_lsn))
+		pg_fatal("backup at \"%s\" is an incremental backup, but the first backup must be a full backup",
+				 backups[0].path);
+
+	for (i = 1; i < nbackups; i++)
+	{
+		BackupInfo *prior = &backups[i - 1];
+		BackupInfo *backup = &backups[i];
+
+		if (XLogRecPtrIsInvalid(backup->prior_lsn))
+			pg_fatal("backup at \"%s\" is a full backup, but only the first backup may be a full backup",
+					 backup->path);
+		if (backup->prior_lsn != prior->start_lsn ||
+			backup->prior_tli != prior->start_tli)
+			pg_fatal("backup at \"%s\" was taken relative to a backup starting at %X/%X on timeline %u, but the backup at \"%s\" starts at %X/%X on timeline %u",
+					 backup->path,
+					 (uint32) (backup->prior_lsn >> 32),
+					 (uint32) backup->prior_lsn, backup->prior_tli,
+					 prior->path,
+					 (uint32) (prior->start_lsn >> 32),
+					 (uint32) prior->start_lsn, prior->start_tli);
+	}
+}
+
+/*
+ * Check that all the backups are of the same cluster.
+ */
+static void
+check_control_files(void)
+{
+	uint64		system_identifier = 0;
+	int			i;
+
+	for (i = 0; i < nbackups; i++)
+	{
+		ControlFileData *control_file;
+		bool		crc_ok;
+
+		control_file = get_controlfile(backups[i].path, &crc_ok);
+		if (!crc_ok)
+			pg_fatal("%s/global/pg_control: calculated CRC checksum does not match value stored in file",
+					 backups[i].path);
+		if (i == 0)
+			system_identifier = control_file->system_identifier;
+		else if (control_file->system_identifier != system_identifier)
+			pg_fatal("%s: expected system identifier " UINT64_FORMAT ", but found " UINT64_FORMAT,
+					 backups[i].path, system_identifier,
+					 control_file->system_identifier);
+		pg_free(control_file);
+	}
+}
+
+/*
+ * Read the WAL ranges from the final backup's manifest.
+ */
+static WALRange *
+read_final_manifest(void)
+{
+	char		filename[MAXPGPATH];
+	int			fd;
+	struct stat statbuf;
+	char	   *buffer;
+	int			rc;
+	WALRange   *ranges = NULL;
+	JsonManifestParseContext context;
+
+	snprintf(filename, sizeof(filename), "%s/backup_manifest",
+			 backups[nbackups - 1].path);
+	if ((fd = open(filename, O_RDONLY | PG_BINARY, 0)) < 0)
+	{
+		if (errno == ENOENT)
+		{
+			pg_log_error("could not open file \"%s\": %m", filename);
+			pg_log_info("HINT: use --no-manifest if the backup has no manifest");
+			exit(1);
+		}
+		pg_fatal("could not open file \"%s\": %m", filename);
+	}
+	if (fstat(fd, &statbuf) != 0)
+		pg_fatal("could not stat file \"%s\": %m", filename);
+
+	buffer = pg_malloc(statbuf.st_size);
+	rc = read(fd, buffer, statbuf.st_size);
+	if (rc != statbuf.st_size)
+	{
+		if (rc < 0)
+			pg_fatal("could not read file \"%s\": %m", filename);
+		else
+			pg_fatal("could not read file \"%s\": read %d of %zu",
+					 filename, rc, (size_t) statbuf.st_size);
+	}
+	close(fd);
+
+	context.private_data = &ranges;
+	context.perfile_cb = manifest_file_cb;
+	context.perwalrange_cb = manifest_wal_range_cb;
+	context.error_cb = manifest_error_cb;
+	json_parse_manifest(&context, buffer, statbuf.st_size);
+
+	pg_free(buffer);
+
+	return ranges;
+}
+
+/*
+ * Manifest parser callbacks for read_final_manifest().
+ */
+static void
+manifest_file_cb(JsonManifestParseContext *context, char *pathname,
+				 size_t size, pg_checksum_type type,
+				 int checksum_length, uint8 *checksum_payload)
+{
+	/* The files are found by reading the backup itself. */
+}
+
+static void
+manifest_wal_range_cb(JsonManifestParseContext *context, TimeLineID tli,
+					  XLogRecPtr start_lsn, XLogRecPtr end_lsn)
+{
+	WALRange  **tail = context->private_data;
+	WALRange   *range = pg_malloc(sizeof(WALRange));
+
+	range->next = NULL;
+	range->tli = tli;
+	range->start_lsn = start_lsn;
+	range->end_lsn = end_lsn;
+
+	/* Keep them in the order in which the manifest lists them. */
+	while (*tail != NULL)
+		tail = &(*tail)->next;
+	*tail = range;
+}
+
+static void
+manifest_error_cb(JsonManifestParseContext *context, char *fmt,...)
+{
+	va_list		ap;
+
+	va_start(ap, fmt);
+	pg_log_generic_v(PG_LOG_FATAL, fmt, ap);
+	va_end(ap);
+
+	exit(1);
+}
+
+/*
+ * Set up a directory to write to, which must not exist or be empty.
+ */
+static void
+create_output_directory(const char *dirname)
+{
+	bool		created = false;
+
+	switch (pg_check_dir(dirname))
+	{
+		case 0:
+			if (pg_mkdir_p(unconstify(char *, dirname), pg_dir_create_mode) != 0)
+				pg_fatal("could not create directory \"%s\": %m", dirname);
+			created = true;
+			break;
+		case 1:
+			break;
+		case 2:
+		case 3:
+		case 4:
+			pg_fatal("directory \"%s\" exists but is not empty", dirname);
+			break;
+		case -1:
+			pg_fatal("could not access directory \"%s\": %m", dirname);
+	}
+
+	output_dirs = pg_realloc(output_dirs,
+							 sizeof(OutputDir) * (noutput_dirs + 1));
+	output_dirs[noutput_dirs].path = pg_strdup(dirname);
+	output_dirs[noutput_dirs].created = created;
+	noutput_dirs++;
+}
+
+/*
+ * Write the contents of directory relpath of the final backup to outdir.
+ */
+static void
+process_directory(const char *relpath, const char *outdir)
+{
+	BackupInfo *final = &backups[nbackups - 1];
+	char		indir[MAXPGPATH];
+	DIR		   *dir;
+	struct dirent *de;
+
+	if (*relpath == '\0')
+		strlcpy(indir, final->path, sizeof(indir));
+	else
+		snprintf(indir, sizeof(indir), "%s/%s", final->path, relpath);
+
+	if ((dir = opendir(indir)) == NULL)
+		pg_fatal("could not open directory \"%s\": %m", indir);
+
+	while (errno = 0, (de = readdir(dir)) != NULL)
+	{
+		char		relfile[MAXPGPATH];
+		char		infile[MAXPGPATH];
+		char		outfile[MAXPGPATH];
+		struct stat statbuf;
+
+		if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0)
+			continue;
+
+		/* These are written separately. */
+		if (*relpath == '\0' &&
+			(strcmp(de->d_name, "backup_label") == 0 ||
+			 strcmp(de->d_name, "backup_manifest") == 0))
+			continue;
+
+		if (*relpath == '\0')
+			strlcpy(relfile, de->d_name, sizeof(relfile));
+		else
+			snprintf(relfile, sizeof(relfile), "%s/%s", relpath, de->d_name);
+		snprintf(infile, sizeof(infile), "%s/%s", indir, de->d_name);
+		snprintf(outfile, sizeof(outfile), "%s/%s", outdir, de->d_name);
+
+		if (lstat(infile, &statbuf) != 0)
+			pg_fatal("could not stat file \"%s\": %m", infile);
+
+#ifndef WIN32
+		if (S_ISLNK(statbuf.st_mode) && strcmp(relpath, "pg_tblspc") == 0)
+#else
+		if (pgwin32_is_junction(infile) && strcmp(relpath, "pg_tblspc") == 0)
+#endif
+		{
+			char		linkpath[MAXPGPATH];
+			int			rllen;
+			const char *newdir;
+
+			/* A tablespace: write it to its new location, and link to it. */
+			rllen = readlink(infile, linkpath, sizeof(linkpath));
+			if (rllen < 0)
+				pg_fatal("could not read symbolic link \"%s\": %m", infile);
+			if (rllen >= sizeof(linkpath))
+				pg_fatal("symbolic link \"%s\" target is too long", infile);
+			linkpath[rllen] = '\0';
+
+			newdir = get_tablespace_mapping(linkpath);
+			create_output_directory(newdir);
+			if (symlink(newdir, outfile) != 0)
+				pg_fatal("could not create symbolic link from \"%s\" to \"%s\": %m",
+						 outfile, newdir);
+			process_directory(relfile, newdir);
+			continue;
+		}
+
+		/* Anything else is followed, such as a symlinked pg_wal. */
+		if (stat(infile, &statbuf) != 0)
+			pg_fatal("could not stat file \"%s\": %m", infile);
+
+		if (S_ISDIR(statbuf.st_mode))
+		{
+			if (mkdir(outfile, pg_dir_create_mode) != 0)
+				pg_fatal("could not create directory \"%s\": %m", outfile);
+			process_directory(relfile, outfile);
+		}
+		else if (!S_ISREG(statbuf.st_mode))
+			pg_log_warning("skipping special file \"%s\"", infile);
+		else if (strncmp(de->d_name, INCREMENTAL_PREFIX,
+						 INCREMENTAL_PREFIX_LENGTH) == 0)
+		{
+			const char *name = de->d_name + INCREMENTAL_PREFIX_LENGTH;
+
+			snprintf(outfile, sizeof(outfile), "%s/%s", outdir, name);
+			reconstruct_file(relpath, name, outfile, &statbuf);
+		}
+		else
+			copy_file(relfile, infile, outfile, &statbuf);
+	}
+
+	if (errno)
+		pg_fatal("could not read directory \"%s\": %m", indir);
+	if (closedir(dir))
+		pg_fatal("could not close directory \"%s\": %m", indir);
+}
+
+/*
+ * Copy a file that the final backup contains in full.
+ */
+static void
+copy_file(const char *relpath, const char *infile, const char *outfile,
+		  struct stat *statbuf)
+{
+	int			src_fd;
+	int			dst_fd;
+	char	   *buffer;
+	int			rc;
+	uint64		size = 0;
+	pg_checksum_context checksum_ctx;
+
+	pg_checksum_init(&checksum_ctx, checksum_type);
+
+	if ((src_fd = open(infile, O_RDONLY | PG_BINARY, 0)) < 0)
+		pg_fatal("could not open file \"%s\": %m", infile);
+	if ((dst_fd = open(outfile, O_CREAT | O_EXCL | O_WRONLY | PG_BINARY,
+					   pg_file_create_mode)) < 0)
+		pg_fatal("could not create file \"%s\": %m", outfile);
+
+	buffer = pg_malloc(COPY_BUF_SIZE);
+	while ((rc = read(src_fd, buffer, COPY_BUF_SIZE)) > 0)
+	{
+		write_bytes(dst_fd, outfile, buffer, rc);
+		pg_checksum_update(&checksum_ctx, (uint8 *) buffer, rc);
+		size += rc;
+	}
+	if (rc < 0)
+		pg_fatal("could not read file \"%s\": %m", infile);
+	pg_free(buffer);
+
+	if (close(dst_fd) != 0)
+		pg_fatal("could not close file \"%s\": %m", outfile);
+	close(src_fd);
+
+	/* The WAL isn't listed in backup manifests. */
+	if (strncmp(relpath, "pg_wal/", strlen("pg_wal/")) != 0)
+		add_file_to_manifest(relpath, size, statbuf->st_mtime, &checksum_ctx);
+}
+
+/*
+ * Reconstruct the relation file "name" in directory reldir from the
+ * incremental file the final backup contains for it, and the versions of it
+ * in the earlier backups.
+ *
+ * The output file has the truncation block length of the final incremental
+ * file.  Each of its blocks is taken from the newest backup that contains it;
+ * going back through the backups, we stop at the first one that contains the
+ * file in full.  A block that no backup contains was beyond the end of the
+ * file in every backup that would have to contain it, and is zero-filled;
+ * it will be restored by WAL replay.
+ */
+static void
+reconstruct_file(const char *reldir, const char *name, const char *outfile,
+				 struct stat *statbuf)
+{
+	rfile	  **sources;
+	rfile	  **block_source;
+	off_t	   *block_offset;
+	unsigned	block_length;
+	unsigned	limit;
+	unsigned	unresolved;
+	unsigned	b;
+	unsigned	k;
+	int			i;
+	int			fd;
+	PGAlignedBlock buf;
+	char		relname[MAXPGPATH];
+	pg_checksum_context checksum_ctx;
+
+	snprintf(relname, sizeof(relname), "%s%s%s",
+			 reldir, *reldir ? "/" : "", name);
+	pg_checksum_init(&checksum_ctx, checksum_type);
+	sources = pg_malloc0(sizeof(rfile *) * nbackups);
+
+	/* Start with the blocks in the final backup. */
+	for (i = nbackups - 1; i >= 0; i--)
+	{
+		char		filename[MAXPGPATH];
+		struct stat sb;
+
+		snprintf(filename, sizeof(filename), "%s/%s%s%s%s",
+				 backups[i].path, reldir, *reldir ? "/" : "",
+				 INCREMENTAL_PREFIX, name);
+		if (i == nbackups - 1 || stat(filename, &sb) == 0)
+		{
+			sources[i] = open_incremental_rfile(filename);
+			continue;
+		}
+		if (errno != ENOENT)
+			pg_fatal("could not stat file \"%s\": %m", filename);
+
+		snprintf(filename, sizeof(filename), "%s/%s%s%s",
+				 backups[i].path, reldir, *reldir ? "/" : "", name);
+		if (stat(filename, &sb) == 0)
+		{
+			sources[i] = open_full_rfile(filename, sb.st_size);
+			break;
+		}
+		if (errno != ENOENT)
+			pg_fatal("could not stat file \"%s\": %m", filename);
+
+		pg_fatal("could not find a full or incremental version of file \"%s\" in backup \"%s\"",
+				 relname, backups[i].path);
+	}
+	if (i < 0)
+		pg_fatal("could not find a full version of file \"%s\" in any of the backups",
+				 relname);
+
+	/* Decide where each block comes from. */
+	block_length = sources[nbackups - 1]->truncation_block_length;
+	block_source = pg_malloc0(sizeof(rfile *) * Max(block_length, 1));
+	block_offset = pg_malloc0(sizeof(off_t) * Max(block_length, 1));
+	limit = block_length;
+	unresolved = block_length;
+	for (i = nbackups - 1; i >= 0 && unresolved > 0; i--)
+	{
+		rfile	   *rf = sources[i];
+
+		if (rf == NULL)
+			continue;
+
+		if (rf->relative_block_numbers == NULL)
+		{
+			/* A full file: provides every block it has. */
+			for (b = 0; b < Min(limit, rf->num_blocks); b++)
+			{
+				if (block_source[b] == NULL)
+				{
+					block_source[b] = rf;
+					block_offset[b] = (off_t) b * BLCKSZ;
+					unresolved--;
+				}
+			}
+			break;
+		}
+
+		/*
+		 * Blocks at or past the truncation length of any backup didn't exist
+		 * then; older versions of them don't count.
+		 */
+		limit = Min(limit, rf->truncation_block_length);
+		for (k = 0; k < rf->num_blocks; k++)
+		{
+			b = rf->relative_block_numbers[k];
+			if (b < limit && block_source[b] == NULL)
+			{
+				block_source[b] = rf;
+				block_offset[b] = rf->header_length + (off_t) k * BLCKSZ;
+				unresolved--;
+			}
+		}
+	}
+
+	/* Write the blocks out. */
+	if ((fd = open(outfile, O_CREAT | O_EXCL | O_WRONLY | PG_BINARY,
+				   pg_file_create_mode)) < 0)
+		pg_fatal("could not create file \"%s\": %m", outfile);
+	for (b = 0; b < block_length; b++)
+	{
+		rfile	   *rf = block_source[b];
+
+		if (rf == NULL)
+			memset(buf.data, 0, BLCKSZ);
+		else
+		{
+			int			rc;
+
+			rc = pg_pread(rf->fd, buf.data, BLCKSZ, block_offset[b]);
+			if (rc < 0)
+				pg_fatal("could not read file \"%s\": %m", rf->filename);
+
+			/* Only the last block of a full file can be short. */
+			if (rc < BLCKSZ)
+			{
+				if (rf->relative_block_numbers != NULL)
+					pg_fatal("could not read file \"%s\": read %d of %d",
+							 rf->filename, rc, BLCKSZ);
+				memset(buf.data + rc, 0, BLCKSZ - rc);
+			}
+		}
+		write_bytes(fd, outfile, buf.data, BLCKSZ);
+		pg_checksum_update(&checksum_ctx, (uint8 *) buf.data, BLCKSZ);
+	}
+	if (close(fd) != 0)
+		pg_fatal("could not close file \"%s\": %m", outfile);
+
+	for (i = 0; i < nbackups; i++)
+		if (sources[i] != NULL)
+			close_rfile(sources[i]);
+	pg_free(sources);
+	pg_free(block_source);
+	pg_free(block_offset);
+
+	/* List it under the name of the file it reconstructs. */
+	add_file_to_manifest(relname, (uint64) block_length * BLCKSZ,
+						 statbuf->st_mtime, &checksum_ctx);
+}
+
+/*
+ * Open an incremental file, and read its header.
+ */
+static rfile *
+open_incremental_rfile(const char *filename)
+{
+	rfile	   *rf = pg_malloc0(sizeof(rfile));
+	uint32		header[3];
+
+	rf->filename = pg_strdup(filename);
+	if ((rf->fd = open(filename, O_RDONLY | PG_BINARY, 0)) < 0)
+		pg_fatal("could not open file \"%s\": %m", filename);
+
+	read_bytes(rf, header, sizeof(header));
+	if (header[0] != INCREMENTAL_MAGIC)
+		pg_fatal("file \"%s\" has bad incremental magic number (0x%x not 0x%x)",
+				 filename, header[0], INCREMENTAL_MAGIC);
+	rf->num_blocks = header[1];
+	rf->truncation_block_length = header[2];
+	if (rf->num_blocks > RELSEG_SIZE)
+		pg_fatal("file \"%s\" has block count %u in excess of segment size %u",
+				 filename, rf->num_blocks, RELSEG_SIZE);
+	if (rf->truncation_block_length > RELSEG_SIZE)
+		pg_fatal("file \"%s\" has truncation block length %u in excess of segment size %u",
+				 filename, rf->truncation_block_length, RELSEG_SIZE);
+
+	rf->relative_block_numbers =
+		pg_malloc(sizeof(BlockNumber) * Max(rf->num_blocks, 1));
+	if (rf->num_blocks > 0)
+		read_bytes(rf, rf->relative_block_numbers,
+				   sizeof(BlockNumber) * rf->num_blocks);
+	rf->header_length = INCREMENTAL_HEADER_SIZE +
+		sizeof(BlockNumber) * rf->num_blocks;
+
+	return rf;
+}
+
+/*
+ * Open a file that a backup contains in full.
+ */
+static rfile *
+open_full_rfile(const char *filename, off_t size)
+{
+	rfile	   *rf = pg_malloc0(sizeof(rfile));
+
+	rf->filename = pg_strdup(filename);
+	if ((rf->fd = open(filename, O_RDONLY | PG_BINARY, 0)) < 0)
+		pg_fatal("could not open file \"%s\": %m", filename);
+	rf->num_blocks = (size + BLCKSZ - 1) / BLCKSZ;
+	rf->truncation_block_length = rf->num_blocks;
+
+	return rf;
+}
+
+static void
+close_rfile(rfile *rf)
+{
+	close(rf->fd);
+	pg_free(rf->filename);
+	if (rf->relative_block_numbers != NULL)
+		pg_free(rf->relative_block_numbers);
+	pg_free(rf);
+}
+
+/*
+ * Read exactly length bytes from the current position of an rfile.
+ */
+static void
+read_bytes(rfile *rf, void *buffer, unsigned length)
+{
+	int			rc = read(rf->fd, buffer, length);
+
+	if (rc < 0)
+		pg_fatal("could not read file \"%s\": %m", rf->filename);
+	if (rc < length)
+		pg_fatal("could not read file \"%s\": read %d of %u",
+				 rf->filename, rc, length);
+}
+
+static void
+write_bytes(int fd, const char *filename, const void *buffer, size_t length)
+{
+	errno = 0;
+	if (write(fd, buffer, length) != length)
+	{
+		/* if write didn't set errno, assume problem is no disk space */
+		if (errno == 0)
+			errno = ENOSPC;
+		pg_fatal("could not write file \"%s\": %m", filename);
+	}
+}
+
+/*
+ * Write the backup_label of the final backup, less the lines that mark it as
+ * incremental.
+ */
+static void
+write_backup_label(void)
+{
+	char		infile[MAXPGPATH];
+	char		outfile[MAXPGPATH];
+	FILE	   *fp;
+	int			fd;
+	char		line[MAXPGPATH];
+	StringInfoData buf;
+	struct stat statbuf;
+	pg_checksum_context checksum_ctx;
+
+	snprintf(infile, sizeof(infile), "%s/backup_label",
+			 backups[nbackups - 1].path);
+	snprintf(outfile, sizeof(outfile), "%s/backup_label", output);
+
+	if ((fp = fopen(infile, "r")) == NULL)
+		pg_fatal("could not open file \"%s\": %m", infile);
+	if (fstat(fileno(fp), &statbuf) != 0)
+		pg_fatal("could not stat file \"%s\": %m", infile);
+	initStringInfo(&buf);
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		if (strncmp(line, INCREMENTAL_FROM_LSN_LABEL,
+					strlen(INCREMENTAL_FROM_LSN_LABEL)) == 0 ||
+			strncmp(line, INCREMENTAL_FROM_TLI_LABEL,
+					strlen(INCREMENTAL_FROM_TLI_LABEL)) == 0)
+			continue;
+		appendStringInfoString(&buf, line);
+	}
+	if (ferror(fp))
+		pg_fatal("could not read file \"%s\": %m", infile);
+	fclose(fp);
+
+	if ((fd = open(outfile, O_CREAT | O_EXCL | O_WRONLY | PG_BINARY,
+				   pg_file_create_mode)) < 0)
+		pg_fatal("could not create file \"%s\": %m", outfile);
+	write_bytes(fd, outfile, buf.data, buf.len);
+	if (close(fd) != 0)
+		pg_fatal("could not close file \"%s\": %m", outfile);
+
+	pg_checksum_init(&checksum_ctx, checksum_type);
+	pg_checksum_update(&checksum_ctx, (uint8 *) buf.data, buf.len);
+	add_file_to_manifest("backup_label", buf.len, statbuf.st_mtime,
+						 &checksum_ctx);
+	pfree(buf.data);
+}
+
+/*
+ * Add an entry for a file to the output manifest, in the format the server
+ * uses.
+ */
+static void
+add_file_to_manifest(const char *pathname, uint64 size, time_t mtime,
+					 pg_checksum_context *ctx)
+{
+	StringInfoData buf;
+	const char *p;
+	bool		encode = false;
+	char		timebuf[128];
+
+	if (manifest == NULL)
+		return;
+
+	initStringInfo(&buf);
+	appendStringInfoString(&buf, manifest->first_file ? "\n" : ",\n");
+	manifest->first_file = false;
+
+	/* Hex-encode any path that would need escaping in JSON. */
+	for (p = pathname; *p; p++)
+		if ((unsigned char) *p < 0x20 || (unsigned char) *p >= 0x80 ||
+			*p == '"' || *p == '\\')
+			encode = true;
+	if (!encode)
+		appendStringInfo(&buf, "{ \"Path\": \"%s\", ", pathname);
+	else
+	{
+		appendStringInfoString(&buf, "{ \"Encoded-Path\": \"");
+		append_hex(&buf, (const uint8 *) pathname, strlen(pathname));
+		appendStringInfoString(&buf, "\", ");
+	}
+
+	appendStringInfo(&buf, "\"Size\": " UINT64_FORMAT ", ", size);
+
+	strftime(timebuf, sizeof(timebuf), "%Y-%m-%d %H:%M:%S GMT",
+			 gmtime(&mtime));
+	appendStringInfo(&buf, "\"Last-Modified\": \"%s\"", timebuf);
+
+	if (ctx->type != CHECKSUM_TYPE_NONE)
+	{
+		uint8		checksumbuf[PG_CHECKSUM_MAX_LENGTH];
+		int			checksumlen;
+
+		checksumlen = pg_checksum_final(ctx, checksumbuf);
+		appendStringInfo(&buf,
+						 ", \"Checksum-Algorithm\": \"%s\", \"Checksum\": \"",
+						 pg_checksum_type_name(ctx->type));
+		append_hex(&buf, checksumbuf, checksumlen);
+		appendStringInfoString(&buf, "\"");
+	}
+	appendStringInfoString(&buf, " }");
+
+	appendBinaryStringInfo(&manifest->buf, buf.data, buf.len);
+	pfree(buf.data);
+}
+
+/*
+ * Finish the output manifest with the WAL ranges of the final backup and the
+ * manifest checksum, and write it out.
+ */
+static void
+write_manifest(WALRange *ranges)
+{
+	char		filename[MAXPGPATH];
+	uint8		checksumbuf[PG_SHA256_DIGEST_LENGTH];
+	WALRange   *range;
+	int			fd;
+
+	appendStringInfoString(&manifest->buf, "\n],\n\"WAL-Ranges\": [\n");
+	for (range = ranges; range != NULL; range = range->next)
+		appendStringInfo(&manifest->buf,
+						 "%s{ \"Timeline\": %u, \"Start-LSN\": \"%X/%X\", \"End-LSN\": \"%X/%X\" }",
+						 range == ranges ? "" : ",\n",
+						 range->tli,
+						 (uint32) (range->start_lsn >> 32),
+						 (uint32) range->start_lsn,
+						 (uint32) (range->end_lsn >> 32),
+						 (uint32) range->end_lsn);
+	appendStringInfoString(&manifest->buf, "\n],\n");
+
+	/* Everything so far is covered by the manifest checksum. */
+	pg_sha256_update(&manifest->manifest_ctx, (uint8 *) manifest->buf.data,
+					 manifest->buf.len);
+	pg_sha256_final(&manifest->manifest_ctx, checksumbuf);
+	appendStringInfoString(&manifest->buf, "\"Manifest-Checksum\": \"");
+	append_hex(&manifest->buf, checksumbuf, sizeof(checksumbuf));
+	appendStringInfoString(&manifest->buf, "\"}\n");
+
+	snprintf(filename, sizeof(filename), "%s/backup_manifest", output);
+	if ((fd = open(filename, O_CREAT | O_EXCL | O_WRONLY | PG_BINARY,
+				   pg_file_create_mode)) < 0)
+		pg_fatal("could not create file \"%s\": %m", filename);
+	write_bytes(fd, filename, manifest->buf.data, manifest->buf.len);
+	if (close(fd) != 0)
+		pg_fatal("could not close file \"%s\": %m", filename);
+}
+
+static void
+append_hex(StringInfo buf, const uint8 *data, int len)
+{
+	static const char hextbl[] = "0123456789abcdef";
+	int			i;
+
+	for (i = 0; i < len; i++)
+	{
+		appendStringInfoChar(buf, hextbl[(data[i] >> 4) & 0xF]);
+		appendStringInfoChar(buf, hextbl[data[i] & 0xF]);
+	}
+}
@@ -0,0 +1,108 @@
+# Test taking incremental backups and combining them into full backups.
+
+use strict;
+use warnings;
+use PostgresNode;
+use TestLib;
+use Test::More tests => 28;
+
+my $tempdir = TestLib::tempdir;
+
+program_help_ok('pg_combinebackup');
+program_version_ok('pg_combinebackup');
+program_options_handling_ok('pg_combinebackup');
+
+command_fails_like(['pg_combinebackup', $tempdir],
+				   qr/no output directory specified/,
+				   'output directory must be specified');
+command_fails_like(['pg_combinebackup', '-o', "$tempdir/out"],
+				   qr/no input directories specified/,
+				   'input directories must be specified');
+
+my $node = get_new_node('main');
+$node->init(allows_streaming => 1);
+$node->append_conf('postgresql.conf', 'summarize_wal = on');
+$node->start;
+
+$node->safe_psql('postgres',
+	'CREATE TABLE t (a int, b text); '
+	  . 'INSERT INTO t SELECT g, repeat(\'x\', 100) FROM generate_series(1, 20000) g; '
+	  . 'CREATE TABLE dropped AS SELECT 1 AS a;');
+
+my $backupdir = $node->backup_dir;
+$node->command_ok(
+	[ 'pg_basebackup', '-D', "$backupdir/full", '--no-sync' ],
+	'full backup');
+
+# An incremental backup needs a manifest to be taken relative to.
+command_fails_like(
+	[ 'pg_basebackup', '-D', "$backupdir/fail", '--no-sync',
+	  '-h', $node->host, '-p', $node->port,
+	  '--incremental', "$tempdir/no_such_manifest" ],
+	qr/could not open file/,
+	'incremental backup needs the manifest of the prior backup');
+
+$node->safe_psql('postgres',
+	'UPDATE t SET b = \'y\' WHERE a % 1000 = 0; '
+	  . 'DROP TABLE dropped; '
+	  . 'CREATE TABLE t2 AS SELECT 2 AS a;');
+$node->command_ok(
+	[ 'pg_basebackup', '-D', "$backupdir/incr1", '--no-sync',
+	  '--incremental', "$backupdir/full/backup_manifest" ],
+	'first incremental backup');
+
+my @incremental_files = glob("$backupdir/incr1/base/*/INCREMENTAL.*");
+ok(@incremental_files > 0, 'incremental backup contains incremental files');
+
+$node->safe_psql('postgres',
+	'DELETE FROM t WHERE a > 15000; VACUUM t; '
+	  . 'INSERT INTO t VALUES (-1, \'after\');');
+$node->command_ok(
+	[ 'pg_basebackup', '-D', "$backupdir/incr2", '--no-sync',
+	  '--incremental', "$backupdir/incr1/backup_manifest" ],
+	'second incremental backup');
+
+my $expected = $node->safe_psql('postgres',
+	'SELECT count(*), sum(a), count(*) FILTER (WHERE b = \'y\') FROM t');
+
+# An incremental backup can't be started by itself.
+my $incr_node = get_new_node('incr');
+$incr_node->init_from_backup($node, 'incr2');
+ok(!$incr_node->start(fail_ok => 1),
+	'incremental backup is not a data directory');
+like(slurp_file($incr_node->logfile),
+	qr/this is an incremental backup, not a data directory/,
+	'startup reports incremental backup');
+
+# The backups must be given in order, starting with a full backup.
+command_fails_like(
+	[ 'pg_combinebackup', '-N', '-o', "$backupdir/bad",
+	  "$backupdir/full", "$backupdir/incr2" ],
+	qr/was taken relative to a backup starting at/,
+	'missing backup in chain is detected');
+command_fails_like(
+	[ 'pg_combinebackup', '-N', '-o', "$backupdir/bad",
+	  "$backupdir/incr1", "$backupdir/incr2" ],
+	qr/the first backup must be a full backup/,
+	'chain must start with a full backup');
+
+command_ok(
+	[ 'pg_combinebackup', '-N', '-o', "$backupdir/combined",
+	  "$backupdir/full", "$backupdir/incr1", "$backupdir/incr2" ],
+	'combine backups');
+command_ok([ 'pg_verifybackup', '-n', "$backupdir/combined" ],
+	'combined backup verifies');
+
+my $restored = get_new_node('restored');
+$restored->init_from_backup($node, 'combined');
+$restored->start;
+
+is($restored->safe_psql('postgres',
+	'SELECT count(*), sum(a), count(*) FILTER (WHERE b = \'y\') FROM t'),
+	$expected, 'combined backup has the data of the last backup');
+is($restored->safe_psql('postgres',
+	'SELECT count(*) FROM pg_class WHERE relname IN (\'dropped\', \'t2\')'),
+	'1', 'dropped and created tables are restored');
+
+$restored->stop;
+$node->stop;
@@ -141,6 +141,8 @@ typedef struct _dumpOptions
 	bool		aclsSkip;
 	const char *lockWaitTimeout;
 	int			dump_inserts;	/* 0 = COPY, otherwise rows per INSERT */
+	int			table_chunk_size;	/* split table data into chunks of this
+									 * many MB; 0 = don't split */
 
 	/* flags for various command-line long options */
 	int			disable_dollar_quoting;
@@ -91,6 +91,7 @@ static bool _tocEntryIsACL(TocEntry *te);
 static void _disableTriggersIfNecessary(ArchiveHandle *AH, TocEntry *te);
 static void _enableTriggersIfNecessary(ArchiveHandle *AH, TocEntry *te);
 static void buildTocEntryArrays(ArchiveHandle *AH);
+static bool hasChunkedTableData(ArchiveHandle *AH);
 static void _moveBefore(ArchiveHandle *AH, TocEntry *pos, TocEntry *te);
 static int	_discoverArchiveFormat(ArchiveHandle *AH);
 
@@ -1845,12 +1846,18 @@ buildTocEntryArrays(ArchiveHandle *AH)
 
 		/* tocsByDumpId indexes all TOCs by their dump ID */
 		AH->tocsByDumpId[te->dumpId] = te;
+		te->nextTableData = NULL;
 
 		/*
 		 * tableDataId provides the TABLE DATA item's dump ID for each TABLE
 		 * TOC entry that has a DATA item.  We compute this by reversing the
 		 * TABLE DATA item's dependency, knowing that a TABLE DATA item has
 		 * just one dependency and it is the TABLE item.
+		 *
+		 * A table whose data was dumped in chunks (pg_dump's
+		 * --table-chunk-size) has several TABLE DATA items.  tableDataId
+		 * shows the first one we come across, and the others are chained to
+		 * it through nextTableData.
 		 */
 		if (strcmp(te->desc, "TABLE DATA") == 0 && te->nDeps > 0)
 		{
@@ -1864,11 +1871,54 @@ buildTocEntryArrays(ArchiveHandle *AH)
 			if (tableId <= 0 || tableId > maxDumpId)
 				fatal("bad table dumpId for TABLE DATA item");
 
-			AH->tableDataId[tableId] = te->dumpId;
+			if (AH->tableDataId[tableId] != 0)
+			{
+				TocEntry   *firstte = AH->tocsByDumpId[AH->tableDataId[tableId]];
+
+				te->nextTableData = firstte->nextTableData;
+				firstte->nextTableData = te;
+			}
+			else
+				AH->tableDataId[tableId] = te->dumpId;
 		}
 	}
 }
 
+/*
+ * Does any table have more than one TABLE DATA item, as written by pg_dump's
+ * --table-chunk-size?
+ */
+static bool
+hasChunkedTableData(ArchiveHandle *AH)
+{
+	bool	   *hasData;
+	bool		result = false;
+	TocEntry   *te;
+
+	hasData = (bool *) pg_malloc0((AH->maxDumpId + 1) * sizeof(bool));
+
+	for (te = AH->toc->next; te != AH->toc; te = te->next)
+	{
+		DumpId		tableId;
+
+		if (strcmp(te->desc, "TABLE DATA") != 0 || te->nDeps <= 0)
+			continue;
+
+		tableId = te->dependencies[0];
+		if (tableId <= 0 || tableId > AH->maxDumpId)
+			continue;
+		if (hasData[tableId])
+		{
+			result = true;
+			break;
+		}
+		hasData[tableId] = true;
+	}
+
+	pg_free(hasData);
+	return result;
+}
+
 TocEntry *
 getTocEntryByDumpId(ArchiveHandle *AH, DumpId id)
 {
@@ -3755,11 +3805,22 @@ void
 WriteHead(ArchiveHandle *AH)
 {
 	struct tm	crtm;
+	int			version = AH->version;
+
+	/*
+	 * pg_restore before K_VERS_1_15 doesn't know that a table's data can be
+	 * split into several TABLE DATA items, and a parallel restore would
+	 * truncate the table before loading each of them.  So label only
+	 * archives that contain such tables with the new version, and keep the
+	 * others readable by older releases.
+	 */
+	if (version == K_VERS_1_15 && !hasChunkedTableData(AH))
+		version = K_VERS_1_14;
 
 	AH->WriteBufPtr(AH, "PGDMP", 5);	/* Magic code */
-	AH->WriteBytePtr(AH, ARCHIVE_MAJOR(AH->version));
-	AH->WriteBytePtr(AH, ARCHIVE_MINOR(AH->version));
-	AH->WriteBytePtr(AH, ARCHIVE_REV(AH->version));
+	AH->WriteBytePtr(AH, ARCHIVE_MAJOR(version));
+	AH->WriteBytePtr(AH, ARCHIVE_MINOR(version));
+	AH->WriteBytePtr(AH, ARCHIVE_REV(version));
 	AH->WriteBytePtr(AH, AH->intSize);
 	AH->WriteBytePtr(AH, AH->offSize);
 	AH->WriteBytePtr(AH, AH->format);
@@ -4529,6 +4590,29 @@ fix_dependencies(ArchiveHandle *AH)
 	 */
 	repoint_table_dependencies(AH);
 
+	/*
+	 * When triggers are disabled for a data-only restore, each TABLE DATA
+	 * item disables the table's triggers before loading and re-enables them
+	 * afterwards.  The chunks of a table's data must then be loaded one after
+	 * another, lest one of them re-enable the triggers while another one is
+	 * still loading, so make each chunk depend on the one before it.
+	 */
+	if (AH->public.ropt->dataOnly && AH->public.ropt->disable_triggers)
+	{
+		for (te = AH->toc->next; te != AH->toc; te = te->next)
+		{
+			TocEntry   *nextte = te->nextTableData;
+
+			if (nextte == NULL)
+				continue;
+			nextte->dependencies = (DumpId *)
+				pg_realloc(nextte->dependencies,
+						   (nextte->nDeps + 1) * sizeof(DumpId));
+			nextte->dependencies[nextte->nDeps++] = te->dumpId;
+			nextte->depCount++;
+		}
+	}
+
 	/*
 	 * Pre-8.4 versions of pg_dump neglected to set up a dependency from BLOB
 	 * COMMENTS to BLOBS.  Cope.  (We assume there's only one BLOBS and only
@@ -4625,18 +4709,21 @@ fix_dependencies(ArchiveHandle *AH)
 
 /*
  * Change dependencies on table items to depend on table data items instead,
- * but only in POST_DATA items.
+ * but only in POST_DATA items.  If the table's data is in several chunks,
+ * the item is made to depend on all of them.
  *
  * Also, for any item having such dependency(s), set its dataLength to the
- * largest dataLength of the table data items it depends on.  This ensures
- * that parallel restore will prioritize larger jobs (index builds, FK
- * constraint checks, etc) over smaller ones, avoiding situations where we
- * end a restore with only one active job working on a large table.
+ * largest dataLength of the table data it depends on, counting all chunks
+ * of a table together.  This ensures that parallel restore will prioritize
+ * larger jobs (index builds, FK constraint checks, etc) over smaller ones,
+ * avoiding situations where we end a restore with only one active job
+ * working on a large table.
  */
 static void
 repoint_table_dependencies(ArchiveHandle *AH)
 {
 	TocEntry   *te;
+	TocEntry   *chunkte;
 	int			i;
 	DumpId		olddep;
 
@@ -4652,11 +4739,34 @@ repoint_table_dependencies(ArchiveHandle *AH)
 			{
 				DumpId		tabledataid = AH->tableDataId[olddep];
 				TocEntry   *tabledatate = AH->tocsByDumpId[tabledataid];
+				pgoff_t		dataLength = tabledatate->dataLength;
+				int			nchunks = 0;
 
 				te->dependencies[i] = tabledataid;
-				te->dataLength = Max(te->dataLength, tabledatate->dataLength);
 				pg_log_debug("transferring dependency %d -> %d to %d",
 							 te->dumpId, olddep, tabledataid);
+
+				/* Add dependencies on the rest of the chunks, if any */
+				for (chunkte = tabledatate->nextTableData; chunkte != NULL;
+					 chunkte = chunkte->nextTableData)
+					nchunks++;
+				if (nchunks > 0)
+				{
+					te->dependencies = (DumpId *)
+						pg_realloc(te->dependencies,
+								   (te->nDeps + nchunks) * sizeof(DumpId));
+					for (chunkte = tabledatate->nextTableData; chunkte != NULL;
+						 chunkte = chunkte->nextTableData)
+					{
+						te->dependencies[te->nDeps++] = chunkte->dumpId;
+						te->depCount++;
+						dataLength += chunkte->dataLength;
+						pg_log_debug("adding dependency %d -> %d",
+									 te->dumpId, chunkte->dumpId);
+					}
+				}
+
+				te->dataLength = Max(te->dataLength, dataLength);
 			}
 		}
 	}
@@ -4778,12 +4888,17 @@ mark_create_done(ArchiveHandle *AH, TocEntry *te)
 	{
 		TocEntry   *ted = AH->tocsByDumpId[AH->tableDataId[te->dumpId]];
 
-		ted->created = true;
+		/*
+		 * A table whose data is loaded in several chunks mustn't be truncated
+		 * before each of them, so don't mark those.
+		 */
+		if (ted->nextTableData == NULL)
+			ted->created = true;
 	}
 }
 
 /*
- * Mark the DATA member corresponding to the given TABLE member
+ * Mark the DATA member(s) corresponding to the given TABLE member
  * as not wanted
  */
 static void
@@ -4794,9 +4909,11 @@ inhibit_data_for_failed_table(ArchiveHandle *AH, TocEntry *te)
 
 	if (AH->tableDataId[te->dumpId] != 0)
 	{
-		TocEntry   *ted = AH->tocsByDumpId[AH->tableDataId[te->dumpId]];
+		TocEntry   *ted;
 
-		ted->reqs = 0;
+		for (ted = AH->tocsByDumpId[AH->tableDataId[te->dumpId]];
+			 ted != NULL; ted = ted->nextTableData)
+			ted->reqs = 0;
 	}
 }
 
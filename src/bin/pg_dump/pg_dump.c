@@ -133,6 +133,9 @@ static const CatalogId nilCatalogId = {0, 0};
 static bool have_extra_float_digits = false;
 static int	extra_float_digits;
 
+/* size of a table data chunk in blocks, per --table-chunk-size; 0 = off */
+static BlockNumber table_chunk_pages = 0;
+
 /*
  * The default number of rows per INSERT when
  * --inserts is specified without --rows-per-insert
@@ -243,8 +246,10 @@ static void addBoundaryDependencies(DumpableObject **dobjs, int numObjs,
 static void getDomainConstraints(Archive *fout, TypeInfo *tyinfo);
 static void getTableData(DumpOptions *dopt, TableInfo *tblinfo, int numTables, char relkind);
 static void makeTableDataInfo(DumpOptions *dopt, TableInfo *tbinfo);
+static void makeTableDataChunks(TableInfo *tbinfo);
 static void buildMatViewRefreshDependencies(Archive *fout);
 static void getTableDataFKConstraints(void);
+static void addTableDataDependencies(TableInfo *contable, TableInfo *reftable);
 static char *format_function_arguments(FuncInfo *finfo, char *funcargs,
 									   bool is_agg);
 static char *format_function_arguments_old(Archive *fout,
@@ -318,6 +323,7 @@ main(int argc, char **argv)
 	const char *dumpsnapshot = NULL;
 	char	   *use_role = NULL;
 	long		rowsPerInsert;
+	long		tableChunkSize;
 	int			numWorkers = 1;
 	trivalue	prompt_password = TRI_DEFAULT;
 	int			compressLevel = -1;
@@ -391,6 +397,7 @@ main(int argc, char **argv)
 		{"on-conflict-do-nothing", no_argument, &dopt.do_nothing, 1},
 		{"rows-per-insert", required_argument, NULL, 10},
 		{"include-foreign-data", required_argument, NULL, 11},
+		{"table-chunk-size", required_argument, NULL, 12},
 
 		{NULL, 0, NULL, 0}
 	};
@@ -611,6 +618,21 @@ main(int argc, char **argv)
 										  optarg);
 				break;
 
+			case 12:			/* table chunk size */
+				errno = 0;
+				tableChunkSize = strtol(optarg, &endptr, 10);
+
+				if (endptr == optarg || *endptr != '\0' ||
+					tableChunkSize <= 0 || tableChunkSize > INT_MAX ||
+					errno == ERANGE)
+				{
+					pg_log_error("table-chunk-size must be in range %d..%d",
+								 1, INT_MAX);
+					exit_nicely(1);
+				}
+				dopt.table_chunk_size = (int) tableChunkSize;
+				break;
+
 			default:
 				fprintf(stderr, _("Try \"%s --help\" for more information.\n"), progname);
 				exit_nicely(1);
@@ -721,6 +743,10 @@ main(int argc, char **argv)
 	if (archiveFormat != archDirectory && numWorkers > 1)
 		fatal("parallel backup only supported by the directory format");
 
+	/* Likewise splitting table data into chunks */
+	if (archiveFormat != archDirectory && dopt.table_chunk_size > 0)
+		fatal("option --table-chunk-size is only supported by the directory format");
+
 	/* Open the output file */
 	fout = CreateArchive(filename, archiveFormat, compressLevel, dosync,
 						 archiveMode, setupDumpWorker);
@@ -782,6 +808,31 @@ main(int argc, char **argv)
 	if (dumpsnapshot && fout->remoteVersion < 90200)
 		fatal("Exported snapshots are not supported by this server version.");
 
+	/*
+	 * Splitting table data into chunks relies on the server being able to
+	 * scan just a range of a table's blocks given a ctid range; older servers
+	 * would read the whole table for every chunk.
+	 */
+	if (dopt.table_chunk_size > 0)
+	{
+		if (fout->remoteVersion < 130000)
+			pg_log_warning("option --table-chunk-size is not supported by this server version, dumping tables whole");
+		else
+		{
+			PGresult   *res;
+			uint64		blcksz;
+			uint64		chunkpages;
+
+			res = ExecuteSqlQueryForSingleRow(fout,
+											  "SELECT pg_catalog.current_setting('block_size')");
+			blcksz = strtoul(PQgetvalue(res, 0, 0), NULL, 10);
+			PQclear(res);
+
+			chunkpages = ((uint64) dopt.table_chunk_size * 1024 * 1024) / blcksz;
+			table_chunk_pages = (BlockNumber) Min(chunkpages, MaxBlockNumber);
+		}
+	}
+
 	/*
 	 * Find the last built-in OID, if needed (prior to 8.1)
 	 *
@@ -1051,6 +1102,8 @@ help(const char *progname)
 	printf(_("  --snapshot=SNAPSHOT          use given snapshot for the dump\n"));
 	printf(_("  --strict-names               require table and/or schema include patterns to\n"
 			 "                               match at least one entity each\n"));
+	printf(_("  --table-chunk-size=SIZE      dump data of tables larger than SIZE megabytes\n"
+			 "                               in chunks of that size\n"));
 	printf(_("  --use-set-session-authorization\n"
 			 "                               use SET SESSION AUTHORIZATION commands instead of\n"
 			 "                               ALTER OWNER commands to set ownership\n"));
@@ -2324,9 +2377,13 @@ dumpTableData(Archive *fout, TableDataInfo *tdinfo)
 		 * However, relpages is declared as "integer" in pg_class, and hence
 		 * also in TableInfo, but it's really BlockNumber a/k/a unsigned int.
 		 * Cast so that we get the right interpretation of table sizes
-		 * exceeding INT_MAX pages.
+		 * exceeding INT_MAX pages.  A chunk of a table counts only its own
+		 * pages.
 		 */
-		te->dataLength = (BlockNumber) tbinfo->relpages;
+		if (tdinfo->chunkpages > 0)
+			te->dataLength = tdinfo->chunkpages;
+		else
+			te->dataLength = (BlockNumber) tbinfo->relpages;
 	}
 
 	destroyPQExpBuffer(copyBuf);
@@ -2384,7 +2441,11 @@ getTableData(DumpOptions *dopt, TableInfo *tblinfo, int numTables, char relkind)
 	{
 		if (tblinfo[i].dobj.dump & DUMP_COMPONENT_DATA &&
 			(!relkind || tblinfo[i].relkind == relkind))
+		{
 			makeTableDataInfo(dopt, &(tblinfo[i]));
+			if (table_chunk_pages > 0)
+				makeTableDataChunks(&(tblinfo[i]));
+		}
 	}
 }
 
@@ -2450,11 +2511,90 @@ makeTableDataInfo(DumpOptions *dopt, TableInfo *tbinfo)
 	tdinfo->dobj.namespace = tbinfo->dobj.namespace;
 	tdinfo->tdtable = tbinfo;
 	tdinfo->filtercond = NULL;	/* might get set later */
+	tdinfo->chunkpages = 0;
+	tdinfo->nextChunk = NULL;
 	addObjectDependency(&tdinfo->dobj, tbinfo->dobj.dumpId);
 
 	tbinfo->dataObj = tdinfo;
 }
 
+/*
+ * Split the data of a large table into several TABLE DATA objects, each
+ * covering table_chunk_pages of the table's blocks, so that a parallel dump
+ * and a parallel restore can work on the pieces concurrently.
+ *
+ * Each chunk selects its rows with a ctid range, which the server executes as
+ * a TID Range Scan reading only that chunk's blocks.  The last chunk has no
+ * upper bound, so rows in blocks added since relpages was last updated are
+ * not missed.  The table's existing TableDataInfo becomes the first chunk and
+ * the rest are chained to it through nextChunk.
+ */
+static void
+makeTableDataChunks(TableInfo *tbinfo)
+{
+	TableDataInfo *tdinfo = tbinfo->dataObj;
+	BlockNumber relpages = (BlockNumber) tbinfo->relpages;
+	BlockNumber startblk;
+	TableDataInfo *prev;
+
+	/*
+	 * Only split plain heap tables that are not dumped with a filter
+	 * condition already.  Extension configuration tables are never split,
+	 * since the dependencies among them are set up before we get here.
+	 */
+	if (tdinfo == NULL || tdinfo->dobj.objType != DO_TABLE_DATA ||
+		tdinfo->filtercond != NULL || tdinfo->nextChunk != NULL ||
+		tbinfo->dobj.ext_member)
+		return;
+	if (tbinfo->relkind != RELKIND_RELATION || tbinfo->amname == NULL ||
+		strcmp(tbinfo->amname, "heap") != 0)
+		return;
+	if (relpages <= table_chunk_pages)
+		return;
+
+	tdinfo->filtercond = psprintf("WHERE ctid < '(%u,0)'::pg_catalog.tid",
+								  table_chunk_pages);
+	tdinfo->chunkpages = table_chunk_pages;
+
+	prev = tdinfo;
+	startblk = table_chunk_pages;
+	for (;;)
+	{
+		TableDataInfo *chunk;
+		bool		last = (relpages - startblk <= table_chunk_pages);
+
+		chunk = (TableDataInfo *) pg_malloc(sizeof(TableDataInfo));
+		chunk->dobj.objType = DO_TABLE_DATA;
+		chunk->dobj.catId = tdinfo->dobj.catId;
+		AssignDumpId(&chunk->dobj);
+		chunk->dobj.name = tdinfo->dobj.name;
+		chunk->dobj.namespace = tdinfo->dobj.namespace;
+		chunk->tdtable = tbinfo;
+		if (last)
+		{
+			chunk->filtercond = psprintf("WHERE ctid >= '(%u,0)'::pg_catalog.tid",
+										 startblk);
+			chunk->chunkpages = relpages - startblk;
+		}
+		else
+		{
+			chunk->filtercond = psprintf("WHERE ctid >= '(%u,0)'::pg_catalog.tid"
+										 " AND ctid < '(%u,0)'::pg_catalog.tid",
+										 startblk, startblk + table_chunk_pages);
+			chunk->chunkpages = table_chunk_pages;
+		}
+		chunk->nextChunk = NULL;
+		addObjectDependency(&chunk->dobj, tbinfo->dobj.dumpId);
+
+		prev->nextChunk = chunk;
+		prev = chunk;
+
+		if (last)
+			break;
+		startblk += table_chunk_pages;
+	}
+}
+
 /*
  * The refresh for a materialized view must be dependent on the refresh for
  * any materialized view that this one is dependent on.
@@ -2603,16 +2743,44 @@ getTableDataFKConstraints(void)
 				continue;
 
 			/*
-			 * Okay, make referencing table's TABLE_DATA object depend on the
-			 * referenced table's TABLE_DATA object.
+			 * Okay, make referencing table's TABLE_DATA object(s) depend on
+			 * the referenced table's TABLE_DATA object(s).
 			 */
-			addObjectDependency(&cinfo->contable->dataObj->dobj,
-								ftable->dataObj->dobj.dumpId);
+			addTableDataDependencies(cinfo->contable, ftable);
 		}
 	}
 	free(dobjs);
 }
 
+/*
+ * Make each TABLE_DATA object of contable depend on each TABLE_DATA object of
+ * reftable.  There is usually just one per table, but there are several if
+ * the table's data was split into chunks.
+ */
+static void
+addTableDataDependencies(TableInfo *contable, TableInfo *reftable)
+{
+	TableDataInfo *con;
+	TableDataInfo *ref;
+
+	/*
+	 * For a self-referential table, one self-dependency is enough to have
+	 * the sort complain about it; don't create loops among its chunks.
+	 */
+	if (contable == reftable)
+	{
+		addObjectDependency(&contable->dataObj->dobj,
+							reftable->dataObj->dobj.dumpId);
+		return;
+	}
+
+	for (con = contable->dataObj; con != NULL; con = con->nextChunk)
+	{
+		for (ref = reftable->dataObj; ref != NULL; ref = ref->nextChunk)
+			addObjectDependency(&con->dobj, ref->dobj.dumpId);
+	}
+}
+
 
 /*
  * guessConstraintInheritance:
@@ -351,6 +351,9 @@ typedef struct _tableDataInfo
 	DumpableObject dobj;
 	TableInfo  *tdtable;		/* link to table to dump */
 	char	   *filtercond;		/* WHERE condition to limit rows dumped */
+	uint32		chunkpages;		/* pages in this chunk, or 0 if the table's
+								 * data is dumped whole */
+	struct _tableDataInfo *nextChunk;	/* next chunk of the same table */
 } TableDataInfo;
 
 typedef struct _indxInfo
@@ -4,7 +4,7 @@ use warnings;
 use Config;
 use PostgresNode;
 use TestLib;
-use Test::More tests => 78;
+use Test::More tests => 82;
 
 my $tempdir       = TestLib::tempdir;
 my $tempdir_short = TestLib::tempdir_short;
@@ -98,6 +98,16 @@ command_fails_like(
 	qr/\Qpg_dump: error: parallel backup only supported by the directory format\E/,
 	'pg_dump: parallel backup only supported by the directory format');
 
+command_fails_like(
+	[ 'pg_dump', '--table-chunk-size=1024' ],
+	qr/\Qpg_dump: error: option --table-chunk-size is only supported by the directory format\E/,
+	'pg_dump: option --table-chunk-size is only supported by the directory format');
+
+command_fails_like(
+	[ 'pg_dump', '-Fd', '--table-chunk-size=0' ],
+	qr/\Qpg_dump: error: table-chunk-size must be in range\E/,
+	'pg_dump: table-chunk-size must be in range');
+
 command_fails_like(
 	[ 'pg_dump', '-j', '-1' ],
 	qr/\Qpg_dump: error: invalid number of parallel jobs\E/,
@@ -0,0 +1,84 @@
+use strict;
+use warnings;
+
+use PostgresNode;
+use TestLib;
+use Test::More tests => 7;
+
+my $tempdir = TestLib::tempdir;
+
+my $node = get_new_node('main');
+my $port = $node->port;
+
+$node->init;
+$node->start;
+
+#########################################
+# Dump a table split into chunks with several jobs, restore it with
+# several jobs, and check that the data and the post-data objects of the
+# table survive.
+
+$node->safe_psql(
+	'postgres', q{
+CREATE TABLE big (id int PRIMARY KEY, val text NOT NULL,
+                  CHECK (id > 0));
+CREATE INDEX big_val ON big (val);
+INSERT INTO big SELECT g, repeat('x', 100) || g
+  FROM generate_series(1, 60000) g;
+CREATE TABLE big_ref (id int REFERENCES big, note text);
+INSERT INTO big_ref SELECT g, 'note ' || g
+  FROM generate_series(1, 60000, 7) g;
+VACUUM ANALYZE big;
+});
+
+my $dump_dir = "$tempdir/chunked_dump";
+
+command_ok(
+	[
+		'pg_dump',              '-Fd',
+		'-j',                   '4',
+		'--table-chunk-size=1', '-f',
+		$dump_dir,              '-p',
+		$port,                  'postgres'
+	],
+	'pg_dump: dump with table chunks');
+
+my ($stdout, $stderr) = run_command([ 'pg_restore', '-l', $dump_dir ]);
+my $nchunks = () = $stdout =~ /TABLE DATA public big /g;
+cmp_ok($nchunks, '>', 1, 'pg_dump: large table is dumped in several chunks');
+like(
+	$stdout,
+	qr/Dump Version: 1\.15-0/,
+	'pg_dump: archive with table chunks is marked as needing 1.15');
+
+$node->safe_psql('postgres', 'CREATE DATABASE restored');
+
+command_ok(
+	[ 'pg_restore', '-j', '4', '-p', $port, '-d', 'restored', $dump_dir ],
+	'pg_restore: restore table chunks in parallel');
+
+my $data_sql = q{
+SELECT count(*), sum(id), md5(string_agg(val, ',' ORDER BY id)) FROM big;
+SELECT count(*), sum(id) FROM big_ref;
+};
+is( $node->safe_psql('restored', $data_sql),
+	$node->safe_psql('postgres', $data_sql),
+	'pg_restore: all rows of the chunked table are restored');
+
+my $objects_sql = q{
+SELECT string_agg(indexdef, E'\n' ORDER BY indexname) FROM pg_indexes
+  WHERE tablename IN ('big', 'big_ref');
+SELECT string_agg(conname || ' ' || pg_get_constraintdef(oid), E'\n'
+                  ORDER BY conname)
+  FROM pg_constraint WHERE conrelid IN ('big'::regclass, 'big_ref'::regclass);
+};
+is( $node->safe_psql('restored', $objects_sql),
+	$node->safe_psql('postgres', $objects_sql),
+	'pg_restore: indexes and constraints of the chunked table are restored');
+
+is( $node->safe_psql(
+		'restored',
+		q{SELECT bool_and(indisvalid) FROM pg_index
+		  WHERE indrelid = 'big'::regclass}),
+	't',
+	'pg_restore: indexes of the chunked table are valid');
@@ -0,0 +1,129 @@
+/*-------------------------------------------------------------------------
+ *
+ * backup_compression.c
+ *	  Compression methods for base backups compressed by the server
+ *
+ * The server and pg_basebackup both need to know the names of the methods,
+ * and whether this build can handle them: the server to compress the tar
+ * streams it sends, and pg_basebackup to decompress them again when it
+ * writes out a plain-format backup.
+ *
+ * Portions Copyright (c) 2016-2020, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *		  src/common/backup_compression.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef FRONTEND
+#include "postgres.h"
+#else
+#include "postgres_fe.h"
+#endif
+
+#include "common/backup_compression.h"
+
+/*
+ * If 'name' is a recognized compression method, set *method to the
+ * corresponding constant and return true.  Otherwise, set *method to
+ * BACKUP_COMPRESSION_NONE and return false.
+ */
+bool
+parse_backup_compression(const char *name, pg_backup_compression *method)
+{
+	pg_backup_compression result_method = BACKUP_COMPRESSION_NONE;
+	bool		result = true;
+
+	if (pg_strcasecmp(name, "none") == 0)
+		result_method = BACKUP_COMPRESSION_NONE;
+	else if (pg_strcasecmp(name, "gzip") == 0)
+		result_method = BACKUP_COMPRESSION_GZIP;
+	else if (pg_strcasecmp(name, "lz4") == 0)
+		result_method = BACKUP_COMPRESSION_LZ4;
+	else if (pg_strcasecmp(name, "zstd") == 0)
+		result_method = BACKUP_COMPRESSION_ZSTD;
+	else
+		result = false;
+
+	*method = result_method;
+	return result;
+}
+
+/*
+ * Get the canonical name of a compression method.
+ */
+const char *
+backup_compression_name(pg_backup_compression method)
+{
+	switch (method)
+	{
+		case BACKUP_COMPRESSION_NONE:
+			return "none";
+		case BACKUP_COMPRESSION_GZIP:
+			return "gzip";
+		case BACKUP_COMPRESSION_LZ4:
+			return "lz4";
+		case BACKUP_COMPRESSION_ZSTD:
+			return "zstd";
+	}
+
+	Assert(false);
+	return "???";
+}
+
+/*
+ * Get the file name extension of a tar file compressed with the given
+ * method.
+ */
+const char *
+backup_compression_extension(pg_backup_compression method)
+{
+	switch (method)
+	{
+		case BACKUP_COMPRESSION_NONE:
+			return "";
+		case BACKUP_COMPRESSION_GZIP:
+			return ".gz";
+		case BACKUP_COMPRESSION_LZ4:
+			return ".lz4";
+		case BACKUP_COMPRESSION_ZSTD:
+			return ".zst";
+	}
+
+	Assert(false);
+	return "";
+}
+
+/*
+ * Was this build compiled with support for the given compression method?
+ */
+bool
+backup_compression_supported(pg_backup_compression method)
+{
+	switch (method)
+	{
+		case BACKUP_COMPRESSION_NONE:
+			return true;
+		case BACKUP_COMPRESSION_GZIP:
+#ifdef HAVE_LIBZ
+			return true;
+#else
+			return false;
+#endif
+		case BACKUP_COMPRESSION_LZ4:
+#ifdef USE_LZ4
+			return true;
+#else
+			return false;
+#endif
+		case BACKUP_COMPRESSION_ZSTD:
+#ifdef USE_ZSTD
+			return true;
+#else
+			return false;
+#endif
+	}
+
+	return false;
+}
@@ -53,6 +53,7 @@ typedef struct HeapScanDescData
 	BlockNumber rs_startblock;	/* block # to start at */
 	BlockNumber rs_numblocks;	/* max number of blocks to scan */
 	/* rs_numblocks is usually InvalidBlockNumber, meaning "scan whole rel" */
+	BlockNumber rs_limitblocks; /* rs_numblocks before the scan started */
 
 	/* scan current state */
 	bool		rs_inited;		/* false = scan not init'd yet */
@@ -63,12 +64,36 @@ typedef struct HeapScanDescData
 	/* rs_numblocks is usually InvalidBlockNumber, meaning "scan whole rel" */
 	BufferAccessStrategy rs_strategy;	/* access strategy for reads */
 
+	/*
+	 * Sequential and bitmap scans read their blocks through a read stream,
+	 * created on first use.  A sequential scan only uses it while moving
+	 * forward; rs_prefetch_block and rs_prefetch_remaining describe the
+	 * blocks the stream has yet to return in a non-parallel scan, and
+	 * rs_nextbuf holds the buffer of the block just allocated to a parallel
+	 * one.
+	 */
+	struct ReadStream *rs_read_stream;
+	ScanDirection rs_dir;		/* direction of the current heapgettup() */
+	BlockNumber rs_prefetch_block;
+	BlockNumber rs_prefetch_remaining;
+	Buffer		rs_nextbuf;
+
 	HeapTupleData rs_ctup;		/* current tuple in scan, if any */
 
 	/* these fields only used in page-at-a-time mode and for bitmap scans */
 	int			rs_cindex;		/* current tuple's index in vistuples */
 	int			rs_ntuples;		/* number of visible tuples on page */
 	OffsetNumber rs_vistuples[MaxHeapTuplesPerPage];	/* their offsets */
+
+	/*
+	 * these fields only used in bitmap scans: pages that needn't be fetched
+	 * are counted in rs_empty_tuples_pending and rs_skipped_pages when the
+	 * read stream comes across them, and returned as rs_empty_tuples
+	 */
+	Buffer		rs_vmbuffer;	/* visibility map buffer, if pinned */
+	int			rs_empty_tuples_pending;
+	int			rs_empty_tuples;
+	int			rs_skipped_pages;
 }			HeapScanDescData;
 typedef struct HeapScanDescData *HeapScanDesc;
 
@@ -121,6 +146,11 @@ extern void heap_endscan(TableScanDesc scan);
 extern HeapTuple heap_getnext(TableScanDesc scan, ScanDirection direction);
 extern bool heap_getnextslot(TableScanDesc sscan,
 							 ScanDirection direction, struct TupleTableSlot *slot);
+extern void heap_set_tidrange(TableScanDesc sscan, ItemPointer mintid,
+							  ItemPointer maxtid);
+extern bool heap_getnextslot_tidrange(TableScanDesc sscan,
+									  ScanDirection direction,
+									  TupleTableSlot *slot);
 
 extern bool heap_fetch(Relation relation, Snapshot snapshot,
 					   HeapTuple tuple, Buffer *userbuf);
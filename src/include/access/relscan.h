@@ -23,6 +23,8 @@
 
 
 struct ParallelTableScanDescData;
+struct TBMIterator;
+struct TBMSharedIterator;
 
 /*
  * Generic descriptor for table scans. This is the base-class for table scans,
@@ -42,9 +44,20 @@ typedef struct TableScanDescData
 	 */
 	uint32		rs_flags;
 
+	/* Range of ItemPointers for table_scan_getnextslot_tidrange() to scan. */
+	ItemPointerData rs_mintid;
+	ItemPointerData rs_maxtid;
+
 	struct ParallelTableScanDescData *rs_parallel;	/* parallel scan
 													 * information */
 
+	/*
+	 * For bitmap scans, the iterator over the bitmap, set by the executor.
+	 * Only one of them is used, depending on whether the scan is parallel.
+	 */
+	struct TBMIterator *rs_tbmiterator;
+	struct TBMSharedIterator *rs_shared_tbmiterator;
+
 } TableScanDescData;
 typedef struct TableScanDescData *TableScanDesc;
 
@@ -196,6 +196,13 @@ typedef struct VariableCacheData
 	TransactionId latestCompletedXid;	/* newest XID that has committed or
 										 * aborted */
 
+	/*
+	 * Number of times the set of running XIDs has shrunk, that is, a
+	 * transaction with an XID has committed or aborted.  GetSnapshotData()
+	 * uses it to tell whether a snapshot it computed before is still good.
+	 */
+	uint64		xactCompletionCount;
+
 	/*
 	 * These fields are protected by CLogTruncationLock
 	 */
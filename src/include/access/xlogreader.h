@@ -148,6 +148,9 @@ struct XLogReaderState
 	uint32		main_data_len;	/* main data portion's length */
 	uint32		main_data_bufsz;	/* allocated size of the buffer */
 
+	/* payload length before compression, if XLR_COMPRESSED */
+	uint32		raw_payload_len;
+
 	RepOriginId record_origin;
 
 	/* information about blocks referenced by the record. */
@@ -207,6 +210,10 @@ struct XLogReaderState
 	char	   *readRecordBuf;
 	uint32		readRecordBufSize;
 
+	/* Buffer for the decompressed payload of an XLR_COMPRESSED record */
+	char	   *decompressBuf;
+	uint32		decompressBufSize;
+
 	/* Buffer to hold error message */
 	char	   *errormsg_buf;
 };
@@ -284,6 +291,9 @@ extern bool DecodeXLogRecord(XLogReaderState *state, XLogRecord *record,
 #define XLogRecGetInfo(decoder) ((decoder)->decoded_record->xl_info)
 #define XLogRecGetRmid(decoder) ((decoder)->decoded_record->xl_rmid)
 #define XLogRecGetXid(decoder) ((decoder)->decoded_record->xl_xid)
+#define XLogRecIsCompressed(decoder) \
+	(((decoder)->decoded_record->xl_info & XLR_COMPRESSED) != 0)
+#define XLogRecGetRawPayloadLen(decoder) ((decoder)->raw_payload_len)
 #define XLogRecGetOrigin(decoder) ((decoder)->record_origin)
 #define XLogRecGetData(decoder) ((decoder)->main_data)
 #define XLogRecGetDataLen(decoder) ((decoder)->main_data_len)
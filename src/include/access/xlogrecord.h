@@ -79,6 +79,33 @@ typedef struct XLogRecord
  */
 #define XLR_CHECK_CONSISTENCY	0x02
 
+/*
+ * The record's payload, that is everything following the fixed-size
+ * XLogRecord header, is compressed.  The header is followed by an
+ * XLogRecordCompressedHeader and the compressed bytes, which decompress to
+ * the usual block headers, block data and main data.  This is set internally
+ * by XLogInsert when wal_record_compression_threshold is enabled.
+ */
+#define XLR_COMPRESSED			0x04
+
+/*
+ * Header for a compressed record payload.  It is stored without padding, so
+ * raw_length is unaligned in the WAL and the fields must be copied one at a
+ * time; SizeOfXLogRecordCompressedHeader is its stored size.
+ */
+typedef struct XLogRecordCompressedHeader
+{
+	uint8		method;			/* XLR_COMPRESSION_* */
+	uint32		raw_length;		/* payload length after decompression */
+} XLogRecordCompressedHeader;
+
+#define SizeOfXLogRecordCompressedHeader (sizeof(uint8) + sizeof(uint32))
+
+/* Compression methods used for record payloads */
+#define XLR_COMPRESSION_PGLZ	1
+#define XLR_COMPRESSION_LZ4		2
+#define XLR_COMPRESSION_ZSTD	3
+
 /*
  * Header info for block data appended to an XLOG record.
  *
@@ -114,7 +141,8 @@ typedef struct XLogRecordBlockHeader
  * present is (BLCKSZ - <length of "hole" bytes>).
  *
  * Additionally, when wal_compression is enabled, we will try to compress full
- * page images using the PGLZ compression algorithm, after removing the "hole".
+ * page images using the selected compression algorithm, after removing the
+ * "hole".
  * This can reduce the WAL volume, but at some extra cost of CPU spent
  * on the compression during WAL logging. In this case, since the "hole"
  * length cannot be calculated by subtracting the number of page image bytes
@@ -134,7 +162,7 @@ typedef struct XLogRecordBlockImageHeader
 	uint8		bimg_info;		/* flag bits, see below */
 
 	/*
-	 * If BKPIMAGE_HAS_HOLE and BKPIMAGE_IS_COMPRESSED, an
+	 * If BKPIMAGE_HAS_HOLE and BKPIMAGE_COMPRESSED(), an
 	 * XLogRecordBlockCompressHeader struct follows.
 	 */
 } XLogRecordBlockImageHeader;
@@ -144,9 +172,15 @@ typedef struct XLogRecordBlockImageHeader
 
 /* Information stored in bimg_info */
 #define BKPIMAGE_HAS_HOLE		0x01	/* page image has "hole" */
-#define BKPIMAGE_IS_COMPRESSED		0x02	/* page image is compressed */
+#define BKPIMAGE_COMPRESS_PGLZ	0x02	/* page image is compressed with pglz */
 #define BKPIMAGE_APPLY		0x04	/* page image should be restored during
 									 * replay */
+#define BKPIMAGE_COMPRESS_LZ4	0x08	/* page image is compressed with lz4 */
+#define BKPIMAGE_COMPRESS_ZSTD	0x10	/* page image is compressed with zstd */
+
+#define BKPIMAGE_COMPRESSED(info) \
+	(((info) & (BKPIMAGE_COMPRESS_PGLZ | BKPIMAGE_COMPRESS_LZ4 | \
+			  BKPIMAGE_COMPRESS_ZSTD)) != 0)
 
 /*
  * Extra header information used when page image has "hole" and
@@ -206,6 +206,17 @@
 #define unlikely(x) ((x) != 0)
 #endif
 
+/*
+ * Hint to the CPU that the cache line containing addr will be read soon.
+ * This is only worth doing when addr can be computed well before it is
+ * dereferenced, and the memory is unlikely to be in cache already.
+ */
+#if __GNUC__ >= 3
+#define pg_prefetch_mem(addr)	__builtin_prefetch(addr)
+#else
+#define pg_prefetch_mem(addr)	((void) 0)
+#endif
+
 /*
  * CppAsString
  *		Convert the argument to a string, using the C preprocessor.
@@ -1114,6 +1125,32 @@ typedef union PGAlignedXLogBlock
 	int64		force_align_i64;
 } PGAlignedXLogBlock;
 
+/*
+ * Same as above, but aligned suitably for direct I/O, see PG_IO_ALIGN_SIZE.
+ * Use these for buffers that are passed to smgr or written to WAL segments
+ * directly.  Without pg_attribute_aligned, they are only MAXALIGN'ed, and
+ * direct I/O can't be enabled.
+ */
+typedef union PGIOAlignedBlock
+{
+#ifdef pg_attribute_aligned
+	pg_attribute_aligned(PG_IO_ALIGN_SIZE)
+#endif
+	char		data[BLCKSZ];
+	double		force_align_d;
+	int64		force_align_i64;
+} PGIOAlignedBlock;
+
+typedef union PGIOAlignedXLogBlock
+{
+#ifdef pg_attribute_aligned
+	pg_attribute_aligned(PG_IO_ALIGN_SIZE)
+#endif
+	char		data[XLOG_BLCKSZ];
+	double		force_align_d;
+	int64		force_align_i64;
+} PGIOAlignedXLogBlock;
+
 /* msb for char */
 #define HIGHBIT					(0x80)
 #define IS_HIGHBIT_SET(ch)		((unsigned char)(ch) & HIGHBIT)
@@ -53,6 +53,6 @@
  */
 
 /*							yyyymmddN */
-#define CATALOG_VERSION_NO	202004074
+#define CATALOG_VERSION_NO	202004077
 
 #endif
@@ -0,0 +1,31 @@
+/*-------------------------------------------------------------------------
+ *
+ * backup_compression.h
+ *	  Compression methods for base backups compressed by the server
+ *
+ * Portions Copyright (c) 2016-2020, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *		  src/include/common/backup_compression.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef BACKUP_COMPRESSION_H
+#define BACKUP_COMPRESSION_H
+
+typedef enum pg_backup_compression
+{
+	BACKUP_COMPRESSION_NONE,
+	BACKUP_COMPRESSION_GZIP,
+	BACKUP_COMPRESSION_LZ4,
+	BACKUP_COMPRESSION_ZSTD
+} pg_backup_compression;
+
+extern bool parse_backup_compression(const char *name,
+									 pg_backup_compression *method);
+extern const char *backup_compression_name(pg_backup_compression method);
+extern const char *backup_compression_extension(pg_backup_compression method);
+extern bool backup_compression_supported(pg_backup_compression method);
+
+#endif							/* BACKUP_COMPRESSION_H */
@@ -52,6 +52,10 @@
  * AfterTriggerBeginQuery/AfterTriggerEndQuery.  This does not necessarily
  * mean that the plan can't queue any AFTER triggers; just that the caller
  * is responsible for there being a trigger context for them to be queued in.
+ *
+ * BATCH indicates that the parent node can consume the plan node's output a
+ * batch at a time (see execBatch.c), if the node supports that.  It is only
+ * passed to direct children that support it.
  */
 #define EXEC_FLAG_EXPLAIN_ONLY	0x0001	/* EXPLAIN, no ANALYZE */
 #define EXEC_FLAG_REWIND		0x0002	/* need efficient rescan */
@@ -59,6 +63,7 @@
 #define EXEC_FLAG_MARK			0x0008	/* need mark/restore */
 #define EXEC_FLAG_SKIP_TRIGGERS 0x0010	/* skip AfterTrigger calls */
 #define EXEC_FLAG_WITH_NO_DATA	0x0020	/* rel scannability doesn't matter */
+#define EXEC_FLAG_BATCH			0x0040	/* parent can consume batches */
 
 
 /* Hook for plugins to get control in ExecutorStart() */
@@ -96,6 +101,9 @@ extern void ExecRestrPos(PlanState *node);
 extern bool ExecSupportsMarkRestore(struct Path *pathnode);
 extern bool ExecSupportsBackwardScan(Plan *node);
 extern bool ExecMaterializesOutput(NodeTag plantype);
+extern bool ExecSupportsBatchOutput(Plan *node);
+extern bool ExecBatchOutputReady(PlanState *node);
+extern void ExecLimitBatchAttrs(PlanState *node, int natts);
 
 /*
  * prototypes from functions in execCurrent.c
@@ -224,6 +232,7 @@ extern void EvalPlanQualEnd(EPQState *epqstate);
 extern PlanState *ExecInitNode(Plan *node, EState *estate, int eflags);
 extern void ExecSetExecProcNode(PlanState *node, ExecProcNodeMtd function);
 extern Node *MultiExecProcNode(PlanState *node);
+extern struct TupleBatch *ExecGetBatch(PlanState *node);
 extern void ExecEndNode(PlanState *node);
 extern bool ExecShutdownNode(PlanState *node);
 extern void ExecSetTupleBound(int64 tuples_needed, PlanState *child_node);
@@ -14,6 +14,7 @@
 #ifndef HASHJOIN_H
 #define HASHJOIN_H
 
+#include "lib/bloomfilter.h"
 #include "nodes/execnodes.h"
 #include "port/atomics.h"
 #include "storage/barrier.h"
@@ -80,6 +81,28 @@ typedef struct HashJoinTupleData
 #define HJTUPLE_MINTUPLE(hjtup)  \
 	((MinimalTuple) ((char *) (hjtup) + HJTUPLE_OVERHEAD))
 
+/*
+ * If hash_join_bucket_tags is on, a private (non-parallel) hash table keeps
+ * a tag for each bucket next to the bucket array, with one bit set for each
+ * tuple in the bucket, chosen by the top bits of its hash value.  A probe
+ * whose bit isn't set in the tag can't find a match, so it needn't follow
+ * the bucket's pointer into the tuples at all.  The tags array is a quarter
+ * of the size of the bucket array, so more of it stays in cache.
+ *
+ * The bucket number and the batch number come from the low bits of the hash
+ * value, so the top bits are still useful for telling the tuples of a bucket
+ * apart except in very large joins.
+ */
+typedef uint16 HashJoinBucketTag;
+
+#define HJ_BUCKET_TAG(hashvalue) \
+	((HashJoinBucketTag) (1 << ((hashvalue) >> 28)))
+
+/* memory needed for each bucket */
+#define HJ_BUCKET_SIZE(hashtable) \
+	(sizeof(HashJoinTuple) + \
+	 ((hashtable)->bucketTags != NULL ? sizeof(HashJoinBucketTag) : 0))
+
 /*
  * If the outer relation's distribution is sufficiently nonuniform, we attempt
  * to optimize the join by treating the hash values corresponding to the outer
@@ -243,6 +266,7 @@ typedef struct ParallelHashJoinState
 	int			nparticipants;
 	size_t		space_allowed;
 	size_t		total_tuples;	/* total number of inner tuples */
+	dsa_pointer runtime_filter; /* SharedRuntimeFilter, if any */
 	LWLock		lock;			/* lock protecting the above */
 
 	Barrier		build_barrier;	/* synchronization for the build phases */
@@ -281,6 +305,74 @@ typedef struct ParallelHashJoinState
 #define PHJ_GROW_BUCKETS_REINSERTING	2
 #define PHJ_GROW_BUCKETS_PHASE(n)		((n) % 3)	/* circular phases */
 
+/* ----------------------------------------------------------------
+ *				runtime filter structures
+ *
+ * A hash join whose outer input is a plain scan of a table can give that
+ * scan a runtime filter summarizing the join keys of the inner relation, so
+ * that the scan discards rows that can't have a join partner right after
+ * fetching them, instead of passing them up to be rejected by the probe.
+ * This is only done for join types that drop unmatched outer rows.
+ *
+ * The filter is built along with the hash table: a Bloom filter over the
+ * hash values of the inner tuples, which the outer rows' hash values must
+ * be found in, plus the range of each key whose operator belongs to a btree
+ * opfamily and compares a pass-by-value type with itself.  Like the hash
+ * table, it covers all the inner tuples, whatever batch they go to.  In a
+ * Parallel Hash, each participant builds a filter over the tuples it
+ * hashed, and they are combined in a SharedRuntimeFilter before probing.
+ *
+ * If a filter turns out not to reject enough rows to pay for itself, the
+ * scan stops applying it.
+ * ----------------------------------------------------------------
+ */
+typedef struct RuntimeFilterRange
+{
+	bool		empty;			/* no inner values seen yet? */
+	Datum		min;			/* smallest inner value */
+	Datum		max;			/* largest inner value */
+} RuntimeFilterRange;
+
+typedef struct RuntimeFilterKey
+{
+	AttrNumber	attno;			/* key column of the outer scan's tuples */
+	FmgrInfo	hashfn;			/* hash function for the outer values */
+	Oid			collation;		/* collation of the join operator */
+	bool		strict;			/* is the join operator strict? */
+	bool		hasrange;		/* do we track the range of the key? */
+	FmgrInfo	cmpfn;			/* btree comparison function, if hasrange */
+	RuntimeFilterRange range;	/* range of the inner values, if hasrange */
+} RuntimeFilterKey;
+
+typedef struct RuntimeFilterData
+{
+	ScanState  *scan;			/* scan on the outer side of the join */
+	int			nkeys;			/* number of join keys */
+	RuntimeFilterKey *keys;		/* array of length nkeys */
+	int64		nelems;			/* expected number of inner tuples */
+	bloom_filter *bloom;		/* hash values of the inner tuples, or NULL
+								 * if it wouldn't fit in memory */
+	uint64		ntested;		/* # of outer rows tested */
+	uint64		nrejected;		/* # of outer rows rejected */
+} RuntimeFilterData;
+
+/*
+ * The combined filter of a Parallel Hash, in DSA memory.  The Bloom filter
+ * follows the array of ranges, at SharedRuntimeFilterBloom().
+ */
+typedef struct SharedRuntimeFilter
+{
+	int			nkeys;
+	RuntimeFilterRange ranges[FLEXIBLE_ARRAY_MEMBER];
+} SharedRuntimeFilter;
+
+#define SharedRuntimeFilterBloomOffset(nkeys) \
+	MAXALIGN(offsetof(SharedRuntimeFilter, ranges) + \
+			 (nkeys) * sizeof(RuntimeFilterRange))
+#define SharedRuntimeFilterBloom(shared) \
+	((bloom_filter *) ((char *) (shared) + \
+					   SharedRuntimeFilterBloomOffset((shared)->nkeys)))
+
 typedef struct HashJoinTableData
 {
 	int			nbuckets;		/* # buckets in the in-memory hash table */
@@ -299,6 +391,9 @@ typedef struct HashJoinTableData
 		dsa_pointer_atomic *shared;
 	}			buckets;
 
+	/* bucketTags[i] is the tag of the i'th bucket, or NULL; see above */
+	HashJoinBucketTag *bucketTags;
+
 	bool		keepNulls;		/* true to store unmatchable NULL tuples */
 
 	bool		skewEnabled;	/* are we using skew optimization? */
@@ -339,6 +434,9 @@ typedef struct HashJoinTableData
 	bool	   *hashStrict;		/* is each hash join operator strict? */
 	Oid		   *collations;
 
+	/* Runtime filter to add the inner tuples to, or NULL */
+	RuntimeFilter runtimefilter;
+
 	Size		spaceUsed;		/* memory space currently used by tuples */
 	Size		spaceAllowed;	/* upper limit for space used */
 	Size		spacePeak;		/* peak space used */
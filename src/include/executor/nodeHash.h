@@ -19,6 +19,9 @@
 
 struct SharedHashJoinBatch;
 
+/* GUC parameter */
+extern PGDLLIMPORT bool hash_join_bucket_tags;
+
 extern HashState *ExecInitHash(Hash *node, EState *estate, int eflags);
 extern Node *MultiExecHash(HashState *node);
 extern void ExecEndHash(HashState *node);
@@ -49,10 +52,16 @@ extern bool ExecHashGetHashValue(HashJoinTable hashtable,
 								 bool outer_tuple,
 								 bool keep_nulls,
 								 uint32 *hashvalue);
+extern void ExecHashTableBeginRuntimeFilter(HashJoinTable hashtable,
+											RuntimeFilter filter);
+extern bool ExecRuntimeFilterTest(RuntimeFilter filter, TupleTableSlot *slot,
+								  ExprContext *econtext);
 extern void ExecHashGetBucketAndBatch(HashJoinTable hashtable,
 									  uint32 hashvalue,
 									  int *bucketno,
 									  int *batchno);
+extern void ExecHashPrefetchBuckets(HashJoinTable hashtable,
+									const uint32 *hashvalues, int n);
 extern bool ExecScanHashBucket(HashJoinState *hjstate, ExprContext *econtext);
 extern bool ExecParallelScanHashBucket(HashJoinState *hjstate, ExprContext *econtext);
 extern void ExecPrepHashTableForUnmatched(HashJoinState *hjstate);
@@ -18,6 +18,10 @@
 #include "nodes/execnodes.h"
 #include "storage/buffile.h"
 
+/* GUC parameters */
+extern PGDLLIMPORT bool runtime_join_filter;
+extern PGDLLIMPORT bool hash_join_prefetch;
+
 extern HashJoinState *ExecInitHashJoin(HashJoin *node, EState *estate, int eflags);
 extern void ExecEndHashJoin(HashJoinState *node);
 extern void ExecReScanHashJoin(HashJoinState *node);
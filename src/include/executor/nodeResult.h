@@ -14,6 +14,7 @@
 #ifndef NODERESULT_H
 #define NODERESULT_H
 
+#include "executor/execBatch.h"
 #include "nodes/execnodes.h"
 
 extern ResultState *ExecInitResult(Result *node, EState *estate, int eflags);
@@ -21,5 +22,6 @@ extern void ExecEndResult(ResultState *node);
 extern void ExecResultMarkPos(ResultState *node);
 extern void ExecResultRestrPos(ResultState *node);
 extern void ExecReScanResult(ResultState *node);
+extern TupleBatch *ExecResultGetBatch(ResultState *node);
 
 #endif							/* NODERESULT_H */
@@ -17,6 +17,7 @@
 #include "access/tupconvert.h"
 #include "executor/instrument.h"
 #include "fmgr.h"
+#include "lib/ilist.h"
 #include "lib/pairingheap.h"
 #include "nodes/params.h"
 #include "nodes/plannodes.h"
@@ -1054,6 +1055,11 @@ typedef struct PlanState
 		if (((PlanState *)(node))->instrument) \
 			((PlanState *)(node))->instrument->nfiltered2 += (delta); \
 	} while(0)
+#define InstrCountFiltered3(node, delta) \
+	do { \
+		if (((PlanState *)(node))->instrument) \
+			((PlanState *)(node))->instrument->nfiltered3 += (delta); \
+	} while(0)
 
 /*
  * EPQState is state for executing an EvalPlanQual recheck on a candidate
@@ -1325,6 +1331,7 @@ typedef struct BitmapOrState
  *		currentRelation    relation being scanned (NULL if none)
  *		currentScanDesc    current scan descriptor for scan (NULL if none)
  *		ScanTupleSlot	   pointer to slot in tuple table holding scan tuple
+ *		RuntimeFilter	   filter pushed down by a hash join (NULL if none)
  * ----------------
  */
 typedef struct ScanState
@@ -1333,6 +1340,7 @@ typedef struct ScanState
 	Relation	ss_currentRelation;
 	struct TableScanDescData *ss_currentScanDesc;
 	TupleTableSlot *ss_ScanTupleSlot;
+	struct RuntimeFilterData *ss_RuntimeFilter;
 } ScanState;
 
 /* ----------------
@@ -1343,6 +1351,13 @@ typedef struct SeqScanState
 {
 	ScanState	ss;				/* its first field is NodeTag */
 	Size		pscan_len;		/* size of parallel heap scan descriptor */
+
+	/* these fields are used only in batch mode (see execBatch.c) */
+	struct TupleBatch *batch;	/* current batch of rows, or NULL */
+	struct BatchQual *batchqual;	/* part of qual evaluated per batch */
+	TupleTableSlot *batchslot;	/* slot the table AM fetches rows into */
+	bool		batchpending;	/* batchslot holds a row not yet batched */
+	bool		batchdone;		/* table AM has returned all its rows */
 } SeqScanState;
 
 /* ----------------
@@ -1534,11 +1549,7 @@ typedef enum
 /* ----------------
  *	 ParallelBitmapHeapState information
  *		tbmiterator				iterator for scanning current pages
- *		prefetch_iterator		iterator for prefetching ahead of current page
- *		mutex					mutual exclusion for the prefetching variable
- *								and state
- *		prefetch_pages			# pages prefetch iterator is ahead of current
- *		prefetch_target			current target prefetch distance
+ *		mutex					mutual exclusion for the state
  *		state					current state of the TIDBitmap
  *		cv						conditional wait variable
  *		phs_snapshot_data		snapshot data shared to workers
@@ -1547,10 +1558,7 @@ typedef enum
 typedef struct ParallelBitmapHeapState
 {
 	dsa_pointer tbmiterator;
-	dsa_pointer prefetch_iterator;
 	slock_t		mutex;
-	int			prefetch_pages;
-	int			prefetch_target;
 	SharedBitmapState state;
 	ConditionVariable cv;
 	char		phs_snapshot_data[FLEXIBLE_ARRAY_MEMBER];
@@ -1562,21 +1570,12 @@ typedef struct ParallelBitmapHeapState
  *		bitmapqualorig	   execution state for bitmapqualorig expressions
  *		tbm				   bitmap obtained from child index scan(s)
  *		tbmiterator		   iterator for scanning current pages
- *		tbmres			   current-page data
- *		can_skip_fetch	   can we potentially skip tuple fetches in this scan?
- *		return_empty_tuples number of empty tuples to return
- *		vmbuffer		   buffer for visibility-map lookups
- *		pvmbuffer		   ditto, for prefetched pages
+ *		recheck			   do current page's tuples need recheck?
  *		exact_pages		   total number of exact pages retrieved
  *		lossy_pages		   total number of lossy pages retrieved
- *		prefetch_iterator  iterator for prefetching ahead of current page
- *		prefetch_pages	   # pages prefetch iterator is ahead of current
- *		prefetch_target    current target prefetch distance
- *		prefetch_maximum   maximum value for prefetch_target
  *		pscan_len		   size of the shared memory for parallel bitmap
  *		initialized		   is node is ready to iterate
  *		shared_tbmiterator	   shared iterator
- *		shared_prefetch_iterator shared iterator for prefetching
  *		pstate			   shared state for parallel bitmap scan
  * ----------------
  */
@@ -1586,21 +1585,12 @@ typedef struct BitmapHeapScanState
 	ExprState  *bitmapqualorig;
 	TIDBitmap  *tbm;
 	TBMIterator *tbmiterator;
-	TBMIterateResult *tbmres;
-	bool		can_skip_fetch;
-	int			return_empty_tuples;
-	Buffer		vmbuffer;
-	Buffer		pvmbuffer;
+	bool		recheck;
 	long		exact_pages;
 	long		lossy_pages;
-	TBMIterator *prefetch_iterator;
-	int			prefetch_pages;
-	int			prefetch_target;
-	int			prefetch_maximum;
 	Size		pscan_len;
 	bool		initialized;
 	TBMSharedIterator *shared_tbmiterator;
-	TBMSharedIterator *shared_prefetch_iterator;
 	ParallelBitmapHeapState *pstate;
 } BitmapHeapScanState;
 
@@ -1626,6 +1616,24 @@ typedef struct TidScanState
 	HeapTupleData tss_htup;
 } TidScanState;
 
+/* ----------------
+ *	 TidRangeScanState information
+ *
+ *		trss_tidexprs		list of TidOpExpr structs (see nodeTidrangescan.c)
+ *		trss_mintid			the lowest TID in the scan range
+ *		trss_maxtid			the highest TID in the scan range
+ *		trss_inScan			is a scan currently in progress?
+ * ----------------
+ */
+typedef struct TidRangeScanState
+{
+	ScanState	ss;				/* its first field is NodeTag */
+	List	   *trss_tidexprs;
+	ItemPointerData trss_mintid;
+	ItemPointerData trss_maxtid;
+	bool		trss_inScan;
+} TidRangeScanState;
+
 /* ----------------
  *	 SubqueryScanState information
  *
@@ -1915,6 +1923,8 @@ typedef struct MergeJoinState
  *		hj_HashOperators		the join operators in the hashjoin condition
  *		hj_HashTable			hash table for the hashjoin
  *								(NULL if table not built yet)
+ *		hj_RuntimeFilter		filter on the inner join keys for the outer
+ *								scan (NULL if we don't build one)
  *		hj_CurHashValue			hash value for current outer tuple
  *		hj_CurBucketNo			regular bucket# for current outer tuple
  *		hj_CurSkewBucketNo		skew bucket# for current outer tuple
@@ -1930,12 +1940,21 @@ typedef struct MergeJoinState
  *		hj_JoinState			current state of ExecHashJoin state machine
  *		hj_MatchedOuter			true if found a join match for current outer
  *		hj_OuterNotEmpty		true if outer relation known not empty
+ *		hj_ProbeSlots			outer tuples read ahead to prefetch their
+ *								buckets, or NULL if not done
+ *		hj_ProbeHashValues		hash values of the tuples in hj_ProbeSlots
+ *		hj_ProbeCount			number of tuples in hj_ProbeSlots
+ *		hj_ProbeNext			next tuple of hj_ProbeSlots to return
+ *		hj_ProbeGroupSize		number of tuples to read ahead next time
+ *		hj_ProbeExhausted		true if the outer batch ended while reading
+ *								ahead
  * ----------------
  */
 
 /* these structs are defined in executor/hashjoin.h: */
 typedef struct HashJoinTupleData *HashJoinTuple;
 typedef struct HashJoinTableData *HashJoinTable;
+typedef struct RuntimeFilterData *RuntimeFilter;
 
 typedef struct HashJoinState
 {
@@ -1945,6 +1964,7 @@ typedef struct HashJoinState
 	List	   *hj_HashOperators;	/* list of operator OIDs */
 	List	   *hj_Collations;
 	HashJoinTable hj_HashTable;
+	RuntimeFilter hj_RuntimeFilter;
 	uint32		hj_CurHashValue;
 	int			hj_CurBucketNo;
 	int			hj_CurSkewBucketNo;
@@ -1957,6 +1977,12 @@ typedef struct HashJoinState
 	int			hj_JoinState;
 	bool		hj_MatchedOuter;
 	bool		hj_OuterNotEmpty;
+	TupleTableSlot **hj_ProbeSlots;
+	uint32	   *hj_ProbeHashValues;
+	int			hj_ProbeCount;
+	int			hj_ProbeNext;
+	int			hj_ProbeGroupSize;
+	bool		hj_ProbeExhausted;
 } HashJoinState;
 
 
@@ -1982,6 +2008,75 @@ typedef struct MaterialState
 	Tuplestorestate *tuplestorestate;
 } MaterialState;
 
+struct ResultCacheEntry;
+struct ResultCacheTuple;
+
+/* ----------------
+ *	 ResultCacheInstrumentation information
+ * ----------------
+ */
+typedef struct ResultCacheInstrumentation
+{
+	uint64		cache_hits;		/* number of rescans whose parameter values
+								 * were found in the cache */
+	uint64		cache_misses;	/* number of rescans whose parameter values
+								 * were not found in the cache */
+	uint64		cache_evictions;	/* number of cache entries removed to
+									 * free memory */
+	uint64		cache_overflows;	/* number of scans whose rows could not
+									 * all be cached, even after evicting
+									 * every other entry */
+	uint64		mem_peak;		/* peak memory usage in bytes */
+} ResultCacheInstrumentation;
+
+/* ----------------
+ *	 Shared memory container for per-worker result cache information
+ * ----------------
+ */
+typedef struct SharedResultCacheInfo
+{
+	int			num_workers;
+	ResultCacheInstrumentation sinstrument[FLEXIBLE_ARRAY_MEMBER];
+} SharedResultCacheInfo;
+
+/* ----------------
+ *	 ResultCacheState information
+ *
+ *		result cache nodes remember the rows returned by their subplan for
+ *		recently seen values of the subplan's parameters.  The cache is a
+ *		hash table keyed by the parameter values; the entries are kept in
+ *		an LRU list so that the least recently used ones can be evicted
+ *		when the cache outgrows hash_mem.
+ * ----------------
+ */
+typedef struct ResultCacheState
+{
+	ScanState	ss;				/* its first field is NodeTag */
+	int			rc_status;		/* state of the ExecResultCache state
+								 * machine */
+	int			nkeys;			/* number of cache keys */
+	struct resultcache_hash *hashtable; /* hash table of cache entries */
+	TupleDesc	hashkeydesc;	/* tuple descriptor for cache keys */
+	TupleTableSlot *tableslot;	/* slot for the keys of cache entries */
+	TupleTableSlot *probeslot;	/* virtual slot used for hash lookups */
+	ExprState  *cache_eq_expr;	/* compares probeslot to tableslot */
+	ExprState **param_exprs;	/* evaluate the current cache key */
+	FmgrInfo   *hashfunctions;	/* hash functions, nkeys in size */
+	Oid		   *collations;		/* collations, nkeys in size */
+	uint64		mem_used;		/* bytes of memory used by the cache */
+	uint64		mem_limit;		/* memory limit in bytes for the cache */
+	MemoryContext tableContext; /* memory context holding the cache */
+	dlist_head	lru_list;		/* keys, least recently used first */
+	struct ResultCacheTuple *last_tuple;	/* last tuple returned from, or
+											 * stored in, the current entry */
+	struct ResultCacheEntry *entry; /* entry that last_tuple belongs to */
+	bool		singlerow;		/* true if a cache entry is complete once
+								 * its first row has been cached */
+	Bitmapset  *keyparamids;	/* paramids of the Params in param_exprs */
+	ResultCacheInstrumentation stats;	/* execution statistics */
+	SharedResultCacheInfo *shared_info; /* statistics of parallel workers */
+} ResultCacheState;
+
 
 /* ----------------
  *	 When performing sorting by multiple keys, it's possible that the input
@@ -2190,6 +2285,10 @@ typedef struct AggState
 	AggStatePerGroup *all_pergroups;	/* array of first ->pergroups, than
 										 * ->hash_pergroup */
 	ProjectionInfo *combinedproj;	/* projection machinery */
+
+	/* used only when aggregating batches of the input (see execBatch.c) */
+	struct BatchAggTrans *batchtrans;	/* per-trans batch transitions, or
+										 * NULL */
 } AggState;
 
 /* ----------------
@@ -2398,6 +2497,14 @@ typedef struct HashState
 
 	/* Parallel hash state. */
 	struct ParallelHashJoinState *parallel_state;
+
+	/*
+	 * Used only when building the hash table from batches of rows of the
+	 * input (see execBatch.c), which are unrelated to hash join batches.
+	 */
+	int		   *batchattrs;		/* column vector of each input column, or
+								 * NULL */
+	TupleTableSlot *batchslot;	/* slot the input rows are stored in */
 } HashState;
 
 /* ----------------
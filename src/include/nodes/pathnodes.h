@@ -709,6 +709,8 @@ typedef struct RelOptInfo
 	PlannerInfo *subroot;		/* if subquery */
 	List	   *subplan_params; /* if subquery */
 	int			rel_parallel_workers;	/* wanted number of parallel workers */
+	uint32		amflags;		/* Bitmask of optional features supported by
+								 * the table AM */
 
 	/* Information about foreign tables and foreign joins */
 	Oid			serverid;		/* identifies server for the table or join */
@@ -755,6 +757,11 @@ typedef struct RelOptInfo
 	List	   *partitioned_child_rels; /* List of RT indexes */
 } RelOptInfo;
 
+/*
+ * Bitmask of flags supported by table AMs, for RelOptInfo.amflags
+ */
+#define AMFLAG_HAS_TID_RANGE (1 << 0)
+
 /*
  * Is given relation partitioned?
  *
@@ -1319,6 +1326,18 @@ typedef struct TidPath
 	List	   *tidquals;		/* qual(s) involving CTID = something */
 } TidPath;
 
+/*
+ * TidRangePath represents a scan by a contiguous range of TIDs
+ *
+ * tidrangequals is an implicitly AND'ed list of qual expressions of the form
+ * "CTID relop pseudoconstant", where relop is one of >,>=,<,<=.
+ */
+typedef struct TidRangePath
+{
+	Path		path;
+	List	   *tidrangequals;
+} TidRangePath;
+
 /*
  * SubqueryScanPath represents a scan of an unflattened subquery-in-FROM
  *
@@ -1456,6 +1475,25 @@ typedef struct MaterialPath
 	Path	   *subpath;
 } MaterialPath;
 
+/*
+ * ResultCachePath represents a ResultCache plan node, i.e., a cache that
+ * remembers the rows its subpath produced for recently seen values of the
+ * subpath's parameters.  It's used on the inner side of a parameterized
+ * nested loop, when the outer side is expected to repeat parameter values.
+ */
+typedef struct ResultCachePath
+{
+	Path		path;
+	Path	   *subpath;		/* path whose output is cached */
+	List	   *hash_operators; /* hash equality operators for each key */
+	List	   *param_exprs;	/* expressions forming the cache key */
+	bool		singlerow;		/* true if a cache entry is complete once
+								 * its first row has been cached */
+	double		calls;			/* expected number of rescans */
+	uint32		est_entries;	/* number of entries the planner expects to
+								 * fit in the cache, or 0 if unknown */
+} ResultCachePath;
+
 /*
  * UniquePath represents elimination of distinct rows from the output of
  * its subpath.
@@ -493,6 +493,19 @@ typedef struct TidScan
 	List	   *tidquals;		/* qual(s) involving CTID = something */
 } TidScan;
 
+/* ----------------
+ *		tid range scan node
+ *
+ * tidrangequals is an implicitly AND'ed list of qual expressions of the form
+ * "CTID relop pseudoconstant", where relop is one of >,>=,<,<=.
+ * ----------------
+ */
+typedef struct TidRangeScan
+{
+	Scan		scan;
+	List	   *tidrangequals;	/* qual(s) involving CTID op something */
+} TidRangeScan;
+
 /* ----------------
  *		subquery scan node
  *
@@ -760,6 +773,28 @@ typedef struct Material
 	Plan		plan;
 } Material;
 
+/* ----------------
+ *		result cache node
+ *
+ * Caches the rows returned by the outer subplan for each set of values of
+ * param_exprs, so that a rescan with parameters seen before can return the
+ * cached rows instead of executing the subplan.
+ * ----------------
+ */
+typedef struct ResultCache
+{
+	Plan		plan;
+	int			numKeys;		/* size of the two arrays below */
+	Oid		   *hashOperators;	/* hash equality operators for each key */
+	Oid		   *collations;		/* collations for each key */
+	List	   *param_exprs;	/* expressions forming the cache key */
+	bool		singlerow;		/* true if a cache entry is complete once
+								 * its first row has been cached */
+	uint32		est_entries;	/* number of entries the planner expects to
+								 * fit in the cache, or 0 if unknown */
+	Bitmapset  *keyparamids;	/* paramids of the Params in param_exprs */
+} ResultCache;
+
 /* ----------------
  *		sort node
  * ----------------
@@ -122,6 +122,14 @@
  */
 #define ALIGNOF_BUFFER	32
 
+/*
+ * Alignment required for buffers used with direct I/O (see io_direct).  The
+ * kernel typically requires buffers, file offsets and transfer sizes to be
+ * aligned to the logical block size of the underlying device, which is at
+ * most 4kB on common hardware.
+ */
+#define PG_IO_ALIGN_SIZE	4096
+
 /*
  * If EXEC_BACKEND is defined, the postmaster uses an alternative method for
  * starting subprocesses: Instead of simply using fork(), as is standard on
@@ -1,7 +1,7 @@
 /* ----------
  *	pgstat.h
  *
- *	Definitions for the PostgreSQL statistics collector daemon.
+ *	Definitions for the PostgreSQL cumulative statistics system.
  *
  *	Copyright (c) 2001-2020, PostgreSQL Global Development Group
  *
@@ -31,7 +31,10 @@
 #define PGSTAT_STAT_PERMANENT_FILENAME		"pg_stat/global.stat"
 #define PGSTAT_STAT_PERMANENT_TMPFILE		"pg_stat/global.tmp"
 
-/* Default directory to store temporary statistics data in */
+/*
+ * Directory for temporary statistics data.  The core statistics don't use it
+ * anymore, but extensions such as pg_stat_statements do.
+ */
 #define PG_STAT_TMP_DIR		"pg_stat_tmp"
 
 /* Values for track_functions GUC variable --- order is significant! */
@@ -43,13 +46,12 @@ typedef enum TrackFunctionsLevel
 }			TrackFunctionsLevel;
 
 /* ----------
- * The types of backend -> collector messages
+ * The types of statistics messages.  Processes collect their statistics in
+ * these messages and apply them to shared memory in batches.
  * ----------
  */
 typedef enum StatMsgType
 {
-	PGSTAT_MTYPE_DUMMY,
-	PGSTAT_MTYPE_INQUIRY,
 	PGSTAT_MTYPE_TABSTAT,
 	PGSTAT_MTYPE_TABPURGE,
 	PGSTAT_MTYPE_DROPDB,
@@ -63,6 +65,8 @@ typedef enum StatMsgType
 	PGSTAT_MTYPE_ARCHIVER,
 	PGSTAT_MTYPE_BGWRITER,
 	PGSTAT_MTYPE_SLRU,
+	PGSTAT_MTYPE_IO,
+	PGSTAT_MTYPE_WALFLUSH,
 	PGSTAT_MTYPE_FUNCSTAT,
 	PGSTAT_MTYPE_FUNCPURGE,
 	PGSTAT_MTYPE_RECOVERYCONFLICT,
@@ -119,11 +123,81 @@ typedef struct PgStat_TableCounts
 	PgStat_Counter t_blocks_hit;
 } PgStat_TableCounts;
 
+/* ----------
+ * IOContext		What kind of buffer access an I/O was done for
+ *
+ * Reads and writes done through a BufferAccessStrategy ring are counted
+ * separately from those done for ordinary accesses to shared buffers.
+ * ----------
+ */
+typedef enum IOContext
+{
+	IOCONTEXT_NORMAL,
+	IOCONTEXT_BULKREAD,
+	IOCONTEXT_BULKWRITE,
+	IOCONTEXT_VACUUM
+} IOContext;
+
+#define IOCONTEXT_NUM_TYPES (IOCONTEXT_VACUUM + 1)
+
+/* ----------
+ * IOOp				Kinds of shared buffer I/O operations that are counted
+ *
+ * IOOP_EVICT counts buffers whose previous contents were thrown out to make
+ * room for another block, IOOP_REUSE those that were taken from a strategy's
+ * ring for that.  Only reads, writes, extends and fsyncs are timed.
+ * ----------
+ */
+typedef enum IOOp
+{
+	IOOP_READ,
+	IOOP_HIT,
+	IOOP_WRITE,
+	IOOP_EXTEND,
+	IOOP_EVICT,
+	IOOP_REUSE,
+	IOOP_FSYNC
+} IOOp;
+
+#define IOOP_NUM_TYPES (IOOP_FSYNC + 1)
+
+/* ----------
+ * PgStat_IOCounts				I/O counts of one backend type
+ *
+ * Like PgStat_TableCounts, this should contain only event counters, since
+ * we memcmp it against zeroes to detect whether there is anything to send.
+ * ----------
+ */
+typedef struct PgStat_IOCounts
+{
+	PgStat_Counter counts[IOCONTEXT_NUM_TYPES][IOOP_NUM_TYPES];
+	PgStat_Counter times[IOCONTEXT_NUM_TYPES][IOOP_NUM_TYPES];	/* times in
+																 * microseconds */
+} PgStat_IOCounts;
+
+/* ----------
+ * PgStat_WalFlushCounts		Group WAL flushes led by one process
+ *
+ * members counts the XLogFlush() calls satisfied by those flushes, including
+ * the leaders' own.  The max_ fields are maximums, not sums.
+ * ----------
+ */
+typedef struct PgStat_WalFlushCounts
+{
+	PgStat_Counter groups;
+	PgStat_Counter members;
+	PgStat_Counter max_members;
+	PgStat_Counter flush_time;	/* times in microseconds */
+	PgStat_Counter max_flush_time;
+} PgStat_WalFlushCounts;
+
 /* Possible targets for resetting cluster-wide shared values */
 typedef enum PgStat_Shared_Reset_Target
 {
 	RESET_ARCHIVER,
-	RESET_BGWRITER
+	RESET_BGWRITER,
+	RESET_IO,
+	RESET_WAL_FLUSH
 } PgStat_Shared_Reset_Target;
 
 /* Possible object types for resetting single counters */
@@ -201,54 +275,14 @@ typedef struct PgStat_MsgHdr
 } PgStat_MsgHdr;
 
 /* ----------
- * Space available in a message.  This will keep the UDP packets below 1K,
- * which should fit unfragmented into the MTU of the loopback interface.
- * (Larger values of PGSTAT_MAX_MSG_SIZE would work for that on most
- * platforms, but we're being conservative here.)
+ * Space available in a message.  This also determines how many entries are
+ * applied to shared memory in one batch.
  * ----------
  */
 #define PGSTAT_MAX_MSG_SIZE 1000
 #define PGSTAT_MSG_PAYLOAD	(PGSTAT_MAX_MSG_SIZE - sizeof(PgStat_MsgHdr))
 
 
-/* ----------
- * PgStat_MsgDummy				A dummy message, ignored by the collector
- * ----------
- */
-typedef struct PgStat_MsgDummy
-{
-	PgStat_MsgHdr m_hdr;
-} PgStat_MsgDummy;
-
-
-/* ----------
- * PgStat_MsgInquiry			Sent by a backend to ask the collector
- *								to write the stats file(s).
- *
- * Ordinarily, an inquiry message prompts writing of the global stats file,
- * the stats file for shared catalogs, and the stats file for the specified
- * database.  If databaseid is InvalidOid, only the first two are written.
- *
- * New file(s) will be written only if the existing file has a timestamp
- * older than the specified cutoff_time; this prevents duplicated effort
- * when multiple requests arrive at nearly the same time, assuming that
- * backends send requests with cutoff_times a little bit in the past.
- *
- * clock_time should be the requestor's current local time; the collector
- * uses this to check for the system clock going backward, but it has no
- * effect unless that occurs.  We assume clock_time >= cutoff_time, though.
- * ----------
- */
-
-typedef struct PgStat_MsgInquiry
-{
-	PgStat_MsgHdr m_hdr;
-	TimestampTz clock_time;		/* observed local clock time */
-	TimestampTz cutoff_time;	/* minimum acceptable file timestamp */
-	Oid			databaseid;		/* requested DB (InvalidOid => shared only) */
-} PgStat_MsgInquiry;
-
-
 /* ----------
  * PgStat_TableEntry			Per-table info in a MsgTabstat
  * ----------
@@ -282,8 +316,8 @@ typedef struct PgStat_MsgTabstat
 
 
 /* ----------
- * PgStat_MsgTabpurge			Sent by the backend to tell the collector
- *								about dead tables.
+ * PgStat_MsgTabpurge			Sent by the backend to report
+ *								dead tables.
  * ----------
  */
 #define PGSTAT_NUM_TABPURGE  \
@@ -300,8 +334,8 @@ typedef struct PgStat_MsgTabpurge
 
 
 /* ----------
- * PgStat_MsgDropdb				Sent by the backend to tell the collector
- *								about a dropped database
+ * PgStat_MsgDropdb				Sent by the backend to report
+ *								a dropped database
  * ----------
  */
 typedef struct PgStat_MsgDropdb
@@ -312,7 +346,7 @@ typedef struct PgStat_MsgDropdb
 
 
 /* ----------
- * PgStat_MsgResetcounter		Sent by the backend to tell the collector
+ * PgStat_MsgResetcounter		Sent by the backend to ask
  *								to reset counters
  * ----------
  */
@@ -323,7 +357,7 @@ typedef struct PgStat_MsgResetcounter
 } PgStat_MsgResetcounter;
 
 /* ----------
- * PgStat_MsgResetsharedcounter Sent by the backend to tell the collector
+ * PgStat_MsgResetsharedcounter Sent by the backend to ask
  *								to reset a shared counter
  * ----------
  */
@@ -334,7 +368,7 @@ typedef struct PgStat_MsgResetsharedcounter
 } PgStat_MsgResetsharedcounter;
 
 /* ----------
- * PgStat_MsgResetsinglecounter Sent by the backend to tell the collector
+ * PgStat_MsgResetsinglecounter Sent by the backend to ask
  *								to reset a single counter
  * ----------
  */
@@ -347,7 +381,7 @@ typedef struct PgStat_MsgResetsinglecounter
 } PgStat_MsgResetsinglecounter;
 
 /* ----------
- * PgStat_MsgResetslrucounter Sent by the backend to tell the collector
+ * PgStat_MsgResetslrucounter Sent by the backend to ask
  *								to reset a SLRU counter
  * ----------
  */
@@ -485,7 +519,7 @@ typedef struct PgStat_MsgTempFile
  * it against zeroes to detect whether there are any counts to transmit.
  *
  * Note that the time counters are in instr_time format here.  We convert to
- * microseconds in PgStat_Counter format when transmitting to the collector.
+ * microseconds in PgStat_Counter format when transmitting to shared memory.
  * ----------
  */
 typedef struct PgStat_FunctionCounts
@@ -505,6 +539,29 @@ typedef struct PgStat_BackendFunctionEntry
 	PgStat_FunctionCounts f_counts;
 } PgStat_BackendFunctionEntry;
 
+/* ----------
+ * PgStat_MsgIO					Sent by a process to report the shared buffer
+ *								I/O it has done since the last report.
+ * ----------
+ */
+typedef struct PgStat_MsgIO
+{
+	PgStat_MsgHdr m_hdr;
+	BackendType m_backend_type;
+	PgStat_IOCounts m_counts;
+} PgStat_MsgIO;
+
+/* ----------
+ * PgStat_MsgWalFlush			Sent by a process to report the group WAL
+ *								flushes it has led since the last report.
+ * ----------
+ */
+typedef struct PgStat_MsgWalFlush
+{
+	PgStat_MsgHdr m_hdr;
+	PgStat_WalFlushCounts m_counts;
+} PgStat_MsgWalFlush;
+
 /* ----------
  * PgStat_FunctionEntry			Per-function info in a MsgFuncstat
  * ----------
@@ -535,8 +592,8 @@ typedef struct PgStat_MsgFuncstat
 } PgStat_MsgFuncstat;
 
 /* ----------
- * PgStat_MsgFuncpurge			Sent by the backend to tell the collector
- *								about dead functions.
+ * PgStat_MsgFuncpurge			Sent by the backend to report
+ *								dead functions.
  * ----------
  */
 #define PGSTAT_NUM_FUNCPURGE  \
@@ -552,8 +609,8 @@ typedef struct PgStat_MsgFuncpurge
 } PgStat_MsgFuncpurge;
 
 /* ----------
- * PgStat_MsgDeadlock			Sent by the backend to tell the collector
- *								about a deadlock that occurred.
+ * PgStat_MsgDeadlock			Sent by the backend to report
+ *								a deadlock that occurred.
  * ----------
  */
 typedef struct PgStat_MsgDeadlock
@@ -563,8 +620,8 @@ typedef struct PgStat_MsgDeadlock
 } PgStat_MsgDeadlock;
 
 /* ----------
- * PgStat_MsgChecksumFailure	Sent by the backend to tell the collector
- *								about checksum failures noticed.
+ * PgStat_MsgChecksumFailure	Sent by the backend to report
+ *								checksum failures noticed.
  * ----------
  */
 typedef struct PgStat_MsgChecksumFailure
@@ -583,8 +640,6 @@ typedef struct PgStat_MsgChecksumFailure
 typedef union PgStat_Msg
 {
 	PgStat_MsgHdr msg_hdr;
-	PgStat_MsgDummy msg_dummy;
-	PgStat_MsgInquiry msg_inquiry;
 	PgStat_MsgTabstat msg_tabstat;
 	PgStat_MsgTabpurge msg_tabpurge;
 	PgStat_MsgDropdb msg_dropdb;
@@ -598,6 +653,8 @@ typedef union PgStat_Msg
 	PgStat_MsgArchiver msg_archiver;
 	PgStat_MsgBgWriter msg_bgwriter;
 	PgStat_MsgSLRU msg_slru;
+	PgStat_MsgIO msg_io;
+	PgStat_MsgWalFlush msg_walflush;
 	PgStat_MsgFuncstat msg_funcstat;
 	PgStat_MsgFuncpurge msg_funcpurge;
 	PgStat_MsgRecoveryConflict msg_recoveryconflict;
@@ -608,17 +665,17 @@ typedef union PgStat_Msg
 
 
 /* ------------------------------------------------------------
- * Statistic collector data structures follow
+ * Shared statistics data structures follow
  *
  * PGSTAT_FILE_FORMAT_ID should be changed whenever any of these
  * data structures change.
  * ------------------------------------------------------------
  */
 
-#define PGSTAT_FILE_FORMAT_ID	0x01A5BC9D
+#define PGSTAT_FILE_FORMAT_ID	0x01A5BCA0
 
 /* ----------
- * PgStat_StatDBEntry			The collector's data per database
+ * PgStat_StatDBEntry			The shared data per database
  * ----------
  */
 typedef struct PgStat_StatDBEntry
@@ -648,19 +705,11 @@ typedef struct PgStat_StatDBEntry
 	PgStat_Counter n_block_write_time;
 
 	TimestampTz stat_reset_timestamp;
-	TimestampTz stats_timestamp;	/* time of db stats file update */
-
-	/*
-	 * tables and functions must be last in the struct, because we don't write
-	 * the pointers out to the stats file.
-	 */
-	HTAB	   *tables;
-	HTAB	   *functions;
 } PgStat_StatDBEntry;
 
 
 /* ----------
- * PgStat_StatTabEntry			The collector's data per table (or index)
+ * PgStat_StatTabEntry			The shared data per table (or index)
  * ----------
  */
 typedef struct PgStat_StatTabEntry
@@ -697,7 +746,7 @@ typedef struct PgStat_StatTabEntry
 
 
 /* ----------
- * PgStat_StatFuncEntry			The collector's data per function
+ * PgStat_StatFuncEntry			The shared data per function
  * ----------
  */
 typedef struct PgStat_StatFuncEntry
@@ -712,7 +761,7 @@ typedef struct PgStat_StatFuncEntry
 
 
 /*
- * Archiver statistics kept in the stats collector
+ * Archiver statistics kept in shared memory
  */
 typedef struct PgStat_ArchiverStats
 {
@@ -728,7 +777,7 @@ typedef struct PgStat_ArchiverStats
 } PgStat_ArchiverStats;
 
 /*
- * Global statistics kept in the stats collector
+ * Global statistics kept in shared memory
  */
 typedef struct PgStat_GlobalStats
 {
@@ -747,7 +796,7 @@ typedef struct PgStat_GlobalStats
 } PgStat_GlobalStats;
 
 /*
- * SLRU statistics kept in the stats collector
+ * SLRU statistics kept in shared memory
  */
 typedef struct PgStat_SLRUStats
 {
@@ -761,6 +810,24 @@ typedef struct PgStat_SLRUStats
 	TimestampTz stat_reset_timestamp;
 } PgStat_SLRUStats;
 
+/*
+ * Shared buffer I/O statistics kept in shared memory, by backend type
+ */
+typedef struct PgStat_IOStats
+{
+	PgStat_IOCounts stats[BACKEND_NUM_TYPES];
+	TimestampTz stat_reset_timestamp;
+} PgStat_IOStats;
+
+/*
+ * Group WAL flush statistics kept in shared memory
+ */
+typedef struct PgStat_WalFlushStats
+{
+	PgStat_WalFlushCounts counts;
+	TimestampTz stat_reset_timestamp;
+} PgStat_WalFlushStats;
+
 
 /* ----------
  * Backend states
@@ -807,13 +874,14 @@ typedef enum
 	WAIT_EVENT_BGWRITER_HIBERNATE,
 	WAIT_EVENT_BGWRITER_MAIN,
 	WAIT_EVENT_CHECKPOINTER_MAIN,
+	WAIT_EVENT_IO_WORKER_MAIN,
 	WAIT_EVENT_LOGICAL_APPLY_MAIN,
 	WAIT_EVENT_LOGICAL_LAUNCHER_MAIN,
-	WAIT_EVENT_PGSTAT_MAIN,
 	WAIT_EVENT_RECOVERY_WAL_STREAM,
 	WAIT_EVENT_SYSLOGGER_MAIN,
 	WAIT_EVENT_WAL_RECEIVER_MAIN,
 	WAIT_EVENT_WAL_SENDER_MAIN,
+	WAIT_EVENT_WAL_SUMMARIZER_WAL,
 	WAIT_EVENT_WAL_WRITER_MAIN
 } WaitEventActivity;
 
@@ -847,10 +915,13 @@ typedef enum
  */
 typedef enum
 {
-	WAIT_EVENT_BACKUP_WAIT_WAL_ARCHIVE = PG_WAIT_IPC,
+	WAIT_EVENT_AIO_COMPLETION = PG_WAIT_IPC,
+	WAIT_EVENT_BACKUP_WAIT_PARALLEL_WORKERS,
+	WAIT_EVENT_BACKUP_WAIT_WAL_ARCHIVE,
 	WAIT_EVENT_BGWORKER_SHUTDOWN,
 	WAIT_EVENT_BGWORKER_STARTUP,
 	WAIT_EVENT_BTREE_PAGE,
+	WAIT_EVENT_BUFFER_IO,
 	WAIT_EVENT_CLOG_GROUP_UPDATE,
 	WAIT_EVENT_CHECKPOINT_DONE,
 	WAIT_EVENT_CHECKPOINT_START,
@@ -879,6 +950,7 @@ typedef enum
 	WAIT_EVENT_PARALLEL_BITMAP_SCAN,
 	WAIT_EVENT_PARALLEL_CREATE_INDEX_SCAN,
 	WAIT_EVENT_PARALLEL_FINISH,
+	WAIT_EVENT_PARALLEL_REDO_DRAIN,
 	WAIT_EVENT_PROCARRAY_GROUP_UPDATE,
 	WAIT_EVENT_PROMOTE,
 	WAIT_EVENT_RECOVERY_CONFLICT_SNAPSHOT,
@@ -887,7 +959,9 @@ typedef enum
 	WAIT_EVENT_REPLICATION_ORIGIN_DROP,
 	WAIT_EVENT_REPLICATION_SLOT_DROP,
 	WAIT_EVENT_SAFE_SNAPSHOT,
-	WAIT_EVENT_SYNC_REP
+	WAIT_EVENT_SYNC_REP,
+	WAIT_EVENT_WAL_FLUSH_GROUP,
+	WAIT_EVENT_WAL_SUMMARY_READY
 } WaitEventIPC;
 
 /* ----------
@@ -979,6 +1053,8 @@ typedef enum
 	WAIT_EVENT_WAL_INIT_SYNC,
 	WAIT_EVENT_WAL_INIT_WRITE,
 	WAIT_EVENT_WAL_READ,
+	WAIT_EVENT_WAL_SUMMARY_READ,
+	WAIT_EVENT_WAL_SUMMARY_WRITE,
 	WAIT_EVENT_WAL_SYNC,
 	WAIT_EVENT_WAL_SYNC_METHOD_ASSIGN,
 	WAIT_EVENT_WAL_WRITE
@@ -1055,8 +1131,8 @@ typedef struct PgBackendGSSStatus
  *
  * Each live backend maintains a PgBackendStatus struct in shared memory
  * showing its current activity.  (The structs are allocated according to
- * BackendId, but that is not critical.)  Note that the collector process
- * has no involvement in, or even access to, these structs.
+ * BackendId, but that is not critical.)  Note that these structs are
+ * separate from the cumulative statistics kept in shared memory.
  *
  * Each auxiliary process also maintains a PgBackendStatus struct in shared
  * memory.
@@ -1251,9 +1327,6 @@ extern PGDLLIMPORT bool pgstat_track_activities;
 extern PGDLLIMPORT bool pgstat_track_counts;
 extern PGDLLIMPORT int pgstat_track_functions;
 extern PGDLLIMPORT int pgstat_track_activity_query_size;
-extern char *pgstat_stat_directory;
-extern char *pgstat_stat_tmpname;
-extern char *pgstat_stat_filename;
 
 /*
  * BgWriter statistics counters are updated directly by bgwriter and bufmgr
@@ -1271,35 +1344,34 @@ extern PgStat_MsgSLRU SlruStats[];
 extern PgStat_Counter pgStatBlockReadTime;
 extern PgStat_Counter pgStatBlockWriteTime;
 
+/* Shared-memory state of the statistics, private to pgstat.c */
+typedef struct StatsShmemStruct StatsShmemStruct;
+
 /* ----------
  * Functions called from postmaster
  * ----------
  */
 extern Size BackendStatusShmemSize(void);
 extern void CreateSharedBackendStatus(void);
+extern Size StatsShmemSize(void);
+extern void StatsShmemInit(void);
 
-extern void pgstat_init(void);
-extern int	pgstat_start(void);
 extern void pgstat_reset_all(void);
-extern void allow_immediate_pgstat_restart(void);
-
-#ifdef EXEC_BACKEND
-extern void PgstatCollectorMain(int argc, char *argv[]) pg_attribute_noreturn();
-#endif
 
 
 /* ----------
  * Functions called from backends
  * ----------
  */
-extern void pgstat_ping(void);
-
 extern void pgstat_report_stat(bool force);
 extern void pgstat_vacuum_stat(void);
 extern void pgstat_drop_database(Oid databaseid);
 
 extern void pgstat_clear_snapshot(void);
 extern void pgstat_reset_counters(void);
+
+extern void pgstat_write_statsfile(void);
+extern void pgstat_restore_stats(void);
 extern void pgstat_reset_shared_counters(const char *);
 extern void pgstat_reset_single_counter(Oid objectid, PgStat_Single_Reset_Type type);
 extern void pgstat_reset_slru_counter(const char *);
@@ -1464,6 +1536,8 @@ extern void pgstat_twophase_postabort(TransactionId xid, uint16 info,
 
 extern void pgstat_send_archiver(const char *xlog, bool failed);
 extern void pgstat_send_bgwriter(void);
+extern void pgstat_send_io(void);
+extern void pgstat_send_wal_flush(void);
 
 /* ----------
  * Support functions for the SQL-callable functions to
@@ -1472,6 +1546,8 @@ extern void pgstat_send_bgwriter(void);
  */
 extern PgStat_StatDBEntry *pgstat_fetch_stat_dbentry(Oid dbid);
 extern PgStat_StatTabEntry *pgstat_fetch_stat_tabentry(Oid relid);
+extern PgStat_StatTabEntry *pgstat_fetch_stat_tabentry_ext(bool shared,
+															Oid relid);
 extern PgBackendStatus *pgstat_fetch_stat_beentry(int beid);
 extern LocalPgBackendStatus *pgstat_fetch_stat_local_beentry(int beid);
 extern PgStat_StatFuncEntry *pgstat_fetch_stat_funcentry(Oid funcid);
@@ -1479,6 +1555,8 @@ extern int	pgstat_fetch_stat_numbackends(void);
 extern PgStat_ArchiverStats *pgstat_fetch_stat_archiver(void);
 extern PgStat_GlobalStats *pgstat_fetch_global(void);
 extern PgStat_SLRUStats *pgstat_fetch_slru(void);
+extern PgStat_IOStats *pgstat_fetch_stat_io(void);
+extern PgStat_WalFlushStats *pgstat_fetch_stat_wal_flush(void);
 
 extern void pgstat_count_slru_page_zeroed(SlruCtl ctl);
 extern void pgstat_count_slru_page_hit(SlruCtl ctl);
@@ -1490,4 +1568,11 @@ extern void pgstat_count_slru_truncate(SlruCtl ctl);
 extern char *pgstat_slru_name(int idx);
 extern int pgstat_slru_index(const char *name);
 
+extern void pgstat_count_io_op(IOContext io_context, IOOp io_op);
+extern void pgstat_count_io_time(IOContext io_context, IOOp io_op,
+								 instr_time io_time);
+extern const char *pgstat_io_context_desc(IOContext io_context);
+
+extern void pgstat_count_wal_flush_group(int members, instr_time *flush_time);
+
 #endif							/* PGSTAT_H */
@@ -0,0 +1,43 @@
+/*-------------------------------------------------------------------------
+ *
+ * basebackup_incremental.h
+ *	  API for deciding which blocks an incremental base backup must send
+ *
+ * Portions Copyright (c) 2010-2020, PostgreSQL Global Development Group
+ *
+ * src/include/replication/basebackup_incremental.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef BASEBACKUP_INCREMENTAL_H
+#define BASEBACKUP_INCREMENTAL_H
+
+#include "access/xlogdefs.h"
+#include "common/relpath.h"
+#include "lib/stringinfo.h"
+#include "storage/block.h"
+#include "storage/relfilenode.h"
+
+typedef struct IncrementalBackupInfo IncrementalBackupInfo;
+
+typedef enum
+{
+	BACK_UP_FILE_FULLY,
+	BACK_UP_FILE_INCREMENTALLY
+} FileBackupMethod;
+
+extern IncrementalBackupInfo *CreateIncrementalBackupInfo(XLogRecPtr prior_lsn,
+														  TimeLineID prior_tli);
+extern void PrepareForIncrementalBackup(IncrementalBackupInfo *ib,
+										XLogRecPtr backup_start_lsn,
+										TimeLineID backup_start_tli,
+										StringInfo labelfile);
+extern FileBackupMethod GetFileBackupMethod(IncrementalBackupInfo *ib,
+											const RelFileNode *rnode,
+											ForkNumber forknum,
+											unsigned segno, off_t size,
+											unsigned *num_blocks_required,
+											BlockNumber *relative_block_numbers,
+											unsigned *truncation_block_length);
+
+#endif							/* BASEBACKUP_INCREMENTAL_H */
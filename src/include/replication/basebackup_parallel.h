@@ -0,0 +1,67 @@
+/*-------------------------------------------------------------------------
+ *
+ * basebackup_parallel.h
+ *	  API for taking a base backup over several connections at once
+ *
+ * Portions Copyright (c) 2010-2020, PostgreSQL Global Development Group
+ *
+ * src/include/replication/basebackup_parallel.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef BASEBACKUP_PARALLEL_H
+#define BASEBACKUP_PARALLEL_H
+
+#include "access/xlogdefs.h"
+#include "common/backup_compression.h"
+#include "common/checksum_helper.h"
+#include "nodes/pg_list.h"
+#include "storage/buffile.h"
+
+/*
+ * The options of a parallel backup that the leader shares with its workers.
+ */
+typedef struct ParallelBackupParams
+{
+	int			nparticipants;	/* number of connections, leader included */
+	XLogRecPtr	startptr;		/* start of the backup */
+	bool		started_in_recovery;
+	bool		noverify_checksums;
+	uint32		maxrate;		/* per connection, 0 for no limit */
+	pg_backup_compression compression;
+	int			compression_level;
+	int			compression_workers;
+	bool		manifest;		/* is a backup manifest being built? */
+	bool		manifest_force_encode;
+	pg_checksum_type manifest_checksum_type;
+} ParallelBackupParams;
+
+typedef struct ParallelBackupState ParallelBackupState;
+
+extern Size ParallelBackupShmemSize(void);
+extern void ParallelBackupShmemInit(void);
+
+/* Functions for the leader */
+extern ParallelBackupState *ParallelBackupBegin(const ParallelBackupParams *params,
+												List *tablespaces);
+extern void ParallelBackupWaitForWorkers(ParallelBackupState *pb,
+										 long long *checksum_failures);
+extern BufFile *ParallelBackupOpenManifest(ParallelBackupState *pb,
+										   int worker);
+
+/* Functions for the workers */
+extern ParallelBackupState *ParallelBackupJoin(int leader_pid,
+											   ParallelBackupParams *params,
+											   List **tablespaces);
+extern BufFile *ParallelBackupCreateManifest(ParallelBackupState *pb);
+extern void ParallelBackupWorkerDone(ParallelBackupState *pb,
+									 BufFile *manifest,
+									 long long checksum_failures);
+
+/* Functions for both */
+extern void ParallelBackupEnd(ParallelBackupState *pb);
+extern int	ParallelBackupNumWorkers(ParallelBackupState *pb);
+extern bool ParallelBackupIsMyFile(ParallelBackupState *pb, const char *path);
+extern void ParallelBackupCheckForFailure(ParallelBackupState *pb);
+
+#endif							/* BASEBACKUP_PARALLEL_H */
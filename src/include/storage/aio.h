@@ -0,0 +1,147 @@
+/*-------------------------------------------------------------------------
+ *
+ * aio.h
+ *	  Asynchronous I/O subsystem.
+ *
+ * See src/backend/storage/aio/README for an overview.
+ *
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/storage/aio.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef AIO_H
+#define AIO_H
+
+#include "port/pg_iovec.h"
+#include "storage/block.h"
+#include "storage/relfilenode.h"
+
+/* Possible values for the io_method GUC */
+typedef enum IoMethod
+{
+	IOMETHOD_SYNC,				/* execute I/O synchronously when staged */
+	IOMETHOD_WORKER,			/* hand I/O off to I/O worker processes */
+	IOMETHOD_IO_URING			/* Linux io_uring */
+} IoMethod;
+
+#define DEFAULT_IO_METHOD IOMETHOD_SYNC
+
+/*
+ * io_uring rings are created by the postmaster and inherited by its children
+ * through fork(), which rules out EXEC_BACKEND builds.
+ */
+#if defined(HAVE_LINUX_IO_URING_H) && !defined(EXEC_BACKEND)
+#define USE_IO_URING
+#endif
+
+/*
+ * Maximum number of iovecs an I/O can use, which is also the maximum number
+ * of callback arguments it can carry, e.g. one per buffer of a multi-block
+ * read.
+ */
+#define PGAIO_MAX_IOV	PG_IOV_MAX
+
+/* Operations an I/O handle can perform */
+typedef enum PgAioOp
+{
+	PGAIO_OP_INVALID = 0,
+	PGAIO_OP_READ
+} PgAioOp;
+
+/*
+ * Completion callbacks.  These are referenced by number rather than by
+ * function pointer, because completion may happen in a process other than
+ * the one that started the I/O.
+ */
+typedef enum PgAioCallbackId
+{
+	PGAIO_CB_NONE = 0,
+	PGAIO_CB_SHARED_BUFFER_READ
+} PgAioCallbackId;
+
+/*
+ * Outcome of an I/O, as determined by its completion callback.  Callbacks
+ * must not throw errors, or even log warnings, so it is up to the issuing
+ * backend to report anything but PGAIO_RS_OK once it collects the result.
+ * A status is recorded for each callback argument, so that for example a
+ * multi-block read can report which of its blocks failed.  Callbacks can
+ * pass along additional information as "status_data", see
+ * pgaio_io_set_status().
+ */
+typedef enum PgAioResultStatus
+{
+	PGAIO_RS_UNKNOWN = 0,		/* not yet completed */
+	PGAIO_RS_OK,				/* success */
+	PGAIO_RS_ZEROED,			/* invalid data was zeroed out */
+	PGAIO_RS_SHORT_READ,		/* read fewer bytes than requested */
+	PGAIO_RS_INVALID_PAGE,		/* page failed verification */
+	PGAIO_RS_ERROR				/* the system call failed */
+} PgAioResultStatus;
+
+/* Flags for pgaio_io_set_callback(), interpreted by the callback */
+#define PGAIO_FLAG_ZERO_ON_ERROR		0x01	/* zero pages that fail
+												 * verification */
+
+typedef struct PgAioHandle PgAioHandle;
+
+/* GUC variables */
+extern int	io_method;
+extern int	io_max_concurrency;
+extern int	io_workers;
+
+/* upper limits for the GUCs above */
+#define MAX_IO_MAX_CONCURRENCY	1024
+#define MAX_IO_WORKERS			32
+
+/* shared memory setup, in aio.c */
+extern Size AioShmemSize(void);
+extern void AioShmemInit(void);
+extern void pgaio_init_backend(void);
+extern int	pgaio_inherited_fds(void);
+
+/* handle lifecycle */
+extern PgAioHandle *pgaio_io_acquire_nb(void);
+extern void pgaio_io_release(PgAioHandle *ioh);
+extern int	pgaio_io_get_id(PgAioHandle *ioh);
+
+/* defining an I/O */
+extern void pgaio_io_set_target(PgAioHandle *ioh, RelFileNodeBackend rnode,
+								ForkNumber forknum, BlockNumber blocknum);
+extern void pgaio_io_get_target(PgAioHandle *ioh, RelFileNodeBackend *rnode,
+								ForkNumber *forknum, BlockNumber *blocknum);
+extern void pgaio_io_set_callback(PgAioHandle *ioh, PgAioCallbackId cb,
+								  int flags);
+extern void pgaio_io_add_cb_data(PgAioHandle *ioh, int cb_data);
+extern void pgaio_io_prep_readv(PgAioHandle *ioh, int fd,
+								const struct iovec *iov, int iovcnt,
+								off_t offset);
+
+/* submitting and waiting */
+extern void pgaio_io_stage(PgAioHandle *ioh);
+extern void pgaio_submit_staged(void);
+extern void pgaio_io_wait(PgAioHandle *ioh);
+extern void pgaio_wait_for_id(int id);
+extern void pgaio_closing_fd(int fd);
+
+/* for use by completion callbacks and by the issuer collecting results */
+extern int	pgaio_io_get_cb_data(PgAioHandle *ioh, int **cb_data);
+extern int	pgaio_io_get_flags(PgAioHandle *ioh);
+extern int	pgaio_io_get_result(PgAioHandle *ioh);
+extern PgAioResultStatus pgaio_io_get_status(PgAioHandle *ioh, int i,
+											 int *status_data);
+extern void pgaio_io_set_status(PgAioHandle *ioh, int i,
+								PgAioResultStatus status, int status_data);
+
+/* cleanup */
+extern void pgaio_wait_all_owned(void);
+extern void pgaio_io_release_resowner(int id);
+
+/* I/O workers, in aio_worker.c */
+extern void IoWorkersRegister(void);
+extern void IoWorkerMain(Datum main_arg) pg_attribute_noreturn();
+
+#endif							/* AIO_H */
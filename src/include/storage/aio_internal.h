@@ -0,0 +1,103 @@
+/*-------------------------------------------------------------------------
+ *
+ * aio_internal.h
+ *	  Declarations shared between the implementation files of the
+ *	  asynchronous I/O subsystem.  Nothing outside src/backend/storage/aio
+ *	  should include this.
+ *
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/storage/aio_internal.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef AIO_INTERNAL_H
+#define AIO_INTERNAL_H
+
+#include "storage/aio.h"
+#include "storage/condition_variable.h"
+
+/*
+ * States of an I/O handle.
+ *
+ * Only the owning backend moves a handle out of AHS_IDLE, AHS_HANDED_OUT and
+ * AHS_STAGED.  Any process may move it from AHS_IN_FLIGHT to AHS_COMPLETED,
+ * and only the owner moves it from there back to AHS_IDLE.
+ */
+typedef enum PgAioHandleState
+{
+	AHS_IDLE = 0,				/* not in use */
+	AHS_HANDED_OUT,				/* acquired, I/O being defined */
+	AHS_STAGED,					/* defined, waiting to be submitted */
+	AHS_IN_FLIGHT,				/* submitted, not yet completed */
+	AHS_COMPLETED				/* completion callback has run */
+} PgAioHandleState;
+
+struct PgAioHandle
+{
+	/* state, see above; read without locks, so use barriers when changing */
+	volatile uint8 state;
+
+	uint8		op;				/* PgAioOp */
+	uint8		cb;				/* PgAioCallbackId */
+	uint8		flags;			/* PGAIO_FLAG_* */
+
+	int			owner_procno;	/* pgprocno of the owning backend */
+
+	/* what is being read, starting at which block */
+	RelFileNodeBackend rnode;
+	ForkNumber	forknum;
+	BlockNumber blocknum;
+
+	/* how it is read */
+	int			fd;
+	off_t		offset;
+	int			iovcnt;
+	int			amount;			/* total length of iov */
+	struct iovec iov[PGAIO_MAX_IOV];
+
+	/* bytes transferred, or negative errno */
+	int			result;
+
+	/* arguments for the completion callback */
+	int			ncb_data;
+	int			cb_data[PGAIO_MAX_IOV];
+
+	/*
+	 * PgAioResultStatus, and callback-specific detail about it, for each
+	 * callback argument.  An I/O without callback arguments has just one.
+	 */
+	uint8		status[PGAIO_MAX_IOV];
+	uint8		status_data[PGAIO_MAX_IOV];
+
+	/* broadcast when the handle reaches AHS_COMPLETED */
+	ConditionVariable cv;
+};
+
+/* Shared array of all I/O handles */
+extern PgAioHandle *pgaio_handles;
+extern int	pgaio_num_handles;
+
+/* in aio.c */
+extern void pgaio_io_perform_synchronously(PgAioHandle *ioh);
+extern void pgaio_io_process_completion(PgAioHandle *ioh);
+extern void pgaio_io_wait_cv(PgAioHandle *ioh);
+
+/* in aio_worker.c */
+extern Size pgaio_worker_shmem_size(void);
+extern void pgaio_worker_shmem_init(void);
+extern void pgaio_worker_submit(int nios, PgAioHandle **ios);
+
+/* in aio_uring.c */
+#ifdef USE_IO_URING
+extern Size pgaio_uring_shmem_size(void);
+extern void pgaio_uring_shmem_init(void);
+extern void pgaio_uring_init_backend(void);
+extern int	pgaio_uring_inherited_fds(void);
+extern void pgaio_uring_submit(int nios, PgAioHandle **ios);
+extern void pgaio_uring_wait_one(PgAioHandle *ioh);
+#endif
+
+#endif							/* AIO_INTERNAL_H */
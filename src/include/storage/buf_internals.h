@@ -15,9 +15,11 @@
 #ifndef BUFMGR_INTERNALS_H
 #define BUFMGR_INTERNALS_H
 
+#include "pgstat.h"
 #include "port/atomics.h"
 #include "storage/buf.h"
 #include "storage/bufmgr.h"
+#include "storage/condition_variable.h"
 #include "storage/latch.h"
 #include "storage/lwlock.h"
 #include "storage/shmem.h"
@@ -221,12 +223,27 @@ typedef union BufferDescPadded
 
 #define BufferDescriptorGetBuffer(bdesc) ((bdesc)->buf_id + 1)
 
-#define BufferDescriptorGetIOLock(bdesc) \
-	(&(BufferIOLWLockArray[(bdesc)->buf_id]).lock)
+/*
+ * State of I/O on a buffer that doesn't fit in the BufferDesc.  Backends
+ * waiting for BM_IO_IN_PROGRESS to be cleared sleep on the condition
+ * variable.  While an asynchronous read into the buffer is in progress, aio
+ * holds the id of its I/O handle, so that waiters can help the I/O along;
+ * otherwise it is -1.  aio is protected by the buffer header lock.
+ */
+typedef struct BufferIO
+{
+	ConditionVariable cv;
+	int			aio;
+} BufferIO;
+
+#define BufferDescriptorGetIO(bdesc) \
+	(&BufferIOArray[(bdesc)->buf_id])
+#define BufferDescriptorGetIOCV(bdesc) \
+	(&BufferIOArray[(bdesc)->buf_id].cv)
 #define BufferDescriptorGetContentLock(bdesc) \
 	((LWLock*) (&(bdesc)->content_lock))
 
-extern PGDLLIMPORT LWLockMinimallyPadded *BufferIOLWLockArray;
+extern PGDLLIMPORT BufferIO *BufferIOArray;
 
 /*
  * The freeNext field is either the index of the next freelist entry,
@@ -306,17 +323,23 @@ extern void ScheduleBufferTagForWriteback(WritebackContext *context, BufferTag *
 
 /* freelist.c */
 extern BufferDesc *StrategyGetBuffer(BufferAccessStrategy strategy,
-									 uint32 *buf_state);
+									 uint32 *buf_state, bool *from_ring);
 extern void StrategyFreeBuffer(BufferDesc *buf);
 extern bool StrategyRejectBuffer(BufferAccessStrategy strategy,
 								 BufferDesc *buf);
 
-extern int	StrategySyncStart(uint32 *complete_passes, uint32 *num_buf_alloc);
+extern int	StrategyNumPartitions(void);
+extern void StrategyPartitionRange(int partition, int *first_buffer,
+								   int *num_buffers);
+extern int	StrategyPartitionNode(int partition);
+extern int	StrategySyncStart(int partition, uint32 *complete_passes,
+							  uint32 *num_buf_alloc);
 extern void StrategyNotifyBgWriter(int bgwprocno);
 
 extern Size StrategyShmemSize(void);
 extern void StrategyInitialize(bool init);
 extern bool have_free_buffer(void);
+extern IOContext IOContextForStrategy(BufferAccessStrategy strategy);
 
 /* buf_table.c */
 extern Size BufTableShmemSize(int size);
@@ -14,6 +14,7 @@
 #ifndef BUFMGR_H
 #define BUFMGR_H
 
+#include "port/pg_iovec.h"
 #include "storage/block.h"
 #include "storage/buf.h"
 #include "storage/bufpage.h"
@@ -55,6 +56,30 @@ typedef struct PrefetchBufferResult
 	bool		initiated_io;	/* If true, a miss resulting in async I/O */
 } PrefetchBufferResult;
 
+/*
+ * State of a read started by StartReadBuffers(), to be completed by
+ * WaitReadBuffer().  When consecutive blocks are read with one I/O, only the
+ * entry for the first of them has "ioh" set.
+ */
+typedef struct PendingBufferRead
+{
+	Buffer		buffer;			/* the buffer being read into */
+	struct PgAioHandle *ioh;	/* I/O to wait for, or NULL if none */
+	int			nblocks;		/* number of blocks read by ioh */
+	RelFileNodeBackend rnode;	/* what is being read, for error reports */
+	ForkNumber	forknum;
+	BlockNumber blocknum;
+	BufferAccessStrategy strategy;	/* for I/O statistics */
+} PendingBufferRead;
+
+/* Possible values for numa */
+typedef enum NumaPlacement
+{
+	NUMA_PLACEMENT_OFF,			/* leave placement to the operating system */
+	NUMA_PLACEMENT_INTERLEAVE,	/* spread buffers over all nodes */
+	NUMA_PLACEMENT_PARTITION	/* one range of buffers per node */
+} NumaPlacement;
+
 /* forward declared, to avoid having to expose buf_internals.h here */
 struct WritebackContext;
 
@@ -71,6 +96,7 @@ extern double bgwriter_lru_multiplier;
 extern bool track_io_timing;
 extern int	effective_io_concurrency;
 extern int	maintenance_io_concurrency;
+extern int	io_combine_limit;
 
 extern int	checkpoint_flush_after;
 extern int	backend_flush_after;
@@ -78,6 +104,7 @@ extern int	bgwriter_flush_after;
 
 /* in buf_init.c */
 extern PGDLLIMPORT char *BufferBlocks;
+extern int	numa_placement;
 
 /* in localbuf.c */
 extern PGDLLIMPORT int NLocBuffer;
@@ -87,6 +114,10 @@ extern PGDLLIMPORT int32 *LocalRefCount;
 /* upper limit for effective_io_concurrency */
 #define MAX_IO_CONCURRENCY 1000
 
+/* upper limit and default for io_combine_limit, in blocks */
+#define MAX_IO_COMBINE_LIMIT PG_IOV_MAX
+#define DEFAULT_IO_COMBINE_LIMIT Min(MAX_IO_COMBINE_LIMIT, (128 * 1024) / BLCKSZ)
+
 /* special block number for ReadBuffer() */
 #define P_NEW	InvalidBlockNumber	/* grow the file to get a new page */
 
@@ -183,6 +214,16 @@ extern Buffer ReadBufferExtended(Relation reln, ForkNumber forkNum,
 extern Buffer ReadBufferWithoutRelcache(RelFileNode rnode,
 										ForkNumber forkNum, BlockNumber blockNum,
 										ReadBufferMode mode, BufferAccessStrategy strategy);
+extern bool StartReadBuffer(PendingBufferRead *read, Relation reln,
+							ForkNumber forkNum, BlockNumber blockNum,
+							ReadBufferMode mode,
+							BufferAccessStrategy strategy);
+extern bool StartReadBuffers(PendingBufferRead *reads, int *nblocks,
+							 Relation reln, ForkNumber forkNum,
+							 BlockNumber blockNum, ReadBufferMode mode,
+							 BufferAccessStrategy strategy);
+extern Buffer WaitReadBuffer(PendingBufferRead *read);
+extern void SharedBufferReadComplete(struct PgAioHandle *ioh);
 extern void ReleaseBuffer(Buffer buffer);
 extern void UnlockReleaseBuffer(Buffer buffer);
 extern void MarkBufferDirty(Buffer buffer);
@@ -243,6 +284,7 @@ extern void TestForOldSnapshot_impl(Snapshot snapshot, Relation relation);
 /* in freelist.c */
 extern BufferAccessStrategy GetAccessStrategy(BufferAccessStrategyType btype);
 extern void FreeAccessStrategy(BufferAccessStrategy strategy);
+extern int	GetAccessStrategyBufferCount(BufferAccessStrategy strategy);
 
 
 /* inline functions */
@@ -418,6 +418,16 @@ do { \
 						((overwrite) ? PAI_OVERWRITE : 0) | \
 						((is_heap) ? PAI_IS_HEAP : 0))
 
+/*
+ * Flags for PageIsVerifiedExtended()
+ */
+#define PIV_LOG_WARNING			(1 << 0)	/* log checksum failures */
+#define PIV_REPORT_STAT			(1 << 1)	/* count them in pgstat */
+
+#define PageIsVerified(page, blkno) \
+	PageIsVerifiedExtended(page, blkno, \
+						   PIV_LOG_WARNING | PIV_REPORT_STAT, NULL)
+
 /*
  * Check that BLCKSZ is a multiple of sizeof(size_t).  In PageIsVerified(),
  * it is much faster to check if a page is full of zeroes using the native
@@ -429,7 +439,8 @@ StaticAssertDecl(BLCKSZ == ((BLCKSZ / sizeof(size_t)) * sizeof(size_t)),
 				 "BLCKSZ has to be a multiple of sizeof(size_t)");
 
 extern void PageInit(Page page, Size pageSize, Size specialSize);
-extern bool PageIsVerified(Page page, BlockNumber blkno);
+extern bool PageIsVerifiedExtended(Page page, BlockNumber blkno, int flags,
+								   bool *checksum_failure_p);
 extern OffsetNumber PageAddItemExtended(Page page, Item item, Size size,
 										OffsetNumber offsetNumber, int flags);
 extern Page PageGetTempPage(Page page);
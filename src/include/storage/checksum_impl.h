@@ -6,7 +6,9 @@
  * This file exists for the benefit of external programs that may wish to
  * check Postgres page checksums.  They can #include this to get the code
  * referenced by storage/checksum.h.  (Note: you may need to redefine
- * Assert() as empty to compile this successfully externally.)
+ * Assert() as empty to compile this successfully externally.  If the build
+ * was configured with vectorized checksum implementations, the program also
+ * needs to link with libpgport.)
  *
  * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
  * Portions Copyright (c) 1994, Regents of the University of California
@@ -98,10 +100,23 @@
  * to unroll the inner loop to avoid loop overhead and minimize register
  * spilling. For less sophisticated compilers it might be beneficial to
  * manually unroll the inner loop.
+ *
+ * Compilers only vectorize the loop for the instruction set the build
+ * targets, which for portable binaries is usually just SSE2. If configure
+ * found that the compiler can produce AVX2 or AVX-512 code, pg_checksum_block
+ * therefore uses an explicitly vectorized implementation from src/port
+ * instead, chosen on first use depending on what the CPU supports. Those
+ * keep the 32 sums in four 256-bit or two 512-bit registers, and produce
+ * exactly the same checksums.
  */
 
 #include "storage/bufpage.h"
 
+#if defined(USE_AVX2_CHECKSUM_WITH_RUNTIME_CHECK) || defined(USE_AVX512_CHECKSUM_WITH_RUNTIME_CHECK)
+#define PG_CHECKSUM_BLOCK_VECTORIZED
+#include "port/pg_checksum_block.h"
+#endif
+
 /* number of checksums to calculate in parallel */
 #define N_SUMS 32
 /* prime multiplier of FNV-1a hash */
@@ -153,6 +168,25 @@ pg_checksum_block(const PGChecksummablePage *page)
 	/* ensure that the size is compatible with the algorithm */
 	Assert(sizeof(PGChecksummablePage) == BLCKSZ);
 
+#ifdef PG_CHECKSUM_BLOCK_VECTORIZED
+	{
+		static pg_checksum_block_fn vectorized = NULL;
+		static bool vectorized_chosen = false;
+
+		StaticAssertStmt(N_SUMS == PG_CHECKSUM_BLOCK_SUMS &&
+						 FNV_PRIME == PG_CHECKSUM_BLOCK_PRIME,
+						 "vectorized checksum parameters do not match");
+
+		if (!vectorized_chosen)
+		{
+			vectorized = pg_checksum_block_choose();
+			vectorized_chosen = true;
+		}
+		if (vectorized != NULL)
+			return vectorized(&page->data[0][0], checksumBaseOffsets);
+	}
+#endif
+
 	/* initialize partial checksums to their corresponding offsets */
 	memcpy(sums, checksumBaseOffsets, sizeof(checksumBaseOffsets));
 
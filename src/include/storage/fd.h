@@ -48,10 +48,18 @@
 
 typedef int File;
 
+struct PgAioHandle;				/* avoid including storage/aio.h here */
+struct iovec;					/* avoid including port/pg_iovec.h here */
 
 /* GUC parameter */
 extern PGDLLIMPORT int max_files_per_process;
 extern PGDLLIMPORT bool data_sync_retry;
+extern PGDLLIMPORT int io_direct_flags;
+
+/* Flags for io_direct_flags */
+#define IO_DIRECT_DATA			0x01	/* relation data files */
+#define IO_DIRECT_WAL			0x02	/* WAL segments, when written */
+#define IO_DIRECT_WAL_INIT		0x04	/* WAL segments, when initialized */
 
 /*
  * This is private to fd.c, but exported for save/restore_backend_variables()
@@ -83,6 +91,9 @@ extern void FileClose(File file);
 extern int	FilePrefetch(File file, off_t offset, int amount, uint32 wait_event_info);
 extern int	FileRead(File file, char *buffer, int amount, off_t offset, uint32 wait_event_info);
 extern int	FileWrite(File file, char *buffer, int amount, off_t offset, uint32 wait_event_info);
+extern int	FileReadV(File file, const struct iovec *iov, int iovcnt, off_t offset, uint32 wait_event_info);
+extern int	FilePrepareReadV(File file, const struct iovec *iov, int iovcnt, off_t offset, struct PgAioHandle *ioh);
+extern int	FileWriteV(File file, const struct iovec *iov, int iovcnt, off_t offset, uint32 wait_event_info);
 extern int	FileSync(File file, uint32 wait_event_info);
 extern off_t FileSize(File file);
 extern int	FileTruncate(File file, off_t offset, uint32 wait_event_info);
@@ -30,10 +30,16 @@ extern void mdextend(SMgrRelation reln, ForkNumber forknum,
 					 BlockNumber blocknum, char *buffer, bool skipFsync);
 extern bool mdprefetch(SMgrRelation reln, ForkNumber forknum,
 					   BlockNumber blocknum);
-extern void mdread(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
-				   char *buffer);
-extern void mdwrite(SMgrRelation reln, ForkNumber forknum,
-					BlockNumber blocknum, char *buffer, bool skipFsync);
+extern void mdreadv(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
+					char **buffers, BlockNumber nblocks);
+extern BlockNumber mdmaxcombine(SMgrRelation reln, ForkNumber forknum,
+								BlockNumber blocknum);
+extern void mdpreparereadv(SMgrRelation reln, ForkNumber forknum,
+						   BlockNumber blocknum, char **buffers,
+						   BlockNumber nblocks, PgAioHandle *ioh);
+extern void mdwritev(SMgrRelation reln, ForkNumber forknum,
+					 BlockNumber blocknum, char **buffers, BlockNumber nblocks,
+					 bool skipFsync);
 extern void mdwriteback(SMgrRelation reln, ForkNumber forknum,
 						BlockNumber blocknum, BlockNumber nblocks);
 extern BlockNumber mdnblocks(SMgrRelation reln, ForkNumber forknum);
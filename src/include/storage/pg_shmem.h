@@ -63,6 +63,7 @@ typedef enum
 
 #ifndef WIN32
 extern unsigned long UsedShmemSegID;
+extern Size UsedShmemPageSize;
 #else
 extern HANDLE UsedShmemSegID;
 extern void *ShmemProtectiveRegion;
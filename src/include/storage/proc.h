@@ -108,6 +108,8 @@ struct PGPROC
 								 * else InvalidLocalTransactionId */
 	int			pid;			/* Backend's process ID; 0 if prepared xact */
 	int			pgprocno;
+	int			pgxactoff;		/* position in the ProcArray, and so in
+								 * ProcGlobal->xids, or -1 if not in it */
 
 	/* These fields are zero while a backend is still starting up: */
 	BackendId	backendId;		/* This backend's backend ID (if assigned) */
@@ -188,6 +190,12 @@ struct PGPROC
 	XLogRecPtr	clogGroupMemberLsn; /* WAL location of commit record for clog
 									 * group member */
 
+	/* Support for group WAL flush. */
+	bool		walFlushGroupMember;	/* true, if member of WAL flush group */
+	pg_atomic_uint32 walFlushGroupNext; /* next WAL flush group member */
+	XLogRecPtr	walFlushGroupMemberLsn; /* WAL location the member needs
+										 * flushed */
+
 	/* Per-backend LWLock.  Protects fields below (but not group fields). */
 	LWLock		backendLock;
 
@@ -247,6 +255,16 @@ typedef struct PROC_HDR
 	PGPROC	   *allProcs;
 	/* Array of PGXACT structures (not including dummies for prepared txns) */
 	PGXACT	   *allPgXact;
+
+	/*
+	 * Copy of the xid of each PGXACT in the ProcArray, in the same order as
+	 * the ProcArray, so that snapshots can be built by scanning just this
+	 * dense array.  An entry is changed only while holding ProcArrayLock,
+	 * except that a backend assigning itself an XID sets its own entry while
+	 * holding XidGenLock; the position of an entry, PGPROC->pgxactoff, only
+	 * changes while holding both locks exclusively.
+	 */
+	TransactionId *xids;
 	/* Length of allProcs array */
 	uint32		allProcCount;
 	/* Head of list of free PGPROC structures */
@@ -261,8 +279,12 @@ typedef struct PROC_HDR
 	pg_atomic_uint32 procArrayGroupFirst;
 	/* First pgproc waiting for group transaction status update */
 	pg_atomic_uint32 clogGroupFirst;
+	/* First pgproc waiting for group WAL flush */
+	pg_atomic_uint32 walFlushGroupFirst;
 	/* WALWriter process's latch */
 	Latch	   *walwriterLatch;
+	/* Background writer process's latch */
+	Latch	   *bgwriterLatch;
 	/* Checkpointer process's latch */
 	Latch	   *checkpointerLatch;
 	/* Current shared estimate of appropriate spins_per_delay value */
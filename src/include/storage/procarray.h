@@ -79,6 +79,8 @@ extern int	GetMaxSnapshotXidCount(void);
 extern int	GetMaxSnapshotSubxidCount(void);
 
 extern Snapshot GetSnapshotData(Snapshot snapshot);
+extern void UpdateRecentGlobalXmin(void);
+extern void MaybeUpdateRecentGlobalXmin(TransactionId xid);
 
 extern bool ProcArrayInstallImportedXmin(TransactionId xmin,
 										 VirtualTransactionId *sourcevxid);
@@ -15,6 +15,7 @@
 #define SMGR_H
 
 #include "lib/ilist.h"
+#include "storage/aio.h"
 #include "storage/block.h"
 #include "storage/relfilenode.h"
 
@@ -97,8 +98,22 @@ extern bool smgrprefetch(SMgrRelation reln, ForkNumber forknum,
 						 BlockNumber blocknum);
 extern void smgrread(SMgrRelation reln, ForkNumber forknum,
 					 BlockNumber blocknum, char *buffer);
+extern void smgrreadv(SMgrRelation reln, ForkNumber forknum,
+					  BlockNumber blocknum, char **buffers,
+					  BlockNumber nblocks);
+extern BlockNumber smgrmaxcombine(SMgrRelation reln, ForkNumber forknum,
+								  BlockNumber blocknum);
+extern void smgrpreparereadv(SMgrRelation reln, ForkNumber forknum,
+							 BlockNumber blocknum, char **buffers,
+							 BlockNumber nblocks, PgAioHandle *ioh);
+extern void smgrstartreadv(SMgrRelation reln, ForkNumber forknum,
+						   BlockNumber blocknum, char **buffers,
+						   BlockNumber nblocks, PgAioHandle *ioh);
 extern void smgrwrite(SMgrRelation reln, ForkNumber forknum,
 					  BlockNumber blocknum, char *buffer, bool skipFsync);
+extern void smgrwritev(SMgrRelation reln, ForkNumber forknum,
+					   BlockNumber blocknum, char **buffers,
+					   BlockNumber nblocks, bool skipFsync);
 extern void smgrwriteback(SMgrRelation reln, ForkNumber forknum,
 						  BlockNumber blocknum, BlockNumber nblocks);
 extern BlockNumber smgrnblocks(SMgrRelation reln, ForkNumber forknum);
@@ -95,4 +95,9 @@ extern void ResourceOwnerRememberJIT(ResourceOwner owner,
 extern void ResourceOwnerForgetJIT(ResourceOwner owner,
 								   Datum handle);
 
+/* support for asynchronous I/O handle management */
+extern void ResourceOwnerEnlargeAioHandles(ResourceOwner owner);
+extern void ResourceOwnerRememberAioHandle(ResourceOwner owner, int id);
+extern void ResourceOwnerForgetAioHandle(ResourceOwner owner, int id);
+
 #endif							/* RESOWNER_PRIVATE_H */
@@ -52,6 +52,9 @@
 #define DEFAULT_UNK_SEL			0.005
 #define DEFAULT_NOT_UNK_SEL		(1.0 - DEFAULT_UNK_SEL)
 
+/* bits in EstimationInfo.flags */
+#define SELFLAG_USED_DEFAULT		(1 << 0)	/* estimate used a default */
+
 
 /*
  * Clamp a computed probability estimate (which may suffer from roundoff or
@@ -66,6 +69,15 @@
 	} while (0)
 
 
+/*
+ * Additional information about an estimate, returned by estimation functions
+ * that accept an EstimationInfo pointer
+ */
+typedef struct EstimationInfo
+{
+	uint32		flags;			/* SELFLAG_* bits */
+} EstimationInfo;
+
 /* Return data from examine_variable and friends */
 typedef struct VariableStatData
 {
@@ -187,7 +199,8 @@ extern void mergejoinscansel(PlannerInfo *root, Node *clause,
 							 Selectivity *rightstart, Selectivity *rightend);
 
 extern double estimate_num_groups(PlannerInfo *root, List *groupExprs,
-								  double input_rows, List **pgset);
+								  double input_rows, List **pgset,
+								  EstimationInfo *estinfo);
 
 extern void estimate_hash_bucket_stats(PlannerInfo *root,
 									   Node *hashkey, double nbuckets,
@@ -0,0 +1,78 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_checksum_avx2.c
+ *	  Compute data page checksums using AVX2 instructions.
+ *
+ * The 32 parallel sums of the checksum algorithm are kept in four 256-bit
+ * registers, so that each row of the page is folded in with four vector
+ * multiplications. See storage/checksum_impl.h for the algorithm itself.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *	  src/port/pg_checksum_avx2.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "c.h"
+
+#include <immintrin.h>
+
+#include "port/pg_checksum_block.h"
+
+/* one round of the checksum, on eight of the parallel sums */
+#define CHECKSUM_COMP_AVX2(sums, value) \
+do { \
+	__m256i		__tmp = _mm256_xor_si256((sums), (value)); \
+	(sums) = _mm256_xor_si256(_mm256_mullo_epi32(__tmp, prime), \
+							  _mm256_srli_epi32(__tmp, 17)); \
+} while (0)
+
+uint32
+pg_checksum_block_avx2(const uint32 *data, const uint32 *base_offsets)
+{
+	const __m256i prime = _mm256_set1_epi32(PG_CHECKSUM_BLOCK_PRIME);
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i		s0,
+				s1,
+				s2,
+				s3;
+	uint32		lanes[8];
+	uint32		result = 0;
+	int			i;
+
+	/* initialize partial checksums to their corresponding offsets */
+	s0 = _mm256_loadu_si256((const __m256i *) base_offsets);
+	s1 = _mm256_loadu_si256((const __m256i *) (base_offsets + 8));
+	s2 = _mm256_loadu_si256((const __m256i *) (base_offsets + 16));
+	s3 = _mm256_loadu_si256((const __m256i *) (base_offsets + 24));
+
+	/* main checksum calculation */
+	for (i = 0; i < (int) (BLCKSZ / (sizeof(uint32) * PG_CHECKSUM_BLOCK_SUMS)); i++)
+	{
+		CHECKSUM_COMP_AVX2(s0, _mm256_loadu_si256((const __m256i *) data));
+		CHECKSUM_COMP_AVX2(s1, _mm256_loadu_si256((const __m256i *) (data + 8)));
+		CHECKSUM_COMP_AVX2(s2, _mm256_loadu_si256((const __m256i *) (data + 16)));
+		CHECKSUM_COMP_AVX2(s3, _mm256_loadu_si256((const __m256i *) (data + 24)));
+		data += PG_CHECKSUM_BLOCK_SUMS;
+	}
+
+	/* finally add in two rounds of zeroes for additional mixing */
+	for (i = 0; i < 2; i++)
+	{
+		CHECKSUM_COMP_AVX2(s0, zero);
+		CHECKSUM_COMP_AVX2(s1, zero);
+		CHECKSUM_COMP_AVX2(s2, zero);
+		CHECKSUM_COMP_AVX2(s3, zero);
+	}
+
+	/* xor fold partial checksums together */
+	s0 = _mm256_xor_si256(_mm256_xor_si256(s0, s1), _mm256_xor_si256(s2, s3));
+	_mm256_storeu_si256((__m256i *) lanes, s0);
+	for (i = 0; i < 8; i++)
+		result ^= lanes[i];
+
+	return result;
+}
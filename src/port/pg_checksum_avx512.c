@@ -0,0 +1,69 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_checksum_avx512.c
+ *	  Compute data page checksums using AVX-512 instructions.
+ *
+ * The 32 parallel sums of the checksum algorithm are kept in two 512-bit
+ * registers, so that each row of the page is folded in with two vector
+ * multiplications. See storage/checksum_impl.h for the algorithm itself.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *	  src/port/pg_checksum_avx512.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "c.h"
+
+#include <immintrin.h>
+
+#include "port/pg_checksum_block.h"
+
+/* one round of the checksum, on sixteen of the parallel sums */
+#define CHECKSUM_COMP_AVX512(sums, value) \
+do { \
+	__m512i		__tmp = _mm512_xor_si512((sums), (value)); \
+	(sums) = _mm512_xor_si512(_mm512_mullo_epi32(__tmp, prime), \
+							  _mm512_srli_epi32(__tmp, 17)); \
+} while (0)
+
+uint32
+pg_checksum_block_avx512(const uint32 *data, const uint32 *base_offsets)
+{
+	const __m512i prime = _mm512_set1_epi32(PG_CHECKSUM_BLOCK_PRIME);
+	const __m512i zero = _mm512_setzero_si512();
+	__m512i		s0,
+				s1;
+	uint32		lanes[16];
+	uint32		result = 0;
+	int			i;
+
+	/* initialize partial checksums to their corresponding offsets */
+	s0 = _mm512_loadu_si512((const void *) base_offsets);
+	s1 = _mm512_loadu_si512((const void *) (base_offsets + 16));
+
+	/* main checksum calculation */
+	for (i = 0; i < (int) (BLCKSZ / (sizeof(uint32) * PG_CHECKSUM_BLOCK_SUMS)); i++)
+	{
+		CHECKSUM_COMP_AVX512(s0, _mm512_loadu_si512((const void *) data));
+		CHECKSUM_COMP_AVX512(s1, _mm512_loadu_si512((const void *) (data + 16)));
+		data += PG_CHECKSUM_BLOCK_SUMS;
+	}
+
+	/* finally add in two rounds of zeroes for additional mixing */
+	for (i = 0; i < 2; i++)
+	{
+		CHECKSUM_COMP_AVX512(s0, zero);
+		CHECKSUM_COMP_AVX512(s1, zero);
+	}
+
+	/* xor fold partial checksums together */
+	_mm512_storeu_si512((void *) lanes, _mm512_xor_si512(s0, s1));
+	for (i = 0; i < 16; i++)
+		result ^= lanes[i];
+
+	return result;
+}
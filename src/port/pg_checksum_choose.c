@@ -0,0 +1,38 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_checksum_choose.c
+ *	  Choose between the vectorized data page checksum implementations.
+ *
+ * Called once by pg_checksum_block() in storage/checksum_impl.h. If the CPU
+ * supports AVX-512, use that implementation, else if it supports AVX2 use
+ * that one. Otherwise, the caller falls back to the plain C implementation,
+ * which the compiler may have vectorized for the targeted instruction set.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *	  src/port/pg_checksum_choose.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "c.h"
+
+#include "port/pg_checksum_block.h"
+#include "port/pg_cpu_x86.h"
+
+pg_checksum_block_fn
+pg_checksum_block_choose(void)
+{
+#ifdef USE_AVX512_CHECKSUM_WITH_RUNTIME_CHECK
+	if (pg_cpu_x86_have_avx512f())
+		return pg_checksum_block_avx512;
+#endif
+#ifdef USE_AVX2_CHECKSUM_WITH_RUNTIME_CHECK
+	if (pg_cpu_x86_have_avx2())
+		return pg_checksum_block_avx2;
+#endif
+	return NULL;
+}
@@ -0,0 +1,92 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_crc32c_avx512.c
+ *	  Compute CRC-32C checksum using AVX-512 and VPCLMULQDQ instructions.
+ *
+ * The SSE 4.2 CRC32 instruction has a latency of three cycles, and each
+ * step depends on the previous one, so it can process at most eight bytes
+ * every three cycles. For large inputs, we instead fold 64-byte chunks into
+ * a 512-bit accumulator with carry-less multiplication, which has no such
+ * serial dependency, and only reduce the accumulator to a CRC at the end,
+ * using the CRC32 instruction. Whatever is left over after the last full
+ * chunk is processed by the SSE 4.2 implementation.
+ *
+ * The folding constants are powers of x modulo the (bit-reflected) CRC-32C
+ * polynomial, see "Fast CRC Computation for Generic Polynomials Using
+ * PCLMULQDQ Instruction", Intel, 2009.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *	  src/port/pg_crc32c_avx512.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "c.h"
+
+#include <immintrin.h>
+
+#include "port/pg_crc32c.h"
+
+#define clmul_lo(a, b) (_mm512_clmulepi64_epi128((a), (b), 0))
+#define clmul_hi(a, b) (_mm512_clmulepi64_epi128((a), (b), 17))
+
+pg_crc32c
+pg_comp_crc32c_avx512(pg_crc32c crc, const void *data, size_t len)
+{
+	const char *buf = data;
+
+	if (len >= 64)
+	{
+		const char *end = buf + len;
+		const char *limit = buf + len - 64;
+		__m512i		x0,
+					y0,
+					k;
+		__m128i		z0;
+
+		/*
+		 * Fold the initial CRC into the first chunk.  The upper lanes must be
+		 * zero, which _mm512_castsi128_si512() doesn't guarantee.
+		 */
+		x0 = _mm512_loadu_si512((const void *) buf);
+		x0 = _mm512_xor_si512(_mm512_zextsi128_si512(_mm_cvtsi32_si128(crc)), x0);
+		buf += 64;
+
+		/* fold each following chunk into the accumulator: x^(512+-64) */
+		k = _mm512_broadcast_i32x4(_mm_setr_epi32(0x740eef02, 0, 0x9e4addf8, 0));
+		while (buf <= limit)
+		{
+			y0 = clmul_lo(x0, k);
+			x0 = clmul_hi(x0, k);
+			x0 = _mm512_ternarylogic_epi64(x0, y0,
+										   _mm512_loadu_si512((const void *) buf),
+										   0x96);
+			buf += 64;
+		}
+
+		/* reduce the four 128-bit lanes to one */
+		k = _mm512_setr_epi32(0x1c291d04, 0, 0xddc0152b, 0,
+							  0x3da6d0cb, 0, 0xba4fc28e, 0,
+							  0xf20c0dfe, 0, 0x493c7d27, 0,
+							  0, 0, 0, 0);
+		y0 = clmul_lo(x0, k);
+		k = clmul_hi(x0, k);
+		y0 = _mm512_xor_si512(y0, k);
+		z0 = _mm_ternarylogic_epi64(_mm512_castsi512_si128(y0),
+									_mm512_extracti32x4_epi32(y0, 1),
+									_mm512_extracti32x4_epi32(y0, 2),
+									0x96);
+		z0 = _mm_xor_si128(z0, _mm512_extracti32x4_epi32(x0, 3));
+
+		/* and reduce the remaining 128 bits to a CRC */
+		crc = (uint32) _mm_crc32_u64(0, _mm_extract_epi64(z0, 0));
+		crc = (uint32) _mm_crc32_u64(crc, _mm_extract_epi64(z0, 1));
+
+		len = end - buf;
+	}
+
+	return pg_comp_crc32c_sse42(crc, buf, len);
+}
@@ -5,8 +5,9 @@
  *
  * On first call, checks if the CPU we're running on supports Intel SSE
  * 4.2. If it does, use the special SSE instructions for CRC-32C
- * computation. Otherwise, fall back to the pure software implementation
- * (slicing-by-8).
+ * computation, or the AVX-512 implementation built on them if the CPU
+ * supports that as well. Otherwise, fall back to the pure software
+ * implementation (slicing-by-8).
  *
  * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
  * Portions Copyright (c) 1994, Regents of the University of California
@@ -29,6 +30,9 @@
 #endif
 
 #include "port/pg_crc32c.h"
+#ifdef USE_AVX512_CRC32C_WITH_RUNTIME_CHECK
+#include "port/pg_cpu_x86.h"
+#endif
 
 static bool
 pg_crc32c_sse42_available(void)
@@ -54,7 +58,13 @@ static pg_crc32c
 pg_comp_crc32c_choose(pg_crc32c crc, const void *data, size_t len)
 {
 	if (pg_crc32c_sse42_available())
+	{
 		pg_comp_crc32c = pg_comp_crc32c_sse42;
+#ifdef USE_AVX512_CRC32C_WITH_RUNTIME_CHECK
+		if (pg_cpu_x86_have_avx512_vpclmulqdq())
+			pg_comp_crc32c = pg_comp_crc32c_avx512;
+#endif
+	}
 	else
 		pg_comp_crc32c = pg_comp_crc32c_sb8;
 
@@ -0,0 +1,97 @@
+# Run the main regression tests with each asynchronous I/O method
+
+use strict;
+use warnings;
+use Cwd qw(abs_path);
+use File::Basename;
+use PostgresNode;
+use TestLib;
+use Test::More tests => 4;
+
+# The regression test sources live next to this module in the source tree,
+# while regress.so is found in the build tree.
+my $dlpath   = dirname($ENV{REGRESS_SHLIB});
+my $inputdir = abs_path(dirname(__FILE__) . "/../../../regress");
+my $schedule = "$inputdir/parallel_schedule";
+
+# Run the regression tests against a node, returning pg_regress's exit code
+sub run_regression
+{
+	my ($node, $outputdir) = @_;
+
+	my $rc = system($ENV{PG_REGRESS}
+		  . " --dlpath=\"$dlpath\""
+		  . " --bindir="
+		  . " --host="
+		  . $node->host
+		  . " --port="
+		  . $node->port
+		  . " --schedule=$schedule"
+		  . " --max-concurrent-tests=20"
+		  . " --inputdir=$inputdir"
+		  . " --outputdir=\"$outputdir\"");
+	if ($rc != 0)
+	{
+		# Dump out the regression diffs file, if there is one
+		my $diffs = "$outputdir/regression.diffs";
+		if (-e $diffs)
+		{
+			print "=== dumping $diffs ===\n";
+			print slurp_file($diffs);
+			print "=== EOF ===\n";
+		}
+	}
+	return $rc;
+}
+
+# io_uring is only accepted if the server was built with it
+my $probe = get_new_node('probe');
+$probe->init;
+$probe->start;
+my $have_io_uring = $probe->safe_psql('postgres',
+	"SELECT 'io_uring' = ANY (enumvals) FROM pg_settings WHERE name = 'io_method'"
+);
+$probe->stop;
+
+foreach my $method ('worker', 'io_uring')
+{
+  SKIP:
+	{
+		skip "io_uring not supported by this build", 2
+		  if ($method eq 'io_uring' && $have_io_uring ne 't');
+
+		my $node = get_new_node("io_$method");
+		$node->init;
+		$node->append_conf('postgresql.conf', "io_method = $method");
+		$node->append_conf('postgresql.conf', "io_workers = 3")
+		  if $method eq 'worker';
+
+		# The kernel may not let us create rings even if we were built
+		# with io_uring support (too old, or disabled by a sandbox)
+		if (!$node->start(fail_ok => 1))
+		{
+			my $log = slurp_file($node->logfile);
+			skip "io_uring not usable on this system", 2
+			  if ($method eq 'io_uring'
+				&& $log =~ /could not create io_uring/);
+			BAIL_OUT("could not start node with io_method = $method");
+		}
+
+		is($node->safe_psql('postgres', 'SHOW io_method'),
+			$method, "io_method is $method");
+
+		# Send the outputs to a private directory, laid out the way the
+		# makefile sets up src/test/regress: pg_regress writes the converted
+		# .source files into sql/ and expected/, and only creates the
+		# tablespace test's directory itself on Windows.
+		my $outputdir = "$TestLib::tmp_check/regress_$method";
+		mkdir $outputdir;
+		mkdir "$outputdir/sql";
+		mkdir "$outputdir/expected";
+		mkdir "$outputdir/testtablespace";
+		is(run_regression($node, $outputdir),
+			0, "regression tests pass with io_method = $method");
+
+		$node->stop;
+	}
+}
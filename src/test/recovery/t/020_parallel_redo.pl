@@ -0,0 +1,103 @@
+# Test parallel redo, in standby replay and in crash recovery
+use strict;
+use warnings;
+use PostgresNode;
+use TestLib;
+use Test::More tests => 4;
+
+# Initialize primary node
+my $node_primary = get_new_node('primary');
+$node_primary->init(allows_streaming => 1);
+$node_primary->append_conf('postgresql.conf', 'max_parallel_redo_workers = 4');
+$node_primary->start;
+
+my $backup_name = 'my_backup';
+$node_primary->backup($backup_name);
+
+# Create a standby.  Parallel redo is only used with hot standby disabled.
+my $node_standby = get_new_node('standby');
+$node_standby->init_from_backup($node_primary, $backup_name,
+	has_streaming => 1);
+$node_standby->append_conf(
+	'postgresql.conf', qq(
+hot_standby = off
+max_parallel_redo_workers = 4
+));
+$node_standby->start;
+
+# A workload touching the heap and btree indexes, with DDL and with
+# relations truncated both by TRUNCATE and by VACUUM.
+$node_primary->safe_psql(
+	'postgres', q{
+CREATE TABLE heap_t (id int PRIMARY KEY, val text, n int);
+INSERT INTO heap_t SELECT g, md5(g::text), g % 100
+  FROM generate_series(1, 20000) g;
+CREATE INDEX heap_t_val ON heap_t (val);
+UPDATE heap_t SET n = n + 1 WHERE id % 3 = 0;
+DELETE FROM heap_t WHERE id % 7 = 0;
+INSERT INTO heap_t SELECT g, md5(g::text), 0
+  FROM generate_series(20001, 25000) g;
+ALTER TABLE heap_t ADD COLUMN extra int DEFAULT 42;
+UPDATE heap_t SET extra = id WHERE id % 5 = 0;
+CREATE TABLE ddl_t AS SELECT g AS id FROM generate_series(1, 1000) g;
+ALTER TABLE ddl_t RENAME TO ddl_renamed;
+CREATE TABLE dropped_t (id int);
+INSERT INTO dropped_t SELECT generate_series(1, 1000);
+DROP TABLE dropped_t;
+CREATE TABLE trunc_t (id int);
+INSERT INTO trunc_t SELECT generate_series(1, 5000);
+TRUNCATE trunc_t;
+INSERT INTO trunc_t SELECT generate_series(1, 100);
+CREATE TABLE vac_t (id int) WITH (autovacuum_enabled = off);
+INSERT INTO vac_t SELECT generate_series(1, 10000);
+DELETE FROM vac_t WHERE id > 1000;
+VACUUM vac_t;
+BEGIN;
+INSERT INTO ddl_renamed SELECT generate_series(1001, 2000);
+ROLLBACK;
+});
+
+# Compare the contents of the tables, using the indexes as well as the heap.
+my $check_sql = q{
+SELECT count(*), sum(id), sum(n), sum(extra),
+       md5(string_agg(val, ',' ORDER BY id)) FROM heap_t;
+SELECT count(*), sum(id) FROM ddl_renamed;
+SELECT count(*), sum(id) FROM trunc_t;
+SELECT count(*), sum(id), pg_relation_size('vac_t') FROM vac_t;
+SELECT to_regclass('dropped_t') IS NULL;
+SET enable_seqscan = off;
+SET enable_bitmapscan = off;
+SELECT count(*), md5(string_agg(val, ',' ORDER BY val)) FROM heap_t
+  WHERE val >= '8';
+SELECT count(*), sum(n) FROM heap_t WHERE id BETWEEN 100 AND 15000;
+};
+
+my $expected = $node_primary->safe_psql('postgres', $check_sql);
+
+# Check the standby, after it has replayed everything
+$node_primary->wait_for_catchup($node_standby, 'replay',
+	$node_primary->lsn('insert'));
+like(
+	slurp_file($node_standby->logfile),
+	qr/using 4 parallel redo workers/,
+	'standby replays WAL with parallel redo');
+
+$node_standby->promote;
+$node_standby->poll_query_until('postgres',
+	'SELECT NOT pg_is_in_recovery()')
+  or die "Timed out while waiting for promotion";
+is($node_standby->safe_psql('postgres', $check_sql),
+	$expected, 'standby matches primary after parallel redo');
+
+# Crash the primary.  Its last checkpoint is the one of the base backup,
+# which was taken before the workload, so recovery replays all of it.
+my $log_offset = -s $node_primary->logfile;
+$node_primary->stop('immediate');
+$node_primary->start;
+
+like(
+	substr(slurp_file($node_primary->logfile), $log_offset),
+	qr/using 4 parallel redo workers/,
+	'crash recovery uses parallel redo');
+is($node_primary->safe_psql('postgres', $check_sql),
+	$expected, 'primary matches after crash recovery with parallel redo');
@@ -0,0 +1,79 @@
+# Test WAL compression of full-page images and of record payloads, with
+# each compression method, through replay on a standby and pg_waldump.
+use strict;
+use warnings;
+use PostgresNode;
+use TestLib;
+use Test::More tests => 12;
+
+my $node_primary = get_new_node('primary');
+$node_primary->init(allows_streaming => 1);
+$node_primary->start;
+
+my $backup_name = 'my_backup';
+$node_primary->backup($backup_name);
+
+my $node_standby = get_new_node('standby');
+$node_standby->init_from_backup($node_primary, $backup_name,
+	has_streaming => 1);
+$node_standby->start;
+
+my %built = (
+	pglz => 1,
+	lz4  => check_pg_config("#define USE_LZ4 1"),
+	zstd => check_pg_config("#define USE_ZSTD 1"));
+
+foreach my $method ('pglz', 'lz4', 'zstd')
+{
+  SKIP:
+	{
+		skip "$method not supported by this build", 4 unless $built{$method};
+
+		my $start_lsn = $node_primary->lsn('insert');
+		my $start_seg = $node_primary->safe_psql('postgres',
+			"SELECT pg_walfile_name('$start_lsn')");
+
+		# The inserts write compressed payloads.  The updates after the
+		# checkpoint write compressed full-page images.
+		$node_primary->safe_psql(
+			'postgres', qq{
+SET wal_compression = $method;
+SET wal_record_compression_threshold = 32;
+CREATE TABLE t_$method (id int PRIMARY KEY, val text);
+INSERT INTO t_$method SELECT g, repeat('abc', 100) || g
+  FROM generate_series(1, 1000) g;
+CHECKPOINT;
+UPDATE t_$method SET val = val || 'x' WHERE id % 10 = 0;
+});
+
+		my $end_lsn = $node_primary->lsn('insert');
+		my $check_sql =
+		  "SELECT count(*), md5(string_agg(val, ',' ORDER BY id)) FROM t_$method";
+		my $expected = $node_primary->safe_psql('postgres', $check_sql);
+
+		$node_primary->wait_for_catchup($node_standby, 'replay', $end_lsn);
+		is($node_standby->safe_psql('postgres', $check_sql),
+			$expected, "standby replays WAL compressed with $method");
+
+		# Passing the start segment keeps pg_waldump from reading the
+		# segment size off a zero-filled, preallocated file
+		my ($stdout, $stderr);
+		my $result = IPC::Run::run [
+			'pg_waldump', '--bkp-details',
+			'--path',     $node_primary->data_dir . '/pg_wal',
+			'--start',    $start_lsn,
+			'--end',      $end_lsn,
+			$start_seg
+		  ],
+		  '>', \$stdout, '2>', \$stderr;
+		ok($result, "pg_waldump reads WAL compressed with $method");
+		like(
+			$stdout,
+			qr/compression saved: \d+, method: $method/,
+			"pg_waldump shows full-page images compressed with $method");
+		like(
+			$stdout,
+			qr/compressed payload: \d+\/\d+/,
+			"pg_waldump shows payloads compressed with $method");
+	}
+}
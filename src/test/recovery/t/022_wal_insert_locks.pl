@@ -0,0 +1,74 @@
+# Test concurrent WAL insertion with more than the default number of WAL
+# insertion locks, through replay on a standby, crash recovery and
+# pg_waldump, all of which check the records' prev-links.
+use strict;
+use warnings;
+use PostgresNode;
+use TestLib;
+use Test::More tests => 6;
+
+my $node_primary = get_new_node('primary');
+$node_primary->init(allows_streaming => 1);
+$node_primary->append_conf(
+	'postgresql.conf', qq{
+wal_insert_locks = 32
+max_connections = 40
+});
+$node_primary->start;
+
+is($node_primary->safe_psql('postgres', 'SHOW wal_insert_locks'),
+	'32', 'wal_insert_locks is set');
+
+my $backup_name = 'my_backup';
+$node_primary->backup($backup_name);
+
+my $node_standby = get_new_node('standby');
+$node_standby->init_from_backup($node_primary, $backup_name,
+	has_streaming => 1);
+$node_standby->start;
+
+$node_primary->safe_psql('postgres',
+	'CREATE TABLE t (id bigserial PRIMARY KEY, val text)');
+
+my $start_lsn = $node_primary->lsn('insert');
+my $start_seg = $node_primary->safe_psql('postgres',
+	"SELECT pg_walfile_name('$start_lsn')");
+
+# Many small inserts of varying sizes from many clients at once, so that
+# records often cross page boundaries while other backends insert.
+my $script = $node_primary->basedir . '/insert.sql';
+TestLib::append_to_file($script,
+	"INSERT INTO t (val) SELECT repeat('x', (random() * 300)::int) FROM generate_series(1, 5);\n"
+);
+
+$node_primary->command_ok(
+	[
+		'pgbench', '-n',  '-c', '24',    '-j', '4',
+		'-t',      '300', '-f', $script, 'postgres'
+	],
+	'concurrent inserts with 32 WAL insertion locks');
+
+my $end_lsn = $node_primary->lsn('insert');
+my $check_sql = "SELECT count(*), sum(length(val)) FROM t";
+my $expected  = $node_primary->safe_psql('postgres', $check_sql);
+like($expected, qr/^36000\|/, 'all inserts are visible');
+
+$node_primary->wait_for_catchup($node_standby, 'replay', $end_lsn);
+is($node_standby->safe_psql('postgres', $check_sql),
+	$expected, 'standby replays concurrently inserted WAL');
+
+# Name the first segment, rather than let pg_waldump pick any file from
+# pg_wal to learn the segment size; preallocated ones are still all zeroes.
+my ($stdout, $stderr);
+my $result = IPC::Run::run [
+	'pg_waldump', '--path', $node_primary->data_dir . '/pg_wal',
+	'--start', $start_lsn, '--end', $end_lsn, $start_seg
+  ],
+  '>', \$stdout, '2>', \$stderr;
+ok($result, 'pg_waldump reads concurrently inserted WAL');
+
+# Crash recovery replays the same WAL from the last checkpoint
+$node_primary->stop('immediate');
+$node_primary->start;
+is($node_primary->safe_psql('postgres', $check_sql),
+	$expected, 'crash recovery replays concurrently inserted WAL');
@@ -0,0 +1,104 @@
+--
+-- Sequential scans in batch mode (executor_batch_size)
+--
+
+CREATE TABLE batch_tbl (i2 int2, i4 int4, i8 int8, f4 float4, f8 float8,
+                        d date, o oid, t text);
+INSERT INTO batch_tbl
+  SELECT g % 100, g, g * 1000000000::int8, g / 4.0,
+         CASE WHEN g % 500 = 0 THEN 'NaN' ELSE g / 8.0 END,
+         '2000-01-01'::date + g, g, 'row ' || g
+  FROM generate_series(1, 5000) g;
+INSERT INTO batch_tbl DEFAULT VALUES;
+
+-- each of these counts must come out the same whatever the batch size
+CREATE VIEW batch_counts AS SELECT
+  (SELECT count(*) FROM batch_tbl WHERE i4 > 4990) AS c1,
+  (SELECT count(*) FROM batch_tbl WHERE i2 = 7) AS c2,
+  (SELECT count(*) FROM batch_tbl WHERE i8 >= 4999000000000) AS c3,
+  (SELECT count(*) FROM batch_tbl WHERE f4 < 2) AS c4,
+  (SELECT count(*) FROM batch_tbl WHERE f8 > 600) AS c5,
+  (SELECT count(*) FROM batch_tbl WHERE f8 = 'NaN') AS c6,
+  (SELECT count(*) FROM batch_tbl WHERE d BETWEEN '2000-02-01' AND '2000-02-10') AS c7,
+  (SELECT count(*) FROM batch_tbl WHERE o < 10) AS c8,
+  (SELECT count(*) FROM batch_tbl WHERE i4 IS NULL) AS c9,
+  (SELECT count(*) FROM batch_tbl WHERE i4 IS NOT NULL AND i2 < 1) AS c10,
+  (SELECT count(*) FROM batch_tbl WHERE 100 < i4 AND i4 <= 110 AND t LIKE '%5') AS c11,
+  (SELECT count(*) FROM batch_tbl WHERE i4 < 3::int8) AS c12,
+  (SELECT count(*) FROM batch_tbl WHERE i2 > 98) AS c13,
+  (SELECT count(*) FROM batch_tbl WHERE f4 >= 1249.5::float8) AS c14,
+  (SELECT count(*) FROM batch_tbl WHERE i4 > NULL::int4) AS c15;
+
+SELECT * FROM batch_counts;
+SELECT i4, t FROM batch_tbl WHERE i4 % 1000 = 0 AND i4 > 2000;
+SELECT i4 FROM batch_tbl WHERE i4 > 10 LIMIT 3;
+-- rows filtered out before the limit is reached are counted exactly
+EXPLAIN (ANALYZE, COSTS OFF, TIMING OFF, SUMMARY OFF)
+SELECT * FROM batch_tbl WHERE i4 > 10 AND i4 % 2 = 0 LIMIT 3;
+
+SET executor_batch_size = 7;
+SELECT * FROM batch_counts;
+SELECT i4, t FROM batch_tbl WHERE i4 % 1000 = 0 AND i4 > 2000;
+
+SET executor_batch_size = 0;
+SELECT * FROM batch_counts;
+
+RESET executor_batch_size;
+
+-- WHERE CURRENT OF must find the row a batch-mode scan is positioned on
+BEGIN;
+DECLARE c NO SCROLL CURSOR FOR SELECT i4 FROM batch_tbl WHERE i4 > 4997;
+FETCH c;
+UPDATE batch_tbl SET t = 'updated' WHERE CURRENT OF c;
+FETCH c;
+COMMIT;
+SELECT i4, t FROM batch_tbl WHERE t = 'updated';
+
+-- plain aggregates over a scan consume its batches directly
+CREATE VIEW batch_aggs AS SELECT
+  count(*) AS n, count(f8) AS nf8, sum(i2) AS s2, sum(i4) AS s4,
+  min(i2) AS mn2, max(i8) AS mx8, min(o) AS mno,
+  max(d) - '2000-01-01'::date AS mxd, min(f4) AS mnf4, max(f8) AS mxf8
+FROM batch_tbl WHERE i4 > 100;
+CREATE VIEW batch_aggs_f8 AS SELECT
+  count(*) AS n, sum(f8) AS sf8, max(f8) AS mxf8, min(i8) AS mn8,
+  max(f4) AS mxf4, max(i4) AS mx4
+FROM batch_tbl WHERE f8 < 100;
+SELECT * FROM batch_aggs;
+SELECT * FROM batch_aggs_f8;
+SELECT count(*), count(i4), sum(i2), min(i4), max(i4), min(f8) FROM batch_tbl;
+SELECT count(*), sum(i4), min(f8) FROM batch_tbl WHERE i4 > 10000;
+-- rescans
+SELECT g, s.* FROM generate_series(1, 2) g,
+  LATERAL (SELECT count(*), max(i4) + g AS m FROM batch_tbl WHERE i2 = 7) s;
+EXPLAIN (ANALYZE, COSTS OFF, TIMING OFF, SUMMARY OFF)
+SELECT count(*), sum(i4) FROM batch_tbl WHERE i4 > 10;
+SET executor_batch_size = 7;
+SELECT * FROM batch_aggs;
+SELECT * FROM batch_aggs_f8;
+SET executor_batch_size = 0;
+SELECT * FROM batch_aggs;
+SELECT * FROM batch_aggs_f8;
+RESET executor_batch_size;
+
+-- a Result node with a one-time filter passes the batches on
+CREATE VIEW batch_gated AS SELECT count(*) AS n, sum(i4) AS s4, max(i8) AS mx8
+FROM batch_tbl WHERE i4 > 100 AND now() IS NOT NULL;
+-- hash tables are built from batches of rows
+CREATE VIEW batch_join AS SELECT count(*) AS n, sum(a.i4) AS s4, min(b.t) AS mnt
+FROM batch_tbl a JOIN batch_tbl b ON a.i4 = b.i8 / 1000000000 WHERE b.i2 = 7;
+EXPLAIN (COSTS OFF) SELECT * FROM batch_gated;
+SELECT * FROM batch_gated;
+SELECT * FROM batch_join;
+SELECT count(*) FROM batch_tbl WHERE i4 > 100 AND now() IS NULL;
+SET executor_batch_size = 7;
+SELECT * FROM batch_gated;
+SELECT * FROM batch_join;
+SET executor_batch_size = 0;
+SELECT * FROM batch_gated;
+SELECT * FROM batch_join;
+RESET executor_batch_size;
+
+DROP VIEW batch_aggs, batch_aggs_f8, batch_gated, batch_join;
+DROP VIEW batch_counts;
+DROP TABLE batch_tbl;
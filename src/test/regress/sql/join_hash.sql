@@ -467,6 +467,64 @@ $$
 $$);
 rollback to settings;
 
+-- A runtime filter lets the scan of the outer relation discard the rows
+-- whose keys don't occur in the inner relation.  The first outer row may be
+-- fetched before the hash table is built, so make sure it has a match.
+savepoint settings;
+set local max_parallel_workers_per_gather = 0;
+set local enable_mergejoin = off;
+set local enable_nestloop = off;
+set local work_mem = '8MB';
+create table rf_fact as select i % 100 as k from generate_series(1, 1000) i;
+create table rf_dim as select * from (values (1), (50), (99)) v(id);
+analyze rf_fact;
+analyze rf_dim;
+create function explain_runtime_filter(query text) returns setof text
+language plpgsql as
+$$
+declare
+    ln text;
+begin
+    for ln in
+        execute format('explain (analyze, costs off, summary off, timing off) %s',
+            query)
+    loop
+        ln := regexp_replace(ln, 'Memory Usage: \d+', 'Memory Usage: N');
+        return next ln;
+    end loop;
+end;
+$$;
+select explain_runtime_filter('
+  select count(*) from rf_fact f join rf_dim d on f.k = d.id');
+select count(*) from rf_fact f join rf_dim d on f.k = d.id;
+-- no filter for a left join
+select count(*) from rf_fact f left join rf_dim d on f.k = d.id;
+-- with too little memory for a Bloom filter, just the range of the inner
+-- keys is checked
+set local work_mem = '1MB';
+select explain_runtime_filter('
+  select count(*) from rf_fact f join rf_dim d on f.k = d.id');
+rollback to settings;
+
+-- Bucket tags, in a single-batch join and in one whose number of batches
+-- grows while the hash table is built, which rebuilds the tags.  The left
+-- join checks that outer rows skipped by the tags still come out.
+savepoint settings;
+set local max_parallel_workers_per_gather = 0;
+set local hash_join_bucket_tags = on;
+set local work_mem = '4MB';
+select count(*) from simple r join simple s using (id);
+select count(*) from simple r left join simple s on r.id = s.id + 10000
+  where s.id is null;
+set local work_mem = '128kB';
+select count(*) from simple r join bigger_than_it_looks s using (id);
+select original > 1 as initially_multibatch, final > original as increased_batches
+  from hash_join_batches(
+$$
+  select count(*) from simple r join bigger_than_it_looks s using (id);
+$$);
+rollback to settings;
+
 rollback;
 
 
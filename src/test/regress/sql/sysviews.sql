@@ -32,6 +32,15 @@ select count(*) = 0 as ok from pg_prepared_statements;
 -- See also prepared_xacts.sql
 select count(*) >= 0 as ok from pg_prepared_xacts;
 
+-- One row for each backend type that does I/O and each I/O context
+select count(*) = 40 as ok from pg_stat_io;
+
+-- Exactly one row, whether or not we are in recovery
+select count(*) = 1 as ok from pg_stat_recovery_prefetch;
+
+-- Every group flush satisfies at least its leader's request
+select members >= groups as ok from pg_stat_wal_flush;
+
 -- This is to record the prevailing planner enable_foo settings during
 -- a regression test run.
 select name, setting from pg_settings where name like 'enable%';
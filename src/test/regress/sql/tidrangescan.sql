@@ -0,0 +1,87 @@
+-- tests for tidrangescans
+
+SET enable_seqscan TO off;
+CREATE TABLE tidrangescan(id integer, data text);
+
+-- empty table
+EXPLAIN (COSTS OFF)
+SELECT ctid FROM tidrangescan WHERE ctid < '(1, 0)';
+SELECT ctid FROM tidrangescan WHERE ctid < '(1, 0)';
+
+EXPLAIN (COSTS OFF)
+SELECT ctid FROM tidrangescan WHERE ctid > '(9, 0)';
+SELECT ctid FROM tidrangescan WHERE ctid > '(9, 0)';
+
+-- insert enough tuples to fill at least three pages
+INSERT INTO tidrangescan SELECT i, repeat('x', 100) FROM generate_series(1,200) AS s(i);
+
+-- remove all tuples after the 10th tuple on each page, and all pages after
+-- the third, so that we get the same layout regardless of the page size
+DELETE FROM tidrangescan
+WHERE substring(ctid::text FROM ',(\d+)\)')::integer > 10
+   OR substring(ctid::text FROM '\((\d+),')::integer > 2;
+VACUUM tidrangescan;
+
+SELECT count(*) FROM tidrangescan;
+
+-- range scans with an upper bound
+EXPLAIN (COSTS OFF)
+SELECT ctid FROM tidrangescan WHERE ctid < '(1,0)';
+SELECT ctid FROM tidrangescan WHERE ctid < '(1,0)';
+
+EXPLAIN (COSTS OFF)
+SELECT ctid FROM tidrangescan WHERE ctid <= '(1,5)';
+SELECT ctid FROM tidrangescan WHERE ctid <= '(1,5)';
+
+-- range scans with a lower bound
+EXPLAIN (COSTS OFF)
+SELECT ctid FROM tidrangescan WHERE ctid > '(2,8)';
+SELECT ctid FROM tidrangescan WHERE ctid > '(2,8)';
+
+EXPLAIN (COSTS OFF)
+SELECT ctid FROM tidrangescan WHERE '(2,8)' <= ctid;
+SELECT ctid FROM tidrangescan WHERE '(2,8)' <= ctid;
+
+-- range scans with both bounds
+EXPLAIN (COSTS OFF)
+SELECT ctid FROM tidrangescan WHERE ctid > '(1,9)' AND '(2,2)' > ctid;
+SELECT ctid FROM tidrangescan WHERE ctid > '(1,9)' AND '(2,2)' > ctid;
+
+EXPLAIN (COSTS OFF)
+SELECT ctid FROM tidrangescan WHERE ctid >= '(1,0)' AND ctid < '(2,0)' AND ctid > '(1,7)';
+SELECT ctid FROM tidrangescan WHERE ctid >= '(1,0)' AND ctid < '(2,0)' AND ctid > '(1,7)';
+
+-- empty ranges
+SELECT ctid FROM tidrangescan WHERE ctid > '(2,1)' AND ctid < '(1,0)';
+SELECT ctid FROM tidrangescan WHERE ctid > '(9,0)';
+SELECT ctid FROM tidrangescan WHERE ctid < '(0,0)';
+
+-- other quals are applied as a filter
+EXPLAIN (COSTS OFF)
+SELECT ctid FROM tidrangescan WHERE ctid < '(1,0)' AND id % 2 = 0 AND id < 5;
+SELECT ctid FROM tidrangescan WHERE ctid < '(1,0)' AND id % 2 = 0 AND id < 5;
+
+-- tid range scan with a parameter, rescanned for each outer row
+EXPLAIN (COSTS OFF)
+SELECT t.ctid, t2.c FROM tidrangescan t,
+LATERAL (SELECT count(*) c FROM tidrangescan t2 WHERE t2.ctid <= t.ctid) t2
+WHERE t.ctid < '(1,0)';
+SELECT t.ctid, t2.c FROM tidrangescan t,
+LATERAL (SELECT count(*) c FROM tidrangescan t2 WHERE t2.ctid <= t.ctid) t2
+WHERE t.ctid < '(1,0)';
+
+-- cursors, including scanning backwards
+BEGIN;
+DECLARE c SCROLL CURSOR FOR
+SELECT ctid FROM tidrangescan WHERE ctid >= '(1,5)' AND ctid < '(2,0)';
+FETCH NEXT c;
+FETCH NEXT c;
+FETCH PRIOR c;
+FETCH FIRST c;
+FETCH PRIOR c;
+FETCH LAST c;
+FETCH BACKWARD 2 c;
+COMMIT;
+
+DROP TABLE tidrangescan;
+RESET enable_seqscan;
@@ -0,0 +1,349 @@
+/*
+ * src/tools/checksum_bench/checksum_bench.c
+ *
+ *
+ *	checksum_bench.c
+ *		verify and benchmark the CRC-32C and data page checksum
+ *		implementations
+ */
+
+#include "postgres_fe.h"
+
+#include "port/pg_crc32c.h"
+#include "portability/instr_time.h"
+#include "storage/checksum.h"
+#include "storage/checksum_impl.h"
+
+#if defined(HAVE__GET_CPUID_COUNT) || defined(HAVE__CPUIDEX)
+#include "port/pg_cpu_x86.h"
+#endif
+
+/* largest CRC-32C input */
+#define MAX_CRC_LEN		65536
+/* number of pages to checksum, so that they don't all stay in L1 cache */
+#define NUM_PAGES		16
+
+typedef pg_crc32c (*crc_fn) (pg_crc32c crc, const void *data, size_t len);
+typedef uint32 (*checksum_fn) (const uint32 *data, const uint32 *base_offsets);
+
+typedef struct
+{
+	const char *name;
+	bool		available;
+	crc_fn		fn;
+} CrcImpl;
+
+typedef struct
+{
+	const char *name;
+	bool		available;
+	checksum_fn fn;
+} ChecksumImpl;
+
+static pg_crc32c comp_crc32c_default(pg_crc32c crc, const void *data, size_t len);
+static uint32 checksum_block_c(const uint32 *data, const uint32 *base_offsets);
+static uint32 checksum_block_default(const uint32 *data, const uint32 *base_offsets);
+
+static const size_t crc_lengths[] = {8, 64, 512, BLCKSZ, MAX_CRC_LEN};
+
+static char *crc_buf;
+static PGAlignedBlock *pages;
+static double seconds = 1.0;
+
+/*
+ * Can this CPU run the SSE 4.2 implementation? If we can't tell, only the
+ * default implementation is tested.
+ */
+static bool
+cpu_has_sse42(void)
+{
+#if defined(USE_SSE42_CRC32C)
+	return true;
+#elif defined(HAVE__GET_CPUID_COUNT) || defined(HAVE__CPUIDEX)
+	unsigned int exx[4];
+
+	pg_cpuid_count(1, 0, exx);
+	return (exx[2] & (1 << 20)) != 0;	/* SSE 4.2 */
+#else
+	return false;
+#endif
+}
+
+/* COMP_CRC32C, as chosen by the build and at runtime */
+static pg_crc32c
+comp_crc32c_default(pg_crc32c crc, const void *data, size_t len)
+{
+	COMP_CRC32C(crc, data, len);
+	return crc;
+}
+
+/* The plain C algorithm of pg_checksum_block, never explicitly vectorized */
+static uint32
+checksum_block_c(const uint32 *data, const uint32 *base_offsets)
+{
+	uint32		sums[N_SUMS];
+	uint32		result = 0;
+	uint32		i,
+				j;
+
+	memcpy(sums, base_offsets, sizeof(sums));
+	for (i = 0; i < (uint32) (BLCKSZ / (sizeof(uint32) * N_SUMS)); i++)
+		for (j = 0; j < N_SUMS; j++)
+			CHECKSUM_COMP(sums[j], data[i * N_SUMS + j]);
+	for (i = 0; i < 2; i++)
+		for (j = 0; j < N_SUMS; j++)
+			CHECKSUM_COMP(sums[j], 0);
+	for (i = 0; i < N_SUMS; i++)
+		result ^= sums[i];
+
+	return result;
+}
+
+/* pg_checksum_block, as chosen by the build and at runtime */
+static uint32
+checksum_block_default(const uint32 *data, const uint32 *base_offsets)
+{
+	return pg_checksum_block((const PGChecksummablePage *) data);
+}
+
+static double
+elapsed_since(instr_time start)
+{
+	instr_time	now;
+
+	INSTR_TIME_SET_CURRENT(now);
+	INSTR_TIME_SUBTRACT(now, start);
+	return INSTR_TIME_GET_DOUBLE(now);
+}
+
+/*
+ * Check that all available CRC-32C implementations agree with the default
+ * one for the given input.
+ */
+static bool
+verify_crc_input(const CrcImpl *impls, int nimpls, const char *data, size_t len)
+{
+	bool		ok = true;
+	pg_crc32c	expected;
+	int			i;
+
+	INIT_CRC32C(expected);
+	expected = comp_crc32c_default(expected, data, len);
+	FIN_CRC32C(expected);
+
+	for (i = 0; i < nimpls; i++)
+	{
+		pg_crc32c	crc;
+
+		if (!impls[i].available)
+			continue;
+
+		INIT_CRC32C(crc);
+		crc = impls[i].fn(crc, data, len);
+		FIN_CRC32C(crc);
+		if (crc != expected)
+		{
+			fprintf(stderr, "CRC-32C mismatch for %s, length %zu, offset %d: %08X, expected %08X\n",
+					impls[i].name, len, (int) (data - crc_buf), crc, expected);
+			ok = false;
+		}
+	}
+
+	return ok;
+}
+
+/*
+ * Check every length up to 1kB at every alignment, and a large input.
+ */
+static bool
+verify_crc(const CrcImpl *impls, int nimpls)
+{
+	bool		ok = true;
+	size_t		len;
+	int			off;
+
+	for (off = 0; off < 8; off++)
+	{
+		for (len = 0; len <= 1024; len++)
+			ok = verify_crc_input(impls, nimpls, crc_buf + off, len) && ok;
+		ok = verify_crc_input(impls, nimpls, crc_buf + off, MAX_CRC_LEN - off) && ok;
+	}
+
+	return ok;
+}
+
+/*
+ * Check that all available page checksum implementations agree with the
+ * plain C one, and that pg_checksum_page() agrees too.
+ */
+static bool
+verify_checksum(const ChecksumImpl *impls, int nimpls)
+{
+	bool		ok = true;
+	int			p;
+	int			i;
+
+	for (p = 0; p < NUM_PAGES; p++)
+	{
+		const uint32 *data = (const uint32 *) pages[p].data;
+		uint32		expected = checksum_block_c(data, checksumBaseOffsets);
+		uint16		expected_page;
+		uint16		page_checksum;
+
+		for (i = 0; i < nimpls; i++)
+		{
+			uint32		sum;
+
+			if (!impls[i].available)
+				continue;
+
+			sum = impls[i].fn(data, checksumBaseOffsets);
+			if (sum != expected)
+			{
+				fprintf(stderr, "page checksum mismatch for %s, page %d: %08X, expected %08X\n",
+						impls[i].name, p, sum, expected);
+				ok = false;
+			}
+		}
+
+		expected_page = (uint16) (((expected ^ (BlockNumber) p) % 65535) + 1);
+		page_checksum = pg_checksum_page(pages[p].data, (BlockNumber) p);
+		if (page_checksum != expected_page)
+		{
+			fprintf(stderr, "pg_checksum_page mismatch, page %d: %04X, expected %04X\n",
+					p, page_checksum, expected_page);
+			ok = false;
+		}
+	}
+
+	return ok;
+}
+
+static void
+bench_crc(const CrcImpl *impl, size_t len)
+{
+	volatile pg_crc32c sink = 0;
+	instr_time	start;
+	uint64		bytes = 0;
+	double		elapsed;
+	int			i;
+
+	INSTR_TIME_SET_CURRENT(start);
+	do
+	{
+		for (i = 0; i < 64; i++)
+		{
+			pg_crc32c	crc;
+
+			INIT_CRC32C(crc);
+			crc = impl->fn(crc, crc_buf, len);
+			FIN_CRC32C(crc);
+			sink ^= crc;
+		}
+		bytes += 64 * len;
+	} while ((elapsed = elapsed_since(start)) < seconds);
+
+	printf("CRC-32C   %-14s %8zu bytes %10.1f MB/s\n",
+		   impl->name, len, bytes / elapsed / 1e6);
+}
+
+static void
+bench_checksum(const ChecksumImpl *impl)
+{
+	volatile uint32 sink = 0;
+	instr_time	start;
+	uint64		bytes = 0;
+	double		elapsed;
+	int			p;
+
+	INSTR_TIME_SET_CURRENT(start);
+	do
+	{
+		for (p = 0; p < NUM_PAGES; p++)
+			sink ^= impl->fn((const uint32 *) pages[p].data, checksumBaseOffsets);
+		bytes += NUM_PAGES * BLCKSZ;
+	} while ((elapsed = elapsed_since(start)) < seconds);
+
+	printf("checksum  %-14s %8d bytes %10.1f MB/s\n",
+		   impl->name, BLCKSZ, bytes / elapsed / 1e6);
+}
+
+int
+main(int argc, char *argv[])
+{
+	CrcImpl		crc_impls[] = {
+		{"default", true, comp_crc32c_default},
+#if defined(USE_SSE42_CRC32C_WITH_RUNTIME_CHECK) || defined(USE_ARMV8_CRC32C_WITH_RUNTIME_CHECK) || defined(USE_SLICING_BY_8_CRC32C)
+		{"slicing-by-8", true, pg_comp_crc32c_sb8},
+#endif
+#if defined(USE_SSE42_CRC32C) || defined(USE_SSE42_CRC32C_WITH_RUNTIME_CHECK)
+		{"SSE 4.2", cpu_has_sse42(), pg_comp_crc32c_sse42},
+#endif
+#ifdef USE_AVX512_CRC32C_WITH_RUNTIME_CHECK
+		{"AVX-512", cpu_has_sse42() && pg_cpu_x86_have_avx512_vpclmulqdq(),
+		pg_comp_crc32c_avx512},
+#endif
+	};
+	ChecksumImpl checksum_impls[] = {
+		{"default", true, checksum_block_default},
+		{"C", true, checksum_block_c},
+#ifdef USE_AVX2_CHECKSUM_WITH_RUNTIME_CHECK
+		{"AVX2", pg_cpu_x86_have_avx2(), pg_checksum_block_avx2},
+#endif
+#ifdef USE_AVX512_CHECKSUM_WITH_RUNTIME_CHECK
+		{"AVX-512", pg_cpu_x86_have_avx512f(), pg_checksum_block_avx512},
+#endif
+	};
+	int			ncrc = lengthof(crc_impls);
+	int			nchecksum = lengthof(checksum_impls);
+	bool		ok;
+	int			i;
+	int			j;
+
+	if (argc > 2 || (argc == 2 && (seconds = atof(argv[1])) <= 0))
+	{
+		fprintf(stderr, "usage: %s [seconds]\n", argv[0]);
+		exit(1);
+	}
+
+	srandom(42);
+	crc_buf = pg_malloc(MAX_CRC_LEN);
+	for (i = 0; i < MAX_CRC_LEN; i++)
+		crc_buf[i] = (char) random();
+	pages = pg_malloc(NUM_PAGES * sizeof(PGAlignedBlock));
+	for (i = 0; i < NUM_PAGES; i++)
+	{
+		for (j = 0; j < BLCKSZ; j++)
+			pages[i].data[j] = (char) random();
+		/* pg_checksum_page() ignores the stored checksum */
+		((PageHeader) pages[i].data)->pd_checksum = 0;
+	}
+
+	for (i = 0; i < ncrc; i++)
+		printf("CRC-32C implementation %s: %s\n", crc_impls[i].name,
+			   crc_impls[i].available ? "available" : "not supported by CPU");
+	for (i = 0; i < nchecksum; i++)
+		printf("checksum implementation %s: %s\n", checksum_impls[i].name,
+			   checksum_impls[i].available ? "available" : "not supported by CPU");
+
+	ok = verify_crc(crc_impls, ncrc);
+	ok = verify_checksum(checksum_impls, nchecksum) && ok;
+	if (!ok)
+		exit(1);
+	printf("all implementations agree\n\n");
+
+	for (i = 0; i < ncrc; i++)
+	{
+		if (!crc_impls[i].available)
+			continue;
+		for (j = 0; j < lengthof(crc_lengths); j++)
+			bench_crc(&crc_impls[i], crc_lengths[j]);
+	}
+	for (i = 0; i < nchecksum; i++)
+	{
+		if (checksum_impls[i].available)
+			bench_checksum(&checksum_impls[i]);
+	}
+
+	return 0;
+}
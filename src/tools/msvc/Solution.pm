@@ -289,6 +289,7 @@ sub GenerateFiles
 		HAVE_LIBCRYPTO                              => undef,
 		HAVE_LIBLDAP                                => undef,
 		HAVE_LIBLDAP_R                              => undef,
+		HAVE_LIBLZ4                                 => undef,
 		HAVE_LIBM                                   => undef,
 		HAVE_LIBPAM                                 => undef,
 		HAVE_LIBREADLINE                            => undef,
@@ -298,7 +299,10 @@ sub GenerateFiles
 		HAVE_LIBXML2                                => undef,
 		HAVE_LIBXSLT                                => undef,
 		HAVE_LIBZ                   => $self->{options}->{zlib} ? 1 : undef,
+		HAVE_LIBZSTD                => undef,
 		HAVE_LINK                   => undef,
+		HAVE_LINUX_IO_URING_H       => undef,
+		HAVE_LINUX_MEMPOLICY_H      => undef,
 		HAVE_LOCALE_T               => 1,
 		HAVE_LONG_INT_64            => undef,
 		HAVE_LONG_LONG_INT_64       => 1,
@@ -320,12 +324,14 @@ sub GenerateFiles
 		HAVE_PPC_LWARX_MUTEX_HINT   => undef,
 		HAVE_PPOLL                  => undef,
 		HAVE_PREAD                  => undef,
+		HAVE_PREADV                 => undef,
 		HAVE_PSTAT                  => undef,
 		HAVE_PS_STRINGS             => undef,
 		HAVE_PTHREAD                => undef,
 		HAVE_PTHREAD_IS_THREADED_NP => undef,
 		HAVE_PTHREAD_PRIO_INHERIT   => undef,
 		HAVE_PWRITE                 => undef,
+		HAVE_PWRITEV                => undef,
 		HAVE_RANDOM                 => undef,
 		HAVE_READLINE_H             => undef,
 		HAVE_READLINE_HISTORY_H     => undef,
@@ -390,6 +396,7 @@ sub GenerateFiles
 		HAVE_SYS_TAS_H                           => undef,
 		HAVE_SYS_TYPES_H                         => 1,
 		HAVE_SYS_UCRED_H                         => undef,
+		HAVE_SYS_UIO_H                           => undef,
 		HAVE_SYS_UN_H                            => undef,
 		HAVE_TERMIOS_H                           => undef,
 		HAVE_TYPEOF                              => undef,
@@ -423,7 +430,9 @@ sub GenerateFiles
 		HAVE__BUILTIN_UNREACHABLE                => undef,
 		HAVE__CONFIGTHREADLOCALE                 => 1,
 		HAVE__CPUID                              => 1,
+		HAVE__CPUIDEX                            => 1,
 		HAVE__GET_CPUID                          => undef,
+		HAVE__GET_CPUID_COUNT                    => undef,
 		HAVE__STATIC_ASSERT                      => undef,
 		HAVE___STRTOLL                           => undef,
 		HAVE___STRTOULL                          => undef,
@@ -463,6 +472,10 @@ sub GenerateFiles
 		USE_ARMV8_CRC32C                    => undef,
 		USE_ARMV8_CRC32C_WITH_RUNTIME_CHECK => undef,
 		USE_ASSERT_CHECKING => $self->{options}->{asserts} ? 1 : undef,
+		USE_AVX2_BATCH_WITH_RUNTIME_CHECK      => undef,
+		USE_AVX2_CHECKSUM_WITH_RUNTIME_CHECK   => undef,
+		USE_AVX512_CHECKSUM_WITH_RUNTIME_CHECK => undef,
+		USE_AVX512_CRC32C_WITH_RUNTIME_CHECK   => undef,
 		USE_BONJOUR         => undef,
 		USE_BSD_AUTH        => undef,
 		USE_DEV_URANDOM     => undef,
@@ -471,6 +484,7 @@ sub GenerateFiles
 		USE_LIBXSLT                => undef,
 		USE_LDAP                   => $self->{options}->{ldap} ? 1 : undef,
 		USE_LLVM                   => undef,
+		USE_LZ4                    => undef,
 		USE_NAMED_POSIX_SEMAPHORES => undef,
 		USE_OPENSSL                => undef,
 		USE_OPENSSL_RANDOM         => undef,
@@ -485,6 +499,7 @@ sub GenerateFiles
 		USE_WIN32_RANDOM                    => 1,
 		USE_WIN32_SEMAPHORES                => 1,
 		USE_WIN32_SHARED_MEMORY             => 1,
+		USE_ZSTD                   => undef,
 		WCSTOMBS_L_IN_XLOCALE               => undef,
 		WORDS_BIGENDIAN                     => undef,
 		XLOG_BLCKSZ       => 1024 * $self->{options}->{wal_blocksize},
@@ -512,6 +527,16 @@ sub GenerateFiles
 		$define{HAVE_LIBXSLT} = 1;
 		$define{USE_LIBXSLT}  = 1;
 	}
+	if ($self->{options}->{lz4})
+	{
+		$define{HAVE_LIBLZ4} = 1;
+		$define{USE_LZ4}     = 1;
+	}
+	if ($self->{options}->{zstd})
+	{
+		$define{HAVE_LIBZSTD} = 1;
+		$define{USE_ZSTD}     = 1;
+	}
 	if ($self->{options}->{openssl})
 	{
 		$define{USE_OPENSSL} = 1;
@@ -922,6 +947,16 @@ sub AddProject
 		$proj->AddIncludeDir($self->{options}->{zlib} . '\include');
 		$proj->AddLibrary($self->{options}->{zlib} . '\lib\zdll.lib');
 	}
+	if ($self->{options}->{lz4})
+	{
+		$proj->AddIncludeDir($self->{options}->{lz4} . '\include');
+		$proj->AddLibrary($self->{options}->{lz4} . '\lib\liblz4.lib');
+	}
+	if ($self->{options}->{zstd})
+	{
+		$proj->AddIncludeDir($self->{options}->{zstd} . '\include');
+		$proj->AddLibrary($self->{options}->{zstd} . '\lib\libzstd.lib');
+	}
 	if ($self->{options}->{openssl})
 	{
 		$proj->AddIncludeDir($self->{options}->{openssl} . '\include');
@@ -1146,6 +1181,8 @@ sub GetFakeConfigure
 	$cfg .= ' --with-uuid'          if ($self->{options}->{uuid});
 	$cfg .= ' --with-libxml'        if ($self->{options}->{xml});
 	$cfg .= ' --with-libxslt'       if ($self->{options}->{xslt});
+	$cfg .= ' --with-lz4'           if ($self->{options}->{lz4});
+	$cfg .= ' --with-zstd'          if ($self->{options}->{zstd});
 	$cfg .= ' --with-gssapi'        if ($self->{options}->{gss});
 	$cfg .= ' --with-icu'           if ($self->{options}->{icu});
 	$cfg .= ' --with-tcl'           if ($self->{options}->{tcl});
@@ -20,6 +20,8 @@ our $config = {
 	uuid      => undef,    # --with-uuid=<path>
 	xml       => undef,    # --with-libxml=<path>
 	xslt      => undef,    # --with-libxslt=<path>
+	lz4       => undef,    # --with-lz4=<path>
+	zstd      => undef,    # --with-zstd=<path>
 	iconv     => undef,    # (not in configure, path to iconv)
 	zlib      => undef     # --with-zlib=<path>
 };
@@ -0,0 +1,38 @@
+/*-------------------------------------------------------------------------
+ *
+ * xlogparallel.h
+ *		Declarations for parallel WAL redo.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *		src/include/access/xlogparallel.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef XLOGPARALLEL_H
+#define XLOGPARALLEL_H
+
+#include "access/xlogreader.h"
+#include "storage/block.h"
+#include "storage/relfilenode.h"
+
+/* GUCs */
+extern int	max_parallel_redo_workers;
+
+extern bool ParallelRedoStart(bool local_sync);
+extern bool ParallelRedoDispatch(XLogReaderState *record);
+extern void ParallelRedoWaitForWorkers(void);
+extern void ParallelRedoCheckWorkers(void);
+extern void ParallelRedoReachedConsistency(void);
+extern bool ParallelRedoHaveInvalidPages(void);
+extern void ParallelRedoDropRelation(RelFileNode rnode, ForkNumber forknum);
+extern void ParallelRedoTruncateRelation(RelFileNode rnode, ForkNumber forknum,
+										 BlockNumber nblocks);
+extern void ParallelRedoDropDatabase(Oid dbid);
+extern void ParallelRedoFinish(void);
+
+extern void ParallelRedoWorkerMain(Datum main_arg) pg_attribute_noreturn();
+
+#endif							/* XLOGPARALLEL_H */
@@ -0,0 +1,30 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_largeobject_d.h
+ *    Macro definitions for pg_largeobject
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * NOTES
+ *  ******************************
+ *  *** DO NOT EDIT THIS FILE! ***
+ *  ******************************
+ *
+ *  It has been GENERATED by src/backend/catalog/genbki.pl
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef PG_LARGEOBJECT_D_H
+#define PG_LARGEOBJECT_D_H
+
+#define LargeObjectRelationId 2613
+
+#define Anum_pg_largeobject_loid 1
+#define Anum_pg_largeobject_pageno 2
+#define Anum_pg_largeobject_data 3
+
+#define Natts_pg_largeobject 3
+
+
+#endif							/* PG_LARGEOBJECT_D_H */
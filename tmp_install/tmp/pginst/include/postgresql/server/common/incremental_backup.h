@@ -0,0 +1,52 @@
+/*-------------------------------------------------------------------------
+ *
+ * incremental_backup.h
+ *	  On-disk format of the files sent by an incremental base backup
+ *
+ * An incremental base backup sends some relation files in full, and others
+ * as "incremental files" that contain only the blocks modified since the
+ * prior backup.  An incremental file is stored alongside the files that are
+ * sent in full, under the name of the relation file prefixed with
+ * INCREMENTAL_PREFIX.  Its contents, all in native byte order, are:
+ *
+ *	uint32		magic number (INCREMENTAL_MAGIC)
+ *	uint32		number of blocks included in the file
+ *	uint32		truncation block length
+ *	uint32[]	block numbers, relative to the start of the segment, in
+ *				ascending order
+ *	char[][]	the contents of those blocks, BLCKSZ bytes each
+ *
+ * The truncation block length is the length, in blocks, that the segment had
+ * when the backup was taken.  Blocks at or beyond that length are not part
+ * of the file; blocks below it that are not included have not been modified
+ * since the prior backup and must be taken from it.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *		  src/include/common/incremental_backup.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef INCREMENTAL_BACKUP_H
+#define INCREMENTAL_BACKUP_H
+
+#define INCREMENTAL_MAGIC			0xd3ae1f0d
+#define INCREMENTAL_PREFIX			"INCREMENTAL."
+#define INCREMENTAL_PREFIX_LENGTH	(sizeof(INCREMENTAL_PREFIX) - 1)
+
+/* Size of the fixed part of the header: magic, block count, truncation */
+#define INCREMENTAL_HEADER_SIZE		(3 * sizeof(uint32))
+
+/* Size of an incremental file containing the given number of blocks */
+#define INCREMENTAL_FILE_SIZE(nblocks) \
+	(INCREMENTAL_HEADER_SIZE + (size_t) (nblocks) * (sizeof(uint32) + BLCKSZ))
+
+/*
+ * Lines added to the backup_label of an incremental backup, identifying the
+ * backup it was taken relative to.
+ */
+#define INCREMENTAL_FROM_LSN_LABEL	"INCREMENTAL FROM LSN"
+#define INCREMENTAL_FROM_TLI_LABEL	"INCREMENTAL FROM TLI"
+
+#endif							/* INCREMENTAL_BACKUP_H */
@@ -0,0 +1,155 @@
+/*-------------------------------------------------------------------------
+ *
+ * execBatch.h
+ *	  Support for evaluating scans a batch of rows at a time
+ *
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/executor/execBatch.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef EXECBATCH_H
+#define EXECBATCH_H
+
+#include "executor/tuptable.h"
+#include "nodes/pg_list.h"
+#include "nodes/plannodes.h"
+#include "storage/buf.h"
+
+/* maximum number of buffers a batch keeps pinned */
+#define TUPLE_BATCH_MAX_BUFFERS		8
+
+/* GUC parameter */
+extern PGDLLIMPORT int executor_batch_size;
+
+/*
+ * A TupleBatch holds up to maxrows rows of a scan, deformed into column
+ * vectors: values[i][row] and isnull[i][row] hold attribute i + 1 of each
+ * row, for the first natts attributes of the scanned relation.
+ *
+ * Pass-by-reference values point into the pages the rows came from, so the
+ * batch keeps those buffers pinned until it is reset.
+ *
+ * sel[] lists, in ascending order, the nselected rows that passed the
+ * batch's qual; next is the position in sel[] of the next row to return,
+ * and lastrow the last row returned (or -1), so that the caller can count
+ * the rows that were filtered out as it goes.
+ */
+typedef struct TupleBatch
+{
+	int			maxrows;		/* allocated number of rows */
+	int			natts;			/* number of attributes deformed */
+	int			nrows;			/* number of rows currently held */
+	Datum	  **values;			/* column vectors of values */
+	bool	  **isnull;			/* column vectors of null flags */
+	ItemPointerData *tids;		/* TID of each row */
+
+	int		   *sel;			/* selection vector */
+	int			nselected;		/* number of entries in sel[] */
+	int			next;			/* next entry of sel[] to return */
+	int			lastrow;		/* last row returned, or -1 */
+
+	int64	   *iscratch;		/* workspace for integer comparisons */
+	double	   *fscratch;		/* workspace for float comparisons */
+
+	int			nbuffers;		/* number of pinned buffers */
+	Buffer		buffers[TUPLE_BATCH_MAX_BUFFERS];
+} TupleBatch;
+
+/*
+ * Physical representation of a column, or of a constant, as the batch code
+ * handles it
+ */
+typedef enum BatchValueType
+{
+	BATCH_INT2,
+	BATCH_INT4,					/* also date */
+	BATCH_INT8,					/* also timestamp */
+	BATCH_OID,
+	BATCH_FLOAT4,
+	BATCH_FLOAT8
+} BatchValueType;
+
+typedef enum BatchCmp
+{
+	BATCH_CMP_EQ,
+	BATCH_CMP_NE,
+	BATCH_CMP_LT,
+	BATCH_CMP_LE,
+	BATCH_CMP_GT,
+	BATCH_CMP_GE
+} BatchCmp;
+
+/*
+ * Kernels over the values of a batch column, gathered into a plain array.
+ * Integer types are gathered as int64 and float types as float8.
+ *
+ * The filter kernels keep the entries of sel[] whose value passes the
+ * comparison with c, compacting sel[] in place, and return how many they
+ * kept; filter_float8 needn't cope with a NaN constant.  The min and max
+ * kernels require n > 0.
+ *
+ * There's a plain C implementation of each kernel, and on x86 an AVX2 one,
+ * which is used if the CPU supports it.
+ */
+typedef struct BatchKernels
+{
+	int			(*filter_int64) (BatchCmp cmp, int64 c, const int64 *values,
+								 int *sel, int n);
+	int			(*filter_float8) (BatchCmp cmp, double c,
+								  const double *values, int *sel, int n);
+	int64		(*sum_int64) (const int64 *values, int n);
+	int64		(*min_int64) (const int64 *values, int n);
+	int64		(*max_int64) (const int64 *values, int n);
+} BatchKernels;
+
+#ifdef USE_AVX2_BATCH_WITH_RUNTIME_CHECK
+extern const BatchKernels batch_kernels_avx2;
+#endif
+
+/* opaque, see execBatch.c */
+typedef struct BatchQual BatchQual;
+
+/*
+ * An aggregate transition function that can be advanced over a whole batch.
+ * All of them have pass-by-value transition states.
+ */
+typedef enum BatchAggKind
+{
+	BATCH_AGG_COUNT_STAR,		/* count(*) */
+	BATCH_AGG_COUNT,			/* count(column) */
+	BATCH_AGG_SUM_INT,			/* sum of int2 or int4 */
+	BATCH_AGG_SUM_FLOAT8,		/* sum of float8 */
+	BATCH_AGG_MIN,				/* min of an integer or float type */
+	BATCH_AGG_MAX				/* max of an integer or float type */
+} BatchAggKind;
+
+typedef struct BatchAggTrans
+{
+	BatchAggKind kind;
+	int			attno;			/* column vector, 0-based; -1 for count(*) */
+	BatchValueType coltype;		/* representation of the column */
+} BatchAggTrans;
+
+extern bool ExecBatchScanAttrs(List *targetlist, List *qual, Index scanrelid,
+							   int *natts);
+extern int	ExecBatchOutputAttr(Plan *plan, AttrNumber resno);
+extern BatchQual *ExecInitBatchQual(List *qual, Index scanrelid,
+									List **residual);
+extern void ExecBatchQualEval(BatchQual *bqual, TupleBatch *batch);
+
+extern bool ExecInitBatchAggTrans(Oid transfn, int attno,
+								  BatchAggTrans *trans);
+extern void ExecBatchAggAdvance(BatchAggTrans *trans, TupleBatch *batch,
+								Datum *transValue, bool *transValueIsNull);
+
+extern TupleBatch *ExecCreateTupleBatch(int maxrows, int natts);
+extern void ExecResetTupleBatch(TupleBatch *batch);
+extern bool ExecTupleBatchAddRow(TupleBatch *batch, TupleTableSlot *slot);
+extern void ExecStoreBatchRow(TupleBatch *batch, int row,
+							  TupleTableSlot *slot);
+
+#endif							/* EXECBATCH_H */
@@ -0,0 +1 @@
+/* src/include/port/openbsd.h */
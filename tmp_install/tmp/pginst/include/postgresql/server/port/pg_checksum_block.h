@@ -0,0 +1,44 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_checksum_block.h
+ *	  Explicitly vectorized implementations of the data page checksum.
+ *
+ * These compute exactly the same result as pg_checksum_block() in
+ * storage/checksum_impl.h, which uses them when the CPU supports them.
+ * Each takes the BLCKSZ bytes of the page, viewed as rows of
+ * PG_CHECKSUM_BLOCK_SUMS 32-bit words, and the initial values of the
+ * parallel sums.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/port/pg_checksum_block.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef PG_CHECKSUM_BLOCK_H
+#define PG_CHECKSUM_BLOCK_H
+
+/* these must match N_SUMS and FNV_PRIME in storage/checksum_impl.h */
+#define PG_CHECKSUM_BLOCK_SUMS	32
+#define PG_CHECKSUM_BLOCK_PRIME	16777619
+
+typedef uint32 (*pg_checksum_block_fn) (const uint32 *data,
+										const uint32 *base_offsets);
+
+/*
+ * Returns the fastest implementation the CPU supports, or NULL if it
+ * supports none of them.
+ */
+extern pg_checksum_block_fn pg_checksum_block_choose(void);
+
+#ifdef USE_AVX2_CHECKSUM_WITH_RUNTIME_CHECK
+extern uint32 pg_checksum_block_avx2(const uint32 *data,
+									 const uint32 *base_offsets);
+#endif
+#ifdef USE_AVX512_CHECKSUM_WITH_RUNTIME_CHECK
+extern uint32 pg_checksum_block_avx512(const uint32 *data,
+									   const uint32 *base_offsets);
+#endif
+
+#endif							/* PG_CHECKSUM_BLOCK_H */
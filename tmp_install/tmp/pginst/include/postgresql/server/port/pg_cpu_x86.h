@@ -0,0 +1,131 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_cpu_x86.h
+ *	  Runtime detection of x86 instruction set extensions.
+ *
+ * These are used to choose between implementations of CRC-32C and of the
+ * data page checksum at runtime. Using the AVX registers also requires
+ * support from the operating system, which has to save and restore them on
+ * context switches, so besides the CPUID feature bits we check that the OS
+ * has enabled the register state in XCR0.
+ *
+ * Only include this where cpuid with a subleaf is available, that is, if
+ * HAVE__GET_CPUID_COUNT or HAVE__CPUIDEX is defined.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/port/pg_cpu_x86.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef PG_CPU_X86_H
+#define PG_CPU_X86_H
+
+#if defined(HAVE__GET_CPUID_COUNT)
+#include <cpuid.h>
+#elif defined(HAVE__CPUIDEX)
+#include <intrin.h>
+#else
+#error cpuid instruction with subleaf not available
+#endif
+
+/* XCR0 bits for SSE and AVX (YMM) state */
+#define PG_XCR0_YMM_STATE		0x06
+/* ... plus the AVX-512 opmask and ZMM state */
+#define PG_XCR0_ZMM_STATE		0xE6
+
+/*
+ * Execute CPUID for the given leaf and subleaf. Leaves that the CPU doesn't
+ * support read as all zeroes.
+ */
+static inline void
+pg_cpuid_count(unsigned int leaf, unsigned int subleaf, unsigned int *exx)
+{
+#if defined(HAVE__GET_CPUID_COUNT)
+	if (!__get_cpuid_count(leaf, subleaf, &exx[0], &exx[1], &exx[2], &exx[3]))
+		exx[0] = exx[1] = exx[2] = exx[3] = 0;
+#else
+	int			maxleaf[4];
+
+	__cpuidex(maxleaf, 0, 0);
+	if ((unsigned int) maxleaf[0] < leaf)
+		exx[0] = exx[1] = exx[2] = exx[3] = 0;
+	else
+		__cpuidex((int *) exx, leaf, subleaf);
+#endif
+}
+
+/*
+ * Does the operating system save and restore all of the register state in
+ * "mask"?
+ */
+static inline bool
+pg_cpu_x86_os_saves(uint64 mask)
+{
+	unsigned int exx[4];
+	uint64		xcr0;
+
+	pg_cpuid_count(1, 0, exx);
+	if ((exx[2] & (1 << 27)) == 0)	/* OSXSAVE */
+		return false;
+
+#if defined(HAVE__GET_CPUID_COUNT)
+	{
+		uint32		eax,
+					edx;
+
+		/* XGETBV, spelled out for assemblers that don't know it */
+		__asm__ __volatile__(".byte 0x0f, 0x01, 0xd0"
+							 : "=a"(eax), "=d"(edx) : "c"(0));
+		xcr0 = ((uint64) edx << 32) | eax;
+	}
+#else
+	xcr0 = _xgetbv(0);
+#endif
+
+	return (xcr0 & mask) == mask;
+}
+
+/* Does the CPU support AVX2? */
+static inline bool
+pg_cpu_x86_have_avx2(void)
+{
+	unsigned int exx[4];
+
+	if (!pg_cpu_x86_os_saves(PG_XCR0_YMM_STATE))
+		return false;
+	pg_cpuid_count(7, 0, exx);
+	return (exx[1] & (1 << 5)) != 0;	/* AVX2 */
+}
+
+/* Does the CPU support the AVX-512 Foundation instructions? */
+static inline bool
+pg_cpu_x86_have_avx512f(void)
+{
+	unsigned int exx[4];
+
+	if (!pg_cpu_x86_os_saves(PG_XCR0_ZMM_STATE))
+		return false;
+	pg_cpuid_count(7, 0, exx);
+	return (exx[1] & (1 << 16)) != 0;	/* AVX-512F */
+}
+
+/*
+ * Does the CPU support AVX-512F, AVX-512VL and VPCLMULQDQ, as used by the
+ * folding CRC-32C implementation?
+ */
+static inline bool
+pg_cpu_x86_have_avx512_vpclmulqdq(void)
+{
+	unsigned int exx[4];
+
+	if (!pg_cpu_x86_os_saves(PG_XCR0_ZMM_STATE))
+		return false;
+	pg_cpuid_count(7, 0, exx);
+	return (exx[1] & (1 << 16)) != 0 &&	/* AVX-512F */
+		(exx[1] & (1U << 31)) != 0 &&	/* AVX-512VL */
+		(exx[2] & (1 << 10)) != 0;	/* VPCLMULQDQ */
+}
+
+#endif							/* PG_CPU_X86_H */
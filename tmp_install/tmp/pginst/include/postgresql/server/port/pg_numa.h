@@ -0,0 +1,40 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_numa.h
+ *	  Basic NUMA (non-uniform memory access) support for the backend.
+ *
+ * Nodes are identified by their index in the list of nodes this process is
+ * allowed to allocate memory on, so they are always numbered 0 .. n-1, even
+ * if the operating system's node numbers have gaps.  pg_numa_node_id()
+ * translates an index to the operating system's node number.
+ *
+ * The placement functions apply to whole pages of memory, so addr and size
+ * must be multiples of the page size of the mapping, which may be a huge page
+ * size.  They return 0 on success, or -1 with errno set.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/port/pg_numa.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef PG_NUMA_H
+#define PG_NUMA_H
+
+/*
+ * We use the Linux system calls directly rather than libnuma; we need only
+ * a small part of it.
+ */
+#ifdef HAVE_LINUX_MEMPOLICY_H
+#define USE_NUMA
+#endif
+
+extern int	pg_numa_num_nodes(void);
+extern int	pg_numa_node_id(int node);
+extern int	pg_numa_current_node(void);
+extern int	pg_numa_interleave(void *addr, Size size);
+extern int	pg_numa_prefer(void *addr, Size size, int node);
+extern int	pg_numa_query_pages(int count, void **pages, int *status);
+
+#endif							/* PG_NUMA_H */
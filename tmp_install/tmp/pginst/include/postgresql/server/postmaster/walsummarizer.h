@@ -0,0 +1,29 @@
+/*-------------------------------------------------------------------------
+ *
+ * walsummarizer.h
+ *	  Exports from postmaster/walsummarizer.c.
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ *
+ * src/include/postmaster/walsummarizer.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef _WALSUMMARIZER_H
+#define _WALSUMMARIZER_H
+
+#include "access/xlogdefs.h"
+
+/* GUC options */
+extern bool summarize_wal;
+extern int	wal_summary_keep_time;
+
+extern Size WalSummarizerShmemSize(void);
+extern void WalSummarizerShmemInit(void);
+extern void WalSummarizerRegister(void);
+extern void WalSummarizerMain(Datum main_arg) pg_attribute_noreturn();
+
+extern XLogRecPtr GetOldestUnsummarizedLSN(TimeLineID *tli);
+extern void WaitForWalSummarization(XLogRecPtr lsn);
+
+#endif							/* _WALSUMMARIZER_H */
@@ -0,0 +1,28 @@
+/*-------------------------------------------------------------------------
+ *
+ * basebackup_compress.h
+ *	  API for compressing the tar streams of a base backup on the server
+ *
+ * Portions Copyright (c) 2010-2020, PostgreSQL Global Development Group
+ *
+ * src/include/replication/basebackup_compress.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef BASEBACKUP_COMPRESS_H
+#define BASEBACKUP_COMPRESS_H
+
+#include "common/backup_compression.h"
+
+typedef struct BackupCompressor BackupCompressor;
+
+extern void CheckBackupCompressionOptions(pg_backup_compression method,
+										  int level, int workers);
+extern BackupCompressor *CreateBackupCompressor(pg_backup_compression method,
+												int level, int workers);
+extern void BackupCompressorBegin(BackupCompressor *bc);
+extern void BackupCompressorWrite(BackupCompressor *bc, const char *data,
+								  size_t len);
+extern void BackupCompressorEnd(BackupCompressor *bc);
+
+#endif							/* BASEBACKUP_COMPRESS_H */
@@ -0,0 +1,76 @@
+/*-------------------------------------------------------------------------
+ *
+ * walsummary.h
+ *	  WAL summary files and the block reference tables they contain
+ *
+ * A WAL summary records, for a range of WAL on a single timeline, which
+ * blocks of which relation forks were modified by that WAL, and the lowest
+ * block number to which each relation fork was truncated (or at which it was
+ * created) within the range.
+ *
+ * Portions Copyright (c) 2010-2020, PostgreSQL Global Development Group
+ *
+ * src/include/replication/walsummary.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef WALSUMMARY_H
+#define WALSUMMARY_H
+
+#include "access/xlogdefs.h"
+#include "nodes/pg_list.h"
+#include "pgtime.h"
+#include "storage/block.h"
+#include "storage/relfilenode.h"
+
+/* Directory, relative to the data directory, holding WAL summary files */
+#define WAL_SUMMARY_DIR		"pg_wal/summaries"
+
+/* Information about a WAL summary file, as encoded in its name */
+typedef struct WalSummaryFile
+{
+	TimeLineID	tli;
+	XLogRecPtr	start_lsn;
+	XLogRecPtr	end_lsn;
+} WalSummaryFile;
+
+/*
+ * A block reference table.  The contents are private to walsummary.c; it is
+ * only manipulated through the functions below.
+ */
+typedef struct BlockRefTable BlockRefTable;
+
+extern BlockRefTable *CreateBlockRefTable(void);
+extern void FreeBlockRefTable(BlockRefTable *brtab);
+extern void BlockRefTableMarkBlockModified(BlockRefTable *brtab,
+										   const RelFileNode *rnode,
+										   ForkNumber forknum,
+										   BlockNumber blknum);
+extern void BlockRefTableSetLimitBlock(BlockRefTable *brtab,
+									   const RelFileNode *rnode,
+									   ForkNumber forknum,
+									   BlockNumber limit_block);
+extern bool BlockRefTableLookup(BlockRefTable *brtab,
+								const RelFileNode *rnode, ForkNumber forknum,
+								BlockNumber *limit_block);
+extern int	BlockRefTableGetBlocks(BlockRefTable *brtab,
+								   const RelFileNode *rnode,
+								   ForkNumber forknum,
+								   BlockNumber start_blkno,
+								   BlockNumber stop_blkno,
+								   BlockNumber *blocks, int nblocks);
+extern uint64 BlockRefTableNumBlocks(BlockRefTable *brtab);
+
+/* WAL summary files */
+extern List *GetWalSummaries(TimeLineID tli, XLogRecPtr start_lsn,
+							 XLogRecPtr end_lsn);
+extern bool WalSummariesAreComplete(List *wslist, XLogRecPtr start_lsn,
+									XLogRecPtr end_lsn,
+									XLogRecPtr *missing_lsn);
+extern void WriteWalSummary(BlockRefTable *brtab, TimeLineID tli,
+							XLogRecPtr start_lsn, XLogRecPtr end_lsn);
+extern void ReadWalSummary(BlockRefTable *brtab, WalSummaryFile *ws);
+extern void RemoveWalSummaryIfOlderThan(WalSummaryFile *ws,
+										pg_time_t cutoff_time);
+
+#endif							/* WALSUMMARY_H */
@@ -0,0 +1,61 @@
+/*-------------------------------------------------------------------------
+ *
+ * read_stream.h
+ *	  Mechanism for reading a sequence of relation blocks ahead of use.
+ *
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/storage/read_stream.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef READ_STREAM_H
+#define READ_STREAM_H
+
+#include "storage/bufmgr.h"
+
+/* Flags for read_stream_begin_relation() */
+#define READ_STREAM_DEFAULT			0x00
+
+/*
+ * The stream is used by a maintenance operation, so its lookahead is
+ * governed by maintenance_io_concurrency rather than effective_io_concurrency.
+ */
+#define READ_STREAM_MAINTENANCE		0x01
+
+/*
+ * The caller is going to consume the whole stream, so start at the maximum
+ * lookahead distance rather than ramping up.  Without this, streams start
+ * with no lookahead, so that a scan that stops after a few blocks, for
+ * example because of a LIMIT, doesn't pin and read buffers it doesn't need.
+ */
+#define READ_STREAM_FULL			0x02
+
+typedef struct ReadStream ReadStream;
+
+/*
+ * Callback that returns the next block number to read, or InvalidBlockNumber
+ * at the end of the stream.  If the stream was created with a non-zero
+ * per_buffer_data_size, per_buffer_data points to that much space, where the
+ * callback can store information that read_stream_next_buffer() will hand
+ * back along with the buffer.
+ */
+typedef BlockNumber (*ReadStreamBlockNumberCB) (ReadStream *stream,
+												void *callback_private_data,
+												void *per_buffer_data);
+
+extern ReadStream *read_stream_begin_relation(int flags,
+											  BufferAccessStrategy strategy,
+											  Relation rel,
+											  ForkNumber forknum,
+											  ReadStreamBlockNumberCB callback,
+											  void *callback_private_data,
+											  size_t per_buffer_data_size);
+extern Buffer read_stream_next_buffer(ReadStream *stream,
+									  void **per_buffer_data);
+extern void read_stream_reset(ReadStream *stream);
+extern void read_stream_end(ReadStream *stream);
+
+#endif							/* READ_STREAM_H */
@@ -0,0 +1,25 @@
+/*-------------------------------------------------------------------------
+ *
+ * int8.h
+ *	  Declarations for operations on 64-bit integers.
+ *
+ *
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/utils/int8.h
+ *
+ * NOTES
+ * These data types are supported on all 64-bit architectures, and may
+ *	be supported through libraries on some 32-bit machines. If your machine
+ *	is not currently supported, then please try to make it so, then post
+ *	patches to the postgresql.org hackers mailing list.
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef INT8_H
+#define INT8_H
+
+extern bool scanint8(const char *str, bool errorOK, int64 *result);
+
+#endif							/* INT8_H */